@@ -106,6 +106,7 @@ try {
     10240,
     ref.NULL, // passphrase
     ref.NULL, // seed words
+    ref.NULL, // runtime
     receivedTx,
     receivedTxReply,
     receivedFinalized,
@@ -120,6 +121,10 @@ try {
     itxoValidation,
     txValidation,
     safsReceived,
+    ref.NULL, // events batch callback
+    0, // events batch window ms
+    0, // events batch max events
+    ref.NULL, // wallet ready callback
     err
   );
 
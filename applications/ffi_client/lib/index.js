@@ -6,6 +6,7 @@ const {
   transportRef,
   commsConfigRef,
   walletRef,
+  runtimeRef,
   fn,
   bool,
   u8,
@@ -49,6 +50,7 @@ const libWallet = ffi.Library("./libtari_wallet_ffi.dylib", {
       u32,
       "string",
       "string",
+      runtimeRef,
       fn,
       fn,
       fn,
@@ -63,6 +65,10 @@ const libWallet = ffi.Library("./libtari_wallet_ffi.dylib", {
       fn,
       fn,
       fn,
+      fn,
+      u64,
+      u32,
+      fn,
       errPtr,
     ],
   ],
@@ -6,6 +6,7 @@ const errPtr = ref.refType(ref.types.int32);
 const transportRef = ref.refType(ref.types.void);
 const commsConfigRef = ref.refType(ref.types.void);
 const walletRef = ref.refType(ref.types.void);
+const runtimeRef = ref.refType(ref.types.void);
 const fn = ref.refType(ref.types.void);
 const bool = ref.types.bool;
 const u8 = ref.types.uint8;
@@ -26,6 +27,7 @@ module.exports = {
   transportRef,
   commsConfigRef,
   walletRef,
+  runtimeRef,
   fn,
   bool,
   u8,
@@ -138,6 +138,7 @@ try {
     10240,
     ref.NULL, // passphrase
     seedWords, // seed words
+    ref.NULL, // runtime
     receivedTx,
     receivedTxReply,
     receivedFinalized,
@@ -152,6 +153,10 @@ try {
     itxoValidation,
     txValidation,
     safsReceived,
+    ref.NULL, // events batch callback
+    0, // events batch window ms
+    0, // events batch max events
+    ref.NULL, // wallet ready callback
     err
   );
 
@@ -908,6 +908,10 @@ impl tari_rpc::base_node_server::BaseNode for BaseNodeGrpcServer {
         Ok(Response::new(consts::APP_VERSION.to_string().into()))
     }
 
+    async fn get_metrics(&self, _request: Request<tari_rpc::Empty>) -> Result<Response<tari_rpc::StringValue>, Status> {
+        Ok(Response::new(tari_metrics::global().encode_text().into()))
+    }
+
     async fn check_for_updates(
         &self,
         _request: Request<tari_rpc::Empty>,
@@ -611,35 +611,45 @@ pub async fn command_runner(
                 println!("Emoji ID  : {}", emoji_id);
             },
             ExportUtxos => {
-                let utxos = output_service.get_unspent_outputs().await?;
-                let count = utxos.len();
-                let sum: MicroTari = utxos.iter().map(|utxo| utxo.value).sum();
-                if parsed.args.is_empty() {
+                // Listing needs only the public parts of the outputs, the secret keys are decrypted for a CSV export
+                let (count, sum) = if parsed.args.is_empty() {
+                    let utxos = output_service.get_unspent_output_summaries().await?;
                     for (i, utxo) in utxos.iter().enumerate() {
                         println!("{}. Value: {} {}", i + 1, utxo.value, utxo.features);
                     }
-                } else if let ParsedArgument::CSVFileName(file) = parsed.args[1].clone() {
-                    write_utxos_to_csv_file(utxos, file)?;
-                }
+                    (utxos.len(), utxos.iter().map(|utxo| utxo.value).sum::<MicroTari>())
+                } else {
+                    let utxos = output_service.get_unspent_outputs().await?;
+                    let count_and_sum = (utxos.len(), utxos.iter().map(|utxo| utxo.value).sum::<MicroTari>());
+                    if let ParsedArgument::CSVFileName(file) = parsed.args[1].clone() {
+                        write_utxos_to_csv_file(utxos, file)?;
+                    }
+                    count_and_sum
+                };
                 println!("Total number of UTXOs: {}", count);
                 println!("Total value of UTXOs: {}", sum);
             },
             ExportSpentUtxos => {
-                let utxos = output_service.get_spent_outputs().await?;
-                let count = utxos.len();
-                let sum: MicroTari = utxos.iter().map(|utxo| utxo.value).sum();
-                if parsed.args.is_empty() {
+                // Listing needs only the public parts of the outputs, the secret keys are decrypted for a CSV export
+                let (count, sum) = if parsed.args.is_empty() {
+                    let utxos = output_service.get_spent_output_summaries().await?;
                     for (i, utxo) in utxos.iter().enumerate() {
                         println!("{}. Value: {} {}", i + 1, utxo.value, utxo.features);
                     }
-                } else if let ParsedArgument::CSVFileName(file) = parsed.args[1].clone() {
-                    write_utxos_to_csv_file(utxos, file)?;
-                }
+                    (utxos.len(), utxos.iter().map(|utxo| utxo.value).sum::<MicroTari>())
+                } else {
+                    let utxos = output_service.get_spent_outputs().await?;
+                    let count_and_sum = (utxos.len(), utxos.iter().map(|utxo| utxo.value).sum::<MicroTari>());
+                    if let ParsedArgument::CSVFileName(file) = parsed.args[1].clone() {
+                        write_utxos_to_csv_file(utxos, file)?;
+                    }
+                    count_and_sum
+                };
                 println!("Total number of UTXOs: {}", count);
                 println!("Total value of UTXOs: {}", sum);
             },
             CountUtxos => {
-                let utxos = output_service.get_unspent_outputs().await?;
+                let utxos = output_service.get_unspent_output_summaries().await?;
                 let count = utxos.len();
                 let values: Vec<MicroTari> = utxos.iter().map(|utxo| utxo.value).collect();
                 let sum: MicroTari = values.iter().sum();
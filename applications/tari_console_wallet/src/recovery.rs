@@ -149,6 +149,19 @@ pub async fn wallet_recovery(wallet: &WalletSqlite, base_node_config: &PeerConfi
                 println!("{}", s);
                 warn!(target: LOG_TARGET, "{}", s);
             },
+            Ok(UtxoScannerEvent::ScanningStatistics {
+                rewind_time,
+                import_time,
+                persist_time,
+            }) => {
+                debug!(
+                    target: LOG_TARGET,
+                    "Recovery time spent rewinding = {:.2?}, importing = {:.2?}, persisting progress = {:.2?}",
+                    rewind_time,
+                    import_time,
+                    persist_time
+                );
+            },
             Ok(UtxoScannerEvent::Completed {
                 number_scanned: num_scanned,
                 number_received: num_utxos,
@@ -766,28 +766,10 @@ impl AppStateInner {
         if let Err(e) = self
             .wallet
             .output_manager_service
-            .validate_txos(TxoValidationType::Unspent, ValidationRetryStrategy::UntilSuccess)
+            .validate_txos(TxoValidationType::All, ValidationRetryStrategy::UntilSuccess)
             .await
         {
-            error!(target: LOG_TARGET, "Problem validating UTXOs: {}", e);
-        }
-
-        if let Err(e) = self
-            .wallet
-            .output_manager_service
-            .validate_txos(TxoValidationType::Spent, ValidationRetryStrategy::UntilSuccess)
-            .await
-        {
-            error!(target: LOG_TARGET, "Problem validating STXOs: {}", e);
-        }
-
-        if let Err(e) = self
-            .wallet
-            .output_manager_service
-            .validate_txos(TxoValidationType::Invalid, ValidationRetryStrategy::UntilSuccess)
-            .await
-        {
-            error!(target: LOG_TARGET, "Problem validating Invalid TXOs: {}", e);
+            error!(target: LOG_TARGET, "Problem validating TXOs: {}", e);
         }
     }
 }
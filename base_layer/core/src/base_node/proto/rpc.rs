@@ -21,6 +21,8 @@
 //  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{blocks::Block, chain_storage::PrunedOutput, proto::base_node as proto, tari_utilities::Hashable};
+use prost::encoding::{encode_key, encode_varint, encoded_len_varint, key_len, uint64, WireType};
+use tari_comms::{Bytes, BytesMut};
 
 impl From<Block> for proto::BlockBodyResponse {
     fn from(block: Block) -> Self {
@@ -49,3 +51,53 @@ impl From<PrunedOutput> for proto::SyncUtxo {
         }
     }
 }
+
+impl proto::SyncUtxosResponse {
+    /// Encodes a `SyncUtxosResponse` holding a `SyncUtxo` that is already encoded. The `SyncUtxo` is copied in as-is,
+    /// the result is the same as encoding the response with the decoded `SyncUtxo`.
+    pub fn encode_with_utxo(encoded_utxo: &[u8], mmr_index: u64) -> Bytes {
+        let len = key_len(1) +
+            encoded_len_varint(encoded_utxo.len() as u64) +
+            encoded_utxo.len() +
+            uint64::encoded_len(3, &mmr_index);
+        let mut buf = BytesMut::with_capacity(len);
+        encode_key(1, WireType::LengthDelimited, &mut buf);
+        encode_varint(encoded_utxo.len() as u64, &mut buf);
+        buf.extend_from_slice(encoded_utxo);
+        if mmr_index != 0 {
+            uint64::encode(3, &mmr_index, &mut buf);
+        }
+        buf.freeze()
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use prost::Message;
+
+    #[test]
+    fn encode_with_utxo_matches_the_message_encoding() {
+        let utxo = proto::SyncUtxo {
+            utxo: Some(proto::sync_utxo::Utxo::PrunedOutput(proto::PrunedOutput {
+                hash: vec![1; 32],
+                witness_hash: vec![2; 32],
+            })),
+        };
+        let mut encoded_utxo = Vec::new();
+        utxo.encode(&mut encoded_utxo).unwrap();
+
+        for mmr_index in &[0, 1, 300, u64::MAX] {
+            let response = proto::SyncUtxosResponse {
+                utxo_or_deleted: Some(proto::sync_utxos_response::UtxoOrDeleted::Utxo(utxo.clone())),
+                mmr_index: *mmr_index,
+            };
+            let mut expected = Vec::new();
+            response.encode(&mut expected).unwrap();
+            assert_eq!(
+                proto::SyncUtxosResponse::encode_with_utxo(&encoded_utxo, *mmr_index).as_ref(),
+                expected.as_slice()
+            );
+        }
+    }
+}
@@ -123,11 +123,11 @@ impl<B: BlockchainBackend + 'static> BaseNodeStateMachine<B> {
         match (state, event) {
             (Starting(s), Initialized) => Listening(s.into()),
             (Listening(s), InitialSync) => HeaderSync(s.into()),
-            (HeaderSync(_), HeadersSynchronized(conn)) => {
+            (HeaderSync(s), HeadersSynchronized(conn)) => {
                 if self.config.pruning_horizon > 0 {
                     HorizonStateSync(states::HorizonStateSync::with_peer(conn))
                 } else {
-                    BlockSync(states::BlockSync::with_peer(conn))
+                    BlockSync(states::BlockSync::with_peer(conn, s.sync_peers().to_vec()))
                 }
             },
             (HeaderSync(s), HeaderSyncFailed) => Waiting(s.into()),
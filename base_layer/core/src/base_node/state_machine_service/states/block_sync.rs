@@ -31,13 +31,14 @@ use crate::{
 };
 use log::*;
 use std::time::Instant;
-use tari_comms::PeerConnection;
+use tari_comms::{peer_manager::NodeId, PeerConnection};
 
 const LOG_TARGET: &str = "c::bn::block_sync";
 
 #[derive(Debug, Default)]
 pub struct BlockSync {
     sync_peer: Option<PeerConnection>,
+    sync_peers: Vec<NodeId>,
     is_synced: bool,
 }
 
@@ -46,9 +47,10 @@ impl BlockSync {
         Default::default()
     }
 
-    pub fn with_peer(sync_peer: PeerConnection) -> Self {
+    pub fn with_peer(sync_peer: PeerConnection, sync_peers: Vec<NodeId>) -> Self {
         Self {
             sync_peer: Some(sync_peer),
+            sync_peers,
             is_synced: false,
         }
     }
@@ -57,10 +59,17 @@ impl BlockSync {
         &mut self,
         shared: &mut BaseNodeStateMachine<B>,
     ) -> StateEvent {
+        let sync_peers = if self.sync_peers.is_empty() {
+            shared.config.block_sync_config.sync_peers.clone()
+        } else {
+            self.sync_peers.clone()
+        };
         let mut synchronizer = BlockSynchronizer::new(
+            shared.config.block_sync_config.clone(),
             shared.db.clone(),
             shared.connectivity.clone(),
             self.sync_peer.take(),
+            sync_peers,
             shared.sync_validators.block_body.clone(),
         );
 
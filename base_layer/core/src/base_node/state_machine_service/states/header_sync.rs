@@ -49,6 +49,12 @@ impl HeaderSync {
         }
     }
 
+    /// The peers header sync was started with. These are the peers to fetch the block bodies from once the headers
+    /// are synchronized.
+    pub fn sync_peers(&self) -> &[NodeId] {
+        &self.sync_peers
+    }
+
     pub fn is_synced(&self) -> bool {
         self.is_synced
     }
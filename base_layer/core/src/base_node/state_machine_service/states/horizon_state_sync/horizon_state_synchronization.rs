@@ -298,6 +298,7 @@ impl<'a, B: BlockchainBackend + 'static> HorizonStateSynchronization<'a, B> {
             end_header_hash: end_hash,
             include_deleted_bitmaps: true,
             include_pruned_utxos: true,
+            end_mmr_index: 0,
         };
         let mut output_stream = client.sync_utxos(req).await?;
 
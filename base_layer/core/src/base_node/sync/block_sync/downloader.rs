@@ -0,0 +1,281 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use super::error::BlockSyncError;
+use crate::{
+    base_node::sync::rpc,
+    chain_storage::{async_db::AsyncBlockchainDb, BlockchainBackend, ChainBlock},
+    proto::base_node::SyncBlocksRequest,
+    tari_utilities::{hex::Hex, Hashable},
+    transactions::aggregated_body::AggregateBody,
+};
+use futures::{channel::mpsc, SinkExt, StreamExt};
+use log::*;
+use std::{
+    collections::VecDeque,
+    convert::TryFrom,
+    sync::{Arc, Mutex, MutexGuard},
+    time::{Duration, Instant},
+};
+use tari_comms::peer_manager::NodeId;
+use tokio::{
+    sync::{OwnedSemaphorePermit, Semaphore},
+    time,
+};
+
+const LOG_TARGET: &str = "c::bn::block_sync::downloader";
+/// How long an idle downloader waits before checking for ranges that other downloaders could not complete
+const QUEUE_WAIT_INTERVAL: Duration = Duration::from_millis(200);
+
+/// A range of block heights to download, both ends inclusive
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct HeightRange {
+    pub start: u64,
+    pub end: u64,
+}
+
+impl HeightRange {
+    pub fn new(start: u64, end: u64) -> Self {
+        Self { start, end }
+    }
+
+    pub fn len(&self) -> u64 {
+        (self.end + 1).saturating_sub(self.start)
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+/// Split the heights in `[start, end]` into ranges of at most `batch_size` blocks
+pub fn plan_height_ranges(start: u64, end: u64, batch_size: u64) -> VecDeque<HeightRange> {
+    let batch_size = batch_size.max(1);
+    let mut ranges = VecDeque::new();
+    let mut position = start;
+    while position <= end {
+        let range_end = position.saturating_add(batch_size - 1).min(end);
+        ranges.push_back(HeightRange::new(position, range_end));
+        position = range_end + 1;
+    }
+    ranges
+}
+
+/// The height ranges left to download, shared by the downloaders
+#[derive(Debug, Default)]
+pub struct DownloadQueue {
+    ranges: VecDeque<HeightRange>,
+    num_in_progress: usize,
+}
+
+enum NextRange {
+    Download(HeightRange),
+    /// Every range has been taken but some may still be put back
+    Wait,
+    Finished,
+}
+
+impl DownloadQueue {
+    pub fn new(ranges: VecDeque<HeightRange>) -> Self {
+        Self {
+            ranges,
+            num_in_progress: 0,
+        }
+    }
+
+    fn take(&mut self) -> NextRange {
+        match self.ranges.pop_front() {
+            Some(range) => {
+                self.num_in_progress += 1;
+                NextRange::Download(range)
+            },
+            None if self.num_in_progress > 0 => NextRange::Wait,
+            None => NextRange::Finished,
+        }
+    }
+
+    /// Mark a taken range as done. Any part of it that was not downloaded is downloaded next by another peer.
+    fn complete(&mut self, remaining: Option<HeightRange>) {
+        self.num_in_progress -= 1;
+        if let Some(range) = remaining {
+            self.ranges.push_front(range);
+        }
+    }
+}
+
+/// Blocks downloaded from a peer, starting at `start_height` and forming a chain on top of the block before it. The
+/// batch holds a download permit until it has been handed on for validation.
+pub struct DownloadedBatch {
+    pub start_height: u64,
+    pub blocks: Vec<Arc<ChainBlock>>,
+    pub download_time: Duration,
+    _permit: OwnedSemaphorePermit,
+}
+
+/// Downloads block bodies from one peer. Downloaders share a queue of height ranges, the part of a range that a
+/// downloader cannot complete is put back on the front of the queue for another peer and the downloader stops. A
+/// downloader must hold one of the shared permits to fetch a range, which bounds the number of batches held ahead of
+/// validation.
+pub struct BlockBatchDownloader<B> {
+    pub peer: NodeId,
+    pub client: rpc::BaseNodeSyncRpcClient,
+    pub db: AsyncBlockchainDb<B>,
+    pub queue: Arc<Mutex<DownloadQueue>>,
+    pub permits: Arc<Semaphore>,
+    pub batches: mpsc::Sender<DownloadedBatch>,
+}
+
+impl<B: BlockchainBackend + 'static> BlockBatchDownloader<B> {
+    pub async fn run(mut self) {
+        loop {
+            if self.batches.is_closed() {
+                break;
+            }
+            let permit = self.permits.clone().acquire_owned().await;
+            let next_range = self.lock_queue().take();
+            let range = match next_range {
+                NextRange::Download(range) => range,
+                NextRange::Wait => {
+                    drop(permit);
+                    time::delay_for(QUEUE_WAIT_INTERVAL).await;
+                    continue;
+                },
+                NextRange::Finished => break,
+            };
+
+            let timer = Instant::now();
+            let blocks = match self.download(range).await {
+                Ok(blocks) => blocks,
+                Err(err) => {
+                    debug!(
+                        target: LOG_TARGET,
+                        "Failed to download blocks #{} to #{} from `{}`: {}", range.start, range.end, self.peer, err
+                    );
+                    self.lock_queue().complete(Some(range));
+                    break;
+                },
+            };
+
+            let num_blocks = blocks.len() as u64;
+            let is_complete = num_blocks == range.len();
+            if is_complete {
+                self.lock_queue().complete(None);
+            } else {
+                debug!(
+                    target: LOG_TARGET,
+                    "Peer `{}` sent {} of {} requested block(s) from #{}",
+                    self.peer,
+                    num_blocks,
+                    range.len(),
+                    range.start
+                );
+                self.lock_queue()
+                    .complete(Some(HeightRange::new(range.start + num_blocks, range.end)));
+            }
+            if num_blocks > 0 {
+                let batch = DownloadedBatch {
+                    start_height: range.start,
+                    blocks,
+                    download_time: timer.elapsed(),
+                    _permit: permit,
+                };
+                if self.batches.send(batch).await.is_err() {
+                    break;
+                }
+            }
+            if !is_complete {
+                break;
+            }
+        }
+        debug!(target: LOG_TARGET, "Block downloader for `{}` stopped", self.peer);
+    }
+
+    fn lock_queue(&self) -> MutexGuard<'_, DownloadQueue> {
+        self.queue.lock().expect("block download queue lock poisoned")
+    }
+
+    async fn download(&mut self, range: HeightRange) -> Result<Vec<Arc<ChainBlock>>, BlockSyncError> {
+        let start_hash = self.db.fetch_chain_header(range.start - 1).await?.hash().clone();
+        let end_hash = self.db.fetch_chain_header(range.end).await?.hash().clone();
+        let request = SyncBlocksRequest {
+            start_hash: start_hash.clone(),
+            end_hash,
+        };
+
+        let mut block_stream = self.client.sync_blocks(request).await?;
+        let mut prev_hash = start_hash;
+        let mut blocks = Vec::with_capacity(range.len() as usize);
+        while let Some(block) = block_stream.next().await {
+            let block = block?;
+
+            let header = self
+                .db
+                .fetch_chain_header_by_block_hash(block.hash.clone())
+                .await?
+                .ok_or_else(|| {
+                    BlockSyncError::ReceivedInvalidBlockBody("Peer sent hash for block header we do not have".into())
+                })?;
+
+            if header.header().prev_hash != prev_hash {
+                return Err(BlockSyncError::PeerSentBlockThatDidNotFormAChain {
+                    expected: prev_hash.to_hex(),
+                    got: header.header().prev_hash.to_hex(),
+                });
+            }
+            prev_hash = header.hash().clone();
+
+            let body = block
+                .body
+                .map(AggregateBody::try_from)
+                .ok_or_else(|| BlockSyncError::ReceivedInvalidBlockBody("Block body was empty".to_string()))?
+                .map_err(BlockSyncError::ReceivedInvalidBlockBody)?;
+
+            blocks.push(Arc::new(header.upgrade_to_chain_block(body)));
+            if blocks.len() as u64 == range.len() {
+                break;
+            }
+        }
+        Ok(blocks)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::{plan_height_ranges, HeightRange};
+
+    #[test]
+    fn it_splits_heights_into_ranges() {
+        let ranges = plan_height_ranges(1, 10, 4).into_iter().collect::<Vec<_>>();
+        assert_eq!(ranges, vec![
+            HeightRange::new(1, 4),
+            HeightRange::new(5, 8),
+            HeightRange::new(9, 10)
+        ]);
+        assert_eq!(ranges.iter().map(|r| r.len()).sum::<u64>(), 10);
+
+        assert_eq!(plan_height_ranges(5, 5, 100).into_iter().collect::<Vec<_>>(), vec![
+            HeightRange::new(5, 5)
+        ]);
+        assert!(plan_height_ranges(6, 5, 100).is_empty());
+        assert_eq!(plan_height_ranges(1, 3, 0).len(), 3);
+    }
+}
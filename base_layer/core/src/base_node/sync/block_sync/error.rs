@@ -42,6 +42,8 @@ pub enum BlockSyncError {
     ConnectivityError(#[from] ConnectivityError),
     #[error("No sync peers available")]
     NoSyncPeers,
+    #[error("Every sync peer failed to provide blocks #{start} to #{end}")]
+    SyncFailedAllPeers { start: u64, end: u64 },
     #[error("Error fetching PoW: {0}")]
     PowError(#[from] PowError),
     //#[error("Expected to find header at height {0} however the header did not exist")]
@@ -20,21 +20,22 @@
 //  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 //  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-use super::error::BlockSyncError;
+use super::{
+    downloader::{plan_height_ranges, BlockBatchDownloader, DownloadQueue, DownloadedBatch},
+    error::BlockSyncError,
+};
 use crate::{
-    base_node::sync::{hooks::Hooks, rpc},
+    base_node::sync::{hooks::Hooks, rpc, BlockSyncConfig},
     chain_storage::{async_db::AsyncBlockchainDb, BlockchainBackend, ChainBlock},
-    proto::base_node::SyncBlocksRequest,
     tari_utilities::{hex::Hex, Hashable},
-    transactions::aggregated_body::AggregateBody,
     validation::CandidateBlockBodyValidation,
 };
-use futures::StreamExt;
+use futures::{channel::mpsc, future, SinkExt, StreamExt};
 use log::*;
 use num_format::{Locale, ToFormattedString};
 use std::{
-    convert::TryFrom,
-    sync::Arc,
+    collections::BTreeMap,
+    sync::{Arc, Mutex},
     time::{Duration, Instant},
 };
 use tari_comms::{
@@ -42,29 +43,47 @@ use tari_comms::{
     peer_manager::NodeId,
     PeerConnection,
 };
-use tokio::task;
+use tokio::{sync::Semaphore, task};
 
 const LOG_TARGET: &str = "c::bn::block_sync";
 
 pub struct BlockSynchronizer<B> {
+    config: BlockSyncConfig,
     db: AsyncBlockchainDb<B>,
     connectivity: ConnectivityRequester,
     sync_peer: Option<PeerConnection>,
+    helper_peers: Vec<NodeId>,
     block_validator: Arc<dyn CandidateBlockBodyValidation<B>>,
     hooks: Hooks,
 }
 
+/// The time spent in each stage of the block sync pipeline. Downloading is summed over all peers and stateless
+/// validation over all validating threads, so these can add up to more than the time the sync took.
+#[derive(Debug, Default, Clone, Copy)]
+struct BlockSyncTimings {
+    download: Duration,
+    stateless_validation: Duration,
+    chain_validation: Duration,
+    commit: Duration,
+    /// The time the commit stage spent waiting for the next validated block
+    commit_stalled: Duration,
+}
+
 impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
     pub fn new(
+        config: BlockSyncConfig,
         db: AsyncBlockchainDb<B>,
         connectivity: ConnectivityRequester,
         sync_peer: Option<PeerConnection>,
+        helper_peers: Vec<NodeId>,
         block_validator: Arc<dyn CandidateBlockBodyValidation<B>>,
     ) -> Self {
         Self {
+            config,
             db,
             connectivity,
             sync_peer,
+            helper_peers,
             block_validator,
             hooks: Default::default(),
         }
@@ -109,18 +128,78 @@ impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
         }
     }
 
+    /// Connect to the peers that download blocks alongside the sync peer. These are the given helper peers if there
+    /// are any, otherwise other connected base nodes. A helper that does not have the blocks drops out of the sync.
+    async fn connect_helper_peers(&mut self, sync_peer: &NodeId) -> Vec<PeerConnection> {
+        let max_helpers = self.config.max_block_download_peers.saturating_sub(1);
+        if max_helpers == 0 {
+            return Vec::new();
+        }
+        if self.helper_peers.is_empty() {
+            return self
+                .connectivity
+                .select_connections(ConnectivitySelection::random_nodes(max_helpers, vec![sync_peer.clone()]))
+                .await
+                .unwrap_or_else(|err| {
+                    debug!(target: LOG_TARGET, "Could not select block sync helper peers: {}", err);
+                    Vec::new()
+                });
+        }
+
+        let dials = self
+            .helper_peers
+            .iter()
+            .filter(|node_id| *node_id != sync_peer)
+            .take(max_helpers)
+            .map(|node_id| {
+                let mut connectivity = self.connectivity.clone();
+                let node_id = node_id.clone();
+                async move { connectivity.dial_peer(node_id).await }
+            });
+        future::join_all(dials)
+            .await
+            .into_iter()
+            .filter_map(|result| match result {
+                Ok(conn) => Some(conn),
+                Err(err) => {
+                    debug!(target: LOG_TARGET, "Failed to dial block sync helper peer: {}", err);
+                    None
+                },
+            })
+            .collect()
+    }
+
     async fn attempt_block_sync(&mut self, mut conn: PeerConnection) -> Result<(), BlockSyncError> {
-        let mut client = conn
+        let client = conn
             .connect_rpc_using_builder(rpc::BaseNodeSyncRpcClient::builder().with_deadline(Duration::from_secs(60)))
             .await?;
-        self.synchronize_blocks(conn.peer_node_id(), &mut client).await?;
+        let mut clients = vec![(conn.peer_node_id().clone(), client)];
+        for mut helper in self.connect_helper_peers(conn.peer_node_id()).await {
+            match helper
+                .connect_rpc_using_builder(
+                    rpc::BaseNodeSyncRpcClient::builder().with_deadline(Duration::from_secs(60)),
+                )
+                .await
+            {
+                Ok(client) => clients.push((helper.peer_node_id().clone(), client)),
+                Err(err) => debug!(
+                    target: LOG_TARGET,
+                    "Could not connect to block sync helper peer `{}`: {}",
+                    helper.peer_node_id(),
+                    err
+                ),
+            }
+        }
+        self.synchronize_blocks(clients).await?;
         Ok(())
     }
 
+    /// Download, validate and store the blocks up to the tip header. Blocks are downloaded in batches from every
+    /// client at once, checked in parallel with the checks that only need the block, then checked against the chain
+    /// state and committed in chain order. Every stage is bounded, so a slow stage holds back the stages before it.
     async fn synchronize_blocks(
         &mut self,
-        peer: &NodeId,
-        client: &mut rpc::BaseNodeSyncRpcClient,
+        clients: Vec<(NodeId, rpc::BaseNodeSyncRpcClient)>,
     ) -> Result<(), BlockSyncError> {
         let tip_header = self.db.fetch_last_header().await?;
         let local_metadata = self.db.get_chain_metadata().await?;
@@ -138,68 +217,87 @@ impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
         let chain_header = self.db.fetch_chain_header(best_height).await?;
 
         let best_full_block_hash = chain_header.accumulated_data().hash.clone();
+        let peers = clients.iter().map(|(peer, _)| peer.clone()).collect::<Vec<_>>();
         debug!(
             target: LOG_TARGET,
-            "Starting block sync from peer `{}`. Current best block is #{} `{}`. Syncing to #{} ({}).",
-            peer,
+            "Starting block sync from {} peer(s). Current best block is #{} `{}`. Syncing to #{} ({}).",
+            peers.len(),
             best_height,
             best_full_block_hash.to_hex(),
             tip_height,
             tip_hash.to_hex()
         );
-        let request = SyncBlocksRequest {
-            start_hash: best_full_block_hash.clone(),
-            // To the tip!
-            end_hash: tip_hash.clone(),
-        };
-
-        let mut block_stream = client.sync_blocks(request).await?;
-        let mut prev_hash = best_full_block_hash;
-        let mut current_block = None;
-        while let Some(block) = block_stream.next().await {
-            let block = block?;
-
-            let header = self
-                .db
-                .fetch_chain_header_by_block_hash(block.hash.clone())
-                .await?
-                .ok_or_else(|| {
-                    BlockSyncError::ReceivedInvalidBlockBody("Peer sent hash for block header we do not have".into())
-                })?;
-
-            let header_hash = header.hash().clone();
-
-            if header.header().prev_hash != prev_hash {
-                return Err(BlockSyncError::PeerSentBlockThatDidNotFormAChain {
-                    expected: prev_hash.to_hex(),
-                    got: header.header().prev_hash.to_hex(),
-                });
-            }
 
-            prev_hash = header_hash.clone();
+        let download_depth = self.config.block_download_depth.max(1);
+        let validation_depth = self.config.block_validation_depth.max(1);
+        let queue = Arc::new(Mutex::new(DownloadQueue::new(plan_height_ranges(
+            best_height + 1,
+            tip_height,
+            self.config.block_download_batch_size as u64,
+        ))));
+        let permits = Arc::new(Semaphore::new(download_depth));
+        let (batch_sender, batch_receiver) = mpsc::channel(download_depth);
+        for (peer, client) in clients {
+            task::spawn(
+                BlockBatchDownloader {
+                    peer,
+                    client,
+                    db: self.db.clone(),
+                    queue: queue.clone(),
+                    permits: permits.clone(),
+                    batches: batch_sender.clone(),
+                }
+                .run(),
+            );
+        }
+        // The batch stream ends once every downloader has stopped
+        drop(batch_sender);
 
-            let body = block
-                .body
-                .map(AggregateBody::try_from)
-                .ok_or_else(|| BlockSyncError::ReceivedInvalidBlockBody("Block body was empty".to_string()))?
-                .map_err(BlockSyncError::ReceivedInvalidBlockBody)?;
+        let (block_sender, block_receiver) = mpsc::channel(validation_depth);
+        let ordering = task::spawn(order_downloaded_batches(
+            batch_receiver,
+            best_height + 1,
+            tip_height,
+            block_sender,
+        ));
 
-            debug!(
-                target: LOG_TARGET,
-                "Validating block body #{} (PoW = {}, {})",
-                header.height(),
-                header.header().pow_algo(),
-                body.to_counts_string(),
-            );
+        let validator = self.block_validator.clone();
+        let mut validated_blocks = block_receiver
+            .map(move |block| {
+                let validator = validator.clone();
+                async move {
+                    let block = block?;
+                    let timer = Instant::now();
+                    let validating_block = block.clone();
+                    task::spawn_blocking(move || validator.validate_body_stateless(validating_block.block()))
+                        .await
+                        .expect("block validator panicked")?;
+                    Result::<_, BlockSyncError>::Ok((block, timer.elapsed()))
+                }
+            })
+            .buffered(validation_depth);
+
+        let mut timings = BlockSyncTimings::default();
+        let mut current_block = None;
+        loop {
+            let timer = Instant::now();
+            let (block, stateless_validation_time) = match validated_blocks.next().await {
+                Some(result) => result?,
+                None => break,
+            };
+            timings.commit_stalled += timer.elapsed();
+            timings.stateless_validation += stateless_validation_time;
 
             let timer = Instant::now();
-            let block = Arc::new(header.upgrade_to_chain_block(body));
-            self.validate_block(block.clone()).await?;
+            self.validate_block_against_chain(block.clone()).await?;
+            let chain_validation_time = timer.elapsed();
+            timings.chain_validation += chain_validation_time;
 
             debug!(
                 target: LOG_TARGET,
-                "Validated in {:.0?}. Storing block body #{} (PoW = {}, {})",
-                timer.elapsed(),
+                "Validated in {:.0?} (stateless checks {:.0?}). Storing block body #{} (PoW = {}, {})",
+                stateless_validation_time + chain_validation_time,
+                stateless_validation_time,
                 block.header().height,
                 block.header().pow_algo(),
                 block.block().body.to_counts_string(),
@@ -211,20 +309,21 @@ impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
                 .insert_block_body(block.clone())
                 .set_best_block(
                     block.height(),
-                    header_hash,
+                    block.hash().clone(),
                     block.accumulated_data().total_accumulated_difficulty,
                 )
                 .commit()
                 .await?;
+            let commit_time = timer.elapsed();
+            timings.commit += commit_time;
 
-            self.hooks
-                .call_on_progress_block_hooks(block.clone(), tip_height, &[peer.clone()]);
+            self.hooks.call_on_progress_block_hooks(block.clone(), tip_height, &peers);
 
             debug!(
                 target: LOG_TARGET,
                 "Block body #{} added in {:.0?}, Tot_acc_diff {}, Monero {}, SHA3 {}",
                 block.height(),
-                timer.elapsed(),
+                commit_time,
                 block
                     .accumulated_data()
                     .total_accumulated_difficulty
@@ -234,6 +333,7 @@ impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
             );
             current_block = Some(block);
         }
+        timings.download = ordering.await.expect("block batch ordering panicked");
 
         if let Some(block) = current_block {
             // Update metadata to last tip header
@@ -250,21 +350,66 @@ impl<B: BlockchainBackend + 'static> BlockSynchronizer<B> {
             self.hooks.call_on_complete_hooks(block);
         }
 
-        debug!(target: LOG_TARGET, "Completed block sync with peer `{}`", peer);
+        info!(
+            target: LOG_TARGET,
+            "Block sync stage times: download = {:.2?}, stateless validation = {:.2?}, chain validation = {:.2?}, \
+             commit = {:.2?}, commit waiting on earlier stages = {:.2?}",
+            timings.download,
+            timings.stateless_validation,
+            timings.chain_validation,
+            timings.commit,
+            timings.commit_stalled
+        );
+        debug!(target: LOG_TARGET, "Completed block sync with {} peer(s)", peers.len());
 
         Ok(())
     }
 
-    async fn validate_block(&self, block: Arc<ChainBlock>) -> Result<(), BlockSyncError> {
+    async fn validate_block_against_chain(&self, block: Arc<ChainBlock>) -> Result<(), BlockSyncError> {
         let validator = self.block_validator.clone();
 
         let db = self.db.clone();
         task::spawn_blocking(move || {
             let db = db.inner().db_read_access()?;
-            validator.validate_body(block.block(), &*db)?;
+            validator.validate_body_against_chain(block.block(), &*db)?;
             Result::<_, BlockSyncError>::Ok(())
         })
         .await
         .expect("block validator panicked")
     }
 }
+
+/// Pass the blocks of the downloaded batches on in chain order from `start_height`. Batches that arrive ahead of the
+/// next height are held until the batches before them arrive. Returns the total download time of the batches.
+async fn order_downloaded_batches(
+    mut batches: mpsc::Receiver<DownloadedBatch>,
+    start_height: u64,
+    end_height: u64,
+    mut blocks: mpsc::Sender<Result<Arc<ChainBlock>, BlockSyncError>>,
+) -> Duration {
+    let mut download_time = Duration::default();
+    let mut pending = BTreeMap::new();
+    let mut next_height = start_height;
+    while let Some(batch) = batches.next().await {
+        download_time += batch.download_time;
+        pending.insert(batch.start_height, batch);
+        while let Some(batch) = pending.remove(&next_height) {
+            next_height += batch.blocks.len() as u64;
+            for block in batch.blocks {
+                if blocks.send(Ok(block)).await.is_err() {
+                    return download_time;
+                }
+            }
+        }
+    }
+
+    if next_height <= end_height {
+        let _ = blocks
+            .send(Err(BlockSyncError::SyncFailedAllPeers {
+                start: next_height,
+                end: end_height,
+            }))
+            .await;
+    }
+    download_time
+}
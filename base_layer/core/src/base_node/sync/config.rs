@@ -31,6 +31,14 @@ pub struct BlockSyncConfig {
     pub ban_period: Duration,
     pub short_ban_period: Duration,
     pub sync_peers: Vec<NodeId>,
+    /// The maximum number of peers that block bodies are downloaded from at the same time
+    pub max_block_download_peers: usize,
+    /// The number of blocks requested from a peer at once
+    pub block_download_batch_size: usize,
+    /// The number of downloaded batches that may be held ahead of the next block to be committed
+    pub block_download_depth: usize,
+    /// The number of blocks that may be validated at the same time ahead of the next block to be committed
+    pub block_validation_depth: usize,
 }
 
 impl Default for BlockSyncConfig {
@@ -42,6 +50,10 @@ impl Default for BlockSyncConfig {
             ban_period: Duration::from_secs(30 * 60),
             short_ban_period: Duration::from_secs(60),
             sync_peers: Default::default(),
+            max_block_download_peers: 4,
+            block_download_batch_size: 100,
+            block_download_depth: 4,
+            block_validation_depth: 8,
         }
     }
 }
@@ -37,8 +37,10 @@ use crate::chain_storage::{async_db::AsyncBlockchainDb, BlockchainBackend};
 use crate::{
     proto,
     proto::base_node::{
+        BlockFilterResponse,
         FindChainSplitRequest,
         FindChainSplitResponse,
+        SyncBlockFiltersRequest,
         SyncBlocksRequest,
         SyncHeadersRequest,
         SyncKernelsRequest,
@@ -89,6 +91,12 @@ pub trait BaseNodeSyncService: Send + Sync + 'static {
 
     #[rpc(method = 8)]
     async fn sync_utxos(&self, request: Request<SyncUtxosRequest>) -> Result<Streaming<SyncUtxosResponse>, RpcStatus>;
+
+    #[rpc(method = 9)]
+    async fn sync_block_filters(
+        &self,
+        request: Request<SyncBlockFiltersRequest>,
+    ) -> Result<Streaming<BlockFilterResponse>, RpcStatus>;
 }
 
 #[cfg(feature = "base_node")]
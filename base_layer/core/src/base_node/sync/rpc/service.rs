@@ -27,8 +27,10 @@ use crate::{
     iterators::NonOverlappingIntegerPairIter,
     proto,
     proto::base_node::{
+        BlockFilterResponse,
         FindChainSplitRequest,
         FindChainSplitResponse,
+        SyncBlockFiltersRequest,
         SyncBlocksRequest,
         SyncHeadersRequest,
         SyncKernelsRequest,
@@ -37,10 +39,15 @@ use crate::{
         SyncUtxosResponse,
     },
 };
+use croaring::Bitmap;
 use futures::{channel::mpsc, stream, SinkExt};
 use log::*;
 use std::{cmp, time::Instant};
-use tari_comms::protocol::rpc::{Request, Response, RpcStatus, Streaming};
+use tari_comms::{
+    message::MessageExt,
+    protocol::rpc::{Request, Response, RpcStatus, Streaming},
+    Bytes,
+};
 use tari_crypto::tari_utilities::hex::Hex;
 use tokio::task;
 
@@ -408,9 +415,11 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
         let peer = request.context().peer_node_id();
         debug!(
             target: LOG_TARGET,
-            "Received sync_utxos request from {} (start = {}, include_pruned_utxos = {}, include_deleted_bitmaps = {})",
+            "Received sync_utxos request from {} (start = {}, end_mmr_index = {}, include_pruned_utxos = {}, \
+             include_deleted_bitmaps = {})",
             peer,
             req.start,
+            req.end_mmr_index,
             req.include_pruned_utxos,
             req.include_deleted_bitmaps
         );
@@ -427,16 +436,13 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                 Self { db, request }
             }
 
-            pub async fn run(self, mut tx: mpsc::Sender<Result<SyncUtxosResponse, RpcStatus>>) {
+            pub async fn run(self, mut tx: mpsc::Sender<Result<Bytes, RpcStatus>>) {
                 if let Err(err) = self.start_streaming(&mut tx).await {
                     let _ = tx.send(Err(err)).await;
                 }
             }
 
-            async fn start_streaming(
-                &self,
-                tx: &mut mpsc::Sender<Result<SyncUtxosResponse, RpcStatus>>,
-            ) -> Result<(), RpcStatus> {
+            async fn start_streaming(&self, tx: &mut mpsc::Sender<Result<Bytes, RpcStatus>>) -> Result<(), RpcStatus> {
                 let end_header = self
                     .db
                     .fetch_header_by_block_hash(self.request.end_header_hash.clone())
@@ -456,6 +462,31 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                         self.request.start, end_header.output_mmr_size
                     )));
                 }
+                // An end index of 0 streams to the end header
+                let end_index = match self.request.end_mmr_index {
+                    0 => end_header.output_mmr_size,
+                    end_index => end_index.min(end_header.output_mmr_size),
+                };
+                if end_index <= self.request.start {
+                    return Err(RpcStatus::bad_request(format!(
+                        "end index {} must be greater than the start index {}",
+                        end_index, self.request.start
+                    )));
+                }
+                if end_index < end_header.output_mmr_size && self.request.include_deleted_bitmaps {
+                    return Err(RpcStatus::bad_request(
+                        "An end index cannot be combined with include_deleted_bitmaps",
+                    ));
+                }
+
+                // The deleted bitmap as of the end header decides which outputs are sent pruned. It is the same for
+                // every block, so it is fetched once.
+                let (_, _, _, deleted) = self
+                    .db
+                    .fetch_block_accumulated_data(end_header_hash.clone())
+                    .await
+                    .map_err(RpcStatus::log_internal_error(LOG_TARGET))?
+                    .dissolve();
 
                 let prev_header = self
                     .db
@@ -496,7 +527,7 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                     );
 
                     let start = cmp::max(self.request.start, prev_header.output_mmr_size);
-                    let end = current_header.output_mmr_size - 1;
+                    let end = cmp::min(current_header.output_mmr_size, end_index) - 1;
 
                     if tx.is_closed() {
                         debug!(target: LOG_TARGET, "Exiting sync_utxos early because client has gone",);
@@ -511,34 +542,58 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                         end.saturating_sub(start).saturating_add(1),
                         current_header.height
                     );
-                    let (utxos, deleted_diff) = self
+                    // Outputs in the UTXO sync index are sent as they are stored, without being decoded
+                    let deleted_in_range = deleted_in_mmr_range(&deleted, start, end);
+                    let encoded = self
                         .db
-                        .fetch_utxos_by_mmr_position(start, end, end_header_hash.clone())
+                        .fetch_encoded_utxos_by_mmr_position(start, end, deleted_in_range.clone())
                         .await
                         .map_err(RpcStatus::log_internal_error(LOG_TARGET))?;
+                    let (utxos, deleted_diff) = match encoded {
+                        Some((utxos, deleted_diff)) => {
+                            let utxos = utxos
+                                .into_iter()
+                                .enumerate()
+                                // Only include pruned UTXOs if include_pruned_utxos is true
+                                .filter(|(_, utxo)| self.request.include_pruned_utxos || !utxo.is_pruned())
+                                .map(|(i, utxo)| {
+                                    SyncUtxosResponse::encode_with_utxo(utxo.as_bytes(), start + i as u64)
+                                })
+                                .collect::<Vec<_>>();
+                            (utxos, deleted_diff)
+                        },
+                        None => {
+                            let (utxos, deleted_diff) = self
+                                .db
+                                .fetch_utxos_by_mmr_position_with_deleted(start, end, deleted_in_range)
+                                .await
+                                .map_err(RpcStatus::log_internal_error(LOG_TARGET))?;
+                            let utxos = utxos
+                                .into_iter()
+                                .enumerate()
+                                .filter(|(_, utxo)| self.request.include_pruned_utxos || !utxo.is_pruned())
+                                .map(|(i, utxo)| {
+                                    let response = SyncUtxosResponse {
+                                        utxo_or_deleted: Some(
+                                            proto::base_node::sync_utxos_response::UtxoOrDeleted::Utxo(SyncUtxo::from(
+                                                utxo,
+                                            )),
+                                        ),
+                                        mmr_index: start + i as u64,
+                                    };
+                                    Bytes::from(response.to_encoded_bytes())
+                                })
+                                .collect::<Vec<_>>();
+                            (utxos, deleted_diff)
+                        },
+                    };
                     trace!(
                         target: LOG_TARGET,
                         "Loaded {} UTXO(s) and |deleted_diff| = {}",
                         utxos.len(),
                         deleted_diff.cardinality(),
                     );
-                    let mut utxos = stream::iter(
-                        utxos
-                            .into_iter()
-                            .enumerate()
-                            // Only include pruned UTXOs if include_pruned_utxos is true
-                            .filter(|(_, utxo)| self.request.include_pruned_utxos || !utxo.is_pruned())
-                            .map(|(i, utxo)| {
-                                SyncUtxosResponse {
-                                    utxo_or_deleted: Some(proto::base_node::sync_utxos_response::UtxoOrDeleted::Utxo(
-                                        SyncUtxo::from(utxo)
-                                    )),
-                                    mmr_index: start + i  as u64,
-                                }
-                            })
-                            .map(Ok)
-                            .map(Ok),
-                    );
+                    let mut utxos = stream::iter(utxos.into_iter().map(Ok).map(Ok));
 
                     // Ensure task stops if the peer prematurely stops their RPC session
                     if tx.send_all(&mut utxos).await.is_err() {
@@ -553,7 +608,7 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                             mmr_index: 0,
                         };
 
-                        if tx.send(Ok(bitmaps)).await.is_err() {
+                        if tx.send(Ok(Bytes::from(bitmaps.to_encoded_bytes()))).await.is_err() {
                             break;
                         }
                     }
@@ -566,6 +621,9 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
                     );
 
                     prev_header = current_header;
+                    if end + 1 >= end_index {
+                        break;
+                    }
                 }
 
                 debug!(
@@ -582,6 +640,115 @@ impl<B: BlockchainBackend + 'static> BaseNodeSyncService for BaseNodeSyncRpcServ
         let (tx, rx) = mpsc::channel(200);
         task::spawn(SyncUtxosTask::new(self.db(), request.into_message()).run(tx));
 
+        Ok(Streaming::encoded(rx))
+    }
+
+    async fn sync_block_filters(
+        &self,
+        request: Request<SyncBlockFiltersRequest>,
+    ) -> Result<Streaming<BlockFilterResponse>, RpcStatus> {
+        let peer = request.context().peer_node_id().clone();
+        let req = request.into_message();
+        debug!(
+            target: LOG_TARGET,
+            "Received sync_block_filters request from {} (start = {})", peer, req.start
+        );
+        const BATCH_SIZE: usize = 1000;
+        let (mut tx, rx) = mpsc::channel(BATCH_SIZE);
+        let db = self.db();
+
+        task::spawn(async move {
+            let end_header = match db
+                .fetch_header_by_block_hash(req.end_header_hash.clone())
+                .await
+                .or_not_found("BlockHeader", "hash", req.end_header_hash.to_hex())
+                .map_err(RpcStatus::log_internal_error(LOG_TARGET))
+            {
+                Ok(header) => header,
+                Err(err) => {
+                    let _ = tx.send(Err(err)).await;
+                    return;
+                },
+            };
+            if req.start >= end_header.output_mmr_size {
+                let _ = tx
+                    .send(Err(RpcStatus::bad_request(format!(
+                        "start index {} cannot be greater than the end header's output MMR size ({})",
+                        req.start, end_header.output_mmr_size
+                    ))))
+                    .await;
+                return;
+            }
+            // The header found is the first with an output MMR size of at least `start`. If its size is `start` the
+            // block ends just before the start position and is not included.
+            let start_height = match db
+                .fetch_header_containing_utxo_mmr(req.start)
+                .await
+                .map_err(RpcStatus::log_internal_error(LOG_TARGET))
+            {
+                Ok(header) if header.header().output_mmr_size > req.start => header.height(),
+                Ok(header) => header.height() + 1,
+                Err(err) => {
+                    let _ = tx.send(Err(err)).await;
+                    return;
+                },
+            };
+
+            let iter = NonOverlappingIntegerPairIter::new(start_height, end_header.height + 1, BATCH_SIZE);
+            for (start, end) in iter {
+                if tx.is_closed() {
+                    break;
+                }
+                debug!(target: LOG_TARGET, "Streaming block filters {} to {}", start, end);
+                let headers = match db
+                    .fetch_headers(start..=end)
+                    .await
+                    .map_err(RpcStatus::log_internal_error(LOG_TARGET))
+                {
+                    Ok(headers) => headers,
+                    Err(err) => {
+                        let _ = tx.send(Err(err)).await;
+                        break;
+                    },
+                };
+                for header in headers {
+                    let filter = match db
+                        .fetch_block_filter(header.height)
+                        .await
+                        .map_err(RpcStatus::log_internal_error(LOG_TARGET))
+                    {
+                        Ok(filter) => filter,
+                        Err(err) => {
+                            let _ = tx.send(Err(err)).await;
+                            return;
+                        },
+                    };
+                    let response = BlockFilterResponse {
+                        height: header.height,
+                        header_hash: header.hash(),
+                        output_mmr_size: header.output_mmr_size,
+                        filter: filter.map(|f| f.to_bytes()).unwrap_or_default(),
+                    };
+                    // Ensure task stops if the peer prematurely stops their RPC session
+                    if tx.send(Ok(response)).await.is_err() {
+                        return;
+                    }
+                }
+            }
+            debug!(target: LOG_TARGET, "Block filter sync to {} completed", peer);
+        });
         Ok(Streaming::new(rx))
     }
 }
+
+/// The positions in the output MMR range `start..=end` that are set in `deleted`
+fn deleted_in_mmr_range(deleted: &Bitmap, start: u64, end: u64) -> Bitmap {
+    let mut bitmap = Bitmap::create();
+    for position in start..=end {
+        let position = position as u32;
+        if deleted.contains(position) {
+            bitmap.add(position);
+        }
+    }
+    bitmap
+}
@@ -0,0 +1,291 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! Compact block filters. A block filter is a Golomb-coded set of the scripts of the outputs in a block, which lets a
+//! wallet test whether a block can contain one of its outputs without downloading the outputs of the block. A filter
+//! never gives a false negative, the false positive rate is `1 / FILTER_M` per queried item.
+
+use digest::Digest;
+use serde::{Deserialize, Serialize};
+use std::convert::TryInto;
+use tari_crypto::common::Blake256;
+
+/// The number of low bits of each hashed item that are stored verbatim in the filter
+const FILTER_P: u8 = 19;
+/// The inverse of the false positive rate of a filter
+const FILTER_M: u64 = 784_931;
+
+/// A Golomb-coded set over the output scripts of a block. Items are hashed together with the block hash, so the same
+/// hash that was used to build the filter has to be given when matching items against it.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct BlockFilter {
+    num_items: u32,
+    data: Vec<u8>,
+}
+
+impl BlockFilter {
+    /// Build the filter for the block with the given hash over the given items. Duplicate items are stored once.
+    pub fn new<'a, I: IntoIterator<Item = &'a [u8]>>(block_hash: &[u8], items: I) -> Self {
+        let mut items = items.into_iter().collect::<Vec<_>>();
+        items.sort_unstable();
+        items.dedup();
+        // The range is sized from the distinct items, which is the count stored in the filter and used by
+        // `matches_any`. Distinct items that hash to the same value are coded as a zero delta.
+        let range = (items.len() as u64).saturating_mul(FILTER_M);
+        let mut values = items
+            .into_iter()
+            .map(|item| hash_to_range(block_hash, item, range))
+            .collect::<Vec<_>>();
+        values.sort_unstable();
+
+        let mut writer = BitWriter::default();
+        let mut last = 0;
+        for value in values.iter() {
+            let delta = value - last;
+            for _ in 0..(delta >> FILTER_P) {
+                writer.write_bit(true);
+            }
+            writer.write_bit(false);
+            writer.write_bits(delta, FILTER_P);
+            last = *value;
+        }
+        Self {
+            num_items: values.len() as u32,
+            data: writer.into_bytes(),
+        }
+    }
+
+    /// Decode a filter from the bytes returned by [BlockFilter::to_bytes]
+    pub fn from_bytes(bytes: &[u8]) -> Result<Self, String> {
+        if bytes.len() < 4 {
+            return Err("Block filter is too short".to_string());
+        }
+        let (num_items, data) = bytes.split_at(4);
+        Ok(Self {
+            num_items: u32::from_le_bytes(num_items.try_into().expect("slice is 4 bytes")),
+            data: data.to_vec(),
+        })
+    }
+
+    /// Encode the filter as the number of items followed by the coded set. The encoding is never empty.
+    pub fn to_bytes(&self) -> Vec<u8> {
+        let mut bytes = Vec::with_capacity(4 + self.data.len());
+        bytes.extend_from_slice(&self.num_items.to_le_bytes());
+        bytes.extend_from_slice(&self.data);
+        bytes
+    }
+
+    pub fn num_items(&self) -> usize {
+        self.num_items as usize
+    }
+
+    /// Returns true if any of the items may be in the set of the block with the given hash. A filter that cannot be
+    /// decoded matches everything, so that the block is fetched rather than missed.
+    pub fn matches_any<'a, I: IntoIterator<Item = &'a [u8]>>(&self, block_hash: &[u8], items: I) -> bool {
+        if self.num_items == 0 {
+            return false;
+        }
+        let range = u64::from(self.num_items).saturating_mul(FILTER_M);
+        let mut queries = items
+            .into_iter()
+            .map(|item| hash_to_range(block_hash, item, range))
+            .collect::<Vec<_>>();
+        if queries.is_empty() {
+            return false;
+        }
+        queries.sort_unstable();
+
+        let mut reader = BitReader::new(&self.data);
+        let mut queries = queries.into_iter().peekable();
+        let mut value = 0u64;
+        for _ in 0..self.num_items {
+            let delta = match reader.read_golomb_rice() {
+                Some(d) => d,
+                None => return true,
+            };
+            value += delta;
+            while let Some(query) = queries.peek() {
+                if *query < value {
+                    queries.next();
+                } else {
+                    break;
+                }
+            }
+            match queries.peek() {
+                Some(query) if *query == value => return true,
+                Some(_) => {},
+                None => return false,
+            }
+        }
+        false
+    }
+}
+
+/// Hash an item of the block with the given hash to a value uniformly distributed in `[0, range)`
+fn hash_to_range(block_hash: &[u8], item: &[u8], range: u64) -> u64 {
+    let hash = Blake256::new().chain(block_hash).chain(item).finalize();
+    let value = u64::from_le_bytes(hash[..8].try_into().expect("hash is at least 8 bytes"));
+    ((u128::from(value) * u128::from(range)) >> 64) as u64
+}
+
+#[derive(Default)]
+struct BitWriter {
+    bytes: Vec<u8>,
+    used_bits: u8,
+}
+
+impl BitWriter {
+    fn write_bit(&mut self, bit: bool) {
+        if self.used_bits == 0 {
+            self.bytes.push(0);
+        }
+        if bit {
+            let last = self.bytes.len() - 1;
+            self.bytes[last] |= 0x80 >> self.used_bits;
+        }
+        self.used_bits = (self.used_bits + 1) % 8;
+    }
+
+    /// Write the `n` low bits of `value`, most significant bit first
+    fn write_bits(&mut self, value: u64, n: u8) {
+        for i in (0..n).rev() {
+            self.write_bit((value >> i) & 1 == 1);
+        }
+    }
+
+    fn into_bytes(self) -> Vec<u8> {
+        self.bytes
+    }
+}
+
+struct BitReader<'a> {
+    bytes: &'a [u8],
+    position: usize,
+}
+
+impl<'a> BitReader<'a> {
+    fn new(bytes: &'a [u8]) -> Self {
+        Self { bytes, position: 0 }
+    }
+
+    fn read_bit(&mut self) -> Option<bool> {
+        let byte = self.bytes.get(self.position / 8)?;
+        let bit = byte & (0x80 >> (self.position % 8)) != 0;
+        self.position += 1;
+        Some(bit)
+    }
+
+    fn read_bits(&mut self, n: u8) -> Option<u64> {
+        let mut value = 0u64;
+        for _ in 0..n {
+            value = (value << 1) | u64::from(self.read_bit()?);
+        }
+        Some(value)
+    }
+
+    fn read_golomb_rice(&mut self) -> Option<u64> {
+        let mut quotient = 0u64;
+        while self.read_bit()? {
+            quotient += 1;
+        }
+        let remainder = self.read_bits(FILTER_P)?;
+        Some((quotient << FILTER_P) | remainder)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::BlockFilter;
+
+    fn items(prefix: &str, n: usize) -> Vec<Vec<u8>> {
+        (0..n).map(|i| format!("{}-{}", prefix, i).into_bytes()).collect()
+    }
+
+    #[test]
+    fn it_matches_every_member() {
+        let block_hash = [1u8; 32];
+        let members = items("member", 500);
+        let filter = BlockFilter::new(&block_hash, members.iter().map(|i| i.as_slice()));
+        assert_eq!(filter.num_items(), 500);
+
+        for item in members.iter() {
+            assert!(filter.matches_any(&block_hash, vec![item.as_slice()]));
+        }
+        let non_members = items("non-member", 2000);
+        let mut queries = non_members.iter().map(|i| i.as_slice()).collect::<Vec<_>>();
+        queries.push(members[250].as_slice());
+        assert!(filter.matches_any(&block_hash, queries));
+    }
+
+    #[test]
+    fn it_rarely_matches_non_members() {
+        let block_hash = [2u8; 32];
+        let members = items("member", 100);
+        let filter = BlockFilter::new(&block_hash, members.iter().map(|i| i.as_slice()));
+
+        let false_positives = items("non-member", 10_000)
+            .iter()
+            .filter(|item| filter.matches_any(&block_hash, vec![item.as_slice()]))
+            .count();
+        assert!(false_positives < 5, "{} false positives", false_positives);
+        assert!(!filter.matches_any(&block_hash, Vec::<&[u8]>::new()));
+    }
+
+    #[test]
+    fn it_handles_empty_and_duplicate_sets() {
+        let block_hash = [3u8; 32];
+        let empty = BlockFilter::new(&block_hash, Vec::<&[u8]>::new());
+        assert_eq!(empty.num_items(), 0);
+        assert!(!empty.matches_any(&block_hash, vec![b"anything".as_ref()]));
+        assert!(!empty.to_bytes().is_empty());
+
+        let filter = BlockFilter::new(&block_hash, vec![b"script".as_ref(), b"script".as_ref()]);
+        assert_eq!(filter.num_items(), 1);
+        assert!(filter.matches_any(&block_hash, vec![b"script".as_ref()]));
+
+        // Repeated scripts alongside distinct ones, as in a block with several outputs sharing a script
+        let members = items("member", 20);
+        let mut with_duplicates = members.iter().map(|i| i.as_slice()).collect::<Vec<_>>();
+        with_duplicates.extend(vec![b"script".as_ref(); 5]);
+        let filter = BlockFilter::new(&block_hash, with_duplicates);
+        assert_eq!(filter.num_items(), 21);
+        assert!(filter.matches_any(&block_hash, vec![b"script".as_ref()]));
+        for item in members.iter() {
+            assert!(filter.matches_any(&block_hash, vec![item.as_slice()]));
+        }
+    }
+
+    #[test]
+    fn it_round_trips_through_bytes() {
+        let block_hash = [4u8; 32];
+        let members = items("member", 50);
+        let filter = BlockFilter::new(&block_hash, members.iter().map(|i| i.as_slice()));
+        let decoded = BlockFilter::from_bytes(&filter.to_bytes()).unwrap();
+        assert_eq!(decoded, filter);
+        assert!(decoded.matches_any(&block_hash, vec![members[7].as_slice()]));
+        assert!(BlockFilter::from_bytes(&[0u8; 3]).is_err());
+
+        // A truncated filter is treated as matching rather than silently missing outputs
+        let truncated = BlockFilter::from_bytes(&filter.to_bytes()[..8]).unwrap();
+        assert!(truncated.matches_any(&block_hash, vec![b"not a member".as_ref()]));
+    }
+}
@@ -23,6 +23,8 @@
 #[cfg(feature = "base_node")]
 mod block;
 #[cfg(any(feature = "base_node", feature = "base_node_proto"))]
+pub mod block_filter;
+#[cfg(any(feature = "base_node", feature = "base_node_proto"))]
 pub mod block_header;
 
 #[cfg(feature = "base_node")]
@@ -34,6 +36,8 @@ mod new_blockheader_template;
 #[cfg(feature = "base_node")]
 pub use block::{Block, BlockBuilder, BlockValidationError, NewBlock};
 #[cfg(any(feature = "base_node", feature = "base_node_proto"))]
+pub use block_filter::BlockFilter;
+#[cfg(any(feature = "base_node", feature = "base_node_proto"))]
 pub use block_header::{BlockHeader, BlockHeaderValidationError};
 #[cfg(feature = "base_node")]
 pub use new_block_template::NewBlockTemplate;
@@ -21,7 +21,7 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
-    blocks::{Block, BlockHeader, NewBlockTemplate},
+    blocks::{Block, BlockFilter, BlockHeader, NewBlockTemplate},
     chain_storage::{
         accumulated_data::BlockHeaderAccumulatedData,
         BlockAccumulatedData,
@@ -32,6 +32,7 @@ use crate::{
         ChainHeader,
         ChainStorageError,
         DbTransaction,
+        EncodedSyncUtxo,
         HistoricalBlock,
         HorizonData,
         MmrTree,
@@ -144,6 +145,10 @@ impl<B: BlockchainBackend + 'static> AsyncBlockchainDb<B> {
 
     make_async_fn!(fetch_utxos_by_mmr_position(start: u64, end: u64, end_header_hash: HashOutput) -> (Vec<PrunedOutput>, Bitmap), "fetch_utxos_by_mmr_position");
 
+    make_async_fn!(fetch_utxos_by_mmr_position_with_deleted(start: u64, end: u64, deleted: Bitmap) -> (Vec<PrunedOutput>, Bitmap), "fetch_utxos_by_mmr_position_with_deleted");
+
+    make_async_fn!(fetch_encoded_utxos_by_mmr_position(start: u64, end: u64, deleted: Bitmap) -> Option<(Vec<EncodedSyncUtxo>, Bitmap)>, "fetch_encoded_utxos_by_mmr_position");
+
     //---------------------------------- Kernel --------------------------------------------//
     make_async_fn!(fetch_kernel_by_excess_sig(excess_sig: Signature) -> Option<(TransactionKernel, HashOutput)>, "fetch_kernel_by_excess_sig");
 
@@ -214,6 +219,8 @@ impl<B: BlockchainBackend + 'static> AsyncBlockchainDb<B> {
 
     make_async_fn!(fetch_block_accumulated_data_by_height(height: u64) -> BlockAccumulatedData, "fetch_block_accumulated_data_by_height");
 
+    make_async_fn!(fetch_block_filter(height: u64) -> Option<BlockFilter>, "fetch_block_filter");
+
     //---------------------------------- Misc. --------------------------------------------//
     make_async_fn!(fetch_block_timestamps(start_hash: HashOutput) -> RollingVec<EpochTime>, "fetch_block_timestamps");
 
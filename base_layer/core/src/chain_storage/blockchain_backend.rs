@@ -1,5 +1,5 @@
 use crate::{
-    blocks::{Block, BlockHeader},
+    blocks::{Block, BlockFilter, BlockHeader},
     chain_storage::{
         pruned_output::PrunedOutput,
         BlockAccumulatedData,
@@ -10,6 +10,7 @@ use crate::{
         DbKey,
         DbTransaction,
         DbValue,
+        EncodedSyncUtxo,
         HorizonData,
         MmrTree,
     },
@@ -75,6 +76,10 @@ pub trait BlockchainBackend: Send + Sync {
         height: u64,
     ) -> Result<Option<BlockAccumulatedData>, ChainStorageError>;
 
+    /// Fetch the compact filter over the output scripts of the block at the given height. Blocks that were added
+    /// before filters were stored have no filter.
+    fn fetch_block_filter(&self, height: u64) -> Result<Option<BlockFilter>, ChainStorageError>;
+
     /// Fetch all the kernels in a block
     fn fetch_kernels_in_block(&self, header_hash: &HashOutput) -> Result<Vec<TransactionKernel>, ChainStorageError>;
 
@@ -101,6 +106,16 @@ pub trait BlockchainBackend: Send + Sync {
         deleted: &Bitmap,
     ) -> Result<(Vec<PrunedOutput>, Bitmap), ChainStorageError>;
 
+    /// Fetch the outputs in the MMR position range already encoded for UTXO sync, in the same form as
+    /// `fetch_utxos_by_mmr_position`. Returns None if any of the outputs are missing from the UTXO sync index, which is
+    /// the case for outputs that were added before the index existed.
+    fn fetch_encoded_utxos_by_mmr_position(
+        &self,
+        start: u64,
+        end: u64,
+        deleted: &Bitmap,
+    ) -> Result<Option<(Vec<EncodedSyncUtxo>, Bitmap)>, ChainStorageError>;
+
     /// Fetch a specific output. Returns the output and the leaf index in the output MMR
     fn fetch_output(
         &self,
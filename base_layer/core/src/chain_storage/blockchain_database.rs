@@ -20,7 +20,7 @@
 // WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 use crate::{
-    blocks::{Block, BlockHeader, NewBlockTemplate},
+    blocks::{Block, BlockFilter, BlockHeader, NewBlockTemplate},
     chain_storage::{
         accumulated_data::{BlockAccumulatedData, BlockHeaderAccumulatedData},
         consts::{
@@ -35,6 +35,7 @@ use crate::{
         BlockchainBackend,
         ChainBlock,
         ChainHeader,
+        EncodedSyncUtxo,
         HistoricalBlock,
         HorizonData,
         MmrTree,
@@ -357,6 +358,31 @@ where B: BlockchainBackend
         db.fetch_utxos_by_mmr_position(start, end, accum_data.deleted())
     }
 
+    /// Returns the outputs in the MMR position range, using the given deleted bitmap instead of fetching the bitmap of
+    /// an end header. This lets a caller that fetches many ranges against the same block fetch its bitmap only once.
+    pub fn fetch_utxos_by_mmr_position_with_deleted(
+        &self,
+        start: u64,
+        end: u64,
+        deleted: Bitmap,
+    ) -> Result<(Vec<PrunedOutput>, Bitmap), ChainStorageError> {
+        let db = self.db_read_access()?;
+        db.fetch_utxos_by_mmr_position(start, end, &deleted)
+    }
+
+    /// Returns the outputs in the MMR position range encoded for UTXO sync, or None if they are not all in the UTXO
+    /// sync index, in which case `fetch_utxos_by_mmr_position_with_deleted` must be used. `deleted` is the deleted
+    /// bitmap of the block being synced to, only the positions in the range are read from it.
+    pub fn fetch_encoded_utxos_by_mmr_position(
+        &self,
+        start: u64,
+        end: u64,
+        deleted: Bitmap,
+    ) -> Result<Option<(Vec<EncodedSyncUtxo>, Bitmap)>, ChainStorageError> {
+        let db = self.db_read_access()?;
+        db.fetch_encoded_utxos_by_mmr_position(start, end, &deleted)
+    }
+
     /// Returns the block header at the given block height.
     pub fn fetch_header(&self, height: u64) -> Result<Option<BlockHeader>, ChainStorageError> {
         let db = self.db_read_access()?;
@@ -596,6 +622,12 @@ where B: BlockchainBackend
         )
     }
 
+    /// Returns the compact filter of the block at the given height, or None if the block has no stored filter.
+    pub fn fetch_block_filter(&self, height: u64) -> Result<Option<BlockFilter>, ChainStorageError> {
+        let db = self.db_read_access()?;
+        db.fetch_block_filter(height)
+    }
+
     /// Returns the orphan block with the given hash.
     pub fn fetch_orphan(&self, hash: HashOutput) -> Result<Block, ChainStorageError> {
         let db = self.db_read_access()?;
@@ -930,14 +962,9 @@ pub fn calculate_mmr_roots<T: BlockchainBackend>(db: &T, block: &Block) -> Resul
     let mut witness_mmr = MerkleMountainRange::<HashDigest, _>::new(range_proofs);
     let mut input_mmr = MutableMmr::<HashDigest, _>::new(Vec::new(), Bitmap::create())?;
 
-    for kernel in body.kernels().iter() {
-        kernel_mmr.push(kernel.hash())?;
-    }
-
-    for output in body.outputs().iter() {
-        output_mmr.push(output.hash())?;
-        witness_mmr.push(output.witness_hash())?;
-    }
+    kernel_mmr.push_many(body.kernels().iter().map(|kernel| kernel.hash()))?;
+    output_mmr.push_many(body.outputs().iter().map(|output| output.hash()))?;
+    witness_mmr.push_many(body.outputs().iter().map(|output| output.witness_hash()))?;
 
     for input in body.inputs().iter() {
         // Search the DB for the output leaf index so that it can be marked as spent/deleted.
@@ -0,0 +1,134 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+use crate::{
+    chain_storage::ChainStorageError,
+    proto::base_node as proto,
+    transactions::{transaction::TransactionOutput, types::HashOutput},
+};
+use prost::Message;
+use std::convert::TryFrom;
+
+/// An output from the UTXO sync index, held as the encoded `SyncUtxo` message that is sent to syncing peers.
+#[derive(Debug, Clone)]
+pub struct EncodedSyncUtxo {
+    is_pruned: bool,
+    message: Vec<u8>,
+}
+
+impl EncodedSyncUtxo {
+    pub fn is_pruned(&self) -> bool {
+        self.is_pruned
+    }
+
+    /// The encoded `SyncUtxo` message
+    pub fn as_bytes(&self) -> &[u8] {
+        &self.message
+    }
+
+    pub fn into_bytes(self) -> Vec<u8> {
+        self.message
+    }
+
+    /// The value stored in the UTXO sync index for an output. It holds the encoded pruned form of the output, prefixed
+    /// with its length as a big-endian u32, followed by the encoded full form if the output has not been pruned.
+    pub(crate) fn index_value(
+        output_hash: HashOutput,
+        witness_hash: HashOutput,
+        output: Option<TransactionOutput>,
+    ) -> Vec<u8> {
+        let pruned = proto::SyncUtxo {
+            utxo: Some(proto::sync_utxo::Utxo::PrunedOutput(proto::PrunedOutput {
+                hash: output_hash,
+                witness_hash,
+            })),
+        };
+        let full = output.map(|output| proto::SyncUtxo {
+            utxo: Some(proto::sync_utxo::Utxo::Output(output.into())),
+        });
+        let full_len = full.as_ref().map(Message::encoded_len).unwrap_or(0);
+        let mut value = Vec::with_capacity(4 + pruned.encoded_len() + full_len);
+        value.extend_from_slice(&(pruned.encoded_len() as u32).to_be_bytes());
+        pruned.encode(&mut value).expect("Vec<u8> provides capacity as needed");
+        if let Some(full) = full {
+            full.encode(&mut value).expect("Vec<u8> provides capacity as needed");
+        }
+        value
+    }
+
+    /// Drops the full form of the output from an index value, leaving only the pruned form
+    pub(crate) fn pruned_index_value(value: &[u8]) -> Result<&[u8], ChainStorageError> {
+        let pruned_len = Self::pruned_len(value)?;
+        Ok(&value[..4 + pruned_len])
+    }
+
+    /// Reads an output from an index value, taking the pruned form if the output has been pruned or if it is deleted
+    /// as of the block being synced to.
+    pub(crate) fn from_index_value(value: &[u8], is_deleted: bool) -> Result<Self, ChainStorageError> {
+        let pruned_len = Self::pruned_len(value)?;
+        let (pruned, full) = value[4..].split_at(pruned_len);
+        let is_pruned = is_deleted || full.is_empty();
+        let message = if is_pruned { pruned } else { full };
+        Ok(Self {
+            is_pruned,
+            message: message.to_vec(),
+        })
+    }
+
+    fn pruned_len(value: &[u8]) -> Result<usize, ChainStorageError> {
+        let corrupt = || ChainStorageError::CriticalError("Corrupt UTXO sync index value".to_string());
+        if value.len() < 4 {
+            return Err(corrupt());
+        }
+        let mut len = [0u8; 4];
+        len.copy_from_slice(&value[..4]);
+        let len = usize::try_from(u32::from_be_bytes(len)).map_err(|_| corrupt())?;
+        if value.len() < 4 + len {
+            return Err(corrupt());
+        }
+        Ok(len)
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use crate::proto::base_node::sync_utxo::Utxo;
+
+    #[test]
+    fn it_reads_the_pruned_form_of_a_deleted_or_pruned_output() {
+        let value = EncodedSyncUtxo::index_value(vec![1; 32], vec![2; 32], None);
+        let utxo = EncodedSyncUtxo::from_index_value(&value, false).unwrap();
+        assert!(utxo.is_pruned());
+        let decoded = proto::SyncUtxo::decode(utxo.as_bytes()).unwrap();
+        match decoded.utxo {
+            Some(Utxo::PrunedOutput(pruned)) => {
+                assert_eq!(pruned.hash, vec![1; 32]);
+                assert_eq!(pruned.witness_hash, vec![2; 32]);
+            },
+            _ => panic!("Expected a pruned output"),
+        }
+
+        let pruned_value = EncodedSyncUtxo::pruned_index_value(&value).unwrap();
+        assert_eq!(pruned_value, value.as_slice());
+        assert!(EncodedSyncUtxo::from_index_value(&[0, 0, 0, 9, 1], false).is_err());
+    }
+}
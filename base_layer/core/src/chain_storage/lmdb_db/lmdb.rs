@@ -129,6 +129,26 @@ where
     })
 }
 
+/// Inserts or replaces a value that is stored as-is rather than serialized, so that it can be read back without
+/// deserializing it
+pub fn lmdb_replace_raw<K>(
+    txn: &WriteTransaction<'_>,
+    db: &Database,
+    key: &K,
+    val: &[u8],
+) -> Result<(), ChainStorageError>
+where
+    K: AsLmdbBytes + ?Sized,
+{
+    txn.access().put(&db, key, val, put::Flags::empty()).map_err(|e| {
+        error!(
+            target: LOG_TARGET,
+            "Could not replace raw value in lmdb transaction: {:?}", e
+        );
+        ChainStorageError::AccessError(e.to_string())
+    })
+}
+
 /// Deletes the given key. An error is returned if the key does not exist
 pub fn lmdb_delete<K>(txn: &WriteTransaction<'_>, db: &Database, key: &K) -> Result<(), ChainStorageError>
 where K: AsLmdbBytes + ?Sized {
@@ -209,6 +229,57 @@ where
     }
 }
 
+/// Returns a copy of a value that was stored as-is with [lmdb_replace_raw]
+pub fn lmdb_get_raw<K>(
+    txn: &ConstTransaction<'_>,
+    db: &Database,
+    key: &K,
+) -> Result<Option<Vec<u8>>, ChainStorageError>
+where
+    K: AsLmdbBytes + ?Sized,
+{
+    let access = txn.access();
+    match access.get::<K, [u8]>(&db, key).to_opt() {
+        Ok(v) => Ok(v.map(|v| v.to_vec())),
+        Err(e) => {
+            error!(target: LOG_TARGET, "Could not get raw value from lmdb: {:?}", e);
+            Err(ChainStorageError::AccessError(e.to_string()))
+        },
+    }
+}
+
+/// Calls `f` with the key and value bytes of each row with a key in the range `start..=end`, in key order. The slices
+/// point into the memory map, nothing is copied or deserialized unless `f` does so.
+pub fn lmdb_for_each_raw_in_range<F>(
+    txn: &ConstTransaction<'_>,
+    db: &Database,
+    start: &[u8],
+    end: &[u8],
+    mut f: F,
+) -> Result<(), ChainStorageError>
+where
+    F: FnMut(&[u8], &[u8]) -> Result<(), ChainStorageError>,
+{
+    let access = txn.access();
+    let mut cursor = txn.cursor(db).map_err(|e| {
+        error!(target: LOG_TARGET, "Could not get read cursor from lmdb: {:?}", e);
+        ChainStorageError::AccessError(e.to_string())
+    })?;
+
+    let mut row = match cursor.seek_range_k::<[u8], [u8]>(&access, start).to_opt()? {
+        Some(r) => r,
+        None => return Ok(()),
+    };
+    while row.0 <= end {
+        f(row.0, row.1)?;
+        row = match cursor.next::<[u8], [u8]>(&access).to_opt()? {
+            Some(r) => r,
+            None => break,
+        };
+    }
+    Ok(())
+}
+
 pub fn lmdb_get_multiple<K, V>(txn: &ConstTransaction<'_>, db: &Database, key: &K) -> Result<Vec<V>, ChainStorageError>
 where
     K: AsLmdbBytes + FromLmdbBytes + ?Sized,
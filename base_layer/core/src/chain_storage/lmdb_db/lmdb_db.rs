@@ -20,7 +20,7 @@
 // WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 use crate::{
-    blocks::{block_header::BlockHeader, Block},
+    blocks::{block_header::BlockHeader, Block, BlockFilter},
     chain_storage::{
         accumulated_data::{BlockAccumulatedData, BlockHeaderAccumulatedData, DeletedBitmap},
         db_transaction::{DbKey, DbTransaction, DbValue, WriteOperation},
@@ -34,18 +34,22 @@ use crate::{
                 lmdb_fetch_keys_starting_with,
                 lmdb_filter_map_values,
                 lmdb_first_after,
+                lmdb_for_each_raw_in_range,
                 lmdb_get,
                 lmdb_get_multiple,
+                lmdb_get_raw,
                 lmdb_insert,
                 lmdb_insert_dup,
                 lmdb_last,
                 lmdb_len,
                 lmdb_replace,
+                lmdb_replace_raw,
             },
             TransactionInputRowData,
             TransactionKernelRowData,
             TransactionOutputRowData,
             LMDB_DB_BLOCK_ACCUMULATED_DATA,
+            LMDB_DB_BLOCK_FILTERS,
             LMDB_DB_BLOCK_HASHES,
             LMDB_DB_HEADERS,
             LMDB_DB_HEADER_ACCUMULATED_DATA,
@@ -63,10 +67,12 @@ use crate::{
             LMDB_DB_TXOS_HASH_TO_INDEX,
             LMDB_DB_UTXOS,
             LMDB_DB_UTXO_MMR_SIZE_INDEX,
+            LMDB_DB_UTXO_SYNC_INDEX,
         },
         BlockchainBackend,
         ChainBlock,
         ChainHeader,
+        EncodedSyncUtxo,
         HorizonData,
         MmrTree,
         PrunedOutput,
@@ -83,7 +89,7 @@ use fs2::FileExt;
 use lmdb_zero::{ConstTransaction, Database, Environment, ReadTransaction, WriteTransaction};
 use log::*;
 use serde::{Deserialize, Serialize};
-use std::{convert::TryFrom, fmt, fs, fs::File, path::Path, sync::Arc, time::Instant};
+use std::{cmp, convert::TryFrom, fmt, fs, fs::File, path::Path, sync::Arc, time::Instant};
 use tari_common_types::{
     chain_metadata::ChainMetadata,
     types::{BlockHash, BLOCK_HASH_LENGTH},
@@ -96,6 +102,9 @@ type DatabaseRef = Arc<Database<'static>>;
 
 pub const LOG_TARGET: &str = "c::cs::lmdb_db::lmdb_db";
 
+/// The number of blocks whose outputs are added to the UTXO sync index in one write transaction by the backfill
+const UTXO_SYNC_INDEX_BACKFILL_BLOCKS: u64 = 1000;
+
 struct OutputKey {
     header_hash: HashOutput,
     mmr_position: u32,
@@ -123,7 +132,9 @@ pub struct LMDBDatabase {
     header_accumulated_data_db: DatabaseRef,
     block_accumulated_data_db: DatabaseRef,
     block_hashes_db: DatabaseRef,
+    block_filters_db: DatabaseRef,
     utxos_db: DatabaseRef,
+    utxo_sync_index: DatabaseRef,
     inputs_db: DatabaseRef,
     txos_hash_to_index_db: DatabaseRef,
     kernels_db: DatabaseRef,
@@ -149,7 +160,9 @@ impl LMDBDatabase {
             header_accumulated_data_db: get_database(&store, LMDB_DB_HEADER_ACCUMULATED_DATA)?,
             block_accumulated_data_db: get_database(&store, LMDB_DB_BLOCK_ACCUMULATED_DATA)?,
             block_hashes_db: get_database(&store, LMDB_DB_BLOCK_HASHES)?,
+            block_filters_db: get_database(&store, LMDB_DB_BLOCK_FILTERS)?,
             utxos_db: get_database(&store, LMDB_DB_UTXOS)?,
+            utxo_sync_index: get_database(&store, LMDB_DB_UTXO_SYNC_INDEX)?,
             inputs_db: get_database(&store, LMDB_DB_INPUTS)?,
             txos_hash_to_index_db: get_database(&store, LMDB_DB_TXOS_HASH_TO_INDEX)?,
             kernels_db: get_database(&store, LMDB_DB_KERNELS)?,
@@ -166,10 +179,83 @@ impl LMDBDatabase {
             env_config: store.env_config(),
             _file_lock: Arc::new(file_lock),
         };
+        res.backfill_utxo_sync_index()?;
 
         Ok(res)
     }
 
+    /// Adds the outputs that were stored before the UTXO sync index existed to the index. Once the index holds an entry
+    /// for every output this does nothing, so the outputs are only read the first time an older database is opened.
+    fn backfill_utxo_sync_index(&self) -> Result<(), ChainStorageError> {
+        let tip_height = {
+            let txn = self.read_transaction()?;
+            if self.is_utxo_sync_index_complete(&txn)? {
+                return Ok(());
+            }
+            match self.fetch_last_header_in_txn(&txn)? {
+                Some(header) => header.height,
+                None => return Ok(()),
+            }
+        };
+
+        info!(target: LOG_TARGET, "Adding existing outputs to the UTXO sync index");
+        let timer = Instant::now();
+        let mut num_indexed = 0;
+        let mut batch_start = 0;
+        while batch_start <= tip_height {
+            let last_height = cmp::min(batch_start + UTXO_SYNC_INDEX_BACKFILL_BLOCKS - 1, tip_height);
+            let write_txn = self.write_transaction()?;
+            for height in batch_start..=last_height {
+                let accum_data =
+                    lmdb_get::<_, BlockHeaderAccumulatedData>(&write_txn, &self.header_accumulated_data_db, &height)?
+                        .ok_or_else(|| ChainStorageError::ValueNotFound {
+                        entity: "BlockHeader".to_string(),
+                        field: "height".to_string(),
+                        value: height.to_string(),
+                    })?;
+                let rows = lmdb_fetch_keys_starting_with::<TransactionOutputRowData>(
+                    accum_data.hash.to_hex().as_str(),
+                    &write_txn,
+                    &self.utxos_db,
+                )?;
+                for row in rows {
+                    let index_key = row.mmr_position.to_be_bytes();
+                    if lmdb_exists(&write_txn, &self.utxo_sync_index, &index_key)? {
+                        continue;
+                    }
+                    lmdb_replace_raw(
+                        &write_txn,
+                        &self.utxo_sync_index,
+                        &index_key,
+                        &EncodedSyncUtxo::index_value(row.hash, row.witness_hash, row.output),
+                    )?;
+                    num_indexed += 1;
+                }
+            }
+            write_txn
+                .commit()
+                .map_err(|e| ChainStorageError::AccessError(e.to_string()))?;
+            debug!(
+                target: LOG_TARGET,
+                "UTXO sync index backfilled to height {}/{}", last_height, tip_height
+            );
+            batch_start = last_height + 1;
+        }
+        info!(
+            target: LOG_TARGET,
+            "Added {} output(s) to the UTXO sync index in {:.2?}",
+            num_indexed,
+            timer.elapsed()
+        );
+        Ok(())
+    }
+
+    /// True if every stored output has an entry in the UTXO sync index. Entries are added and removed together with
+    /// the outputs, so comparing the number of entries is enough.
+    fn is_utxo_sync_index_complete(&self, txn: &ConstTransaction<'_>) -> Result<bool, ChainStorageError> {
+        Ok(lmdb_len(txn, &self.utxo_sync_index)? == lmdb_len(txn, &self.utxos_db)?)
+    }
+
     /// Try to establish a read lock on the LMDB database. If an exclusive write lock has been previously acquired, this
     /// method will block until that lock is released.
     fn read_transaction(&self) -> Result<ReadTransaction<'_>, ChainStorageError> {
@@ -353,6 +439,15 @@ impl LMDBDatabase {
         let result = output.output.take();
         // output.output is None
         lmdb_replace(txn, &self.utxos_db, key_string, &output)?;
+        let index_key = output.mmr_position.to_be_bytes();
+        if let Some(value) = lmdb_get_raw(txn, &self.utxo_sync_index, &index_key)? {
+            lmdb_replace_raw(
+                txn,
+                &self.utxo_sync_index,
+                &index_key,
+                EncodedSyncUtxo::pruned_index_value(&value)?,
+            )?;
+        }
         Ok(result)
     }
 
@@ -377,6 +472,12 @@ impl LMDBDatabase {
             &(mmr_position, key_string.clone()),
             "txos_hash_to_index_db",
         )?;
+        lmdb_replace_raw(
+            txn,
+            &self.utxo_sync_index,
+            &mmr_position.to_be_bytes(),
+            &EncodedSyncUtxo::index_value(output_hash.clone(), witness_hash.clone(), Some(output.clone())),
+        )?;
         lmdb_insert(
             txn,
             &*self.utxos_db,
@@ -417,6 +518,12 @@ impl LMDBDatabase {
             &(mmr_position, key_string.clone()),
             "txos_hash_to_index_db",
         )?;
+        lmdb_replace_raw(
+            txn,
+            &self.utxo_sync_index,
+            &mmr_position.to_be_bytes(),
+            &EncodedSyncUtxo::index_value(output_hash.clone(), witness_hash.clone(), None),
+        )?;
         lmdb_insert(
             txn,
             &*self.utxos_db,
@@ -688,11 +795,18 @@ impl LMDBDatabase {
             .fetch_height_from_hash(&write_txn, &hash)
             .or_not_found("Block", "hash", hash.to_hex())?;
         lmdb_delete(&write_txn, &self.block_accumulated_data_db, &height)?;
+        if lmdb_exists(&write_txn, &self.block_filters_db, &height)? {
+            lmdb_delete(&write_txn, &self.block_filters_db, &height)?;
+        }
         let rows = lmdb_delete_keys_starting_with::<TransactionOutputRowData>(&write_txn, &self.utxos_db, &hash_hex)?;
 
         for utxo in rows {
             trace!(target: LOG_TARGET, "Deleting UTXO `{}`", to_hex(&utxo.hash));
             lmdb_delete(&write_txn, &self.txos_hash_to_index_db, utxo.hash.as_slice())?;
+            let index_key = utxo.mmr_position.to_be_bytes();
+            if lmdb_exists(&write_txn, &self.utxo_sync_index, &index_key)? {
+                lmdb_delete(&write_txn, &self.utxo_sync_index, &index_key)?;
+            }
         }
         debug!(target: LOG_TARGET, "Deleting kernels...");
         let kernels =
@@ -792,6 +906,10 @@ impl LMDBDatabase {
 
         let (inputs, outputs, kernels) = body.dissolve();
 
+        let scripts = outputs.iter().map(|o| o.script.as_bytes()).collect::<Vec<_>>();
+        let filter = BlockFilter::new(&block_hash, scripts.iter().map(|s| s.as_slice()));
+        lmdb_insert(txn, &self.block_filters_db, &header.height, &filter, "block_filters_db")?;
+
         let data = if header.height == 0 {
             BlockAccumulatedData::default()
         } else {
@@ -1042,6 +1160,55 @@ impl LMDBDatabase {
         lmdb_get(&txn, &self.block_accumulated_data_db, &height).map_err(Into::into)
     }
 
+    /// Returns the heights of the first and last blocks that contain the outputs in the MMR position range
+    /// `start..=end`
+    fn fetch_heights_containing_utxo_mmr_range(
+        &self,
+        txn: &ConstTransaction<'_>,
+        start: u64,
+        end: u64,
+    ) -> Result<(u64, u64), ChainStorageError> {
+        let start_height =
+            lmdb_first_after(txn, &self.output_mmr_size_index, &(start + 1).to_be_bytes())?.ok_or_else(|| {
+                ChainStorageError::InvalidQuery(format!(
+                    "Unable to find block height from start output MMR index {}",
+                    start
+                ))
+            })?;
+        let end_height: u64 =
+            lmdb_first_after(txn, &self.output_mmr_size_index, &(end + 1).to_be_bytes())?.unwrap_or(start_height);
+        Ok((start_height, end_height))
+    }
+
+    /// Builds a bitmap of the UTXO MMR positions that were deleted in the blocks from `start_height` to `end_height`
+    fn fetch_deleted_bitmap_difference(
+        &self,
+        txn: &ConstTransaction<'_>,
+        start_height: u64,
+        end_height: u64,
+    ) -> Result<Bitmap, ChainStorageError> {
+        let mut difference_bitmap = Bitmap::create();
+        for height in start_height..=end_height {
+            // Builds a BitMap of the deleted UTXO MMR indexes that occurred at the current height
+            let mut diff_bitmap = self
+                .fetch_block_accumulated_data(txn, height)
+                .or_not_found("BlockAccumulatedData", "height", height.to_string())?
+                .deleted()
+                .clone();
+            if height > 0 {
+                let prev_accum = self.fetch_block_accumulated_data(txn, height - 1).or_not_found(
+                    "BlockAccumulatedData",
+                    "height",
+                    height.to_string(),
+                )?;
+                diff_bitmap.xor_inplace(prev_accum.deleted());
+            }
+            difference_bitmap.or_inplace(&diff_bitmap);
+        }
+        difference_bitmap.run_optimize();
+        Ok(difference_bitmap)
+    }
+
     #[allow(clippy::ptr_arg)]
     fn fetch_height_from_hash(
         &self,
@@ -1064,6 +1231,16 @@ impl LMDBDatabase {
     }
 }
 
+/// The number of outputs in the MMR position range `start..=end`
+fn utxo_mmr_range_size(start: u64, end: u64) -> Result<usize, ChainStorageError> {
+    end.checked_sub(start)
+        .and_then(|v| v.checked_add(1))
+        .and_then(|v| usize::try_from(v).ok())
+        .ok_or_else(|| {
+            ChainStorageError::InvalidQuery("fetch_utxos_by_mmr_position: end is less than start".to_string())
+        })
+}
+
 pub fn create_lmdb_database<P: AsRef<Path>>(path: P, config: LMDBConfig) -> Result<LMDBDatabase, ChainStorageError> {
     let flags = db::CREATE;
     let _ = std::fs::create_dir_all(&path);
@@ -1073,13 +1250,15 @@ pub fn create_lmdb_database<P: AsRef<Path>>(path: P, config: LMDBConfig) -> Resu
     let lmdb_store = LMDBBuilder::new()
         .set_path(path)
         .set_env_config(config)
-        .set_max_number_of_databases(20)
+        .set_max_number_of_databases(22)
         .add_database(LMDB_DB_METADATA, flags)
         .add_database(LMDB_DB_HEADERS, flags | db::INTEGERKEY)
         .add_database(LMDB_DB_HEADER_ACCUMULATED_DATA, flags | db::INTEGERKEY)
         .add_database(LMDB_DB_BLOCK_ACCUMULATED_DATA, flags | db::INTEGERKEY)
         .add_database(LMDB_DB_BLOCK_HASHES, flags)
+        .add_database(LMDB_DB_BLOCK_FILTERS, flags | db::INTEGERKEY)
         .add_database(LMDB_DB_UTXOS, flags)
+        .add_database(LMDB_DB_UTXO_SYNC_INDEX, flags)
         .add_database(LMDB_DB_INPUTS, flags)
         .add_database(LMDB_DB_TXOS_HASH_TO_INDEX, flags)
         .add_database(LMDB_DB_KERNELS, flags)
@@ -1384,6 +1563,11 @@ impl BlockchainBackend for LMDBDatabase {
         self.fetch_block_accumulated_data(&txn, height)
     }
 
+    fn fetch_block_filter(&self, height: u64) -> Result<Option<BlockFilter>, ChainStorageError> {
+        let txn = self.read_transaction()?;
+        lmdb_get(&txn, &self.block_filters_db, &height).map_err(Into::into)
+    }
+
     fn fetch_kernels_in_block(&self, header_hash: &HashOutput) -> Result<Vec<TransactionKernel>, ChainStorageError> {
         let txn = self.read_transaction()?;
         Ok(
@@ -1496,15 +1680,7 @@ impl BlockchainBackend for LMDBDatabase {
         deleted: &Bitmap,
     ) -> Result<(Vec<PrunedOutput>, Bitmap), ChainStorageError> {
         let txn = self.read_transaction()?;
-        let start_height = lmdb_first_after(&txn, &self.output_mmr_size_index, &(start + 1).to_be_bytes())?
-            .ok_or_else(|| {
-                ChainStorageError::InvalidQuery(format!(
-                    "Unable to find block height from start output MMR index {}",
-                    start
-                ))
-            })?;
-        let end_height: u64 =
-            lmdb_first_after(&txn, &self.output_mmr_size_index, &(end + 1).to_be_bytes())?.unwrap_or(start_height);
+        let (start_height, end_height) = self.fetch_heights_containing_utxo_mmr_range(&txn, start, end)?;
 
         let previous_mmr_count = if start_height == 0 {
             0
@@ -1515,13 +1691,7 @@ impl BlockchainBackend for LMDBDatabase {
             header.output_mmr_size
         };
 
-        let total_size = end
-            .checked_sub(start)
-            .and_then(|v| v.checked_add(1))
-            .and_then(|v| usize::try_from(v).ok())
-            .ok_or_else(|| {
-                ChainStorageError::InvalidQuery("fetch_utxos_by_mmr_position: end is less than start".to_string())
-            })?;
+        let total_size = utxo_mmr_range_size(start, end)?;
         let mut result = Vec::with_capacity(total_size);
 
         let mut skip_amount = (start - previous_mmr_count) as usize;
@@ -1535,7 +1705,6 @@ impl BlockchainBackend for LMDBDatabase {
             previous_mmr_count,
             skip_amount
         );
-        let mut difference_bitmap = Bitmap::create();
 
         for height in start_height..=end_height {
             let accum_data =
@@ -1573,29 +1742,62 @@ impl BlockchainBackend for LMDBDatabase {
                 }),
             );
 
-            // Builds a BitMap of the deleted UTXO MMR indexes that occurred at the current height
-            let mut diff_bitmap = self
-                .fetch_block_accumulated_data(&txn, height)
-                .or_not_found("BlockAccumulatedData", "height", height.to_string())?
-                .deleted()
-                .clone();
-            if height > 0 {
-                let prev_accum = self.fetch_block_accumulated_data(&txn, height - 1).or_not_found(
-                    "BlockAccumulatedData",
-                    "height",
-                    height.to_string(),
-                )?;
-                diff_bitmap.xor_inplace(prev_accum.deleted());
-            }
-            difference_bitmap.or_inplace(&diff_bitmap);
-
             skip_amount = 0;
         }
 
-        difference_bitmap.run_optimize();
+        let difference_bitmap = self.fetch_deleted_bitmap_difference(&txn, start_height, end_height)?;
         Ok((result, difference_bitmap))
     }
 
+    fn fetch_encoded_utxos_by_mmr_position(
+        &self,
+        start: u64,
+        end: u64,
+        deleted: &Bitmap,
+    ) -> Result<Option<(Vec<EncodedSyncUtxo>, Bitmap)>, ChainStorageError> {
+        let txn = self.read_transaction()?;
+        if !self.is_utxo_sync_index_complete(&txn)? {
+            debug!(target: LOG_TARGET, "UTXO sync index is incomplete");
+            return Ok(None);
+        }
+        let (start_height, end_height) = self.fetch_heights_containing_utxo_mmr_range(&txn, start, end)?;
+        let total_size = utxo_mmr_range_size(start, end)?;
+        let start_key = u32::try_from(start).map_err(|_| {
+            ChainStorageError::InvalidQuery("fetch_encoded_utxos_by_mmr_position: start is out of range".to_string())
+        })?;
+        let end_key = u32::try_from(end).unwrap_or(u32::MAX);
+
+        let mut result = Vec::with_capacity(total_size);
+        lmdb_for_each_raw_in_range(
+            &txn,
+            &self.utxo_sync_index,
+            &start_key.to_be_bytes(),
+            &end_key.to_be_bytes(),
+            |key, value| {
+                let mut position = [0u8; 4];
+                position.copy_from_slice(key);
+                let position = u32::from_be_bytes(position);
+                result.push(EncodedSyncUtxo::from_index_value(value, deleted.contains(position))?);
+                Ok(())
+            },
+        )?;
+        // Outputs added before the index existed are not in it
+        if result.len() != total_size {
+            debug!(
+                target: LOG_TARGET,
+                "UTXO sync index holds {} of the {} outputs from {} to {}",
+                result.len(),
+                total_size,
+                start,
+                end
+            );
+            return Ok(None);
+        }
+
+        let difference_bitmap = self.fetch_deleted_bitmap_difference(&txn, start_height, end_height)?;
+        Ok(Some((result, difference_bitmap)))
+    }
+
     fn fetch_output(
         &self,
         output_hash: &HashOutput,
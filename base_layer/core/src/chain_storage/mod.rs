@@ -64,6 +64,9 @@ pub use db_transaction::{DbKey, DbTransaction, DbValue, WriteOperation};
 mod mmr_tree;
 pub use mmr_tree::*;
 
+mod encoded_sync_utxo;
+pub use encoded_sync_utxo::EncodedSyncUtxo;
+
 mod error;
 pub use error::{ChainStorageError, Optional, OrNotFound};
 
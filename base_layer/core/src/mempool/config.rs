@@ -58,6 +58,11 @@ pub struct MempoolServiceConfig {
     pub initial_sync_num_peers: usize,
     /// The maximum number of transactions to sync in a single sync session Default: 10_000
     pub initial_sync_max_transactions: usize,
+    /// The maximum number of transactions received from peers that can wait to be validated. Transaction messages
+    /// that arrive while the queue is full are dropped and counted as rejected. Default: 1_000
+    pub admission_queue_size: usize,
+    /// The maximum number of queued transactions validated together. Default: 50
+    pub admission_batch_size: usize,
 }
 
 impl Default for MempoolServiceConfig {
@@ -66,6 +71,8 @@ impl Default for MempoolServiceConfig {
             request_timeout: consts::MEMPOOL_SERVICE_REQUEST_TIMEOUT,
             initial_sync_num_peers: 2,
             initial_sync_max_transactions: 10_000,
+            admission_queue_size: 1_000,
+            admission_batch_size: 50,
         }
     }
 }
@@ -31,9 +31,17 @@ use crate::{
         TxStorageResponse,
     },
     transactions::{transaction::Transaction, types::Signature},
-    validation::MempoolTransactionValidation,
+    validation::{MempoolTransactionValidation, ValidationError},
 };
-use std::sync::{Arc, RwLock};
+use log::*;
+use rayon::prelude::*;
+use std::sync::{
+    atomic::{AtomicU64, Ordering},
+    Arc,
+    RwLock,
+};
+
+pub const LOG_TARGET: &str = "c::mp::mempool";
 
 /// The Mempool consists of an Unconfirmed Transaction Pool, Pending Pool, Orphan Pool and Reorg Pool and is responsible
 /// for managing and maintaining all unconfirmed transactions have not yet been included in a block, and transactions
@@ -41,31 +49,68 @@ use std::sync::{Arc, RwLock};
 #[derive(Clone)]
 pub struct Mempool {
     pool_storage: Arc<RwLock<MempoolStorage>>,
+    validator: Arc<dyn MempoolTransactionValidation>,
+    /// The number of blocks and reorgs processed, changed while the mempool write lock is held
+    chain_updates: Arc<AtomicU64>,
 }
 
 impl Mempool {
     /// Create a new Mempool with an UnconfirmedPool, OrphanPool, PendingPool and ReOrgPool.
     pub fn new(config: MempoolConfig, validator: Arc<dyn MempoolTransactionValidation>) -> Self {
         Self {
-            pool_storage: Arc::new(RwLock::new(MempoolStorage::new(config, validator))),
+            pool_storage: Arc::new(RwLock::new(MempoolStorage::new(config, validator.clone()))),
+            validator,
+            chain_updates: Arc::new(AtomicU64::new(0)),
         }
     }
 
     /// Insert an unconfirmed transaction into the Mempool. The transaction *MUST* have passed through the validation
-    /// pipeline already and will thus always be internally consistent by this stage
+    /// pipeline already and will thus always be internally consistent by this stage. The transaction is validated
+    /// before the mempool lock is taken, so the lock is usually only held to store it. If a block or reorg was
+    /// processed in the meantime the transaction is validated again under the lock.
     pub fn insert(&self, tx: Arc<Transaction>) -> Result<TxStorageResponse, MempoolError> {
-        self.pool_storage
+        let chain_updates = self.chain_updates.load(Ordering::Acquire);
+        let validation_result = self.validator.validate(&tx);
+        let mut pool_storage = self
+            .pool_storage
             .write()
-            .map_err(|e| MempoolError::BackendError(e.to_string()))?
-            .insert(tx)
+            .map_err(|e| MempoolError::BackendError(e.to_string()))?;
+        let validation_result = if self.chain_updated_since(chain_updates) {
+            self.validator.validate(&tx)
+        } else {
+            validation_result
+        };
+        pool_storage.insert_validated(tx, validation_result)
+    }
+
+    /// Insert a batch of unconfirmed transactions into the Mempool. The transactions are validated in parallel
+    /// without holding the mempool lock, which is then taken once to store all of them. If a block or reorg was
+    /// processed in the meantime the transactions are validated again under the lock. Returns where each transaction
+    /// was stored, in the order they were given.
+    pub fn insert_all(&self, txs: Vec<Arc<Transaction>>) -> Result<Vec<TxStorageResponse>, MempoolError> {
+        let chain_updates = self.chain_updates.load(Ordering::Acquire);
+        let mut validation_results = txs.par_iter().map(|tx| self.validator.validate(tx)).collect::<Vec<_>>();
+        let mut pool_storage = self
+            .pool_storage
+            .write()
+            .map_err(|e| MempoolError::BackendError(e.to_string()))?;
+        if self.chain_updated_since(chain_updates) {
+            validation_results = txs.iter().map(|tx| self.validator.validate(tx)).collect();
+        }
+        txs.into_iter()
+            .zip(validation_results)
+            .map(|(tx, validation_result)| pool_storage.insert_validated(tx, validation_result))
+            .collect()
     }
 
     /// Update the Mempool based on the received published block.
     pub fn process_published_block(&self, published_block: Arc<Block>) -> Result<(), MempoolError> {
-        self.pool_storage
+        let mut pool_storage = self
+            .pool_storage
             .write()
-            .map_err(|e| MempoolError::BackendError(e.to_string()))?
-            .process_published_block(published_block)
+            .map_err(|e| MempoolError::BackendError(e.to_string()))?;
+        self.chain_updates.fetch_add(1, Ordering::AcqRel);
+        pool_storage.process_published_block(published_block)
     }
 
     /// In the event of a ReOrg, resubmit all ReOrged transactions into the Mempool and process each newly introduced
@@ -75,10 +120,12 @@ impl Mempool {
         removed_blocks: Vec<Arc<Block>>,
         new_blocks: Vec<Arc<Block>>,
     ) -> Result<(), MempoolError> {
-        self.pool_storage
+        let mut pool_storage = self
+            .pool_storage
             .write()
-            .map_err(|e| MempoolError::BackendError(e.to_string()))?
-            .process_reorg(removed_blocks, new_blocks)
+            .map_err(|e| MempoolError::BackendError(e.to_string()))?;
+        self.chain_updates.fetch_add(1, Ordering::AcqRel);
+        pool_storage.process_reorg(removed_blocks, new_blocks)
     }
 
     /// Returns all unconfirmed transaction stored in the Mempool, except the transactions stored in the ReOrgPool.
@@ -107,6 +154,22 @@ impl Mempool {
             .has_tx_with_excess_sig(excess_sig)
     }
 
+    /// Check which of the specified transactions are stored in the Mempool, taking the mempool lock once for all of
+    /// them.
+    pub fn has_txs_with_excess_sigs(
+        &self,
+        excess_sigs: Vec<Signature>,
+    ) -> Result<Vec<TxStorageResponse>, MempoolError> {
+        let pool_storage = self
+            .pool_storage
+            .read()
+            .map_err(|e| MempoolError::BackendError(e.to_string()))?;
+        excess_sigs
+            .into_iter()
+            .map(|excess_sig| pool_storage.has_tx_with_excess_sig(excess_sig))
+            .collect()
+    }
+
     /// Gathers and returns the stats of the Mempool.
     pub fn stats(&self) -> Result<StatsResponse, MempoolError> {
         self.pool_storage
@@ -122,4 +185,18 @@ impl Mempool {
             .map_err(|e| MempoolError::BackendError(e.to_string()))?
             .state()
     }
+
+    /// Returns true if a block or reorg was processed since `chain_updates` was read. A validation that started before
+    /// then may have passed inputs that are now spent or a maturity that no longer holds, so it has to be redone. Must
+    /// be called with the mempool write lock held.
+    fn chain_updated_since(&self, chain_updates: u64) -> bool {
+        let updated = self.chain_updates.load(Ordering::Acquire) != chain_updates;
+        if updated {
+            debug!(
+                target: LOG_TARGET,
+                "The chain was updated during validation, validating again under the mempool lock"
+            );
+        }
+        updated
+    }
 }
@@ -62,6 +62,17 @@ impl MempoolStorage {
     /// Insert an unconfirmed transaction into the Mempool. The transaction *MUST* have passed through the validation
     /// pipeline already and will thus always be internally consistent by this stage
     pub fn insert(&mut self, tx: Arc<Transaction>) -> Result<TxStorageResponse, MempoolError> {
+        let validation_result = self.validator.validate(&tx);
+        self.insert_validated(tx, validation_result)
+    }
+
+    /// Insert an unconfirmed transaction that has already been checked by the mempool validator. The result of the
+    /// validation decides which pool, if any, the transaction is stored in.
+    pub fn insert_validated(
+        &mut self,
+        tx: Arc<Transaction>,
+        validation_result: Result<(), ValidationError>,
+    ) -> Result<TxStorageResponse, MempoolError> {
         debug!(
             target: LOG_TARGET,
             "Inserting tx into mempool: {}",
@@ -71,7 +82,7 @@ impl MempoolStorage {
                 .map(|k| k.excess_sig.get_signature().to_hex())
                 .unwrap_or_else(|| "None".into())
         );
-        match self.validator.validate(&tx) {
+        match validation_result {
             Ok(()) => {
                 self.unconfirmed_pool.insert(tx, None)?;
                 Ok(TxStorageResponse::UnconfirmedPool)
@@ -33,7 +33,7 @@ use crate::{
     transactions::transaction::Transaction,
 };
 use log::*;
-use std::sync::Arc;
+use std::{collections::HashSet, sync::Arc};
 use tari_comms::peer_manager::NodeId;
 use tari_crypto::tari_utilities::hex::Hex;
 use tokio::sync::broadcast;
@@ -107,6 +107,55 @@ impl MempoolInboundHandlers {
         self.submit_transaction(tx, exclude_peers).await.map(|_| ())
     }
 
+    /// Handle a batch of inbound transactions from remote peers. Transactions that are already in the mempool, or
+    /// repeated in the batch, are dropped before validation. The rest are validated together and the ones that were
+    /// accepted to the unconfirmed pool are propagated. Returns the number of transactions that were dropped as
+    /// duplicates and the storage response of every other transaction.
+    pub async fn handle_transactions(
+        &mut self,
+        txs: Vec<(Transaction, NodeId)>,
+    ) -> Result<(usize, Vec<TxStorageResponse>), MempoolServiceError> {
+        let num_received = txs.len();
+        let mut seen = HashSet::with_capacity(num_received);
+        let txs = txs
+            .into_iter()
+            .filter(|(tx, _)| seen.insert(tx.body.kernels()[0].excess_sig.clone()))
+            .collect::<Vec<_>>();
+        let excess_sigs = txs
+            .iter()
+            .map(|(tx, _)| tx.body.kernels()[0].excess_sig.clone())
+            .collect();
+        let stored = async_mempool::has_txs_with_excess_sigs(self.mempool.clone(), excess_sigs).await?;
+        let (txs, source_peers): (Vec<_>, Vec<_>) = txs
+            .into_iter()
+            .zip(stored)
+            .filter(|(_, tx_storage)| !tx_storage.is_stored())
+            .map(|((tx, source_peer), _)| (Arc::new(tx), source_peer))
+            .unzip();
+        let num_duplicates = num_received - txs.len();
+        if txs.is_empty() {
+            return Ok((num_duplicates, Vec::new()));
+        }
+
+        let responses = async_mempool::insert_all(self.mempool.clone(), txs.clone()).await?;
+        for ((tx, source_peer), tx_storage) in txs.into_iter().zip(source_peers).zip(&responses) {
+            let kernel_excess_sig = tx.body.kernels()[0].excess_sig.get_signature().to_hex();
+            debug!(
+                target: LOG_TARGET,
+                "Transaction inserted into mempool: {}, pool: {}.", kernel_excess_sig, tx_storage
+            );
+            // propagate the tx if it was accepted to the unconfirmed pool
+            if matches!(tx_storage, TxStorageResponse::UnconfirmedPool) {
+                debug!(
+                    target: LOG_TARGET,
+                    "Propagate transaction ({}) to network.", kernel_excess_sig,
+                );
+                self.outbound_nmi.propagate_tx((*tx).clone(), vec![source_peer]).await?;
+            }
+        }
+        Ok((num_duplicates, responses))
+    }
+
     // Submits a transaction to the mempool and propagate valid transactions.
     async fn submit_transaction(
         &mut self,
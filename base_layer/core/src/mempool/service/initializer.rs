@@ -39,7 +39,10 @@ use crate::{
 };
 use futures::{channel::mpsc, future, Stream, StreamExt};
 use log::*;
-use std::{convert::TryFrom, sync::Arc};
+use std::{
+    convert::TryFrom,
+    sync::{atomic::AtomicUsize, Arc},
+};
 use tari_comms_dht::Dht;
 use tari_p2p::{
     comms_connector::{PeerMessage, SubscriptionFactory},
@@ -96,10 +99,11 @@ impl MempoolServiceInitializer {
             .filter_map(ok_or_skip_result)
     }
 
-    /// Create a stream of 'New Transaction` messages
-    fn inbound_transaction_stream(&self) -> impl Stream<Item = DomainMessage<Transaction>> {
+    /// Create a stream of 'New Transaction` messages. Messages dropped because the stream lagged behind are added to
+    /// `num_shed`.
+    fn inbound_transaction_stream(&self, num_shed: Arc<AtomicUsize>) -> impl Stream<Item = DomainMessage<Transaction>> {
         self.inbound_message_subscription_factory
-            .get_subscription(TariMessageType::NewTransaction, SUBSCRIPTION_LABEL)
+            .get_subscription_with_lag_count(TariMessageType::NewTransaction, SUBSCRIPTION_LABEL, num_shed)
             .filter_map(extract_transaction)
     }
 }
@@ -141,7 +145,8 @@ impl ServiceInitializer for MempoolServiceInitializer {
         // Create streams for receiving Mempool service requests and response messages from comms
         let inbound_request_stream = self.inbound_request_stream();
         let inbound_response_stream = self.inbound_response_stream();
-        let inbound_transaction_stream = self.inbound_transaction_stream();
+        let num_shed_transactions = Arc::new(AtomicUsize::new(0));
+        let inbound_transaction_stream = self.inbound_transaction_stream(num_shed_transactions.clone());
 
         // Connect MempoolOutboundServiceHandle to MempoolService
         let (request_sender, request_receiver) = reply_channel::unbounded();
@@ -178,6 +183,7 @@ impl ServiceInitializer for MempoolServiceInitializer {
                 inbound_request_stream,
                 inbound_response_stream,
                 inbound_transaction_stream,
+                num_shed_transactions,
                 local_request_stream,
                 block_event_stream: base_node.get_block_event_stream(),
                 request_receiver,
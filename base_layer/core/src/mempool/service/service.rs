@@ -34,6 +34,7 @@ use crate::{
             MempoolResponse,
         },
         MempoolServiceConfig,
+        TxStorageResponse,
     },
     proto,
     transactions::transaction::Transaction,
@@ -47,7 +48,15 @@ use futures::{
 };
 use log::*;
 use rand::rngs::OsRng;
-use std::{convert::TryInto, sync::Arc, time::Duration};
+use std::{
+    cmp,
+    convert::TryInto,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+    time::{Duration, Instant},
+};
 use tari_common_types::waiting_requests::{generate_request_key, RequestKey, WaitingRequests};
 use tari_comms::peer_manager::NodeId;
 use tari_comms_dht::{
@@ -62,6 +71,9 @@ use tokio::task;
 
 const LOG_TARGET: &str = "c::mempool::service::service";
 
+/// How often the admission queue depth and the outcome of the transactions received from peers are reported
+const ADMISSION_REPORT_INTERVAL: Duration = Duration::from_secs(60);
+
 /// A convenience struct to hold all the Mempool service streams
 pub struct MempoolStreams<SOutReq, SInReq, SInRes, STxIn, SLocalReq> {
     pub outbound_request_stream: SOutReq,
@@ -69,6 +81,8 @@ pub struct MempoolStreams<SOutReq, SInReq, SInRes, STxIn, SLocalReq> {
     pub inbound_request_stream: SInReq,
     pub inbound_response_stream: SInRes,
     pub inbound_transaction_stream: STxIn,
+    /// Counts the transaction messages that were dropped before reaching the admission queue
+    pub num_shed_transactions: Arc<AtomicUsize>,
     pub local_request_stream: SLocalReq,
     pub block_event_stream: BlockEventReceiver,
     pub request_receiver: reply_channel::TryReceiver<MempoolRequest, MempoolResponse, MempoolServiceError>,
@@ -113,7 +127,7 @@ impl MempoolService {
         SOutReq: Stream<Item = RequestContext<MempoolRequest, Result<MempoolResponse, MempoolServiceError>>>,
         SInReq: Stream<Item = DomainMessage<mempool_proto::MempoolServiceRequest>>,
         SInRes: Stream<Item = DomainMessage<mempool_proto::MempoolServiceResponse>>,
-        STxIn: Stream<Item = DomainMessage<Transaction>>,
+        STxIn: Stream<Item = DomainMessage<Transaction>> + Send + 'static,
         SLocalReq: Stream<Item = RequestContext<MempoolRequest, Result<MempoolResponse, MempoolServiceError>>>,
     {
         let outbound_request_stream = streams.outbound_request_stream.fuse();
@@ -123,8 +137,7 @@ impl MempoolService {
         pin_mut!(inbound_request_stream);
         let inbound_response_stream = streams.inbound_response_stream.fuse();
         pin_mut!(inbound_response_stream);
-        let inbound_transaction_stream = streams.inbound_transaction_stream.fuse();
-        pin_mut!(inbound_transaction_stream);
+        self.spawn_transaction_admission(streams.inbound_transaction_stream, streams.num_shed_transactions);
         let local_request_stream = streams.local_request_stream.fuse();
         pin_mut!(local_request_stream);
         let mut block_event_stream = streams.block_event_stream.fuse();
@@ -163,11 +176,6 @@ impl MempoolService {
                     self.spawn_handle_incoming_response(domain_msg);
                 },
 
-                // Incoming transaction messages from the Comms layer
-                transaction_msg = inbound_transaction_stream.select_next_some() => {
-                    self.spawn_handle_incoming_tx(transaction_msg).await;
-                }
-
                 // Incoming local request messages from the LocalMempoolServiceInterface and other local services
                 local_request_context = local_request_stream.select_next_some() => {
                     self.spawn_handle_local_request(local_request_context);
@@ -261,29 +269,27 @@ impl MempoolService {
         });
     }
 
-    async fn spawn_handle_incoming_tx(&self, tx_msg: DomainMessage<Transaction>) {
-        // Determine if we are bootstrapped
-        let status_watch = self.state_machine.get_status_info_watch();
-
-        if !(*status_watch.borrow()).bootstrapped {
-            debug!(
-                target: LOG_TARGET,
-                "Transaction with Message {} from peer `{}` not processed while busy with initial sync.",
-                tx_msg.dht_header.message_tag,
-                tx_msg.source_peer.node_id.short_str(),
-            );
-            return;
-        }
-        let inbound_handlers = self.inbound_handlers.clone();
-        task::spawn(async move {
-            let result = handle_incoming_tx(inbound_handlers, tx_msg).await;
-            if let Err(e) = result {
-                error!(
-                    target: LOG_TARGET,
-                    "Failed to handle incoming transaction message: {:?}", e
-                );
-            }
-        });
+    /// Incoming transaction messages from the Comms layer are queued in a bounded admission queue and validated in
+    /// batches by a separate task, so that a flood of transactions does not hold up the other mempool requests.
+    /// Transactions that arrive while the queue is full are shed and counted as rejected.
+    fn spawn_transaction_admission<STxIn>(&self, inbound_transaction_stream: STxIn, num_shed: Arc<AtomicUsize>)
+    where STxIn: Stream<Item = DomainMessage<Transaction>> + Send + 'static {
+        let (queue_sender, queue_receiver) = mpsc::channel(self.config.admission_queue_size);
+        let queue_depth = Arc::new(AtomicUsize::new(0));
+        task::spawn(queue_incoming_txs(
+            inbound_transaction_stream,
+            self.state_machine.clone(),
+            queue_sender,
+            queue_depth.clone(),
+            num_shed.clone(),
+        ));
+        task::spawn(admit_incoming_txs(
+            self.inbound_handlers.clone(),
+            queue_receiver,
+            self.config.admission_batch_size,
+            queue_depth,
+            num_shed,
+        ));
     }
 
     fn spawn_handle_local_request(
@@ -435,28 +441,156 @@ async fn handle_outbound_request(
     }
 }
 
-async fn handle_incoming_tx(
+/// Move the transactions received from peers into the admission queue. The inbound transaction stream is a broadcast
+/// subscription that drops messages when it is not read, so rather than waiting for space this sheds the
+/// transactions that arrive while the queue is full and adds them to `num_shed`.
+async fn queue_incoming_txs<STxIn>(
+    inbound_transaction_stream: STxIn,
+    state_machine: StateMachineHandle,
+    mut queue: mpsc::Sender<DomainMessage<Transaction>>,
+    queue_depth: Arc<AtomicUsize>,
+    num_shed: Arc<AtomicUsize>,
+) where
+    STxIn: Stream<Item = DomainMessage<Transaction>>,
+{
+    pin_mut!(inbound_transaction_stream);
+    // Determine if we are bootstrapped
+    let status_watch = state_machine.get_status_info_watch();
+    while let Some(tx_msg) = inbound_transaction_stream.next().await {
+        if !(*status_watch.borrow()).bootstrapped {
+            debug!(
+                target: LOG_TARGET,
+                "Transaction with Message {} from peer `{}` not processed while busy with initial sync.",
+                tx_msg.dht_header.message_tag,
+                tx_msg.source_peer.node_id.short_str(),
+            );
+            continue;
+        }
+        match queue.try_send(tx_msg) {
+            Ok(_) => {
+                queue_depth.fetch_add(1, Ordering::Relaxed);
+            },
+            Err(err) if err.is_full() => {
+                let tx_msg = err.into_inner();
+                debug!(
+                    target: LOG_TARGET,
+                    "Admission queue full. Transaction with Message {} from peer `{}` dropped.",
+                    tx_msg.dht_header.message_tag,
+                    tx_msg.source_peer.node_id.short_str(),
+                );
+                num_shed.fetch_add(1, Ordering::Relaxed);
+            },
+            Err(_) => break,
+        }
+    }
+}
+
+/// Validate and insert the queued transactions in batches of up to `batch_size`.
+async fn admit_incoming_txs(
     mut inbound_handlers: MempoolInboundHandlers,
-    domain_transaction_msg: DomainMessage<Transaction>,
-) -> Result<(), MempoolServiceError> {
-    let DomainMessage::<_> { source_peer, inner, .. } = domain_transaction_msg;
-
-    debug!(
-        "New transaction received: {}, from: {}",
-        inner.body.kernels()[0].excess_sig.get_signature().to_hex(),
-        source_peer.public_key,
-    );
-    trace!(
-        target: LOG_TARGET,
-        "New transaction: {}, from: {}",
-        inner,
-        source_peer.public_key
-    );
-    inbound_handlers
-        .handle_transaction(inner, Some(source_peer.node_id))
-        .await?;
+    queue: mpsc::Receiver<DomainMessage<Transaction>>,
+    batch_size: usize,
+    queue_depth: Arc<AtomicUsize>,
+    num_shed: Arc<AtomicUsize>,
+) {
+    let mut batches = queue.ready_chunks(cmp::max(batch_size, 1));
+    let mut stats = AdmissionStats::default();
+    let mut last_report = Instant::now();
+    while let Some(batch) = batches.next().await {
+        queue_depth.fetch_sub(batch.len(), Ordering::Relaxed);
+        let txs = batch
+            .into_iter()
+            .map(|domain_transaction_msg| {
+                let DomainMessage::<_> { source_peer, inner, .. } = domain_transaction_msg;
+                debug!(
+                    "New transaction received: {}, from: {}",
+                    inner.body.kernels()[0].excess_sig.get_signature().to_hex(),
+                    source_peer.public_key,
+                );
+                trace!(
+                    target: LOG_TARGET,
+                    "New transaction: {}, from: {}",
+                    inner,
+                    source_peer.public_key
+                );
+                (inner, source_peer.node_id.clone())
+            })
+            .collect::<Vec<_>>();
+
+        let num_txs = txs.len();
+        match inbound_handlers.handle_transactions(txs).await {
+            Ok((num_duplicates, responses)) => stats.record(num_duplicates, &responses),
+            Err(e) => {
+                error!(
+                    target: LOG_TARGET,
+                    "Failed to handle incoming transaction messages: {:?}", e
+                );
+                stats.record_failed(num_txs);
+            },
+        }
 
-    Ok(())
+        if last_report.elapsed() >= ADMISSION_REPORT_INTERVAL {
+            stats.record_shed(num_shed.swap(0, Ordering::Relaxed));
+            info!(
+                target: LOG_TARGET,
+                "Transaction admission in the last {:.0?}: {} received, {} admitted, {} duplicate(s), {} rejected \
+                 ({:.1}%, {} shed under load). {} transaction(s) queued.",
+                last_report.elapsed(),
+                stats.received,
+                stats.admitted,
+                stats.duplicates,
+                stats.rejected,
+                stats.rejection_rate(),
+                stats.shed,
+                queue_depth.load(Ordering::Relaxed),
+            );
+            stats = AdmissionStats::default();
+            last_report = Instant::now();
+        }
+    }
+}
+
+/// What happened to the transactions received from peers since the last admission report
+#[derive(Debug, Default)]
+struct AdmissionStats {
+    received: usize,
+    admitted: usize,
+    duplicates: usize,
+    rejected: usize,
+    shed: usize,
+}
+
+impl AdmissionStats {
+    fn record(&mut self, num_duplicates: usize, responses: &[TxStorageResponse]) {
+        let num_admitted = responses
+            .iter()
+            .filter(|tx_storage| matches!(tx_storage, TxStorageResponse::UnconfirmedPool))
+            .count();
+        self.received += num_duplicates + responses.len();
+        self.duplicates += num_duplicates;
+        self.admitted += num_admitted;
+        self.rejected += responses.len() - num_admitted;
+    }
+
+    fn record_failed(&mut self, num_txs: usize) {
+        self.received += num_txs;
+        self.rejected += num_txs;
+    }
+
+    /// Transactions dropped without being validated, either because the admission queue was full or because the
+    /// inbound subscription lagged, are counted as rejected
+    fn record_shed(&mut self, num_txs: usize) {
+        self.record_failed(num_txs);
+        self.shed += num_txs;
+    }
+
+    /// The percentage of received transactions that were rejected
+    fn rejection_rate(&self) -> f64 {
+        if self.received == 0 {
+            return 0.0;
+        }
+        self.rejected as f64 * 100.0 / self.received as f64
+    }
 }
 
 async fn handle_request_timeout(
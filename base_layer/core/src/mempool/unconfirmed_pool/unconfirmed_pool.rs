@@ -35,7 +35,7 @@ use crate::{
 use log::*;
 use serde::{Deserialize, Serialize};
 use std::{
-    collections::{BTreeMap, HashMap},
+    collections::{BTreeMap, HashMap, HashSet},
     sync::Arc,
 };
 use tari_crypto::tari_utilities::{hex::Hex, Hashable};
@@ -67,13 +67,16 @@ impl Default for UnconfirmedPoolConfig {
 /// transactions included in blocks with transactions stored in the pool. The txs_by_priority BTreeMap prioritise the
 /// transactions in the pool according to TXPriority, it allows transactions to be inserted in sorted order by their
 /// priority. The txs_by_priority BTreeMap makes it easier to select the set of highest priority transactions that can
-/// be included in a block. The excess_sig of a transaction is used a key to uniquely identify a specific transaction in
-/// these containers.
+/// be included in a block. The txs_by_output and txs_by_input HashMaps index the transactions by the hashes of the
+/// outputs they create and spend, so that dependent and double spending transactions, and the transactions made
+/// invalid by a block, can be found without scanning the pool. The excess_sig of a transaction is used a key to
+/// uniquely identify a specific transaction in these containers.
 pub struct UnconfirmedPool {
     config: UnconfirmedPoolConfig,
     txs_by_signature: HashMap<Signature, PrioritizedTransaction>,
     txs_by_priority: BTreeMap<FeePriority, Signature>,
     txs_by_output: HashMap<HashOutput, Vec<Signature>>,
+    txs_by_input: HashMap<HashOutput, Vec<Signature>>,
 }
 
 // helper class to reduce type complexity
@@ -90,6 +93,7 @@ impl UnconfirmedPool {
             txs_by_signature: HashMap::new(),
             txs_by_priority: BTreeMap::new(),
             txs_by_output: HashMap::new(),
+            txs_by_input: HashMap::new(),
         }
     }
 
@@ -98,9 +102,8 @@ impl UnconfirmedPool {
     }
 
     fn remove_lowest_priority_tx(&mut self) {
-        if let Some((priority, sig)) = self.txs_by_priority.iter().next().map(|(p, s)| (p.clone(), s.clone())) {
-            self.txs_by_signature.remove(&sig);
-            self.txs_by_priority.remove(&priority);
+        if let Some(sig) = self.txs_by_priority.values().next().cloned() {
+            self.delete_transaction(&sig);
         }
     }
 
@@ -127,12 +130,18 @@ impl UnconfirmedPool {
             self.txs_by_priority
                 .insert(prioritized_tx.priority.clone(), tx_key.clone());
             self.txs_by_signature.insert(tx_key.clone(), prioritized_tx);
-            for output in tx.body.outputs().clone() {
+            for output in tx.body.outputs() {
                 self.txs_by_output
                     .entry(output.hash())
                     .or_default()
                     .push(tx_key.clone());
             }
+            for input in tx.body.inputs() {
+                self.txs_by_input
+                    .entry(input.output_hash())
+                    .or_default()
+                    .push(tx_key.clone());
+            }
             debug!(
                 target: LOG_TARGET,
                 "Inserted transaction with signature {} into unconfirmed pool:",
@@ -171,6 +180,7 @@ impl UnconfirmedPool {
     /// Returns a set of the highest priority unconfirmed transactions, that can be included in a block
     pub fn highest_priority_txs(&mut self, total_weight: u64) -> Result<RetrieveResults, UnconfirmedPoolError> {
         let mut selected_txs = HashMap::new();
+        let mut selected_inputs = HashSet::new();
         let mut curr_weight: u64 = 0;
         let mut curr_skip_count: usize = 0;
         let mut transactions_to_remove_and_recheck = Vec::new();
@@ -196,9 +206,10 @@ impl UnconfirmedPool {
             if curr_weight + total_transaction_weight <= total_weight &&
                 potential_transactions_to_remove_and_recheck.is_empty()
             {
-                if !UnconfirmedPool::find_duplicate_input(&selected_txs, &potential_transactions_to_insert) {
+                if !UnconfirmedPool::find_duplicate_input(&selected_inputs, &potential_transactions_to_insert) {
                     curr_weight += total_transaction_weight;
                     for (key, transaction) in potential_transactions_to_insert {
+                        selected_inputs.extend(transaction.transaction.body.inputs().iter().map(|i| i.output_hash()));
                         selected_txs.insert((key).clone(), transaction.transaction.clone());
                     }
                 }
@@ -300,23 +311,20 @@ impl UnconfirmedPool {
         Ok(highest_signature)
     }
 
-    // This will search a Vec<Arc<Transaction>> for duplicate inputs of a tx
+    // This will check if any of the transactions to insert spend one of the inputs already spent by the selected
+    // transactions
     fn find_duplicate_input(
-        current_transactions: &HashMap<Signature, Arc<Transaction>>,
+        selected_inputs: &HashSet<HashOutput>,
         transactions_to_insert: &HashMap<Signature, PrioritizedTransaction>,
     ) -> bool {
-        for (_, transaction_to_insert) in transactions_to_insert.iter() {
-            for (_, transaction) in current_transactions.iter() {
-                for input in transaction.body.inputs() {
-                    for tx_input in transaction_to_insert.transaction.body.inputs() {
-                        if tx_input.output_hash() == input.output_hash() {
-                            return true;
-                        }
-                    }
-                }
-            }
-        }
-        false
+        transactions_to_insert.values().any(|transaction_to_insert| {
+            transaction_to_insert
+                .transaction
+                .body
+                .inputs()
+                .iter()
+                .any(|input| selected_inputs.contains(&input.output_hash()))
+        })
     }
 
     /// Remove all current mempool transactions from the UnconfirmedPoolStorage, returning that which have been removed
@@ -328,6 +336,7 @@ impl UnconfirmedPool {
             .collect();
         self.txs_by_priority.clear();
         self.txs_by_output.clear();
+        self.txs_by_input.clear();
 
         mempool_txs
     }
@@ -355,14 +364,16 @@ impl UnconfirmedPool {
         removed_transactions
     }
 
-    // Remove all deprecated transactions from the UnconfirmedPool by scanning inputs and outputs.
+    // Remove all deprecated transactions from the UnconfirmedPool by looking up the inputs and outputs of the block.
     fn remove_deprecated_transactions(&mut self, published_block: &Block) -> Vec<Arc<Transaction>> {
         let mut transaction_keys_to_remove = Vec::new();
-        for (tx_key, ptx) in self.txs_by_signature.iter() {
-            if UnconfirmedPool::find_matching_block_input(ptx, published_block) {
-                transaction_keys_to_remove.push(tx_key.clone())
+        published_block.body.inputs().iter().for_each(|input| {
+            if let Some(signatures) = self.txs_by_input.get(&input.output_hash()) {
+                for signature in signatures {
+                    transaction_keys_to_remove.push(signature.clone())
+                }
             }
-        }
+        });
         published_block.body.outputs().iter().for_each(|output| {
             if let Some(signatures) = self.txs_by_output.get(&output.hash()) {
                 for signature in signatures {
@@ -377,18 +388,6 @@ impl UnconfirmedPool {
         self.delete_transactions(&transaction_keys_to_remove)
     }
 
-    // This is a helper function that searches a block and transaction for matching inputs
-    fn find_matching_block_input(transaction: &PrioritizedTransaction, published_block: &Block) -> bool {
-        for input in transaction.transaction.body.inputs() {
-            for published_input in published_block.body.inputs() {
-                if published_input.output_hash() == input.output_hash() {
-                    return true;
-                }
-            }
-        }
-        false
-    }
-
     fn delete_transactions(&mut self, signature: &[Signature]) -> Vec<Arc<Transaction>> {
         let mut removed_txs: Vec<Arc<Transaction>> = Vec::new();
         for tx_key in signature {
@@ -417,6 +416,15 @@ impl UnconfirmedPool {
                     }
                 }
             }
+            for input in prioritized_transaction.transaction.as_ref().body.inputs() {
+                let key = input.output_hash();
+                if let Some(signatures) = self.txs_by_input.get_mut(&key) {
+                    signatures.retain(|x| x != signature);
+                    if signatures.is_empty() {
+                        self.txs_by_input.remove(&key);
+                    }
+                }
+            }
             trace!(
                 target: LOG_TARGET,
                 "Deleted transaction: {}",
@@ -466,9 +474,17 @@ impl UnconfirmedPool {
         if self.txs_by_priority.len() != self.txs_by_signature.len() {
             return false;
         }
+        let is_indexed = |index: &HashMap<HashOutput, Vec<Signature>>| {
+            index
+                .values()
+                .flatten()
+                .all(|tx_key| self.txs_by_signature.contains_key(tx_key))
+        };
         self.txs_by_priority
             .iter()
-            .all(|(_, tx_key)| self.txs_by_signature.contains_key(tx_key))
+            .all(|(_, tx_key)| self.txs_by_signature.contains_key(tx_key)) &&
+            is_indexed(&self.txs_by_output) &&
+            is_indexed(&self.txs_by_input)
     }
 }
 
@@ -494,10 +510,9 @@ mod test {
     fn test_find_duplicate_input() {
         let tx1 = Arc::new(tx!(MicroTari(5000), fee: MicroTari(50), inputs: 2, outputs: 1).0);
         let tx2 = Arc::new(tx!(MicroTari(5000), fee: MicroTari(50), inputs: 2, outputs: 1).0);
-        let mut tx_pool = HashMap::new();
+        let tx_pool = tx1.body.inputs().iter().map(|i| i.output_hash()).collect();
         let mut tx1_pool = HashMap::new();
         let mut tx2_pool = HashMap::new();
-        tx_pool.insert(tx1.first_kernel_excess_sig().unwrap().clone(), tx1.clone());
         tx1_pool.insert(
             tx1.first_kernel_excess_sig().unwrap().clone(),
             PrioritizedTransaction::convert_from_transaction((*tx1).clone(), None).unwrap(),
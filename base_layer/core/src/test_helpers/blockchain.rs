@@ -21,7 +21,7 @@
 //  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
-    blocks::{genesis_block::get_weatherwax_genesis_block, Block, BlockHeader},
+    blocks::{genesis_block::get_weatherwax_genesis_block, Block, BlockFilter, BlockHeader},
     chain_storage::{
         create_lmdb_database,
         BlockAccumulatedData,
@@ -35,6 +35,7 @@ use crate::{
         DbKey,
         DbTransaction,
         DbValue,
+        EncodedSyncUtxo,
         HorizonData,
         LMDBDatabase,
         MmrTree,
@@ -212,6 +213,10 @@ impl BlockchainBackend for TempDatabase {
         self.db.fetch_block_accumulated_data_by_height(height)
     }
 
+    fn fetch_block_filter(&self, height: u64) -> Result<Option<BlockFilter>, ChainStorageError> {
+        self.db.fetch_block_filter(height)
+    }
+
     fn fetch_kernels_in_block(&self, header_hash: &HashOutput) -> Result<Vec<TransactionKernel>, ChainStorageError> {
         self.db.fetch_kernels_in_block(header_hash)
     }
@@ -243,6 +248,15 @@ impl BlockchainBackend for TempDatabase {
         self.db.fetch_utxos_by_mmr_position(start, end, deleted)
     }
 
+    fn fetch_encoded_utxos_by_mmr_position(
+        &self,
+        start: u64,
+        end: u64,
+        deleted: &Bitmap,
+    ) -> Result<Option<(Vec<EncodedSyncUtxo>, Bitmap)>, ChainStorageError> {
+        self.db.fetch_encoded_utxos_by_mmr_position(start, end, deleted)
+    }
+
     fn fetch_output(
         &self,
         output_hash: &HashOutput,
@@ -26,6 +26,7 @@ use crate::transactions::{
     types::{BlindingFactor, Commitment, CommitmentFactory, CryptoFactories, PrivateKey, PublicKey, RangeProofService},
 };
 use log::*;
+use rayon::prelude::*;
 use serde::{Deserialize, Serialize};
 use std::fmt::{Display, Error, Formatter};
 use tari_crypto::{
@@ -37,6 +38,10 @@ use tari_crypto::{
 
 pub const LOG_TARGET: &str = "c::tx::aggregated_body";
 
+/// The number of range proofs or signatures verified together on one worker thread. Bodies with no more than this
+/// many items are verified on the calling thread.
+const VERIFICATION_BATCH_SIZE: usize = 16;
+
 /// The components of the block or transaction. The same struct can be used for either, since in Mimblewimble,
 /// cut-through means that blocks and transactions have the same structure.
 #[derive(Clone, Debug, Serialize, Deserialize, PartialEq, Eq)]
@@ -195,13 +200,12 @@ impl AggregateBody {
     /// will be added to the public key used in the signature verification.
     pub fn verify_kernel_signatures(&self) -> Result<(), TransactionError> {
         trace!(target: LOG_TARGET, "Checking kernel signatures",);
-        for kernel in self.kernels.iter() {
+        verify_in_batches(&self.kernels, |kernel| {
             kernel.verify_signature().map_err(|e| {
                 warn!(target: LOG_TARGET, "Kernel ({}) signature failed {:?}.", kernel, e);
                 e
-            })?;
-        }
-        Ok(())
+            })
+        })
     }
 
     pub fn get_total_fee(&self) -> MicroTari {
@@ -407,22 +411,19 @@ impl AggregateBody {
 
     fn validate_range_proofs(&self, range_proof_service: &RangeProofService) -> Result<(), TransactionError> {
         trace!(target: LOG_TARGET, "Checking range proofs");
-        for o in &self.outputs {
+        verify_in_batches(&self.outputs, |o| {
             if !o.verify_range_proof(&range_proof_service)? {
                 return Err(TransactionError::ValidationError(
                     "Range proof could not be verified".into(),
                 ));
             }
-        }
-        Ok(())
+            Ok(())
+        })
     }
 
     fn verify_metadata_signatures(&self) -> Result<(), TransactionError> {
         trace!(target: LOG_TARGET, "Checking sender signatures");
-        for o in &self.outputs {
-            o.verify_metadata_signature()?;
-        }
-        Ok(())
+        verify_in_batches(&self.outputs, TransactionOutput::verify_metadata_signature)
     }
 
     /// Returns the byte size or weight of a body
@@ -451,6 +452,26 @@ impl From<Transaction> for AggregateBody {
     }
 }
 
+/// Verify every item with `verify`, splitting the items into batches that are spread over the rayon thread pool.
+/// The error returned is always that of the first failing item in order, the same as checking the items one by one.
+fn verify_in_batches<T, F>(items: &[T], verify: F) -> Result<(), TransactionError>
+where
+    T: Sync,
+    F: Fn(&T) -> Result<(), TransactionError> + Sync,
+{
+    if items.len() <= VERIFICATION_BATCH_SIZE {
+        return items.iter().try_for_each(verify);
+    }
+    match items
+        .par_chunks(VERIFICATION_BATCH_SIZE)
+        .filter_map(|batch| batch.iter().try_for_each(&verify).err())
+        .find_first(|_| true)
+    {
+        Some(err) => Err(err),
+        None => Ok(()),
+    }
+}
+
 impl Display for AggregateBody {
     fn fmt(&self, fmt: &mut Formatter<'_>) -> Result<(), Error> {
         if !self.is_sorted() {
@@ -472,3 +493,30 @@ impl Display for AggregateBody {
         Ok(())
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn fail_on(failing: &[usize]) -> impl Fn(&usize) -> Result<(), TransactionError> + Sync + '_ {
+        move |i| {
+            if failing.contains(i) {
+                Err(TransactionError::ValidationError(i.to_string()))
+            } else {
+                Ok(())
+            }
+        }
+    }
+
+    #[test]
+    fn it_returns_the_first_failing_item_of_all_batches() {
+        let items = (0..100usize).collect::<Vec<_>>();
+        assert!(verify_in_batches(&items, fail_on(&[])).is_ok());
+        let err = verify_in_batches(&items, fail_on(&[99, 57, 40])).unwrap_err();
+        assert!(matches!(err, TransactionError::ValidationError(i) if i == "40"));
+
+        // Fewer items than a batch are verified on the calling thread
+        let err = verify_in_batches(&items[..3], fail_on(&[2, 1])).unwrap_err();
+        assert!(matches!(err, TransactionError::ValidationError(i) if i == "1"));
+    }
+}
@@ -389,6 +389,11 @@ impl<B: BlockchainBackend> CandidateBlockBodyValidation<B> for BlockValidator<B>
     /// 1. Does the block satisfy the stateless checks?
     /// 1. Are the block header MMR roots valid?
     fn validate_body(&self, block: &Block, backend: &B) -> Result<(), ValidationError> {
+        self.validate_body_stateless(block)?;
+        self.validate_body_against_chain(block, backend)
+    }
+
+    fn validate_body_stateless(&self, block: &Block) -> Result<(), ValidationError> {
         let block_id = format!("block #{}", block.header.height);
         trace!(target: LOG_TARGET, "Validating {}", block_id);
 
@@ -405,7 +410,11 @@ impl<B: BlockchainBackend> CandidateBlockBodyValidation<B> for BlockValidator<B>
             target: LOG_TARGET,
             "{} has PASSED stateless VALIDATION check.", &block_id
         );
+        Ok(())
+    }
 
+    fn validate_body_against_chain(&self, block: &Block, backend: &B) -> Result<(), ValidationError> {
+        let block_id = format!("block #{}", block.header.height);
         check_mmr_roots(&block, backend)?;
         trace!(
             target: LOG_TARGET,
@@ -32,6 +32,18 @@ use crate::{
 /// validated
 pub trait CandidateBlockBodyValidation<B: BlockchainBackend>: Send + Sync {
     fn validate_body(&self, block: &Block, backend: &B) -> Result<(), ValidationError>;
+
+    /// The checks of `validate_body` that only depend on the block itself. These can be run for many blocks at once
+    /// ahead of `validate_body_against_chain`. By default every check is left to `validate_body_against_chain`.
+    fn validate_body_stateless(&self, _block: &Block) -> Result<(), ValidationError> {
+        Ok(())
+    }
+
+    /// The checks of `validate_body` that are not done by `validate_body_stateless`. These depend on the chain state,
+    /// so the previous block must have been added.
+    fn validate_body_against_chain(&self, block: &Block, backend: &B) -> Result<(), ValidationError> {
+        self.validate_body(block, backend)
+    }
 }
 
 /// A validator that validates a body after it has been determined to be a valid orphan
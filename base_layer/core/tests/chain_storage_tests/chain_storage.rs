@@ -37,6 +37,7 @@ use crate::helpers::{
     sample_blockchains::{create_new_blockchain, create_new_blockchain_lmdb},
     test_blockchain::TestBlockchain,
 };
+use prost::Message;
 use rand::{rngs::OsRng, RngCore};
 use tari_common::configuration::Network;
 use tari_common_types::types::BlockHash;
@@ -54,6 +55,7 @@ use tari_core::{
     },
     consensus::{emission::Emission, ConsensusConstantsBuilder, ConsensusManagerBuilder},
     proof_of_work::Difficulty,
+    proto::base_node::SyncUtxo,
     test_helpers::blockchain::{
         create_store_with_consensus,
         create_store_with_consensus_and_validators,
@@ -176,6 +178,82 @@ fn add_multiple_blocks() {
     assert_eq!(metadata.best_block(), hash);
 }
 
+#[test]
+fn store_and_remove_block_filters() {
+    let network = Network::LocalNet;
+    let consensus_manager = ConsensusManagerBuilder::new(network).build();
+    let store = create_store_with_consensus(consensus_manager.clone());
+    let block0 = store.fetch_block(0).unwrap();
+    let block1 = append_block(
+        &store,
+        &block0.try_into_chain_block().unwrap(),
+        vec![],
+        &consensus_manager,
+        1.into(),
+    )
+    .unwrap();
+
+    let filter = store.fetch_block_filter(1).unwrap().unwrap();
+    let scripts = block1
+        .block()
+        .body
+        .outputs()
+        .iter()
+        .map(|o| o.script.as_bytes())
+        .collect::<Vec<_>>();
+    assert!(!scripts.is_empty());
+    for script in scripts.iter() {
+        assert!(filter.matches_any(block1.hash(), vec![script.as_slice()]));
+    }
+    assert!(!filter.matches_any(block1.hash(), vec![b"not an output script".as_ref()]));
+
+    store.rewind_to_height(0).unwrap();
+    assert_eq!(store.fetch_block_filter(1).unwrap(), None);
+}
+
+#[test]
+fn fetch_encoded_utxos_from_the_sync_index() {
+    let network = Network::LocalNet;
+    let consensus_manager = ConsensusManagerBuilder::new(network).build();
+    let store = create_store_with_consensus(consensus_manager.clone());
+    let block0 = store.fetch_block(0).unwrap();
+    let block1 = append_block(
+        &store,
+        &block0.try_into_chain_block().unwrap(),
+        vec![],
+        &consensus_manager,
+        1.into(),
+    )
+    .unwrap();
+
+    let end = block1.header().output_mmr_size - 1;
+    let (outputs, deleted_diff) = store
+        .fetch_utxos_by_mmr_position(0, end, block1.hash().clone())
+        .unwrap();
+    let deleted = store
+        .fetch_block_accumulated_data(block1.hash().clone())
+        .unwrap()
+        .deleted()
+        .clone();
+    let (encoded, encoded_deleted_diff) = store
+        .fetch_encoded_utxos_by_mmr_position(0, end, deleted.clone())
+        .unwrap()
+        .unwrap();
+    assert_eq!(encoded.len(), outputs.len());
+    assert_eq!(encoded_deleted_diff, deleted_diff);
+    for (output, encoded) in outputs.into_iter().zip(encoded) {
+        assert_eq!(encoded.is_pruned(), output.is_pruned());
+        assert_eq!(SyncUtxo::decode(encoded.as_bytes()).unwrap(), SyncUtxo::from(output));
+    }
+
+    store.rewind_to_height(0).unwrap();
+    let end = block0.header().output_mmr_size;
+    assert!(store
+        .fetch_encoded_utxos_by_mmr_position(0, end, deleted)
+        .unwrap()
+        .is_none());
+}
+
 #[test]
 fn test_checkpoints() {
     let network = Network::LocalNet;
@@ -37,7 +37,11 @@ use helpers::{
 };
 use tari_crypto::keys::PublicKey as PublicKeyTrait;
 // use crate::helpers::database::create_store;
-use std::{ops::Deref, sync::Arc, time::Duration};
+use std::{
+    ops::Deref,
+    sync::{Arc, Mutex},
+    time::Duration,
+};
 use tari_common::configuration::Network;
 use tari_comms_dht::domain_message::OutboundDomainMessage;
 use tari_core::{
@@ -60,7 +64,11 @@ use tari_core::{
     },
     tx,
     txn_schema,
-    validation::transaction_validators::{TxConsensusValidator, TxInputAndMaturityValidator},
+    validation::{
+        transaction_validators::{TxConsensusValidator, TxInputAndMaturityValidator},
+        MempoolTransactionValidation,
+        ValidationError,
+    },
 };
 use tari_crypto::script;
 use tari_p2p::{services::liveness::LivenessConfig, tari_message::TariMessageType};
@@ -201,6 +209,103 @@ fn test_insert_and_process_published_block() {
     assert_eq!(stats.total_weight, 30);
 }
 
+#[test]
+#[allow(clippy::identity_op)]
+fn test_insert_all() {
+    let network = Network::LocalNet;
+    let (mut store, mut blocks, mut outputs, consensus_manager) = create_new_blockchain(network);
+    let mempool_validator = TxInputAndMaturityValidator::new(store.clone());
+    let mempool = Mempool::new(MempoolConfig::default(), Arc::new(mempool_validator));
+    let txs = vec![txn_schema!(
+        from: vec![outputs[0][0].clone()],
+        to: vec![2 * T, 2 * T], fee: 25.into(), lock: 0, features: OutputFeatures::default()
+    )];
+    generate_new_block(&mut store, &mut blocks, &mut outputs, txs, &consensus_manager).unwrap();
+
+    let (orphan, _, _) = tx!(1*T, fee: 100*uT);
+    let tx1 = txn_schema!(from: vec![outputs[1][0].clone()], to: vec![1*T], fee: 20*uT, lock: 0, features: OutputFeatures::default());
+    let tx2 = txn_schema!(from: vec![outputs[1][1].clone()], to: vec![1*T], fee: 20*uT, lock: 0, features: OutputFeatures::default());
+    let txs = vec![
+        Arc::new(spend_utxos(tx1).0),
+        Arc::new(orphan),
+        Arc::new(spend_utxos(tx2).0),
+    ];
+
+    let responses = mempool.insert_all(txs.clone()).unwrap();
+    assert_eq!(responses, vec![
+        TxStorageResponse::UnconfirmedPool,
+        TxStorageResponse::NotStoredOrphan,
+        TxStorageResponse::UnconfirmedPool
+    ]);
+    let excess_sigs = txs.iter().map(|tx| tx.body.kernels()[0].excess_sig.clone()).collect();
+    assert_eq!(mempool.has_txs_with_excess_sigs(excess_sigs).unwrap(), vec![
+        TxStorageResponse::UnconfirmedPool,
+        TxStorageResponse::NotStored,
+        TxStorageResponse::UnconfirmedPool
+    ]);
+}
+
+/// Runs `on_validate` once, after the first transaction it validates has been checked by the inner validator
+struct InterleavedValidator<V> {
+    inner: V,
+    on_validate: Mutex<Option<Box<dyn FnOnce() + Send>>>,
+}
+
+impl<V: MempoolTransactionValidation> MempoolTransactionValidation for InterleavedValidator<V> {
+    fn validate(&self, tx: &Transaction) -> Result<(), ValidationError> {
+        let result = self.inner.validate(tx);
+        if let Some(on_validate) = self.on_validate.lock().unwrap().take() {
+            on_validate();
+        }
+        result
+    }
+}
+
+#[test]
+#[allow(clippy::identity_op)]
+fn test_insert_with_block_published_during_validation() {
+    let network = Network::LocalNet;
+    let (mut store, mut blocks, mut outputs, consensus_manager) = create_new_blockchain(network);
+    let txs = vec![txn_schema!(
+        from: vec![outputs[0][0].clone()],
+        to: vec![2 * T], fee: 25.into(), lock: 0, features: OutputFeatures::default()
+    )];
+    generate_new_block(&mut store, &mut blocks, &mut outputs, txs, &consensus_manager).unwrap();
+
+    // Both transactions spend the same output. A block that includes tx2 is published after tx1 has passed validation
+    // but before it is stored.
+    let tx1 = txn_schema!(from: vec![outputs[1][0].clone()], to: vec![1*T], fee: 20*uT, lock: 0, features: OutputFeatures::default());
+    let tx1 = Arc::new(spend_utxos(tx1).0);
+    let tx2 = txn_schema!(from: vec![outputs[1][0].clone()], to: vec![1*T], fee: 25*uT, lock: 0, features: OutputFeatures::default());
+    let tx2 = spend_utxos(tx2).0;
+
+    let mempool_slot = Arc::new(Mutex::new(None::<Mempool>));
+    let block_mempool = mempool_slot.clone();
+    let block_store = store.clone();
+    let validator = InterleavedValidator {
+        inner: TxInputAndMaturityValidator::new(store),
+        on_validate: Mutex::new(Some(Box::new(move || {
+            generate_block(&block_store, &mut blocks, vec![tx2], &consensus_manager).unwrap();
+            let mempool = block_mempool.lock().unwrap().take().unwrap();
+            mempool.process_published_block(blocks[2].to_arc_block()).unwrap();
+        }))),
+    };
+    let mempool = Mempool::new(MempoolConfig::default(), Arc::new(validator));
+    *mempool_slot.lock().unwrap() = Some(mempool.clone());
+
+    assert_eq!(
+        mempool.insert(tx1.clone()).unwrap(),
+        TxStorageResponse::NotStoredAlreadySpent
+    );
+    assert_eq!(
+        mempool
+            .has_tx_with_excess_sig(tx1.body.kernels()[0].excess_sig.clone())
+            .unwrap(),
+        TxStorageResponse::NotStored
+    );
+    assert!(mempool.retrieve(100_000).unwrap().is_empty());
+}
+
 #[test]
 #[allow(clippy::identity_op)]
 fn test_time_locked() {
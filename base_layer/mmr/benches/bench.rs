@@ -33,7 +33,7 @@ mod benches {
     use criterion::{criterion_group, BatchSize, Criterion};
     use digest::Digest;
     use std::time::Duration;
-    use tari_mmr::MerkleMountainRange;
+    use tari_mmr::{FlatHashVec, MerkleMountainRange};
 
     fn get_hashes(n: usize) -> Vec<Vec<u8>> {
         (0..n).map(|i| Blake2b::digest(&i.to_le_bytes()).to_vec()).collect()
@@ -55,14 +55,70 @@ mod benches {
         });
     }
 
+    const LARGE_MMR_SIZE: usize = 1 << 20;
+
+    fn push_large_mmr(c: &mut Criterion) {
+        c.bench_function("Push 1M leaves one at a time", move |b| {
+            let hashes = get_hashes(LARGE_MMR_SIZE);
+            b.iter_batched(
+                || (MerkleMountainRange::<Blake2b, _>::new(Vec::default()), hashes.clone()),
+                |(mut mmr, hashes)| {
+                    hashes.into_iter().for_each(|hash| {
+                        mmr.push(hash).unwrap();
+                    });
+                    mmr.get_merkle_root().unwrap()
+                },
+                BatchSize::LargeInput,
+            );
+        });
+    }
+
+    fn push_many_large_mmr(c: &mut Criterion) {
+        c.bench_function("Push 1M leaves as a batch", move |b| {
+            let hashes = get_hashes(LARGE_MMR_SIZE);
+            b.iter_batched(
+                || (MerkleMountainRange::<Blake2b, _>::new(Vec::default()), hashes.clone()),
+                |(mut mmr, hashes)| {
+                    mmr.push_many(hashes).unwrap();
+                    mmr.get_merkle_root().unwrap()
+                },
+                BatchSize::LargeInput,
+            );
+        });
+    }
+
+    fn push_many_large_flat_mmr(c: &mut Criterion) {
+        c.bench_function("Push 1M leaves as a batch into a flat backend", move |b| {
+            let hashes = get_hashes(LARGE_MMR_SIZE);
+            b.iter_batched(
+                || {
+                    let backend = FlatHashVec::with_capacity(Blake2b::output_size(), 2 * LARGE_MMR_SIZE);
+                    (MerkleMountainRange::<Blake2b, _>::new(backend), hashes.clone())
+                },
+                |(mut mmr, hashes)| {
+                    mmr.push_many(hashes).unwrap();
+                    mmr.get_merkle_root().unwrap()
+                },
+                BatchSize::LargeInput,
+            );
+        });
+    }
+
     criterion_group!(
         name = mmr;
         config= Criterion::default().warm_up_time(Duration::from_millis(500)).sample_size(10);
         targets= build_mmr
     );
 
+    criterion_group!(
+        name = large_mmr;
+        config= Criterion::default().warm_up_time(Duration::from_millis(500)).sample_size(10);
+        targets= push_large_mmr, push_many_large_mmr, push_many_large_flat_mmr
+    );
+
     pub fn main() {
         mmr();
+        large_mmr();
         criterion::Criterion::default().configure_from_args().final_summary();
     }
 }
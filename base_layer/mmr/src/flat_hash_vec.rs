@@ -0,0 +1,157 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use crate::{
+    backend::{ArrayLike, ArrayLikeExt},
+    error::MerkleMountainRangeError,
+    Hash,
+    HashSlice,
+};
+use digest::Digest;
+use std::cmp::min;
+
+/// A backend for fixed-size hashes that stores them back to back in one contiguous buffer, rather than as a separate
+/// heap allocation per hash. Appends and lookups touch a single allocation, which keeps large MMRs cache-friendly.
+#[derive(Debug, Clone, PartialEq)]
+pub struct FlatHashVec {
+    hash_size: usize,
+    data: Vec<u8>,
+}
+
+impl FlatHashVec {
+    /// Create an empty backend for hashes of `hash_size` bytes
+    pub fn new(hash_size: usize) -> Self {
+        Self::with_capacity(hash_size, 0)
+    }
+
+    /// Create an empty backend for hashes of `hash_size` bytes with room for `capacity` hashes
+    pub fn with_capacity(hash_size: usize, capacity: usize) -> Self {
+        Self {
+            hash_size,
+            data: Vec::with_capacity(hash_size.saturating_mul(capacity)),
+        }
+    }
+
+    /// Create an empty backend for hashes produced by the digest `D`
+    pub fn for_digest<D: Digest>() -> Self {
+        Self::new(D::output_size())
+    }
+
+    /// The size in bytes of each stored hash
+    pub fn hash_size(&self) -> usize {
+        self.hash_size
+    }
+
+    /// Return a reference to the hash at the given index without copying it
+    pub fn get_slice(&self, index: usize) -> Option<&HashSlice> {
+        if self.hash_size == 0 {
+            return None;
+        }
+        let start = index.checked_mul(self.hash_size)?;
+        self.data.get(start..start.checked_add(self.hash_size)?)
+    }
+
+    fn check_hash_size(&self, hash: &HashSlice) -> Result<(), MerkleMountainRangeError> {
+        if self.hash_size == 0 || hash.len() != self.hash_size {
+            return Err(MerkleMountainRangeError::BackendError(format!(
+                "Expected a hash of {} bytes but got {} bytes",
+                self.hash_size,
+                hash.len()
+            )));
+        }
+        Ok(())
+    }
+}
+
+impl ArrayLike for FlatHashVec {
+    type Error = MerkleMountainRangeError;
+    type Value = Hash;
+
+    fn len(&self) -> Result<usize, Self::Error> {
+        Ok(self.data.len().checked_div(self.hash_size).unwrap_or(0))
+    }
+
+    fn is_empty(&self) -> Result<bool, Self::Error> {
+        Ok(self.data.is_empty())
+    }
+
+    fn push(&mut self, item: Self::Value) -> Result<usize, Self::Error> {
+        self.check_hash_size(&item)?;
+        self.data.extend_from_slice(&item);
+        Ok(self.len()? - 1)
+    }
+
+    fn get(&self, index: usize) -> Result<Option<Self::Value>, Self::Error> {
+        Ok(self.get_slice(index).map(|hash| hash.to_vec()))
+    }
+
+    fn clear(&mut self) -> Result<(), Self::Error> {
+        self.data.clear();
+        Ok(())
+    }
+
+    fn position(&self, item: &Self::Value) -> Result<Option<usize>, Self::Error> {
+        if self.check_hash_size(item).is_err() {
+            return Ok(None);
+        }
+        Ok(self
+            .data
+            .chunks_exact(self.hash_size)
+            .position(|hash| hash == item.as_slice()))
+    }
+}
+
+impl ArrayLikeExt for FlatHashVec {
+    type Value = Hash;
+
+    fn truncate(&mut self, len: usize) -> Result<(), MerkleMountainRangeError> {
+        self.data.truncate(len.saturating_mul(self.hash_size));
+        Ok(())
+    }
+
+    fn shift(&mut self, n: usize) -> Result<(), MerkleMountainRangeError> {
+        let drain_n = min(n, self.len()?);
+        self.data.drain(0..drain_n * self.hash_size);
+        Ok(())
+    }
+
+    fn push_front(&mut self, item: Self::Value) -> Result<(), MerkleMountainRangeError> {
+        self.check_hash_size(&item)?;
+        let mut data = Vec::with_capacity(item.len() + self.data.len());
+        data.extend_from_slice(&item);
+        data.extend_from_slice(&self.data);
+        self.data = data;
+        Ok(())
+    }
+
+    fn for_each<F>(&self, f: F) -> Result<(), MerkleMountainRangeError>
+    where F: FnMut(Result<Self::Value, MerkleMountainRangeError>) {
+        if self.hash_size == 0 {
+            return Ok(());
+        }
+        self.data
+            .chunks_exact(self.hash_size)
+            .map(|hash| Ok(hash.to_vec()))
+            .for_each(f);
+        Ok(())
+    }
+}
@@ -142,6 +142,7 @@ pub type Hash = Vec<u8>;
 pub type HashSlice = [u8];
 
 mod backend;
+mod flat_hash_vec;
 mod mem_backend_vec;
 mod merkle_mountain_range;
 mod merkle_proof;
@@ -156,6 +157,8 @@ pub mod pruned_hashset;
 // Commonly used exports
 /// A vector-based backend for [MerkleMountainRange]
 pub use backend::{ArrayLike, ArrayLikeExt};
+/// A backend that stores fixed-size hashes contiguously in a single buffer.
+pub use flat_hash_vec::FlatHashVec;
 /// MemBackendVec is a shareable, memory only, vector that can be be used with MmrCache to store checkpoints.
 pub use mem_backend_vec::MemBackendVec;
 /// An immutable, append-only Merkle Mountain range (MMR) data structure
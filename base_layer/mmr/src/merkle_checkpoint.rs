@@ -56,9 +56,7 @@ impl MerkleCheckPoint {
         D: Digest,
         B2: ArrayLike<Value = Hash>,
     {
-        for node in &self.nodes_added {
-            mmr.push(node.clone())?;
-        }
+        mmr.push_many(self.nodes_added.iter().cloned())?;
         mmr.deleted.or_inplace(&self.nodes_deleted);
         Ok(())
     }
@@ -37,6 +37,8 @@ use crate::{
     Hash,
 };
 use digest::Digest;
+#[cfg(feature = "parallel")]
+use rayon::prelude::*;
 use std::{
     cmp::{max, min},
     convert::TryInto,
@@ -44,6 +46,11 @@ use std::{
     marker::PhantomData,
 };
 
+/// The number of parent nodes on a single level of a batch append that makes it worthwhile to hash the level in
+/// parallel.
+#[cfg(feature = "parallel")]
+const PARALLEL_HASH_THRESHOLD: usize = 1024;
+
 /// An implementation of a Merkle Mountain Range (MMR). The MMR is append-only and immutable. Only the hashes are
 /// stored in this data structure. The data itself can be stored anywhere as long as you can maintain a 1:1 mapping
 /// of the hash of that data to the leaf nodes in the MMR.
@@ -76,9 +83,7 @@ where
         self.hashes
             .clear()
             .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?;
-        for hash in hash_iter.into_iter() {
-            self.push(hash)?;
-        }
+        self.push_many(hash_iter)?;
         Ok(())
     }
 
@@ -196,6 +201,100 @@ where
         Ok(pos)
     }
 
+    /// Push a batch of new elements into the MMR. The result is identical to calling [push](Self::push) for each hash
+    /// in turn, but the new parent nodes are calculated one level of the tree at a time. Every hash on a level only
+    /// depends on the level below it, so each level is hashed in one pass (in parallel for large batches) and the new
+    /// nodes are then written to the backend in order.
+    /// Returns the new length of the merkle mountain range (the number of all nodes, not just leaf nodes).
+    pub fn push_many<I: IntoIterator<Item = Hash>>(&mut self, hashes: I) -> Result<usize, MerkleMountainRangeError> {
+        let len = self.len()?;
+        // For a valid MMR size, the peak map is the number of leaves
+        let (mut leaf_count, height) = peak_map_height(len);
+        if height != 0 {
+            return Err(MerkleMountainRangeError::CorruptDataStructure);
+        }
+
+        // Lay out the new nodes in the order that `push` would write them. Leaves are known up front, while the
+        // offsets of the parent nodes are collected per level so that they can be filled in below.
+        let mut nodes = Vec::<Option<Hash>>::new();
+        let mut levels = Vec::<Vec<usize>>::new();
+        for hash in hashes {
+            nodes.push(Some(hash));
+            for height in 1..=leaf_count.trailing_ones() as usize {
+                if levels.len() < height {
+                    levels.push(Vec::new());
+                }
+                levels[height - 1].push(nodes.len());
+                nodes.push(None);
+            }
+            leaf_count += 1;
+        }
+
+        for (i, offsets) in levels.iter().enumerate() {
+            let height = i + 1;
+            // Only the first parent on a level can have a left child that is already in the backend: the peak of the
+            // same height that the batch is merged into.
+            let peak_pos = (len + offsets[0]) - (1 << height);
+            let peak = if peak_pos < len {
+                Some(
+                    self.hashes
+                        .get(peak_pos)
+                        .map_err(MerkleMountainRangeError::backend_error)?
+                        .ok_or(MerkleMountainRangeError::HashNotFound(peak_pos))?,
+                )
+            } else {
+                None
+            };
+            let children = offsets
+                .iter()
+                .map(|&offset| {
+                    let left_pos = (len + offset) - (1 << height);
+                    let left = if left_pos < len {
+                        peak.as_ref()
+                    } else {
+                        nodes[left_pos - len].as_ref()
+                    };
+                    let right = nodes[offset - 1].as_ref();
+                    (
+                        left.expect("left child is hashed before its parent"),
+                        right.expect("right child is hashed before its parent"),
+                    )
+                })
+                .collect::<Vec<_>>();
+            let parents = Self::hash_level(&children);
+            for (&offset, hash) in offsets.iter().zip(parents) {
+                nodes[offset] = Some(hash);
+            }
+        }
+
+        for hash in nodes {
+            self.push_hash(hash.expect("every new node has been hashed"))?;
+        }
+        self.len()
+    }
+
+    #[cfg(feature = "parallel")]
+    fn hash_level(children: &[(&Hash, &Hash)]) -> Vec<Hash> {
+        if children.len() < PARALLEL_HASH_THRESHOLD {
+            return children
+                .iter()
+                .map(|(left, right)| hash_together::<D>(left, right))
+                .collect();
+        }
+        children
+            .par_iter()
+            .map(|(left, right)| hash_together::<D>(left, right))
+            .collect()
+    }
+
+    #[cfg(not(feature = "parallel"))]
+    fn hash_level(children: &[(&Hash, &Hash)]) -> Vec<Hash> {
+        children
+            .iter()
+            .map(|(left, right)| hash_together::<D>(left, right))
+            .collect()
+    }
+
     /// Walks the nodes in the MMR and revalidates all parent hashes
     pub fn validate(&self) -> Result<(), MerkleMountainRangeError> {
         // iterate on all parent nodes
@@ -115,15 +115,7 @@ where
     fn create_base_mmr(&mut self) -> Result<(), MerkleMountainRangeError> {
         self.base_mmr.clear()?;
         self.base_cp_index = self.calculate_base_cp_index()?;
-        for cp_index in 0..=self.base_cp_index {
-            if let Some(cp) = self
-                .checkpoints
-                .get(cp_index)
-                .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?
-            {
-                cp.apply(&mut self.base_mmr)?;
-            }
-        }
+        apply_checkpoints(&self.checkpoints, &mut self.base_mmr, 0..=self.base_cp_index)?;
         Ok(())
     }
 
@@ -134,15 +126,11 @@ where
             .len()
             .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?;
         self.curr_mmr = prune_mutable_mmr::<D, _>(&self.base_mmr)?;
-        for cp_index in self.base_cp_index + 1..self.curr_cp_index {
-            if let Some(cp) = self
-                .checkpoints
-                .get(cp_index)
-                .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?
-            {
-                cp.apply(&mut self.curr_mmr)?;
-            }
-        }
+        apply_checkpoints(
+            &self.checkpoints,
+            &mut self.curr_mmr,
+            self.base_cp_index + 1..self.curr_cp_index,
+        )?;
         Ok(())
     }
 
@@ -151,15 +139,11 @@ where
         let prev_cp_index = self.base_cp_index;
         self.base_cp_index = self.calculate_base_cp_index()?;
         if prev_cp_index < self.base_cp_index {
-            for cp_index in prev_cp_index + 1..=self.base_cp_index {
-                if let Some(cp) = self
-                    .checkpoints
-                    .get(cp_index)
-                    .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?
-                {
-                    cp.apply(&mut self.base_mmr)?;
-                }
-            }
+            apply_checkpoints(
+                &self.checkpoints,
+                &mut self.base_mmr,
+                prev_cp_index + 1..=self.base_cp_index,
+            )?;
         } else {
             self.create_base_mmr()?;
         }
@@ -207,12 +191,14 @@ where
     /// Returns the hash of the leaf index provided, as well as its deletion status. The node has been marked for
     /// deletion if the boolean value is true.
     pub fn fetch_mmr_node(&self, leaf_index: u32) -> Result<(Option<Hash>, bool), MerkleMountainRangeError> {
-        let (base_hash, base_deleted) = self.base_mmr.get_leaf_status(leaf_index)?;
-        let (curr_hash, curr_deleted) = self.curr_mmr.get_leaf_status(leaf_index)?;
-        if let Some(base_hash) = base_hash {
-            return Ok((Some(base_hash), base_deleted | curr_deleted));
-        }
-        Ok((curr_hash, base_deleted | curr_deleted))
+        let deleted = self.base_mmr.deleted().contains(leaf_index) | self.curr_mmr.deleted().contains(leaf_index);
+        // The current MMR only holds the peaks of the base MMR, so leaves in the base range are only looked up there
+        let hash = if (leaf_index as usize) < self.base_mmr.get_leaf_count() {
+            self.base_mmr.mmr().get_leaf_hash(leaf_index as usize)?
+        } else {
+            self.curr_mmr.mmr().get_leaf_hash(leaf_index as usize)?
+        };
+        Ok((hash, deleted))
     }
 
     /// Search for the leaf index of the given hash in the nodes of the current and base MMR.
@@ -225,6 +211,36 @@ where
     }
 }
 
+// Apply the checkpoints with the given indices to the MMR. The nodes added by all of the checkpoints are pushed as a
+// single batch, which results in the same MMR as applying the checkpoints one at a time.
+fn apply_checkpoints<D, B, CpBackend, I>(
+    checkpoints: &CpBackend,
+    mmr: &mut MutableMmr<D, B>,
+    cp_indices: I,
+) -> Result<(), MerkleMountainRangeError>
+where
+    D: Digest,
+    B: ArrayLike<Value = Hash>,
+    CpBackend: ArrayLike<Value = MerkleCheckPoint>,
+    I: IntoIterator<Item = usize>,
+{
+    let mut nodes_added = Vec::new();
+    let mut nodes_deleted = Bitmap::create();
+    for cp_index in cp_indices {
+        if let Some(cp) = checkpoints
+            .get(cp_index)
+            .map_err(|e| MerkleMountainRangeError::BackendError(e.to_string()))?
+        {
+            let (added, deleted) = cp.into_parts();
+            nodes_added.extend(added);
+            nodes_deleted.or_inplace(&deleted);
+        }
+    }
+    mmr.push_many(nodes_added)?;
+    mmr.deleted.or_inplace(&nodes_deleted);
+    Ok(())
+}
+
 impl<D, BaseBackend, CpBackend> Deref for MmrCache<D, BaseBackend, CpBackend>
 where
     D: Digest,
@@ -153,6 +153,19 @@ where
         Ok(self.size as usize)
     }
 
+    /// Push a batch of new elements into the MMR. See [MerkleMountainRange::push_many].
+    /// Returns the new number of leaf nodes (regardless of deleted state) in the mutable MMR
+    pub fn push_many<I: IntoIterator<Item = Hash>>(&mut self, hashes: I) -> Result<usize, MerkleMountainRangeError> {
+        let hashes = hashes.into_iter().collect::<Vec<_>>();
+        if u64::from(self.size) + hashes.len() as u64 > u64::from(u32::MAX) {
+            return Err(MerkleMountainRangeError::MaximumSizeReached);
+        }
+        let num_hashes = hashes.len() as u32;
+        self.mmr.push_many(hashes)?;
+        self.size += num_hashes;
+        Ok(self.size as usize)
+    }
+
     /// Mark a node for deletion and optionally compress the deletion bitmap. Don't call this function unless you're
     /// in a tight loop and want to eke out some extra performance by delaying the bitmap compression until after the
     /// batch deletion.
@@ -25,7 +25,7 @@ mod support;
 
 use digest::Digest;
 use support::{combine_hashes, create_mmr, int_to_hash, Hasher};
-use tari_mmr::MerkleMountainRange;
+use tari_mmr::{FlatHashVec, MerkleMountainRange};
 
 /// MMRs with no elements should provide sane defaults. The merkle root must be the hash of an empty string, b"".
 #[test]
@@ -178,3 +178,51 @@ fn find_leaf_index() {
     assert_eq!(mmr.find_leaf_index(&h4), Ok(Some(4)));
     assert_eq!(mmr.find_leaf_index(&h5), Ok(None));
 }
+
+#[test]
+fn push_many_matches_push() {
+    // Cover batches that merge into existing peaks of different heights, as well as a batch large enough to be
+    // hashed in parallel
+    for &(initial, batch) in &[
+        (0, 0),
+        (0, 1),
+        (0, 7),
+        (1, 1),
+        (3, 5),
+        (5, 27),
+        (64, 1),
+        (63, 2),
+        (100, 5000),
+    ] {
+        let expected = create_mmr(initial + batch);
+        let mut mmr = create_mmr(initial);
+        let len = mmr.push_many((initial..initial + batch).map(int_to_hash)).unwrap();
+        assert_eq!(len, expected.len().unwrap());
+        for i in 0..len {
+            assert_eq!(
+                mmr.get_node_hash(i),
+                expected.get_node_hash(i),
+                "node {} of {}+{}",
+                i,
+                initial,
+                batch
+            );
+        }
+        assert!(mmr.validate().is_ok());
+    }
+}
+
+#[test]
+fn push_many_onto_pruned_and_flat_backends() {
+    let expected = create_mmr(300);
+    let base = create_mmr(100);
+    let mut pruned = MerkleMountainRange::<Hasher, _>::new(base.get_pruned_hash_set().unwrap());
+    pruned.push_many((100..300).map(int_to_hash)).unwrap();
+    assert_eq!(pruned.get_merkle_root(), expected.get_merkle_root());
+
+    let mut flat = MerkleMountainRange::<Hasher, _>::new(FlatHashVec::for_digest::<Hasher>());
+    flat.push_many((0..300).map(int_to_hash)).unwrap();
+    assert_eq!(flat.get_merkle_root(), expected.get_merkle_root());
+    assert_eq!(flat.len(), expected.len());
+    assert!(flat.validate().is_ok());
+}
@@ -24,8 +24,8 @@
 mod support;
 
 use croaring::Bitmap;
-use support::{combine_hashes, int_to_hash, Hasher};
-use tari_mmr::{ArrayLike, ArrayLikeExt, MemBackendVec, MerkleCheckPoint, MmrCache, MmrCacheConfig};
+use support::{combine_hashes, create_mutable_mmr, int_to_hash, Hasher};
+use tari_mmr::{ArrayLike, ArrayLikeExt, FlatHashVec, MemBackendVec, MerkleCheckPoint, MmrCache, MmrCacheConfig};
 
 #[test]
 fn create_cache_update_and_rewind() {
@@ -230,3 +230,33 @@ fn checkpoint_merging() {
     assert!(mmr_cache.checkpoints_merged(3).is_ok());
     assert_eq!(mmr_cache.get_mmr_only_root(), Ok(cp6_mmr_only_root));
 }
+
+#[test]
+fn replay_checkpoints_into_flat_backend() {
+    let config = MmrCacheConfig { rewind_hist_len: 2 };
+    let mut checkpoint_db = MemBackendVec::<MerkleCheckPoint>::new();
+    let mut expected = create_mutable_mmr(0);
+    for cp_index in 0..10 {
+        let hashes = (cp_index * 7..(cp_index + 1) * 7).map(int_to_hash).collect::<Vec<_>>();
+        let mut deleted = Bitmap::create();
+        deleted.add((cp_index * 7) as u32);
+        for hash in &hashes {
+            expected.push(hash.clone()).unwrap();
+        }
+        assert!(expected.delete((cp_index * 7) as u32));
+        checkpoint_db.push(MerkleCheckPoint::new(hashes, deleted, 0)).unwrap();
+    }
+    expected.compress();
+
+    let mut mmr_cache =
+        MmrCache::<Hasher, _, _>::new(FlatHashVec::for_digest::<Hasher>(), checkpoint_db.clone(), config).unwrap();
+    assert!(mmr_cache.update().is_ok());
+    assert_eq!(mmr_cache.get_mmr_only_root(), expected.get_mmr_only_root());
+    assert_eq!(mmr_cache.len(), expected.len());
+    // Leaves from both the base and the current MMR
+    assert_eq!(mmr_cache.fetch_mmr_node(7), Ok((Some(int_to_hash(7)), true)));
+    assert_eq!(mmr_cache.fetch_mmr_node(8), Ok((Some(int_to_hash(8)), false)));
+    assert_eq!(mmr_cache.fetch_mmr_node(63), Ok((Some(int_to_hash(63)), true)));
+    assert_eq!(mmr_cache.fetch_mmr_node(69), Ok((Some(int_to_hash(69)), false)));
+    assert_eq!(mmr_cache.fetch_mmr_node(70), Ok((None, false)));
+}
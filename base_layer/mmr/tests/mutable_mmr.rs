@@ -126,6 +126,25 @@ fn build_mmr() {
     assert_eq!(mmr.get_merkle_root(), Ok(root_check));
 }
 
+#[test]
+fn push_many() {
+    let mut expected = MutableMmr::<Hasher, _>::new(Vec::default(), Bitmap::create()).unwrap();
+    let mut mmr = MutableMmr::<Hasher, _>::new(Vec::default(), Bitmap::create()).unwrap();
+    for i in 0..3 {
+        assert!(expected.push(int_to_hash(i)).is_ok());
+        assert!(mmr.push(int_to_hash(i)).is_ok());
+    }
+    assert!(expected.delete(1));
+    assert!(mmr.delete(1));
+    for i in 3..40 {
+        assert!(expected.push(int_to_hash(i)).is_ok());
+    }
+    assert_eq!(mmr.push_many((3..40).map(int_to_hash)), Ok(40));
+    assert_eq!(mmr.len(), 39);
+    assert_eq!(mmr.get_leaf_count(), 40);
+    assert_eq!(mmr.get_merkle_root(), expected.get_merkle_root());
+}
+
 #[test]
 fn equality_check() {
     let mut ma = MutableMmr::<Hasher, _>::new(Vec::default(), Bitmap::create()).unwrap();
@@ -24,7 +24,15 @@ use super::peer_message::PeerMessage;
 use crate::{comms_connector::InboundDomainConnector, tari_message::TariMessageType};
 use futures::{channel::mpsc, future, stream::Fuse, Stream, StreamExt};
 use log::*;
-use std::{cmp, fmt::Debug, sync::Arc, time::Duration};
+use std::{
+    cmp,
+    fmt::Debug,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+    time::Duration,
+};
 use tari_comms::rate_limit::RateLimit;
 use tokio::{runtime::Handle, sync::broadcast};
 
@@ -148,6 +156,21 @@ where
     /// Create a subscription stream to a particular topic. The provided label is used to identify which consumer is
     /// lagging.
     pub fn get_subscription(&self, topic: T, label: &'static str) -> impl Stream<Item = M> {
+        self.subscribe(topic, label, None)
+    }
+
+    /// Create a subscription stream to a particular topic that adds the number of messages dropped because the
+    /// consumer lagged behind to `num_lagged`. Note that the count includes messages for other topics.
+    pub fn get_subscription_with_lag_count(
+        &self,
+        topic: T,
+        label: &'static str,
+        num_lagged: Arc<AtomicUsize>,
+    ) -> impl Stream<Item = M> {
+        self.subscribe(topic, label, Some(num_lagged))
+    }
+
+    fn subscribe(&self, topic: T, label: &'static str, num_lagged: Option<Arc<AtomicUsize>>) -> impl Stream<Item = M> {
         self.sender
             .subscribe()
             .filter_map({
@@ -161,6 +184,9 @@ where
                                 target: LOG_TARGET,
                                 "Subscription '{}' for topic '{:?}' lagged. {} message(s) dropped.", label, topic, n
                             );
+                            if let Some(num_lagged) = num_lagged.as_ref() {
+                                num_lagged.fetch_add(n as usize, Ordering::Relaxed);
+                            }
                             None
                         },
                     };
@@ -0,0 +1,525 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! Wallet recovery benchmark
+//!
+//! Recovers a wallet from a synthetic chain that is served by an in-process base node and reports the scanning rate,
+//! the time spent in each stage of the scan and the peak memory use. The chain is configured with environment
+//! variables:
+//! - `RECOVERY_BENCH_OUTPUTS`: the number of outputs in the chain (default 10000)
+//! - `RECOVERY_BENCH_OWNED_FRACTION`: the fraction of the outputs that belong to the recovered wallet (default 0.05)
+//!
+//! `cargo bench -p tari_wallet --features benches --bench recovery`
+
+#[cfg(not(feature = "benches"))]
+mod benches {
+    pub fn main() {
+        println!("Enable the `benches` feature to run benches");
+    }
+}
+
+#[cfg(feature = "benches")]
+mod benches {
+    use futures::{channel::mpsc, SinkExt, StreamExt};
+    use rand::{rngs::OsRng, RngCore};
+    use std::{
+        env,
+        fs,
+        str::FromStr,
+        sync::Arc,
+        thread,
+        time::{Duration, Instant},
+    };
+    use tari_common_types::chain_metadata::ChainMetadata;
+    use tari_comms::{
+        peer_manager::PeerFeatures,
+        protocol::rpc::{mock::MockRpcServer, NamedProtocolService, Request, Response, RpcStatus, Streaming},
+        test_utils::{mocks::create_connectivity_mock, node_identity::build_node_identity},
+        types::{CommsPublicKey, CommsSecretKey},
+    };
+    use tari_core::{
+        base_node::sync::rpc::{BaseNodeSyncRpcServer, BaseNodeSyncService},
+        blocks::BlockHeader,
+        consensus::ConsensusConstantsBuilder,
+        proto,
+        proto::base_node::{
+            BlockFilterResponse,
+            FindChainSplitRequest,
+            FindChainSplitResponse,
+            SyncBlockFiltersRequest,
+            SyncBlocksRequest,
+            SyncHeadersRequest,
+            SyncKernelsRequest,
+            SyncUtxosRequest,
+            SyncUtxosResponse,
+        },
+        tari_utilities::Hashable,
+        transactions::{
+            helpers::{create_unblinded_output, TestParams},
+            tari_amount::MicroTari,
+            transaction::{OutputFeatures, TransactionOutput},
+            transaction_protocol::RewindData,
+            types::{CryptoFactories, PrivateKey},
+        },
+    };
+    use tari_crypto::{keys::SecretKey, script};
+    use tari_p2p::Network;
+    use tari_service_framework::reply_channel;
+    use tari_shutdown::Shutdown;
+    use tari_wallet::{
+        base_node_service::{handle::BaseNodeServiceHandle, mock_base_node_service::MockBaseNodeService},
+        output_manager_service::{
+            config::OutputManagerServiceConfig,
+            handle::OutputManagerHandle,
+            service::OutputManagerService,
+            storage::database::OutputManagerDatabase,
+        },
+        storage::{database::WalletDatabase, sqlite_db::WalletSqliteDatabase},
+        test_utils::{make_recoverable_output_keys, make_wallet_connectivity_mock, make_wallet_databases},
+        transaction_service::{
+            error::TransactionServiceError,
+            handle::{TransactionServiceHandle, TransactionServiceRequest, TransactionServiceResponse},
+            storage::{database::TransactionDatabase, sqlite_db::TransactionServiceSqliteDatabase},
+        },
+        utxo_scanner_service::{
+            handle::UtxoScannerEvent,
+            utxo_scanning::{UtxoScannerMode, UtxoScannerService},
+        },
+    };
+    use tokio::{
+        runtime::Runtime,
+        sync::{broadcast, broadcast::RecvError},
+        task,
+    };
+
+    const DEFAULT_NUM_OUTPUTS: usize = 10_000;
+    const DEFAULT_OWNED_FRACTION: f64 = 0.05;
+    /// The number of outputs in each block of the synthetic chain
+    const OUTPUTS_PER_BLOCK: usize = 100;
+    const SYNC_UTXOS_BUFFER_SIZE: usize = 100;
+
+    /// A chain of outputs of which every `owned_interval`th output belongs to the wallet being recovered
+    struct SyntheticChain {
+        outputs: Vec<TransactionOutput>,
+        num_owned: usize,
+        owned_value: MicroTari,
+    }
+
+    impl SyntheticChain {
+        fn build(num_outputs: usize, owned_fraction: f64, master_key: &PrivateKey) -> Self {
+            let owned_interval = if owned_fraction > 0.0 {
+                ((1.0 / owned_fraction.min(1.0)).round() as usize).max(1)
+            } else {
+                num_outputs.saturating_add(1)
+            };
+            let owned_indexes = (0..num_outputs).filter(|i| i % owned_interval == 0).collect::<Vec<_>>();
+            let (spending_keys, rewind_data) = make_recoverable_output_keys(master_key, owned_indexes.len() as u64);
+            let owned_value = owned_indexes
+                .iter()
+                .fold(MicroTari::from(0), |total, i| total + output_value(*i));
+
+            // Building the range proofs dominates the fixture set up, so it is spread over all the cores
+            let num_threads = num_cpus::get().max(1);
+            let chunk_size = (num_outputs + num_threads - 1) / num_threads;
+            let spending_keys = Arc::new(spending_keys);
+            let builders = (0..num_threads)
+                .map(|n| {
+                    let start = (n * chunk_size).min(num_outputs);
+                    let end = ((n + 1) * chunk_size).min(num_outputs);
+                    let spending_keys = spending_keys.clone();
+                    let rewind_data = rewind_data.clone();
+                    thread::spawn(move || build_outputs(start, end, owned_interval, &spending_keys, &rewind_data))
+                })
+                .collect::<Vec<_>>();
+            let outputs = builders
+                .into_iter()
+                .flat_map(|b| b.join().expect("Output builder thread panicked"))
+                .collect();
+
+            Self {
+                outputs,
+                num_owned: owned_indexes.len(),
+                owned_value,
+            }
+        }
+
+        fn tip_header(&self) -> BlockHeader {
+            let mut header = BlockHeader::new(0);
+            header.height = (self.outputs.len() / OUTPUTS_PER_BLOCK) as u64;
+            header.output_mmr_size = self.outputs.len() as u64;
+            header
+        }
+    }
+
+    fn output_value(index: usize) -> MicroTari {
+        MicroTari::from(1_000 + index as u64)
+    }
+
+    fn build_outputs(
+        start: usize,
+        end: usize,
+        owned_interval: usize,
+        spending_keys: &[PrivateKey],
+        rewind_data: &RewindData,
+    ) -> Vec<TransactionOutput> {
+        let factories = CryptoFactories::default();
+        (start..end)
+            .map(|i| {
+                let mut output = create_unblinded_output(
+                    script!(Nop),
+                    OutputFeatures::default(),
+                    TestParams::new(),
+                    output_value(i),
+                );
+                if i % owned_interval == 0 {
+                    output.spending_key = spending_keys[i / owned_interval].clone();
+                    output.as_rewindable_transaction_output(&factories, rewind_data)
+                } else {
+                    output.as_transaction_output(&factories)
+                }
+                .expect("Should be able to build output")
+            })
+            .collect()
+    }
+
+    /// Serves the synthetic chain with the base node sync RPC interface used by the UTXO scanner
+    #[derive(Clone)]
+    struct SyntheticChainService {
+        outputs: Arc<Vec<TransactionOutput>>,
+        tip_header: BlockHeader,
+    }
+
+    #[tari_comms::async_trait]
+    impl BaseNodeSyncService for SyntheticChainService {
+        async fn sync_blocks(
+            &self,
+            _: Request<SyncBlocksRequest>,
+        ) -> Result<Streaming<proto::base_node::BlockBodyResponse>, RpcStatus> {
+            Err(RpcStatus::not_implemented("The synthetic chain has no blocks"))
+        }
+
+        async fn sync_headers(
+            &self,
+            _: Request<SyncHeadersRequest>,
+        ) -> Result<Streaming<proto::core::BlockHeader>, RpcStatus> {
+            Err(RpcStatus::not_implemented("The synthetic chain only has a tip header"))
+        }
+
+        async fn get_header_by_height(
+            &self,
+            request: Request<u64>,
+        ) -> Result<Response<proto::core::BlockHeader>, RpcStatus> {
+            if request.into_message() != self.tip_header.height {
+                return Err(RpcStatus::not_found("The synthetic chain only has a tip header"));
+            }
+            Ok(Response::new(self.tip_header.clone().into()))
+        }
+
+        async fn find_chain_split(
+            &self,
+            _: Request<FindChainSplitRequest>,
+        ) -> Result<Response<FindChainSplitResponse>, RpcStatus> {
+            Ok(Response::new(FindChainSplitResponse {
+                headers: Vec::new(),
+                fork_hash_index: 0,
+                tip_height: self.tip_header.height,
+            }))
+        }
+
+        async fn get_chain_metadata(
+            &self,
+            _: Request<()>,
+        ) -> Result<Response<proto::base_node::ChainMetadata>, RpcStatus> {
+            let metadata = ChainMetadata::new(self.tip_header.height, self.tip_header.hash(), 0, 0, 1);
+            Ok(Response::new(metadata.into()))
+        }
+
+        async fn sync_kernels(
+            &self,
+            _: Request<SyncKernelsRequest>,
+        ) -> Result<Streaming<proto::types::TransactionKernel>, RpcStatus> {
+            Err(RpcStatus::not_implemented("The synthetic chain has no kernels"))
+        }
+
+        async fn sync_utxos(
+            &self,
+            request: Request<SyncUtxosRequest>,
+        ) -> Result<Streaming<SyncUtxosResponse>, RpcStatus> {
+            let request = request.into_message();
+            let start = request.start as usize;
+            let end = match request.end_mmr_index {
+                0 => self.outputs.len(),
+                end => (end as usize).min(self.outputs.len()),
+            };
+            let outputs = self.outputs.clone();
+            let (mut tx, rx) = mpsc::channel(SYNC_UTXOS_BUFFER_SIZE);
+            task::spawn(async move {
+                for (i, output) in outputs.iter().enumerate().take(end).skip(start) {
+                    let response = SyncUtxosResponse {
+                        utxo_or_deleted: Some(proto::base_node::sync_utxos_response::UtxoOrDeleted::Utxo(
+                            proto::base_node::SyncUtxo {
+                                utxo: Some(proto::base_node::sync_utxo::Utxo::Output(output.clone().into())),
+                            },
+                        )),
+                        mmr_index: i as u64,
+                    };
+                    if tx.send(Ok(response)).await.is_err() {
+                        break;
+                    }
+                }
+            });
+            Ok(Streaming::new(rx))
+        }
+
+        async fn sync_block_filters(
+            &self,
+            _: Request<SyncBlockFiltersRequest>,
+        ) -> Result<Streaming<BlockFilterResponse>, RpcStatus> {
+            Err(RpcStatus::not_implemented("The synthetic chain has no blocks"))
+        }
+    }
+
+    /// Stands in for the transaction service by writing the import transaction records to the database
+    async fn run_transaction_service(
+        request_stream: reply_channel::Receiver<
+            TransactionServiceRequest,
+            Result<TransactionServiceResponse, TransactionServiceError>,
+        >,
+        db: TransactionDatabase<TransactionServiceSqliteDatabase>,
+        node_public_key: CommsPublicKey,
+    ) {
+        let mut request_stream = request_stream;
+        while let Some(request_context) = request_stream.next().await {
+            let (request, reply_tx) = request_context.split();
+            let response = match request {
+                TransactionServiceRequest::ImportUtxo(value, source_public_key, message, maturity) => {
+                    let tx_id = OsRng.next_u64();
+                    db.add_utxo_import_transaction(
+                        tx_id,
+                        value,
+                        source_public_key,
+                        node_public_key.clone(),
+                        message,
+                        maturity,
+                    )
+                    .await
+                    .map(|_| TransactionServiceResponse::UtxoImported(tx_id))
+                    .map_err(TransactionServiceError::from)
+                },
+                request => Err(TransactionServiceError::InvalidMessageError(format!(
+                    "{} is not supported by the benchmark",
+                    request
+                ))),
+            };
+            let _ = reply_tx.send(response);
+        }
+    }
+
+    struct RecoveryReport {
+        number_scanned: u64,
+        number_received: u64,
+        value_received: MicroTari,
+        time_taken: Duration,
+        rewind_time: Duration,
+        import_time: Duration,
+        persist_time: Duration,
+    }
+
+    fn recover_wallet(runtime: &mut Runtime, chain: &SyntheticChain, master_key: CommsSecretKey) -> RecoveryReport {
+        let shutdown = Shutdown::new();
+        let factories = CryptoFactories::default();
+        let (wallet_backend, transaction_backend, output_manager_backend, _, _temp_dir) = make_wallet_databases(None);
+
+        let base_node_identity = build_node_identity(PeerFeatures::COMMUNICATION_NODE);
+        let wallet_node_identity = build_node_identity(PeerFeatures::COMMUNICATION_CLIENT);
+        let server = BaseNodeSyncRpcServer::new(SyntheticChainService {
+            outputs: Arc::new(chain.outputs.clone()),
+            tip_header: chain.tip_header(),
+        });
+        let protocol_name = server.as_protocol_name();
+        let mut mock_server = runtime
+            .handle()
+            .enter(|| MockRpcServer::new(server, base_node_identity.clone()));
+        runtime.handle().enter(|| mock_server.serve());
+
+        let (connectivity_manager, connectivity_mock) = create_connectivity_mock();
+        let connectivity_mock_state = connectivity_mock.get_shared_state();
+        runtime.spawn(connectivity_mock.run());
+        let connection =
+            runtime.block_on(mock_server.create_connection(base_node_identity.to_peer(), protocol_name.into()));
+        runtime.block_on(connectivity_mock_state.add_active_connection(connection));
+
+        let (ts_request_sender, ts_request_receiver) = reply_channel::unbounded();
+        let (ts_event_publisher, _) = broadcast::channel(100);
+        let ts_handle = TransactionServiceHandle::new(ts_request_sender, ts_event_publisher);
+        runtime.spawn(run_transaction_service(
+            ts_request_receiver,
+            TransactionDatabase::new(transaction_backend),
+            wallet_node_identity.public_key().clone(),
+        ));
+
+        let (bns_request_sender, bns_request_receiver) = reply_channel::unbounded();
+        let (bns_event_publisher, _) = broadcast::channel(100);
+        let bns_handle = BaseNodeServiceHandle::new(bns_request_sender, bns_event_publisher);
+        let mut mock_base_node_service = MockBaseNodeService::new(bns_request_receiver, shutdown.to_signal());
+        mock_base_node_service.set_default_base_node_state();
+        runtime.spawn(mock_base_node_service.run());
+
+        let (oms_request_sender, oms_request_receiver) = reply_channel::unbounded();
+        let (oms_event_publisher, _) = broadcast::channel(200);
+        let output_manager_service = runtime
+            .block_on(OutputManagerService::new(
+                OutputManagerServiceConfig::default(),
+                ts_handle.clone(),
+                oms_request_receiver,
+                OutputManagerDatabase::new(output_manager_backend),
+                oms_event_publisher.clone(),
+                factories.clone(),
+                ConsensusConstantsBuilder::new(Network::Weatherwax).build(),
+                shutdown.to_signal(),
+                bns_handle,
+                connectivity_manager.clone(),
+                make_wallet_connectivity_mock(),
+                master_key,
+            ))
+            .expect("Should be able to create the output manager service");
+        let oms_handle = OutputManagerHandle::new(oms_request_sender, oms_event_publisher);
+        runtime.spawn(async move { output_manager_service.start().await });
+
+        let (_scanner_request_sender, scanner_request_receiver) = reply_channel::unbounded();
+        let (scanner_event_sender, _) = broadcast::channel(200);
+        let mut scanner = UtxoScannerService::<WalletSqliteDatabase>::builder()
+            .with_peers(vec![base_node_identity.public_key().clone()])
+            .with_retry_limit(1)
+            .with_mode(UtxoScannerMode::Recovery)
+            .build_with_resources(
+                WalletDatabase::new(wallet_backend),
+                connectivity_manager,
+                make_wallet_connectivity_mock(),
+                oms_handle,
+                ts_handle,
+                wallet_node_identity,
+                factories,
+                shutdown.to_signal(),
+                scanner_request_receiver,
+                scanner_event_sender,
+            );
+        let mut events = scanner.get_event_receiver();
+        runtime.spawn(scanner.run());
+
+        runtime.block_on(async move {
+            let mut stage_times = (Duration::default(), Duration::default(), Duration::default());
+            loop {
+                match events.recv().await {
+                    Ok(UtxoScannerEvent::ScanningStatistics {
+                        rewind_time,
+                        import_time,
+                        persist_time,
+                    }) => {
+                        stage_times = (rewind_time, import_time, persist_time);
+                    },
+                    Ok(UtxoScannerEvent::Completed {
+                        number_scanned,
+                        number_received,
+                        value_received,
+                        time_taken,
+                    }) => {
+                        let (rewind_time, import_time, persist_time) = stage_times;
+                        return RecoveryReport {
+                            number_scanned,
+                            number_received,
+                            value_received,
+                            time_taken,
+                            rewind_time,
+                            import_time,
+                            persist_time,
+                        };
+                    },
+                    Ok(UtxoScannerEvent::ScanningRoundFailed { .. }) => {
+                        panic!("The recovery failed to scan the synthetic chain");
+                    },
+                    Ok(_) | Err(RecvError::Lagged(_)) => {},
+                    Err(RecvError::Closed) => panic!("The recovery stopped before it completed"),
+                }
+            }
+        })
+    }
+
+    /// The peak resident set size of this process in kB (Linux only)
+    fn peak_memory_kb() -> Option<u64> {
+        let status = fs::read_to_string("/proc/self/status").ok()?;
+        status
+            .lines()
+            .find(|line| line.starts_with("VmHWM:"))
+            .and_then(|line| line.split_whitespace().nth(1))
+            .and_then(|v| v.parse().ok())
+    }
+
+    fn format_memory(kb: Option<u64>) -> String {
+        kb.map(|kb| format!("{:.1} MiB", kb as f64 / 1024.0))
+            .unwrap_or_else(|| "unavailable".to_string())
+    }
+
+    fn env_or<T: FromStr>(name: &str, default: T) -> T {
+        env::var(name).ok().and_then(|v| v.parse().ok()).unwrap_or(default)
+    }
+
+    pub fn main() {
+        let num_outputs = env_or("RECOVERY_BENCH_OUTPUTS", DEFAULT_NUM_OUTPUTS);
+        let owned_fraction = env_or("RECOVERY_BENCH_OWNED_FRACTION", DEFAULT_OWNED_FRACTION);
+        let master_key = CommsSecretKey::random(&mut OsRng);
+
+        let timer = Instant::now();
+        let chain = SyntheticChain::build(num_outputs, owned_fraction, &master_key);
+        let fixture_memory = peak_memory_kb();
+        println!(
+            "Built a synthetic chain of {} outputs ({} owned) in {:.2?}",
+            chain.outputs.len(),
+            chain.num_owned,
+            timer.elapsed()
+        );
+
+        let mut runtime = Runtime::new().expect("Should be able to start a runtime");
+        let report = recover_wallet(&mut runtime, &chain, master_key);
+        let rate = report.number_scanned as f64 / report.time_taken.as_secs_f64().max(f64::EPSILON);
+
+        println!(
+            "Scanned            : {} outputs in {:.2?}",
+            report.number_scanned, report.time_taken
+        );
+        println!("Rate               : {:.1} outputs/s", rate);
+        println!(
+            "Recovered          : {} of {} owned outputs worth {} (expected {})",
+            report.number_received, chain.num_owned, report.value_received, chain.owned_value
+        );
+        // The output manager stores the outputs it recovers while rewinding, so that is included in the rewind time
+        println!("Rewind time        : {:.2?}", report.rewind_time);
+        println!("Import time        : {:.2?}", report.import_time);
+        println!("Progress DB time   : {:.2?}", report.persist_time);
+        println!("Peak memory        : {}", format_memory(peak_memory_kb()));
+        println!("Fixture peak memory: {}", format_memory(fixture_memory));
+    }
+}
+
+fn main() {
+    benches::main();
+}
@@ -0,0 +1,2 @@
+DROP INDEX IF EXISTS idx_completed_transactions_cancelled_status_timestamp;
+DROP INDEX IF EXISTS idx_completed_transactions_cancelled_timestamp;
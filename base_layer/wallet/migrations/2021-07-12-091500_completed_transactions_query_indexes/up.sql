@@ -0,0 +1,4 @@
+CREATE INDEX idx_completed_transactions_cancelled_timestamp
+    ON completed_transactions (cancelled, timestamp DESC, tx_id DESC);
+CREATE INDEX idx_completed_transactions_cancelled_status_timestamp
+    ON completed_transactions (cancelled, status, timestamp DESC, tx_id DESC);
@@ -0,0 +1,21 @@
+DROP TRIGGER IF EXISTS completed_transactions_change_seq_update;
+DROP TRIGGER IF EXISTS completed_transactions_change_seq_insert;
+DROP TRIGGER IF EXISTS outbound_transactions_change_seq_update;
+DROP TRIGGER IF EXISTS outbound_transactions_change_seq_insert;
+DROP TRIGGER IF EXISTS inbound_transactions_change_seq_update;
+DROP TRIGGER IF EXISTS inbound_transactions_change_seq_insert;
+
+DROP INDEX IF EXISTS idx_completed_transactions_change_seq;
+DROP INDEX IF EXISTS idx_outbound_transactions_change_seq;
+DROP INDEX IF EXISTS idx_inbound_transactions_change_seq;
+
+ALTER TABLE completed_transactions
+    DROP COLUMN change_seq;
+
+ALTER TABLE outbound_transactions
+    DROP COLUMN change_seq;
+
+ALTER TABLE inbound_transactions
+    DROP COLUMN change_seq;
+
+DROP TABLE IF EXISTS transaction_change_sequence;
@@ -0,0 +1,77 @@
+-- A single row counter that is bumped every time a transaction row is inserted, updated or cancelled. The new value is
+-- stamped onto the changed row so that clients can ask for the rows that changed after a sequence number they have
+-- already seen.
+CREATE TABLE transaction_change_sequence (
+    id  INTEGER PRIMARY KEY NOT NULL CHECK (id = 1),
+    seq BIGINT NOT NULL
+);
+
+INSERT INTO transaction_change_sequence (id, seq) VALUES (1, 1);
+
+-- Existing rows are all reported as changed to a client that starts from sequence 0
+ALTER TABLE inbound_transactions
+    ADD COLUMN change_seq BIGINT NOT NULL DEFAULT 1;
+
+ALTER TABLE outbound_transactions
+    ADD COLUMN change_seq BIGINT NOT NULL DEFAULT 1;
+
+ALTER TABLE completed_transactions
+    ADD COLUMN change_seq BIGINT NOT NULL DEFAULT 1;
+
+CREATE INDEX idx_inbound_transactions_change_seq ON inbound_transactions (change_seq);
+CREATE INDEX idx_outbound_transactions_change_seq ON outbound_transactions (change_seq);
+CREATE INDEX idx_completed_transactions_change_seq ON completed_transactions (change_seq);
+
+-- The update triggers list the columns explicitly so that stamping `change_seq` does not fire them again, and so that
+-- re-writing the protocol columns when applying or removing encryption is not reported as a change.
+CREATE TRIGGER inbound_transactions_change_seq_insert AFTER INSERT ON inbound_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE inbound_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
+
+CREATE TRIGGER inbound_transactions_change_seq_update
+    AFTER UPDATE OF cancelled, direct_send_success, send_count, last_send_timestamp ON inbound_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE inbound_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
+
+CREATE TRIGGER outbound_transactions_change_seq_insert AFTER INSERT ON outbound_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE outbound_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
+
+CREATE TRIGGER outbound_transactions_change_seq_update
+    AFTER UPDATE OF cancelled, direct_send_success, send_count, last_send_timestamp ON outbound_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE outbound_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
+
+CREATE TRIGGER completed_transactions_change_seq_insert AFTER INSERT ON completed_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE completed_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
+
+CREATE TRIGGER completed_transactions_change_seq_update
+    AFTER UPDATE OF status, timestamp, cancelled, direction, send_count, last_send_timestamp, valid, confirmations,
+    mined_height ON completed_transactions
+BEGIN
+    UPDATE transaction_change_sequence SET seq = seq + 1 WHERE id = 1;
+    UPDATE completed_transactions
+    SET change_seq = (SELECT seq FROM transaction_change_sequence WHERE id = 1)
+    WHERE tx_id = NEW.tx_id;
+END;
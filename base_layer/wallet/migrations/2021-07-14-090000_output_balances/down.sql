@@ -0,0 +1,7 @@
+DROP INDEX IF EXISTS idx_outputs_status_maturity;
+
+DROP TRIGGER IF EXISTS outputs_balance_delete;
+DROP TRIGGER IF EXISTS outputs_balance_update;
+DROP TRIGGER IF EXISTS outputs_balance_insert;
+
+DROP TABLE IF EXISTS output_balances;
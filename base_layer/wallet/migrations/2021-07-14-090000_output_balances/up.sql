@@ -0,0 +1,30 @@
+-- The total value of the outputs in each status. The totals are maintained by triggers so they are always updated in
+-- the same transaction as the outputs, and reading the balance does not have to scan or decrypt the outputs.
+CREATE TABLE output_balances (
+    status INTEGER PRIMARY KEY NOT NULL,
+    total  BIGINT NOT NULL
+);
+
+INSERT INTO output_balances (status, total)
+SELECT status, SUM(value) FROM outputs GROUP BY status;
+
+CREATE TRIGGER outputs_balance_insert AFTER INSERT ON outputs
+BEGIN
+    INSERT OR IGNORE INTO output_balances (status, total) VALUES (NEW.status, 0);
+    UPDATE output_balances SET total = total + NEW.value WHERE status = NEW.status;
+END;
+
+CREATE TRIGGER outputs_balance_update AFTER UPDATE OF status, value ON outputs
+BEGIN
+    UPDATE output_balances SET total = total - OLD.value WHERE status = OLD.status;
+    INSERT OR IGNORE INTO output_balances (status, total) VALUES (NEW.status, 0);
+    UPDATE output_balances SET total = total + NEW.value WHERE status = NEW.status;
+END;
+
+CREATE TRIGGER outputs_balance_delete AFTER DELETE ON outputs
+BEGIN
+    UPDATE output_balances SET total = total - OLD.value WHERE status = OLD.status;
+END;
+
+-- Time-locked balances are summed over the unspent outputs that have not matured yet
+CREATE INDEX idx_outputs_status_maturity ON outputs (status, maturity);
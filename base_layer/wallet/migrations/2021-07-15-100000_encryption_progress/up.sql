@@ -0,0 +1,7 @@
+-- The position reached in each table while encryption is applied to or removed from the wallet. A row exists only while
+-- a pass over its table is incomplete, so that an interrupted pass can continue where it stopped.
+CREATE TABLE encryption_progress (
+    table_name TEXT PRIMARY KEY NOT NULL,
+    encrypting INTEGER NOT NULL,
+    last_id    BIGINT NOT NULL
+);
@@ -0,0 +1,7 @@
+ALTER TABLE completed_transactions
+    DROP COLUMN validated_height;
+
+ALTER TABLE outputs
+    DROP COLUMN validated_height;
+
+DROP TABLE IF EXISTS validation_checkpoints;
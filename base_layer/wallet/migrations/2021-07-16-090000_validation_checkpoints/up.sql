@@ -0,0 +1,14 @@
+-- The chain tip that each set of outputs or transactions was last validated against, so that a later validation only
+-- has to query the base node about the items that the blocks after the tip could have changed.
+CREATE TABLE validation_checkpoints (
+    name       TEXT PRIMARY KEY NOT NULL,
+    height     BIGINT NOT NULL,
+    block_hash BLOB NOT NULL
+);
+
+-- The chain height at which each item was last confirmed by a validation, NULL if it has never been validated
+ALTER TABLE outputs
+    ADD COLUMN validated_height BIGINT NULL;
+
+ALTER TABLE completed_transactions
+    ADD COLUMN validated_height BIGINT NULL;
@@ -0,0 +1,161 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use log::*;
+use std::{
+    collections::HashMap,
+    fmt,
+    sync::{Arc, Mutex, Weak},
+    time::Duration,
+};
+use tari_common_types::chain_metadata::ChainMetadata;
+use tari_comms::peer_manager::NodeId;
+use tokio::sync::watch;
+
+const LOG_TARGET: &str = "wallet::base_node_service::chain_metadata_hub";
+
+/// The chain state of a base node as observed by the wallet that is polling it
+#[derive(Debug, Clone, PartialEq)]
+pub struct SharedChainState {
+    pub chain_metadata: ChainMetadata,
+    pub is_synced: bool,
+    pub latency: Option<Duration>,
+}
+
+type ChainStateReceiver = watch::Receiver<Option<SharedChainState>>;
+
+struct ChainStateChannel {
+    sender: watch::Sender<Option<SharedChainState>>,
+    receiver: ChainStateReceiver,
+}
+
+/// Lets many wallets in one process that use the same base node share a single chain metadata poller. The first
+/// wallet to join for a base node becomes the publisher and polls it, every other wallet follows the published state
+/// instead of opening its own RPC session and sending its own tip info requests. When the publisher stops, because
+/// its wallet shut down or lost the connection, the followers are notified and one of them takes over.
+#[derive(Clone, Default)]
+pub struct ChainMetadataHub {
+    channels: Arc<Mutex<HashMap<NodeId, Weak<ChainStateChannel>>>>,
+}
+
+impl ChainMetadataHub {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Join the hub for the given base node, returning whether the caller must poll the base node itself or can
+    /// follow the wallet that already does.
+    pub fn join(&self, base_node: &NodeId) -> ChainStateLease {
+        let mut channels = acquire_lock!(self.channels);
+        if let Some(channel) = channels.get(base_node).and_then(Weak::upgrade) {
+            trace!(target: LOG_TARGET, "Following the chain state of base node {}", base_node);
+            return ChainStateLease::Follower(channel.receiver.clone());
+        }
+
+        channels.retain(|_, channel| channel.strong_count() > 0);
+        let (sender, receiver) = watch::channel(None);
+        let channel = Arc::new(ChainStateChannel { sender, receiver });
+        channels.insert(base_node.clone(), Arc::downgrade(&channel));
+        debug!(target: LOG_TARGET, "Publishing the chain state of base node {}", base_node);
+        ChainStateLease::Publisher(ChainStatePublisher { channel })
+    }
+}
+
+impl fmt::Debug for ChainMetadataHub {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "ChainMetadataHub")
+    }
+}
+
+/// The role a wallet has been given by the `ChainMetadataHub` for a base node
+pub enum ChainStateLease {
+    /// No other wallet is polling the base node, the holder must poll it and publish what it observes
+    Publisher(ChainStatePublisher),
+    /// Another wallet is polling the base node. The receiver yields `None` once that wallet stops publishing.
+    Follower(ChainStateReceiver),
+}
+
+/// Held by the wallet polling a base node. Dropping it hands the polling over to one of the followers.
+pub struct ChainStatePublisher {
+    channel: Arc<ChainStateChannel>,
+}
+
+impl ChainStatePublisher {
+    pub fn publish(&self, state: SharedChainState) {
+        // The channel holds a receiver of its own so broadcasting cannot fail while the publisher exists
+        let _ = self.channel.sender.broadcast(Some(state));
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use crate::base_node_service::chain_metadata_hub::{ChainMetadataHub, ChainStateLease, SharedChainState};
+    use rand::rngs::OsRng;
+    use tari_common_types::chain_metadata::ChainMetadata;
+    use tari_comms::{peer_manager::NodeId, types::CommsPublicKey};
+    use tari_crypto::keys::PublicKey;
+    use tokio::runtime::Runtime;
+
+    fn random_node_id() -> NodeId {
+        let (_, public_key) = CommsPublicKey::random_keypair(&mut OsRng);
+        NodeId::from_key(&public_key)
+    }
+
+    #[test]
+    fn test_chain_metadata_hub() {
+        let mut runtime = Runtime::new().unwrap();
+        let hub = ChainMetadataHub::new();
+        let base_node = random_node_id();
+
+        let publisher = match hub.join(&base_node) {
+            ChainStateLease::Publisher(publisher) => publisher,
+            ChainStateLease::Follower(_) => panic!("The first wallet to join should publish"),
+        };
+        let mut follower = match hub.join(&base_node) {
+            ChainStateLease::Follower(receiver) => receiver,
+            ChainStateLease::Publisher(_) => panic!("The second wallet to join should follow"),
+        };
+        match hub.join(&random_node_id()) {
+            ChainStateLease::Publisher(_) => {},
+            ChainStateLease::Follower(_) => panic!("A different base node should get its own publisher"),
+        }
+
+        let state = SharedChainState {
+            chain_metadata: ChainMetadata::new(10, vec![1u8; 32], 0, 0, 100),
+            is_synced: true,
+            latency: None,
+        };
+        publisher.publish(state.clone());
+        let mut received = runtime.block_on(follower.recv()).unwrap();
+        if received.is_none() {
+            received = runtime.block_on(follower.recv()).unwrap();
+        }
+        assert_eq!(received, Some(state));
+
+        drop(publisher);
+        assert!(runtime.block_on(follower.recv()).is_none());
+        match hub.join(&base_node) {
+            ChainStateLease::Publisher(_) => {},
+            ChainStateLease::Follower(_) => panic!("A follower should take over once the publisher stops"),
+        }
+    }
+}
@@ -20,6 +20,7 @@
 // WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+use crate::base_node_service::chain_metadata_hub::ChainMetadataHub;
 use log::*;
 use std::time::Duration;
 
@@ -29,6 +30,8 @@ const LOG_TARGET: &str = "wallet::base_node_service::config";
 pub struct BaseNodeServiceConfig {
     pub base_node_monitor_refresh_interval: Duration,
     pub request_max_age: Duration,
+    /// When set, the chain metadata of the base node is polled once for all the wallets sharing the hub
+    pub chain_metadata_hub: Option<ChainMetadataHub>,
 }
 
 impl Default for BaseNodeServiceConfig {
@@ -36,6 +39,7 @@ impl Default for BaseNodeServiceConfig {
         Self {
             base_node_monitor_refresh_interval: Duration::from_secs(5),
             request_max_age: Duration::from_secs(60),
+            chain_metadata_hub: None,
         }
     }
 }
@@ -51,6 +55,7 @@ impl BaseNodeServiceConfig {
         Self {
             base_node_monitor_refresh_interval: Duration::from_secs(refresh_interval),
             request_max_age: Duration::from_secs(request_max_age),
+            chain_metadata_hub: None,
         }
     }
 }
@@ -22,6 +22,7 @@
 
 use crate::{
     base_node_service::{
+        chain_metadata_hub::{ChainMetadataHub, ChainStateLease, ChainStatePublisher, SharedChainState},
         handle::{BaseNodeEvent, BaseNodeEventSender},
         service::{BaseNodeState, OnlineState},
     },
@@ -43,7 +44,7 @@ use tari_core::base_node::rpc::BaseNodeWalletRpcClient;
 use tari_shutdown::ShutdownSignal;
 use tokio::{
     stream::StreamExt,
-    sync::{broadcast, RwLock},
+    sync::{broadcast, watch, RwLock},
     time,
 };
 
@@ -55,6 +56,7 @@ pub struct BaseNodeMonitor<T> {
     db: WalletDatabase<T>,
     connectivity_manager: ConnectivityRequester,
     event_publisher: BaseNodeEventSender,
+    chain_metadata_hub: Option<ChainMetadataHub>,
     shutdown_signal: ShutdownSignal,
 }
 
@@ -65,6 +67,7 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
         db: WalletDatabase<T>,
         connectivity_manager: ConnectivityRequester,
         event_publisher: BaseNodeEventSender,
+        chain_metadata_hub: Option<ChainMetadataHub>,
         shutdown_signal: ShutdownSignal,
     ) -> Self {
         Self {
@@ -73,6 +76,7 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
             db,
             connectivity_manager,
             event_publisher,
+            chain_metadata_hub,
             shutdown_signal,
         }
     }
@@ -112,6 +116,13 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
                     self.set_connecting().await;
                     continue;
                 },
+                Err(BaseNodeMonitorError::SharedMonitorStopped) => {
+                    debug!(
+                        target: LOG_TARGET,
+                        "The wallet polling the shared base node stopped. Rejoining the chain metadata hub...",
+                    );
+                    continue;
+                },
                 Err(e @ BaseNodeMonitorError::InvalidBaseNodeResponse(_)) |
                 Err(e @ BaseNodeMonitorError::WalletStorageError(_)) => {
                     error!(target: LOG_TARGET, "{}", e);
@@ -130,6 +141,17 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
 
     async fn process(&mut self) -> Result<(), BaseNodeMonitorError> {
         let peer = self.wait_for_peer_to_be_set().await?;
+        let publisher = match self.chain_metadata_hub.as_ref().map(|hub| hub.join(&peer)) {
+            Some(ChainStateLease::Follower(updates)) => {
+                debug!(
+                    target: LOG_TARGET,
+                    "Base node is polled by another wallet. Following its chain metadata...",
+                );
+                return self.follow_node(peer, updates).await;
+            },
+            Some(ChainStateLease::Publisher(publisher)) => Some(publisher),
+            None => None,
+        };
         let connection = self.attempt_dial(peer.clone()).await?;
         debug!(
             target: LOG_TARGET,
@@ -137,7 +159,7 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
         );
         let client = self.connect_client(connection).await?;
         debug!(target: LOG_TARGET, "RPC established",);
-        self.monitor_node(peer, client).await?;
+        self.monitor_node(peer, client, publisher).await?;
         Ok(())
     }
 
@@ -190,6 +212,7 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
         &self,
         peer_node_id: NodeId,
         mut client: BaseNodeWalletRpcClient,
+        publisher: Option<ChainStatePublisher>,
     ) -> Result<(), BaseNodeMonitorError> {
         loop {
             let latency = client.get_last_request_latency().await?;
@@ -209,17 +232,14 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
                     ChainMetadata::try_from(metadata).map_err(BaseNodeMonitorError::InvalidBaseNodeResponse)
                 })?;
 
-            self.db.set_chain_metadata(chain_metadata.clone()).await?;
-
-            self.map_state(move |state| BaseNodeState {
-                chain_metadata: Some(chain_metadata),
-                is_synced: Some(is_synced),
-                updated: Some(Utc::now().naive_utc()),
-                latency,
-                online: OnlineState::Online,
-                base_node_peer: state.base_node_peer.clone(),
-            })
-            .await;
+            if let Some(publisher) = publisher.as_ref() {
+                publisher.publish(SharedChainState {
+                    chain_metadata: chain_metadata.clone(),
+                    is_synced,
+                    latency,
+                });
+            }
+            self.set_online(chain_metadata, is_synced, latency).await?;
 
             self.sleep_or_shutdown().await?;
             self.check_if_base_node_changed(&peer_node_id).await?;
@@ -230,6 +250,56 @@ impl<T: WalletBackend + 'static> BaseNodeMonitor<T> {
         Ok(())
     }
 
+    /// Follow the chain metadata published by the wallet that polls the base node, until that wallet stops polling it
+    async fn follow_node(
+        &self,
+        peer_node_id: NodeId,
+        mut updates: watch::Receiver<Option<SharedChainState>>,
+    ) -> Result<(), BaseNodeMonitorError> {
+        loop {
+            let update = {
+                let recv = updates.recv();
+                futures::pin_mut!(recv);
+                let mut shutdown_signal = self.shutdown_signal.clone();
+                match future::select(recv, &mut shutdown_signal).await {
+                    Either::Left((update, _)) => update,
+                    Either::Right(_) => return Err(BaseNodeMonitorError::NodeShuttingDown),
+                }
+            };
+
+            match update {
+                Some(Some(shared)) => {
+                    self.set_online(shared.chain_metadata, shared.is_synced, shared.latency)
+                        .await?
+                },
+                // The publisher has not reached the base node yet
+                Some(None) => {},
+                None => return Err(BaseNodeMonitorError::SharedMonitorStopped),
+            }
+            self.check_if_base_node_changed(&peer_node_id).await?;
+        }
+    }
+
+    async fn set_online(
+        &self,
+        chain_metadata: ChainMetadata,
+        is_synced: bool,
+        latency: Option<Duration>,
+    ) -> Result<(), BaseNodeMonitorError> {
+        self.db.set_chain_metadata(chain_metadata.clone()).await?;
+
+        self.map_state(move |state| BaseNodeState {
+            chain_metadata: Some(chain_metadata),
+            is_synced: Some(is_synced),
+            updated: Some(Utc::now().naive_utc()),
+            latency,
+            online: OnlineState::Online,
+            base_node_peer: state.base_node_peer.clone(),
+        })
+        .await;
+        Ok(())
+    }
+
     async fn check_if_base_node_changed(&self, peer_node_id: &NodeId) -> Result<(), BaseNodeMonitorError> {
         // Check if the base node peer is no longer set or has changed
         if self
@@ -316,4 +386,6 @@ enum BaseNodeMonitorError {
     WalletStorageError(#[from] WalletStorageError),
     #[error("Base node changed")]
     BaseNodeChanged,
+    #[error("The shared base node monitor stopped")]
+    SharedMonitorStopped,
 }
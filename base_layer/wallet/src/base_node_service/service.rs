@@ -126,6 +126,7 @@ where T: WalletBackend + 'static
             self.db.clone(),
             self.connectivity_manager.clone(),
             self.event_publisher.clone(),
+            self.config.chain_metadata_hub.clone(),
             shutdown_signal.clone(),
         );
 
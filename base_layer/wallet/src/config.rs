@@ -22,6 +22,7 @@
 
 use crate::{
     base_node_service::config::BaseNodeServiceConfig,
+    connectivity_service::WalletConnectivityConfig,
     output_manager_service::config::OutputManagerServiceConfig,
     transaction_service::config::TransactionServiceConfig,
 };
@@ -42,6 +43,7 @@ pub struct WalletConfig {
     pub network: NetworkConsensus,
     pub base_node_service_config: BaseNodeServiceConfig,
     pub scan_for_utxo_interval: Duration,
+    pub connectivity_config: WalletConnectivityConfig,
 }
 
 impl WalletConfig {
@@ -67,6 +69,7 @@ impl WalletConfig {
             network,
             base_node_service_config: base_node_service_config.unwrap_or_default(),
             scan_for_utxo_interval: scan_for_utxo_interval.unwrap_or_else(|| Duration::from_secs(43200)),
+            connectivity_config: WalletConnectivityConfig::default(),
         }
     }
 }
@@ -0,0 +1,137 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use super::{error::WalletConnectivityError, service::BaseNodePools};
+use futures::{channel::mpsc, SinkExt};
+use log::*;
+use std::{fmt, sync::Arc, time::Duration};
+use tari_comms::{
+    peer_manager::NodeId,
+    protocol::rpc::{RpcClientLease, RpcClientPoolStats},
+};
+use tari_core::base_node::{rpc::BaseNodeWalletRpcClient, sync::rpc::BaseNodeSyncRpcClient};
+use tokio::sync::RwLock;
+
+const LOG_TARGET: &str = "wallet::connectivity";
+
+pub(crate) enum WalletConnectivityRequest {
+    SetBaseNode(NodeId),
+}
+
+/// Statistics for the RPC session pools to the base node
+#[derive(Debug, Clone)]
+pub struct BaseNodePoolStats {
+    pub node_id: NodeId,
+    /// The wallet RPC pools and their request deadline
+    pub wallet_rpc: Vec<(Duration, RpcClientPoolStats)>,
+    /// The sync RPC pools and their request deadline
+    pub sync_rpc: Vec<(Duration, RpcClientPoolStats)>,
+}
+
+impl fmt::Display for BaseNodePoolStats {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "Base node {}:", self.node_id)?;
+        for (deadline, stats) in &self.wallet_rpc {
+            write!(f, " wallet RPC {:.0?} ({})", deadline, stats)?;
+        }
+        for (deadline, stats) in &self.sync_rpc {
+            write!(f, " sync RPC {:.0?} ({})", deadline, stats)?;
+        }
+        Ok(())
+    }
+}
+
+/// Handle to the wallet connectivity service, which keeps pools of established RPC sessions to the base node so that
+/// the wallet services do not each pay the connection and handshake latency.
+#[derive(Clone)]
+pub struct WalletConnectivityHandle {
+    sender: mpsc::Sender<WalletConnectivityRequest>,
+    pools: Arc<RwLock<Option<BaseNodePools>>>,
+}
+
+impl WalletConnectivityHandle {
+    pub(crate) fn new(
+        sender: mpsc::Sender<WalletConnectivityRequest>,
+        pools: Arc<RwLock<Option<BaseNodePools>>>,
+    ) -> Self {
+        Self { sender, pools }
+    }
+
+    /// Set the base node to keep RPC sessions open to. Sessions to any previous base node are dropped.
+    pub async fn set_base_node(&mut self, node_id: NodeId) -> Result<(), WalletConnectivityError> {
+        self.sender
+            .send(WalletConnectivityRequest::SetBaseNode(node_id))
+            .await
+            .map_err(|_| WalletConnectivityError::ServiceTerminated)
+    }
+
+    /// Obtain a wallet RPC session to the given base node from the pool of sessions with the given request deadline.
+    /// None is returned if the base node is not connected or a session could not be established, in which case the
+    /// caller should connect the session itself.
+    pub async fn obtain_base_node_wallet_rpc_client(
+        &self,
+        node_id: &NodeId,
+        deadline: Duration,
+    ) -> Option<RpcClientLease<BaseNodeWalletRpcClient>> {
+        let pool = self.get_pools(node_id).await?.wallet_rpc.get(deadline);
+        match pool.get().await {
+            Ok(client) => Some(client),
+            Err(err) => {
+                debug!(target: LOG_TARGET, "No pooled wallet RPC session available: {}", err);
+                None
+            },
+        }
+    }
+
+    /// Obtain a sync RPC session to the given base node from the pool of sessions with the given request deadline.
+    /// None is returned if the base node is not connected or a session could not be established, in which case the
+    /// caller should connect the session itself.
+    pub async fn obtain_base_node_sync_rpc_client(
+        &self,
+        node_id: &NodeId,
+        deadline: Duration,
+    ) -> Option<RpcClientLease<BaseNodeSyncRpcClient>> {
+        let pool = self.get_pools(node_id).await?.sync_rpc.get(deadline);
+        match pool.get().await {
+            Ok(client) => Some(client),
+            Err(err) => {
+                debug!(target: LOG_TARGET, "No pooled sync RPC session available: {}", err);
+                None
+            },
+        }
+    }
+
+    /// Returns the statistics of the session pools, or None if no base node is connected
+    pub async fn get_pool_stats(&self) -> Option<BaseNodePoolStats> {
+        let pools = self.pools.read().await.clone()?;
+        Some(pools.stats().await)
+    }
+
+    async fn get_pools(&self, node_id: &NodeId) -> Option<BaseNodePools> {
+        self.pools
+            .read()
+            .await
+            .as_ref()
+            .filter(|pools| pools.node_id == *node_id)
+            .cloned()
+    }
+}
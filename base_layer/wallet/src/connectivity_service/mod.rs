@@ -0,0 +1,74 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+mod config;
+pub use config::WalletConnectivityConfig;
+
+mod error;
+pub use error::WalletConnectivityError;
+
+mod handle;
+pub use handle::{BaseNodePoolStats, WalletConnectivityHandle};
+
+mod service;
+pub use service::WalletConnectivityService;
+
+use futures::channel::mpsc;
+use log::*;
+use std::sync::Arc;
+use tari_comms::connectivity::ConnectivityRequester;
+use tari_service_framework::{async_trait, ServiceInitializationError, ServiceInitializer, ServiceInitializerContext};
+use tokio::sync::RwLock;
+
+const LOG_TARGET: &str = "wallet::connectivity";
+
+pub struct WalletConnectivityInitializer {
+    config: WalletConnectivityConfig,
+}
+
+impl WalletConnectivityInitializer {
+    pub fn new(config: WalletConnectivityConfig) -> Self {
+        Self { config }
+    }
+}
+
+#[async_trait]
+impl ServiceInitializer for WalletConnectivityInitializer {
+    async fn initialize(&mut self, context: ServiceInitializerContext) -> Result<(), ServiceInitializationError> {
+        info!(target: LOG_TARGET, "Wallet connectivity service initializing.");
+        let (sender, request_rx) = mpsc::channel(10);
+        let pools = Arc::new(RwLock::new(None));
+
+        // Register handle before waiting for handles to be ready
+        context.register_handle(WalletConnectivityHandle::new(sender, pools.clone()));
+
+        let config = self.config.clone();
+        context.spawn_when_ready(move |handles| async move {
+            let connectivity = handles.expect_handle::<ConnectivityRequester>();
+            WalletConnectivityService::new(config, request_rx, connectivity, pools, handles.get_shutdown_signal())
+                .run()
+                .await;
+        });
+
+        Ok(())
+    }
+}
@@ -0,0 +1,261 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use super::{
+    config::WalletConnectivityConfig,
+    handle::{BaseNodePoolStats, WalletConnectivityRequest},
+};
+use futures::{channel::mpsc, FutureExt, StreamExt};
+use log::*;
+use std::{
+    collections::HashMap,
+    sync::{Arc, Mutex},
+    time::Duration,
+};
+use tari_comms::{
+    connectivity::ConnectivityRequester,
+    peer_manager::NodeId,
+    protocol::rpc::{
+        NamedProtocolService,
+        RpcClient,
+        RpcClientBuilder,
+        RpcClientPool,
+        RpcClientPoolError,
+        RpcClientPoolStats,
+        RpcPoolClient,
+    },
+    PeerConnection,
+};
+use tari_core::base_node::{rpc::BaseNodeWalletRpcClient, sync::rpc::BaseNodeSyncRpcClient};
+use tari_shutdown::ShutdownSignal;
+use tokio::{sync::RwLock, time};
+
+const LOG_TARGET: &str = "wallet::connectivity";
+
+/// The RPC session pools to the current base node
+#[derive(Clone)]
+pub(crate) struct BaseNodePools {
+    pub node_id: NodeId,
+    connection: PeerConnection,
+    pub wallet_rpc: DeadlinePools<BaseNodeWalletRpcClient>,
+    pub sync_rpc: DeadlinePools<BaseNodeSyncRpcClient>,
+}
+
+impl BaseNodePools {
+    fn new(connection: PeerConnection, config: &WalletConnectivityConfig) -> Self {
+        Self {
+            node_id: connection.peer_node_id().clone(),
+            wallet_rpc: DeadlinePools::new(connection.clone(), config.base_node_rpc_pool_size),
+            sync_rpc: DeadlinePools::new(connection.clone(), config.base_node_rpc_pool_size),
+            connection,
+        }
+    }
+
+    fn is_connected(&self) -> bool {
+        self.connection.is_connected()
+    }
+
+    pub async fn stats(&self) -> BaseNodePoolStats {
+        BaseNodePoolStats {
+            node_id: self.node_id.clone(),
+            wallet_rpc: self.wallet_rpc.stats().await,
+            sync_rpc: self.sync_rpc.stats().await,
+        }
+    }
+}
+
+/// RPC session pools of one kind to the base node. Sessions send their deadline to the base node when they are
+/// established, so the pools are keyed by deadline and each wallet flow gets sessions with its own deadline.
+#[derive(Clone)]
+pub(crate) struct DeadlinePools<T> {
+    connection: PeerConnection,
+    pool_size: usize,
+    pools: Arc<Mutex<HashMap<Duration, RpcClientPool<T>>>>,
+}
+
+impl<T> DeadlinePools<T>
+where T: RpcPoolClient + From<RpcClient> + NamedProtocolService + Clone
+{
+    fn new(connection: PeerConnection, pool_size: usize) -> Self {
+        Self {
+            connection,
+            pool_size,
+            pools: Default::default(),
+        }
+    }
+
+    /// Returns the pool of sessions with the given deadline, creating it if this is the first request for it
+    pub fn get(&self, deadline: Duration) -> RpcClientPool<T> {
+        let mut pools = acquire_lock!(self.pools);
+        pools
+            .entry(deadline)
+            .or_insert_with(|| {
+                self.connection
+                    .create_rpc_client_pool(self.pool_size, RpcClientBuilder::new().with_deadline(deadline))
+            })
+            .clone()
+    }
+
+    /// Re-establishes the closed sessions of every pool. Returns the number of sessions that were established.
+    async fn warm_up(&self) -> Result<usize, RpcClientPoolError> {
+        let mut num_established = 0;
+        for pool in self.pools() {
+            num_established += pool.warm_up().await?;
+        }
+        Ok(num_established)
+    }
+
+    async fn stats(&self) -> Vec<(Duration, RpcClientPoolStats)> {
+        let mut stats = Vec::new();
+        for (deadline, pool) in self.deadlines_and_pools() {
+            stats.push((deadline, pool.stats().await));
+        }
+        stats.sort_by_key(|(deadline, _)| *deadline);
+        stats
+    }
+
+    fn pools(&self) -> Vec<RpcClientPool<T>> {
+        acquire_lock!(self.pools).values().cloned().collect()
+    }
+
+    fn deadlines_and_pools(&self) -> Vec<(Duration, RpcClientPool<T>)> {
+        acquire_lock!(self.pools)
+            .iter()
+            .map(|(deadline, pool)| (*deadline, pool.clone()))
+            .collect()
+    }
+}
+
+/// # Wallet connectivity service
+///
+/// Keeps a connection and pools of warm RPC sessions to the wallet's base node. The base node is dialed as soon as it
+/// is set and is then checked every `keepalive_interval`. A dropped connection is re-dialed and closed sessions are
+/// re-established ahead of the next request.
+pub struct WalletConnectivityService {
+    config: WalletConnectivityConfig,
+    request_rx: Option<mpsc::Receiver<WalletConnectivityRequest>>,
+    connectivity: ConnectivityRequester,
+    pools: Arc<RwLock<Option<BaseNodePools>>>,
+    base_node: Option<NodeId>,
+    shutdown_signal: ShutdownSignal,
+}
+
+impl WalletConnectivityService {
+    pub(super) fn new(
+        config: WalletConnectivityConfig,
+        request_rx: mpsc::Receiver<WalletConnectivityRequest>,
+        connectivity: ConnectivityRequester,
+        pools: Arc<RwLock<Option<BaseNodePools>>>,
+        shutdown_signal: ShutdownSignal,
+    ) -> Self {
+        Self {
+            config,
+            request_rx: Some(request_rx),
+            connectivity,
+            pools,
+            base_node: None,
+            shutdown_signal,
+        }
+    }
+
+    pub async fn run(mut self) {
+        let mut request_rx = self
+            .request_rx
+            .take()
+            .expect("WalletConnectivityService initialized without request_rx")
+            .fuse();
+        let mut keepalive = time::interval(self.config.keepalive_interval).fuse();
+        let mut shutdown = self.shutdown_signal.clone().fuse();
+
+        debug!(target: LOG_TARGET, "Wallet connectivity service started");
+        loop {
+            futures::select! {
+                request = request_rx.select_next_some() => {
+                    self.handle_request(request).await;
+                },
+                _ = keepalive.select_next_some() => {
+                    self.keep_alive().await;
+                },
+                _ = shutdown => {
+                    break;
+                }
+            }
+        }
+        *self.pools.write().await = None;
+        debug!(target: LOG_TARGET, "Wallet connectivity service shut down");
+    }
+
+    async fn handle_request(&mut self, request: WalletConnectivityRequest) {
+        use WalletConnectivityRequest::*;
+        match request {
+            SetBaseNode(node_id) => {
+                if self.base_node.as_ref() == Some(&node_id) {
+                    return;
+                }
+                debug!(target: LOG_TARGET, "Base node set to {}", node_id);
+                self.base_node = Some(node_id);
+                *self.pools.write().await = None;
+                self.keep_alive().await;
+            },
+        }
+    }
+
+    async fn keep_alive(&mut self) {
+        let node_id = match self.base_node.clone() {
+            Some(node_id) => node_id,
+            None => return,
+        };
+
+        let current = self.pools.read().await.clone();
+        let pools = match current {
+            Some(pools) if pools.is_connected() => pools,
+            _ => match self.connectivity.dial_peer(node_id.clone()).await {
+                Ok(connection) => {
+                    debug!(target: LOG_TARGET, "Connected to base node {}", node_id);
+                    let pools = BaseNodePools::new(connection, &self.config);
+                    *self.pools.write().await = Some(pools.clone());
+                    pools
+                },
+                Err(err) => {
+                    debug!(
+                        target: LOG_TARGET,
+                        "Failed to connect to base node {}: {}. Retrying in {:.0?}",
+                        node_id,
+                        err,
+                        self.config.keepalive_interval
+                    );
+                    *self.pools.write().await = None;
+                    return;
+                },
+            },
+        };
+
+        // Re-establish any sessions that have closed so that they are ready before the next request
+        if let Err(err) = pools.wallet_rpc.warm_up().await {
+            debug!(target: LOG_TARGET, "Failed to establish wallet RPC session(s): {}", err);
+        }
+        if let Err(err) = pools.sync_rpc.warm_up().await {
+            debug!(target: LOG_TARGET, "Failed to establish sync RPC session(s): {}", err);
+        }
+        trace!(target: LOG_TARGET, "{}", pools.stats().await);
+    }
+}
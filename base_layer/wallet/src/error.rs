@@ -21,11 +21,12 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityError,
     base_node_service::error::BaseNodeServiceError,
     contacts_service::error::ContactsServiceError,
-    output_manager_service::error::OutputManagerError,
+    output_manager_service::error::{OutputManagerError, OutputManagerStorageError},
     storage::database::DbKey,
-    transaction_service::error::TransactionServiceError,
+    transaction_service::error::{TransactionServiceError, TransactionStorageError},
     utxo_scanner_service::error::UtxoScannerError,
 };
 use diesel::result::Error as DieselError;
@@ -71,6 +72,8 @@ pub enum WalletError {
     ServiceInitializationError(#[from] ServiceInitializationError),
     #[error("Base Node Service error: {0}")]
     BaseNodeServiceError(#[from] BaseNodeServiceError),
+    #[error("Wallet connectivity error: {0}")]
+    WalletConnectivityError(#[from] WalletConnectivityError),
     #[error("Node ID error: `{0}`")]
     NodeIdError(#[from] NodeIdError),
     #[error("Error performing wallet recovery: '{0}'")]
@@ -141,4 +144,8 @@ pub enum WalletStorageError {
     IncorrectPassword,
     #[error("Deprecated operation error")]
     DeprecatedOperation,
+    #[error("Output manager storage error: `{0}`")]
+    OutputManagerStorageError(#[from] OutputManagerStorageError),
+    #[error("Transaction storage error: `{0}`")]
+    TransactionStorageError(#[from] TransactionStorageError),
 }
@@ -30,6 +30,12 @@ pub struct OutputManagerServiceConfig {
     pub prevent_fee_gt_amount: bool,
     pub peer_dial_retry_timeout: Duration,
     pub seed_word_language: MnemonicLanguage,
+    /// The number of threads used to rewind the range proofs of scanned outputs during recovery
+    pub rewind_workers: usize,
+    /// The round trip time that TXO validation aims for when sizing its batch queries
+    pub txo_validation_target_latency: Duration,
+    /// The maximum number of TXO validation batch queries that can be in flight to the base node at once
+    pub txo_validation_max_in_flight: usize,
 }
 
 impl Default for OutputManagerServiceConfig {
@@ -40,6 +46,9 @@ impl Default for OutputManagerServiceConfig {
             prevent_fee_gt_amount: true,
             peer_dial_retry_timeout: Duration::from_secs(20),
             seed_word_language: MnemonicLanguage::English,
+            rewind_workers: num_cpus::get(),
+            txo_validation_target_latency: Duration::from_secs(5),
+            txo_validation_max_in_flight: 4,
         }
     }
 }
@@ -24,11 +24,15 @@ use crate::{
     output_manager_service::{
         error::OutputManagerError,
         service::Balance,
-        storage::{database::PendingTransactionOutputs, models::KnownOneSidedPaymentScript},
+        storage::{
+            database::PendingTransactionOutputs,
+            models::{DbOutputSummary, KnownOneSidedPaymentScript},
+        },
         tasks::TxoValidationType,
         TxId,
     },
     types::ValidationRetryStrategy,
+    util::encryption::EncryptionProgress,
 };
 use aes_gcm::Aes256Gcm;
 use futures::{stream::Fuse, StreamExt};
@@ -58,24 +62,28 @@ pub enum OutputManagerRequest {
     ConfirmPendingTransaction(u64),
     ConfirmTransaction((u64, Vec<TransactionInput>, Vec<TransactionOutput>)),
     PrepareToSendTransaction((MicroTari, MicroTari, Option<u64>, String, TariScript)),
+    PrepareToSendTransactions((Vec<(MicroTari, String)>, MicroTari, Option<u64>)),
     CreatePayToSelfTransaction((MicroTari, MicroTari, Option<u64>, String)),
     CancelTransaction(u64),
     TimeoutTransactions(Duration),
     GetPendingTransactions,
     GetSpentOutputs,
     GetUnspentOutputs,
+    GetSpentOutputSummaries,
+    GetUnspentOutputSummaries,
     GetInvalidOutputs,
     GetSeedWords,
     SetBaseNodePublicKey(CommsPublicKey),
     ValidateUtxos(TxoValidationType, ValidationRetryStrategy),
     CreateCoinSplit((MicroTari, usize, MicroTari, Option<u64>)),
-    ApplyEncryption(Box<Aes256Gcm>),
-    RemoveEncryption,
+    ApplyEncryption((Box<Aes256Gcm>, EncryptionProgress)),
+    RemoveEncryption(EncryptionProgress),
     GetPublicRewindKeys,
     FeeEstimate((MicroTari, MicroTari, u64, u64)),
     ScanForRecoverableOutputs(Vec<TransactionOutput>),
     ScanOutputs(Vec<TransactionOutput>),
     AddKnownOneSidedPaymentScript(KnownOneSidedPaymentScript),
+    GetKnownOneSidedPaymentScripts,
 }
 
 impl fmt::Display for OutputManagerRequest {
@@ -96,25 +104,31 @@ impl fmt::Display for OutputManagerRequest {
             ConfirmTransaction(v) => write!(f, "ConfirmTransaction ({})", v.0),
             ConfirmPendingTransaction(v) => write!(f, "ConfirmPendingTransaction ({})", v),
             PrepareToSendTransaction((_, _, _, msg, _)) => write!(f, "PrepareToSendTransaction ({})", msg),
+            PrepareToSendTransactions((payments, _, _)) => {
+                write!(f, "PrepareToSendTransactions ({} payments)", payments.len())
+            },
             CreatePayToSelfTransaction((_, _, _, msg)) => write!(f, "CreatePayToSelfTransaction ({})", msg),
             CancelTransaction(v) => write!(f, "CancelTransaction ({})", v),
             TimeoutTransactions(d) => write!(f, "TimeoutTransactions ({}s)", d.as_secs()),
             GetPendingTransactions => write!(f, "GetPendingTransactions"),
             GetSpentOutputs => write!(f, "GetSpentOutputs"),
             GetUnspentOutputs => write!(f, "GetUnspentOutputs"),
+            GetSpentOutputSummaries => write!(f, "GetSpentOutputSummaries"),
+            GetUnspentOutputSummaries => write!(f, "GetUnspentOutputSummaries"),
             GetInvalidOutputs => write!(f, "GetInvalidOutputs"),
             GetSeedWords => write!(f, "GetSeedWords"),
             SetBaseNodePublicKey(k) => write!(f, "SetBaseNodePublicKey ({})", k),
             ValidateUtxos(validation_type, retry) => write!(f, "{} ({:?})", validation_type, retry),
             CreateCoinSplit(v) => write!(f, "CreateCoinSplit ({})", v.0),
             ApplyEncryption(_) => write!(f, "ApplyEncryption"),
-            RemoveEncryption => write!(f, "RemoveEncryption"),
+            RemoveEncryption(_) => write!(f, "RemoveEncryption"),
             GetCoinbaseTransaction(_) => write!(f, "GetCoinbaseTransaction"),
             GetPublicRewindKeys => write!(f, "GetPublicRewindKeys"),
             FeeEstimate(_) => write!(f, "FeeEstimate"),
             ScanForRecoverableOutputs(_) => write!(f, "ScanForRecoverableOutputs"),
             ScanOutputs(_) => write!(f, "ScanRewindAndImportOutputs"),
             AddKnownOneSidedPaymentScript(_) => write!(f, "AddKnownOneSidedPaymentScript"),
+            GetKnownOneSidedPaymentScripts => write!(f, "GetKnownOneSidedPaymentScripts"),
         }
     }
 }
@@ -132,11 +146,14 @@ pub enum OutputManagerResponse {
     PayToSelfTransaction((TxId, MicroTari, Transaction)),
     TransactionConfirmed,
     TransactionToSend(SenderTransactionProtocol),
+    TransactionsToSend(Vec<SenderTransactionProtocol>),
     TransactionCancelled,
     TransactionsTimedOut,
     PendingTransactions(HashMap<u64, PendingTransactionOutputs>),
     SpentOutputs(Vec<UnblindedOutput>),
     UnspentOutputs(Vec<UnblindedOutput>),
+    SpentOutputSummaries(Vec<DbOutputSummary>),
+    UnspentOutputSummaries(Vec<DbOutputSummary>),
     InvalidOutputs(Vec<UnblindedOutput>),
     SeedWords(Vec<String>),
     BaseNodePublicKeySet,
@@ -149,6 +166,7 @@ pub enum OutputManagerResponse {
     RewoundOutputs(Vec<UnblindedOutput>),
     ScanOutputs(Vec<UnblindedOutput>),
     AddKnownOneSidedPaymentScript,
+    KnownOneSidedPaymentScripts(Vec<TariScript>),
 }
 
 pub type OutputManagerEventSender = broadcast::Sender<Arc<OutputManagerEvent>>;
@@ -299,6 +317,28 @@ impl OutputManagerHandle {
         }
     }
 
+    /// Prepare a transaction to send for each of the `payments` of an amount with a message in one request. The outputs
+    /// to spend are still selected for each transaction in turn. If any of them cannot be prepared none are.
+    pub async fn prepare_transactions_to_send(
+        &mut self,
+        payments: Vec<(MicroTari, String)>,
+        fee_per_gram: MicroTari,
+        lock_height: Option<u64>,
+    ) -> Result<Vec<SenderTransactionProtocol>, OutputManagerError> {
+        match self
+            .handle
+            .call(OutputManagerRequest::PrepareToSendTransactions((
+                payments,
+                fee_per_gram,
+                lock_height,
+            )))
+            .await??
+        {
+            OutputManagerResponse::TransactionsToSend(stps) => Ok(stps),
+            _ => Err(OutputManagerError::UnexpectedApiResponse),
+        }
+    }
+
     /// Get a fee estimate for an amount of MicroTari, at a specified fee per gram and given number of kernels and
     /// outputs.
     pub async fn fee_estimate(
@@ -400,6 +440,31 @@ impl OutputManagerHandle {
         }
     }
 
+    /// The public parts of the spent outputs, read without decrypting their secret keys
+    pub async fn get_spent_output_summaries(&mut self) -> Result<Vec<DbOutputSummary>, OutputManagerError> {
+        match self
+            .handle
+            .call(OutputManagerRequest::GetSpentOutputSummaries)
+            .await??
+        {
+            OutputManagerResponse::SpentOutputSummaries(s) => Ok(s),
+            _ => Err(OutputManagerError::UnexpectedApiResponse),
+        }
+    }
+
+    /// The public parts of the unspent outputs, read without decrypting their secret keys. Sorted from lowest value to
+    /// highest
+    pub async fn get_unspent_output_summaries(&mut self) -> Result<Vec<DbOutputSummary>, OutputManagerError> {
+        match self
+            .handle
+            .call(OutputManagerRequest::GetUnspentOutputSummaries)
+            .await??
+        {
+            OutputManagerResponse::UnspentOutputSummaries(s) => Ok(s),
+            _ => Err(OutputManagerError::UnexpectedApiResponse),
+        }
+    }
+
     pub async fn get_invalid_outputs(&mut self) -> Result<Vec<UnblindedOutput>, OutputManagerError> {
         match self.handle.call(OutputManagerRequest::GetInvalidOutputs).await?? {
             OutputManagerResponse::InvalidOutputs(s) => Ok(s),
@@ -472,9 +537,19 @@ impl OutputManagerHandle {
     }
 
     pub async fn apply_encryption(&mut self, cipher: Aes256Gcm) -> Result<(), OutputManagerError> {
+        self.apply_encryption_with_progress(cipher, EncryptionProgress::default())
+            .await
+    }
+
+    /// Apply encryption, reporting the number of rows encrypted to `progress`
+    pub async fn apply_encryption_with_progress(
+        &mut self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), OutputManagerError> {
         match self
             .handle
-            .call(OutputManagerRequest::ApplyEncryption(Box::new(cipher)))
+            .call(OutputManagerRequest::ApplyEncryption((Box::new(cipher), progress)))
             .await??
         {
             OutputManagerResponse::EncryptionApplied => Ok(()),
@@ -483,7 +558,20 @@ impl OutputManagerHandle {
     }
 
     pub async fn remove_encryption(&mut self) -> Result<(), OutputManagerError> {
-        match self.handle.call(OutputManagerRequest::RemoveEncryption).await?? {
+        self.remove_encryption_with_progress(EncryptionProgress::default())
+            .await
+    }
+
+    /// Remove encryption, reporting the number of rows decrypted to `progress`
+    pub async fn remove_encryption_with_progress(
+        &mut self,
+        progress: EncryptionProgress,
+    ) -> Result<(), OutputManagerError> {
+        match self
+            .handle
+            .call(OutputManagerRequest::RemoveEncryption(progress))
+            .await??
+        {
             OutputManagerResponse::EncryptionRemoved => Ok(()),
             _ => Err(OutputManagerError::UnexpectedApiResponse),
         }
@@ -524,6 +612,18 @@ impl OutputManagerHandle {
         }
     }
 
+    /// The scripts this wallet looks for when scanning for one-sided payments
+    pub async fn get_known_one_sided_payment_scripts(&mut self) -> Result<Vec<TariScript>, OutputManagerError> {
+        match self
+            .handle
+            .call(OutputManagerRequest::GetKnownOneSidedPaymentScripts)
+            .await??
+        {
+            OutputManagerResponse::KnownOneSidedPaymentScripts(scripts) => Ok(scripts),
+            _ => Err(OutputManagerError::UnexpectedApiResponse),
+        }
+    }
+
     pub async fn create_pay_to_self_transaction(
         &mut self,
         amount: MicroTari,
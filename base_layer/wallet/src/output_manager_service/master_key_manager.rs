@@ -49,6 +49,29 @@ const KEY_MANAGER_RECOVERY_VIEWONLY_BRANCH_KEY: &str = "recovery_viewonly";
 const KEY_MANAGER_RECOVERY_BLINDING_BRANCH_KEY: &str = "recovery_blinding";
 const KEY_MANAGER_MAX_SEARCH_DEPTH: u64 = 1_000_000;
 
+/// Derive the data used to rewind the range proofs of the outputs that belong to the wallet with this master key
+pub(crate) fn derive_rewind_data(master_key: &PrivateKey) -> Result<RewindData, OutputManagerError> {
+    let rewind_key_manager = KeyManager::<PrivateKey, KeyDigest>::from(
+        master_key.clone(),
+        KEY_MANAGER_RECOVERY_VIEWONLY_BRANCH_KEY.to_string(),
+        0,
+    );
+    let rewind_key = rewind_key_manager.derive_key(0)?.k;
+
+    let rewind_blinding_key_manager = KeyManager::<PrivateKey, KeyDigest>::from(
+        master_key.clone(),
+        KEY_MANAGER_RECOVERY_BLINDING_BRANCH_KEY.to_string(),
+        0,
+    );
+    let rewind_blinding_key = rewind_blinding_key_manager.derive_key(0)?.k;
+
+    Ok(RewindData {
+        rewind_key,
+        rewind_blinding_key,
+        proof_message: [0u8; REWIND_USER_MESSAGE_LENGTH],
+    })
+}
+
 pub(crate) struct MasterKeyManager<TBackend>
 where TBackend: OutputManagerBackend + 'static
 {
@@ -110,25 +133,7 @@ where TBackend: OutputManagerBackend + 'static
             0,
         );
 
-        let rewind_key_manager = KeyManager::<PrivateKey, KeyDigest>::from(
-            key_manager_state.master_key.clone(),
-            KEY_MANAGER_RECOVERY_VIEWONLY_BRANCH_KEY.to_string(),
-            0,
-        );
-        let rewind_key = rewind_key_manager.derive_key(0)?.k;
-
-        let rewind_blinding_key_manager = KeyManager::<PrivateKey, KeyDigest>::from(
-            key_manager_state.master_key,
-            KEY_MANAGER_RECOVERY_BLINDING_BRANCH_KEY.to_string(),
-            0,
-        );
-        let rewind_blinding_key = rewind_blinding_key_manager.derive_key(0)?.k;
-
-        let rewind_data = RewindData {
-            rewind_key,
-            rewind_blinding_key,
-            proof_message: [0u8; REWIND_USER_MESSAGE_LENGTH],
-        };
+        let rewind_data = derive_rewind_data(&key_manager_state.master_key)?;
 
         Ok(Self {
             utxo_key_manager: Mutex::new(utxo_key_manager),
@@ -22,6 +22,7 @@
 
 use crate::{
     base_node_service::handle::BaseNodeServiceHandle,
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::{
         config::OutputManagerServiceConfig,
         handle::OutputManagerHandle,
@@ -57,7 +58,7 @@ pub mod service;
 pub mod storage;
 mod tasks;
 
-pub(crate) use master_key_manager::MasterKeyManager;
+pub(crate) use master_key_manager::{derive_rewind_data, MasterKeyManager};
 pub use tasks::TxoValidationType;
 
 const LOG_TARGET: &str = "wallet::output_manager_service::initializer";
@@ -124,6 +125,7 @@ where T: OutputManagerBackend + 'static
             let transaction_service = handles.expect_handle::<TransactionServiceHandle>();
             let base_node_service_handle = handles.expect_handle::<BaseNodeServiceHandle>();
             let connectivity_manager = handles.expect_handle::<ConnectivityRequester>();
+            let wallet_connectivity = handles.expect_handle::<WalletConnectivityHandle>();
 
             let service = OutputManagerService::new(
                 config,
@@ -136,6 +138,7 @@ where T: OutputManagerBackend + 'static
                 handles.get_shutdown_signal(),
                 base_node_service_handle,
                 connectivity_manager,
+                wallet_connectivity,
                 master_secret_key,
             )
             .await
@@ -28,13 +28,16 @@ use crate::output_manager_service::{
     },
     MasterKeyManager,
 };
+use futures::future;
 use log::*;
 use std::sync::Arc;
 use tari_core::transactions::{
     transaction::{TransactionOutput, UnblindedOutput},
+    transaction_protocol::RewindData,
     types::{CryptoFactories, PublicKey},
 };
 use tari_crypto::{inputs, keys::PublicKey as PublicKeyTrait, tari_utilities::hex::Hex};
+use tokio::task;
 
 const LOG_TARGET: &str = "wallet::output_manager_service::recovery";
 
@@ -42,6 +45,7 @@ pub(crate) struct StandardUtxoRecoverer<TBackend: OutputManagerBackend + 'static
     master_key_manager: Arc<MasterKeyManager<TBackend>>,
     factories: CryptoFactories,
     db: OutputManagerDatabase<TBackend>,
+    rewind_workers: usize,
 }
 
 impl<TBackend> StandardUtxoRecoverer<TBackend>
@@ -51,11 +55,13 @@ where TBackend: OutputManagerBackend + 'static
         master_key_manager: Arc<MasterKeyManager<TBackend>>,
         factories: CryptoFactories,
         db: OutputManagerDatabase<TBackend>,
+        rewind_workers: usize,
     ) -> Self {
         Self {
             master_key_manager,
             factories,
             db,
+            rewind_workers,
         }
     }
 
@@ -65,41 +71,7 @@ where TBackend: OutputManagerBackend + 'static
         &mut self,
         outputs: Vec<TransactionOutput>,
     ) -> Result<Vec<UnblindedOutput>, OutputManagerError> {
-        let mut rewound_outputs: Vec<UnblindedOutput> = outputs
-            .into_iter()
-            .filter_map(|output| {
-                output
-                    .full_rewind_range_proof(
-                        &self.factories.range_proof,
-                        &self.master_key_manager.rewind_data().rewind_key,
-                        &self.master_key_manager.rewind_data().rewind_blinding_key,
-                    )
-                    .ok()
-                    .map(|v| {
-                        (
-                            v,
-                            output.features,
-                            output.script,
-                            output.sender_offset_public_key,
-                            output.metadata_signature,
-                        )
-                    })
-            })
-            .map(
-                |(output, features, script, sender_offset_public_key, metadata_signature)| {
-                    UnblindedOutput::new(
-                        output.committed_value,
-                        output.blinding_factor.clone(),
-                        Some(features),
-                        script,
-                        inputs!(PublicKey::from_secret_key(&output.blinding_factor)),
-                        output.blinding_factor,
-                        sender_offset_public_key,
-                        metadata_signature,
-                    )
-                },
-            )
-            .collect();
+        let mut rewound_outputs = self.rewind_outputs(outputs).await?;
 
         for output in rewound_outputs.iter_mut() {
             self.update_outputs_script_private_key_and_update_key_manager_index(output)
@@ -123,6 +95,37 @@ where TBackend: OutputManagerBackend + 'static
         Ok(rewound_outputs)
     }
 
+    /// Rewind the range proofs of the outputs on up to `rewind_workers` blocking threads. The outputs are split into
+    /// contiguous chunks so that the rewound outputs keep the order in which they were given.
+    async fn rewind_outputs(
+        &self,
+        mut outputs: Vec<TransactionOutput>,
+    ) -> Result<Vec<UnblindedOutput>, OutputManagerError> {
+        if outputs.is_empty() {
+            return Ok(Vec::new());
+        }
+        let workers = self.rewind_workers.max(1);
+        let chunk_size = (outputs.len() + workers - 1) / workers;
+        let mut chunks = Vec::with_capacity(workers);
+        while outputs.len() > chunk_size {
+            let rest = outputs.split_off(chunk_size);
+            chunks.push(outputs);
+            outputs = rest;
+        }
+        chunks.push(outputs);
+
+        let tasks = chunks.into_iter().map(|chunk| {
+            let factories = self.factories.clone();
+            let rewind_data = self.master_key_manager.rewind_data().clone();
+            task::spawn_blocking(move || rewind_chunk(chunk, &factories, &rewind_data))
+        });
+        let rewound_chunks = future::try_join_all(tasks)
+            .await
+            .map_err(|e| OutputManagerError::BlockingTaskSpawnError(e.to_string()))?;
+
+        Ok(rewound_chunks.into_iter().flatten().collect())
+    }
+
     /// Find the key manager index that corresponds to the spending key in the rewound output, if found then modify
     /// output to contain correct associated script private key and update the key manager to the highest index it has
     /// seen so far.
@@ -145,3 +148,45 @@ where TBackend: OutputManagerBackend + 'static
         Ok(())
     }
 }
+
+fn rewind_chunk(
+    outputs: Vec<TransactionOutput>,
+    factories: &CryptoFactories,
+    rewind_data: &RewindData,
+) -> Vec<UnblindedOutput> {
+    outputs
+        .into_iter()
+        .filter_map(|output| {
+            output
+                .full_rewind_range_proof(
+                    &factories.range_proof,
+                    &rewind_data.rewind_key,
+                    &rewind_data.rewind_blinding_key,
+                )
+                .ok()
+                .map(|v| {
+                    (
+                        v,
+                        output.features,
+                        output.script,
+                        output.sender_offset_public_key,
+                        output.metadata_signature,
+                    )
+                })
+        })
+        .map(
+            |(output, features, script, sender_offset_public_key, metadata_signature)| {
+                UnblindedOutput::new(
+                    output.committed_value,
+                    output.blinding_factor.clone(),
+                    Some(features),
+                    script,
+                    inputs!(PublicKey::from_secret_key(&output.blinding_factor)),
+                    output.blinding_factor,
+                    sender_offset_public_key,
+                    metadata_signature,
+                )
+            },
+        )
+        .collect()
+}
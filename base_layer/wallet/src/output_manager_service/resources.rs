@@ -21,6 +21,7 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::{
         config::OutputManagerServiceConfig,
         handle::OutputManagerEventSender,
@@ -48,5 +49,6 @@ where TBackend: OutputManagerBackend + 'static
     pub master_key_manager: Arc<MasterKeyManager<TBackend>>,
     pub consensus_constants: ConsensusConstants,
     pub connectivity_manager: ConnectivityRequester,
+    pub wallet_connectivity: WalletConnectivityHandle,
     pub shutdown_signal: ShutdownSignal,
 }
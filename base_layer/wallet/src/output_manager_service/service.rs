@@ -22,6 +22,7 @@
 
 use crate::{
     base_node_service::handle::BaseNodeServiceHandle,
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::{
         config::OutputManagerServiceConfig,
         error::{OutputManagerError, OutputManagerProtocolError, OutputManagerStorageError},
@@ -29,8 +30,9 @@ use crate::{
         recovery::StandardUtxoRecoverer,
         resources::OutputManagerResources,
         storage::{
-            database::{OutputManagerBackend, OutputManagerDatabase, PendingTransactionOutputs},
-            models::{DbUnblindedOutput, KnownOneSidedPaymentScript},
+            database::{DbKey, OutputManagerBackend, OutputManagerDatabase, PendingTransactionOutputs},
+            models::{DbOutputSummary, DbUnblindedOutput, KnownOneSidedPaymentScript},
+            spendable_index::SpendableOutputSummary,
         },
         tasks::{TxoValidationTask, TxoValidationType},
         MasterKeyManager,
@@ -45,7 +47,6 @@ use futures::{pin_mut, StreamExt};
 use log::*;
 use rand::{rngs::OsRng, RngCore};
 use std::{
-    cmp::Ordering,
     collections::HashMap,
     fmt::{self, Display},
     sync::Arc,
@@ -69,7 +70,7 @@ use tari_core::{
             UnblindedOutput,
         },
         transaction_protocol::sender::TransactionSenderMessage,
-        types::{CryptoFactories, PrivateKey, PublicKey},
+        types::{Commitment, CryptoFactories, PrivateKey, PublicKey},
         CoinbaseBuilder,
         ReceiverTransactionProtocol,
         SenderTransactionProtocol,
@@ -82,6 +83,7 @@ use tari_crypto::{
     script::TariScript,
     tari_utilities::{hex::Hex, ByteArray},
 };
+use tari_metrics::Histogram;
 use tari_service_framework::reply_channel;
 use tari_shutdown::ShutdownSignal;
 use tokio::sync::broadcast;
@@ -89,6 +91,14 @@ use tokio::sync::broadcast;
 const LOG_TARGET: &str = "wallet::output_manager_service";
 const LOG_TARGET_STRESS: &str = "stress_test::output_manager_service";
 
+lazy_static! {
+    static ref SELECT_UTXOS_DURATION: Arc<Histogram> = tari_metrics::global().histogram(
+        "wallet_select_utxos_seconds",
+        "Time taken to select the outputs to spend in a transaction",
+        &[],
+    );
+}
+
 /// This service will manage a wallet's available outputs and the key manager that produces the keys for these outputs.
 /// The service will assemble transactions to be sent from the wallets available outputs and provide keys to receive
 /// outputs. When the outputs are detected on the blockchain the Transaction service will call this Service to confirm
@@ -121,6 +131,7 @@ where TBackend: OutputManagerBackend + 'static
         shutdown_signal: ShutdownSignal,
         base_node_service: BaseNodeServiceHandle,
         connectivity_manager: ConnectivityRequester,
+        wallet_connectivity: WalletConnectivityHandle,
         master_secret_key: CommsSecretKey,
     ) -> Result<OutputManagerService<TBackend>, OutputManagerError> {
         // Clear any encumberances for transactions that were being negotiated but did not complete to become official
@@ -139,6 +150,7 @@ where TBackend: OutputManagerBackend + 'static
             master_key_manager: Arc::new(master_key_manager),
             consensus_constants,
             connectivity_manager,
+            wallet_connectivity,
             shutdown_signal,
         };
 
@@ -237,6 +249,10 @@ where TBackend: OutputManagerBackend + 'static
                 .prepare_transaction_to_send(amount, fee_per_gram, lock_height, message, recipient_script)
                 .await
                 .map(OutputManagerResponse::TransactionToSend),
+            OutputManagerRequest::PrepareToSendTransactions((payments, fee_per_gram, lock_height)) => self
+                .prepare_transactions_to_send(payments, fee_per_gram, lock_height)
+                .await
+                .map(OutputManagerResponse::TransactionsToSend),
             OutputManagerRequest::CreatePayToSelfTransaction((amount, fee_per_gram, lock_height, message)) => self
                 .create_pay_to_self_transaction(amount, fee_per_gram, lock_height, message)
                 .await
@@ -274,6 +290,14 @@ where TBackend: OutputManagerBackend + 'static
                     .collect();
                 Ok(OutputManagerResponse::SpentOutputs(outputs))
             },
+            OutputManagerRequest::GetSpentOutputSummaries => self
+                .fetch_spent_output_summaries()
+                .await
+                .map(OutputManagerResponse::SpentOutputSummaries),
+            OutputManagerRequest::GetUnspentOutputSummaries => self
+                .fetch_unspent_output_summaries()
+                .await
+                .map(OutputManagerResponse::UnspentOutputSummaries),
             OutputManagerRequest::GetUnspentOutputs => {
                 let outputs = self
                     .fetch_unspent_outputs()
@@ -309,17 +333,17 @@ where TBackend: OutputManagerBackend + 'static
                 .create_coin_split(amount_per_split, split_count, fee_per_gram, lock_height)
                 .await
                 .map(OutputManagerResponse::Transaction),
-            OutputManagerRequest::ApplyEncryption(cipher) => self
+            OutputManagerRequest::ApplyEncryption((cipher, progress)) => self
                 .resources
                 .db
-                .apply_encryption(*cipher)
+                .apply_encryption(*cipher, progress)
                 .await
                 .map(|_| OutputManagerResponse::EncryptionApplied)
                 .map_err(OutputManagerError::OutputManagerStorageError),
-            OutputManagerRequest::RemoveEncryption => self
+            OutputManagerRequest::RemoveEncryption(progress) => self
                 .resources
                 .db
-                .remove_encryption()
+                .remove_encryption(progress)
                 .await
                 .map(|_| OutputManagerResponse::EncryptionRemoved)
                 .map_err(OutputManagerError::OutputManagerStorageError),
@@ -331,6 +355,7 @@ where TBackend: OutputManagerBackend + 'static
                 self.resources.master_key_manager.clone(),
                 self.resources.factories.clone(),
                 self.resources.db.clone(),
+                self.resources.config.rewind_workers,
             )
             .scan_and_recover_outputs(outputs)
             .await
@@ -343,6 +368,15 @@ where TBackend: OutputManagerBackend + 'static
                 .add_known_script(known_script)
                 .await
                 .map(|_| OutputManagerResponse::AddKnownOneSidedPaymentScript),
+            OutputManagerRequest::GetKnownOneSidedPaymentScripts => self
+                .resources
+                .db
+                .get_all_known_one_sided_payment_scripts()
+                .await
+                .map(|scripts| {
+                    OutputManagerResponse::KnownOneSidedPaymentScripts(scripts.into_iter().map(|s| s.script).collect())
+                })
+                .map_err(OutputManagerError::OutputManagerStorageError),
         }
     }
 
@@ -539,12 +573,14 @@ where TBackend: OutputManagerBackend + 'static
             num_outputs
         );
 
-        let (utxos, _, _) = self
-            .select_utxos(amount, fee_per_gram, num_outputs as usize, None)
+        // Only the number of inputs is needed, so the selected outputs are not loaded
+        let selection = self
+            .select_utxo_commitments(amount, fee_per_gram, num_outputs as usize, None)
             .await?;
-        debug!(target: LOG_TARGET, "{} utxos selected.", utxos.len());
+        let num_inputs = selection.commitments.len();
+        debug!(target: LOG_TARGET, "{} utxos selected.", num_inputs);
 
-        let fee = Fee::calculate_with_minimum(fee_per_gram, num_kernels as usize, utxos.len(), num_outputs as usize);
+        let fee = Fee::calculate_with_minimum(fee_per_gram, num_kernels as usize, num_inputs, num_outputs as usize);
 
         debug!(target: LOG_TARGET, "Fee calculated: {}", fee);
         Ok(fee)
@@ -652,6 +688,39 @@ where TBackend: OutputManagerBackend + 'static
         Ok(stp)
     }
 
+    /// Prepare a transaction for each payment. Inputs are selected separately for each transaction, which gets its own
+    /// change output, and are encumbered before the next one selects its inputs, so no output is spent twice. If a
+    /// transaction cannot be prepared, the outputs of the ones already prepared are released again.
+    async fn prepare_transactions_to_send(
+        &mut self,
+        payments: Vec<(MicroTari, String)>,
+        fee_per_gram: MicroTari,
+        lock_height: Option<u64>,
+    ) -> Result<Vec<SenderTransactionProtocol>, OutputManagerError> {
+        debug!(
+            target: LOG_TARGET,
+            "Preparing {} transactions to send. Fee per gram: {}. ",
+            payments.len(),
+            fee_per_gram,
+        );
+        let mut stps = Vec::with_capacity(payments.len());
+        for (amount, message) in payments {
+            match self
+                .prepare_transaction_to_send(amount, fee_per_gram, lock_height, message, script!(Nop))
+                .await
+            {
+                Ok(stp) => stps.push(stp),
+                Err(e) => {
+                    for stp in &stps {
+                        self.cancel_transaction(stp.get_tx_id()?).await?;
+                    }
+                    return Err(e);
+                },
+            }
+        }
+        Ok(stps)
+    }
+
     /// Request a Coinbase transaction for a specific block height. All existing pending transactions with
     /// this blockheight will be cancelled.
     /// The key will be derived from the coinbase specific keychain using the blockheight as an index. The coinbase
@@ -905,6 +974,41 @@ where TBackend: OutputManagerBackend + 'static
         output_count: usize,
         strategy: Option<UTXOSelectionStrategy>,
     ) -> Result<(Vec<DbUnblindedOutput>, bool, MicroTari), OutputManagerError> {
+        // A stale index is dropped by the lookup, so the selection is made once more from a rebuilt index before the
+        // error is returned
+        let mut is_retry = false;
+        loop {
+            let selection = self
+                .select_utxo_commitments(amount, fee_per_gram, output_count, strategy)
+                .await?;
+            match self
+                .resources
+                .db
+                .fetch_unspent_outputs_by_commitment(selection.commitments)
+                .await
+            {
+                Ok(utxos) => return Ok((utxos, selection.require_change_output, selection.total_value)),
+                Err(OutputManagerStorageError::ValuesNotFound) if !is_retry => {
+                    warn!(
+                        target: LOG_TARGET,
+                        "Selected UTXOs no longer match the stored outputs, selecting again from a rebuilt index"
+                    );
+                    is_retry = true;
+                },
+                Err(e) => return Err(e.into()),
+            }
+        }
+    }
+
+    /// Select the UTXOs to spend from the index of unspent outputs, without loading or decrypting any of them
+    async fn select_utxo_commitments(
+        &mut self,
+        amount: MicroTari,
+        fee_per_gram: MicroTari,
+        output_count: usize,
+        strategy: Option<UTXOSelectionStrategy>,
+    ) -> Result<UtxoSelection, OutputManagerError> {
+        let _timer = SELECT_UTXOS_DURATION.start_timer();
         debug!(
             target: LOG_TARGET,
             "select_utxos amount: {}, fee_per_gram: {}, output_count: {}, strategy: {:?}",
@@ -913,13 +1017,6 @@ where TBackend: OutputManagerBackend + 'static
             output_count,
             strategy
         );
-        let mut utxos = Vec::new();
-        let mut utxos_total_value = MicroTari::from(0);
-        let mut fee_without_change = MicroTari::from(0);
-        let mut fee_with_change = MicroTari::from(0);
-
-        let uo = self.resources.db.fetch_sorted_unspent_outputs().await?;
-
         // Attempt to get the chain tip height
         let chain_metadata = self.base_node_service.get_chain_metadata().await?;
         let (connected, tip_height) = match &chain_metadata {
@@ -934,95 +1031,82 @@ where TBackend: OutputManagerBackend + 'static
             (None, true) => None, // use the selection heuristic next
         };
 
-        // If we know the chain height then filter out unspendable UTXOs
-        let num_utxos = uo.len();
-        let uo = if connected {
-            let mature_utxos = uo
-                .into_iter()
-                .filter(|u| u.unblinded_output.features.maturity <= tip_height)
-                .collect::<Vec<DbUnblindedOutput>>();
+        // The selection is made on the index of the unspent outputs so that only the selected outputs need to be
+        // loaded and decrypted
+        let selection = self
+            .resources
+            .db
+            .with_spendable_output_index(|index| {
+                // If we know the chain height then filter out unspendable UTXOs
+                let is_mature = |o: &&SpendableOutputSummary| !connected || o.maturity <= tip_height;
+                let num_mature = index.iter_by_value().filter(is_mature).count();
+                if connected {
+                    trace!(
+                        target: LOG_TARGET,
+                        "Some UTXOs have not matured yet at height {}, filtered {} UTXOs",
+                        tip_height,
+                        index.len() - num_mature
+                    );
+                }
 
-            trace!(
-                target: LOG_TARGET,
-                "Some UTXOs have not matured yet at height {}, filtered {} UTXOs",
-                tip_height,
-                num_utxos - mature_utxos.len()
-            );
+                // Heuristic for selection strategy: Default to MaturityThenSmallest, but if the amount is greater than
+                // the largest UTXO, use Largest UTXOs first.
+                let strategy = match (strategy, index.iter_by_value().rev().find(is_mature)) {
+                    (Some(s), _) => s,
+                    (None, None) => UTXOSelectionStrategy::Smallest,
+                    (None, Some(largest_utxo)) => {
+                        if amount > largest_utxo.value {
+                            UTXOSelectionStrategy::Largest
+                        } else {
+                            UTXOSelectionStrategy::MaturityThenSmallest
+                        }
+                    },
+                };
+                debug!(target: LOG_TARGET, "select_utxos selection strategy: {}", strategy);
+                trace!(target: LOG_TARGET, "We found {} UTXOs to select from", num_mature);
 
-            mature_utxos
-        } else {
-            uo
-        };
+                let uo: Box<dyn Iterator<Item = &SpendableOutputSummary> + '_> = match strategy {
+                    UTXOSelectionStrategy::Smallest => Box::new(index.iter_by_value()),
+                    UTXOSelectionStrategy::MaturityThenSmallest => Box::new(index.iter_by_maturity_then_value()),
+                    UTXOSelectionStrategy::Largest => Box::new(index.iter_by_value().rev()),
+                };
 
-        // Heuristic for selection strategy: Default to MaturityThenSmallest, but if the amount is greater than
-        // the largest UTXO, use Largest UTXOs first.
-        let strategy = match (strategy, uo.is_empty()) {
-            (Some(s), _) => s,
-            (None, true) => UTXOSelectionStrategy::Smallest,
-            (None, false) => {
-                let largest_utxo = &uo[uo.len() - 1];
-                if amount > largest_utxo.unblinded_output.value {
-                    UTXOSelectionStrategy::Largest
-                } else {
-                    UTXOSelectionStrategy::MaturityThenSmallest
-                }
-            },
-        };
-        debug!(target: LOG_TARGET, "select_utxos selection strategy: {}", strategy);
-
-        let uo = match strategy {
-            UTXOSelectionStrategy::Smallest => uo,
-            UTXOSelectionStrategy::MaturityThenSmallest => {
-                let mut uo = uo;
-                uo.sort_by(|a, b| {
-                    match a
-                        .unblinded_output
-                        .features
-                        .maturity
-                        .cmp(&b.unblinded_output.features.maturity)
-                    {
-                        Ordering::Equal => a.unblinded_output.value.cmp(&b.unblinded_output.value),
-                        Ordering::Less => Ordering::Less,
-                        Ordering::Greater => Ordering::Greater,
+                let mut selection = UtxoSelection::default();
+                for o in uo.filter(is_mature) {
+                    selection.commitments.push(o.commitment.clone());
+                    selection.total_value += o.value;
+                    // The assumption here is that the only output will be the payment output and change if required
+                    selection.fee_without_change =
+                        Fee::calculate(fee_per_gram, 1, selection.commitments.len(), output_count);
+                    if selection.total_value == amount + selection.fee_without_change {
+                        break;
                     }
-                });
-                uo
-            },
-            UTXOSelectionStrategy::Largest => uo.into_iter().rev().collect(),
-        };
-        trace!(target: LOG_TARGET, "We found {} UTXOs to select from", uo.len());
-
-        let mut require_change_output = false;
-        for o in uo.iter() {
-            utxos.push(o.clone());
-            utxos_total_value += o.unblinded_output.value;
-            // The assumption here is that the only output will be the payment output and change if required
-            fee_without_change = Fee::calculate(fee_per_gram, 1, utxos.len(), output_count);
-            if utxos_total_value == amount + fee_without_change {
-                break;
-            }
-            fee_with_change = Fee::calculate(fee_per_gram, 1, utxos.len(), output_count + 1);
-            if utxos_total_value >= amount + fee_with_change {
-                require_change_output = true;
-                break;
-            }
-        }
+                    selection.fee_with_change =
+                        Fee::calculate(fee_per_gram, 1, selection.commitments.len(), output_count + 1);
+                    if selection.total_value >= amount + selection.fee_with_change {
+                        selection.require_change_output = true;
+                        break;
+                    }
+                }
+                selection
+            })
+            .await?;
 
-        let perfect_utxo_selection = utxos_total_value == amount + fee_without_change;
-        let enough_spendable = utxos_total_value > amount + fee_with_change;
+        let perfect_utxo_selection = selection.total_value == amount + selection.fee_without_change;
+        let enough_spendable = selection.total_value > amount + selection.fee_with_change;
 
         if !perfect_utxo_selection && !enough_spendable {
             let current_chain_tip = chain_metadata.map(|cm| cm.height_of_longest_chain());
             let balance = self.get_balance(current_chain_tip).await?;
             let pending_incoming = balance.pending_incoming_balance;
-            if utxos_total_value + pending_incoming >= amount + fee_with_change {
+            if selection.total_value + pending_incoming >= amount + selection.fee_with_change {
                 return Err(OutputManagerError::FundsPending);
             } else {
                 return Err(OutputManagerError::NotEnoughFunds);
             }
         }
 
-        Ok((utxos, require_change_output, utxos_total_value))
+        Ok(selection)
     }
 
     /// Set the base node public key to the list that will be used to check the status of UTXO's on the base chain. If
@@ -1063,6 +1147,18 @@ where TBackend: OutputManagerBackend + 'static
         Ok(self.resources.db.fetch_sorted_unspent_outputs().await?)
     }
 
+    /// The public parts of the spent outputs. No secret keys are decrypted.
+    pub async fn fetch_spent_output_summaries(&self) -> Result<Vec<DbOutputSummary>, OutputManagerError> {
+        Ok(self.resources.db.fetch_output_summaries(DbKey::SpentOutputs).await?)
+    }
+
+    /// The public parts of the unspent outputs, sorted from lowest value to highest. No secret keys are decrypted.
+    pub async fn fetch_unspent_output_summaries(&self) -> Result<Vec<DbOutputSummary>, OutputManagerError> {
+        let mut summaries = self.resources.db.fetch_output_summaries(DbKey::UnspentOutputs).await?;
+        summaries.sort_by_key(|o| o.value);
+        Ok(summaries)
+    }
+
     pub async fn fetch_invalid_outputs(&self) -> Result<Vec<DbUnblindedOutput>, OutputManagerError> {
         Ok(self.resources.db.get_invalid_outputs().await?)
     }
@@ -1273,7 +1369,7 @@ where TBackend: OutputManagerBackend + 'static
 
 /// Different UTXO selection strategies for choosing which UTXO's are used to fulfill a transaction
 /// TODO Investigate and implement more optimal strategies
-#[derive(Debug)]
+#[derive(Debug, Clone, Copy)]
 pub enum UTXOSelectionStrategy {
     // Start from the smallest UTXOs and work your way up until the amount is covered. Main benefit
     // is removing small UTXOs from the blockchain, con is that it costs more in fees
@@ -1294,6 +1390,16 @@ impl Display for UTXOSelectionStrategy {
     }
 }
 
+/// The outputs chosen from the spendable output index to fund a transaction
+#[derive(Debug, Default)]
+struct UtxoSelection {
+    commitments: Vec<Commitment>,
+    total_value: MicroTari,
+    fee_without_change: MicroTari,
+    fee_with_change: MicroTari,
+    require_change_output: bool,
+}
+
 /// This struct holds the detailed balance of the Output Manager Service.
 #[derive(Debug, Clone, PartialEq)]
 pub struct Balance {
@@ -20,11 +20,17 @@
 // WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-use crate::output_manager_service::{
-    error::OutputManagerStorageError,
-    service::Balance,
-    storage::models::{DbUnblindedOutput, KnownOneSidedPaymentScript},
-    TxId,
+use crate::{
+    output_manager_service::{
+        error::OutputManagerStorageError,
+        service::Balance,
+        storage::{
+            models::{DbOutputSummary, DbUnblindedOutput, KnownOneSidedPaymentScript},
+            spendable_index::{SpendableOutputIndex, SpendableOutputSummary},
+        },
+        TxId,
+    },
+    util::{encryption::EncryptionProgress, validation_checkpoint::ValidationCheckpoint},
 };
 use aes_gcm::Aes256Gcm;
 use chrono::{NaiveDateTime, Utc};
@@ -32,11 +38,10 @@ use log::*;
 use std::{
     collections::HashMap,
     fmt::{Display, Error, Formatter},
-    sync::Arc,
+    sync::{Arc, Mutex},
     time::Duration,
 };
 use tari_core::transactions::{
-    tari_amount::MicroTari,
     transaction::TransactionOutput,
     types::{BlindingFactor, Commitment, PrivateKey},
 };
@@ -85,7 +90,8 @@ pub trait OutputManagerBackend: Send + Sync + Clone {
     fn set_key_index(&self, index: u64) -> Result<(), OutputManagerStorageError>;
     /// If an unspent output is detected as invalid (i.e. not available on the blockchain) then it should be moved to
     /// the invalid outputs collection. The function will return the last recorded TxId associated with this output.
-    fn invalidate_unspent_output(&self, output: &DbUnblindedOutput) -> Result<Option<TxId>, OutputManagerStorageError>;
+    /// An output that is no longer unspent is left unchanged and `ValuesNotFound` is returned.
+    fn invalidate_unspent_output(&self, commitment: &Commitment) -> Result<Option<TxId>, OutputManagerStorageError>;
     /// This method will update an output's metadata signature, akin to 'finalize output'
     fn update_output_metadata_signature(&self, output: &TransactionOutput) -> Result<(), OutputManagerStorageError>;
     /// If an invalid output is found to be valid this function will turn it back into an unspent output
@@ -93,15 +99,51 @@ pub trait OutputManagerBackend: Send + Sync + Clone {
     /// Check to see if there exist any pending transaction with a blockheight equal that provided and cancel those
     /// pending transaction outputs.
     fn cancel_pending_transaction_at_block_height(&self, block_height: u64) -> Result<(), OutputManagerStorageError>;
-    /// Apply encryption to the backend.
-    fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), OutputManagerStorageError>;
-    /// Remove encryption from the backend.
-    fn remove_encryption(&self) -> Result<(), OutputManagerStorageError>;
+    /// Apply encryption to the backend. The rows are encrypted in batches and an interrupted pass is continued by
+    /// calling this again with the same cipher.
+    fn apply_encryption(
+        &self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), OutputManagerStorageError>;
+    /// Remove encryption from the backend. The rows are decrypted in batches and an interrupted pass is continued by
+    /// calling this again.
+    fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), OutputManagerStorageError>;
     /// Update a Spent output to be Unspent
     fn update_spent_output_to_unspent(
         &self,
         commitment: &Commitment,
     ) -> Result<DbUnblindedOutput, OutputManagerStorageError>;
+    /// Retrieve the commitment, value and maturity of every unspent output. The outputs are not decrypted.
+    fn fetch_spendable_output_summaries(&self) -> Result<Vec<SpendableOutputSummary>, OutputManagerStorageError>;
+    /// Retrieve the unspent outputs with the given commitments
+    fn fetch_unspent_outputs_by_commitment(
+        &self,
+        commitments: &[Commitment],
+    ) -> Result<Vec<DbUnblindedOutput>, OutputManagerStorageError>;
+    /// Retrieve the balance from the aggregate totals kept alongside the outputs. The time-locked balance is only
+    /// calculated if the current chain tip is provided.
+    fn get_balance(&self, current_chain_tip: Option<u64>) -> Result<Balance, OutputManagerStorageError>;
+    /// Retrieve the public parts of the outputs in the collection `key` refers to, one of `UnspentOutputs`,
+    /// `SpentOutputs` or `InvalidOutputs`. The secret keys of the outputs are not decrypted.
+    fn fetch_output_summaries(&self, key: &DbKey) -> Result<Vec<DbOutputSummary>, OutputManagerStorageError>;
+    /// Record the chain height at which the outputs with the given commitments were confirmed by a validation
+    fn set_outputs_validated_height(
+        &self,
+        commitments: &[Commitment],
+        height: u64,
+    ) -> Result<(), OutputManagerStorageError>;
+    /// Retrieve the chain tip that the named set of outputs was last validated against
+    fn fetch_validation_checkpoint(
+        &self,
+        name: &str,
+    ) -> Result<Option<ValidationCheckpoint>, OutputManagerStorageError>;
+    /// Record the chain tip that the named set of outputs has been validated against
+    fn set_validation_checkpoint(
+        &self,
+        name: &str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), OutputManagerStorageError>;
 }
 
 /// Holds the outputs that have been selected for a given pending transaction waiting for confirmation
@@ -185,13 +227,25 @@ pub struct OutputManagerDatabase<T>
 where T: OutputManagerBackend + 'static
 {
     db: Arc<T>,
+    spendable_index: Arc<Mutex<SpendableIndexCache>>,
+}
+
+/// The cached index of the unspent outputs. The generation is advanced by every change to the unspent outputs so that
+/// an index loaded from the backend while the outputs changed is not kept.
+#[derive(Default)]
+struct SpendableIndexCache {
+    index: Option<SpendableOutputIndex>,
+    generation: u64,
 }
 
 impl<T> OutputManagerDatabase<T>
 where T: OutputManagerBackend + 'static
 {
     pub fn new(db: T) -> Self {
-        Self { db: Arc::new(db) }
+        Self {
+            db: Arc::new(db),
+            spendable_index: Arc::new(Mutex::new(SpendableIndexCache::default())),
+        }
     }
 
     pub async fn get_key_manager_state(&self) -> Result<Option<KeyManagerState>, OutputManagerStorageError> {
@@ -235,6 +289,7 @@ where T: OutputManagerBackend + 'static
     }
 
     pub async fn add_unspent_output(&self, output: DbUnblindedOutput) -> Result<(), OutputManagerStorageError> {
+        let summary = SpendableOutputSummary::from(&output);
         let db_clone = self.db.clone();
         tokio::task::spawn_blocking(move || {
             db_clone.write(WriteOperation::Insert(DbKeyValuePair::UnspentOutput(
@@ -244,6 +299,7 @@ where T: OutputManagerBackend + 'static
         })
         .await
         .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        self.update_spendable_index(|index| index.insert(summary));
 
         Ok(())
     }
@@ -253,6 +309,7 @@ where T: OutputManagerBackend + 'static
         tx_id: TxId,
         output: DbUnblindedOutput,
     ) -> Result<(), OutputManagerStorageError> {
+        let summary = SpendableOutputSummary::from(&output);
         let db_clone = self.db.clone();
         tokio::task::spawn_blocking(move || {
             db_clone.write(WriteOperation::Insert(DbKeyValuePair::UnspentOutputWithTxId(
@@ -262,86 +319,17 @@ where T: OutputManagerBackend + 'static
         })
         .await
         .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        self.update_spendable_index(|index| index.insert(summary));
 
         Ok(())
     }
 
     pub async fn get_balance(&self, current_chain_tip: Option<u64>) -> Result<Balance, OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        let db_clone2 = self.db.clone();
-        let db_clone3 = self.db.clone();
-
-        let pending_txs = tokio::task::spawn_blocking(move || {
-            db_clone.fetch(&DbKey::AllPendingTransactionOutputs)?.ok_or_else(|| {
-                OutputManagerStorageError::UnexpectedResult(
-                    "Pending Transaction Outputs cannot be retrieved".to_string(),
-                )
-            })
-        })
-        .await
-        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
-
-        let unspent_outputs = tokio::task::spawn_blocking(move || {
-            db_clone2.fetch(&DbKey::UnspentOutputs)?.ok_or_else(|| {
-                OutputManagerStorageError::UnexpectedResult("Unspent Outputs cannot be retrieved".to_string())
-            })
-        })
-        .await
-        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
-
-        if let DbValue::UnspentOutputs(uo) = unspent_outputs {
-            if let DbValue::AllPendingTransactionOutputs(pto) = pending_txs {
-                let available_balance = uo
-                    .iter()
-                    .fold(MicroTari::from(0), |acc, x| acc + x.unblinded_output.value);
-                let time_locked_balance = if let Some(tip) = current_chain_tip {
-                    let time_locked_outputs = tokio::task::spawn_blocking(move || {
-                        db_clone3.fetch(&DbKey::TimeLockedUnspentOutputs(tip))?.ok_or_else(|| {
-                            OutputManagerStorageError::UnexpectedResult(
-                                "Time-locked Outputs cannot be retrieved".to_string(),
-                            )
-                        })
-                    })
-                    .await
-                    .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
-                    if let DbValue::UnspentOutputs(time_locked_uo) = time_locked_outputs {
-                        Some(
-                            time_locked_uo
-                                .iter()
-                                .fold(MicroTari::from(0), |acc, x| acc + x.unblinded_output.value),
-                        )
-                    } else {
-                        None
-                    }
-                } else {
-                    None
-                };
-                let mut pending_incoming = MicroTari::from(0);
-                let mut pending_outgoing = MicroTari::from(0);
-
-                for v in pto.values() {
-                    pending_incoming += v
-                        .outputs_to_be_received
-                        .iter()
-                        .fold(MicroTari::from(0), |acc, x| acc + x.unblinded_output.value);
-                    pending_outgoing += v
-                        .outputs_to_be_spent
-                        .iter()
-                        .fold(MicroTari::from(0), |acc, x| acc + x.unblinded_output.value);
-                }
-
-                return Ok(Balance {
-                    available_balance,
-                    time_locked_balance,
-                    pending_incoming_balance: pending_incoming,
-                    pending_outgoing_balance: pending_outgoing,
-                });
-            }
-        }
-
-        Err(OutputManagerStorageError::UnexpectedResult(
-            "Unexpected result from database backend".to_string(),
-        ))
+        tokio::task::spawn_blocking(move || db_clone.get_balance(current_chain_tip))
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
     }
 
     pub async fn add_pending_transaction_outputs(
@@ -349,14 +337,16 @@ where T: OutputManagerBackend + 'static
         pending_transaction_outputs: PendingTransactionOutputs,
     ) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || {
+        let result = tokio::task::spawn_blocking(move || {
             db_clone.write(WriteOperation::Insert(DbKeyValuePair::PendingTransactionOutputs(
                 pending_transaction_outputs.tx_id,
                 Box::new(pending_transaction_outputs),
             )))
         })
         .await
-        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()));
+        self.invalidate_spendable_index();
+        result??;
 
         Ok(())
     }
@@ -377,10 +367,12 @@ where T: OutputManagerBackend + 'static
     /// `spent_outputs` collections.
     pub async fn confirm_pending_transaction_outputs(&self, tx_id: TxId) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.confirm_transaction(tx_id))
+        let result = tokio::task::spawn_blocking(move || db_clone.confirm_transaction(tx_id))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     /// This method accepts and stores a pending inbound transaction and creates the `output_to_be_received` from the
@@ -418,13 +410,19 @@ where T: OutputManagerBackend + 'static
         outputs_to_send: Vec<DbUnblindedOutput>,
         outputs_to_receive: Vec<DbUnblindedOutput>,
     ) -> Result<(), OutputManagerStorageError> {
+        let spent_commitments = outputs_to_send.iter().map(|o| o.commitment.clone()).collect::<Vec<_>>();
         let db_clone = self.db.clone();
         tokio::task::spawn_blocking(move || {
             db_clone.short_term_encumber_outputs(tx_id, &outputs_to_send, &outputs_to_receive)
         })
         .await
-        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-        .and_then(|inner_result| inner_result)
+        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        self.update_spendable_index(|index| {
+            for commitment in spent_commitments.iter() {
+                index.remove(commitment);
+            }
+        });
+        Ok(())
     }
 
     /// This method is called when a transaction is finished being negotiated. This will fully encumber the outputs
@@ -441,30 +439,36 @@ where T: OutputManagerBackend + 'static
     /// transaction negotiation
     pub async fn clear_short_term_encumberances(&self) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.clear_short_term_encumberances())
+        let result = tokio::task::spawn_blocking(move || db_clone.clear_short_term_encumberances())
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     /// When a pending transaction is cancelled the encumbered outputs are moved back to the `unspent_outputs`
     /// collection.
     pub async fn cancel_pending_transaction_outputs(&self, tx_id: TxId) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.cancel_pending_transaction(tx_id))
+        let result = tokio::task::spawn_blocking(move || db_clone.cancel_pending_transaction(tx_id))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     /// This method is check all pending transactions to see if any are older that the provided duration. If they are
     /// they will be cancelled.
     pub async fn timeout_pending_transaction_outputs(&self, period: Duration) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.timeout_pending_transactions(period))
+        let result = tokio::task::spawn_blocking(move || db_clone.timeout_pending_transactions(period))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     /// Retrieves UTXOs sorted by value from smallest to largest.
@@ -593,15 +597,14 @@ where T: OutputManagerBackend + 'static
         Ok(uo)
     }
 
-    pub async fn invalidate_output(
-        &self,
-        output: DbUnblindedOutput,
-    ) -> Result<Option<TxId>, OutputManagerStorageError> {
+    pub async fn invalidate_output(&self, commitment: Commitment) -> Result<Option<TxId>, OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.invalidate_unspent_output(&output))
+        let result = tokio::task::spawn_blocking(move || db_clone.invalidate_unspent_output(&commitment))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     pub async fn update_output_metadata_signature(
@@ -617,10 +620,12 @@ where T: OutputManagerBackend + 'static
 
     pub async fn revalidate_output(&self, commitment: Commitment) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.revalidate_unspent_output(&commitment))
+        let result = tokio::task::spawn_blocking(move || db_clone.revalidate_unspent_output(&commitment))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     pub async fn update_spent_output_to_unspent(
@@ -628,10 +633,12 @@ where T: OutputManagerBackend + 'static
         commitment: Commitment,
     ) -> Result<DbUnblindedOutput, OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.update_spent_output_to_unspent(&commitment))
+        let result = tokio::task::spawn_blocking(move || db_clone.update_spent_output_to_unspent(&commitment))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+            .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
     pub async fn cancel_pending_transaction_at_block_height(
@@ -639,23 +646,30 @@ where T: OutputManagerBackend + 'static
         block_height: u64,
     ) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.cancel_pending_transaction_at_block_height(block_height))
-            .await
-            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
-            .and_then(|inner_result| inner_result)
+        let result =
+            tokio::task::spawn_blocking(move || db_clone.cancel_pending_transaction_at_block_height(block_height))
+                .await
+                .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+                .and_then(|inner_result| inner_result);
+        self.invalidate_spendable_index();
+        result
     }
 
-    pub async fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), OutputManagerStorageError> {
+    pub async fn apply_encryption(
+        &self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.apply_encryption(cipher))
+        tokio::task::spawn_blocking(move || db_clone.apply_encryption(cipher, progress))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
             .and_then(|inner_result| inner_result)
     }
 
-    pub async fn remove_encryption(&self) -> Result<(), OutputManagerStorageError> {
+    pub async fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.remove_encryption())
+        tokio::task::spawn_blocking(move || db_clone.remove_encryption(progress))
             .await
             .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
             .and_then(|inner_result| inner_result)
@@ -698,7 +712,7 @@ where T: OutputManagerBackend + 'static
 
     pub async fn remove_output_by_commitment(&self, commitment: Commitment) -> Result<(), OutputManagerStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || {
+        let result = tokio::task::spawn_blocking(move || {
             match db_clone.write(WriteOperation::Remove(DbKey::AnyOutputByCommitment(commitment.clone()))) {
                 Ok(None) => log_error(
                     DbKey::AnyOutputByCommitment(commitment.clone()),
@@ -710,9 +724,128 @@ where T: OutputManagerBackend + 'static
             }
         })
         .await
-        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()));
+        self.invalidate_spendable_index();
+        result??;
         Ok(())
     }
+
+    /// Run `f` against the index of the unspent outputs. The index is loaded from the backend, without decrypting any
+    /// outputs, when it is not cached.
+    pub async fn with_spendable_output_index<F, R>(&self, f: F) -> Result<R, OutputManagerStorageError>
+    where F: FnOnce(&SpendableOutputIndex) -> R {
+        let generation = {
+            let cache = acquire_lock!(self.spendable_index);
+            if let Some(index) = cache.index.as_ref() {
+                return Ok(f(index));
+            }
+            cache.generation
+        };
+
+        let db_clone = self.db.clone();
+        let summaries = tokio::task::spawn_blocking(move || db_clone.fetch_spendable_output_summaries())
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        let index = SpendableOutputIndex::new(summaries);
+        let result = f(&index);
+
+        let mut cache = acquire_lock!(self.spendable_index);
+        if cache.generation == generation {
+            cache.index = Some(index);
+        }
+        Ok(result)
+    }
+
+    /// Retrieve the public parts of the unspent, spent or invalid outputs without decrypting them
+    pub async fn fetch_output_summaries(&self, key: DbKey) -> Result<Vec<DbOutputSummary>, OutputManagerStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_output_summaries(&key))
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn set_outputs_validated_height(
+        &self,
+        commitments: Vec<Commitment>,
+        height: u64,
+    ) -> Result<(), OutputManagerStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.set_outputs_validated_height(&commitments, height))
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn fetch_validation_checkpoint(
+        &self,
+        name: &'static str,
+    ) -> Result<Option<ValidationCheckpoint>, OutputManagerStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_validation_checkpoint(name))
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn set_validation_checkpoint(
+        &self,
+        name: &'static str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), OutputManagerStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.set_validation_checkpoint(name, checkpoint))
+            .await
+            .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    /// Retrieve the unspent outputs with the given commitments in the order of the commitments. If any of them is no
+    /// longer unspent the index they were selected from is stale, so it is dropped to be rebuilt on its next use and
+    /// `ValuesNotFound` is returned.
+    pub async fn fetch_unspent_outputs_by_commitment(
+        &self,
+        commitments: Vec<Commitment>,
+    ) -> Result<Vec<DbUnblindedOutput>, OutputManagerStorageError> {
+        let db_clone = self.db.clone();
+        let commitments_clone = commitments.clone();
+        let outputs =
+            tokio::task::spawn_blocking(move || db_clone.fetch_unspent_outputs_by_commitment(&commitments_clone))
+                .await
+                .map_err(|err| OutputManagerStorageError::BlockingTaskSpawnError(err.to_string()))??;
+
+        let mut outputs = outputs
+            .into_iter()
+            .map(|o| (o.commitment.clone(), o))
+            .collect::<HashMap<_, _>>();
+        let ordered = commitments
+            .iter()
+            .map(|c| outputs.remove(c))
+            .collect::<Option<Vec<_>>>();
+        match ordered {
+            Some(ordered) => Ok(ordered),
+            None => {
+                // The index no longer matches the backend
+                self.invalidate_spendable_index();
+                Err(OutputManagerStorageError::ValuesNotFound)
+            },
+        }
+    }
+
+    fn invalidate_spendable_index(&self) {
+        let mut cache = acquire_lock!(self.spendable_index);
+        cache.index = None;
+        cache.generation += 1;
+    }
+
+    fn update_spendable_index<F>(&self, f: F)
+    where F: FnOnce(&mut SpendableOutputIndex) {
+        let mut cache = acquire_lock!(self.spendable_index);
+        cache.generation += 1;
+        if let Some(index) = cache.index.as_mut() {
+            f(index);
+        }
+    }
 }
 
 fn unexpected_result<T>(req: DbKey, res: DbValue) -> Result<T, OutputManagerStorageError> {
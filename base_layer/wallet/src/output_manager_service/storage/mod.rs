@@ -22,4 +22,5 @@
 
 pub mod database;
 pub mod models;
+pub mod spendable_index;
 pub mod sqlite_db;
@@ -25,7 +25,8 @@ use std::cmp::Ordering;
 use tari_core::{
     tari_utilities::hash::Hashable,
     transactions::{
-        transaction::UnblindedOutput,
+        tari_amount::MicroTari,
+        transaction::{OutputFeatures, UnblindedOutput},
         transaction_protocol::RewindData,
         types::{Commitment, CryptoFactories, HashOutput, PrivateKey},
     },
@@ -92,6 +93,30 @@ impl Ord for DbUnblindedOutput {
 
 impl Eq for DbUnblindedOutput {}
 
+/// The public parts of a stored output. These are read without decrypting the secret keys of the output so listing
+/// and validating outputs costs the same whether or not the wallet is encrypted.
+#[derive(Debug, Clone, PartialEq)]
+pub struct DbOutputSummary {
+    pub commitment: Commitment,
+    pub hash: HashOutput,
+    pub value: MicroTari,
+    pub features: OutputFeatures,
+    /// The chain height at which the output was last confirmed by a validation
+    pub validated_height: Option<u64>,
+}
+
+impl From<&DbUnblindedOutput> for DbOutputSummary {
+    fn from(output: &DbUnblindedOutput) -> Self {
+        Self {
+            commitment: output.commitment.clone(),
+            hash: output.hash.clone(),
+            value: output.unblinded_output.value,
+            features: output.unblinded_output.features.clone(),
+            validated_height: None,
+        }
+    }
+}
+
 #[derive(Debug, Clone)]
 pub struct KnownOneSidedPaymentScript {
     pub script_hash: Vec<u8>,
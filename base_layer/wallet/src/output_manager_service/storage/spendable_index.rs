@@ -0,0 +1,151 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use crate::output_manager_service::storage::models::DbUnblindedOutput;
+use std::collections::{BTreeSet, HashMap};
+use tari_core::transactions::{tari_amount::MicroTari, types::Commitment};
+use tari_crypto::tari_utilities::ByteArray;
+
+/// The public details of an unspent output that coin selection needs. No secret material is held so these can be
+/// read from the database without decrypting the outputs.
+#[derive(Debug, Clone, PartialEq)]
+pub struct SpendableOutputSummary {
+    pub commitment: Commitment,
+    pub value: MicroTari,
+    pub maturity: u64,
+}
+
+impl From<&DbUnblindedOutput> for SpendableOutputSummary {
+    fn from(output: &DbUnblindedOutput) -> Self {
+        Self {
+            commitment: output.commitment.clone(),
+            value: output.unblinded_output.value,
+            maturity: output.unblinded_output.features.maturity,
+        }
+    }
+}
+
+/// An index of the unspent outputs of the wallet, ordered by value and by maturity then value, so that outputs can be
+/// selected without loading every unspent output from the database.
+#[derive(Debug, Clone, Default)]
+pub struct SpendableOutputIndex {
+    outputs: HashMap<Vec<u8>, SpendableOutputSummary>,
+    by_value: BTreeSet<(MicroTari, Vec<u8>)>,
+    by_maturity: BTreeSet<(u64, MicroTari, Vec<u8>)>,
+}
+
+impl SpendableOutputIndex {
+    pub fn new(summaries: Vec<SpendableOutputSummary>) -> Self {
+        let mut index = Self::default();
+        for summary in summaries {
+            index.insert(summary);
+        }
+        index
+    }
+
+    pub fn insert(&mut self, summary: SpendableOutputSummary) {
+        let key = summary.commitment.to_vec();
+        self.remove(&summary.commitment);
+        self.by_value.insert((summary.value, key.clone()));
+        self.by_maturity.insert((summary.maturity, summary.value, key.clone()));
+        self.outputs.insert(key, summary);
+    }
+
+    pub fn remove(&mut self, commitment: &Commitment) -> Option<SpendableOutputSummary> {
+        let key = commitment.to_vec();
+        let summary = self.outputs.remove(&key)?;
+        self.by_value.remove(&(summary.value, key.clone()));
+        self.by_maturity.remove(&(summary.maturity, summary.value, key));
+        Some(summary)
+    }
+
+    pub fn len(&self) -> usize {
+        self.outputs.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.outputs.is_empty()
+    }
+
+    /// The outputs from the smallest to the largest value
+    pub fn iter_by_value(&self) -> impl DoubleEndedIterator<Item = &SpendableOutputSummary> {
+        self.by_value.iter().map(move |(_, key)| &self.outputs[key])
+    }
+
+    /// The outputs from the lowest to the highest maturity, outputs with the same maturity from the smallest to the
+    /// largest value
+    pub fn iter_by_maturity_then_value(&self) -> impl Iterator<Item = &SpendableOutputSummary> {
+        self.by_maturity.iter().map(move |(_, _, key)| &self.outputs[key])
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::{SpendableOutputIndex, SpendableOutputSummary};
+    use rand::rngs::OsRng;
+    use tari_core::transactions::{
+        tari_amount::MicroTari,
+        types::{CryptoFactories, PrivateKey},
+    };
+    use tari_crypto::{commitment::HomomorphicCommitmentFactory, keys::SecretKey};
+
+    fn summary(value: u64, maturity: u64) -> SpendableOutputSummary {
+        let factories = CryptoFactories::default();
+        SpendableOutputSummary {
+            commitment: factories
+                .commitment
+                .commit_value(&PrivateKey::random(&mut OsRng), value),
+            value: MicroTari::from(value),
+            maturity,
+        }
+    }
+
+    #[test]
+    fn test_spendable_output_index_ordering() {
+        let outputs = vec![summary(300, 0), summary(100, 5), summary(200, 0), summary(50, 10)];
+        let mut index = SpendableOutputIndex::new(outputs.clone());
+        assert_eq!(index.len(), 4);
+
+        let values = index.iter_by_value().map(|o| o.value.0).collect::<Vec<_>>();
+        assert_eq!(values, vec![50, 100, 200, 300]);
+        let largest = index.iter_by_value().next_back().unwrap();
+        assert_eq!(largest, &outputs[0]);
+
+        let by_maturity = index
+            .iter_by_maturity_then_value()
+            .map(|o| (o.maturity, o.value.0))
+            .collect::<Vec<_>>();
+        assert_eq!(by_maturity, vec![(0, 200), (0, 300), (5, 100), (10, 50)]);
+
+        assert_eq!(index.remove(&outputs[1].commitment), Some(outputs[1].clone()));
+        assert_eq!(index.remove(&outputs[1].commitment), None);
+        let values = index.iter_by_value().map(|o| o.value.0).collect::<Vec<_>>();
+        assert_eq!(values, vec![50, 200, 300]);
+
+        // Inserting an output that is already indexed replaces it
+        index.insert(outputs[3].clone());
+        assert_eq!(index.len(), 3);
+        index.insert(outputs[1].clone());
+        assert_eq!(index.len(), 4);
+        assert!(!index.is_empty());
+    }
+}
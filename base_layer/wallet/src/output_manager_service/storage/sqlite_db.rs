@@ -23,6 +23,7 @@
 use crate::{
     output_manager_service::{
         error::OutputManagerStorageError,
+        service::Balance,
         storage::{
             database::{
                 DbKey,
@@ -33,13 +34,36 @@ use crate::{
                 PendingTransactionOutputs,
                 WriteOperation,
             },
-            models::{DbUnblindedOutput, KnownOneSidedPaymentScript},
+            models::{DbOutputSummary, DbUnblindedOutput, KnownOneSidedPaymentScript},
+            spendable_index::SpendableOutputSummary,
         },
         TxId,
     },
-    schema::{key_manager_states, known_one_sided_payment_scripts, outputs, pending_transaction_outputs},
-    storage::sqlite_utilities::WalletDbConnection,
-    util::encryption::{decrypt_bytes_integral_nonce, encrypt_bytes_integral_nonce, Encryptable},
+    schema::{
+        key_manager_states,
+        known_one_sided_payment_scripts,
+        output_balances,
+        outputs,
+        pending_transaction_outputs,
+    },
+    storage::sqlite_utilities::{
+        run_encryption_pass,
+        EncryptionProgressSql,
+        ValidationCheckpointSql,
+        WalletDbConnection,
+    },
+    util::{
+        encryption::{
+            decrypt_bytes_integral_nonce,
+            decrypt_bytes_integral_nonce_in_place,
+            encrypt_bytes_integral_nonce,
+            encrypt_bytes_integral_nonce_in_place,
+            Encryptable,
+            EncryptionProgress,
+            ENCRYPTION_BATCH_SIZE,
+        },
+        validation_checkpoint::ValidationCheckpoint,
+    },
 };
 use aes_gcm::{aead::Error as AeadError, Aes256Gcm, Error};
 use chrono::{Duration as ChronoDuration, NaiveDateTime, Utc};
@@ -70,6 +94,19 @@ use tari_crypto::{
 };
 
 const LOG_TARGET: &str = "wallet::output_manager_service::database::sqlite_db";
+/// Stay well below the SQLite limit on the number of variables in a query
+const MAX_COMMITMENTS_PER_QUERY: usize = 500;
+
+const OUTPUTS_TABLE: &str = "outputs";
+const KEY_MANAGER_STATES_TABLE: &str = "key_manager_states";
+const KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE: &str = "known_one_sided_payment_scripts";
+/// The tables with encrypted fields, in the order that encryption is applied to or removed from them. The key manager
+/// state comes first as it is read as soon as the Output Manager Service starts.
+pub(crate) const ENCRYPTED_TABLES: [&str; 3] = [
+    KEY_MANAGER_STATES_TABLE,
+    KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE,
+    OUTPUTS_TABLE,
+];
 
 /// A Sqlite backend for the Output Manager Service. The Backend is accessed via a connection pool to the Sqlite file.
 #[derive(Clone)]
@@ -86,6 +123,110 @@ impl OutputManagerSqliteDatabase {
         }
     }
 
+    /// Finish a pass that applied or removed encryption and was interrupted, so that every row can be read with the
+    /// cipher the backend holds afterwards. This must be called before anything is read from the backend.
+    pub fn complete_interrupted_encryption(&self) -> Result<(), OutputManagerStorageError> {
+        let mut current_cipher = acquire_write_lock!(self.cipher);
+        let cipher = match (*current_cipher).clone() {
+            Some(cipher) => cipher,
+            None => return Ok(()),
+        };
+        let conn = self.database_connection.acquire_lock();
+
+        if EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, true, &conn)? {
+            info!(target: LOG_TARGET, "Completing an interrupted pass applying encryption");
+            self.run_encryption_passes(&cipher, true, &EncryptionProgress::default(), &conn)?;
+        }
+        if EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, false, &conn)? {
+            info!(target: LOG_TARGET, "Completing an interrupted pass removing encryption");
+            self.run_encryption_passes(&cipher, false, &EncryptionProgress::default(), &conn)?;
+            let _ = (*current_cipher).take();
+        }
+
+        Ok(())
+    }
+
+    /// Encrypt or decrypt the remaining rows of every table that has an incomplete pass recorded
+    fn run_encryption_passes(
+        &self,
+        cipher: &Aes256Gcm,
+        encrypting: bool,
+        progress: &EncryptionProgress,
+        conn: &SqliteConnection,
+    ) -> Result<(), OutputManagerStorageError> {
+        let mut remaining = 0;
+        // The single batch tables are either still to be processed in full or are complete
+        let state_progress = EncryptionProgressSql::get(KEY_MANAGER_STATES_TABLE, conn)?;
+        if let Some(i64::MIN) = state_progress.map(|p| p.last_id) {
+            remaining += 1;
+        }
+        let scripts_progress = EncryptionProgressSql::get(KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE, conn)?;
+        if let Some(i64::MIN) = scripts_progress.map(|p| p.last_id) {
+            remaining += KnownOneSidedPaymentScriptSql::index(conn)?.len() as u64;
+        }
+        if let Some(p) = EncryptionProgressSql::get(OUTPUTS_TABLE, conn)? {
+            remaining += OutputSql::count_after_id(p.last_id, conn)? as u64;
+        }
+        progress.add_total(remaining);
+
+        let aead_error = |_| {
+            if encrypting {
+                OutputManagerStorageError::AeadError("Encryption Error".to_string())
+            } else {
+                OutputManagerStorageError::AeadError("Decryption Error".to_string())
+            }
+        };
+
+        // The key manager state and the known scripts are small enough to be encrypted in a single batch
+        run_encryption_pass(
+            conn,
+            KEY_MANAGER_STATES_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| match last_id {
+                i64::MIN => Ok(vec![(0, KeyManagerStateSql::get_state(conn)?)]),
+                _ => Ok(Vec::new()),
+            },
+            |state: &KeyManagerStateSql, conn| state.set_state(conn),
+            &aead_error,
+        )?;
+
+        run_encryption_pass(
+            conn,
+            KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| match last_id {
+                i64::MIN => Ok(KnownOneSidedPaymentScriptSql::index(conn)?
+                    .into_iter()
+                    .enumerate()
+                    .map(|(i, script)| (i as i64, script))
+                    .collect()),
+                _ => Ok(Vec::new()),
+            },
+            |script: &KnownOneSidedPaymentScriptSql, conn| script.update_encryption(conn),
+            &aead_error,
+        )?;
+
+        run_encryption_pass(
+            conn,
+            OUTPUTS_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| {
+                Ok(OutputSql::index_after_id(last_id, ENCRYPTION_BATCH_SIZE, conn)?
+                    .into_iter()
+                    .map(|o| (i64::from(o.id), o))
+                    .collect())
+            },
+            |o: &OutputSql, conn| o.update_encryption(conn),
+            &aead_error,
+        )
+    }
+
     fn decrypt_if_necessary<T: Encryptable<Aes256Gcm>>(&self, o: &mut T) -> Result<(), OutputManagerStorageError> {
         let cipher = acquire_read_lock!(self.cipher);
         if let Some(cipher) = cipher.as_ref() {
@@ -181,8 +322,8 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
 
                 Some(DbValue::UnspentOutputs(
                     outputs
-                        .iter()
-                        .map(|o| DbUnblindedOutput::try_from(o.clone()))
+                        .into_iter()
+                        .map(DbUnblindedOutput::try_from)
                         .collect::<Result<Vec<_>, _>>()?,
                 ))
             },
@@ -194,8 +335,8 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
 
                 Some(DbValue::SpentOutputs(
                     outputs
-                        .iter()
-                        .map(|o| DbUnblindedOutput::try_from(o.clone()))
+                        .into_iter()
+                        .map(DbUnblindedOutput::try_from)
                         .collect::<Result<Vec<_>, _>>()?,
                 ))
             },
@@ -207,8 +348,8 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
 
                 Some(DbValue::UnspentOutputs(
                     outputs
-                        .iter()
-                        .map(|o| DbUnblindedOutput::try_from(o.clone()))
+                        .into_iter()
+                        .map(DbUnblindedOutput::try_from)
                         .collect::<Result<Vec<_>, _>>()?,
                 ))
             },
@@ -250,8 +391,8 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
 
                 Some(DbValue::InvalidOutputs(
                     outputs
-                        .iter()
-                        .map(|o| DbUnblindedOutput::try_from(o.clone()))
+                        .into_iter()
+                        .map(DbUnblindedOutput::try_from)
                         .collect::<Result<Vec<_>, _>>()?,
                 ))
             },
@@ -619,9 +760,12 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
         Ok(())
     }
 
-    fn invalidate_unspent_output(&self, output: &DbUnblindedOutput) -> Result<Option<TxId>, OutputManagerStorageError> {
+    fn invalidate_unspent_output(&self, commitment: &Commitment) -> Result<Option<TxId>, OutputManagerStorageError> {
         let conn = self.database_connection.acquire_lock();
-        let output = OutputSql::find_by_commitment_and_cancelled(&output.commitment.to_vec(), false, &conn)?;
+        let output = OutputSql::find_by_commitment_and_cancelled(&commitment.to_vec(), false, &conn)?;
+        if OutputStatus::try_from(output.status)? != OutputStatus::Unspent {
+            return Err(OutputManagerStorageError::ValuesNotFound);
+        }
         let tx_id = output.tx_id.map(|id| id as u64);
         output.update(
             UpdateOutput {
@@ -716,68 +860,50 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
         Ok(())
     }
 
-    fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), OutputManagerStorageError> {
+    fn apply_encryption(
+        &self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), OutputManagerStorageError> {
         let mut current_cipher = acquire_write_lock!(self.cipher);
+        let conn = self.database_connection.acquire_lock();
 
-        if (*current_cipher).is_some() {
+        // An interrupted pass is continued with the cipher the wallet was opened with
+        let resuming = EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, true, &conn)?;
+        if (*current_cipher).is_some() && !resuming {
             return Err(OutputManagerStorageError::AlreadyEncrypted);
         }
 
-        let conn = self.database_connection.acquire_lock();
-        let mut outputs = OutputSql::index(&conn)?;
-
-        // If the db is already encrypted then the very first output we try to encrypt will fail.
-        for o in outputs.iter_mut() {
-            // Test if this output is encrypted or not to avoid a double encryption.
-            let _ = PrivateKey::from_vec(&o.spending_key).map_err(|_| {
+        if !resuming {
+            // Test if the data is encrypted or not to avoid a double encryption. If the db is already encrypted then
+            // the first output and the key manager state will not be readable.
+            let already_encrypted = |_| {
                 error!(
                     target: LOG_TARGET,
                     "Could not create PrivateKey from stored bytes, They might already be encrypted"
                 );
                 OutputManagerStorageError::AlreadyEncrypted
-            })?;
-            o.encrypt(&cipher)
-                .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-            o.update_encryption(&conn)?;
-        }
-
-        let mut key_manager_state = KeyManagerStateSql::get_state(&conn)?;
-
-        let _ = PrivateKey::from_vec(&key_manager_state.master_key).map_err(|_| {
-            error!(
-                target: LOG_TARGET,
-                "Could not create PrivateKey from stored bytes, They might already be encrypted"
-            );
-            OutputManagerStorageError::AlreadyEncrypted
-        })?;
-
-        key_manager_state
-            .encrypt(&cipher)
-            .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-        key_manager_state.set_state(&conn)?;
-
-        let mut known_one_sided_payment_scripts = KnownOneSidedPaymentScriptSql::index(&conn)?;
+            };
+            if let Some(o) = OutputSql::index_after_id(i64::MIN, 1, &conn)?.first() {
+                let _ = PrivateKey::from_vec(&o.spending_key).map_err(already_encrypted)?;
+            }
+            let key_manager_state = KeyManagerStateSql::get_state(&conn)?;
+            let _ = PrivateKey::from_vec(&key_manager_state.master_key).map_err(already_encrypted)?;
+            for script in KnownOneSidedPaymentScriptSql::index(&conn)? {
+                let _ = PrivateKey::from_vec(&script.private_key).map_err(already_encrypted)?;
+            }
 
-        for script in known_one_sided_payment_scripts.iter_mut() {
-            let _ = PrivateKey::from_vec(&script.private_key).map_err(|_| {
-                error!(
-                    target: LOG_TARGET,
-                    "Could not create PrivateKey from stored bytes, They might already be encrypted"
-                );
-                OutputManagerStorageError::AlreadyEncrypted
-            })?;
-            script
-                .encrypt(&cipher)
-                .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-            script.update_encryption(&conn)?;
+            EncryptionProgressSql::begin(&ENCRYPTED_TABLES, true, &conn)?;
         }
 
+        self.run_encryption_passes(&cipher, true, &progress, &conn)?;
+
         (*current_cipher) = Some(cipher);
 
         Ok(())
     }
 
-    fn remove_encryption(&self) -> Result<(), OutputManagerStorageError> {
+    fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), OutputManagerStorageError> {
         let mut current_cipher = acquire_write_lock!(self.cipher);
         let cipher = if let Some(cipher) = (*current_cipher).clone().take() {
             cipher
@@ -785,33 +911,140 @@ impl OutputManagerBackend for OutputManagerSqliteDatabase {
             return Ok(());
         };
         let conn = self.database_connection.acquire_lock();
-        let mut outputs = OutputSql::index(&conn)?;
 
-        for o in outputs.iter_mut() {
-            o.decrypt(&cipher)
-                .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-            o.update_encryption(&conn)?;
+        if !EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, false, &conn)? {
+            EncryptionProgressSql::begin(&ENCRYPTED_TABLES, false, &conn)?;
         }
 
-        let mut key_manager_state = KeyManagerStateSql::get_state(&conn)?;
-        key_manager_state
-            .decrypt(&cipher)
-            .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-        key_manager_state.set_state(&conn)?;
-
-        let mut known_one_sided_payment_scripts = KnownOneSidedPaymentScriptSql::index(&conn)?;
-
-        for script in known_one_sided_payment_scripts.iter_mut() {
-            script
-                .decrypt(&cipher)
-                .map_err(|_| OutputManagerStorageError::AeadError("Encryption Error".to_string()))?;
-            script.update_encryption(&conn)?;
-        }
+        self.run_encryption_passes(&cipher, false, &progress, &conn)?;
 
         // Now that all the decryption has been completed we can safely remove the cipher fully
         let _ = (*current_cipher).take();
         Ok(())
     }
+
+    fn fetch_spendable_output_summaries(&self) -> Result<Vec<SpendableOutputSummary>, OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        OutputSql::index_unspent_summaries(&conn)?
+            .into_iter()
+            .map(|(commitment, value, maturity)| {
+                Ok(SpendableOutputSummary {
+                    commitment: Commitment::from_vec(&commitment)
+                        .map_err(|_| OutputManagerStorageError::ConversionError)?,
+                    value: MicroTari::from(value as u64),
+                    maturity: maturity as u64,
+                })
+            })
+            .collect()
+    }
+
+    fn fetch_output_summaries(&self, key: &DbKey) -> Result<Vec<DbOutputSummary>, OutputManagerStorageError> {
+        let status = match key {
+            DbKey::UnspentOutputs => OutputStatus::Unspent,
+            DbKey::SpentOutputs => OutputStatus::Spent,
+            DbKey::InvalidOutputs => OutputStatus::Invalid,
+            _ => return Err(OutputManagerStorageError::OperationNotSupported),
+        };
+        let conn = self.database_connection.acquire_lock();
+        OutputSql::index_status_summaries(status, &conn)?
+            .into_iter()
+            .map(|o| match (o.commitment, o.hash) {
+                (Some(commitment), Some(hash)) => Ok(DbOutputSummary {
+                    commitment: Commitment::from_vec(&commitment)?,
+                    hash,
+                    value: MicroTari::from(o.value as u64),
+                    features: OutputFeatures {
+                        flags: OutputFlags::from_bits(o.flags as u8)
+                            .ok_or(OutputManagerStorageError::ConversionError)?,
+                        maturity: o.maturity as u64,
+                    },
+                    validated_height: o.validated_height.map(|h| h as u64),
+                }),
+                // Outputs stored before the commitment and hash were kept need the spending key to calculate them
+                _ => {
+                    let mut o = OutputSql::find_by_id(o.id, &conn)?;
+                    self.decrypt_if_necessary(&mut o)?;
+                    let validated_height = o.validated_height.map(|h| h as u64);
+                    Ok(DbOutputSummary {
+                        validated_height,
+                        ..DbOutputSummary::from(&DbUnblindedOutput::try_from(o)?)
+                    })
+                },
+            })
+            .collect()
+    }
+
+    fn set_outputs_validated_height(
+        &self,
+        commitments: &[Commitment],
+        height: u64,
+    ) -> Result<(), OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        conn.transaction::<_, OutputManagerStorageError, _>(|| {
+            for chunk in commitments.chunks(MAX_COMMITMENTS_PER_QUERY) {
+                let commitments = chunk.iter().map(|c| c.to_vec()).collect::<Vec<_>>();
+                OutputSql::update_validated_height(&commitments, height, &conn)?;
+            }
+            Ok(())
+        })
+    }
+
+    fn fetch_validation_checkpoint(
+        &self,
+        name: &str,
+    ) -> Result<Option<ValidationCheckpoint>, OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        Ok(ValidationCheckpointSql::get(name, &conn)?)
+    }
+
+    fn set_validation_checkpoint(
+        &self,
+        name: &str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        ValidationCheckpointSql::set(name, checkpoint, &conn)?;
+        Ok(())
+    }
+
+    fn fetch_unspent_outputs_by_commitment(
+        &self,
+        commitments: &[Commitment],
+    ) -> Result<Vec<DbUnblindedOutput>, OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        let mut result = Vec::with_capacity(commitments.len());
+        for chunk in commitments.chunks(MAX_COMMITMENTS_PER_QUERY) {
+            let commitments = chunk.iter().map(|c| c.to_vec()).collect::<Vec<_>>();
+            for mut o in OutputSql::find_unspent_by_commitments(&commitments, &conn)? {
+                self.decrypt_if_necessary(&mut o)?;
+                result.push(DbUnblindedOutput::try_from(o)?);
+            }
+        }
+        Ok(result)
+    }
+
+    fn get_balance(&self, current_chain_tip: Option<u64>) -> Result<Balance, OutputManagerStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        let totals = output_balances::table.load::<(i32, i64)>(&(*conn))?;
+        let total = |status: OutputStatus| {
+            totals
+                .iter()
+                .find(|(s, _)| *s == status as i32)
+                .map(|(_, total)| MicroTari::from(*total as u64))
+                .unwrap_or_default()
+        };
+        let time_locked_balance = match current_chain_tip {
+            Some(tip) => Some(OutputSql::sum_time_locked(tip, &(*conn))?),
+            None => None,
+        };
+
+        Ok(Balance {
+            available_balance: total(OutputStatus::Unspent),
+            time_locked_balance,
+            pending_incoming_balance: total(OutputStatus::EncumberedToBeReceived),
+            pending_outgoing_balance: total(OutputStatus::EncumberedToBeSpent),
+        })
+    }
 }
 
 /// A utility function to construct a PendingTransactionOutputs structure for a TxId, set of Outputs and a Timestamp
@@ -840,6 +1073,18 @@ fn pending_transaction_outputs_from_sql_outputs(
     })
 }
 
+/// The columns of an output that can be read without decrypting it
+#[derive(Queryable)]
+struct OutputSummarySql {
+    id: i32,
+    commitment: Option<Vec<u8>>,
+    hash: Option<Vec<u8>>,
+    value: i64,
+    flags: i32,
+    maturity: i64,
+    validated_height: Option<i64>,
+}
+
 /// The status of a given output
 #[derive(PartialEq)]
 enum OutputStatus {
@@ -923,14 +1168,14 @@ impl NewOutputSql {
 
 impl Encryptable<Aes256Gcm> for NewOutputSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.spending_key = encrypt_bytes_integral_nonce(&cipher, self.spending_key.clone())?;
-        self.script_private_key = encrypt_bytes_integral_nonce(&cipher, self.script_private_key.clone())?;
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut self.spending_key)?;
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut self.script_private_key)?;
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.spending_key = decrypt_bytes_integral_nonce(&cipher, self.spending_key.clone())?;
-        self.script_private_key = decrypt_bytes_integral_nonce(&cipher, self.script_private_key.clone())?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut self.spending_key)?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut self.script_private_key)?;
         Ok(())
     }
 }
@@ -954,14 +1199,37 @@ struct OutputSql {
     metadata_signature_nonce: Vec<u8>,
     metadata_signature_u_key: Vec<u8>,
     metadata_signature_v_key: Vec<u8>,
+    validated_height: Option<i64>,
 }
 
 impl OutputSql {
     /// Return all outputs
+    #[cfg(test)]
     pub fn index(conn: &SqliteConnection) -> Result<Vec<OutputSql>, OutputManagerStorageError> {
         Ok(outputs::table.load::<OutputSql>(conn)?)
     }
 
+    /// Return up to `limit` outputs with ids greater than `id`, in ascending order of id
+    pub fn index_after_id(
+        id: i64,
+        limit: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<OutputSql>, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::id.gt(id.max(i64::from(i32::MIN)) as i32))
+            .order(outputs::id.asc())
+            .limit(limit)
+            .load(conn)?)
+    }
+
+    /// Return the number of outputs with ids greater than `id`
+    pub fn count_after_id(id: i64, conn: &SqliteConnection) -> Result<i64, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::id.gt(id.max(i64::from(i32::MIN)) as i32))
+            .count()
+            .get_result(conn)?)
+    }
+
     /// Return all outputs with a given status
     pub fn index_status(
         status: OutputStatus,
@@ -978,6 +1246,77 @@ impl OutputSql {
             .load(conn)?)
     }
 
+    /// Return the total value of the unspent outputs that are time-locked at the given tip
+    pub fn sum_time_locked(tip: u64, conn: &SqliteConnection) -> Result<MicroTari, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::status.eq(OutputStatus::Unspent as i32))
+            .filter(outputs::maturity.gt(tip as i64))
+            .select(outputs::value)
+            .load::<i64>(conn)?
+            .into_iter()
+            .fold(MicroTari::from(0), |acc, v| acc + MicroTari::from(v as u64)))
+    }
+
+    /// Return the commitment, value and maturity of all unspent outputs. Outputs stored without a commitment by old
+    /// versions of the wallet are left out.
+    pub fn index_unspent_summaries(
+        conn: &SqliteConnection,
+    ) -> Result<Vec<(Vec<u8>, i64, i64)>, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::status.eq(OutputStatus::Unspent as i32))
+            .select((outputs::commitment, outputs::value, outputs::maturity))
+            .load::<(Option<Vec<u8>>, i64, i64)>(conn)?
+            .into_iter()
+            .filter_map(|(commitment, value, maturity)| commitment.map(|c| (c, value, maturity)))
+            .collect())
+    }
+
+    /// Return the public columns of all outputs with a given status, without the secret keys
+    pub fn index_status_summaries(
+        status: OutputStatus,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<OutputSummarySql>, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::status.eq(status as i32))
+            .select((
+                outputs::id,
+                outputs::commitment,
+                outputs::hash,
+                outputs::value,
+                outputs::flags,
+                outputs::maturity,
+                outputs::validated_height,
+            ))
+            .load(conn)?)
+    }
+
+    /// Set the validated height of the outputs with the given commitments
+    pub fn update_validated_height(
+        commitments: &[Vec<u8>],
+        height: u64,
+        conn: &SqliteConnection,
+    ) -> Result<(), OutputManagerStorageError> {
+        diesel::update(outputs::table.filter(outputs::commitment.eq_any(commitments)))
+            .set(outputs::validated_height.eq(height as i64))
+            .execute(conn)?;
+        Ok(())
+    }
+
+    pub fn find_by_id(id: i32, conn: &SqliteConnection) -> Result<OutputSql, OutputManagerStorageError> {
+        Ok(outputs::table.filter(outputs::id.eq(id)).first::<OutputSql>(conn)?)
+    }
+
+    /// Return the unspent outputs with the given commitments
+    pub fn find_unspent_by_commitments(
+        commitments: &[Vec<u8>],
+        conn: &SqliteConnection,
+    ) -> Result<Vec<OutputSql>, OutputManagerStorageError> {
+        Ok(outputs::table
+            .filter(outputs::status.eq(OutputStatus::Unspent as i32))
+            .filter(outputs::commitment.eq_any(commitments))
+            .load(conn)?)
+    }
+
     /// Find a particular Output, if it exists
     pub fn find(spending_key: &[u8], conn: &SqliteConnection) -> Result<OutputSql, OutputManagerStorageError> {
         Ok(outputs::table
@@ -1189,14 +1528,14 @@ impl TryFrom<OutputSql> for DbUnblindedOutput {
 
 impl Encryptable<Aes256Gcm> for OutputSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.spending_key = encrypt_bytes_integral_nonce(&cipher, self.spending_key.clone())?;
-        self.script_private_key = encrypt_bytes_integral_nonce(&cipher, self.script_private_key.clone())?;
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut self.spending_key)?;
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut self.script_private_key)?;
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.spending_key = decrypt_bytes_integral_nonce(&cipher, self.spending_key.clone())?;
-        self.script_private_key = decrypt_bytes_integral_nonce(&cipher, self.script_private_key.clone())?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut self.spending_key)?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut self.script_private_key)?;
         Ok(())
     }
 }
@@ -1672,12 +2011,12 @@ impl From<KnownOneSidedPaymentScript> for KnownOneSidedPaymentScriptSql {
 
 impl Encryptable<Aes256Gcm> for KnownOneSidedPaymentScriptSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.private_key = encrypt_bytes_integral_nonce(&cipher, self.private_key.clone())?;
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut self.private_key)?;
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        self.private_key = decrypt_bytes_integral_nonce(&cipher, self.private_key.clone())?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut self.private_key)?;
         Ok(())
     }
 }
@@ -1686,7 +2025,7 @@ impl Encryptable<Aes256Gcm> for KnownOneSidedPaymentScriptSql {
 mod test {
     use crate::{
         output_manager_service::storage::{
-            database::{DbKey, KeyManagerState, OutputManagerBackend},
+            database::{DbKey, DbValue, KeyManagerState, OutputManagerBackend},
             models::DbUnblindedOutput,
             sqlite_db::{
                 KeyManagerStateSql,
@@ -1696,10 +2035,14 @@ mod test {
                 OutputStatus,
                 PendingTransactionOutputSql,
                 UpdateOutput,
+                ENCRYPTED_TABLES,
+                KEY_MANAGER_STATES_TABLE,
+                KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE,
+                OUTPUTS_TABLE,
             },
         },
-        storage::sqlite_utilities::WalletDbConnection,
-        util::encryption::Encryptable,
+        storage::sqlite_utilities::{EncryptionProgressSql, WalletDbConnection},
+        util::encryption::{Encryptable, EncryptionProgress},
     };
     use aes_gcm::{
         aead::{generic_array::GenericArray, NewAead},
@@ -2062,17 +2405,159 @@ mod test {
         let connection = WalletDbConnection::new(conn, None);
 
         let db1 = OutputManagerSqliteDatabase::new(connection.clone(), Some(cipher.clone()));
-        assert!(db1.apply_encryption(cipher.clone()).is_err());
+        assert!(db1
+            .apply_encryption(cipher.clone(), EncryptionProgress::default())
+            .is_err());
 
         let db2 = OutputManagerSqliteDatabase::new(connection.clone(), None);
-        assert!(db2.remove_encryption().is_ok());
-        db2.apply_encryption(cipher).unwrap();
+        assert!(db2.remove_encryption(EncryptionProgress::default()).is_ok());
+        let progress = EncryptionProgress::default();
+        db2.apply_encryption(cipher, progress.clone()).unwrap();
+        // Two outputs and the key manager state
+        assert_eq!(progress.processed(), 3);
+        assert_eq!(progress.total(), 3);
 
         let db3 = OutputManagerSqliteDatabase::new(connection, None);
         assert!(db3.fetch(&DbKey::UnspentOutputs).is_err());
+        // The public parts of the outputs can be read without the cipher
+        let summaries = db3.fetch_output_summaries(&DbKey::UnspentOutputs).unwrap();
+        assert_eq!(summaries.len(), 2);
+        assert!(db3.fetch_output_summaries(&DbKey::SpentOutputs).unwrap().is_empty());
+        assert!(db3.fetch_output_summaries(&DbKey::KeyManagerState).is_err());
 
-        db2.remove_encryption().unwrap();
+        db2.remove_encryption(EncryptionProgress::default()).unwrap();
 
         assert!(db3.fetch(&DbKey::UnspentOutputs).is_ok());
     }
+
+    fn create_key_manager_state_and_outputs(conn: &SqliteConnection, num_outputs: usize) -> KeyManagerState {
+        let factories = CryptoFactories::default();
+        let state = KeyManagerState {
+            master_key: PrivateKey::random(&mut OsRng),
+            branch_seed: "boop boop".to_string(),
+            primary_key_index: 1,
+        };
+        KeyManagerStateSql::from(state.clone()).set_state(conn).unwrap();
+
+        for _ in 0..num_outputs {
+            let (_, uo) = make_input(MicroTari::from(100 + OsRng.next_u64() % 1000));
+            let uo = DbUnblindedOutput::from_unblinded_output(uo, &factories).unwrap();
+            NewOutputSql::new(uo, OutputStatus::Unspent, None)
+                .unwrap()
+                .commit(conn)
+                .unwrap();
+        }
+        state
+    }
+
+    fn apply_cipher_to_first_output(conn: &SqliteConnection, cipher: &Aes256Gcm, encrypting: bool) {
+        let mut first = OutputSql::index_after_id(i64::MIN, 1, conn).unwrap().remove(0);
+        if encrypting {
+            first.encrypt(cipher).unwrap();
+        } else {
+            first.decrypt(cipher).unwrap();
+        }
+        first.update_encryption(conn).unwrap();
+        EncryptionProgressSql::new(OUTPUTS_TABLE, encrypting, i64::from(first.id))
+            .set(conn)
+            .unwrap();
+    }
+
+    #[test]
+    fn test_resume_interrupted_encryption() {
+        let db_name = format!("{}.sqlite3", random::string(8).as_str());
+        let temp_dir = tempdir().unwrap();
+        let db_folder = temp_dir.path().to_str().unwrap().to_string();
+        let db_path = format!("{}{}", db_folder, db_name);
+
+        embed_migrations!("./migrations");
+        let conn = SqliteConnection::establish(&db_path).unwrap_or_else(|_| panic!("Error connecting to {}", db_path));
+
+        embedded_migrations::run_with_output(&conn, &mut std::io::stdout()).expect("Migration failed");
+        let state = create_key_manager_state_and_outputs(&conn, 3);
+
+        let key = GenericArray::from_slice(b"an example very very secret key.");
+        let cipher = Aes256Gcm::new(key);
+
+        // Simulate a pass that was interrupted after the key manager state and the batch holding the first output were
+        // committed
+        EncryptionProgressSql::begin(&ENCRYPTED_TABLES, true, &conn).unwrap();
+        let mut state_sql = KeyManagerStateSql::get_state(&conn).unwrap();
+        state_sql.encrypt(&cipher).unwrap();
+        state_sql.set_state(&conn).unwrap();
+        EncryptionProgressSql::clear(KEY_MANAGER_STATES_TABLE, &conn).unwrap();
+        EncryptionProgressSql::clear(KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE, &conn).unwrap();
+        apply_cipher_to_first_output(&conn, &cipher, true);
+
+        // The wallet is opened with the passphrase again and the pass is completed before anything is read
+        let connection = WalletDbConnection::new(conn, None);
+        let db = OutputManagerSqliteDatabase::new(connection.clone(), Some(cipher.clone()));
+        db.complete_interrupted_encryption().unwrap();
+
+        match db.fetch(&DbKey::KeyManagerState).unwrap().unwrap() {
+            DbValue::KeyManagerState(s) => assert_eq!(s, state),
+            _ => panic!("Unexpected value"),
+        }
+        match db.fetch(&DbKey::UnspentOutputs).unwrap().unwrap() {
+            DbValue::UnspentOutputs(outputs) => assert_eq!(outputs.len(), 3),
+            _ => panic!("Unexpected value"),
+        }
+        let conn = connection.acquire_lock();
+        assert!(!EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, true, &conn).unwrap());
+        drop(conn);
+
+        // Once the pass is complete applying encryption again is an error
+        assert!(db.apply_encryption(cipher, EncryptionProgress::default()).is_err());
+    }
+
+    #[test]
+    fn test_resume_interrupted_encryption_removal() {
+        let db_name = format!("{}.sqlite3", random::string(8).as_str());
+        let temp_dir = tempdir().unwrap();
+        let db_folder = temp_dir.path().to_str().unwrap().to_string();
+        let db_path = format!("{}{}", db_folder, db_name);
+
+        embed_migrations!("./migrations");
+        let conn = SqliteConnection::establish(&db_path).unwrap_or_else(|_| panic!("Error connecting to {}", db_path));
+
+        embedded_migrations::run_with_output(&conn, &mut std::io::stdout()).expect("Migration failed");
+        let state = create_key_manager_state_and_outputs(&conn, 3);
+
+        let key = GenericArray::from_slice(b"an example very very secret key.");
+        let cipher = Aes256Gcm::new(key);
+
+        let connection = WalletDbConnection::new(conn, None);
+        let db = OutputManagerSqliteDatabase::new(connection.clone(), None);
+        db.apply_encryption(cipher.clone(), EncryptionProgress::default())
+            .unwrap();
+        drop(db);
+
+        // Simulate a removal that was interrupted after the key manager state and the batch holding the first output
+        // were committed
+        let conn = connection.acquire_lock();
+        EncryptionProgressSql::begin(&ENCRYPTED_TABLES, false, &conn).unwrap();
+        let mut state_sql = KeyManagerStateSql::get_state(&conn).unwrap();
+        state_sql.decrypt(&cipher).unwrap();
+        state_sql.set_state(&conn).unwrap();
+        EncryptionProgressSql::clear(KEY_MANAGER_STATES_TABLE, &conn).unwrap();
+        EncryptionProgressSql::clear(KNOWN_ONE_SIDED_PAYMENT_SCRIPTS_TABLE, &conn).unwrap();
+        apply_cipher_to_first_output(&conn, &cipher, false);
+        drop(conn);
+
+        // The wallet is opened with the passphrase again and the removal is completed before anything is read
+        let db = OutputManagerSqliteDatabase::new(connection.clone(), Some(cipher));
+        db.complete_interrupted_encryption().unwrap();
+
+        match db.fetch(&DbKey::KeyManagerState).unwrap().unwrap() {
+            DbValue::KeyManagerState(s) => assert_eq!(s, state),
+            _ => panic!("Unexpected value"),
+        }
+        let db = OutputManagerSqliteDatabase::new(connection.clone(), None);
+        match db.fetch(&DbKey::UnspentOutputs).unwrap().unwrap() {
+            DbValue::UnspentOutputs(outputs) => assert_eq!(outputs.len(), 3),
+            _ => panic!("Unexpected value"),
+        }
+        let conn = connection.acquire_lock();
+        assert!(!EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, false, &conn).unwrap());
+    }
 }
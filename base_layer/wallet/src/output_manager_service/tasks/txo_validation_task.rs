@@ -22,21 +22,40 @@
 
 use crate::{
     output_manager_service::{
-        error::{OutputManagerError, OutputManagerProtocolError},
+        error::{OutputManagerError, OutputManagerProtocolError, OutputManagerStorageError},
         handle::OutputManagerEvent,
         resources::OutputManagerResources,
-        storage::{database::OutputManagerBackend, models::DbUnblindedOutput},
+        storage::{
+            database::{DbKey, OutputManagerBackend},
+            models::DbOutputSummary,
+        },
     },
     transaction_service::storage::models::TransactionStatus,
     types::ValidationRetryStrategy,
+    util::validation_checkpoint::{get_validation_scope, ValidationCheckpoint, ValidationScope},
 };
-use futures::{FutureExt, StreamExt};
+use futures::{stream::FuturesUnordered, FutureExt, StreamExt};
 use log::*;
-use std::{cmp, collections::HashMap, convert::TryFrom, fmt, sync::Arc, time::Duration};
-use tari_comms::{peer_manager::NodeId, types::CommsPublicKey, PeerConnection};
+use std::{
+    cmp,
+    collections::{HashMap, VecDeque},
+    convert::TryFrom,
+    fmt,
+    sync::Arc,
+    time::{Duration, Instant},
+};
+use tari_comms::{
+    peer_manager::NodeId,
+    protocol::rpc::{RpcClientLease, RpcError},
+    types::CommsPublicKey,
+    PeerConnection,
+};
 use tari_core::{
     base_node::rpc::BaseNodeWalletRpcClient,
-    proto::base_node::FetchMatchingUtxos,
+    proto::{
+        base_node::{FetchMatchingUtxos, FetchUtxosResponse},
+        types::TransactionOutput as TransactionOutputProto,
+    },
     transactions::{transaction::TransactionOutput, types::Signature},
 };
 use tari_crypto::tari_utilities::{hash::Hashable, hex::Hex};
@@ -45,6 +64,10 @@ use tokio::{sync::broadcast, time::delay_for};
 const LOG_TARGET: &str = "wallet::output_manager_service::utxo_validation_task";
 
 const MAX_RETRY_DELAY: Duration = Duration::from_secs(300);
+/// The number of output hashes sent in the first batch query, before any round trip times have been measured
+const INITIAL_BATCH_SIZE: usize = 250;
+/// The smallest batch that the adaptive batch size will shrink to
+const MIN_BATCH_SIZE: usize = 25;
 
 pub struct TxoValidationTask<TBackend>
 where TBackend: OutputManagerBackend + 'static
@@ -57,9 +80,16 @@ where TBackend: OutputManagerBackend + 'static
     retry_delay: Duration,
     base_node_update_receiver: Option<broadcast::Receiver<CommsPublicKey>>,
     base_node_synced: bool,
+    batch_size: AdaptiveBatchSize,
+    report: TxoValidationReport,
+    tip: Option<ValidationCheckpoint>,
 }
 
-/// This protocol defines the process of submitting our current UTXO set to the Base Node to validate it.
+/// This protocol defines the process of submitting our current TXO sets to the Base Node to validate them. The outputs
+/// of every requested set are queued together and sent in batches whose size follows the measured round trip time,
+/// with a batch in flight on each of several RPC sessions to the Base Node. Each set keeps a checkpoint of the chain
+/// tip it was last validated against, only the outputs that blocks after the checkpoint could affect are queried unless
+/// the chain has been reorganised since.
 impl<TBackend> TxoValidationTask<TBackend>
 where TBackend: OutputManagerBackend + 'static
 {
@@ -73,6 +103,10 @@ where TBackend: OutputManagerBackend + 'static
         base_node_update_receiver: broadcast::Receiver<CommsPublicKey>,
     ) -> Self {
         let retry_delay = resources.config.base_node_query_timeout;
+        let batch_size = AdaptiveBatchSize::new(
+            resources.config.max_utxo_query_size,
+            resources.config.txo_validation_target_latency,
+        );
         Self {
             id,
             validation_type,
@@ -82,6 +116,9 @@ where TBackend: OutputManagerBackend + 'static
             retry_delay,
             base_node_update_receiver: Some(base_node_update_receiver),
             base_node_synced: true,
+            batch_size,
+            report: TxoValidationReport::default(),
+            tip: None,
         }
     }
 
@@ -113,9 +150,7 @@ where TBackend: OutputManagerBackend + 'static
             total_retries_str
         );
 
-        let mut output_batches_to_query: Vec<Vec<Vec<u8>>> = self.get_output_batches().await?;
-
-        if output_batches_to_query.is_empty() {
+        if self.get_outputs_to_query(&HashMap::new()).await?.is_empty() {
             debug!(
                 target: LOG_TARGET,
                 "TXO validation protocol (Id: {}) has no outputs to validate", self.id,
@@ -139,7 +174,9 @@ where TBackend: OutputManagerBackend + 'static
         }
 
         let mut retries = 0;
-        let batch_total = output_batches_to_query.len();
+        // The outputs are queued once the scope of each set is known, which needs the tip of the Base Node
+        let mut scopes: Option<HashMap<TxoValidationType, ValidationScope>> = None;
+        let mut outputs_to_query = VecDeque::new();
 
         'main: loop {
             if let ValidationRetryStrategy::Limited(max_retries) = self.retry_strategy {
@@ -262,36 +299,118 @@ where TBackend: OutputManagerBackend + 'static
                 Some(c) => c,
             };
 
-            let mut client = match base_node_connection
-                .connect_rpc_using_builder(
-                    BaseNodeWalletRpcClient::builder().with_deadline(self.resources.config.base_node_query_timeout),
-                )
-                .await
-            {
-                Ok(c) => c,
-                Err(e) => {
-                    warn!(target: LOG_TARGET, "Problem establishing RPC connection: {}", e);
-                    delay.await;
-                    retries += 1;
-                    continue;
+            // Use a warm session from the wallet connectivity pool if there is one, otherwise connect a session
+            let pooled_client = self
+                .resources
+                .wallet_connectivity
+                .obtain_base_node_wallet_rpc_client(&base_node_node_id, self.resources.config.base_node_query_timeout)
+                .await;
+            let mut client = match pooled_client {
+                Some(c) => c,
+                None => match base_node_connection
+                    .connect_rpc_using_builder(
+                        BaseNodeWalletRpcClient::builder().with_deadline(self.resources.config.base_node_query_timeout),
+                    )
+                    .await
+                {
+                    Ok(c) => RpcClientLease::from(c),
+                    Err(e) => {
+                        warn!(target: LOG_TARGET, "Problem establishing RPC connection: {}", e);
+                        delay.await;
+                        retries += 1;
+                        continue;
+                    },
                 },
             };
-            let mut batch_num = 0;
-            debug!(target: LOG_TARGET, "RPC client connected");
-            'per_batch: loop {
-                let batch = if let Some(b) = output_batches_to_query.pop() {
-                    batch_num += 1;
-                    b
-                } else {
+
+            if scopes.is_none() {
+                let delay = delay_for(self.retry_delay);
+                match client.get_tip_info().await {
+                    Ok(tip_info) if !tip_info.is_synced => {
+                        self.base_node_synced = false;
+                        info!(target: LOG_TARGET, "Base Node reports not being synced, will retry.");
+                        let _ = self
+                            .resources
+                            .event_publisher
+                            .send(Arc::new(OutputManagerEvent::TxoValidationDelayed(
+                                self.id,
+                                self.validation_type,
+                            )))
+                            .map_err(|e| {
+                                trace!(
+                                    target: LOG_TARGET,
+                                    "Error sending event {:?}, because there are no subscribers.",
+                                    e.0
+                                );
+                                e
+                            });
+                        delay.await;
+                        self.update_retry_delay(false);
+                        retries += 1;
+                        continue;
+                    },
+                    Ok(tip_info) => {
+                        self.tip = ValidationCheckpoint::from_tip_info(&tip_info);
+                    },
+                    Err(e) => {
+                        warn!(target: LOG_TARGET, "Error with RPC Client: {}. Retrying RPC client connection.", e);
+                        delay.await;
+                        self.update_retry_delay(false);
+                        retries += 1;
+                        continue;
+                    },
+                }
+                let validation_scopes = self.get_validation_scopes(&mut base_node_connection).await?;
+                outputs_to_query = self.get_outputs_to_query(&validation_scopes).await?;
+                scopes = Some(validation_scopes);
+            }
+            // Requests on one RPC session are answered in turn, so each batch that is in flight at the same time needs
+            // its own session. Extra sessions are best effort and the protocol continues with those that connected.
+            let mut idle_clients = vec![client];
+            for _ in 1..self.num_sessions(outputs_to_query.len()) {
+                match base_node_connection
+                    .connect_rpc_using_builder(
+                        BaseNodeWalletRpcClient::builder().with_deadline(self.resources.config.base_node_query_timeout),
+                    )
+                    .await
+                {
+                    Ok(c) => idle_clients.push(c.into()),
+                    Err(e) => {
+                        debug!(target: LOG_TARGET, "Could not establish an additional RPC session: {}", e);
+                        break;
+                    },
+                }
+            }
+            debug!(target: LOG_TARGET, "{} RPC client(s) connected", idle_clients.len());
+
+            let mut queries = FuturesUnordered::new();
+            let mut in_flight: HashMap<usize, Vec<TxoQueueItem>> = HashMap::new();
+            let mut next_batch_id = 0;
+            loop {
+                while !outputs_to_query.is_empty() {
+                    let client = match idle_clients.pop() {
+                        Some(c) => c,
+                        None => break,
+                    };
+                    let batch_size = cmp::min(self.batch_size.size(), outputs_to_query.len());
+                    let batch = outputs_to_query.drain(..batch_size).collect::<Vec<_>>();
+                    let output_hashes = batch.iter().map(|item| item.output.hash.clone()).collect();
+                    info!(
+                        target: LOG_TARGET,
+                        "Output Manager TXO Validation protocol (Id: {}) sending batch query of {} outputs, {} outputs \
+                         remaining",
+                        self.id,
+                        batch.len(),
+                        outputs_to_query.len()
+                    );
+                    in_flight.insert(next_batch_id, batch);
+                    queries.push(query_batch(client, next_batch_id, output_hashes));
+                    next_batch_id += 1;
+                }
+                if queries.is_empty() {
                     break 'main;
-                };
-                info!(
-                    target: LOG_TARGET,
-                    "Output Manager TXO Validation protocol (Id: {}) sending batch query {} of {}",
-                    self.id,
-                    batch_num,
-                    batch_total
-                );
+                }
+
                 let delay = delay_for(self.retry_delay);
                 futures::select! {
                     new_base_node = base_node_update_receiver.select_next_some() => {
@@ -321,54 +440,63 @@ where TBackend: OutputManagerBackend + 'static
                             }
                         }
                     },
-                    result = self.send_query_batch(batch.clone(), &mut client).fuse() => {
+                    (client, batch_id, result, latency) = queries.select_next_some() => {
+                        let batch = in_flight.remove(&batch_id).unwrap_or_default();
                         match result {
-                            Ok(synced) => {
-                                self.base_node_synced = synced;
-                                if !synced {
-                                    info!(target: LOG_TARGET, "Base Node reports not being synced, will retry.");
+                            Ok(response) if !response.is_synced => {
+                                self.base_node_synced = false;
+                                info!(target: LOG_TARGET, "Base Node reports not being synced, will retry.");
+                                let _ = self
+                                    .resources
+                                    .event_publisher
+                                    .send(Arc::new(OutputManagerEvent::TxoValidationDelayed(self.id, self.validation_type)))
+                                    .map_err(|e| {
+                                        trace!(
+                                            target: LOG_TARGET,
+                                            "Error sending event {:?}, because there are no subscribers.",
+                                            e.0
+                                        );
+                                        e
+                                    });
+                                delay.await;
+                                self.update_retry_delay(false);
+                                // The tip is checked again once the Base Node is synced
+                                scopes = None;
+                                retries += 1;
+                                continue 'main;
+                            },
+                            Ok(response) => {
+                                self.batch_size.update(latency);
+                                self.update_retry_delay(true);
+                                if let Err(e) = self.process_batch_response(batch, response.outputs).await {
                                     let _ = self
                                         .resources
                                         .event_publisher
-                                        .send(Arc::new(OutputManagerEvent::TxoValidationDelayed(self.id, self.validation_type)))
+                                        .send(Arc::new(OutputManagerEvent::TxoValidationFailure(self.id, self.validation_type)))
                                         .map_err(|e| {
                                             trace!(
                                                 target: LOG_TARGET,
-                                                "Error sending event {:?}, because there are no subscribers.",
-                                                e.0
+                                                "Error sending event because there are no subscribers: {:?}",
+                                                e
                                             );
                                             e
                                         });
-                                    delay.await;
-                                    self.update_retry_delay(false);
-                                    output_batches_to_query = self.get_output_batches().await?;
-                                    retries += 1;
-                                    break 'per_batch;
+                                    return Err(e);
                                 }
-                                self.update_retry_delay(true);
+                                idle_clients.push(client);
                             },
-                            Err(OutputManagerProtocolError{id: _, error: OutputManagerError::RpcError(e)}) => {
+                            Err(e) => {
                                 warn!(target: LOG_TARGET, "Error with RPC Client: {}. Retrying RPC client connection.", e);
                                 delay.await;
                                 self.update_retry_delay(false);
-                                output_batches_to_query.push(batch);
+                                self.batch_size.decrease();
+                                // Requeue this batch and every batch that was still in flight on the other sessions
+                                outputs_to_query.extend(batch);
+                                for (_, batch) in in_flight.drain() {
+                                    outputs_to_query.extend(batch);
+                                }
                                 retries += 1;
-                                break 'per_batch;
-                            }
-                            Err(e) => {
-                                let _ = self
-                                    .resources
-                                    .event_publisher
-                                    .send(Arc::new(OutputManagerEvent::TxoValidationFailure(self.id, self.validation_type)))
-                                    .map_err(|e| {
-                                        trace!(
-                                            target: LOG_TARGET,
-                                            "Error sending event because there are no subscribers: {:?}",
-                                            e
-                                        );
-                                        e
-                                    });
-                                return Err(e);
+                                continue 'main;
                             },
                         }
                     },
@@ -380,6 +508,11 @@ where TBackend: OutputManagerBackend + 'static
             }
         }
 
+        info!(
+            target: LOG_TARGET,
+            "TXO Validation Protocol (Id: {}) for {} completed: {}", self.id, self.validation_type, self.report
+        );
+        self.set_validation_checkpoints().await;
         let _ = self
             .resources
             .event_publisher
@@ -398,228 +531,270 @@ where TBackend: OutputManagerBackend + 'static
         Ok(self.id)
     }
 
-    async fn send_query_batch(
+    /// Apply the outputs returned by the Base Node to the queried outputs, according to the set each queried output
+    /// was in when it was queued.
+    async fn process_batch_response(
         &mut self,
-        batch: Vec<Vec<u8>>,
-        client: &mut BaseNodeWalletRpcClient,
-    ) -> Result<bool, OutputManagerProtocolError> {
-        let request = FetchMatchingUtxos {
-            output_hashes: batch.clone(),
-        };
-
-        let batch_response = client
-            .fetch_matching_utxos(request)
-            .await
-            .map_err(|e| OutputManagerProtocolError::new(self.id, OutputManagerError::from(e)))?;
-
-        if !batch_response.is_synced {
-            return Ok(false);
-        }
-
-        let mut returned_outputs = Vec::new();
-        for output_proto in batch_response.outputs.iter() {
-            let output = TransactionOutput::try_from(output_proto.clone()).map_err(|_| {
+        batch: Vec<TxoQueueItem>,
+        outputs: Vec<TransactionOutputProto>,
+    ) -> Result<(), OutputManagerProtocolError> {
+        let mut returned_outputs = HashMap::new();
+        for output_proto in outputs {
+            let output = TransactionOutput::try_from(output_proto).map_err(|_| {
                 OutputManagerProtocolError::new(
                     self.id,
                     OutputManagerError::ConversionError("Could not convert protobuf TransactionOutput".to_string()),
                 )
             })?;
-            returned_outputs.push(output);
+            returned_outputs.insert(output.hash(), output);
         }
-
-        // complete validation
-        match self.validation_type {
-            TxoValidationType::Unspent => {
-                // Construct a HashMap of all the unspent outputs
-                let unspent_outputs: Vec<DbUnblindedOutput> =
-                    self.resources.db.get_unspent_outputs().await.map_err(|e| {
-                        OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                    })?;
-
-                // We only want to check outputs that we were expecting and are still valid
-                let mut output_hashes = HashMap::new();
-                for uo in unspent_outputs.iter() {
-                    let hash = uo.hash.clone();
-                    if batch.iter().any(|h| &hash == h) {
-                        output_hashes.insert(hash, uo.clone());
-                    }
-                }
-
-                // Go through all the returned UTXOs and if they are in the hashmap remove them
-                for output in returned_outputs.iter() {
-                    let response_hash = output.hash();
-
-                    let _ = output_hashes.remove(&response_hash);
-                }
-
-                // If there are any remaining Unspent Outputs we will move them to the invalid collection
-                for (_k, v) in output_hashes {
-                    // Get the transaction these belonged to so we can display the kernel signature of the transaction
-                    // this output belonged to.
-
-                    warn!(
-                        target: LOG_TARGET,
-                        "Output with value {} not returned from Base Node query and is thus being invalidated",
-                        v.unblinded_output.value,
-                    );
-                    trace!(
-                        target: LOG_TARGET,
-                        "Output {} with features {} not returned from Base Node query and is thus being invalidated",
-                        v.commitment.to_hex(),
-                        v.unblinded_output.features,
-                    );
-                    // If the output that is being invalidated has an associated TxId then get the kernel signature of
-                    // the transaction and display for easier debugging
-                    if let Some(tx_id) = self.resources.db.invalidate_output(v).await.map_err(|e| {
-                        OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                    })? {
-                        if let Ok(transaction) = self
-                            .resources
-                            .transaction_service
-                            .get_completed_transaction(tx_id)
-                            .await
-                        {
-                            info!(
-                                target: LOG_TARGET,
-                                "Invalidated Output is from Transaction (TxId: {}) with message: {} and Kernel \
-                                 Signature: {}",
-                                transaction.tx_id,
-                                transaction.message,
-                                transaction
-                                    .transaction
-                                    .first_kernel_excess_sig()
-                                    .unwrap_or(&Signature::default())
-                                    .get_signature()
-                                    .to_hex()
-                            );
-
-                            // If transaction is imported we will invalidate it. Normal transactions will be handled by
-                            // the transaction validators.
-                            if transaction.status == TransactionStatus::Imported && transaction.valid {
-                                if let Err(e) = self
-                                    .resources
-                                    .transaction_service
-                                    .set_transaction_validity(transaction.tx_id, false)
-                                    .await
-                                {
-                                    warn!(target: LOG_TARGET, "Problem setting transaction validity: {}", e);
-                                }
-                            }
-                        }
-                    } else {
+        self.report.queried += batch.len();
+
+        // Each queued output carries the summary it was queued from, so no outputs are read back from the database.
+        // Statuses that changed while the query was in flight are checked by the updates themselves.
+        let commitments = batch
+            .iter()
+            .map(|item| item.output.commitment.clone())
+            .collect::<Vec<_>>();
+        for item in batch {
+            match (item.output_type, returned_outputs.get(&item.output.hash)) {
+                (TxoValidationType::Unspent, None) => self.invalidate_output(item.output).await?,
+                (TxoValidationType::Invalid, Some(_)) => {
+                    if self
+                        .resources
+                        .db
+                        .revalidate_output(item.output.commitment)
+                        .await
+                        .is_ok()
+                    {
+                        self.report.revalidated += 1;
                         info!(
                             target: LOG_TARGET,
-                            "Invalidated Output does not have an associated TxId, it is likely a Coinbase output lost \
-                             to a Re-Org"
+                            "Output with value {} has been restored to a valid spendable output", item.output.value
                         );
                     }
-                }
-            },
-            TxoValidationType::Invalid => {
-                let invalid_outputs = self.resources.db.get_invalid_outputs().await.map_err(|e| {
-                    OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                })?;
-
-                for output in returned_outputs.iter() {
-                    let response_hash = output.hash();
-
-                    if let Some(output) = invalid_outputs.iter().find(|o| o.hash == response_hash) {
-                        if self
-                            .resources
-                            .db
-                            .revalidate_output(output.commitment.clone())
-                            .await
-                            .is_ok()
-                        {
-                            info!(
-                                target: LOG_TARGET,
-                                "Output with value {} has been restored to a valid spendable output",
-                                output.unblinded_output.value
-                            );
-                        }
-                    }
-                }
-            },
-            TxoValidationType::Spent => {
-                // Go through the response outputs and check if they are currently Spent, if they are then they can be
-                // marked as Unspent because they exist in the UTXO set. Hooray!
-                for output in returned_outputs.iter() {
+                },
+                // Queried Spent outputs that were returned exist in the UTXO set, so they can be marked as Unspent.
+                // Hooray!
+                (TxoValidationType::Spent, Some(output)) => {
                     match self
                         .resources
                         .db
-                        .update_spent_output_to_unspent(output.clone().commitment)
+                        .update_spent_output_to_unspent(output.commitment.clone())
                         .await
                     {
-                        Ok(uo) => info!(
-                            target: LOG_TARGET,
-                            "Spent output with value {} restored to Unspent output", uo.unblinded_output.value
-                        ),
+                        Ok(uo) => {
+                            self.report.restored += 1;
+                            info!(
+                                target: LOG_TARGET,
+                                "Spent output with value {} restored to Unspent output", uo.unblinded_output.value
+                            )
+                        },
                         Err(e) => debug!(target: LOG_TARGET, "Unable to restore Spent output to Unspent: {}", e),
                     }
-                }
-            },
+                },
+                _ => {},
+            }
+        }
+        if let Some(tip) = self.tip.as_ref() {
+            self.resources
+                .db
+                .set_outputs_validated_height(commitments, tip.height)
+                .await
+                .map_err(|e| {
+                    OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
+                })?;
         }
         debug!(
             target: LOG_TARGET,
             "Completed validation query for one batch of output hashes"
         );
 
-        Ok(true)
+        Ok(())
     }
 
-    async fn get_output_batches(&self) -> Result<Vec<Vec<Vec<u8>>>, OutputManagerProtocolError> {
-        let mut outputs: Vec<Vec<u8>> = match self.validation_type {
-            TxoValidationType::Unspent => self
+    /// Move an Unspent output that was not returned by the Base Node to the invalid outputs
+    async fn invalidate_output(&mut self, output: DbOutputSummary) -> Result<(), OutputManagerProtocolError> {
+        warn!(
+            target: LOG_TARGET,
+            "Output with value {} not returned from Base Node query and is thus being invalidated", output.value,
+        );
+        trace!(
+            target: LOG_TARGET,
+            "Output {} with features {} not returned from Base Node query and is thus being invalidated",
+            output.commitment.to_hex(),
+            output.features,
+        );
+        let tx_id = match self.resources.db.invalidate_output(output.commitment).await {
+            Ok(tx_id) => tx_id,
+            // The output was spent or otherwise changed while the query was in flight
+            Err(OutputManagerStorageError::ValuesNotFound) => {
+                debug!(target: LOG_TARGET, "Output is no longer unspent and was not invalidated");
+                return Ok(());
+            },
+            Err(e) => {
+                return Err(OutputManagerProtocolError::new(
+                    self.id,
+                    OutputManagerError::OutputManagerStorageError(e),
+                ))
+            },
+        };
+        self.report.invalidated += 1;
+        // If the output that is being invalidated has an associated TxId then get the kernel signature of the
+        // transaction and display for easier debugging
+        if let Some(tx_id) = tx_id {
+            if let Ok(transaction) = self
                 .resources
-                .db
-                .get_unspent_outputs()
+                .transaction_service
+                .get_completed_transaction(tx_id)
                 .await
-                .map_err(|e| {
-                    OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                })?
-                .iter()
-                .map(|uo| uo.hash.clone())
-                .collect(),
-            TxoValidationType::Spent => self
+            {
+                info!(
+                    target: LOG_TARGET,
+                    "Invalidated Output is from Transaction (TxId: {}) with message: {} and Kernel Signature: {}",
+                    transaction.tx_id,
+                    transaction.message,
+                    transaction
+                        .transaction
+                        .first_kernel_excess_sig()
+                        .unwrap_or(&Signature::default())
+                        .get_signature()
+                        .to_hex()
+                );
+
+                // If transaction is imported we will invalidate it. Normal transactions will be handled by the
+                // transaction validators.
+                if transaction.status == TransactionStatus::Imported && transaction.valid {
+                    if let Err(e) = self
+                        .resources
+                        .transaction_service
+                        .set_transaction_validity(transaction.tx_id, false)
+                        .await
+                    {
+                        warn!(target: LOG_TARGET, "Problem setting transaction validity: {}", e);
+                    }
+                }
+            }
+        } else {
+            info!(
+                target: LOG_TARGET,
+                "Invalidated Output does not have an associated TxId, it is likely a Coinbase output lost to a Re-Org"
+            );
+        }
+        Ok(())
+    }
+
+    /// The sets covered by this protocol's validation type
+    fn output_types(&self) -> Vec<TxoValidationType> {
+        match self.validation_type {
+            TxoValidationType::All => vec![
+                TxoValidationType::Unspent,
+                TxoValidationType::Spent,
+                TxoValidationType::Invalid,
+            ],
+            t => vec![t],
+        }
+    }
+
+    /// Compare the checkpoint of each set with the tip of the Base Node to find how much of the set has to be queried
+    async fn get_validation_scopes(
+        &self,
+        connection: &mut PeerConnection,
+    ) -> Result<HashMap<TxoValidationType, ValidationScope>, OutputManagerProtocolError> {
+        let mut scopes = HashMap::new();
+        for output_type in self.output_types() {
+            let checkpoint = self
                 .resources
                 .db
-                .get_spent_outputs()
+                .fetch_validation_checkpoint(output_type.checkpoint_name())
                 .await
                 .map_err(|e| {
                     OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                })?
-                .iter()
-                .map(|uo| uo.hash.clone())
-                .collect(),
-            TxoValidationType::Invalid => self
+                })?;
+            let scope = get_validation_scope(
+                connection,
+                checkpoint.as_ref(),
+                self.tip.as_ref(),
+                self.resources.config.base_node_query_timeout,
+            )
+            .await;
+            debug!(
+                target: LOG_TARGET,
+                "TXO Validation protocol (Id: {}) scope for {} is {:?}", self.id, output_type, scope
+            );
+            scopes.insert(output_type, scope);
+        }
+        Ok(scopes)
+    }
+
+    /// Queue the outputs of every set covered by this protocol's validation type that fall in the scope of their set.
+    /// A set without a scope is queued in full.
+    async fn get_outputs_to_query(
+        &self,
+        scopes: &HashMap<TxoValidationType, ValidationScope>,
+    ) -> Result<VecDeque<TxoQueueItem>, OutputManagerProtocolError> {
+        let mut outputs = VecDeque::new();
+        for output_type in self.output_types() {
+            let key = match output_type {
+                TxoValidationType::Spent => DbKey::SpentOutputs,
+                TxoValidationType::Invalid => DbKey::InvalidOutputs,
+                _ => DbKey::UnspentOutputs,
+            };
+            let scope = scopes.get(&output_type).copied().unwrap_or(ValidationScope::Full);
+            outputs.extend(
+                self.fetch_output_summaries(key)
+                    .await?
+                    .into_iter()
+                    .filter(|o| match scope {
+                        ValidationScope::Full => true,
+                        // Invalid outputs can be restored by any new block that mines them
+                        ValidationScope::NonFinal => {
+                            o.validated_height.is_none() || output_type == TxoValidationType::Invalid
+                        },
+                        ValidationScope::Unvalidated => o.validated_height.is_none(),
+                    })
+                    .map(|output| TxoQueueItem { output, output_type }),
+            );
+        }
+        Ok(outputs)
+    }
+
+    /// Record the tip that every set covered by this protocol has now been validated against
+    async fn set_validation_checkpoints(&self) {
+        let tip = match self.tip.as_ref() {
+            Some(t) => t,
+            None => return,
+        };
+        for output_type in self.output_types() {
+            if let Err(e) = self
                 .resources
                 .db
-                .get_invalid_outputs()
+                .set_validation_checkpoint(output_type.checkpoint_name(), tip.clone())
                 .await
-                .map_err(|e| {
-                    OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e))
-                })?
-                .into_iter()
-                .map(|uo| uo.hash)
-                .collect(),
-        };
-
-        // Determine how many rounds of base node request we need to query all the transactions in batches of
-        // max_tx_query_batch_size
-        let num_batches =
-            ((outputs.len() as f32) / (self.resources.config.max_utxo_query_size as f32 + 0.1)) as usize + 1;
-
-        let mut batches: Vec<Vec<Vec<u8>>> = Vec::new();
-        for _b in 0..num_batches {
-            let mut batch = Vec::new();
-            for o in outputs.drain(..cmp::min(self.resources.config.max_utxo_query_size, outputs.len())) {
-                batch.push(o);
-            }
-            if !batch.is_empty() {
-                batches.push(batch);
+            {
+                warn!(
+                    target: LOG_TARGET,
+                    "Could not store the validation checkpoint for {}: {}", output_type, e
+                );
             }
         }
-        Ok(batches)
+    }
+
+    async fn fetch_output_summaries(&self, key: DbKey) -> Result<Vec<DbOutputSummary>, OutputManagerProtocolError> {
+        self.resources
+            .db
+            .fetch_output_summaries(key)
+            .await
+            .map_err(|e| OutputManagerProtocolError::new(self.id, OutputManagerError::OutputManagerStorageError(e)))
+    }
+
+    /// The number of RPC sessions to open, there is no point in having more sessions than batches to send
+    fn num_sessions(&self, num_outputs: usize) -> usize {
+        let num_batches = (num_outputs + self.batch_size.size() - 1) / self.batch_size.size();
+        cmp::max(
+            cmp::min(self.resources.config.txo_validation_max_in_flight, num_batches),
+            1,
+        )
     }
 
     // exponential back-off with max and min delays
@@ -635,11 +810,106 @@ where TBackend: OutputManagerBackend + 'static
     }
 }
 
-#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+/// Send a single batch query on the given RPC session. The session is handed back with the response so that it can be
+/// reused for the next batch.
+async fn query_batch(
+    mut client: RpcClientLease<BaseNodeWalletRpcClient>,
+    batch_id: usize,
+    output_hashes: Vec<Vec<u8>>,
+) -> (
+    RpcClientLease<BaseNodeWalletRpcClient>,
+    usize,
+    Result<FetchUtxosResponse, RpcError>,
+    Duration,
+) {
+    let timer = Instant::now();
+    let result = client.fetch_matching_utxos(FetchMatchingUtxos { output_hashes }).await;
+    (client, batch_id, result, timer.elapsed())
+}
+
+/// An output hash waiting to be queried, along with the set the output was in when it was queued
+#[derive(Debug, Clone)]
+struct TxoQueueItem {
+    output: DbOutputSummary,
+    output_type: TxoValidationType,
+}
+
+/// The number of output hashes to send per batch query. The size doubles while queries return well within the target
+/// latency and halves when they take longer than it, staying between a floor and the configured maximum.
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct AdaptiveBatchSize {
+    size: usize,
+    min: usize,
+    max: usize,
+    target_latency: Duration,
+}
+
+impl AdaptiveBatchSize {
+    fn new(max: usize, target_latency: Duration) -> Self {
+        let max = cmp::max(max, 1);
+        Self {
+            size: cmp::min(INITIAL_BATCH_SIZE, max),
+            min: cmp::min(MIN_BATCH_SIZE, max),
+            max,
+            target_latency,
+        }
+    }
+
+    fn size(&self) -> usize {
+        self.size
+    }
+
+    fn update(&mut self, latency: Duration) {
+        if latency > self.target_latency {
+            self.decrease();
+        } else if latency < self.target_latency / 2 {
+            self.size = cmp::min(self.size * 2, self.max);
+        }
+    }
+
+    fn decrease(&mut self) {
+        self.size = cmp::max(self.size / 2, self.min);
+    }
+}
+
+/// The merged outcome of all the batches of a validation protocol
+#[derive(Debug, Clone, Default)]
+struct TxoValidationReport {
+    queried: usize,
+    invalidated: usize,
+    revalidated: usize,
+    restored: usize,
+}
+
+impl fmt::Display for TxoValidationReport {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "{} outputs queried, {} invalidated, {} revalidated, {} restored to unspent",
+            self.queried, self.invalidated, self.revalidated, self.restored
+        )
+    }
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
 pub enum TxoValidationType {
     Unspent,
     Spent,
     Invalid,
+    /// Validate the Unspent, Spent and Invalid outputs together in one protocol
+    All,
+}
+
+impl TxoValidationType {
+    /// The name the validation checkpoint of this set is stored under
+    fn checkpoint_name(&self) -> &'static str {
+        match self {
+            TxoValidationType::Unspent => "unspent_outputs",
+            TxoValidationType::Spent => "spent_outputs",
+            TxoValidationType::Invalid => "invalid_outputs",
+            TxoValidationType::All => "all_outputs",
+        }
+    }
 }
 
 impl fmt::Display for TxoValidationType {
@@ -648,6 +918,41 @@ impl fmt::Display for TxoValidationType {
             TxoValidationType::Unspent => write!(f, "Unspent Outputs Validation"),
             TxoValidationType::Spent => write!(f, "Spent Outputs Validation"),
             TxoValidationType::Invalid => write!(f, "Invalid Outputs Validation"),
+            TxoValidationType::All => write!(f, "All Outputs Validation"),
+        }
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::AdaptiveBatchSize;
+    use std::time::Duration;
+
+    #[test]
+    fn test_adaptive_batch_size() {
+        let mut batch_size = AdaptiveBatchSize::new(1000, Duration::from_secs(4));
+        assert_eq!(batch_size.size(), 250);
+
+        batch_size.update(Duration::from_secs(1));
+        assert_eq!(batch_size.size(), 500);
+        batch_size.update(Duration::from_secs(1));
+        batch_size.update(Duration::from_secs(1));
+        assert_eq!(batch_size.size(), 1000);
+
+        // Within the target latency the size is kept
+        batch_size.update(Duration::from_secs(3));
+        assert_eq!(batch_size.size(), 1000);
+
+        for _ in 0..10 {
+            batch_size.update(Duration::from_secs(5));
         }
+        assert_eq!(batch_size.size(), 25);
+
+        let mut batch_size = AdaptiveBatchSize::new(2, Duration::from_secs(4));
+        assert_eq!(batch_size.size(), 2);
+        batch_size.decrease();
+        assert_eq!(batch_size.size(), 2);
+        batch_size.update(Duration::from_millis(1));
+        assert_eq!(batch_size.size(), 2);
     }
 }
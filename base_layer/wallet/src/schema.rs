@@ -24,6 +24,8 @@ table! {
         valid -> Integer,
         confirmations -> Nullable<BigInt>,
         mined_height -> Nullable<BigInt>,
+        change_seq -> BigInt,
+        validated_height -> Nullable<BigInt>,
     }
 }
 
@@ -34,6 +36,14 @@ table! {
     }
 }
 
+table! {
+    encryption_progress (table_name) {
+        table_name -> Text,
+        encrypting -> Integer,
+        last_id -> BigInt,
+    }
+}
+
 table! {
     inbound_transactions (tx_id) {
         tx_id -> BigInt,
@@ -46,6 +56,7 @@ table! {
         direct_send_success -> Integer,
         send_count -> Integer,
         last_send_timestamp -> Nullable<Timestamp>,
+        change_seq -> BigInt,
     }
 }
 
@@ -81,6 +92,14 @@ table! {
         direct_send_success -> Integer,
         send_count -> Integer,
         last_send_timestamp -> Nullable<Timestamp>,
+        change_seq -> BigInt,
+    }
+}
+
+table! {
+    output_balances (status) {
+        status -> Integer,
+        total -> BigInt,
     }
 }
 
@@ -102,6 +121,7 @@ table! {
         metadata_signature_nonce -> Binary,
         metadata_signature_u_key -> Binary,
         metadata_signature_v_key -> Binary,
+        validated_height -> Nullable<BigInt>,
     }
 }
 
@@ -114,6 +134,21 @@ table! {
     }
 }
 
+table! {
+    transaction_change_sequence (id) {
+        id -> Integer,
+        seq -> BigInt,
+    }
+}
+
+table! {
+    validation_checkpoints (name) {
+        name -> Text,
+        height -> BigInt,
+        block_hash -> Binary,
+    }
+}
+
 table! {
     wallet_settings (key) {
         key -> Text,
@@ -125,11 +160,15 @@ allow_tables_to_appear_in_same_query!(
     client_key_values,
     completed_transactions,
     contacts,
+    encryption_progress,
     inbound_transactions,
     key_manager_states,
     known_one_sided_payment_scripts,
     outbound_transactions,
+    output_balances,
     outputs,
     pending_transaction_outputs,
+    transaction_change_sequence,
+    validation_checkpoints,
     wallet_settings,
 );
@@ -47,6 +47,9 @@ pub trait WalletBackend: Send + Sync + Clone {
     fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), WalletStorageError>;
     /// Remove encryption from the backend.
     fn remove_encryption(&self) -> Result<(), WalletStorageError>;
+    /// Record that encryption is about to be removed from the backend and from the backends that share its storage, so
+    /// that an interrupted removal is completed when the wallet is next opened.
+    fn begin_remove_encryption(&self) -> Result<(), WalletStorageError>;
 }
 
 #[derive(Debug, Clone, PartialEq)]
@@ -245,6 +248,14 @@ where T: WalletBackend + 'static
             .and_then(|inner_result| inner_result)
     }
 
+    pub async fn begin_remove_encryption(&self) -> Result<(), WalletStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.begin_remove_encryption())
+            .await
+            .map_err(|err| WalletStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
     pub async fn set_client_key_value(&self, key: String, value: String) -> Result<(), WalletStorageError> {
         let db_clone = self.db.clone();
 
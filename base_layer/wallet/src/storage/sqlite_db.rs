@@ -22,11 +22,13 @@
 
 use crate::{
     error::WalletStorageError,
+    output_manager_service::storage::sqlite_db::ENCRYPTED_TABLES as OUTPUT_MANAGER_ENCRYPTED_TABLES,
     schema::{client_key_values, wallet_settings},
     storage::{
         database::{DbKey, DbKeyValuePair, DbValue, WalletBackend, WriteOperation},
-        sqlite_utilities::WalletDbConnection,
+        sqlite_utilities::{EncryptionProgressSql, WalletDbConnection},
     },
+    transaction_service::storage::sqlite_db::ENCRYPTED_TABLES as TRANSACTION_ENCRYPTED_TABLES,
     util::encryption::{decrypt_bytes_integral_nonce, encrypt_bytes_integral_nonce, Encryptable, AES_NONCE_BYTES},
 };
 use aes_gcm::{
@@ -57,6 +59,8 @@ use tari_crypto::{
 };
 
 const LOG_TARGET: &str = "wallet::storage::sqlite_db";
+/// The progress row that marks a removal of encryption that has started but has not yet reached the wallet settings
+const WALLET_SETTINGS_TABLE: &str = "wallet_settings";
 
 /// A Sqlite backend for the Output Manager Service. The Backend is accessed via a connection pool to the Sqlite file.
 #[derive(Clone)]
@@ -74,6 +78,24 @@ impl WalletSqliteDatabase {
         })
     }
 
+    /// Finish removing encryption from the wallet settings if a removal was interrupted, returning true if it was. The
+    /// other backends sharing the connection must have completed their own interrupted passes first and are no longer
+    /// encrypted once this returns true.
+    pub fn complete_interrupted_encryption(&self) -> Result<bool, WalletStorageError> {
+        if acquire_read_lock!(self.cipher).is_none() {
+            return Ok(false);
+        }
+        let in_progress = {
+            let conn = self.database_connection.acquire_lock();
+            EncryptionProgressSql::is_in_progress(&[WALLET_SETTINGS_TABLE], false, &conn)?
+        };
+        if in_progress {
+            info!(target: LOG_TARGET, "Completing an interrupted pass removing encryption");
+            self.remove_encryption()?;
+        }
+        Ok(in_progress)
+    }
+
     fn set_master_secret_key(
         &self,
         secret_key: &CommsSecretKey,
@@ -323,33 +345,42 @@ impl WalletBackend for WalletSqliteDatabase {
         }
 
         let conn = self.database_connection.acquire_lock();
-        let secret_key_str = match WalletSettingSql::get(DbKey::MasterSecretKey.to_string(), &conn)? {
-            None => return Err(WalletStorageError::ValueNotFound(DbKey::MasterSecretKey)),
-            Some(sk) => sk,
-        };
-        // If this fails then the database is already encrypted.
-        let secret_key = CommsSecretKey::from_hex(&secret_key_str).map_err(|_| WalletStorageError::AlreadyEncrypted)?;
-        let ciphertext_integral_nonce = encrypt_bytes_integral_nonce(&cipher, secret_key.to_vec())
-            .map_err(|e| WalletStorageError::AeadError(format!("Encryption Error:{}", e.to_string())))?;
-        WalletSettingSql::new(DbKey::MasterSecretKey.to_string(), ciphertext_integral_nonce.to_hex()).set(&conn)?;
-
-        // Encrypt all the client values
-        let mut client_key_values = ClientKeyValueSql::index(&conn)?;
-        for ckv in client_key_values.iter_mut() {
-            ckv.encrypt(&cipher)
+        // The passes over the other backends are recorded with the encrypted wallet settings so that opening the wallet
+        // with the passphrase always completes them
+        conn.transaction::<_, WalletStorageError, _>(|| {
+            let secret_key_str = match WalletSettingSql::get(DbKey::MasterSecretKey.to_string(), &conn)? {
+                None => return Err(WalletStorageError::ValueNotFound(DbKey::MasterSecretKey)),
+                Some(sk) => sk,
+            };
+            // If this fails then the database is already encrypted.
+            let secret_key =
+                CommsSecretKey::from_hex(&secret_key_str).map_err(|_| WalletStorageError::AlreadyEncrypted)?;
+            let ciphertext_integral_nonce = encrypt_bytes_integral_nonce(&cipher, secret_key.to_vec())
                 .map_err(|e| WalletStorageError::AeadError(format!("Encryption Error:{}", e.to_string())))?;
-            ckv.set(&conn)?;
-        }
+            WalletSettingSql::new(DbKey::MasterSecretKey.to_string(), ciphertext_integral_nonce.to_hex()).set(&conn)?;
 
-        // Encrypt tor_id if present
-        let tor_id = WalletSettingSql::get(DbKey::TorId.to_string(), &conn)?;
-        if let Some(v) = tor_id {
-            let tor = TorIdentity::from_json(&v).map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
-            let bytes = bincode::serialize(&tor).map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
-            let ciphertext_integral_nonce = encrypt_bytes_integral_nonce(&cipher, bytes)
-                .map_err(|e| WalletStorageError::AeadError(format!("Encryption Error:{}", e.to_string())))?;
-            WalletSettingSql::new(DbKey::TorId.to_string(), ciphertext_integral_nonce.to_hex()).set(&conn)?;
-        }
+            // Encrypt all the client values
+            let mut client_key_values = ClientKeyValueSql::index(&conn)?;
+            for ckv in client_key_values.iter_mut() {
+                ckv.encrypt(&cipher)
+                    .map_err(|e| WalletStorageError::AeadError(format!("Encryption Error:{}", e.to_string())))?;
+                ckv.set(&conn)?;
+            }
+
+            // Encrypt tor_id if present
+            let tor_id = WalletSettingSql::get(DbKey::TorId.to_string(), &conn)?;
+            if let Some(v) = tor_id {
+                let tor = TorIdentity::from_json(&v).map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
+                let bytes = bincode::serialize(&tor).map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
+                let ciphertext_integral_nonce = encrypt_bytes_integral_nonce(&cipher, bytes)
+                    .map_err(|e| WalletStorageError::AeadError(format!("Encryption Error:{}", e.to_string())))?;
+                WalletSettingSql::new(DbKey::TorId.to_string(), ciphertext_integral_nonce.to_hex()).set(&conn)?;
+            }
+
+            EncryptionProgressSql::begin(&OUTPUT_MANAGER_ENCRYPTED_TABLES, true, &conn)?;
+            EncryptionProgressSql::begin(&TRANSACTION_ENCRYPTED_TABLES, true, &conn)?;
+            Ok(())
+        })?;
 
         (*current_cipher) = Some(cipher);
 
@@ -364,42 +395,64 @@ impl WalletBackend for WalletSqliteDatabase {
             return Ok(());
         };
         let conn = self.database_connection.acquire_lock();
-        let secret_key_str = match WalletSettingSql::get(DbKey::MasterSecretKey.to_string(), &conn)? {
-            None => return Err(WalletStorageError::ValueNotFound(DbKey::MasterSecretKey)),
-            Some(sk) => sk,
-        };
-
-        let secret_key_bytes = decrypt_bytes_integral_nonce(&cipher, from_hex(secret_key_str.as_str())?)
-            .map_err(|e| WalletStorageError::AeadError(format!("Decryption Error:{}", e.to_string())))?;
-        let decrypted_key = CommsSecretKey::from_bytes(secret_key_bytes.as_slice())?;
-        WalletSettingSql::new(DbKey::MasterSecretKey.to_string(), decrypted_key.to_hex()).set(&conn)?;
+        conn.transaction::<_, WalletStorageError, _>(|| {
+            let secret_key_str = match WalletSettingSql::get(DbKey::MasterSecretKey.to_string(), &conn)? {
+                None => return Err(WalletStorageError::ValueNotFound(DbKey::MasterSecretKey)),
+                Some(sk) => sk,
+            };
 
-        // Decrypt all the client values
-        let mut client_key_values = ClientKeyValueSql::index(&conn)?;
-        for ckv in client_key_values.iter_mut() {
-            ckv.decrypt(&cipher)
+            let secret_key_bytes = decrypt_bytes_integral_nonce(&cipher, from_hex(secret_key_str.as_str())?)
                 .map_err(|e| WalletStorageError::AeadError(format!("Decryption Error:{}", e.to_string())))?;
-            ckv.set(&conn)?;
-        }
+            let decrypted_key = CommsSecretKey::from_bytes(secret_key_bytes.as_slice())?;
+            WalletSettingSql::new(DbKey::MasterSecretKey.to_string(), decrypted_key.to_hex()).set(&conn)?;
+
+            // Decrypt all the client values
+            let mut client_key_values = ClientKeyValueSql::index(&conn)?;
+            for ckv in client_key_values.iter_mut() {
+                ckv.decrypt(&cipher)
+                    .map_err(|e| WalletStorageError::AeadError(format!("Decryption Error:{}", e.to_string())))?;
+                ckv.set(&conn)?;
+            }
 
-        // remove tor id encryption if present
-        let key_str = WalletSettingSql::get(DbKey::TorId.to_string(), &conn)?;
-        if let Some(v) = key_str {
-            let decrypted_key_bytes = decrypt_bytes_integral_nonce(&cipher, from_hex(v.as_str())?)
-                .map_err(|e| WalletStorageError::AeadError(format!("Decryption Error:{}", e.to_string())))?;
-            let tor_id: TorIdentity = bincode::deserialize(&decrypted_key_bytes)
-                .map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
-            let tor_string = tor_id
-                .to_json()
-                .map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
-            WalletSettingSql::new(DbKey::TorId.to_string(), tor_string).set(&conn)?;
-        }
+            // remove tor id encryption if present
+            let key_str = WalletSettingSql::get(DbKey::TorId.to_string(), &conn)?;
+            if let Some(v) = key_str {
+                let decrypted_key_bytes = decrypt_bytes_integral_nonce(&cipher, from_hex(v.as_str())?)
+                    .map_err(|e| WalletStorageError::AeadError(format!("Decryption Error:{}", e.to_string())))?;
+                let tor_id: TorIdentity = bincode::deserialize(&decrypted_key_bytes)
+                    .map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
+                let tor_string = tor_id
+                    .to_json()
+                    .map_err(|e| WalletStorageError::ConversionError(e.to_string()))?;
+                WalletSettingSql::new(DbKey::TorId.to_string(), tor_string).set(&conn)?;
+            }
+
+            EncryptionProgressSql::clear(WALLET_SETTINGS_TABLE, &conn)?;
+            Ok(())
+        })?;
 
         // Now that all the decryption has been completed we can safely remove the cipher fully
         let _ = (*current_cipher).take();
 
         Ok(())
     }
+
+    fn begin_remove_encryption(&self) -> Result<(), WalletStorageError> {
+        if acquire_read_lock!(self.cipher).is_none() {
+            return Ok(());
+        }
+        let conn = self.database_connection.acquire_lock();
+        if !EncryptionProgressSql::is_in_progress(&[WALLET_SETTINGS_TABLE], false, &conn)? {
+            let tables = [
+                &OUTPUT_MANAGER_ENCRYPTED_TABLES[..],
+                &TRANSACTION_ENCRYPTED_TABLES[..],
+                &[WALLET_SETTINGS_TABLE][..],
+            ]
+            .concat();
+            EncryptionProgressSql::begin(&tables, false, &conn)?;
+        }
+        Ok(())
+    }
 }
 
 /// Confirm if database is encrypted or not and if a cipher is provided confirm the cipher is correct.
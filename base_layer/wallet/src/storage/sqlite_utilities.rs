@@ -24,26 +24,47 @@ use crate::{
     contacts_service::storage::sqlite_db::ContactsServiceSqliteDatabase,
     error::WalletStorageError,
     output_manager_service::storage::sqlite_db::OutputManagerSqliteDatabase,
+    schema::{encryption_progress, validation_checkpoints},
     storage::{database::WalletDatabase, sqlite_db::WalletSqliteDatabase},
     transaction_service::storage::sqlite_db::TransactionServiceSqliteDatabase,
+    util::{
+        encryption::{apply_cipher_in_parallel, Encryptable, EncryptionProgress},
+        validation_checkpoint::ValidationCheckpoint,
+    },
 };
 use aes_gcm::{
-    aead::{generic_array::GenericArray, NewAead},
+    aead::{generic_array::GenericArray, Error as AeadError, NewAead},
     Aes256Gcm,
 };
-use diesel::{Connection, SqliteConnection};
+use diesel::{prelude::*, result::Error as DieselError, SqliteConnection};
 use digest::Digest;
 use fs2::FileExt;
 use log::*;
 use std::{
     fs::File,
+    ops::{Deref, DerefMut},
     path::{Path, PathBuf},
     sync::{Arc, Mutex, MutexGuard},
+    time::Instant,
 };
 use tari_crypto::common::Blake256;
+use tari_metrics::Histogram;
 
 const LOG_TARGET: &str = "wallet::storage:sqlite_utilities";
 
+lazy_static! {
+    static ref LOCK_WAIT_DURATION: Arc<Histogram> = tari_metrics::global().histogram(
+        "wallet_sqlite_lock_wait_seconds",
+        "Time spent waiting for the wallet database connection",
+        &[],
+    );
+    static ref QUERY_DURATION: Arc<Histogram> = tari_metrics::global().histogram(
+        "wallet_sqlite_query_seconds",
+        "Time the wallet database connection is held to run queries",
+        &[],
+    );
+}
+
 #[derive(Clone)]
 pub struct WalletDbConnection {
     pub connection: Arc<Mutex<SqliteConnection>>,
@@ -58,8 +79,40 @@ impl WalletDbConnection {
         }
     }
 
-    pub fn acquire_lock(&self) -> MutexGuard<SqliteConnection> {
-        acquire_lock!(self.connection)
+    pub fn acquire_lock(&self) -> WalletDbConnectionGuard<'_> {
+        let timer = Instant::now();
+        let guard = acquire_lock!(self.connection);
+        LOCK_WAIT_DURATION.observe(timer.elapsed());
+        WalletDbConnectionGuard {
+            guard,
+            acquired: Instant::now(),
+        }
+    }
+}
+
+/// The locked database connection. The time the connection was held is recorded when the guard is dropped.
+pub struct WalletDbConnectionGuard<'a> {
+    guard: MutexGuard<'a, SqliteConnection>,
+    acquired: Instant,
+}
+
+impl Deref for WalletDbConnectionGuard<'_> {
+    type Target = SqliteConnection;
+
+    fn deref(&self) -> &Self::Target {
+        &self.guard
+    }
+}
+
+impl DerefMut for WalletDbConnectionGuard<'_> {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.guard
+    }
+}
+
+impl Drop for WalletDbConnectionGuard<'_> {
+    fn drop(&mut self) {
+        QUERY_DURATION.observe(self.acquired.elapsed());
     }
 }
 
@@ -164,8 +217,18 @@ pub fn initialize_sqlite_database_backends(
     })?;
 
     let wallet_backend = WalletSqliteDatabase::new(connection.clone(), cipher.clone())?;
-    let transaction_backend = TransactionServiceSqliteDatabase::new(connection.clone(), cipher.clone());
-    let output_manager_backend = OutputManagerSqliteDatabase::new(connection.clone(), cipher);
+    let mut transaction_backend = TransactionServiceSqliteDatabase::new(connection.clone(), cipher.clone());
+    let mut output_manager_backend = OutputManagerSqliteDatabase::new(connection.clone(), cipher);
+
+    // A pass that applied or removed encryption and was interrupted is completed before anything reads the backends.
+    // When completing a removal the wallet settings are decrypted last, after which none of the backends are encrypted.
+    output_manager_backend.complete_interrupted_encryption()?;
+    transaction_backend.complete_interrupted_encryption()?;
+    if wallet_backend.complete_interrupted_encryption()? {
+        transaction_backend = TransactionServiceSqliteDatabase::new(connection.clone(), None);
+        output_manager_backend = OutputManagerSqliteDatabase::new(connection.clone(), None);
+    }
+
     let contacts_backend = ContactsServiceSqliteDatabase::new(connection);
 
     Ok((
@@ -175,3 +238,151 @@ pub fn initialize_sqlite_database_backends(
         contacts_backend,
     ))
 }
+
+/// The position reached in a table by an incomplete pass that applies or removes encryption. The row is written in the
+/// same database transaction as each batch of re-encrypted rows so that an interrupted pass continues after the last
+/// batch that was committed.
+#[derive(Clone, Debug, Queryable, Insertable, PartialEq)]
+#[table_name = "encryption_progress"]
+pub struct EncryptionProgressSql {
+    pub table_name: String,
+    pub encrypting: i32,
+    pub last_id: i64,
+}
+
+impl EncryptionProgressSql {
+    pub fn new(table_name: &str, encrypting: bool, last_id: i64) -> Self {
+        Self {
+            table_name: table_name.to_string(),
+            encrypting: encrypting as i32,
+            last_id,
+        }
+    }
+
+    pub fn set(&self, conn: &SqliteConnection) -> Result<(), DieselError> {
+        diesel::replace_into(encryption_progress::table)
+            .values(self)
+            .execute(conn)?;
+        Ok(())
+    }
+
+    pub fn get(table_name: &str, conn: &SqliteConnection) -> Result<Option<Self>, DieselError> {
+        encryption_progress::table
+            .filter(encryption_progress::table_name.eq(table_name))
+            .first::<EncryptionProgressSql>(conn)
+            .optional()
+    }
+
+    pub fn clear(table_name: &str, conn: &SqliteConnection) -> Result<(), DieselError> {
+        diesel::delete(encryption_progress::table.filter(encryption_progress::table_name.eq(table_name)))
+            .execute(conn)?;
+        Ok(())
+    }
+
+    /// Returns true if a pass in the given direction over any of the tables is incomplete
+    pub fn is_in_progress(tables: &[&str], encrypting: bool, conn: &SqliteConnection) -> Result<bool, DieselError> {
+        let count = encryption_progress::table
+            .filter(encryption_progress::table_name.eq_any(tables.to_vec()))
+            .filter(encryption_progress::encrypting.eq(encrypting as i32))
+            .count()
+            .get_result::<i64>(conn)?;
+        Ok(count > 0)
+    }
+
+    /// Record the start of a pass over all of the tables
+    pub fn begin(tables: &[&str], encrypting: bool, conn: &SqliteConnection) -> Result<(), DieselError> {
+        conn.transaction(|| {
+            for table_name in tables {
+                EncryptionProgressSql::new(table_name, encrypting, i64::MIN).set(conn)?;
+            }
+            Ok(())
+        })
+    }
+}
+
+/// Encrypt or decrypt the rows of a table in batches, committing each batch and the position reached in a single
+/// database transaction. The pass starts after the position recorded for the table and does nothing if no pass over the
+/// table has been started with [EncryptionProgressSql::begin].
+///
+/// `load_batch` must return the rows with ids greater than the given id in ascending order of id, and `write` must
+/// write the encrypted fields of a row back to the table.
+pub fn run_encryption_pass<T, E, L, W, A>(
+    conn: &SqliteConnection,
+    table_name: &str,
+    encrypting: bool,
+    cipher: &Aes256Gcm,
+    progress: &EncryptionProgress,
+    load_batch: L,
+    write: W,
+    aead_error: A,
+) -> Result<(), E>
+where
+    T: Encryptable<Aes256Gcm> + Send,
+    E: From<DieselError>,
+    L: Fn(i64, &SqliteConnection) -> Result<Vec<(i64, T)>, E>,
+    W: Fn(&T, &SqliteConnection) -> Result<(), E>,
+    A: Fn(AeadError) -> E,
+{
+    let mut last_id = match EncryptionProgressSql::get(table_name, conn)? {
+        Some(p) => p.last_id,
+        None => return Ok(()),
+    };
+
+    loop {
+        let batch = conn.transaction::<_, E, _>(|| {
+            let batch = load_batch(last_id, conn)?;
+            let batch_last_id = match batch.last() {
+                Some((id, _)) => *id,
+                None => return Ok(None),
+            };
+            let rows = batch.into_iter().map(|(_, row)| row).collect::<Vec<_>>();
+            let rows = apply_cipher_in_parallel(rows, cipher, encrypting).map_err(&aead_error)?;
+            for row in rows.iter() {
+                write(row, conn)?;
+            }
+            EncryptionProgressSql::new(table_name, encrypting, batch_last_id).set(conn)?;
+            Ok(Some((rows.len(), batch_last_id)))
+        })?;
+
+        match batch {
+            Some((num_rows, batch_last_id)) => {
+                last_id = batch_last_id;
+                progress.advance(num_rows as u64);
+            },
+            None => break,
+        }
+    }
+
+    EncryptionProgressSql::clear(table_name, conn)?;
+    Ok(())
+}
+
+/// The chain tip that the set of outputs or transactions with the given name was last validated against
+#[derive(Clone, Debug, Queryable, Insertable, PartialEq)]
+#[table_name = "validation_checkpoints"]
+pub struct ValidationCheckpointSql {
+    pub name: String,
+    pub height: i64,
+    pub block_hash: Vec<u8>,
+}
+
+impl ValidationCheckpointSql {
+    pub fn set(name: &str, checkpoint: ValidationCheckpoint, conn: &SqliteConnection) -> Result<(), DieselError> {
+        diesel::replace_into(validation_checkpoints::table)
+            .values(ValidationCheckpointSql {
+                name: name.to_string(),
+                height: checkpoint.height as i64,
+                block_hash: checkpoint.block_hash,
+            })
+            .execute(conn)?;
+        Ok(())
+    }
+
+    pub fn get(name: &str, conn: &SqliteConnection) -> Result<Option<ValidationCheckpoint>, DieselError> {
+        Ok(validation_checkpoints::table
+            .filter(validation_checkpoints::name.eq(name))
+            .first::<ValidationCheckpointSql>(conn)
+            .optional()?
+            .map(|c| ValidationCheckpoint::new(c.height as u64, c.block_hash)))
+    }
+}
@@ -21,15 +21,21 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     contacts_service::storage::sqlite_db::ContactsServiceSqliteDatabase,
-    output_manager_service::storage::sqlite_db::OutputManagerSqliteDatabase,
+    output_manager_service::{derive_rewind_data, storage::sqlite_db::OutputManagerSqliteDatabase},
     storage::{sqlite_db::WalletSqliteDatabase, sqlite_utilities::run_migration_and_create_sqlite_connection},
     transaction_service::storage::sqlite_db::TransactionServiceSqliteDatabase,
+    types::KeyDigest,
 };
 use core::iter;
+use futures::channel::mpsc;
 use rand::{distributions::Alphanumeric, rngs::OsRng, Rng};
-use std::path::Path;
+use std::{path::Path, sync::Arc};
+use tari_core::transactions::{transaction_protocol::RewindData, types::PrivateKey};
+use tari_key_manager::key_manager::KeyManager;
 use tempfile::{tempdir, TempDir};
+use tokio::sync::RwLock;
 
 pub fn random_string(len: usize) -> String {
     iter::repeat(())
@@ -69,3 +75,21 @@ pub fn make_wallet_databases(
         temp_dir,
     )
 }
+
+/// A test helper to create the first `num_keys` spending keys of a new wallet with this master key and the rewind data
+/// of the wallet. Outputs built from these are the outputs that the wallet finds when it is recovered.
+pub fn make_recoverable_output_keys(master_key: &PrivateKey, num_keys: u64) -> (Vec<PrivateKey>, RewindData) {
+    let key_manager = KeyManager::<PrivateKey, KeyDigest>::from(master_key.clone(), "".to_string(), 0);
+    let spending_keys = (0..num_keys)
+        .map(|i| key_manager.derive_key(i).expect("Should be able to derive key").k)
+        .collect();
+    let rewind_data = derive_rewind_data(master_key).expect("Should be able to derive rewind data");
+    (spending_keys, rewind_data)
+}
+
+/// A test helper to create a wallet connectivity handle without a running service. No pooled RPC sessions are ever
+/// available from it, so services that use it connect their own sessions.
+pub fn make_wallet_connectivity_mock() -> WalletConnectivityHandle {
+    let (sender, _) = mpsc::channel(1);
+    WalletConnectivityHandle::new(sender, Arc::new(RwLock::new(None)))
+}
@@ -24,8 +24,16 @@ use crate::{
     output_manager_service::TxId,
     transaction_service::{
         error::TransactionServiceError,
-        storage::models::{CompletedTransaction, InboundTransaction, OutboundTransaction, WalletTransaction},
+        storage::models::{
+            CompletedTransaction,
+            CompletedTransactionQuery,
+            InboundTransaction,
+            OutboundTransaction,
+            TransactionChanges,
+            WalletTransaction,
+        },
     },
+    util::encryption::EncryptionProgress,
 };
 use aes_gcm::Aes256Gcm;
 use futures::{stream::Fuse, StreamExt};
@@ -46,6 +54,8 @@ pub enum TransactionServiceRequest {
     GetPendingInboundTransactions,
     GetPendingOutboundTransactions,
     GetCompletedTransactions,
+    GetCompletedTransactionsPage(CompletedTransactionQuery),
+    GetTransactionChangesSince(u64),
     GetCancelledPendingInboundTransactions,
     GetCancelledPendingOutboundTransactions,
     GetCancelledCompletedTransactions,
@@ -54,13 +64,14 @@ pub enum TransactionServiceRequest {
     SetBaseNodePublicKey(CommsPublicKey),
     SendTransaction(CommsPublicKey, MicroTari, MicroTari, String),
     SendOneSidedTransaction(CommsPublicKey, MicroTari, MicroTari, String),
+    SendTransactions(Vec<(CommsPublicKey, MicroTari, String)>, MicroTari),
     CancelTransaction(TxId),
     ImportUtxo(MicroTari, CommsPublicKey, String, Option<u64>),
     SubmitCoinSplitTransaction(TxId, Transaction, MicroTari, MicroTari, String),
     SetLowPowerMode,
     SetNormalPowerMode,
-    ApplyEncryption(Box<Aes256Gcm>),
-    RemoveEncryption,
+    ApplyEncryption((Box<Aes256Gcm>, EncryptionProgress)),
+    RemoveEncryption(EncryptionProgress),
     GenerateCoinbaseTransaction(MicroTari, MicroTari, u64),
     RestartTransactionProtocols,
     RestartBroadcastProtocols,
@@ -86,6 +97,8 @@ impl fmt::Display for TransactionServiceRequest {
             Self::GetPendingInboundTransactions => f.write_str("GetPendingInboundTransactions"),
             Self::GetPendingOutboundTransactions => f.write_str("GetPendingOutboundTransactions"),
             Self::GetCompletedTransactions => f.write_str("GetCompletedTransactions"),
+            Self::GetCompletedTransactionsPage(q) => f.write_str(&format!("GetCompletedTransactionsPage({:?})", q)),
+            Self::GetTransactionChangesSince(s) => f.write_str(&format!("GetTransactionChangesSince({})", s)),
             Self::GetCancelledPendingInboundTransactions => f.write_str("GetCancelledPendingInboundTransactions"),
             Self::GetCancelledPendingOutboundTransactions => f.write_str("GetCancelledPendingOutboundTransactions"),
             Self::GetCancelledCompletedTransactions => f.write_str("GetCancelledCompletedTransactions"),
@@ -95,6 +108,9 @@ impl fmt::Display for TransactionServiceRequest {
             Self::SendOneSidedTransaction(k, v, _, msg) => {
                 f.write_str(&format!("SendOneSidedTransaction (to {}, {}, {})", k, v, msg))
             },
+            Self::SendTransactions(recipients, _) => {
+                f.write_str(&format!("SendTransactions (to {} recipients)", recipients.len()))
+            },
             Self::CancelTransaction(t) => f.write_str(&format!("CancelTransaction ({})", t)),
             Self::ImportUtxo(v, k, msg, maturity) => f.write_str(&format!(
                 "ImportUtxo (from {}, {}, {} with maturity: {})",
@@ -109,7 +125,7 @@ impl fmt::Display for TransactionServiceRequest {
             Self::SetLowPowerMode => f.write_str("SetLowPowerMode "),
             Self::SetNormalPowerMode => f.write_str("SetNormalPowerMode"),
             Self::ApplyEncryption(_) => f.write_str("ApplyEncryption"),
-            Self::RemoveEncryption => f.write_str("RemoveEncryption"),
+            Self::RemoveEncryption(_) => f.write_str("RemoveEncryption"),
             Self::GenerateCoinbaseTransaction(_, _, bh) => {
                 f.write_str(&format!("GenerateCoinbaseTransaction (Blockheight {})", bh))
             },
@@ -145,10 +161,13 @@ impl fmt::Display for TransactionServiceRequest {
 #[derive(Debug)]
 pub enum TransactionServiceResponse {
     TransactionSent(TxId),
+    TransactionsSent(Vec<TxId>),
     TransactionCancelled,
     PendingInboundTransactions(HashMap<u64, InboundTransaction>),
     PendingOutboundTransactions(HashMap<u64, OutboundTransaction>),
     CompletedTransactions(HashMap<u64, CompletedTransaction>),
+    CompletedTransactionsPage(Vec<CompletedTransaction>),
+    TransactionChanges(Box<TransactionChanges>),
     CompletedTransaction(Box<CompletedTransaction>),
     BaseNodePublicKeySet,
     UtxoImported(TxId),
@@ -271,6 +290,23 @@ impl TransactionServiceHandle {
         }
     }
 
+    /// Send a transaction to each of the `recipients`, given as their public key, the amount to send them and a
+    /// message. Returns the TxId of each recipient's transaction in the order the recipients were given.
+    pub async fn send_transactions(
+        &mut self,
+        recipients: Vec<(CommsPublicKey, MicroTari, String)>,
+        fee_per_gram: MicroTari,
+    ) -> Result<Vec<TxId>, TransactionServiceError> {
+        match self
+            .handle
+            .call(TransactionServiceRequest::SendTransactions(recipients, fee_per_gram))
+            .await??
+        {
+            TransactionServiceResponse::TransactionsSent(tx_ids) => Ok(tx_ids),
+            _ => Err(TransactionServiceError::UnexpectedApiResponse),
+        }
+    }
+
     pub async fn cancel_transaction(&mut self, tx_id: TxId) -> Result<(), TransactionServiceError> {
         match self
             .handle
@@ -347,6 +383,36 @@ impl TransactionServiceHandle {
         }
     }
 
+    /// Retrieve a filtered page of completed transactions, ordered newest first
+    pub async fn get_completed_transactions_page(
+        &mut self,
+        query: CompletedTransactionQuery,
+    ) -> Result<Vec<CompletedTransaction>, TransactionServiceError> {
+        match self
+            .handle
+            .call(TransactionServiceRequest::GetCompletedTransactionsPage(query))
+            .await??
+        {
+            TransactionServiceResponse::CompletedTransactionsPage(c) => Ok(c),
+            _ => Err(TransactionServiceError::UnexpectedApiResponse),
+        }
+    }
+
+    /// Retrieve the transactions that were inserted, updated or cancelled after the given change sequence number
+    pub async fn get_transaction_changes_since(
+        &mut self,
+        sequence: u64,
+    ) -> Result<TransactionChanges, TransactionServiceError> {
+        match self
+            .handle
+            .call(TransactionServiceRequest::GetTransactionChangesSince(sequence))
+            .await??
+        {
+            TransactionServiceResponse::TransactionChanges(c) => Ok(*c),
+            _ => Err(TransactionServiceError::UnexpectedApiResponse),
+        }
+    }
+
     pub async fn get_cancelled_completed_transactions(
         &mut self,
     ) -> Result<HashMap<u64, CompletedTransaction>, TransactionServiceError> {
@@ -463,9 +529,19 @@ impl TransactionServiceHandle {
     }
 
     pub async fn apply_encryption(&mut self, cipher: Aes256Gcm) -> Result<(), TransactionServiceError> {
+        self.apply_encryption_with_progress(cipher, EncryptionProgress::default())
+            .await
+    }
+
+    /// Apply encryption, reporting the number of rows encrypted to `progress`
+    pub async fn apply_encryption_with_progress(
+        &mut self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), TransactionServiceError> {
         match self
             .handle
-            .call(TransactionServiceRequest::ApplyEncryption(Box::new(cipher)))
+            .call(TransactionServiceRequest::ApplyEncryption((Box::new(cipher), progress)))
             .await??
         {
             TransactionServiceResponse::EncryptionApplied => Ok(()),
@@ -474,7 +550,20 @@ impl TransactionServiceHandle {
     }
 
     pub async fn remove_encryption(&mut self) -> Result<(), TransactionServiceError> {
-        match self.handle.call(TransactionServiceRequest::RemoveEncryption).await?? {
+        self.remove_encryption_with_progress(EncryptionProgress::default())
+            .await
+    }
+
+    /// Remove encryption, reporting the number of rows decrypted to `progress`
+    pub async fn remove_encryption_with_progress(
+        &mut self,
+        progress: EncryptionProgress,
+    ) -> Result<(), TransactionServiceError> {
+        match self
+            .handle
+            .call(TransactionServiceRequest::RemoveEncryption(progress))
+            .await??
+        {
             TransactionServiceResponse::EncryptionRemoved => Ok(()),
             _ => Err(TransactionServiceError::UnexpectedApiResponse),
         }
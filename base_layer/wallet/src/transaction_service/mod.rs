@@ -29,6 +29,7 @@ pub mod storage;
 pub mod tasks;
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::handle::OutputManagerHandle,
     transaction_service::{
         config::TransactionServiceConfig,
@@ -192,6 +193,7 @@ where T: TransactionBackend + 'static
             let outbound_message_service = handles.expect_handle::<Dht>().outbound_requester();
             let output_manager_service = handles.expect_handle::<OutputManagerHandle>();
             let connectivity_manager = handles.expect_handle::<ConnectivityRequester>();
+            let wallet_connectivity = handles.expect_handle::<WalletConnectivityHandle>();
 
             let result = TransactionService::new(
                 config,
@@ -205,6 +207,7 @@ where T: TransactionBackend + 'static
                 output_manager_service,
                 outbound_message_service,
                 connectivity_manager,
+                wallet_connectivity,
                 publisher,
                 node_identity,
                 factories,
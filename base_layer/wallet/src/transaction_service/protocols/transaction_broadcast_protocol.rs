@@ -35,7 +35,7 @@ use crate::{
 use futures::{FutureExt, StreamExt};
 use log::*;
 use std::{convert::TryFrom, sync::Arc, time::Duration};
-use tari_comms::{peer_manager::NodeId, types::CommsPublicKey, PeerConnection};
+use tari_comms::{peer_manager::NodeId, protocol::rpc::RpcClientLease, types::CommsPublicKey, PeerConnection};
 use tari_core::{
     base_node::{
         proto::wallet_rpc::{TxLocation, TxQueryResponse, TxSubmissionRejectionReason, TxSubmissionResponse},
@@ -227,18 +227,30 @@ where TBackend: TransactionBackend + 'static
                 return Ok(self.tx_id);
             }
 
-            let mut client = match base_node_connection
-                .connect_rpc_using_builder(
-                    BaseNodeWalletRpcClient::builder()
-                        .with_deadline(self.resources.config.broadcast_monitoring_timeout),
+            // Use a warm session from the wallet connectivity pool if there is one, otherwise connect a session
+            let pooled_client = self
+                .resources
+                .wallet_connectivity
+                .obtain_base_node_wallet_rpc_client(
+                    &base_node_node_id,
+                    self.resources.config.broadcast_monitoring_timeout,
                 )
-                .await
-            {
-                Ok(c) => c,
-                Err(e) => {
-                    warn!(target: LOG_TARGET, "Problem establishing RPC connection: {}", e);
-                    delay.await;
-                    continue;
+                .await;
+            let mut client = match pooled_client {
+                Some(c) => c,
+                None => match base_node_connection
+                    .connect_rpc_using_builder(
+                        BaseNodeWalletRpcClient::builder()
+                            .with_deadline(self.resources.config.broadcast_monitoring_timeout),
+                    )
+                    .await
+                {
+                    Ok(c) => RpcClientLease::from(c),
+                    Err(e) => {
+                        warn!(target: LOG_TARGET, "Problem establishing RPC connection: {}", e);
+                        delay.await;
+                        continue;
+                    },
                 },
             };
 
@@ -31,10 +31,11 @@ use crate::{
         },
     },
     types::ValidationRetryStrategy,
+    util::validation_checkpoint::{get_validation_scope, ValidationCheckpoint, ValidationScope},
 };
 use futures::{FutureExt, StreamExt};
 use log::*;
-use std::{cmp, convert::TryFrom, sync::Arc, time::Duration};
+use std::{cmp, collections::HashMap, convert::TryFrom, sync::Arc, time::Duration};
 use tari_comms::{peer_manager::NodeId, types::CommsPublicKey, PeerConnection};
 use tari_core::{
     base_node::{
@@ -46,6 +47,8 @@ use tari_core::{
 use tokio::{sync::broadcast, time::delay_for};
 
 const LOG_TARGET: &str = "wallet::transaction_service::protocols::validation_protocol";
+/// The name the validation checkpoint of the mined transactions is stored under
+const VALIDATION_CHECKPOINT_NAME: &str = "transactions";
 
 pub struct TransactionValidationProtocol<TBackend>
 where TBackend: TransactionBackend + 'static
@@ -58,6 +61,7 @@ where TBackend: TransactionBackend + 'static
     timeout_update_receiver: Option<broadcast::Receiver<Duration>>,
     retry_strategy: ValidationRetryStrategy,
     base_node_synced: bool,
+    tip: Option<ValidationCheckpoint>,
 }
 
 /// This protocol will check all of the mined transactions (both valid and invalid) in the db to see if they are present
@@ -65,6 +69,9 @@ where TBackend: TransactionBackend + 'static
 /// - If a valid transaction is not present the protocol will mark the transaction as invalid
 /// - If an invalid transaction is present on th ebase node it will be marked as valid
 /// - If a Confirmed mined transaction is present but no longer confirmed its status will change to MinedUnconfirmed
+///
+/// Only the transactions that blocks after the last validated tip could affect are queried, all of the mined
+/// transactions are queried when there is no such tip or the chain has been reorganised since.
 impl<TBackend> TransactionValidationProtocol<TBackend>
 where TBackend: TransactionBackend + 'static
 {
@@ -86,6 +93,7 @@ where TBackend: TransactionBackend + 'static
             timeout_update_receiver: Some(timeout_update_receiver),
             retry_strategy,
             base_node_synced: true,
+            tip: None,
         }
     }
 
@@ -115,10 +123,9 @@ where TBackend: TransactionBackend + 'static
             self.id, total_retries_str
         );
 
-        let mut batches = self
-            .get_transaction_batches()
-            .await
-            .map_err(|e| TransactionServiceProtocolError::new(self.id, e))?;
+        // The transactions are batched once the scope of the validation is known, which needs the tip of the base node
+        let mut scope: Option<ValidationScope> = None;
+        let mut batches = Vec::new();
         let mut retries = 0;
 
         // Main protocol loop
@@ -272,6 +279,74 @@ where TBackend: TransactionBackend + 'static
 
             debug!(target: LOG_TARGET, "RPC client connected");
 
+            if scope.is_none() {
+                let delay = delay_for(self.timeout);
+                match client.get_tip_info().await {
+                    Ok(tip_info) if !tip_info.is_synced => {
+                        self.base_node_synced = false;
+                        info!(target: LOG_TARGET, "Base Node reports not being synced, will retry.");
+                        let _ = self
+                            .resources
+                            .event_publisher
+                            .send(Arc::new(TransactionEvent::TransactionValidationDelayed(self.id)))
+                            .map_err(|e| {
+                                trace!(
+                                    target: LOG_TARGET,
+                                    "Error sending event because there are no subscribers: {:?}",
+                                    e
+                                );
+                                e
+                            });
+                        delay.await;
+                        retries += 1;
+                        continue;
+                    },
+                    Ok(tip_info) => {
+                        self.tip = ValidationCheckpoint::from_tip_info(&tip_info);
+                    },
+                    Err(e) => {
+                        warn!(target: LOG_TARGET, "Error with RPC Client: {}. Retrying RPC client connection.", e);
+                        let _ = self
+                            .resources
+                            .event_publisher
+                            .send(Arc::new(TransactionEvent::TransactionValidationTimedOut(self.id)))
+                            .map_err(|e| {
+                                trace!(
+                                    target: LOG_TARGET,
+                                    "Error sending event {:?}, because there are no subscribers.",
+                                    e.0
+                                );
+                                e
+                            });
+                        delay.await;
+                        retries += 1;
+                        continue;
+                    },
+                }
+                let checkpoint = self
+                    .resources
+                    .db
+                    .fetch_validation_checkpoint(VALIDATION_CHECKPOINT_NAME)
+                    .await
+                    .map_err(|e| TransactionServiceProtocolError::new(self.id, e.into()))?;
+                let validation_scope = get_validation_scope(
+                    &mut base_node_connection,
+                    checkpoint.as_ref(),
+                    self.tip.as_ref(),
+                    self.timeout,
+                )
+                .await;
+                debug!(
+                    target: LOG_TARGET,
+                    "Transaction Validation Protocol (Id: {}) scope is {:?}", self.id, validation_scope
+                );
+                batches = self
+                    .get_transaction_batches(validation_scope)
+                    .await
+                    .map_err(|e| TransactionServiceProtocolError::new(self.id, e))?;
+                scope = Some(validation_scope);
+            }
+
             'per_tx: loop {
                 let batch = if let Some(b) = batches.pop() {
                     b
@@ -328,7 +403,8 @@ where TBackend: TransactionBackend + 'static
                                         });
                                     delay.await;
                                     retries += 1;
-                                    batches = self.get_transaction_batches().await.map_err(|e| TransactionServiceProtocolError::new(self.id, e))?;
+                                    // The tip is checked again once the base node is synced
+                                    scope = None;
                                     break 'per_tx;
                                 }
                             },
@@ -395,6 +471,17 @@ where TBackend: TransactionBackend + 'static
             }
         }
 
+        if let Some(tip) = self.tip.clone() {
+            if let Err(e) = self
+                .resources
+                .db
+                .set_validation_checkpoint(VALIDATION_CHECKPOINT_NAME, tip)
+                .await
+            {
+                warn!(target: LOG_TARGET, "Could not store the transaction validation checkpoint: {}", e);
+            }
+        }
+
         let _ = self
             .resources
             .event_publisher
@@ -547,11 +634,24 @@ where TBackend: TransactionBackend + 'static
                 );
             }
         }
+        if let Some(tip) = self.tip.as_ref() {
+            self.resources
+                .db
+                .set_transactions_validated_height(batch.iter().map(|tx| tx.tx_id).collect(), tip.height)
+                .await?;
+        }
         Ok(true)
     }
 
-    /// Get completed transactions from db and sort the mined transactions into batches
-    async fn get_transaction_batches(&self) -> Result<Vec<Vec<CompletedTransaction>>, TransactionServiceError> {
+    /// Get completed transactions from db and sort the mined transactions that fall in the scope into batches
+    async fn get_transaction_batches(
+        &self,
+        scope: ValidationScope,
+    ) -> Result<Vec<Vec<CompletedTransaction>>, TransactionServiceError> {
+        let validated_heights = match scope {
+            ValidationScope::Full => HashMap::new(),
+            _ => self.resources.db.fetch_validated_heights().await?,
+        };
         let mut completed_txs: Vec<CompletedTransaction> = self
             .resources
             .db
@@ -561,6 +661,16 @@ where TBackend: TransactionBackend + 'static
             .filter(|tx| {
                 tx.status == TransactionStatus::MinedUnconfirmed || tx.status == TransactionStatus::MinedConfirmed
             })
+            .filter(|tx| match scope {
+                ValidationScope::Full => true,
+                // Only confirmed valid transactions are final, the others can change with every new block
+                ValidationScope::NonFinal => {
+                    !validated_heights.contains_key(&tx.tx_id) ||
+                        tx.status == TransactionStatus::MinedUnconfirmed ||
+                        !tx.valid
+                },
+                ValidationScope::Unvalidated => !validated_heights.contains_key(&tx.tx_id),
+            })
             .cloned()
             .collect();
         // Determine how many rounds of base node request we need to query all the transactions in batches of
@@ -21,6 +21,7 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::{handle::OutputManagerHandle, TxId},
     transaction_service::{
         config::TransactionServiceConfig,
@@ -81,6 +82,7 @@ use tari_core::{
         },
         types::{CryptoFactories, PrivateKey},
         ReceiverTransactionProtocol,
+        SenderTransactionProtocol,
     },
 };
 use tari_crypto::{keys::DiffieHellmanSharedSecret, script, tari_utilities::ByteArray};
@@ -166,6 +168,7 @@ where
         output_manager_service: OutputManagerHandle,
         outbound_message_service: OutboundMessageRequester,
         connectivity_manager: ConnectivityRequester,
+        wallet_connectivity: WalletConnectivityHandle,
         event_publisher: TransactionEventSender,
         node_identity: Arc<NodeIdentity>,
         factories: CryptoFactories,
@@ -178,6 +181,7 @@ where
             output_manager_service: output_manager_service.clone(),
             outbound_message_service,
             connectivity_manager,
+            wallet_connectivity,
             event_publisher: event_publisher.clone(),
             node_identity: node_identity.clone(),
             factories,
@@ -534,6 +538,15 @@ where
                 )
                 .await
                 .map(TransactionServiceResponse::TransactionSent),
+            TransactionServiceRequest::SendTransactions(recipients, fee_per_gram) => self
+                .send_transactions(
+                    recipients,
+                    fee_per_gram,
+                    send_transaction_join_handles,
+                    transaction_broadcast_join_handles,
+                )
+                .await
+                .map(TransactionServiceResponse::TransactionsSent),
             TransactionServiceRequest::CancelTransaction(tx_id) => self
                 .cancel_pending_transaction(tx_id)
                 .await
@@ -552,6 +565,16 @@ where
             TransactionServiceRequest::GetCompletedTransactions => Ok(
                 TransactionServiceResponse::CompletedTransactions(self.db.get_completed_transactions().await?),
             ),
+            TransactionServiceRequest::GetCompletedTransactionsPage(query) => {
+                Ok(TransactionServiceResponse::CompletedTransactionsPage(
+                    self.db.get_completed_transactions_page(query).await?,
+                ))
+            },
+            TransactionServiceRequest::GetTransactionChangesSince(sequence) => {
+                Ok(TransactionServiceResponse::TransactionChanges(Box::new(
+                    self.db.get_transaction_changes_since(sequence).await?,
+                )))
+            },
             TransactionServiceRequest::GetCancelledPendingInboundTransactions => {
                 Ok(TransactionServiceResponse::PendingInboundTransactions(
                     self.db.get_cancelled_pending_inbound_transactions().await?,
@@ -626,15 +649,15 @@ where
                 self.set_power_mode(PowerMode::Normal).await?;
                 Ok(TransactionServiceResponse::NormalPowerModeSet)
             },
-            TransactionServiceRequest::ApplyEncryption(cipher) => self
+            TransactionServiceRequest::ApplyEncryption((cipher, progress)) => self
                 .db
-                .apply_encryption(*cipher)
+                .apply_encryption(*cipher, progress)
                 .await
                 .map(|_| TransactionServiceResponse::EncryptionApplied)
                 .map_err(TransactionServiceError::TransactionStorageError),
-            TransactionServiceRequest::RemoveEncryption => self
+            TransactionServiceRequest::RemoveEncryption(progress) => self
                 .db
-                .remove_encryption()
+                .remove_encryption(progress)
                 .await
                 .map(|_| TransactionServiceResponse::EncryptionRemoved)
                 .map_err(TransactionServiceError::TransactionStorageError),
@@ -695,26 +718,13 @@ where
                 .create_pay_to_self_transaction(amount, fee_per_gram, None, message.clone())
                 .await?;
 
-            // Notify that the transaction was successfully resolved.
-            let _ = self
-                .event_publisher
-                .send(Arc::new(TransactionEvent::TransactionCompletedImmediately(tx_id)));
-
-            self.submit_transaction(
+            self.submit_pay_to_self_transaction(
+                tx_id,
+                amount,
+                fee,
+                transaction,
+                message,
                 transaction_broadcast_join_handles,
-                CompletedTransaction::new(
-                    tx_id,
-                    self.node_identity.public_key().clone(),
-                    self.node_identity.public_key().clone(),
-                    amount,
-                    fee,
-                    transaction,
-                    TransactionStatus::Completed,
-                    message,
-                    Utc::now().naive_utc(),
-                    TransactionDirection::Inbound,
-                    None,
-                ),
             )
             .await?;
 
@@ -726,6 +736,144 @@ where
             .prepare_transaction_to_send(amount, fee_per_gram, None, message.clone(), script!(Nop))
             .await?;
 
+        self.spawn_transaction_send_protocol(dest_pubkey, amount, message, sender_protocol, join_handles)
+    }
+
+    /// Sends a separate transaction to each of several recipients, negotiating them concurrently
+    /// # Arguments
+    /// 'recipients': The Comms pubkey of each recipient node, the amount of Tari to send to them and a message
+    /// 'fee_per_gram': The amount of fee per transaction gram to be included in each transaction
+    ///
+    /// Each recipient gets its own transaction, with its own inputs, change output and fee, as the transaction protocol
+    /// supports one recipient, so this saves no fees over sending the transactions one at a time. Every transaction is
+    /// prepared, with its inputs encumbered, before any of them is sent, so if one cannot be prepared the inputs of the
+    /// others are released and nothing is sent. The negotiations with the recipients then run concurrently. Returns
+    /// the TxId of each recipient's transaction in the order the recipients were given.
+    pub async fn send_transactions(
+        &mut self,
+        recipients: Vec<(CommsPublicKey, MicroTari, String)>,
+        fee_per_gram: MicroTari,
+        join_handles: &mut FuturesUnordered<JoinHandle<Result<u64, TransactionServiceProtocolError>>>,
+        transaction_broadcast_join_handles: &mut FuturesUnordered<
+            JoinHandle<Result<u64, TransactionServiceProtocolError>>,
+        >,
+    ) -> Result<Vec<TxId>, TransactionServiceError> {
+        let num_recipients = recipients.len();
+        let (self_payments, payments): (Vec<_>, Vec<_>) = recipients
+            .into_iter()
+            .enumerate()
+            .partition(|(_, (dest_pubkey, _, _))| self.node_identity.public_key() == dest_pubkey);
+
+        let sender_protocols = if payments.is_empty() {
+            Vec::new()
+        } else {
+            self.output_manager_service
+                .prepare_transactions_to_send(
+                    payments
+                        .iter()
+                        .map(|(_, (_, amount, message))| (*amount, message.clone()))
+                        .collect(),
+                    fee_per_gram,
+                    None,
+                )
+                .await?
+        };
+        let mut prepared_tx_ids = sender_protocols
+            .iter()
+            .map(|stp| stp.get_tx_id())
+            .collect::<Result<Vec<_>, _>>()?;
+
+        // Payments to ourselves are completed immediately rather than negotiated
+        let mut self_transactions = Vec::with_capacity(self_payments.len());
+        for (i, (_, amount, message)) in self_payments {
+            match self
+                .output_manager_service
+                .create_pay_to_self_transaction(amount, fee_per_gram, None, message.clone())
+                .await
+            {
+                Ok((tx_id, fee, transaction)) => {
+                    prepared_tx_ids.push(tx_id);
+                    self_transactions.push((i, amount, message, tx_id, fee, transaction));
+                },
+                Err(e) => {
+                    for tx_id in prepared_tx_ids {
+                        self.output_manager_service.cancel_transaction(tx_id).await?;
+                    }
+                    return Err(e.into());
+                },
+            }
+        }
+        debug!(
+            target: LOG_TARGET,
+            "Prepared {} transactions to send concurrently",
+            prepared_tx_ids.len()
+        );
+
+        let mut tx_ids = vec![0; num_recipients];
+        for ((i, (dest_pubkey, amount, message)), sender_protocol) in payments.into_iter().zip(sender_protocols) {
+            tx_ids[i] =
+                self.spawn_transaction_send_protocol(dest_pubkey, amount, message, sender_protocol, join_handles)?;
+        }
+        for (i, amount, message, tx_id, fee, transaction) in self_transactions {
+            self.submit_pay_to_self_transaction(
+                tx_id,
+                amount,
+                fee,
+                transaction,
+                message,
+                transaction_broadcast_join_handles,
+            )
+            .await?;
+            tx_ids[i] = tx_id;
+        }
+        Ok(tx_ids)
+    }
+
+    /// Submit a completed transaction that pays ourselves for broadcast
+    async fn submit_pay_to_self_transaction(
+        &mut self,
+        tx_id: TxId,
+        amount: MicroTari,
+        fee: MicroTari,
+        transaction: Transaction,
+        message: String,
+        transaction_broadcast_join_handles: &mut FuturesUnordered<
+            JoinHandle<Result<u64, TransactionServiceProtocolError>>,
+        >,
+    ) -> Result<(), TransactionServiceError> {
+        // Notify that the transaction was successfully resolved.
+        let _ = self
+            .event_publisher
+            .send(Arc::new(TransactionEvent::TransactionCompletedImmediately(tx_id)));
+
+        self.submit_transaction(
+            transaction_broadcast_join_handles,
+            CompletedTransaction::new(
+                tx_id,
+                self.node_identity.public_key().clone(),
+                self.node_identity.public_key().clone(),
+                amount,
+                fee,
+                transaction,
+                TransactionStatus::Completed,
+                message,
+                Utc::now().naive_utc(),
+                TransactionDirection::Inbound,
+                None,
+            ),
+        )
+        .await
+    }
+
+    /// Start the protocol that negotiates a prepared transaction with its recipient
+    fn spawn_transaction_send_protocol(
+        &mut self,
+        dest_pubkey: CommsPublicKey,
+        amount: MicroTari,
+        message: String,
+        sender_protocol: SenderTransactionProtocol,
+        join_handles: &mut FuturesUnordered<JoinHandle<Result<u64, TransactionServiceProtocolError>>>,
+    ) -> Result<TxId, TransactionServiceError> {
         let tx_id = sender_protocol.get_tx_id()?;
 
         let (tx_reply_sender, tx_reply_receiver) = mpsc::channel(100);
@@ -2114,6 +2262,7 @@ where
                 storage::{database::OutputManagerDatabase, sqlite_db::OutputManagerSqliteDatabase},
             },
             storage::sqlite_utilities::run_migration_and_create_sqlite_connection,
+            test_utils::make_wallet_connectivity_mock,
             transaction_service::{handle::TransactionServiceHandle, storage::models::InboundTransaction},
         };
         use tari_comms::types::CommsSecretKey;
@@ -2159,6 +2308,7 @@ where
             shutdown_signal,
             basenode_service_handle,
             connectivity_manager,
+            make_wallet_connectivity_mock(),
             CommsSecretKey::default(),
         )
         .await?;
@@ -2289,6 +2439,7 @@ where TBackend: TransactionBackend + 'static
     pub output_manager_service: OutputManagerHandle,
     pub outbound_message_service: OutboundMessageRequester,
     pub connectivity_manager: ConnectivityRequester,
+    pub wallet_connectivity: WalletConnectivityHandle,
     pub event_publisher: TransactionEventSender,
     pub node_identity: Arc<NodeIdentity>,
     pub factories: CryptoFactories,
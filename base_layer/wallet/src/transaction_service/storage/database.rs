@@ -26,12 +26,15 @@ use crate::{
         error::TransactionStorageError,
         storage::models::{
             CompletedTransaction,
+            CompletedTransactionQuery,
             InboundTransaction,
             OutboundTransaction,
+            TransactionChanges,
             TransactionDirection,
             TransactionStatus,
         },
     },
+    util::{encryption::EncryptionProgress, validation_checkpoint::ValidationCheckpoint},
 };
 use aes_gcm::Aes256Gcm;
 #[cfg(feature = "test_harness")]
@@ -61,6 +64,13 @@ pub trait TransactionBackend: Send + Sync + Clone {
     fn contains(&self, key: &DbKey) -> Result<bool, TransactionStorageError>;
     /// Modify the state the of the backend with a write operation
     fn write(&self, op: WriteOperation) -> Result<Option<DbValue>, TransactionStorageError>;
+    /// Retrieve a filtered page of completed transactions, newest first, as described by the provided query
+    fn fetch_completed_transactions_page(
+        &self,
+        query: &CompletedTransactionQuery,
+    ) -> Result<Vec<CompletedTransaction>, TransactionStorageError>;
+    /// Retrieve the transactions of all collections that changed after the given change sequence number
+    fn fetch_transaction_changes_since(&self, sequence: u64) -> Result<TransactionChanges, TransactionStorageError>;
     /// Check if a transaction exists in any of the collections
     fn transaction_exists(&self, tx_id: TxId) -> Result<bool, TransactionStorageError>;
     /// Complete outbound transaction, this operation must delete the `OutboundTransaction` with the provided
@@ -114,16 +124,30 @@ pub trait TransactionBackend: Send + Sync + Clone {
         tx_id: TxId,
         timestamp: NaiveDateTime,
     ) -> Result<(), TransactionStorageError>;
-    /// Apply encryption to the backend.
-    fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), TransactionStorageError>;
-    /// Remove encryption from the backend.
-    fn remove_encryption(&self) -> Result<(), TransactionStorageError>;
+    /// Apply encryption to the backend. The rows are encrypted in batches and an interrupted pass is continued by
+    /// calling this again with the same cipher.
+    fn apply_encryption(&self, cipher: Aes256Gcm, progress: EncryptionProgress) -> Result<(), TransactionStorageError>;
+    /// Remove encryption from the backend. The rows are decrypted in batches and an interrupted pass is continued by
+    /// calling this again.
+    fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), TransactionStorageError>;
     /// Increment the send counter and timestamp of a transaction
     fn increment_send_count(&self, tx_id: TxId) -> Result<(), TransactionStorageError>;
     /// Update a transactions number of confirmations
     fn update_confirmations(&self, tx_id: TxId, confirmations: u64) -> Result<(), TransactionStorageError>;
     /// Update a transactions mined height
     fn update_mined_height(&self, tx_id: TxId, mined_height: u64) -> Result<(), TransactionStorageError>;
+    /// Record the chain height at which the given completed transactions were confirmed by a validation
+    fn set_transactions_validated_height(&self, tx_ids: &[TxId], height: u64) -> Result<(), TransactionStorageError>;
+    /// Retrieve the chain height at which each validated completed transaction was last confirmed
+    fn fetch_validated_heights(&self) -> Result<HashMap<TxId, u64>, TransactionStorageError>;
+    /// Retrieve the chain tip that the named set of transactions was last validated against
+    fn fetch_validation_checkpoint(&self, name: &str) -> Result<Option<ValidationCheckpoint>, TransactionStorageError>;
+    /// Record the chain tip that the named set of transactions has been validated against
+    fn set_validation_checkpoint(
+        &self,
+        name: &str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), TransactionStorageError>;
 }
 
 #[derive(Debug, Clone, PartialEq)]
@@ -525,6 +549,30 @@ where T: TransactionBackend + 'static
         Ok(t)
     }
 
+    /// Retrieve a filtered page of completed transactions. The filtering, ordering and limit are applied by the
+    /// backend so only the requested page is loaded.
+    pub async fn get_completed_transactions_page(
+        &self,
+        query: CompletedTransactionQuery,
+    ) -> Result<Vec<CompletedTransaction>, TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_completed_transactions_page(&query))
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn get_transaction_changes_since(
+        &self,
+        sequence: u64,
+    ) -> Result<TransactionChanges, TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_transaction_changes_since(sequence))
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
     /// This method moves a `PendingOutboundTransaction` to the `CompleteTransaction` collection.
     pub async fn complete_outbound_transaction(
         &self,
@@ -663,17 +711,21 @@ where T: TransactionBackend + 'static
             .and_then(|inner_result| inner_result)
     }
 
-    pub async fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), TransactionStorageError> {
+    pub async fn apply_encryption(
+        &self,
+        cipher: Aes256Gcm,
+        progress: EncryptionProgress,
+    ) -> Result<(), TransactionStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.apply_encryption(cipher))
+        tokio::task::spawn_blocking(move || db_clone.apply_encryption(cipher, progress))
             .await
             .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
             .and_then(|inner_result| inner_result)
     }
 
-    pub async fn remove_encryption(&self) -> Result<(), TransactionStorageError> {
+    pub async fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), TransactionStorageError> {
         let db_clone = self.db.clone();
-        tokio::task::spawn_blocking(move || db_clone.remove_encryption())
+        tokio::task::spawn_blocking(move || db_clone.remove_encryption(progress))
             .await
             .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
             .and_then(|inner_result| inner_result)
@@ -738,6 +790,49 @@ where T: TransactionBackend + 'static
             .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))??;
         Ok(())
     }
+
+    pub async fn set_transactions_validated_height(
+        &self,
+        tx_ids: Vec<TxId>,
+        height: u64,
+    ) -> Result<(), TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.set_transactions_validated_height(&tx_ids, height))
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        Ok(())
+    }
+
+    pub async fn fetch_validated_heights(&self) -> Result<HashMap<TxId, u64>, TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_validated_heights())
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn fetch_validation_checkpoint(
+        &self,
+        name: &'static str,
+    ) -> Result<Option<ValidationCheckpoint>, TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.fetch_validation_checkpoint(name))
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))
+            .and_then(|inner_result| inner_result)
+    }
+
+    pub async fn set_validation_checkpoint(
+        &self,
+        name: &'static str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), TransactionStorageError> {
+        let db_clone = self.db.clone();
+        tokio::task::spawn_blocking(move || db_clone.set_validation_checkpoint(name, checkpoint))
+            .await
+            .map_err(|err| TransactionStorageError::BlockingTaskSpawnError(err.to_string()))??;
+        Ok(())
+    }
 }
 
 impl Display for DbKey {
@@ -273,6 +273,38 @@ impl Display for TransactionDirection {
     }
 }
 
+/// Filter and pagination parameters for retrieving a page of completed transactions from the backend. Results are
+/// ordered newest first by timestamp, with the `tx_id` used as a tie breaker.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct CompletedTransactionQuery {
+    /// Only return transactions with one of these statuses, an empty list matches all statuses
+    pub statuses: Vec<TransactionStatus>,
+    /// Only return transactions in this direction
+    pub direction: Option<TransactionDirection>,
+    /// Only return transactions with a timestamp at or after this time
+    pub from_timestamp: Option<NaiveDateTime>,
+    /// Only return transactions with a timestamp before this time
+    pub to_timestamp: Option<NaiveDateTime>,
+    /// Query the cancelled transactions instead of the active ones
+    pub cancelled: bool,
+    /// The `tx_id` of the last transaction of the previous page, the page will start with the next older transaction
+    pub cursor: Option<TxId>,
+    /// The maximum number of transactions to return
+    pub limit: Option<u64>,
+}
+
+/// The transactions that were inserted, updated or cancelled after a given change sequence number. A pending
+/// transaction that has since been completed shows up in `completed` under the same `tx_id`. Pending transactions that
+/// were removed outright are not reported.
+#[derive(Debug, Clone, Default)]
+pub struct TransactionChanges {
+    /// The sequence number of the most recent change, pass this in to fetch the next set of changes
+    pub latest_sequence: u64,
+    pub pending_inbound: Vec<InboundTransaction>,
+    pub pending_outbound: Vec<OutboundTransaction>,
+    pub completed: Vec<CompletedTransaction>,
+}
+
 impl From<CompletedTransaction> for InboundTransaction {
     fn from(ct: CompletedTransaction) -> Self {
         Self {
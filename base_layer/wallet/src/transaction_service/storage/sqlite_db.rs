@@ -22,23 +22,40 @@
 
 use crate::{
     output_manager_service::TxId,
-    schema::{completed_transactions, inbound_transactions, outbound_transactions},
-    storage::sqlite_utilities::WalletDbConnection,
+    schema::{completed_transactions, inbound_transactions, outbound_transactions, transaction_change_sequence},
+    storage::sqlite_utilities::{
+        run_encryption_pass,
+        EncryptionProgressSql,
+        ValidationCheckpointSql,
+        WalletDbConnection,
+        WalletDbConnectionGuard,
+    },
     transaction_service::{
         error::TransactionStorageError,
         storage::{
             database::{DbKey, DbKeyValuePair, DbValue, TransactionBackend, WriteOperation},
             models::{
                 CompletedTransaction,
+                CompletedTransactionQuery,
                 InboundTransaction,
                 OutboundTransaction,
+                TransactionChanges,
                 TransactionDirection,
                 TransactionStatus,
                 WalletTransaction,
             },
         },
     },
-    util::encryption::{decrypt_bytes_integral_nonce, encrypt_bytes_integral_nonce, Encryptable},
+    util::{
+        encryption::{
+            decrypt_bytes_integral_nonce_in_place,
+            encrypt_bytes_integral_nonce_in_place,
+            Encryptable,
+            EncryptionProgress,
+            ENCRYPTION_BATCH_SIZE,
+        },
+        validation_checkpoint::ValidationCheckpoint,
+    },
 };
 use aes_gcm::{self, aead::Error as AeadError, Aes256Gcm};
 use chrono::{NaiveDateTime, Utc};
@@ -47,8 +64,7 @@ use log::*;
 use std::{
     collections::HashMap,
     convert::TryFrom,
-    str::from_utf8,
-    sync::{Arc, MutexGuard, RwLock},
+    sync::{Arc, RwLock},
 };
 use tari_comms::types::CommsPublicKey;
 use tari_core::transactions::{tari_amount::MicroTari, types::PublicKey};
@@ -58,6 +74,18 @@ use tari_crypto::tari_utilities::{
 };
 
 const LOG_TARGET: &str = "wallet::transaction_service::database::sqlite_db";
+/// The most tx_ids that are bound into a single `IN` clause
+const MAX_TX_IDS_PER_QUERY: usize = 500;
+
+const INBOUND_TRANSACTIONS_TABLE: &str = "inbound_transactions";
+const OUTBOUND_TRANSACTIONS_TABLE: &str = "outbound_transactions";
+const COMPLETED_TRANSACTIONS_TABLE: &str = "completed_transactions";
+/// The tables holding encrypted fields, in the order they are processed by an encryption pass
+pub(crate) const ENCRYPTED_TABLES: [&str; 3] = [
+    INBOUND_TRANSACTIONS_TABLE,
+    OUTBOUND_TRANSACTIONS_TABLE,
+    COMPLETED_TRANSACTIONS_TABLE,
+];
 
 /// A Sqlite backend for the Transaction Service. The Backend is accessed via a connection pool to the Sqlite file.
 #[derive(Clone)]
@@ -74,7 +102,114 @@ impl TransactionServiceSqliteDatabase {
         }
     }
 
-    fn insert(&self, kvp: DbKeyValuePair, conn: MutexGuard<SqliteConnection>) -> Result<(), TransactionStorageError> {
+    /// Finish a pass that applied or removed encryption and was interrupted, so that every transaction can be read with
+    /// the cipher the backend holds afterwards. This must be called before anything is read from the backend.
+    pub fn complete_interrupted_encryption(&self) -> Result<(), TransactionStorageError> {
+        let mut current_cipher = acquire_write_lock!(self.cipher);
+        let cipher = match (*current_cipher).clone() {
+            Some(cipher) => cipher,
+            None => return Ok(()),
+        };
+        let conn = self.database_connection.acquire_lock();
+
+        if EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, true, &conn)? {
+            info!(target: LOG_TARGET, "Completing an interrupted pass applying encryption");
+            self.run_encryption_passes(&cipher, true, &EncryptionProgress::default(), &conn)?;
+        }
+        if EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, false, &conn)? {
+            info!(target: LOG_TARGET, "Completing an interrupted pass removing encryption");
+            self.run_encryption_passes(&cipher, false, &EncryptionProgress::default(), &conn)?;
+            let _ = (*current_cipher).take();
+        }
+
+        Ok(())
+    }
+
+    /// Encrypt or decrypt, in batches, the tables that have an encryption pass in progress. Each batch is committed
+    /// with the position it reached so that an interrupted pass can be continued.
+    fn run_encryption_passes(
+        &self,
+        cipher: &Aes256Gcm,
+        encrypting: bool,
+        progress: &EncryptionProgress,
+        conn: &SqliteConnection,
+    ) -> Result<(), TransactionStorageError> {
+        let mut remaining = 0;
+        if let Some(p) = EncryptionProgressSql::get(INBOUND_TRANSACTIONS_TABLE, conn)? {
+            remaining += InboundTransactionSql::count_after_tx_id(p.last_id, conn)? as u64;
+        }
+        if let Some(p) = EncryptionProgressSql::get(OUTBOUND_TRANSACTIONS_TABLE, conn)? {
+            remaining += OutboundTransactionSql::count_after_tx_id(p.last_id, conn)? as u64;
+        }
+        if let Some(p) = EncryptionProgressSql::get(COMPLETED_TRANSACTIONS_TABLE, conn)? {
+            remaining += CompletedTransactionSql::count_after_tx_id(p.last_id, conn)? as u64;
+        }
+        progress.add_total(remaining);
+
+        let aead_error = |_| {
+            if encrypting {
+                TransactionStorageError::AeadError("Encryption Error".to_string())
+            } else {
+                TransactionStorageError::AeadError("Decryption Error".to_string())
+            }
+        };
+
+        run_encryption_pass(
+            conn,
+            INBOUND_TRANSACTIONS_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| {
+                Ok(
+                    InboundTransactionSql::index_after_tx_id(last_id, ENCRYPTION_BATCH_SIZE, conn)?
+                        .into_iter()
+                        .map(|tx| (tx.tx_id, tx))
+                        .collect(),
+                )
+            },
+            |tx: &InboundTransactionSql, conn| tx.update_encryption(conn),
+            &aead_error,
+        )?;
+
+        run_encryption_pass(
+            conn,
+            OUTBOUND_TRANSACTIONS_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| {
+                Ok(
+                    OutboundTransactionSql::index_after_tx_id(last_id, ENCRYPTION_BATCH_SIZE, conn)?
+                        .into_iter()
+                        .map(|tx| (tx.tx_id, tx))
+                        .collect(),
+                )
+            },
+            |tx: &OutboundTransactionSql, conn| tx.update_encryption(conn),
+            &aead_error,
+        )?;
+
+        run_encryption_pass(
+            conn,
+            COMPLETED_TRANSACTIONS_TABLE,
+            encrypting,
+            cipher,
+            progress,
+            |last_id, conn| {
+                Ok(
+                    CompletedTransactionSql::index_after_tx_id(last_id, ENCRYPTION_BATCH_SIZE, conn)?
+                        .into_iter()
+                        .map(|tx| (tx.tx_id, tx))
+                        .collect(),
+                )
+            },
+            |tx: &CompletedTransactionSql, conn| tx.update_encryption(conn),
+            &aead_error,
+        )
+    }
+
+    fn insert(&self, kvp: DbKeyValuePair, conn: WalletDbConnectionGuard) -> Result<(), TransactionStorageError> {
         match kvp {
             DbKeyValuePair::PendingOutboundTransaction(k, v) => {
                 if OutboundTransactionSql::find_by_cancelled(k, false, &(*conn)).is_ok() {
@@ -109,7 +244,7 @@ impl TransactionServiceSqliteDatabase {
     fn remove(
         &self,
         key: DbKey,
-        conn: MutexGuard<SqliteConnection>,
+        conn: WalletDbConnectionGuard,
     ) -> Result<Option<DbValue>, TransactionStorageError> {
         match key {
             DbKey::PendingOutboundTransaction(k) => match OutboundTransactionSql::find_by_cancelled(k, false, &(*conn))
@@ -412,6 +547,61 @@ impl TransactionBackend for TransactionServiceSqliteDatabase {
         }
     }
 
+    fn fetch_completed_transactions_page(
+        &self,
+        query: &CompletedTransactionQuery,
+    ) -> Result<Vec<CompletedTransaction>, TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+
+        let page = match CompletedTransactionSql::index_by_query(query, &(*conn)) {
+            Ok(page) => page,
+            Err(TransactionStorageError::DieselError(DieselError::NotFound)) => {
+                return Err(TransactionStorageError::ValueNotFound(DbKey::CompletedTransaction(
+                    query.cursor.unwrap_or_default(),
+                )))
+            },
+            Err(e) => return Err(e),
+        };
+
+        let mut result = Vec::with_capacity(page.len());
+        for mut c in page.into_iter() {
+            self.decrypt_if_necessary(&mut c)?;
+            result.push(CompletedTransaction::try_from(c)?);
+        }
+
+        Ok(result)
+    }
+
+    fn fetch_transaction_changes_since(&self, sequence: u64) -> Result<TransactionChanges, TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+
+        // The sequence counter and the changed rows are read under the same connection lock so that no write can land
+        // between them, which would otherwise be skipped by the client's next request.
+        let latest_sequence = transaction_change_sequence::table
+            .select(transaction_change_sequence::seq)
+            .first::<i64>(&(*conn))?;
+        let since = sequence as i64;
+
+        let mut changes = TransactionChanges {
+            latest_sequence: latest_sequence as u64,
+            ..Default::default()
+        };
+        for mut i in InboundTransactionSql::index_changed_since(since, &(*conn))?.into_iter() {
+            self.decrypt_if_necessary(&mut i)?;
+            changes.pending_inbound.push(InboundTransaction::try_from(i)?);
+        }
+        for mut o in OutboundTransactionSql::index_changed_since(since, &(*conn))?.into_iter() {
+            self.decrypt_if_necessary(&mut o)?;
+            changes.pending_outbound.push(OutboundTransaction::try_from(o)?);
+        }
+        for mut c in CompletedTransactionSql::index_changed_since(since, &(*conn))?.into_iter() {
+            self.decrypt_if_necessary(&mut c)?;
+            changes.completed.push(CompletedTransaction::try_from(c)?);
+        }
+
+        Ok(changes)
+    }
+
     fn transaction_exists(&self, tx_id: u64) -> Result<bool, TransactionStorageError> {
         let conn = self.database_connection.acquire_lock();
 
@@ -664,69 +854,46 @@ impl TransactionBackend for TransactionServiceSqliteDatabase {
         Ok(())
     }
 
-    fn apply_encryption(&self, cipher: Aes256Gcm) -> Result<(), TransactionStorageError> {
+    fn apply_encryption(&self, cipher: Aes256Gcm, progress: EncryptionProgress) -> Result<(), TransactionStorageError> {
         let mut current_cipher = acquire_write_lock!(self.cipher);
+        let conn = self.database_connection.acquire_lock();
 
-        if (*current_cipher).is_some() {
+        // An interrupted pass is continued with the cipher the wallet was opened with
+        let resuming = EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, true, &conn)?;
+        if (*current_cipher).is_some() && !resuming {
             return Err(TransactionStorageError::AlreadyEncrypted);
         }
 
-        let conn = self.database_connection.acquire_lock();
-
-        let mut inbound_txs = InboundTransactionSql::index(&conn)?;
-        // If the db is already encrypted then the very first output we try to encrypt will fail.
-        for tx in inbound_txs.iter_mut() {
-            // Test if this transaction is encrypted or not to avoid a double encryption.
-            let _ = InboundTransaction::try_from(tx.clone()).map_err(|_| {
+        if !resuming {
+            // Test if the first transaction of each table is encrypted or not to avoid a double encryption
+            let already_encrypted = |_| {
                 error!(
                     target: LOG_TARGET,
-                    "Could not convert Inbound Transaction from database version, it might already be encrypted"
+                    "Could not convert Transaction from database version, it might already be encrypted"
                 );
                 TransactionStorageError::AlreadyEncrypted
-            })?;
-            tx.encrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Encryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
-        }
+            };
+            if let Some(tx) = InboundTransactionSql::index_after_tx_id(i64::MIN, 1, &conn)?.pop() {
+                let _ = InboundTransaction::try_from(tx).map_err(already_encrypted)?;
+            }
+            if let Some(tx) = OutboundTransactionSql::index_after_tx_id(i64::MIN, 1, &conn)?.pop() {
+                let _ = OutboundTransaction::try_from(tx).map_err(already_encrypted)?;
+            }
+            if let Some(tx) = CompletedTransactionSql::index_after_tx_id(i64::MIN, 1, &conn)?.pop() {
+                let _ = CompletedTransaction::try_from(tx).map_err(already_encrypted)?;
+            }
 
-        let mut outbound_txs = OutboundTransactionSql::index(&conn)?;
-        // If the db is already encrypted then the very first output we try to encrypt will fail.
-        for tx in outbound_txs.iter_mut() {
-            // Test if this transaction is encrypted or not to avoid a double encryption.
-            let _ = OutboundTransaction::try_from(tx.clone()).map_err(|_| {
-                error!(
-                    target: LOG_TARGET,
-                    "Could not convert Inbound Transaction from database version, it might already be encrypted"
-                );
-                TransactionStorageError::AlreadyEncrypted
-            })?;
-            tx.encrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Encryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
+            EncryptionProgressSql::begin(&ENCRYPTED_TABLES, true, &conn)?;
         }
 
-        let mut completed_txs = CompletedTransactionSql::index(&conn)?;
-        // If the db is already encrypted then the very first output we try to encrypt will fail.
-        for tx in completed_txs.iter_mut() {
-            // Test if this transaction is encrypted or not to avoid a double encryption.
-            let _ = CompletedTransaction::try_from(tx.clone()).map_err(|_| {
-                error!(
-                    target: LOG_TARGET,
-                    "Could not convert Inbound Transaction from database version, it might already be encrypted"
-                );
-                TransactionStorageError::AlreadyEncrypted
-            })?;
-            tx.encrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Encryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
-        }
+        self.run_encryption_passes(&cipher, true, &progress, &conn)?;
 
         (*current_cipher) = Some(cipher);
 
         Ok(())
     }
 
-    fn remove_encryption(&self) -> Result<(), TransactionStorageError> {
+    fn remove_encryption(&self, progress: EncryptionProgress) -> Result<(), TransactionStorageError> {
         let mut current_cipher = acquire_write_lock!(self.cipher);
 
         let cipher = if let Some(cipher) = (*current_cipher).clone().take() {
@@ -736,28 +903,11 @@ impl TransactionBackend for TransactionServiceSqliteDatabase {
         };
         let conn = self.database_connection.acquire_lock();
 
-        let mut inbound_txs = InboundTransactionSql::index(&conn)?;
-
-        for tx in inbound_txs.iter_mut() {
-            tx.decrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Decryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
-        }
-
-        let mut outbound_txs = OutboundTransactionSql::index(&conn)?;
-
-        for tx in outbound_txs.iter_mut() {
-            tx.decrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Decryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
+        if !EncryptionProgressSql::is_in_progress(&ENCRYPTED_TABLES, false, &conn)? {
+            EncryptionProgressSql::begin(&ENCRYPTED_TABLES, false, &conn)?;
         }
 
-        let mut completed_txs = CompletedTransactionSql::index(&conn)?;
-        for tx in completed_txs.iter_mut() {
-            tx.decrypt(&cipher)
-                .map_err(|_| TransactionStorageError::AeadError("Decryption Error".to_string()))?;
-            tx.update_encryption(&conn)?;
-        }
+        self.run_encryption_passes(&cipher, false, &progress, &conn)?;
 
         // Now that all the decryption has been completed we can safely remove the cipher fully
         let _ = (*current_cipher).take();
@@ -933,6 +1083,40 @@ impl TransactionBackend for TransactionServiceSqliteDatabase {
         };
         Ok(())
     }
+
+    fn set_transactions_validated_height(&self, tx_ids: &[TxId], height: u64) -> Result<(), TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        conn.transaction::<_, TransactionStorageError, _>(|| {
+            for chunk in tx_ids.chunks(MAX_TX_IDS_PER_QUERY) {
+                let tx_ids = chunk.iter().map(|id| *id as i64).collect::<Vec<_>>();
+                CompletedTransactionSql::update_validated_height(&tx_ids, height, &conn)?;
+            }
+            Ok(())
+        })
+    }
+
+    fn fetch_validated_heights(&self) -> Result<HashMap<TxId, u64>, TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        Ok(CompletedTransactionSql::index_validated_heights(&conn)?
+            .into_iter()
+            .map(|(tx_id, height)| (tx_id as TxId, height as u64))
+            .collect())
+    }
+
+    fn fetch_validation_checkpoint(&self, name: &str) -> Result<Option<ValidationCheckpoint>, TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        Ok(ValidationCheckpointSql::get(name, &conn)?)
+    }
+
+    fn set_validation_checkpoint(
+        &self,
+        name: &str,
+        checkpoint: ValidationCheckpoint,
+    ) -> Result<(), TransactionStorageError> {
+        let conn = self.database_connection.acquire_lock();
+        ValidationCheckpointSql::set(name, checkpoint, &conn)?;
+        Ok(())
+    }
 }
 
 #[derive(Clone, Debug, Queryable, Insertable, PartialEq)]
@@ -948,6 +1132,7 @@ struct InboundTransactionSql {
     direct_send_success: i32,
     send_count: i32,
     last_send_timestamp: Option<NaiveDateTime>,
+    change_seq: i64,
 }
 
 impl InboundTransactionSql {
@@ -958,8 +1143,47 @@ impl InboundTransactionSql {
         Ok(())
     }
 
-    pub fn index(conn: &SqliteConnection) -> Result<Vec<InboundTransactionSql>, TransactionStorageError> {
-        Ok(inbound_transactions::table.load::<InboundTransactionSql>(conn)?)
+    /// Return up to `limit` transactions with a tx_id greater than `tx_id`, ordered by tx_id
+    pub fn index_after_tx_id(
+        tx_id: i64,
+        limit: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<InboundTransactionSql>, TransactionStorageError> {
+        Ok(inbound_transactions::table
+            .filter(inbound_transactions::tx_id.gt(tx_id))
+            .order(inbound_transactions::tx_id.asc())
+            .limit(limit)
+            .load::<InboundTransactionSql>(conn)?)
+    }
+
+    pub fn update_validated_height(
+        tx_ids: &[i64],
+        height: u64,
+        conn: &SqliteConnection,
+    ) -> Result<(), TransactionStorageError> {
+        diesel::update(completed_transactions::table.filter(completed_transactions::tx_id.eq_any(tx_ids)))
+            .set(completed_transactions::validated_height.eq(height as i64))
+            .execute(conn)?;
+        Ok(())
+    }
+
+    /// Return the tx_id and validated height of every transaction that has been confirmed by a validation
+    pub fn index_validated_heights(conn: &SqliteConnection) -> Result<Vec<(i64, i64)>, TransactionStorageError> {
+        Ok(completed_transactions::table
+            .select((completed_transactions::tx_id, completed_transactions::validated_height))
+            .filter(completed_transactions::validated_height.is_not_null())
+            .load::<(i64, Option<i64>)>(conn)?
+            .into_iter()
+            .filter_map(|(tx_id, height)| height.map(|h| (tx_id, h)))
+            .collect())
+    }
+
+    /// Return the number of transactions with a tx_id greater than `tx_id`
+    pub fn count_after_tx_id(tx_id: i64, conn: &SqliteConnection) -> Result<i64, TransactionStorageError> {
+        Ok(inbound_transactions::table
+            .filter(inbound_transactions::tx_id.gt(tx_id))
+            .count()
+            .get_result(conn)?)
     }
 
     pub fn index_by_cancelled(
@@ -971,6 +1195,17 @@ impl InboundTransactionSql {
             .load::<InboundTransactionSql>(conn)?)
     }
 
+    /// Load the rows, cancelled or not, that were inserted or updated after the given change sequence number
+    pub fn index_changed_since(
+        change_seq: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<InboundTransactionSql>, TransactionStorageError> {
+        Ok(inbound_transactions::table
+            .filter(inbound_transactions::change_seq.gt(change_seq))
+            .order(inbound_transactions::change_seq.asc())
+            .load::<InboundTransactionSql>(conn)?)
+    }
+
     pub fn find(tx_id: TxId, conn: &SqliteConnection) -> Result<InboundTransactionSql, TransactionStorageError> {
         Ok(inbound_transactions::table
             .filter(inbound_transactions::tx_id.eq(tx_id as i64))
@@ -1048,20 +1283,16 @@ impl InboundTransactionSql {
 
 impl Encryptable<Aes256Gcm> for InboundTransactionSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let encrypted_protocol =
-            encrypt_bytes_integral_nonce(&cipher, self.receiver_protocol.clone().as_bytes().to_vec())?;
-        self.receiver_protocol = encrypted_protocol.to_hex();
+        let mut protocol = std::mem::take(&mut self.receiver_protocol).into_bytes();
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.receiver_protocol = protocol.to_hex();
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let decrypted_protocol = decrypt_bytes_integral_nonce(
-            &cipher,
-            from_hex(self.receiver_protocol.as_str()).map_err(|_| aes_gcm::Error)?,
-        )?;
-        self.receiver_protocol = from_utf8(decrypted_protocol.as_slice())
-            .map_err(|_| aes_gcm::Error)?
-            .to_string();
+        let mut protocol = from_hex(self.receiver_protocol.as_str()).map_err(|_| aes_gcm::Error)?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.receiver_protocol = String::from_utf8(protocol).map_err(|_| aes_gcm::Error)?;
         Ok(())
     }
 }
@@ -1081,6 +1312,7 @@ impl TryFrom<InboundTransaction> for InboundTransactionSql {
             direct_send_success: i.direct_send_success as i32,
             send_count: i.send_count as i32,
             last_send_timestamp: i.last_send_timestamp,
+            change_seq: 0,
         })
     }
 }
@@ -1131,6 +1363,7 @@ struct OutboundTransactionSql {
     direct_send_success: i32,
     send_count: i32,
     last_send_timestamp: Option<NaiveDateTime>,
+    change_seq: i64,
 }
 
 impl OutboundTransactionSql {
@@ -1141,8 +1374,25 @@ impl OutboundTransactionSql {
         Ok(())
     }
 
-    pub fn index(conn: &SqliteConnection) -> Result<Vec<OutboundTransactionSql>, TransactionStorageError> {
-        Ok(outbound_transactions::table.load::<OutboundTransactionSql>(conn)?)
+    /// Return up to `limit` transactions with a tx_id greater than `tx_id`, ordered by tx_id
+    pub fn index_after_tx_id(
+        tx_id: i64,
+        limit: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<OutboundTransactionSql>, TransactionStorageError> {
+        Ok(outbound_transactions::table
+            .filter(outbound_transactions::tx_id.gt(tx_id))
+            .order(outbound_transactions::tx_id.asc())
+            .limit(limit)
+            .load::<OutboundTransactionSql>(conn)?)
+    }
+
+    /// Return the number of transactions with a tx_id greater than `tx_id`
+    pub fn count_after_tx_id(tx_id: i64, conn: &SqliteConnection) -> Result<i64, TransactionStorageError> {
+        Ok(outbound_transactions::table
+            .filter(outbound_transactions::tx_id.gt(tx_id))
+            .count()
+            .get_result(conn)?)
     }
 
     pub fn index_by_cancelled(
@@ -1154,6 +1404,17 @@ impl OutboundTransactionSql {
             .load::<OutboundTransactionSql>(conn)?)
     }
 
+    /// Load the rows, cancelled or not, that were inserted or updated after the given change sequence number
+    pub fn index_changed_since(
+        change_seq: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<OutboundTransactionSql>, TransactionStorageError> {
+        Ok(outbound_transactions::table
+            .filter(outbound_transactions::change_seq.gt(change_seq))
+            .order(outbound_transactions::change_seq.asc())
+            .load::<OutboundTransactionSql>(conn)?)
+    }
+
     pub fn find(tx_id: TxId, conn: &SqliteConnection) -> Result<OutboundTransactionSql, TransactionStorageError> {
         Ok(outbound_transactions::table
             .filter(outbound_transactions::tx_id.eq(tx_id as i64))
@@ -1231,20 +1492,16 @@ impl OutboundTransactionSql {
 
 impl Encryptable<Aes256Gcm> for OutboundTransactionSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let encrypted_protocol =
-            encrypt_bytes_integral_nonce(&cipher, self.sender_protocol.clone().as_bytes().to_vec())?;
-        self.sender_protocol = encrypted_protocol.to_hex();
+        let mut protocol = std::mem::take(&mut self.sender_protocol).into_bytes();
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.sender_protocol = protocol.to_hex();
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let decrypted_protocol = decrypt_bytes_integral_nonce(
-            &cipher,
-            from_hex(self.sender_protocol.as_str()).map_err(|_| aes_gcm::Error)?,
-        )?;
-        self.sender_protocol = from_utf8(decrypted_protocol.as_slice())
-            .map_err(|_| aes_gcm::Error)?
-            .to_string();
+        let mut protocol = from_hex(self.sender_protocol.as_str()).map_err(|_| aes_gcm::Error)?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.sender_protocol = String::from_utf8(protocol).map_err(|_| aes_gcm::Error)?;
         Ok(())
     }
 }
@@ -1265,6 +1522,7 @@ impl TryFrom<OutboundTransaction> for OutboundTransactionSql {
             direct_send_success: o.direct_send_success as i32,
             send_count: o.send_count as i32,
             last_send_timestamp: o.last_send_timestamp,
+            change_seq: 0,
         })
     }
 }
@@ -1322,6 +1580,8 @@ struct CompletedTransactionSql {
     valid: i32,
     confirmations: Option<i64>,
     mined_height: Option<i64>,
+    change_seq: i64,
+    validated_height: Option<i64>,
 }
 
 impl CompletedTransactionSql {
@@ -1332,8 +1592,25 @@ impl CompletedTransactionSql {
         Ok(())
     }
 
-    pub fn index(conn: &SqliteConnection) -> Result<Vec<CompletedTransactionSql>, TransactionStorageError> {
-        Ok(completed_transactions::table.load::<CompletedTransactionSql>(conn)?)
+    /// Return up to `limit` transactions with a tx_id greater than `tx_id`, ordered by tx_id
+    pub fn index_after_tx_id(
+        tx_id: i64,
+        limit: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<CompletedTransactionSql>, TransactionStorageError> {
+        Ok(completed_transactions::table
+            .filter(completed_transactions::tx_id.gt(tx_id))
+            .order(completed_transactions::tx_id.asc())
+            .limit(limit)
+            .load::<CompletedTransactionSql>(conn)?)
+    }
+
+    /// Return the number of transactions with a tx_id greater than `tx_id`
+    pub fn count_after_tx_id(tx_id: i64, conn: &SqliteConnection) -> Result<i64, TransactionStorageError> {
+        Ok(completed_transactions::table
+            .filter(completed_transactions::tx_id.gt(tx_id))
+            .count()
+            .get_result(conn)?)
     }
 
     pub fn index_by_cancelled(
@@ -1345,6 +1622,75 @@ impl CompletedTransactionSql {
             .load::<CompletedTransactionSql>(conn)?)
     }
 
+    /// Load the rows, cancelled or not, that were inserted or updated after the given change sequence number
+    pub fn index_changed_since(
+        change_seq: i64,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<CompletedTransactionSql>, TransactionStorageError> {
+        Ok(completed_transactions::table
+            .filter(completed_transactions::change_seq.gt(change_seq))
+            .order(completed_transactions::change_seq.asc())
+            .load::<CompletedTransactionSql>(conn)?)
+    }
+
+    /// Load a page of completed transactions matching the query, newest first. Paging uses the (timestamp, tx_id) of
+    /// the cursor transaction as a keyset so that the indexes on these columns can satisfy the query without scanning
+    /// the preceding pages.
+    pub fn index_by_query(
+        query: &CompletedTransactionQuery,
+        conn: &SqliteConnection,
+    ) -> Result<Vec<CompletedTransactionSql>, TransactionStorageError> {
+        let mut q = completed_transactions::table
+            .filter(completed_transactions::cancelled.eq(query.cancelled as i32))
+            .into_boxed();
+
+        if !query.statuses.is_empty() {
+            let statuses = query.statuses.iter().map(|s| s.clone() as i32).collect::<Vec<i32>>();
+            q = q.filter(completed_transactions::status.eq_any(statuses));
+        }
+        match query.direction {
+            Some(TransactionDirection::Unknown) => {
+                q = q.filter(
+                    completed_transactions::direction
+                        .is_null()
+                        .or(completed_transactions::direction.eq(TransactionDirection::Unknown as i32)),
+                );
+            },
+            Some(ref direction) => {
+                q = q.filter(completed_transactions::direction.eq(direction.clone() as i32));
+            },
+            None => (),
+        }
+        if let Some(from_timestamp) = query.from_timestamp {
+            q = q.filter(completed_transactions::timestamp.ge(from_timestamp));
+        }
+        if let Some(to_timestamp) = query.to_timestamp {
+            q = q.filter(completed_transactions::timestamp.lt(to_timestamp));
+        }
+        if let Some(cursor) = query.cursor {
+            let cursor_timestamp = completed_transactions::table
+                .filter(completed_transactions::tx_id.eq(cursor as i64))
+                .select(completed_transactions::timestamp)
+                .first::<NaiveDateTime>(conn)?;
+            q = q.filter(
+                completed_transactions::timestamp
+                    .lt(cursor_timestamp)
+                    .or(completed_transactions::timestamp
+                        .eq(cursor_timestamp)
+                        .and(completed_transactions::tx_id.lt(cursor as i64))),
+            );
+        }
+        q = q.order((
+            completed_transactions::timestamp.desc(),
+            completed_transactions::tx_id.desc(),
+        ));
+        if let Some(limit) = query.limit {
+            q = q.limit(limit as i64);
+        }
+
+        Ok(q.load::<CompletedTransactionSql>(conn)?)
+    }
+
     pub fn index_coinbase_at_block_height(
         block_height: i64,
         conn: &SqliteConnection,
@@ -1554,20 +1900,16 @@ impl CompletedTransactionSql {
 
 impl Encryptable<Aes256Gcm> for CompletedTransactionSql {
     fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let encrypted_protocol =
-            encrypt_bytes_integral_nonce(&cipher, self.transaction_protocol.clone().as_bytes().to_vec())?;
-        self.transaction_protocol = encrypted_protocol.to_hex();
+        let mut protocol = std::mem::take(&mut self.transaction_protocol).into_bytes();
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.transaction_protocol = protocol.to_hex();
         Ok(())
     }
 
     fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
-        let decrypted_protocol = decrypt_bytes_integral_nonce(
-            &cipher,
-            from_hex(self.transaction_protocol.as_str()).map_err(|_| aes_gcm::Error)?,
-        )?;
-        self.transaction_protocol = from_utf8(decrypted_protocol.as_slice())
-            .map_err(|_| aes_gcm::Error)?
-            .to_string();
+        let mut protocol = from_hex(self.transaction_protocol.as_str()).map_err(|_| aes_gcm::Error)?;
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut protocol)?;
+        self.transaction_protocol = String::from_utf8(protocol).map_err(|_| aes_gcm::Error)?;
         Ok(())
     }
 }
@@ -1594,6 +1936,8 @@ impl TryFrom<CompletedTransaction> for CompletedTransactionSql {
             valid: c.valid as i32,
             confirmations: c.confirmations.map(|ic| ic as i64),
             mined_height: c.mined_height.map(|ic| ic as i64),
+            change_seq: 0,
+            validated_height: None,
         })
     }
 }
@@ -1694,7 +2038,7 @@ mod test {
                 TransactionServiceSqliteDatabase,
             },
         },
-        util::encryption::Encryptable,
+        util::encryption::{Encryptable, EncryptionProgress},
     };
     use aes_gcm::{
         aead::{generic_array::GenericArray, NewAead},
@@ -2296,11 +2640,16 @@ mod test {
         let connection = WalletDbConnection::new(conn, None);
 
         let db1 = TransactionServiceSqliteDatabase::new(connection.clone(), Some(cipher.clone()));
-        assert!(db1.apply_encryption(cipher.clone()).is_err());
+        assert!(db1
+            .apply_encryption(cipher.clone(), EncryptionProgress::default())
+            .is_err());
 
         let db2 = TransactionServiceSqliteDatabase::new(connection.clone(), None);
-        assert!(db2.remove_encryption().is_ok());
-        db2.apply_encryption(cipher).unwrap();
+        assert!(db2.remove_encryption(EncryptionProgress::default()).is_ok());
+        let progress = EncryptionProgress::default();
+        db2.apply_encryption(cipher, progress.clone()).unwrap();
+        assert_eq!(progress.processed(), 3);
+        assert_eq!(progress.total(), 3);
         assert!(db2.fetch(&DbKey::PendingInboundTransactions).is_ok());
         assert!(db2.fetch(&DbKey::PendingOutboundTransactions).is_ok());
         assert!(db2.fetch(&DbKey::CompletedTransactions).is_ok());
@@ -2310,7 +2659,7 @@ mod test {
         assert!(db3.fetch(&DbKey::PendingOutboundTransactions).is_err());
         assert!(db3.fetch(&DbKey::CompletedTransactions).is_err());
 
-        db2.remove_encryption().unwrap();
+        db2.remove_encryption(EncryptionProgress::default()).unwrap();
 
         assert!(db3.fetch(&DbKey::PendingInboundTransactions).is_ok());
         assert!(db3.fetch(&DbKey::PendingOutboundTransactions).is_ok());
@@ -21,45 +21,162 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use aes_gcm::{
-    aead::{generic_array::GenericArray, Aead, Error as AeadError},
+    aead::{generic_array::GenericArray, AeadInPlace, Error as AeadError},
     Aes256Gcm,
 };
 use rand::{rngs::OsRng, RngCore};
+use rayon::prelude::*;
+use std::{
+    fmt,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc,
+    },
+};
 
 pub const AES_NONCE_BYTES: usize = 12;
 pub const AES_KEY_BYTES: usize = 32;
+pub const AES_TAG_BYTES: usize = 16;
+
+/// The number of rows that are encrypted or decrypted and written back in each database transaction when encryption is
+/// applied to or removed from a backend
+pub const ENCRYPTION_BATCH_SIZE: i64 = 500;
 
 pub trait Encryptable<C> {
     fn encrypt(&mut self, cipher: &C) -> Result<(), AeadError>;
     fn decrypt(&mut self, cipher: &C) -> Result<(), AeadError>;
 }
 
-pub fn decrypt_bytes_integral_nonce(cipher: &Aes256Gcm, ciphertext: Vec<u8>) -> Result<Vec<u8>, AeadError> {
-    if ciphertext.len() < AES_NONCE_BYTES {
+pub fn decrypt_bytes_integral_nonce(cipher: &Aes256Gcm, mut ciphertext: Vec<u8>) -> Result<Vec<u8>, AeadError> {
+    decrypt_bytes_integral_nonce_in_place(cipher, &mut ciphertext)?;
+    Ok(ciphertext)
+}
+
+pub fn encrypt_bytes_integral_nonce(cipher: &Aes256Gcm, mut plaintext: Vec<u8>) -> Result<Vec<u8>, AeadError> {
+    encrypt_bytes_integral_nonce_in_place(cipher, &mut plaintext)?;
+    Ok(plaintext)
+}
+
+/// Decrypt the nonce, ciphertext and tag in `data` in place, leaving only the plaintext
+pub fn decrypt_bytes_integral_nonce_in_place(cipher: &Aes256Gcm, data: &mut Vec<u8>) -> Result<(), AeadError> {
+    if data.len() < AES_NONCE_BYTES + AES_TAG_BYTES {
         return Err(AeadError);
     }
-    let (nonce, cipher_text) = ciphertext.split_at(AES_NONCE_BYTES);
-    let nonce = GenericArray::from_slice(nonce);
-    cipher.decrypt(nonce, cipher_text.as_ref())
+    let tag_start = data.len() - AES_TAG_BYTES;
+    let (nonce_and_ciphertext, tag) = data.split_at_mut(tag_start);
+    let (nonce, ciphertext) = nonce_and_ciphertext.split_at_mut(AES_NONCE_BYTES);
+    cipher.decrypt_in_place_detached(
+        GenericArray::from_slice(nonce),
+        b"",
+        ciphertext,
+        GenericArray::from_slice(tag),
+    )?;
+    data.copy_within(AES_NONCE_BYTES..tag_start, 0);
+    data.truncate(tag_start - AES_NONCE_BYTES);
+    Ok(())
 }
 
-pub fn encrypt_bytes_integral_nonce(cipher: &Aes256Gcm, plaintext: Vec<u8>) -> Result<Vec<u8>, AeadError> {
+/// Encrypt the plaintext in `data` in place. The nonce is prepended and the tag appended to the ciphertext.
+pub fn encrypt_bytes_integral_nonce_in_place(cipher: &Aes256Gcm, data: &mut Vec<u8>) -> Result<(), AeadError> {
     let mut nonce = [0u8; AES_NONCE_BYTES];
     OsRng.fill_bytes(&mut nonce);
-    let nonce_ga = GenericArray::from_slice(&nonce);
-    let mut ciphertext = cipher.encrypt(nonce_ga, plaintext.as_ref())?;
-    let mut ciphertext_integral_nonce = nonce.to_vec();
-    ciphertext_integral_nonce.append(&mut ciphertext);
-    Ok(ciphertext_integral_nonce)
+    let tag = cipher.encrypt_in_place_detached(GenericArray::from_slice(&nonce), b"", data.as_mut_slice())?;
+    data.reserve(AES_TAG_BYTES + AES_NONCE_BYTES);
+    data.extend_from_slice(&tag);
+    data.extend_from_slice(&nonce);
+    data.rotate_right(AES_NONCE_BYTES);
+    Ok(())
+}
+
+/// Encrypt or decrypt all of the `items` on the rayon thread pool. The items are returned in the order they were
+/// given.
+pub fn apply_cipher_in_parallel<T>(items: Vec<T>, cipher: &Aes256Gcm, encrypt: bool) -> Result<Vec<T>, AeadError>
+where T: Encryptable<Aes256Gcm> + Send {
+    items
+        .into_par_iter()
+        .map(|mut item| {
+            if encrypt {
+                item.encrypt(cipher)?;
+            } else {
+                item.decrypt(cipher)?;
+            }
+            Ok(item)
+        })
+        .collect()
+}
+
+/// Tracks the number of rows processed while encryption is applied to or removed from the wallet, and reports each
+/// change to an optional callback as `(processed, total)`. Clones share the same counters.
+#[derive(Clone, Default)]
+pub struct EncryptionProgress {
+    processed: Arc<AtomicU64>,
+    total: Arc<AtomicU64>,
+    callback: Option<Arc<dyn Fn(u64, u64) + Send + Sync>>,
+}
+
+impl EncryptionProgress {
+    pub fn new<F>(callback: F) -> Self
+    where F: Fn(u64, u64) + Send + Sync + 'static {
+        Self {
+            callback: Some(Arc::new(callback)),
+            ..Default::default()
+        }
+    }
+
+    /// Add rows that still have to be processed to the total
+    pub fn add_total(&self, rows: u64) {
+        let total = self.total.fetch_add(rows, Ordering::SeqCst) + rows;
+        self.report(self.processed(), total);
+    }
+
+    /// Record that a number of rows have been processed
+    pub fn advance(&self, rows: u64) {
+        let processed = self.processed.fetch_add(rows, Ordering::SeqCst) + rows;
+        self.report(processed, self.total());
+    }
+
+    pub fn processed(&self) -> u64 {
+        self.processed.load(Ordering::SeqCst)
+    }
+
+    pub fn total(&self) -> u64 {
+        self.total.load(Ordering::SeqCst)
+    }
+
+    fn report(&self, processed: u64, total: u64) {
+        if let Some(callback) = self.callback.as_ref() {
+            (callback)(processed, total);
+        }
+    }
+}
+
+impl fmt::Debug for EncryptionProgress {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("EncryptionProgress")
+            .field("processed", &self.processed())
+            .field("total", &self.total())
+            .finish()
+    }
 }
 
 #[cfg(test)]
 mod test {
-    use crate::util::encryption::{decrypt_bytes_integral_nonce, encrypt_bytes_integral_nonce};
+    use crate::util::encryption::{
+        apply_cipher_in_parallel,
+        decrypt_bytes_integral_nonce,
+        decrypt_bytes_integral_nonce_in_place,
+        encrypt_bytes_integral_nonce,
+        encrypt_bytes_integral_nonce_in_place,
+        Encryptable,
+        EncryptionProgress,
+        AES_NONCE_BYTES,
+        AES_TAG_BYTES,
+    };
     use aes_gcm::{
-        aead::{generic_array::GenericArray, NewAead},
+        aead::{generic_array::GenericArray, Error as AeadError, NewAead},
         Aes256Gcm,
     };
+    use std::sync::{Arc, Mutex};
     #[test]
     fn test_encrypt_decrypt() {
         let plaintext = b"The quick brown fox was annoying".to_vec();
@@ -70,4 +187,62 @@ mod test {
         let decrypted_text = decrypt_bytes_integral_nonce(&cipher, cipher_text).unwrap();
         assert_eq!(decrypted_text, plaintext);
     }
+
+    #[test]
+    fn test_encrypt_decrypt_in_place() {
+        let plaintext = b"The quick brown fox was annoying".to_vec();
+        let key = GenericArray::from_slice(b"an example very very secret key.");
+        let cipher = Aes256Gcm::new(key);
+
+        let mut data = plaintext.clone();
+        encrypt_bytes_integral_nonce_in_place(&cipher, &mut data).unwrap();
+        assert_eq!(data.len(), plaintext.len() + AES_NONCE_BYTES + AES_TAG_BYTES);
+        // The in place format is the same as the allocating one
+        let decrypted_text = decrypt_bytes_integral_nonce(&cipher, data.clone()).unwrap();
+        assert_eq!(decrypted_text, plaintext);
+
+        decrypt_bytes_integral_nonce_in_place(&cipher, &mut data).unwrap();
+        assert_eq!(data, plaintext);
+
+        let mut too_short = vec![0u8; AES_NONCE_BYTES + AES_TAG_BYTES - 1];
+        assert!(decrypt_bytes_integral_nonce_in_place(&cipher, &mut too_short).is_err());
+    }
+
+    struct Item(Vec<u8>);
+
+    impl Encryptable<Aes256Gcm> for Item {
+        fn encrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
+            encrypt_bytes_integral_nonce_in_place(cipher, &mut self.0)
+        }
+
+        fn decrypt(&mut self, cipher: &Aes256Gcm) -> Result<(), AeadError> {
+            decrypt_bytes_integral_nonce_in_place(cipher, &mut self.0)
+        }
+    }
+
+    #[test]
+    fn test_apply_cipher_in_parallel() {
+        let key = GenericArray::from_slice(b"an example very very secret key.");
+        let cipher = Aes256Gcm::new(key);
+        let plaintexts = (0..100u32).map(|i| i.to_le_bytes().to_vec()).collect::<Vec<_>>();
+
+        let items = plaintexts.iter().cloned().map(Item).collect::<Vec<_>>();
+        let encrypted = apply_cipher_in_parallel(items, &cipher, true).unwrap();
+        assert!(encrypted.iter().zip(plaintexts.iter()).all(|(e, p)| &e.0 != p));
+        let decrypted = apply_cipher_in_parallel(encrypted, &cipher, false).unwrap();
+        assert_eq!(decrypted.into_iter().map(|i| i.0).collect::<Vec<_>>(), plaintexts);
+    }
+
+    #[test]
+    fn test_encryption_progress() {
+        let reports = Arc::new(Mutex::new(Vec::new()));
+        let reports_clone = reports.clone();
+        let progress = EncryptionProgress::new(move |processed, total| {
+            reports_clone.lock().unwrap().push((processed, total));
+        });
+        progress.add_total(10);
+        progress.clone().advance(4);
+        progress.advance(6);
+        assert_eq!(*reports.lock().unwrap(), vec![(0, 10), (4, 10), (10, 10)]);
+    }
 }
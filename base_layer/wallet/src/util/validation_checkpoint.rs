@@ -0,0 +1,171 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use log::*;
+use std::{convert::TryFrom, time::Duration};
+use tari_comms::PeerConnection;
+use tari_core::{
+    base_node::sync::rpc::BaseNodeSyncRpcClient,
+    blocks::BlockHeader,
+    proto::base_node::TipInfoResponse,
+    tari_utilities::{hex::Hex, Hashable},
+    transactions::types::HashOutput,
+};
+
+const LOG_TARGET: &str = "wallet::util::validation_checkpoint";
+
+/// The chain tip that a set of outputs or transactions was last validated against
+#[derive(Debug, Clone, PartialEq)]
+pub struct ValidationCheckpoint {
+    pub height: u64,
+    pub block_hash: HashOutput,
+}
+
+impl ValidationCheckpoint {
+    pub fn new(height: u64, block_hash: HashOutput) -> Self {
+        Self { height, block_hash }
+    }
+
+    /// The tip reported by a base node, if the response contains one
+    pub fn from_tip_info(tip_info: &TipInfoResponse) -> Option<Self> {
+        let metadata = tip_info.metadata.as_ref()?;
+        Some(Self::new(
+            metadata.height_of_longest_chain?,
+            metadata.best_block.clone()?,
+        ))
+    }
+
+    /// The scope that follows from comparing this checkpoint with the current tip alone. `None` means that the chain
+    /// has grown past the checkpoint and the header at the checkpoint height is needed to tell whether the checkpoint
+    /// block is still part of the chain.
+    fn scope_for_tip(&self, tip: &ValidationCheckpoint) -> Option<ValidationScope> {
+        if self == tip {
+            Some(ValidationScope::Unvalidated)
+        } else if tip.height <= self.height {
+            Some(ValidationScope::Full)
+        } else {
+            None
+        }
+    }
+}
+
+/// How much of a set of outputs or transactions has to be queried from the base node
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum ValidationScope {
+    /// The tip is unchanged since the checkpoint, only the items that have never been validated are queried
+    Unvalidated,
+    /// The chain has been extended past the checkpoint, the items that have never been validated and the items that
+    /// blocks after the checkpoint could still change are queried
+    NonFinal,
+    /// There is no checkpoint or the chain has been reorganised since it, every item is queried
+    Full,
+}
+
+/// Determine the scope of a validation from the set's checkpoint and the tip of the base node. When the chain has
+/// grown past the checkpoint the header at the checkpoint height is fetched from the base node to detect a reorg, if
+/// that header cannot be fetched a full validation is done.
+pub async fn get_validation_scope(
+    connection: &mut PeerConnection,
+    checkpoint: Option<&ValidationCheckpoint>,
+    tip: Option<&ValidationCheckpoint>,
+    timeout: Duration,
+) -> ValidationScope {
+    let (checkpoint, tip) = match (checkpoint, tip) {
+        (Some(c), Some(t)) => (c, t),
+        _ => return ValidationScope::Full,
+    };
+    if let Some(scope) = checkpoint.scope_for_tip(tip) {
+        return scope;
+    }
+
+    let mut client = match connection
+        .connect_rpc_using_builder(BaseNodeSyncRpcClient::builder().with_deadline(timeout))
+        .await
+    {
+        Ok(c) => c,
+        Err(e) => {
+            debug!(
+                target: LOG_TARGET,
+                "Could not connect to the base node sync RPC to check for a reorg, validating everything: {}", e
+            );
+            return ValidationScope::Full;
+        },
+    };
+    let header = match client.get_header_by_height(checkpoint.height).await {
+        Ok(h) => h,
+        Err(e) => {
+            debug!(
+                target: LOG_TARGET,
+                "Could not fetch the header at height {} to check for a reorg, validating everything: {}",
+                checkpoint.height,
+                e
+            );
+            return ValidationScope::Full;
+        },
+    };
+    match BlockHeader::try_from(header) {
+        Ok(header) if header.hash() == checkpoint.block_hash => ValidationScope::NonFinal,
+        Ok(header) => {
+            info!(
+                target: LOG_TARGET,
+                "Block {} at height {} has been replaced by {} in a reorg, validating everything",
+                checkpoint.block_hash.to_hex(),
+                checkpoint.height,
+                header.hash().to_hex()
+            );
+            ValidationScope::Full
+        },
+        Err(e) => {
+            debug!(target: LOG_TARGET, "Invalid header returned by base node: {}", e);
+            ValidationScope::Full
+        },
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::{ValidationCheckpoint, ValidationScope};
+
+    #[test]
+    fn test_scope_for_tip() {
+        let checkpoint = ValidationCheckpoint::new(10, vec![1u8; 32]);
+
+        assert_eq!(
+            checkpoint.scope_for_tip(&checkpoint.clone()),
+            Some(ValidationScope::Unvalidated)
+        );
+        // A different block at the same or a lower height can only be the result of a reorg
+        assert_eq!(
+            checkpoint.scope_for_tip(&ValidationCheckpoint::new(10, vec![2u8; 32])),
+            Some(ValidationScope::Full)
+        );
+        assert_eq!(
+            checkpoint.scope_for_tip(&ValidationCheckpoint::new(9, vec![2u8; 32])),
+            Some(ValidationScope::Full)
+        );
+        // A higher tip needs the header at the checkpoint height
+        assert_eq!(
+            checkpoint.scope_for_tip(&ValidationCheckpoint::new(11, vec![2u8; 32])),
+            None
+        );
+    }
+}
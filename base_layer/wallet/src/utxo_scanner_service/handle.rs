@@ -55,6 +55,13 @@ pub enum UtxoScannerEvent {
         current_block: u64,
         current_chain_height: u64,
     },
+    /// Time spent in the stages of a completed scan (rewinding outputs, importing the recovered outputs into the
+    /// transaction service and persisting the scanning progress)
+    ScanningStatistics {
+        rewind_time: Duration,
+        import_time: Duration,
+        persist_time: Duration,
+    },
     /// Completed Recovery (Number scanned, Num of Recovered outputs, Value of recovered outputs, Time taken)
     Completed {
         number_scanned: u64,
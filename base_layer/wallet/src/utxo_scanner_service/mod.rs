@@ -21,6 +21,7 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     output_manager_service::handle::OutputManagerHandle,
     storage::database::{WalletBackend, WalletDatabase},
     transaction_service::handle::TransactionServiceHandle,
@@ -46,6 +47,7 @@ use tokio::sync::broadcast;
 pub mod error;
 pub mod handle;
 pub mod utxo_scanning;
+mod utxo_segments;
 
 const LOG_TARGET: &str = "wallet::utxo_scanner_service::initializer";
 
@@ -102,6 +104,7 @@ where T: WalletBackend + 'static
             let transaction_service = handles.expect_handle::<TransactionServiceHandle>();
             let output_manager_service = handles.expect_handle::<OutputManagerHandle>();
             let connectivity_manager = handles.expect_handle::<ConnectivityRequester>();
+            let wallet_connectivity = handles.expect_handle::<WalletConnectivityHandle>();
 
             let scanning_service = UtxoScannerService::<T>::builder()
                 .with_peers(vec![])
@@ -111,6 +114,7 @@ where T: WalletBackend + 'static
                 .build_with_resources(
                     backend,
                     connectivity_manager,
+                    wallet_connectivity,
                     output_manager_service,
                     transaction_service,
                     node_identity,
@@ -21,6 +21,7 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 use crate::{
+    connectivity_service::WalletConnectivityHandle,
     error::WalletError,
     output_manager_service::{handle::OutputManagerHandle, TxId},
     storage::{
@@ -31,11 +32,19 @@ use crate::{
     utxo_scanner_service::{
         error::UtxoScannerError,
         handle::{UtxoScannerEvent, UtxoScannerRequest, UtxoScannerResponse},
+        utxo_segments::{
+            plan_segments,
+            record_completed_segment,
+            SegmentDownloader,
+            SegmentEvent,
+            SegmentQueue,
+            UtxoSegment,
+        },
     },
     WalletSqlite,
 };
 use chrono::Utc;
-use futures::{pin_mut, StreamExt};
+use futures::{channel::mpsc, future, pin_mut, StreamExt};
 use log::*;
 use serde::{Deserialize, Serialize};
 use std::{
@@ -49,17 +58,16 @@ use std::{
 use tari_comms::{
     connectivity::ConnectivityRequester,
     peer_manager::NodeId,
-    protocol::rpc::{RpcError, RpcStatus},
+    protocol::rpc::{RpcClientLease, RpcError},
     types::CommsPublicKey,
     NodeIdentity,
     PeerConnection,
 };
 use tari_core::{
     base_node::sync::rpc::BaseNodeSyncRpcClient,
-    blocks::BlockHeader,
+    blocks::{BlockFilter, BlockHeader},
     crypto::tari_utilities::hex::Hex,
-    proto,
-    proto::base_node::{FindChainSplitRequest, SyncUtxosRequest},
+    proto::base_node::{FindChainSplitRequest, SyncBlockFiltersRequest},
     tari_utilities::Hashable,
     transactions::{
         tari_amount::MicroTari,
@@ -67,6 +75,7 @@ use tari_core::{
         types::{CryptoFactories, HashOutput},
     },
 };
+use tari_metrics::{Counter, Gauge, Histogram};
 use tari_service_framework::{reply_channel, reply_channel::SenderService};
 use tari_shutdown::ShutdownSignal;
 use tokio::{sync::broadcast, task, time};
@@ -75,6 +84,39 @@ pub const LOG_TARGET: &str = "wallet::utxo_scanning";
 
 pub const RECOVERY_KEY: &str = "recovery_data";
 const SCANNING_KEY: &str = "scanning_data";
+/// The maximum number of UTXOs handed to the output manager to rewind at once
+const MAX_SCAN_BATCH_SIZE: usize = 500;
+/// The number of output MMR positions in a download segment. Progress is persisted as segments complete.
+const UTXO_SEGMENT_SIZE: u64 = 2000;
+/// The number of downloaded batches that are buffered ahead of the outputs being rewound
+const SEGMENT_EVENT_BUFFER_SIZE: usize = 8;
+/// The maximum number of sync peers that download segments at the same time
+const MAX_SYNC_PEERS: usize = 4;
+/// The deadline of the requests made on the sync RPC sessions
+const SYNC_RPC_DEADLINE: Duration = Duration::from_secs(60);
+
+lazy_static! {
+    static ref OUTPUTS_SCANNED: Arc<Counter> = tari_metrics::global().counter(
+        "wallet_utxo_scanner_outputs_scanned_total",
+        "The number of outputs downloaded and checked for wallet outputs",
+        &[],
+    );
+    static ref OUTPUTS_RECOVERED: Arc<Counter> = tari_metrics::global().counter(
+        "wallet_utxo_scanner_outputs_recovered_total",
+        "The number of outputs recovered and imported into the wallet",
+        &[],
+    );
+    static ref SCAN_RATE: Arc<Gauge> = tari_metrics::global().gauge(
+        "wallet_utxo_scanner_outputs_per_second",
+        "The rate at which the current or last scan checked outputs",
+        &[],
+    );
+    static ref REWIND_DURATION: Arc<Histogram> = tari_metrics::global().histogram(
+        "wallet_utxo_scanner_rewind_seconds",
+        "Time taken to rewind a batch of downloaded outputs",
+        &[],
+    );
+}
 
 #[derive(Debug, Clone, PartialEq)]
 pub enum UtxoScannerMode {
@@ -88,6 +130,14 @@ impl Default for UtxoScannerMode {
     }
 }
 
+/// The time a scan spent in each of its stages, accumulated across scanning rounds
+#[derive(Debug, Default, Clone, Copy)]
+struct ScanningStatistics {
+    rewind_time: Duration,
+    import_time: Duration,
+    persist_time: Duration,
+}
+
 #[derive(Debug, Default, Clone)]
 pub struct UtxoScannerServiceBuilder {
     retry_limit: usize,
@@ -100,6 +150,7 @@ pub struct UtxoScannerServiceBuilder {
 struct UtxoScannerResources<TBackend> {
     pub db: WalletDatabase<TBackend>,
     pub connectivity: ConnectivityRequester,
+    pub wallet_connectivity: WalletConnectivityHandle,
     pub output_manager_service: OutputManagerHandle,
     pub transaction_service: TransactionServiceHandle,
     pub node_identity: Arc<NodeIdentity>,
@@ -137,6 +188,7 @@ impl UtxoScannerServiceBuilder {
         let resources = UtxoScannerResources {
             db: wallet.db.clone(),
             connectivity: wallet.comms.connectivity(),
+            wallet_connectivity: wallet.wallet_connectivity.clone(),
             output_manager_service: wallet.output_manager_service.clone(),
             transaction_service: wallet.transaction_service.clone(),
             node_identity: wallet.comms.node_identity(),
@@ -169,6 +221,7 @@ impl UtxoScannerServiceBuilder {
         &mut self,
         db: WalletDatabase<TBackend>,
         connectivity: ConnectivityRequester,
+        wallet_connectivity: WalletConnectivityHandle,
         output_manager_service: OutputManagerHandle,
         transaction_service: TransactionServiceHandle,
         node_identity: Arc<NodeIdentity>,
@@ -180,6 +233,7 @@ impl UtxoScannerServiceBuilder {
         let resources = UtxoScannerResources {
             db,
             connectivity,
+            wallet_connectivity,
             output_manager_service,
             transaction_service,
             node_identity,
@@ -213,6 +267,7 @@ where TBackend: WalletBackend + 'static
     peer_index: usize,
     mode: UtxoScannerMode,
     run_flag: Arc<AtomicBool>,
+    statistics: ScanningStatistics,
 }
 impl<TBackend> UtxoScannerTask<TBackend>
 where TBackend: WalletBackend + 'static
@@ -228,6 +283,11 @@ where TBackend: WalletBackend + 'static
             current_block: final_utxo_pos,
             current_chain_height: final_utxo_pos,
         });
+        self.publish_event(UtxoScannerEvent::ScanningStatistics {
+            rewind_time: self.statistics.rewind_time,
+            import_time: self.statistics.import_time,
+            persist_time: self.statistics.persist_time,
+        });
         self.publish_event(UtxoScannerEvent::Completed {
             number_scanned: total_scanned,
             number_received: metadata.number_of_utxos,
@@ -266,15 +326,14 @@ where TBackend: WalletBackend + 'static
     async fn attempt_sync(&mut self, peer: NodeId) -> Result<(u64, u64, Duration), UtxoScannerError> {
         let mut connection = self.connect_to_peer(peer.clone()).await?;
 
-        let mut client = connection
-            .connect_rpc_using_builder(BaseNodeSyncRpcClient::builder().with_deadline(Duration::from_secs(60)))
-            .await?;
+        let mut client = self.connect_sync_client(&mut connection).await?;
 
         let latency = client.get_last_request_latency().await?;
         self.publish_event(UtxoScannerEvent::ConnectedToBaseNode(
             peer.clone(),
             latency.unwrap_or_default(),
         ));
+        let mut helper_connections = self.connect_to_helper_peers(&peer).await;
 
         let timer = Instant::now();
         let mut total_scanned = 0u64;
@@ -296,7 +355,7 @@ where TBackend: WalletBackend + 'static
             );
             // start_index could be greater than output_mmr_size if we switch to a new peer that is behind the original
             // peer. In the common case, we wait for start index.
-            if start_index >= output_mmr_size - 1 {
+            if start_index >= output_mmr_size {
                 debug!(
                     target: LOG_TARGET,
                     "Scanning complete UTXO #{} in {:.2?}",
@@ -306,7 +365,23 @@ where TBackend: WalletBackend + 'static
                 return Ok((total_scanned, start_index, timer.elapsed()));
             }
 
-            let num_scanned = self.scan_utxos(&mut client, start_index, tip_header).await?;
+            // Every sync peer downloads segments over its own RPC session. The sessions are opened per round so that a
+            // helper peer that failed in the previous round gets another chance.
+            let mut clients = vec![(peer.clone(), self.connect_sync_client(&mut connection).await?)];
+            for (helper_peer, helper_connection) in helper_connections.iter_mut() {
+                match helper_connection
+                    .connect_rpc_using_builder(BaseNodeSyncRpcClient::builder().with_deadline(SYNC_RPC_DEADLINE))
+                    .await
+                {
+                    Ok(helper_client) => clients.push((helper_peer.clone(), helper_client.into())),
+                    Err(e) => warn!(
+                        target: LOG_TARGET,
+                        "Not using sync peer {} for this scanning round: {}", helper_peer, e
+                    ),
+                }
+            }
+
+            let num_scanned = self.scan_utxos(clients, start_index, tip_header).await?;
             debug!(
                 target: LOG_TARGET,
                 "Scanning round completed UTXO #{} in {:.2?} ({} scanned)",
@@ -318,6 +393,62 @@ where TBackend: WalletBackend + 'static
         }
     }
 
+    /// Obtain a sync RPC session to the peer of the connection. A warm session from the wallet connectivity pool is
+    /// used if the peer is the wallet's base node, otherwise a new session is connected.
+    async fn connect_sync_client(
+        &self,
+        connection: &mut PeerConnection,
+    ) -> Result<RpcClientLease<BaseNodeSyncRpcClient>, UtxoScannerError> {
+        let pooled_client = self
+            .resources
+            .wallet_connectivity
+            .obtain_base_node_sync_rpc_client(connection.peer_node_id(), SYNC_RPC_DEADLINE)
+            .await;
+        match pooled_client {
+            Some(client) => Ok(client),
+            None => {
+                let client = connection
+                    .connect_rpc_using_builder(BaseNodeSyncRpcClient::builder().with_deadline(SYNC_RPC_DEADLINE))
+                    .await?;
+                Ok(client.into())
+            },
+        }
+    }
+
+    /// Connect to the other sync peers so that they can share the download with the peer the scan is synced against.
+    /// Peers that cannot be reached are left out.
+    async fn connect_to_helper_peers(&self, peer: &NodeId) -> Vec<(NodeId, PeerConnection)> {
+        let helper_peers = self
+            .peer_seeds
+            .iter()
+            .map(NodeId::from_public_key)
+            .filter(|p| p != peer)
+            .take(MAX_SYNC_PEERS - 1)
+            .collect::<Vec<_>>();
+        let dials = helper_peers.into_iter().map(|helper_peer| {
+            let mut connectivity = self.resources.connectivity.clone();
+            async move {
+                let result = connectivity.dial_peer(helper_peer.clone()).await;
+                (helper_peer, result)
+            }
+        });
+
+        future::join_all(dials)
+            .await
+            .into_iter()
+            .filter_map(|(helper_peer, result)| match result {
+                Ok(conn) => Some((helper_peer, conn)),
+                Err(e) => {
+                    debug!(
+                        target: LOG_TARGET,
+                        "Could not connect to sync peer {}, the scan will continue without it: {}", helper_peer, e
+                    );
+                    None
+                },
+            })
+            .collect()
+    }
+
     async fn get_chain_tip_header(&self, client: &mut BaseNodeSyncRpcClient) -> Result<BlockHeader, UtxoScannerError> {
         let chain_metadata = client.get_chain_metadata().await?;
         let chain_height = chain_metadata.height_of_longest_chain();
@@ -356,16 +487,17 @@ where TBackend: WalletBackend + 'static
 
     async fn scan_utxos(
         &mut self,
-        client: &mut BaseNodeSyncRpcClient,
+        mut clients: Vec<(NodeId, RpcClientLease<BaseNodeSyncRpcClient>)>,
         start_mmr_leaf_index: u64,
         end_header: BlockHeader,
     ) -> Result<u64, UtxoScannerError> {
         debug!(
             target: LOG_TARGET,
-            "Scanning UTXO's from #{} to #{} (height {})",
+            "Scanning UTXO's from #{} to #{} (height {}) using {} sync peer(s)",
             start_mmr_leaf_index,
             end_header.output_mmr_size,
-            end_header.height
+            end_header.height,
+            clients.len()
         );
 
         let end_header_hash = end_header.hash();
@@ -373,56 +505,117 @@ where TBackend: WalletBackend + 'static
         let mut num_recovered = 0u64;
         let mut total_amount = MicroTari::from(0);
         let mut total_scanned = 0;
+        let scan_start = Instant::now();
 
         self.publish_event(UtxoScannerEvent::Progress {
             current_block: start_mmr_leaf_index,
             current_chain_height: (end_header_size - 1),
         });
-        let request = SyncUtxosRequest {
-            start: start_mmr_leaf_index,
-            end_header_hash: end_header_hash.clone(),
-            include_pruned_utxos: false,
-            include_deleted_bitmaps: false,
+
+        // Segments completed past the frontier of an interrupted scan are only valid if the scan resumes from that
+        // frontier, a reorg causes everything to be scanned again
+        let metadata = self.get_metadata().await?.unwrap_or_default();
+        let mut completed_segments = if metadata.utxo_index == start_mmr_leaf_index {
+            metadata.completed_segments
+        } else {
+            Vec::new()
         };
+        let mut frontier = start_mmr_leaf_index;
+
+        // Only one-sided payments are looked for when scanning, so the outputs of blocks whose filter matches none of
+        // the known scripts do not have to be downloaded. Recovery has to rewind every output.
+        if self.mode == UtxoScannerMode::Scanning {
+            if let Some((_, client)) = clients.first_mut() {
+                let unmatched = self
+                    .fetch_unmatched_block_ranges(client, start_mmr_leaf_index, end_header_hash.clone())
+                    .await?;
+                if !unmatched.is_empty() {
+                    for segment in unmatched {
+                        record_completed_segment(&mut frontier, &mut completed_segments, segment);
+                    }
+                    self.update_scanning_progress_in_db(
+                        frontier,
+                        completed_segments.clone(),
+                        MicroTari::from(0),
+                        0,
+                        end_header_hash.clone(),
+                    )
+                    .await?;
+                }
+            }
+        }
+
+        let segments = plan_segments(frontier, end_header_size, UTXO_SEGMENT_SIZE, &completed_segments);
+        let queue = Arc::new(SegmentQueue::new(segments));
 
-        let utxo_stream = client.sync_utxos(request).await?;
-        // We download in chunks just because rewind_outputs works with multiple outputs (and could parallelized
-        // rewinding)
-        let mut utxo_stream = utxo_stream.chunks(10);
-        let mut last_utxo_index = 0u64;
-        let mut iteration_count = 0u64;
-        while let Some(response) = utxo_stream.next().await {
+        let (event_sender, event_receiver) = mpsc::channel(SEGMENT_EVENT_BUFFER_SIZE);
+        for (peer, client) in clients {
+            task::spawn(
+                SegmentDownloader {
+                    peer,
+                    client,
+                    end_header_hash: end_header_hash.clone(),
+                    max_batch_size: MAX_SCAN_BATCH_SIZE,
+                    queue: queue.clone(),
+                    events: event_sender.clone(),
+                    run_flag: self.run_flag.clone(),
+                }
+                .run(),
+            );
+        }
+        // The event stream ends once every downloader has finished
+        drop(event_sender);
+        let mut events = event_receiver;
+        while let Some(event) = events.next().await {
             if !self.run_flag.load(Ordering::Relaxed) {
                 // if running is set to false, we know its been canceled upstream so lets exit the loop
                 return Ok(total_scanned as u64);
             }
-            let (outputs, utxo_index) = convert_response_to_transaction_outputs(response, last_utxo_index)?;
-            last_utxo_index = utxo_index;
-            total_scanned += outputs.len();
-            iteration_count += 1;
-            let found_outputs = self.scan_for_outputs(outputs).await?;
-
-            // Reduce the number of db hits by only persisting progress every N iterations
-            const COMMIT_EVERY_N: u64 = 100;
-            if iteration_count % COMMIT_EVERY_N == 0 || last_utxo_index >= end_header_size - 1 {
-                self.publish_event(UtxoScannerEvent::Progress {
-                    current_block: last_utxo_index,
-                    current_chain_height: (end_header_size - 1),
-                });
-                self.update_scanning_progress_in_db(
-                    last_utxo_index,
-                    total_amount,
-                    num_recovered,
-                    end_header_hash.clone(),
-                )
-                .await?;
+            match event {
+                SegmentEvent::Outputs(outputs) => {
+                    total_scanned += outputs.len();
+                    OUTPUTS_SCANNED.inc_by(outputs.len() as u64);
+                    let timer = Instant::now();
+                    let found_outputs = self.scan_for_outputs(outputs).await?;
+                    let rewind_time = timer.elapsed();
+                    self.statistics.rewind_time += rewind_time;
+                    REWIND_DURATION.observe(rewind_time);
+                    let timer = Instant::now();
+                    let (count, amount) = self.import_utxos_to_transaction_service(found_outputs).await?;
+                    self.statistics.import_time += timer.elapsed();
+                    OUTPUTS_RECOVERED.inc_by(count);
+                    SCAN_RATE.set((total_scanned as f64 / scan_start.elapsed().as_secs_f64()) as i64);
+                    num_recovered = num_recovered.saturating_add(count);
+                    total_amount += amount;
+                },
+                SegmentEvent::Completed(segment) => {
+                    record_completed_segment(&mut frontier, &mut completed_segments, segment);
+                    let timer = Instant::now();
+                    self.update_scanning_progress_in_db(
+                        frontier,
+                        completed_segments.clone(),
+                        total_amount,
+                        num_recovered,
+                        end_header_hash.clone(),
+                    )
+                    .await?;
+                    self.statistics.persist_time += timer.elapsed();
+                    num_recovered = 0;
+                    total_amount = MicroTari::from(0);
+                    self.publish_event(UtxoScannerEvent::Progress {
+                        current_block: frontier,
+                        current_chain_height: (end_header_size - 1),
+                    });
+                },
             }
-            let (count, amount) = self.import_utxos_to_transaction_service(found_outputs).await?;
-            num_recovered = num_recovered.saturating_add(count);
-            total_amount += amount;
         }
-        self.update_scanning_progress_in_db(last_utxo_index, total_amount, num_recovered, end_header_hash)
-            .await?;
+
+        if frontier < end_header_size {
+            return Err(UtxoScannerError::UtxoScanningError(format!(
+                "All sync peers failed with UTXOs {}-{} left to scan",
+                frontier, end_header_size
+            )));
+        }
         self.publish_event(UtxoScannerEvent::Progress {
             current_block: (end_header_size - 1),
             current_chain_height: (end_header_size - 1),
@@ -430,9 +623,82 @@ where TBackend: WalletBackend + 'static
         Ok(total_scanned as u64)
     }
 
+    /// Fetch the compact block filters from `start` to the end header and return the output ranges of the blocks that
+    /// cannot contain an output with one of the known one-sided payment scripts. Nothing is skipped if the base node
+    /// does not serve filters, blocks without a filter are always scanned.
+    async fn fetch_unmatched_block_ranges(
+        &mut self,
+        client: &mut BaseNodeSyncRpcClient,
+        start: u64,
+        end_header_hash: HashOutput,
+    ) -> Result<Vec<UtxoSegment>, UtxoScannerError> {
+        let scripts = self
+            .resources
+            .output_manager_service
+            .get_known_one_sided_payment_scripts()
+            .await?
+            .iter()
+            .map(|s| s.as_bytes())
+            .collect::<Vec<_>>();
+
+        let request = SyncBlockFiltersRequest { start, end_header_hash };
+        let mut filter_stream = match client.sync_block_filters(request).await {
+            Ok(stream) => stream,
+            Err(e) => {
+                debug!(
+                    target: LOG_TARGET,
+                    "Base node did not serve block filters, scanning every output: {}", e
+                );
+                return Ok(Vec::new());
+            },
+        };
+
+        let mut unmatched: Vec<UtxoSegment> = Vec::new();
+        let mut position = start;
+        let mut num_blocks = 0;
+        while let Some(response) = filter_stream.next().await {
+            let response = match response {
+                Ok(r) => r,
+                Err(e) => {
+                    // The ranges received so far are still valid, the rest is scanned in full
+                    debug!(target: LOG_TARGET, "Block filter stream failed: {}", e);
+                    break;
+                },
+            };
+            let segment = UtxoSegment::new(position, response.output_mmr_size);
+            position = position.max(response.output_mmr_size);
+            num_blocks += 1;
+            if segment.is_empty() || response.filter.is_empty() {
+                continue;
+            }
+            let is_match = BlockFilter::from_bytes(&response.filter)
+                .map(|filter| filter.matches_any(&response.header_hash, scripts.iter().map(|s| s.as_slice())))
+                .unwrap_or(true);
+            if is_match {
+                continue;
+            }
+            match unmatched.last_mut() {
+                Some(last) if last.end == segment.start => last.end = segment.end,
+                _ => unmatched.push(segment),
+            }
+        }
+        debug!(
+            target: LOG_TARGET,
+            "Block filters of {} block(s) leave {} of {} UTXO(s) to scan",
+            num_blocks,
+            position.saturating_sub(start) - unmatched.iter().map(|s| s.len()).sum::<u64>(),
+            position.saturating_sub(start)
+        );
+        Ok(unmatched)
+    }
+
+    /// Persist the scanning progress. `utxo_index` is the position up to which every UTXO has been scanned and
+    /// `completed_segments` the segments beyond it that have been scanned, the recovered totals are added to the stored
+    /// totals.
     async fn update_scanning_progress_in_db(
         &self,
-        last_utxo_index: u64,
+        utxo_index: u64,
+        completed_segments: Vec<UtxoSegment>,
         total_amount: MicroTari,
         num_recovered: u64,
         end_header_hash: Vec<u8>,
@@ -440,7 +706,8 @@ where TBackend: WalletBackend + 'static
         let mut meta_data = self.get_metadata().await?.unwrap_or_default();
         meta_data.height_hash = end_header_hash;
         meta_data.number_of_utxos += num_recovered;
-        meta_data.utxo_index = last_utxo_index;
+        meta_data.utxo_index = utxo_index;
+        meta_data.completed_segments = completed_segments;
         meta_data.total_amount += total_amount;
 
         self.set_metadata(meta_data).await?;
@@ -678,6 +945,7 @@ where TBackend: WalletBackend + 'static
             num_retries: 0,
             mode: self.mode.clone(),
             run_flag: self.is_running.clone(),
+            statistics: ScanningStatistics::default(),
         }
     }
 
@@ -759,44 +1027,12 @@ where TBackend: WalletBackend + 'static
     }
 }
 
-fn convert_response_to_transaction_outputs(
-    response: Vec<Result<proto::base_node::SyncUtxosResponse, RpcStatus>>,
-    last_utxo_index: u64,
-) -> Result<(Vec<TransactionOutput>, u64), UtxoScannerError> {
-    let response: Vec<proto::base_node::SyncUtxosResponse> = response
-        .into_iter()
-        .map(|v| v.map_err(|e| UtxoScannerError::RpcStatus(e.to_string())))
-        .collect::<Result<Vec<_>, _>>()?;
-
-    let current_utxo_index = response
-    // Assumes correct ordering which is otherwise not required for this protocol
-    .last()
-    .ok_or_else(|| {
-        UtxoScannerError::BaseNodeResponseError("Invalid response from base node: response was empty".to_string())
-    })?
-    .mmr_index;
-    if current_utxo_index < last_utxo_index {
-        return Err(UtxoScannerError::BaseNodeResponseError(
-            "Invalid response from base node: mmr index must be non-decreasing".to_string(),
-        ));
-    }
-
-    let outputs = response
-        .into_iter()
-        .filter_map(|utxo| {
-            utxo.into_utxo()
-                .and_then(|o| o.utxo)
-                .and_then(|utxo| utxo.into_transaction_output())
-                .map(|output| TransactionOutput::try_from(output).map_err(|_| UtxoScannerError::ConversionError))
-        })
-        .collect::<Result<Vec<_>, _>>()?;
-    Ok((outputs, current_utxo_index))
-}
-
 #[derive(Default, Serialize, Deserialize)]
 struct ScanningMetadata {
     pub total_amount: MicroTari,
     pub number_of_utxos: u64,
     pub utxo_index: u64,
     pub height_hash: HashOutput,
+    #[serde(default)]
+    pub completed_segments: Vec<UtxoSegment>,
 }
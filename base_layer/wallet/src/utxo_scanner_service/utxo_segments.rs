@@ -0,0 +1,404 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! Splits the output MMR range of a UTXO scan into segments that are downloaded from several base nodes at once.
+//! Each sync peer runs a download worker that takes segments from a shared queue, so faster peers take more of the
+//! work. A worker whose peer fails hands the rest of its segment back to the queue for the other peers, which keep
+//! running until every segment has been downloaded.
+
+use crate::utxo_scanner_service::{error::UtxoScannerError, utxo_scanning::LOG_TARGET};
+use futures::{channel::mpsc, SinkExt, StreamExt};
+use log::*;
+use serde::{Deserialize, Serialize};
+use std::{
+    collections::VecDeque,
+    convert::TryFrom,
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        Arc,
+        Mutex,
+    },
+    time::Duration,
+};
+use tari_comms::{
+    peer_manager::NodeId,
+    protocol::rpc::{RpcClientLease, RpcStatus},
+};
+use tari_core::{
+    base_node::sync::rpc::BaseNodeSyncRpcClient,
+    proto::base_node::{SyncUtxosRequest, SyncUtxosResponse},
+    transactions::transaction::TransactionOutput,
+};
+use tokio::{sync::Notify, time};
+
+/// How often an idle worker checks whether the scan has been stopped while it waits for segments to be handed back
+const IDLE_CHECK_INTERVAL: Duration = Duration::from_secs(1);
+
+/// A range `[start, end)` of output MMR positions
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub struct UtxoSegment {
+    pub start: u64,
+    pub end: u64,
+}
+
+impl UtxoSegment {
+    pub fn new(start: u64, end: u64) -> Self {
+        Self { start, end }
+    }
+
+    pub fn len(&self) -> u64 {
+        self.end.saturating_sub(self.start)
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+/// Split the positions in `[start, end)` into segments of at most `segment_size` positions, leaving out the
+/// positions covered by the `completed` segments
+pub fn plan_segments(start: u64, end: u64, segment_size: u64, completed: &[UtxoSegment]) -> Vec<UtxoSegment> {
+    let segment_size = segment_size.max(1);
+    let mut completed = completed.to_vec();
+    completed.sort_by_key(|s| s.start);
+
+    let mut segments = Vec::new();
+    let mut position = start;
+    for done in completed.iter().chain(Some(&UtxoSegment::new(end, end))) {
+        let gap_end = done.start.min(end);
+        while position < gap_end {
+            let segment_end = position.saturating_add(segment_size).min(gap_end);
+            segments.push(UtxoSegment::new(position, segment_end));
+            position = segment_end;
+        }
+        position = position.max(done.end);
+    }
+    segments
+}
+
+/// Record a completed segment. `frontier` is the position below which every output has been scanned, it is advanced
+/// over the completed segments that now join up with it and those are removed from `completed`.
+pub fn record_completed_segment(frontier: &mut u64, completed: &mut Vec<UtxoSegment>, segment: UtxoSegment) {
+    if segment.is_empty() {
+        return;
+    }
+    completed.push(segment);
+    completed.sort_by_key(|s| s.start);
+    let mut joined = 0;
+    for s in completed.iter() {
+        if s.start > *frontier {
+            break;
+        }
+        *frontier = (*frontier).max(s.end);
+        joined += 1;
+    }
+    completed.drain(..joined);
+}
+
+/// The segments still to be downloaded, shared by the download workers. The queue is finished once it is empty and
+/// no worker holds a segment, until then an idle worker waits in case a failed worker hands the rest of its segment
+/// back.
+pub struct SegmentQueue {
+    state: Mutex<SegmentQueueState>,
+    changed: Notify,
+}
+
+struct SegmentQueueState {
+    pending: VecDeque<UtxoSegment>,
+    num_in_progress: usize,
+}
+
+pub enum NextSegment {
+    Segment(UtxoSegment),
+    Wait,
+    Finished,
+}
+
+impl SegmentQueue {
+    pub fn new<I: IntoIterator<Item = UtxoSegment>>(segments: I) -> Self {
+        Self {
+            state: Mutex::new(SegmentQueueState {
+                pending: segments.into_iter().collect(),
+                num_in_progress: 0,
+            }),
+            changed: Notify::new(),
+        }
+    }
+
+    /// Take the next segment. A segment that is taken must be passed to `complete` or `hand_back`.
+    pub fn try_take(&self) -> NextSegment {
+        let mut state = acquire_lock!(self.state);
+        match state.pending.pop_front() {
+            Some(segment) => {
+                state.num_in_progress += 1;
+                NextSegment::Segment(segment)
+            },
+            None if state.num_in_progress > 0 => NextSegment::Wait,
+            None => {
+                // Wake the next idle worker so that it sees the queue is finished as well
+                self.changed.notify();
+                NextSegment::Finished
+            },
+        }
+    }
+
+    /// Wait until a segment is handed back or completed, or the timeout elapses
+    pub async fn wait(&self, timeout: Duration) {
+        let _ = time::timeout(timeout, self.changed.notified()).await;
+    }
+
+    pub fn complete(&self) {
+        acquire_lock!(self.state).num_in_progress -= 1;
+        self.changed.notify();
+    }
+
+    /// Return the part of a taken segment that was not downloaded to the front of the queue
+    pub fn hand_back(&self, remaining: UtxoSegment) {
+        {
+            let mut state = acquire_lock!(self.state);
+            state.num_in_progress -= 1;
+            if !remaining.is_empty() {
+                state.pending.push_front(remaining);
+            }
+        }
+        self.changed.notify();
+    }
+}
+
+/// Sent from the download workers to the scanner. The events of one worker arrive in the order they were sent, so a
+/// segment is only reported as completed after all of its outputs have been delivered.
+pub enum SegmentEvent {
+    Outputs(Vec<TransactionOutput>),
+    Completed(UtxoSegment),
+}
+
+pub struct SegmentDownloader {
+    pub peer: NodeId,
+    pub client: RpcClientLease<BaseNodeSyncRpcClient>,
+    pub end_header_hash: Vec<u8>,
+    pub max_batch_size: usize,
+    pub queue: Arc<SegmentQueue>,
+    pub events: mpsc::Sender<SegmentEvent>,
+    pub run_flag: Arc<AtomicBool>,
+}
+
+impl SegmentDownloader {
+    /// Download segments from the queue until every segment has been downloaded, the scan is stopped or the peer fails
+    pub async fn run(mut self) {
+        loop {
+            if !self.run_flag.load(Ordering::Relaxed) || self.events.is_closed() {
+                return;
+            }
+            let segment = match self.queue.try_take() {
+                NextSegment::Segment(segment) => segment,
+                NextSegment::Wait => {
+                    self.queue.wait(IDLE_CHECK_INTERVAL).await;
+                    continue;
+                },
+                NextSegment::Finished => return,
+            };
+
+            let mut next_position = segment.start;
+            let result = self.download_segment(segment, &mut next_position).await;
+            let downloaded = UtxoSegment::new(segment.start, next_position);
+            match result {
+                Ok(()) => {
+                    let sent = self.events.send(SegmentEvent::Completed(segment)).await;
+                    self.queue.complete();
+                    if sent.is_err() {
+                        return;
+                    }
+                },
+                Err(err) => {
+                    warn!(
+                        target: LOG_TARGET,
+                        "Failed to download UTXOs {}-{} from {}: {}. Returning the remaining UTXOs to the other peers",
+                        next_position,
+                        segment.end,
+                        self.peer,
+                        err
+                    );
+                    let _ = self.events.send(SegmentEvent::Completed(downloaded)).await;
+                    self.queue.hand_back(UtxoSegment::new(next_position, segment.end));
+                    return;
+                },
+            }
+        }
+    }
+
+    async fn download_segment(
+        &mut self,
+        segment: UtxoSegment,
+        next_position: &mut u64,
+    ) -> Result<(), UtxoScannerError> {
+        trace!(
+            target: LOG_TARGET,
+            "Downloading UTXOs {}-{} from {}",
+            segment.start,
+            segment.end,
+            self.peer
+        );
+        let request = SyncUtxosRequest {
+            start: segment.start,
+            end_header_hash: self.end_header_hash.clone(),
+            include_pruned_utxos: false,
+            include_deleted_bitmaps: false,
+            end_mmr_index: segment.end,
+        };
+        // The base node stops streaming at the end of the segment
+        let mut utxo_stream = self.client.sync_utxos(request).await?.ready_chunks(self.max_batch_size);
+        while let Some(response) = utxo_stream.next().await {
+            let (outputs, last_position, reached_end) =
+                convert_segment_response(response, *next_position, segment.end)?;
+            if !outputs.is_empty() && self.events.send(SegmentEvent::Outputs(outputs)).await.is_err() {
+                return Err(UtxoScannerError::UtxoScanningError("The scan has stopped".to_string()));
+            }
+            *next_position = last_position.map(|p| p + 1).unwrap_or(*next_position);
+            if reached_end {
+                break;
+            }
+        }
+        *next_position = segment.end;
+        Ok(())
+    }
+}
+
+/// Convert a batch of responses into the outputs that fall within the segment. Returns the outputs, the position of
+/// the last one and whether the stream has passed the end of the segment.
+fn convert_segment_response(
+    response: Vec<Result<SyncUtxosResponse, RpcStatus>>,
+    next_position: u64,
+    segment_end: u64,
+) -> Result<(Vec<TransactionOutput>, Option<u64>, bool), UtxoScannerError> {
+    let response = response
+        .into_iter()
+        .map(|v| v.map_err(|e| UtxoScannerError::RpcStatus(e.to_string())))
+        .collect::<Result<Vec<_>, _>>()?;
+
+    let mut outputs = Vec::with_capacity(response.len());
+    let mut last_position = None;
+    let mut reached_end = false;
+    for utxo in response {
+        if utxo.mmr_index < next_position {
+            return Err(UtxoScannerError::BaseNodeResponseError(
+                "Invalid response from base node: mmr index must be non-decreasing".to_string(),
+            ));
+        }
+        if utxo.mmr_index >= segment_end {
+            reached_end = true;
+            break;
+        }
+        last_position = Some(utxo.mmr_index);
+        if segment_end - 1 == utxo.mmr_index {
+            reached_end = true;
+        }
+        if let Some(output) = utxo
+            .into_utxo()
+            .and_then(|o| o.utxo)
+            .and_then(|utxo| utxo.into_transaction_output())
+        {
+            outputs.push(TransactionOutput::try_from(output).map_err(|_| UtxoScannerError::ConversionError)?);
+        }
+    }
+    Ok((outputs, last_position, reached_end))
+}
+
+#[cfg(test)]
+mod test {
+    use crate::utxo_scanner_service::utxo_segments::{
+        plan_segments,
+        record_completed_segment,
+        NextSegment,
+        SegmentQueue,
+        UtxoSegment,
+    };
+
+    #[test]
+    fn test_plan_segments() {
+        assert!(plan_segments(0, 0, 10, &[]).is_empty());
+
+        let expected = vec![
+            UtxoSegment::new(0, 10),
+            UtxoSegment::new(10, 20),
+            UtxoSegment::new(20, 25),
+        ];
+        assert_eq!(plan_segments(0, 25, 10, &[]), expected);
+
+        let completed = vec![UtxoSegment::new(20, 30), UtxoSegment::new(12, 15)];
+        let expected = vec![
+            UtxoSegment::new(5, 12),
+            UtxoSegment::new(15, 20),
+            UtxoSegment::new(30, 40),
+        ];
+        assert_eq!(plan_segments(5, 40, 10, &completed), expected);
+
+        let completed = vec![UtxoSegment::new(15, 30)];
+        let expected = vec![UtxoSegment::new(0, 10), UtxoSegment::new(10, 15)];
+        assert_eq!(plan_segments(0, 20, 10, &completed), expected);
+    }
+
+    #[test]
+    fn test_record_completed_segment() {
+        let mut frontier = 0;
+        let mut completed = Vec::new();
+        record_completed_segment(&mut frontier, &mut completed, UtxoSegment::new(20, 30));
+        record_completed_segment(&mut frontier, &mut completed, UtxoSegment::new(10, 15));
+        assert_eq!(frontier, 0);
+        assert_eq!(completed, vec![UtxoSegment::new(10, 15), UtxoSegment::new(20, 30)]);
+
+        record_completed_segment(&mut frontier, &mut completed, UtxoSegment::new(0, 10));
+        assert_eq!(frontier, 15);
+        assert_eq!(completed, vec![UtxoSegment::new(20, 30)]);
+
+        record_completed_segment(&mut frontier, &mut completed, UtxoSegment::new(15, 15));
+        assert_eq!(frontier, 15);
+        record_completed_segment(&mut frontier, &mut completed, UtxoSegment::new(15, 20));
+        assert_eq!(frontier, 30);
+        assert!(completed.is_empty());
+    }
+
+    #[test]
+    fn test_segment_queue_waits_for_handed_back_segments() {
+        let queue = SegmentQueue::new(vec![UtxoSegment::new(0, 10), UtxoSegment::new(10, 20)]);
+        let first = match queue.try_take() {
+            NextSegment::Segment(segment) => segment,
+            _ => panic!("Expected a segment"),
+        };
+        let second = match queue.try_take() {
+            NextSegment::Segment(segment) => segment,
+            _ => panic!("Expected a segment"),
+        };
+        assert_eq!(second, UtxoSegment::new(10, 20));
+
+        // The queue is empty but the first segment may still be handed back
+        assert!(matches!(queue.try_take(), NextSegment::Wait));
+        queue.complete();
+        assert!(matches!(queue.try_take(), NextSegment::Wait));
+        queue.hand_back(UtxoSegment::new(first.start + 4, first.end));
+        match queue.try_take() {
+            NextSegment::Segment(segment) => assert_eq!(segment, UtxoSegment::new(4, 10)),
+            _ => panic!("Expected the handed back segment"),
+        }
+        queue.complete();
+        assert!(matches!(queue.try_take(), NextSegment::Finished));
+    }
+}
@@ -23,10 +23,11 @@
 use crate::{
     base_node_service::{handle::BaseNodeServiceHandle, BaseNodeServiceInitializer},
     config::{WalletConfig, KEY_MANAGER_COMMS_SECRET_KEY_BRANCH_KEY},
+    connectivity_service::{WalletConnectivityHandle, WalletConnectivityInitializer},
     contacts_service::{handle::ContactsServiceHandle, storage::database::ContactsBackend, ContactsServiceInitializer},
-    error::WalletError,
+    error::{WalletError, WalletStorageError},
     output_manager_service::{
-        error::OutputManagerError,
+        error::{OutputManagerError, OutputManagerStorageError},
         handle::OutputManagerHandle,
         storage::{database::OutputManagerBackend, models::KnownOneSidedPaymentScript},
         OutputManagerServiceInitializer,
@@ -34,11 +35,13 @@ use crate::{
     },
     storage::database::{WalletBackend, WalletDatabase},
     transaction_service::{
+        error::{TransactionServiceError, TransactionStorageError},
         handle::TransactionServiceHandle,
         storage::database::TransactionBackend,
         TransactionServiceInitializer,
     },
     types::KeyDigest,
+    util::encryption::EncryptionProgress,
     utxo_scanner_service::{handle::UtxoScannerHandle, UtxoScannerServiceInitializer},
 };
 use aes_gcm::{
@@ -46,6 +49,7 @@ use aes_gcm::{
     Aes256Gcm,
 };
 use digest::Digest;
+use futures::future;
 use log::*;
 use rand::rngs::OsRng;
 use std::{marker::PhantomData, sync::Arc};
@@ -98,6 +102,7 @@ where
     pub contacts_service: ContactsServiceHandle,
     pub base_node_service: BaseNodeServiceHandle,
     pub utxo_scanner_service: UtxoScannerHandle,
+    pub wallet_connectivity: WalletConnectivityHandle,
     pub db: WalletDatabase<T>,
     pub factories: CryptoFactories,
     #[cfg(feature = "test_harness")]
@@ -167,6 +172,7 @@ where
         );
         let stack = StackBuilder::new(shutdown_signal)
             .add_initializer(P2pInitializer::new(comms_config, publisher))
+            .add_initializer(WalletConnectivityInitializer::new(config.connectivity_config))
             .add_initializer(OutputManagerServiceInitializer::new(
                 config.output_manager_service_config.unwrap_or_default(),
                 output_manager_backend,
@@ -198,7 +204,6 @@ where
         let comms = handles
             .take_handle::<UnspawnedCommsNode>()
             .expect("P2pInitializer was not added to the stack");
-        let comms = initialization::spawn_comms_using_transport(comms, transport_type).await?;
 
         let mut output_manager_handle = handles.expect_handle::<OutputManagerHandle>();
         let transaction_service_handle = handles.expect_handle::<TransactionServiceHandle>();
@@ -208,13 +213,21 @@ where
 
         let base_node_service_handle = handles.expect_handle::<BaseNodeServiceHandle>();
         let utxo_scanner_service_handle = handles.expect_handle::<UtxoScannerHandle>();
-
-        persist_one_sided_payment_script_for_node_identity(&mut output_manager_handle, comms.node_identity())
-            .await
-            .map_err(|e| {
-                error!(target: LOG_TARGET, "{:?}", e);
-                e
-            })?;
+        let wallet_connectivity = handles.expect_handle::<WalletConnectivityHandle>();
+
+        // Spawning comms waits on the transport (e.g. Tor bootstrap), the one-sided payment script only needs the node
+        // identity so the two run concurrently
+        let spawn_comms = async {
+            initialization::spawn_comms_using_transport(comms, transport_type)
+                .await
+                .map_err(WalletError::from)
+        };
+        let persist_script =
+            persist_one_sided_payment_script_for_node_identity(&mut output_manager_handle, node_identity.clone());
+        let (comms, _) = future::try_join(spawn_comms, persist_script).await.map_err(|e| {
+            error!(target: LOG_TARGET, "{:?}", e);
+            e
+        })?;
 
         // Persist the comms node address and features after it has been spawned to capture any modifications made
         // during comms startup. In the case of a Tor Transport the public address could have been generated
@@ -234,6 +247,7 @@ where
             contacts_service: contacts_handle,
             base_node_service: base_node_service_handle,
             utxo_scanner_service: utxo_scanner_service_handle,
+            wallet_connectivity,
             db: wallet_database,
             factories,
             #[cfg(feature = "test_harness")]
@@ -291,6 +305,8 @@ where
             .set_base_node_public_key(peer.public_key.clone())
             .await?;
 
+        self.wallet_connectivity.set_base_node(peer.node_id.clone()).await?;
+
         self.base_node_service.set_base_node_peer(peer).await?;
 
         Ok(())
@@ -441,23 +457,81 @@ where
     /// Apply encryption to all the Wallet db backends. The Wallet backend will test if the db's are already encrypted
     /// in which case this will fail.
     pub async fn apply_encryption(&mut self, passphrase: String) -> Result<(), WalletError> {
+        self.apply_encryption_with_progress(passphrase, EncryptionProgress::default())
+            .await
+    }
+
+    /// Apply encryption to all the Wallet db backends, reporting the number of rows encrypted to `progress`. The
+    /// wallet db is encrypted first, recording the passes over the remaining backends at the same time, so that if the
+    /// process is interrupted the wallet has to be opened with the passphrase and opening it completes those passes.
+    pub async fn apply_encryption_with_progress(
+        &mut self,
+        passphrase: String,
+        progress: EncryptionProgress,
+    ) -> Result<(), WalletError> {
         debug!(target: LOG_TARGET, "Applying wallet encryption.");
         let passphrase_hash = Blake256::new().chain(passphrase.as_bytes()).finalize();
         let key = GenericArray::from_slice(passphrase_hash.as_slice());
         let cipher = Aes256Gcm::new(key);
 
-        self.db.apply_encryption(cipher.clone()).await?;
-        self.output_manager_service.apply_encryption(cipher.clone()).await?;
-        self.transaction_service.apply_encryption(cipher).await?;
+        let db_result = self.db.apply_encryption(cipher.clone()).await;
+        let db_already_encrypted = match db_result {
+            Err(WalletStorageError::AlreadyEncrypted) => true,
+            r => {
+                r?;
+                false
+            },
+        };
+
+        let oms_result = self
+            .output_manager_service
+            .apply_encryption_with_progress(cipher.clone(), progress.clone())
+            .await;
+        let oms_already_encrypted = match oms_result {
+            Err(OutputManagerError::OutputManagerStorageError(OutputManagerStorageError::AlreadyEncrypted)) => true,
+            r => {
+                r?;
+                false
+            },
+        };
+
+        let ts_result = self
+            .transaction_service
+            .apply_encryption_with_progress(cipher, progress)
+            .await;
+        let ts_already_encrypted = match ts_result {
+            Err(TransactionServiceError::TransactionStorageError(TransactionStorageError::AlreadyEncrypted)) => true,
+            r => {
+                r?;
+                false
+            },
+        };
+
+        if db_already_encrypted && oms_already_encrypted && ts_already_encrypted {
+            return Err(WalletError::WalletStorageError(WalletStorageError::AlreadyEncrypted));
+        }
         Ok(())
     }
 
     /// Remove encryption from all the Wallet db backends. If any backends do not have encryption applied then this will
     /// fail
     pub async fn remove_encryption(&mut self) -> Result<(), WalletError> {
+        self.remove_encryption_with_progress(EncryptionProgress::default())
+            .await
+    }
+
+    /// Remove encryption from all the Wallet db backends, reporting the number of rows decrypted to `progress`. The
+    /// passes over every backend are recorded before any are decrypted and the wallet db is decrypted last, so that an
+    /// interrupted pass still requires the passphrase to open the wallet and opening it completes the removal.
+    pub async fn remove_encryption_with_progress(&mut self, progress: EncryptionProgress) -> Result<(), WalletError> {
+        self.db.begin_remove_encryption().await?;
+        self.output_manager_service
+            .remove_encryption_with_progress(progress.clone())
+            .await?;
+        self.transaction_service
+            .remove_encryption_with_progress(progress)
+            .await?;
         self.db.remove_encryption().await?;
-        self.output_manager_service.remove_encryption().await?;
-        self.transaction_service.remove_encryption().await?;
         Ok(())
     }
 
@@ -80,6 +80,7 @@ use tari_wallet::{
         TxId,
         TxoValidationType,
     },
+    test_utils::make_wallet_connectivity_mock,
     transaction_service::handle::TransactionServiceHandle,
     types::ValidationRetryStrategy,
 };
@@ -166,6 +167,7 @@ pub fn setup_output_manager_service<T: OutputManagerBackend + 'static>(
             shutdown.to_signal(),
             basenode_service_handle,
             connectivity_manager,
+            make_wallet_connectivity_mock(),
             CommsSecretKey::default(),
         ))
         .unwrap();
@@ -267,6 +269,7 @@ pub fn setup_oms_with_bn_state<T: OutputManagerBackend + 'static>(
             shutdown.to_signal(),
             base_node_service_handle.clone(),
             connectivity_manager,
+            make_wallet_connectivity_mock(),
             CommsSecretKey::default(),
         ))
         .unwrap();
@@ -353,6 +356,41 @@ fn fee_estimate() {
     assert!(matches!(err, OutputManagerError::NotEnoughFunds));
 }
 
+#[test]
+fn utxo_selection_is_repeated_when_the_output_index_is_stale() {
+    let (connection, _tempdir) = get_temp_sqlite_database_connection();
+    let backend = OutputManagerSqliteDatabase::new(connection, None);
+
+    let factories = CryptoFactories::default();
+    let mut runtime = Runtime::new().unwrap();
+    let (mut oms, _shutdown, _, _, _, _, _) = setup_output_manager_service(&mut runtime, backend.clone(), true);
+
+    let (_, small) = make_input(&mut OsRng.clone(), MicroTari::from(2000), &factories.commitment);
+    let (_, large) = make_input(&mut OsRng.clone(), MicroTari::from(3000), &factories.commitment);
+    runtime.block_on(oms.add_output(small.clone())).unwrap();
+    runtime.block_on(oms.add_output(large)).unwrap();
+
+    // Cache the index, then change the smallest output behind the service so the index still lists it as unspent
+    let fee_per_gram = MicroTari::from(1);
+    runtime
+        .block_on(oms.fee_estimate(MicroTari::from(1000), fee_per_gram, 1, 1))
+        .unwrap();
+    let small = DbUnblindedOutput::from_unblinded_output(small, &factories).unwrap();
+    backend.invalidate_unspent_output(&small.commitment).unwrap();
+
+    let stp = runtime
+        .block_on(oms.prepare_transaction_to_send(
+            MicroTari::from(1000),
+            fee_per_gram,
+            None,
+            "".to_string(),
+            script!(Nop),
+        ))
+        .unwrap();
+    assert!(stp.get_tx_id().is_ok());
+    assert!(runtime.block_on(oms.get_unspent_outputs()).unwrap().is_empty());
+}
+
 #[allow(clippy::identity_op)]
 #[test]
 fn test_utxo_selection_no_chain_metadata() {
@@ -398,6 +436,16 @@ fn test_utxo_selection_no_chain_metadata() {
         assert_eq!(utxo.value, i * amount);
     }
 
+    // the summaries list the same outputs in the same order
+    let summaries = runtime.block_on(oms.get_unspent_output_summaries()).unwrap();
+    assert_eq!(
+        summaries
+            .iter()
+            .map(|s| (s.value, s.features.maturity))
+            .collect::<Vec<_>>(),
+        utxos.iter().map(|o| (o.value, o.features.maturity)).collect::<Vec<_>>()
+    );
+
     // test that we can get a fee estimate with no chain metadata
     let fee = runtime.block_on(oms.fee_estimate(amount, fee_per_gram, 1, 2)).unwrap();
     assert_eq!(fee, MicroTari::from(300));
@@ -1225,7 +1273,9 @@ fn test_utxo_stxo_invalid_txo_validation() {
         .unwrap();
     backend
         .invalidate_unspent_output(
-            &DbUnblindedOutput::from_unblinded_output(invalid_output.clone(), &factories).unwrap(),
+            &DbUnblindedOutput::from_unblinded_output(invalid_output.clone(), &factories)
+                .unwrap()
+                .commitment,
         )
         .unwrap();
 
@@ -1429,6 +1479,121 @@ fn test_utxo_stxo_invalid_txo_validation() {
     assert!(outputs.iter().any(|o| o == &spent_output1));
 }
 
+#[test]
+fn test_all_txo_validation() {
+    let factories = CryptoFactories::default();
+
+    let mut runtime = Runtime::new().unwrap();
+    let (connection, _tempdir) = get_temp_sqlite_database_connection();
+    let backend = OutputManagerSqliteDatabase::new(connection, None);
+
+    let invalid_output = create_unblinded_output(
+        TariScript::default(),
+        OutputFeatures::default(),
+        TestParamsHelpers::new(),
+        MicroTari::from(666),
+    );
+    let invalid_tx_output = invalid_output.as_transaction_output(&factories).unwrap();
+    let invalid_db_output = DbUnblindedOutput::from_unblinded_output(invalid_output.clone(), &factories).unwrap();
+    let invalid_commitment = invalid_db_output.commitment.clone();
+    backend
+        .write(WriteOperation::Insert(DbKeyValuePair::UnspentOutput(
+            invalid_db_output.commitment.clone(),
+            Box::new(invalid_db_output),
+        )))
+        .unwrap();
+    backend.invalidate_unspent_output(&invalid_commitment).unwrap();
+
+    let spent_output1 = create_unblinded_output(
+        TariScript::default(),
+        OutputFeatures::default(),
+        TestParamsHelpers::new(),
+        MicroTari::from(500),
+    );
+    let spent_tx_output1 = spent_output1.as_transaction_output(&factories).unwrap();
+    let spent_output2 = create_unblinded_output(
+        TariScript::default(),
+        OutputFeatures::default(),
+        TestParamsHelpers::new(),
+        MicroTari::from(800),
+    );
+    for spent_output in vec![spent_output1.clone(), spent_output2] {
+        let spent_db_output = DbUnblindedOutput::from_unblinded_output(spent_output, &factories).unwrap();
+        backend
+            .write(WriteOperation::Insert(DbKeyValuePair::SpentOutput(
+                spent_db_output.commitment.clone(),
+                Box::new(spent_db_output),
+            )))
+            .unwrap();
+    }
+
+    let (mut oms, _shutdown, _ts, _mock_rpc_server, server_node_identity, rpc_service_state, _) =
+        setup_output_manager_service(&mut runtime, backend, true);
+    let mut event_stream = oms.get_event_stream_fused();
+
+    let unspent_output1 = create_unblinded_output(
+        TariScript::default(),
+        OutputFeatures::default(),
+        TestParamsHelpers::new(),
+        MicroTari::from(900),
+    );
+    let unspent_tx_output1 = unspent_output1.as_transaction_output(&factories).unwrap();
+    runtime.block_on(oms.add_output(unspent_output1.clone())).unwrap();
+
+    let unspent_output2 = create_unblinded_output(
+        TariScript::default(),
+        OutputFeatures::default(),
+        TestParamsHelpers::new(),
+        MicroTari::from(901),
+    );
+    runtime.block_on(oms.add_output(unspent_output2)).unwrap();
+
+    rpc_service_state.set_utxos(vec![invalid_tx_output, spent_tx_output1, unspent_tx_output1]);
+
+    runtime
+        .block_on(oms.set_base_node_public_key(server_node_identity.public_key().clone()))
+        .unwrap();
+
+    runtime
+        .block_on(oms.validate_txos(TxoValidationType::All, ValidationRetryStrategy::Limited(5)))
+        .unwrap();
+
+    // The 5 outputs of the three sets are queried together in batches of at most 2
+    let fetch_utxo_calls = runtime
+        .block_on(rpc_service_state.wait_pop_fetch_utxos_calls(3, Duration::from_secs(60)))
+        .unwrap();
+    assert_eq!(fetch_utxo_calls.iter().map(|c| c.len()).sum::<usize>(), 5);
+
+    runtime.block_on(async {
+        let mut delay = delay_for(Duration::from_secs(60)).fuse();
+        let mut success = false;
+        loop {
+            futures::select! {
+                event = event_stream.select_next_some() => {
+                    if let Ok(msg) = event {
+                        if let OutputManagerEvent::TxoValidationSuccess(_, TxoValidationType::All) = (*msg).clone() {
+                            success = true;
+                            break;
+                        };
+                    }
+                },
+                () = delay => {
+                    break;
+                },
+            }
+        }
+        assert!(success, "Did not receive validation success event");
+    });
+
+    let outputs = runtime.block_on(oms.get_unspent_outputs()).unwrap();
+
+    assert_eq!(outputs.len(), 3);
+    assert!(outputs.iter().any(|o| o == &unspent_output1));
+    assert!(outputs.iter().any(|o| o == &spent_output1));
+    assert!(outputs.iter().any(|o| o == &invalid_output));
+    assert_eq!(runtime.block_on(oms.get_invalid_outputs()).unwrap().len(), 1);
+}
+
 #[test]
 fn test_base_node_switch_during_validation() {
     let factories = CryptoFactories::default();
@@ -1864,6 +2029,7 @@ fn test_oms_key_manager_discrepancy() {
             shutdown.to_signal(),
             basenode_service_handle.clone(),
             connectivity_manager.clone(),
+            make_wallet_connectivity_mock(),
             master_key1.clone(),
         ))
         .unwrap();
@@ -1883,6 +2049,7 @@ fn test_oms_key_manager_discrepancy() {
             shutdown.to_signal(),
             basenode_service_handle.clone(),
             connectivity_manager.clone(),
+            make_wallet_connectivity_mock(),
             master_key1,
         ))
         .expect("Should be able to make a new OMS with same master key");
@@ -1901,6 +2068,7 @@ fn test_oms_key_manager_discrepancy() {
         shutdown.to_signal(),
         basenode_service_handle,
         connectivity_manager,
+        make_wallet_connectivity_mock(),
         master_key2,
     ));
 
@@ -40,8 +40,9 @@ use tari_wallet::output_manager_service::{
     error::OutputManagerStorageError,
     service::Balance,
     storage::{
-        database::{KeyManagerState, OutputManagerBackend, OutputManagerDatabase, PendingTransactionOutputs},
-        models::DbUnblindedOutput,
+        database::{DbKey, KeyManagerState, OutputManagerBackend, OutputManagerDatabase, PendingTransactionOutputs},
+        models::{DbOutputSummary, DbUnblindedOutput},
+        spendable_index::SpendableOutputIndex,
         sqlite_db::OutputManagerSqliteDatabase,
     },
 };
@@ -319,12 +320,20 @@ pub fn test_db_backend<T: OutputManagerBackend + 'static>(backend: T) {
     assert_eq!(invalid_outputs.len(), 0);
     let unspent_outputs = runtime.block_on(db.get_unspent_outputs()).unwrap();
     let _ = runtime
-        .block_on(db.invalidate_output(unspent_outputs[0].clone()))
+        .block_on(db.invalidate_output(unspent_outputs[0].commitment.clone()))
         .unwrap();
     let invalid_outputs = runtime.block_on(db.get_invalid_outputs()).unwrap();
 
     assert_eq!(invalid_outputs.len(), 1);
     assert_eq!(invalid_outputs[0], unspent_outputs[0]);
+    let invalid_summaries = runtime
+        .block_on(db.fetch_output_summaries(DbKey::InvalidOutputs))
+        .unwrap();
+    assert_eq!(invalid_summaries, vec![DbOutputSummary::from(&invalid_outputs[0])]);
+    // an output that is no longer unspent is not invalidated
+    assert!(runtime
+        .block_on(db.invalidate_output(invalid_outputs[0].commitment.clone()))
+        .is_err());
 
     // test revalidating output
     let unspent_outputs = runtime.block_on(db.get_unspent_outputs()).unwrap();
@@ -510,6 +519,68 @@ pub async fn test_short_term_encumberance() {
     );
 }
 
+#[tokio_macros::test]
+pub async fn test_spendable_output_index() {
+    let factories = CryptoFactories::default();
+    let (connection, _tempdir) = get_temp_sqlite_database_connection();
+    let backend = OutputManagerSqliteDatabase::new(connection, None);
+    let db = OutputManagerDatabase::new(backend);
+
+    let mut outputs = Vec::new();
+    for i in 1..5 {
+        let (_ti, uo) = make_input(&mut OsRng, MicroTari::from(1000 * i), &factories.commitment);
+        let uo = DbUnblindedOutput::from_unblinded_output(uo, &factories).unwrap();
+        db.add_unspent_output(uo.clone()).await.unwrap();
+        outputs.push(uo);
+    }
+
+    let indexed_values = |index: &SpendableOutputIndex| index.iter_by_value().map(|o| o.value).collect::<Vec<_>>();
+    let values = db.with_spendable_output_index(indexed_values).await.unwrap();
+    assert_eq!(
+        values,
+        outputs.iter().map(|o| o.unblinded_output.value).collect::<Vec<_>>()
+    );
+
+    // The cached index follows outputs added after it was built
+    let (_ti, uo) = make_input(&mut OsRng, MicroTari::from(500), &factories.commitment);
+    let uo = DbUnblindedOutput::from_unblinded_output(uo, &factories).unwrap();
+    db.add_unspent_output(uo.clone()).await.unwrap();
+    outputs.insert(0, uo);
+    let values = db.with_spendable_output_index(indexed_values).await.unwrap();
+    assert_eq!(values.len(), 5);
+    assert_eq!(values[0], MicroTari::from(500));
+
+    // Encumbered outputs are no longer spendable
+    let tx_id = OsRng.next_u64();
+    db.encumber_outputs(tx_id, vec![outputs[1].clone(), outputs[2].clone()], vec![])
+        .await
+        .unwrap();
+    let values = db.with_spendable_output_index(indexed_values).await.unwrap();
+    assert_eq!(values, vec![
+        outputs[0].unblinded_output.value,
+        outputs[3].unblinded_output.value,
+        outputs[4].unblinded_output.value
+    ]);
+
+    db.clear_short_term_encumberances().await.unwrap();
+    let values = db.with_spendable_output_index(indexed_values).await.unwrap();
+    assert_eq!(values.len(), 5);
+
+    // Selected outputs are returned in the order they were selected in
+    let commitments = vec![outputs[3].commitment.clone(), outputs[0].commitment.clone()];
+    let fetched = db.fetch_unspent_outputs_by_commitment(commitments).await.unwrap();
+    assert_eq!(fetched, vec![outputs[3].clone(), outputs[0].clone()]);
+
+    db.encumber_outputs(tx_id, vec![outputs[3].clone()], vec![])
+        .await
+        .unwrap();
+    let err = db
+        .fetch_unspent_outputs_by_commitment(vec![outputs[3].commitment.clone()])
+        .await
+        .unwrap_err();
+    assert!(matches!(err, OutputManagerStorageError::ValuesNotFound));
+}
+
 #[tokio_macros::test]
 pub async fn test_no_duplicate_outputs() {
     let factories = CryptoFactories::default();
@@ -99,6 +99,7 @@ use tari_wallet::{
         mock_base_node_service::MockBaseNodeService,
         BaseNodeServiceInitializer,
     },
+    connectivity_service::{WalletConnectivityConfig, WalletConnectivityInitializer},
     output_manager_service::{
         config::OutputManagerServiceConfig,
         handle::OutputManagerHandle,
@@ -114,7 +115,7 @@ use tari_wallet::{
         database::{WalletBackend, WalletDatabase},
         sqlite_utilities::run_migration_and_create_sqlite_connection,
     },
-    test_utils::make_wallet_databases,
+    test_utils::{make_wallet_connectivity_mock, make_wallet_databases},
     transaction_service::{
         config::TransactionServiceConfig,
         error::TransactionServiceError,
@@ -190,6 +191,7 @@ pub fn setup_transaction_service<
     let fut = StackBuilder::new(shutdown_signal)
         .add_initializer(RegisterHandle::new(dht))
         .add_initializer(RegisterHandle::new(comms.connectivity()))
+        .add_initializer(WalletConnectivityInitializer::new(WalletConnectivityConfig::default()))
         .add_initializer(OutputManagerServiceInitializer::new(
             OutputManagerServiceConfig::default(),
             oms_backend,
@@ -338,6 +340,7 @@ pub fn setup_transaction_service_no_comms_and_oms_backend<
             shutdown.to_signal(),
             basenode_service_handle,
             connectivity_manager.clone(),
+            make_wallet_connectivity_mock(),
             CommsSecretKey::default(),
         ))
         .unwrap();
@@ -369,6 +372,7 @@ pub fn setup_transaction_service_no_comms_and_oms_backend<
         output_manager_service_handle.clone(),
         outbound_message_requester,
         connectivity_manager,
+        make_wallet_connectivity_mock(),
         event_publisher,
         Arc::new(NodeIdentity::random(
             &mut OsRng,
@@ -693,6 +697,68 @@ fn single_transaction_to_self() {
     });
 }
 
+#[test]
+fn send_transactions_sends_nothing_if_a_payment_cannot_be_prepared() {
+    let mut runtime = create_runtime();
+
+    let factories = CryptoFactories::default();
+    let alice_node_identity = Arc::new(NodeIdentity::random(
+        &mut OsRng,
+        get_next_memory_address(),
+        PeerFeatures::COMMUNICATION_NODE,
+    ));
+
+    let temp_dir = tempdir().unwrap();
+    let database_path = temp_dir.path().to_str().unwrap().to_string();
+
+    let (alice_wallet_backend, alice_backend, alice_oms_backend, _, _tempdir) =
+        make_wallet_databases(Some(database_path.clone()));
+
+    let shutdown = Shutdown::new();
+    let (mut alice_ts, mut alice_oms, _alice_comms) = setup_transaction_service(
+        &mut runtime,
+        alice_node_identity.clone(),
+        vec![],
+        factories.clone(),
+        alice_wallet_backend,
+        alice_backend,
+        alice_oms_backend,
+        database_path,
+        Duration::from_secs(0),
+        shutdown.to_signal(),
+    );
+
+    runtime.block_on(async move {
+        let initial_wallet_value = 2500.into();
+        let (_utxo, uo1) = make_input(&mut OsRng, initial_wallet_value, &factories.commitment);
+        alice_oms.add_output(uo1).await.unwrap();
+
+        // The payment to the other wallet is prepared first and spends the only output, so the payment to ourselves
+        // cannot be prepared
+        let bob_public_key = PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng));
+        let result = alice_ts
+            .send_transactions(
+                vec![
+                    (bob_public_key, 1000.into(), "To Bob".to_string()),
+                    (
+                        alice_node_identity.public_key().clone(),
+                        1000.into(),
+                        "To myself".to_string(),
+                    ),
+                ],
+                20.into(),
+            )
+            .await;
+        assert!(result.is_err());
+
+        assert!(alice_ts.get_pending_outbound_transactions().await.unwrap().is_empty());
+        assert!(alice_ts.get_completed_transactions().await.unwrap().is_empty());
+        let balance = alice_oms.get_balance().await.unwrap();
+        assert_eq!(balance.available_balance, initial_wallet_value);
+        assert_eq!(balance.pending_outgoing_balance, MicroTari::from(0));
+    });
+}
+
 #[test]
 fn send_one_sided_transaction_to_other() {
     let mut runtime = create_runtime();
@@ -5385,6 +5451,18 @@ fn start_validation_protocol_then_broadcast_protocol_change_base_node() {
         is_synced: true,
         height_of_longest_chain: 0,
     });
+    // A different tip than the one the previous validation was checked against, so that all the transactions are
+    // queried again
+    rpc_service_state.set_tip_info_response(base_node_proto::TipInfoResponse {
+        metadata: Some(base_node_proto::ChainMetadata {
+            height_of_longest_chain: Some(1),
+            best_block: Some(vec![1u8; 32]),
+            accumulated_difficulty: Vec::new(),
+            pruning_horizon: 0,
+            effective_pruned_height: 0,
+        }),
+        is_synced: true,
+    });
 
     runtime
         .block_on(alice_ts.set_base_node_public_key(server_node_identity.public_key().clone()))
@@ -24,7 +24,7 @@ use aes_gcm::{
     aead::{generic_array::GenericArray, NewAead},
     Aes256Gcm,
 };
-use chrono::Utc;
+use chrono::{Duration as ChronoDuration, Utc};
 use rand::rngs::OsRng;
 use tari_core::transactions::{
     helpers::{create_unblinded_output, TestParams},
@@ -47,6 +47,7 @@ use tari_wallet::{
         database::{TransactionBackend, TransactionDatabase},
         models::{
             CompletedTransaction,
+            CompletedTransactionQuery,
             InboundTransaction,
             OutboundTransaction,
             TransactionDirection,
@@ -55,6 +56,7 @@ use tari_wallet::{
         },
         sqlite_db::TransactionServiceSqliteDatabase,
     },
+    util::encryption::EncryptionProgress,
 };
 use tempfile::tempdir;
 use tokio::runtime::Runtime;
@@ -578,3 +580,165 @@ pub fn test_transaction_service_sqlite_db_encrypted() {
 
     test_db_backend(TransactionServiceSqliteDatabase::new(connection, Some(cipher)));
 }
+
+#[test]
+pub fn test_completed_transactions_page_query() {
+    let db_name = format!("{}.sqlite3", random::string(8));
+    let db_tempdir = tempdir().unwrap();
+    let db_folder = db_tempdir.path().to_str().unwrap().to_string();
+    let db_path = format!("{}/{}", db_folder, db_name);
+    let connection = run_migration_and_create_sqlite_connection(&db_path).unwrap();
+    let db = TransactionDatabase::new(TransactionServiceSqliteDatabase::new(connection, None));
+    let mut runtime = Runtime::new().unwrap();
+
+    let now = Utc::now().naive_utc();
+    for i in 0..20u64 {
+        let status = if i % 2 == 0 {
+            TransactionStatus::MinedConfirmed
+        } else {
+            TransactionStatus::Broadcast
+        };
+        let direction = if i % 4 < 2 {
+            TransactionDirection::Inbound
+        } else {
+            TransactionDirection::Outbound
+        };
+        let tx = CompletedTransaction::new(
+            i + 1,
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            MicroTari::from(1000 + i),
+            MicroTari::from(10),
+            Transaction::new(vec![], vec![], vec![], PrivateKey::default(), PrivateKey::default()),
+            status,
+            format!("Tx {}", i),
+            now + ChronoDuration::seconds(i as i64),
+            direction,
+            None,
+        );
+        runtime.block_on(db.insert_completed_transaction(tx.tx_id, tx)).unwrap();
+    }
+
+    let page = runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            statuses: vec![TransactionStatus::MinedConfirmed],
+            limit: Some(3),
+            ..Default::default()
+        }))
+        .unwrap();
+    assert_eq!(page.iter().map(|tx| tx.tx_id).collect::<Vec<_>>(), vec![19, 17, 15]);
+
+    let page = runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            statuses: vec![TransactionStatus::MinedConfirmed],
+            cursor: Some(15),
+            limit: Some(3),
+            ..Default::default()
+        }))
+        .unwrap();
+    assert_eq!(page.iter().map(|tx| tx.tx_id).collect::<Vec<_>>(), vec![13, 11, 9]);
+
+    let page = runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            direction: Some(TransactionDirection::Outbound),
+            from_timestamp: Some(now + ChronoDuration::seconds(4)),
+            to_timestamp: Some(now + ChronoDuration::seconds(12)),
+            ..Default::default()
+        }))
+        .unwrap();
+    assert_eq!(page.iter().map(|tx| tx.tx_id).collect::<Vec<_>>(), vec![12, 11, 8, 7]);
+
+    runtime.block_on(db.cancel_completed_transaction(20)).unwrap();
+    let page = runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            limit: Some(1),
+            ..Default::default()
+        }))
+        .unwrap();
+    assert_eq!(page[0].tx_id, 19);
+    let page = runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            cancelled: true,
+            ..Default::default()
+        }))
+        .unwrap();
+    assert_eq!(page.len(), 1);
+    assert_eq!(page[0].tx_id, 20);
+
+    assert!(runtime
+        .block_on(db.get_completed_transactions_page(CompletedTransactionQuery {
+            cursor: Some(999),
+            ..Default::default()
+        }))
+        .is_err());
+}
+
+#[test]
+pub fn test_transaction_changes_since() {
+    let db_name = format!("{}.sqlite3", random::string(8));
+    let db_tempdir = tempdir().unwrap();
+    let db_folder = db_tempdir.path().to_str().unwrap().to_string();
+    let db_path = format!("{}/{}", db_folder, db_name);
+    let connection = run_migration_and_create_sqlite_connection(&db_path).unwrap();
+    let db = TransactionDatabase::new(TransactionServiceSqliteDatabase::new(connection, None));
+    let mut runtime = Runtime::new().unwrap();
+
+    let changes = runtime.block_on(db.get_transaction_changes_since(0)).unwrap();
+    assert!(changes.completed.is_empty());
+    let start = changes.latest_sequence;
+
+    for i in 0..5u64 {
+        let tx = CompletedTransaction::new(
+            i + 1,
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            MicroTari::from(1000 + i),
+            MicroTari::from(10),
+            Transaction::new(vec![], vec![], vec![], PrivateKey::default(), PrivateKey::default()),
+            TransactionStatus::Broadcast,
+            format!("Tx {}", i),
+            Utc::now().naive_utc(),
+            TransactionDirection::Inbound,
+            None,
+        );
+        runtime.block_on(db.insert_completed_transaction(tx.tx_id, tx)).unwrap();
+    }
+
+    let changes = runtime.block_on(db.get_transaction_changes_since(start)).unwrap();
+    assert_eq!(changes.latest_sequence, start + 5);
+    assert_eq!(
+        changes.completed.iter().map(|tx| tx.tx_id).collect::<Vec<_>>(),
+        vec![1, 2, 3, 4, 5]
+    );
+    assert!(changes.pending_inbound.is_empty());
+    assert!(changes.pending_outbound.is_empty());
+    let seen = changes.latest_sequence;
+
+    let changes = runtime.block_on(db.get_transaction_changes_since(seen)).unwrap();
+    assert_eq!(changes.latest_sequence, seen);
+    assert!(changes.completed.is_empty());
+
+    runtime.block_on(db.mine_completed_transaction(2)).unwrap();
+    runtime.block_on(db.cancel_completed_transaction(4)).unwrap();
+    runtime.block_on(db.set_transaction_confirmations(2, 1)).unwrap();
+
+    let changes = runtime.block_on(db.get_transaction_changes_since(seen)).unwrap();
+    assert_eq!(changes.latest_sequence, seen + 3);
+    assert_eq!(changes.completed.iter().map(|tx| tx.tx_id).collect::<Vec<_>>(), vec![4, 2]);
+    assert!(changes.completed[0].cancelled);
+    assert_eq!(changes.completed[1].status, TransactionStatus::MinedUnconfirmed);
+    assert_eq!(changes.completed[1].confirmations, Some(1));
+    let seen = changes.latest_sequence;
+
+    // Re-writing the protocols during encryption is not a change to the transactions themselves
+    let key = GenericArray::from_slice(b"an example very very secret key.");
+    runtime
+        .block_on(db.apply_encryption(Aes256Gcm::new(key), EncryptionProgress::default()))
+        .unwrap();
+    let changes = runtime.block_on(db.get_transaction_changes_since(seen)).unwrap();
+    assert_eq!(changes.latest_sequence, seen);
+    assert!(changes.completed.is_empty());
+
+    let changes = runtime.block_on(db.get_transaction_changes_since(start)).unwrap();
+    assert_eq!(changes.completed.len(), 5);
+}
@@ -55,6 +55,18 @@ use tari_test_utils::random;
 use tari_wallet::{
     contacts_service::storage::database::Contact,
     error::{WalletError, WalletStorageError},
+    output_manager_service::storage::{
+        database::{
+            DbKey as OutputManagerDbKey,
+            DbKeyValuePair as OutputManagerDbKeyValuePair,
+            DbValue as OutputManagerDbValue,
+            KeyManagerState,
+            OutputManagerBackend,
+            WriteOperation as OutputManagerWriteOperation,
+        },
+        models::DbUnblindedOutput,
+        sqlite_db::OutputManagerSqliteDatabase,
+    },
     storage::{
         database::{DbKeyValuePair, WalletBackend, WalletDatabase, WriteOperation},
         sqlite_db::WalletSqliteDatabase,
@@ -65,7 +77,12 @@ use tari_wallet::{
         },
     },
     test_utils::make_wallet_databases,
-    transaction_service::{config::TransactionServiceConfig, handle::TransactionEvent},
+    transaction_service::{
+        config::TransactionServiceConfig,
+        handle::TransactionEvent,
+        storage::database::TransactionBackend,
+    },
+    util::encryption::EncryptionProgress,
     Wallet,
     WalletConfig,
     WalletSqlite,
@@ -857,3 +874,89 @@ fn test_db_file_locking() {
 
     assert!(run_migration_and_create_sqlite_connection(&wallet_path).is_ok());
 }
+
+fn assert_output_manager_readable(db: &OutputManagerSqliteDatabase, state: &KeyManagerState) {
+    match db.fetch(&OutputManagerDbKey::KeyManagerState).unwrap() {
+        Some(OutputManagerDbValue::KeyManagerState(s)) => assert_eq!(&s, state),
+        _ => panic!("Should be able to read the key manager state"),
+    }
+    match db.fetch(&OutputManagerDbKey::UnspentOutputs).unwrap() {
+        Some(OutputManagerDbValue::UnspentOutputs(outputs)) => assert_eq!(outputs.len(), 1),
+        _ => panic!("Should be able to read the outputs"),
+    }
+}
+
+#[test]
+fn test_reopen_after_interrupted_encryption() {
+    let factories = CryptoFactories::default();
+    let db_tempdir = tempdir().unwrap();
+    let wallet_path = db_tempdir.path().join("alice_db").with_extension("sqlite3");
+    let passphrase = "It's turtles all the way down".to_string();
+    let passphrase_hash = Blake256::new().chain(passphrase.as_bytes()).finalize();
+    let key = GenericArray::from_slice(passphrase_hash.as_slice());
+    let cipher = Aes256Gcm::new(key);
+
+    let key_manager_state = KeyManagerState {
+        master_key: PrivateKey::random(&mut OsRng),
+        branch_seed: random::string(8),
+        primary_key_index: 0,
+    };
+    {
+        let (wallet_backend, _, output_manager_backend, _) =
+            initialize_sqlite_database_backends(wallet_path.clone(), None).unwrap();
+        wallet_backend
+            .write(WriteOperation::Insert(DbKeyValuePair::MasterSecretKey(
+                CommsSecretKey::random(&mut OsRng),
+            )))
+            .unwrap();
+        output_manager_backend
+            .write(OutputManagerWriteOperation::Insert(
+                OutputManagerDbKeyValuePair::KeyManagerState(key_manager_state.clone()),
+            ))
+            .unwrap();
+        let (_, uo) = make_input(&mut OsRng, MicroTari::from(1000), &factories.commitment);
+        let output = DbUnblindedOutput::from_unblinded_output(uo, &factories).unwrap();
+        output_manager_backend
+            .write(OutputManagerWriteOperation::Insert(
+                OutputManagerDbKeyValuePair::UnspentOutput(output.commitment.clone(), Box::new(output)),
+            ))
+            .unwrap();
+
+        // Applying encryption is interrupted once the wallet settings are encrypted
+        wallet_backend.apply_encryption(cipher.clone()).unwrap();
+    }
+
+    match initialize_sqlite_database_backends(wallet_path.clone(), None) {
+        Err(WalletStorageError::NoPasswordError) => {},
+        _ => panic!("Should not be able to open the wallet without the passphrase"),
+    }
+
+    {
+        // Opening the wallet with the passphrase completes the encryption of the other backends
+        let (wallet_backend, transaction_backend, output_manager_backend, _) =
+            initialize_sqlite_database_backends(wallet_path.clone(), Some(passphrase.clone())).unwrap();
+        assert_output_manager_readable(&output_manager_backend, &key_manager_state);
+        assert!(output_manager_backend
+            .apply_encryption(cipher.clone(), EncryptionProgress::default())
+            .is_err());
+        assert!(transaction_backend
+            .apply_encryption(cipher, EncryptionProgress::default())
+            .is_err());
+
+        // Removing encryption is interrupted once the Output Manager backend is decrypted
+        wallet_backend.begin_remove_encryption().unwrap();
+        output_manager_backend
+            .remove_encryption(EncryptionProgress::default())
+            .unwrap();
+    }
+
+    {
+        // Opening the wallet with the passphrase completes the removal from the other backends
+        let (_, _, output_manager_backend, _) =
+            initialize_sqlite_database_backends(wallet_path.clone(), Some(passphrase)).unwrap();
+        assert_output_manager_readable(&output_manager_backend, &key_manager_state);
+    }
+
+    let (_, _, output_manager_backend, _) = initialize_sqlite_database_backends(wallet_path, None).unwrap();
+    assert_output_manager_readable(&output_manager_backend, &key_manager_state);
+}
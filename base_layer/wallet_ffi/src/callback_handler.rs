@@ -47,11 +47,23 @@
 //! `callback_base_node_sync_complete` - This is called when a Base Node Sync process is completed or times out. The
 //! request_key is used to identify which request this callback references and a result of true means it was successful
 //! and false that the process timed out and new one will be started
-
-use futures::{stream::Fuse, StreamExt};
+//!
+//! ## Batched delivery
+//! When event batching is enabled with `with_event_batching(..)` the individual callbacks above are not called.
+//! Instead the events are collected for up to the configured window, or until the configured number of events has been
+//! collected, and are delivered to `callback_events_batch` as a single `EventBatch`. Repeated events of the same type
+//! for the same TxId or request key within a batch are delivered once, with the most recent value.
+
+use futures::{
+    future::{Fuse as FutureFuse, FusedFuture, FutureExt},
+    stream::Fuse,
+    StreamExt,
+};
 use log::*;
+use std::{collections::HashMap, sync::Arc, time::Duration};
 use tari_comms::types::CommsPublicKey;
 use tari_comms_dht::event::{DhtEvent, DhtEventReceiver};
+use tari_metrics::Gauge;
 use tari_shutdown::ShutdownSignal;
 use tari_wallet::{
     output_manager_service::{
@@ -67,9 +79,18 @@ use tari_wallet::{
         },
     },
 };
+use tokio::time::delay_for;
 
 const LOG_TARGET: &str = "wallet::transaction_service::callback_handler";
 
+lazy_static! {
+    static ref PENDING_EVENTS: Arc<Gauge> = tari_metrics::global().gauge(
+        "wallet_ffi_callback_pending_events",
+        "The number of events waiting to be delivered in a callback batch",
+        &[],
+    );
+}
+
 #[derive(Clone, Copy)]
 enum CallbackValidationResults {
     Success,           // 0
@@ -78,6 +99,51 @@ enum CallbackValidationResults {
     BaseNodeNotInSync, // 3
 }
 
+/// The type of an event delivered in an `EventBatch`, each type corresponds to one of the individual callbacks
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum BatchedEventType {
+    ReceivedTransaction = 0,
+    ReceivedTransactionReply = 1,
+    ReceivedFinalizedTransaction = 2,
+    TransactionBroadcast = 3,
+    TransactionMined = 4,
+    TransactionMinedUnconfirmed = 5,
+    DirectSendResult = 6,
+    StoreAndForwardSendResult = 7,
+    TransactionCancellation = 8,
+    UtxoValidationComplete = 9,
+    StxoValidationComplete = 10,
+    InvalidTxoValidationComplete = 11,
+    TransactionValidationComplete = 12,
+    SafMessagesReceived = 13,
+    TxoValidationComplete = 14,
+}
+
+/// A single event of an `EventBatch`. `id` is the TxId for transaction events and the request key for validation
+/// events. `value` carries the number of confirmations for `TransactionMinedUnconfirmed`, the result for the send
+/// result events (1 for success) and the `CallbackValidationResults` value for the validation events.
+#[derive(Clone, Debug)]
+pub struct BatchedEvent {
+    pub event_type: BatchedEventType,
+    pub id: u64,
+    pub value: u64,
+    pub completed_transaction: Option<CompletedTransaction>,
+    pub inbound_transaction: Option<InboundTransaction>,
+}
+
+#[derive(Clone, Debug, Default)]
+pub struct EventBatch(pub Vec<BatchedEvent>);
+
+/// Settings for delivering events to the client in batches rather than through the individual callbacks
+#[derive(Clone, Copy)]
+pub struct EventBatchConfig {
+    pub callback_events_batch: unsafe extern "C" fn(*mut EventBatch),
+    /// How long to collect events for, starting from the first event of a batch
+    pub window: Duration,
+    /// Deliver the batch as soon as this many distinct events have been collected, 0 for no limit
+    pub max_events: usize,
+}
+
 pub struct CallbackHandler<TBackend>
 where TBackend: TransactionBackend + 'static
 {
@@ -101,6 +167,9 @@ where TBackend: TransactionBackend + 'static
     dht_event_stream: Fuse<DhtEventReceiver>,
     shutdown_signal: Option<ShutdownSignal>,
     comms_public_key: CommsPublicKey,
+    event_batch_config: Option<EventBatchConfig>,
+    pending_events: Vec<(BatchedEventType, u64, u64)>,
+    pending_event_index: HashMap<(BatchedEventType, u64), usize>,
 }
 
 #[allow(clippy::too_many_arguments)]
@@ -207,9 +276,25 @@ where TBackend: TransactionBackend + 'static
             dht_event_stream,
             shutdown_signal: Some(shutdown_signal),
             comms_public_key,
+            event_batch_config: None,
+            pending_events: Vec::new(),
+            pending_event_index: HashMap::new(),
         }
     }
 
+    /// Deliver events in batches to `config.callback_events_batch` instead of calling the individual callbacks
+    pub fn with_event_batching(mut self, config: EventBatchConfig) -> Self {
+        info!(
+            target: LOG_TARGET,
+            "EventsBatchCallback -> Assigning Fn: {:?} with a window of {:?} and at most {} events",
+            config.callback_events_batch,
+            config.window,
+            config.max_events
+        );
+        self.event_batch_config = Some(config);
+        self
+    }
+
     pub async fn start(mut self) {
         let mut shutdown_signal = self
             .shutdown_signal
@@ -218,6 +303,7 @@ where TBackend: TransactionBackend + 'static
 
         info!(target: LOG_TARGET, "Transaction Service Callback Handler starting");
 
+        let mut batch_delay = FutureFuse::terminated();
         loop {
             futures::select! {
                 result = self.transaction_service_event_stream.select_next_some() => {
@@ -306,6 +392,9 @@ where TBackend: TransactionBackend + 'static
                         Err(_e) => error!(target: LOG_TARGET, "Error reading from DHT event broadcast channel"),
                     }
                 }
+                _ = batch_delay => {
+                    self.deliver_event_batch().await;
+                },
                 complete => {
                     info!(target: LOG_TARGET, "Callback Handler is exiting because all tasks have completed");
                     break;
@@ -315,10 +404,117 @@ where TBackend: TransactionBackend + 'static
                     break;
                 },
             }
+
+            if let Some(config) = self.event_batch_config {
+                if config.max_events > 0 && self.pending_events.len() >= config.max_events {
+                    self.deliver_event_batch().await;
+                    batch_delay = FutureFuse::terminated();
+                } else if !self.pending_events.is_empty() && batch_delay.is_terminated() {
+                    batch_delay = delay_for(config.window).fuse();
+                }
+            }
+        }
+
+        // Don't drop the events that were collected before the handler exited
+        self.deliver_event_batch().await;
+    }
+
+    /// Add an event to the pending batch if batching is enabled, returns false if the event should be delivered to
+    /// its individual callback instead. A repeat of an event that is already pending only updates its value.
+    fn batch_event(&mut self, event_type: BatchedEventType, id: u64, value: u64) -> bool {
+        if self.event_batch_config.is_none() {
+            return false;
+        }
+
+        match self.pending_event_index.get(&(event_type, id)) {
+            Some(i) => self.pending_events[*i].2 = value,
+            None => {
+                self.pending_event_index.insert((event_type, id), self.pending_events.len());
+                self.pending_events.push((event_type, id, value));
+                PENDING_EVENTS.inc();
+            },
+        }
+        true
+    }
+
+    async fn deliver_event_batch(&mut self) {
+        let callback_events_batch = match self.event_batch_config {
+            Some(config) => config.callback_events_batch,
+            None => return,
+        };
+        if self.pending_events.is_empty() {
+            return;
+        }
+        self.pending_event_index.clear();
+        let pending_events = std::mem::take(&mut self.pending_events);
+        PENDING_EVENTS.add(-(pending_events.len() as i64));
+
+        // Each transaction is only fetched once per batch no matter how many of its events are in the batch
+        let mut completed_transactions: HashMap<TxId, CompletedTransaction> = HashMap::new();
+        let mut batch = EventBatch(Vec::with_capacity(pending_events.len()));
+        for (event_type, id, value) in pending_events {
+            let mut event = BatchedEvent {
+                event_type,
+                id,
+                value,
+                completed_transaction: None,
+                inbound_transaction: None,
+            };
+            match event_type {
+                BatchedEventType::ReceivedTransaction => match self.db.get_pending_inbound_transaction(id).await {
+                    Ok(tx) => event.inbound_transaction = Some(tx),
+                    Err(e) => {
+                        error!(
+                            target: LOG_TARGET,
+                            "Error retrieving Pending Inbound Transaction: {:?}", e
+                        );
+                        continue;
+                    },
+                },
+                BatchedEventType::ReceivedTransactionReply |
+                BatchedEventType::ReceivedFinalizedTransaction |
+                BatchedEventType::TransactionBroadcast |
+                BatchedEventType::TransactionMined |
+                BatchedEventType::TransactionMinedUnconfirmed => {
+                    if !completed_transactions.contains_key(&id) {
+                        match self.db.get_completed_transaction(id).await {
+                            Ok(tx) => {
+                                completed_transactions.insert(id, tx);
+                            },
+                            Err(e) => {
+                                error!(target: LOG_TARGET, "Error retrieving Completed Transaction: {:?}", e);
+                                continue;
+                            },
+                        }
+                    }
+                    event.completed_transaction = completed_transactions.get(&id).cloned();
+                },
+                BatchedEventType::TransactionCancellation => match self.find_cancelled_transaction(id).await {
+                    Some(tx) => event.completed_transaction = Some(tx),
+                    None => {
+                        error!(target: LOG_TARGET, "Error retrieving Cancelled Transaction TxId {}", id);
+                        continue;
+                    },
+                },
+                _ => (),
+            }
+            batch.0.push(event);
+        }
+
+        debug!(
+            target: LOG_TARGET,
+            "Calling Events Batch callback function with {} events", batch.0.len()
+        );
+        let boxing = Box::into_raw(Box::new(batch));
+        unsafe {
+            (callback_events_batch)(boxing);
         }
     }
 
     async fn receive_transaction_event(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::ReceivedTransaction, tx_id, 0) {
+            return;
+        }
         match self.db.get_pending_inbound_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -338,6 +534,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     async fn receive_transaction_reply_event(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::ReceivedTransactionReply, tx_id, 0) {
+            return;
+        }
         match self.db.get_completed_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -354,6 +553,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     async fn receive_finalized_transaction_event(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::ReceivedFinalizedTransaction, tx_id, 0) {
+            return;
+        }
         match self.db.get_completed_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -370,6 +572,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     fn receive_direct_send_result(&mut self, tx_id: TxId, result: bool) {
+        if self.batch_event(BatchedEventType::DirectSendResult, tx_id, result as u64) {
+            return;
+        }
         debug!(
             target: LOG_TARGET,
             "Calling Direct Send Result callback function for TxId: {} with result {}", tx_id, result
@@ -380,6 +585,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     fn receive_store_and_forward_send_result(&mut self, tx_id: TxId, result: bool) {
+        if self.batch_event(BatchedEventType::StoreAndForwardSendResult, tx_id, result as u64) {
+            return;
+        }
         debug!(
             target: LOG_TARGET,
             "Calling Store and Forward Send Result callback function for TxId: {} with result {}", tx_id, result
@@ -389,7 +597,7 @@ where TBackend: TransactionBackend + 'static
         }
     }
 
-    async fn receive_transaction_cancellation(&mut self, tx_id: TxId) {
+    async fn find_cancelled_transaction(&mut self, tx_id: TxId) -> Option<CompletedTransaction> {
         let mut transaction = None;
         if let Ok(tx) = self.db.get_cancelled_completed_transaction(tx_id).await {
             transaction = Some(tx);
@@ -402,8 +610,15 @@ where TBackend: TransactionBackend + 'static
             inbound_tx.destination_public_key = self.comms_public_key.clone();
             transaction = Some(inbound_tx);
         };
+        transaction
+    }
+
+    async fn receive_transaction_cancellation(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::TransactionCancellation, tx_id, 0) {
+            return;
+        }
 
-        match transaction {
+        match self.find_cancelled_transaction(tx_id).await {
             None => error!(
                 target: LOG_TARGET,
                 "Error retrieving Cancelled Transaction TxId {}", tx_id
@@ -422,6 +637,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     async fn receive_transaction_broadcast_event(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::TransactionBroadcast, tx_id, 0) {
+            return;
+        }
         match self.db.get_completed_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -438,6 +656,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     async fn receive_transaction_mined_event(&mut self, tx_id: TxId) {
+        if self.batch_event(BatchedEventType::TransactionMined, tx_id, 0) {
+            return;
+        }
         match self.db.get_completed_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -454,6 +675,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     async fn receive_transaction_mined_unconfirmed_event(&mut self, tx_id: TxId, confirmations: u64) {
+        if self.batch_event(BatchedEventType::TransactionMinedUnconfirmed, tx_id, confirmations) {
+            return;
+        }
         match self.db.get_completed_transaction(tx_id).await {
             Ok(tx) => {
                 debug!(
@@ -470,6 +694,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     fn transaction_validation_complete_event(&mut self, request_key: u64, result: CallbackValidationResults) {
+        if self.batch_event(BatchedEventType::TransactionValidationComplete, request_key, result as u64) {
+            return;
+        }
         debug!(
             target: LOG_TARGET,
             "Calling Transaction Validation Complete callback function for Request Key: {} with result {:?}",
@@ -501,6 +728,16 @@ where TBackend: TransactionBackend + 'static
         validation_type: TxoValidationType,
         result: CallbackValidationResults,
     ) {
+        let event_type = match validation_type {
+            TxoValidationType::Unspent => BatchedEventType::UtxoValidationComplete,
+            TxoValidationType::Spent => BatchedEventType::StxoValidationComplete,
+            TxoValidationType::Invalid => BatchedEventType::InvalidTxoValidationComplete,
+            TxoValidationType::All => BatchedEventType::TxoValidationComplete,
+        };
+        if self.batch_event(event_type, request_key, result as u64) {
+            return;
+        }
+
         debug!(
             target: LOG_TARGET,
             "Calling Output Validation Complete callback function for Request Key: {} with with type {} result {:?}",
@@ -510,7 +747,9 @@ where TBackend: TransactionBackend + 'static
         );
 
         match validation_type {
-            TxoValidationType::Unspent => match result {
+            // A validation of all the outputs reports through the UTXO validation callback, the request key identifies
+            // which validation completed
+            TxoValidationType::Unspent | TxoValidationType::All => match result {
                 CallbackValidationResults::Success => unsafe {
                     (self.callback_utxo_validation_complete)(request_key, CallbackValidationResults::Success as u8);
                 },
@@ -574,6 +813,9 @@ where TBackend: TransactionBackend + 'static
     }
 
     fn saf_messages_received_event(&mut self) {
+        if self.batch_event(BatchedEventType::SafMessagesReceived, 0, 0) {
+            return;
+        }
         debug!(target: LOG_TARGET, "Calling SAF Messages Received callback function");
         unsafe {
             (self.callback_saf_messages_received)();
@@ -583,7 +825,7 @@ where TBackend: TransactionBackend + 'static
 
 #[cfg(test)]
 mod test {
-    use crate::callback_handler::CallbackHandler;
+    use crate::callback_handler::{BatchedEventType, CallbackHandler, EventBatch, EventBatchConfig};
     use chrono::Utc;
     use futures::StreamExt;
     use rand::rngs::OsRng;
@@ -772,6 +1014,30 @@ mod test {
         drop(lock);
     }
 
+    lazy_static! {
+        static ref BATCH_STATE: Mutex<Vec<Vec<(BatchedEventType, u64, u64, bool)>>> = Mutex::new(Vec::new());
+    }
+
+    unsafe extern "C" fn events_batch_callback(batch: *mut EventBatch) {
+        let mut lock = BATCH_STATE.lock().unwrap();
+        lock.push(
+            (*batch)
+                .0
+                .iter()
+                .map(|e| {
+                    (
+                        e.event_type,
+                        e.id,
+                        e.value,
+                        e.completed_transaction.is_some() || e.inbound_transaction.is_some(),
+                    )
+                })
+                .collect(),
+        );
+        drop(lock);
+        Box::from_raw(batch);
+    }
+
     #[test]
     fn test_callback_handler() {
         let mut runtime = Runtime::new().unwrap();
@@ -1042,4 +1308,116 @@ mod test {
 
         drop(lock);
     }
+
+    #[test]
+    fn test_callback_handler_event_batching() {
+        let mut runtime = Runtime::new().unwrap();
+
+        let (_wallet_backend, backend, _oms_backend, _, _tempdir) = make_wallet_databases(None);
+        let db = TransactionDatabase::new(backend);
+        let completed_tx = CompletedTransaction::new(
+            2u64,
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            MicroTari::from(100),
+            MicroTari::from(2000),
+            Transaction::new(
+                Vec::new(),
+                Vec::new(),
+                Vec::new(),
+                BlindingFactor::default(),
+                BlindingFactor::default(),
+            ),
+            TransactionStatus::Completed,
+            "2".to_string(),
+            Utc::now().naive_utc(),
+            TransactionDirection::Inbound,
+            None,
+        );
+        runtime
+            .block_on(db.insert_completed_transaction(2u64, completed_tx))
+            .unwrap();
+
+        let (tx_sender, tx_receiver) = broadcast::channel(20);
+        let (oms_sender, oms_receiver) = broadcast::channel(20);
+        let (dht_sender, dht_receiver) = broadcast::channel(20);
+
+        let shutdown_signal = Shutdown::new();
+        let callback_handler = CallbackHandler::new(
+            db,
+            tx_receiver.fuse(),
+            oms_receiver.fuse(),
+            dht_receiver.fuse(),
+            shutdown_signal.to_signal(),
+            PublicKey::from_secret_key(&PrivateKey::random(&mut OsRng)),
+            received_tx_callback,
+            received_tx_reply_callback,
+            received_tx_finalized_callback,
+            broadcast_callback,
+            mined_callback,
+            mined_unconfirmed_callback,
+            direct_send_callback,
+            store_and_forward_send_callback,
+            tx_cancellation_callback,
+            utxo_validation_complete_callback,
+            stxo_validation_complete_callback,
+            invalid_txo_validation_complete_callback,
+            transaction_validation_complete_callback,
+            saf_messages_received_callback,
+        )
+        .with_event_batching(EventBatchConfig {
+            callback_events_batch: events_batch_callback,
+            window: Duration::from_millis(500),
+            max_events: 0,
+        });
+
+        runtime.spawn(callback_handler.start());
+
+        tx_sender
+            .send(Arc::new(TransactionEvent::ReceivedTransactionReply(2u64)))
+            .unwrap();
+        tx_sender
+            .send(Arc::new(TransactionEvent::TransactionBroadcast(2u64)))
+            .unwrap();
+        tx_sender
+            .send(Arc::new(TransactionEvent::TransactionBroadcast(2u64)))
+            .unwrap();
+        for confirmations in 1..4u64 {
+            tx_sender
+                .send(Arc::new(TransactionEvent::TransactionMinedUnconfirmed(
+                    2u64,
+                    confirmations,
+                )))
+                .unwrap();
+        }
+        // The transaction does not exist so this event is dropped from the batch
+        tx_sender
+            .send(Arc::new(TransactionEvent::TransactionMined(99u64)))
+            .unwrap();
+        oms_sender
+            .send(Arc::new(OutputManagerEvent::TxoValidationSuccess(
+                1u64,
+                TxoValidationType::Unspent,
+            )))
+            .unwrap();
+        dht_sender
+            .send(Arc::new(DhtEvent::StoreAndForwardMessagesReceived))
+            .unwrap();
+        dht_sender
+            .send(Arc::new(DhtEvent::StoreAndForwardMessagesReceived))
+            .unwrap();
+
+        thread::sleep(Duration::from_secs(5));
+
+        let lock = BATCH_STATE.lock().unwrap();
+        assert_eq!(lock.len(), 1);
+        let batch = &lock[0];
+        assert_eq!(batch.len(), 5);
+        assert!(batch.contains(&(BatchedEventType::ReceivedTransactionReply, 2, 0, true)));
+        assert!(batch.contains(&(BatchedEventType::TransactionBroadcast, 2, 0, true)));
+        assert!(batch.contains(&(BatchedEventType::TransactionMinedUnconfirmed, 2, 3, true)));
+        assert!(batch.contains(&(BatchedEventType::UtxoValidationComplete, 1, 0, false)));
+        assert!(batch.contains(&(BatchedEventType::SafMessagesReceived, 0, 0, false)));
+        drop(lock);
+    }
 }
@@ -49,6 +49,8 @@ pub enum InterfaceError {
     TokioError(String),
     #[error("Emoji ID is invalid")]
     InvalidEmojiId,
+    #[error("The timestamp is out of range: `{0}`")]
+    InvalidTimestamp(String),
 }
 
 /// This struct is meant to hold an error for use by FFI client applications. The error has an integer code and string
@@ -83,6 +85,10 @@ impl From<InterfaceError> for LibWalletError {
                 code: 6,
                 message: format!("{:?}", v),
             },
+            InterfaceError::InvalidTimestamp(_) => Self {
+                code: 7,
+                message: format!("{:?}", v),
+            },
         }
     }
 }
@@ -115,20 +115,26 @@
 
 #![recursion_limit = "1024"]
 
-#[cfg(test)]
 #[macro_use]
 extern crate lazy_static;
 mod callback_handler;
 mod enums;
 mod error;
+mod operations;
+mod startup;
 mod tasks;
+mod wallet_runtime;
 
 use crate::{
-    callback_handler::CallbackHandler,
+    callback_handler::{CallbackHandler, EventBatch, EventBatchConfig},
     enums::SeedWordPushResult,
     error::{InterfaceError, TransactionError},
+    operations::{AsyncOperations, OperationCompletionCallback},
+    startup::{spawn_startup, StagedWallet},
     tasks::recovery_event_monitoring,
+    wallet_runtime::{RuntimeConfig, SharedRuntime, WalletRuntime},
 };
+use chrono::NaiveDateTime;
 use core::ptr;
 use error::LibWalletError;
 use futures::StreamExt;
@@ -149,10 +155,12 @@ use log4rs::{
 use rand::rngs::OsRng;
 use std::{
     boxed::Box,
+    convert::TryFrom,
     ffi::{CStr, CString},
     path::PathBuf,
     slice,
     sync::Arc,
+    thread,
     time::Duration,
 };
 use tari_comms::{
@@ -173,6 +181,7 @@ use tari_p2p::transport::{TorConfig, TransportType, TransportType::Tor};
 use tari_shutdown::Shutdown;
 use tari_utilities::{hex, hex::Hex};
 use tari_wallet::{
+    base_node_service::config::BaseNodeServiceConfig,
     contacts_service::storage::database::Contact,
     error::{WalletError, WalletStorageError},
     output_manager_service::TxoValidationType,
@@ -197,14 +206,19 @@ use tari_wallet::{
             database::TransactionDatabase,
             models::{
                 CompletedTransaction,
+                CompletedTransactionQuery,
                 InboundTransaction,
                 OutboundTransaction,
+                TransactionChanges,
                 TransactionDirection,
                 TransactionStatus,
             },
         },
     },
-    util::emoji::{emoji_set, EmojiId},
+    util::{
+        emoji::{emoji_set, EmojiId},
+        encryption::EncryptionProgress,
+    },
     Wallet,
     WalletConfig,
 };
@@ -216,7 +230,6 @@ use tari_wallet::{
     types::ValidationRetryStrategy,
     util::emoji::EmojiIdError,
     utxo_scanner_service::utxo_scanning::UtxoScannerService,
-    WalletSqlite,
 };
 use tokio::runtime::Runtime;
 
@@ -237,6 +250,58 @@ pub type TariCompletedTransaction = tari_wallet::transaction_service::storage::m
 
 pub struct TariCompletedTransactions(Vec<TariCompletedTransaction>);
 
+/// Field selection flags used by `completed_transactions_export` to choose which fields of a
+/// `TariCompletedTransactionRecord` are populated. Fields that are not selected are left zeroed.
+pub const TX_EXPORT_FIELD_TX_ID: c_uint = 1;
+pub const TX_EXPORT_FIELD_AMOUNT: c_uint = 1 << 1;
+pub const TX_EXPORT_FIELD_FEE: c_uint = 1 << 2;
+pub const TX_EXPORT_FIELD_TIMESTAMP: c_uint = 1 << 3;
+pub const TX_EXPORT_FIELD_STATUS: c_uint = 1 << 4;
+pub const TX_EXPORT_FIELD_DIRECTION: c_uint = 1 << 5;
+pub const TX_EXPORT_FIELD_CONFIRMATIONS: c_uint = 1 << 6;
+pub const TX_EXPORT_FIELD_MINED_HEIGHT: c_uint = 1 << 7;
+pub const TX_EXPORT_FIELD_FLAGS: c_uint = 1 << 8;
+pub const TX_EXPORT_FIELD_SOURCE_PUBLIC_KEY: c_uint = 1 << 9;
+pub const TX_EXPORT_FIELD_DESTINATION_PUBLIC_KEY: c_uint = 1 << 10;
+pub const TX_EXPORT_FIELD_MESSAGE: c_uint = 1 << 11;
+pub const TX_EXPORT_FIELD_ALL: c_uint = (1 << 12) - 1;
+
+/// A packed, fixed-width view of a TariCompletedTransaction that can be filled in bulk by
+/// `completed_transactions_export`. The layout must be kept in sync with the declaration in wallet.h.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct TariCompletedTransactionRecord {
+    pub tx_id: u64,
+    pub amount: u64,
+    pub fee: u64,
+    pub timestamp: i64,
+    pub confirmations: u64,
+    pub mined_height: u64,
+    pub status: i32,
+    pub direction: i32,
+    /// Offset of the NUL terminated message within the caller supplied message arena
+    pub message_offset: u32,
+    /// Length of the message in bytes, excluding the NUL terminator
+    pub message_length: u32,
+    pub source_public_key: [u8; 32],
+    pub destination_public_key: [u8; 32],
+    pub is_valid: bool,
+    pub is_cancelled: bool,
+}
+
+/// All the balance figures of a TariWallet, filled in by `wallet_get_balance`. The layout must be kept in sync with the
+/// declaration in wallet.h.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct TariBalance {
+    pub available_balance: u64,
+    /// The part of the available balance that is not spendable yet, 0 if the chain tip is not known
+    pub time_locked_balance: u64,
+    pub pending_incoming_balance: u64,
+    pub pending_outgoing_balance: u64,
+}
+
+pub type TariOperationCompletion = operations::TariOperationCompletion;
 pub type TariPendingInboundTransaction = tari_wallet::transaction_service::storage::models::InboundTransaction;
 pub type TariPendingOutboundTransaction = tari_wallet::transaction_service::storage::models::OutboundTransaction;
 
@@ -244,6 +309,13 @@ pub struct TariPendingInboundTransactions(Vec<TariPendingInboundTransaction>);
 
 pub struct TariPendingOutboundTransactions(Vec<TariPendingOutboundTransaction>);
 
+pub type TariTransactionChanges = TransactionChanges;
+
+pub type TariEventBatch = EventBatch;
+
+pub type TariRuntimeConfig = RuntimeConfig;
+pub type TariRuntime = SharedRuntime;
+
 #[derive(Debug, PartialEq, Clone)]
 pub struct ByteVector(Vec<c_uchar>); // declared like this so that it can be exposed to external header
 
@@ -254,8 +326,9 @@ pub struct EmojiSet(Vec<ByteVector>);
 pub struct TariSeedWords(Vec<String>);
 
 pub struct TariWallet {
-    wallet: WalletSqlite,
-    runtime: Runtime,
+    wallet: StagedWallet,
+    runtime: WalletRuntime,
+    operations: AsyncOperations,
     shutdown: Shutdown,
 }
 
@@ -1251,6 +1324,134 @@ pub unsafe extern "C" fn completed_transactions_destroy(transactions: *mut TariC
     }
 }
 
+/// Exports a range of a TariCompletedTransactions into a caller supplied array of TariCompletedTransactionRecords in
+/// a single call. Only the fields selected in `fields` are populated, the rest are zeroed. Messages are written as NUL
+/// terminated strings into a single caller supplied arena and referenced from each record by offset and length.
+///
+/// ## Arguments
+/// `transactions` - The pointer to a TariCompletedTransactions
+/// `start` - The position of the first transaction to export
+/// `fields` - A bitmask of the `TX_EXPORT_FIELD_*` values selecting the fields to populate
+/// `records` - The pointer to the first element of an array of TariCompletedTransactionRecord
+/// `records_len` - The number of elements in the `records` array
+/// `message_arena` - The pointer to a char buffer that will receive the messages, may only be null if
+/// `TX_EXPORT_FIELD_MESSAGE` is not selected
+/// `message_arena_len` - The size in bytes of the `message_arena` buffer
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_uint` - Returns the number of records written. This is less than `records_len` when the end of the collection is
+/// reached or the message arena is full, in which case the call can be repeated with `start` advanced by the returned
+/// amount. Zero is returned if an error occurred.
+///
+/// # Safety
+/// `records` must point to at least `records_len` elements and `message_arena` to at least `message_arena_len` bytes
+#[no_mangle]
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn completed_transactions_export(
+    transactions: *mut TariCompletedTransactions,
+    start: c_uint,
+    fields: c_uint,
+    records: *mut TariCompletedTransactionRecord,
+    records_len: c_uint,
+    message_arena: *mut c_char,
+    message_arena_len: c_uint,
+    error_out: *mut c_int,
+) -> c_uint {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transactions.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transactions".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if records.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("records".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    let export_messages = fields & TX_EXPORT_FIELD_MESSAGE != 0;
+    if export_messages && message_arena.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("message_arena".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    let txs = &(*transactions).0;
+    if start as usize > txs.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let records = slice::from_raw_parts_mut(records, records_len as usize);
+    let arena: &mut [u8] = if export_messages {
+        slice::from_raw_parts_mut(message_arena as *mut u8, message_arena_len as usize)
+    } else {
+        &mut []
+    };
+    let mut arena_pos = 0usize;
+    let mut written = 0usize;
+
+    for (record, tx) in records.iter_mut().zip(txs.iter().skip(start as usize)) {
+        let mut r = TariCompletedTransactionRecord::default();
+        if export_messages {
+            let message = tx.message.as_bytes();
+            if arena_pos + message.len() + 1 > arena.len() {
+                if written == 0 {
+                    error = LibWalletError::from(InterfaceError::AllocationError).code;
+                    ptr::swap(error_out, &mut error as *mut c_int);
+                }
+                break;
+            }
+            arena[arena_pos..arena_pos + message.len()].copy_from_slice(message);
+            arena[arena_pos + message.len()] = 0;
+            r.message_offset = arena_pos as u32;
+            r.message_length = message.len() as u32;
+            arena_pos += message.len() + 1;
+        }
+        if fields & TX_EXPORT_FIELD_TX_ID != 0 {
+            r.tx_id = tx.tx_id;
+        }
+        if fields & TX_EXPORT_FIELD_AMOUNT != 0 {
+            r.amount = u64::from(tx.amount);
+        }
+        if fields & TX_EXPORT_FIELD_FEE != 0 {
+            r.fee = u64::from(tx.fee);
+        }
+        if fields & TX_EXPORT_FIELD_TIMESTAMP != 0 {
+            r.timestamp = tx.timestamp.timestamp();
+        }
+        if fields & TX_EXPORT_FIELD_STATUS != 0 {
+            r.status = tx.status.clone() as i32;
+        }
+        if fields & TX_EXPORT_FIELD_DIRECTION != 0 {
+            r.direction = tx.direction.clone() as i32;
+        }
+        if fields & TX_EXPORT_FIELD_CONFIRMATIONS != 0 {
+            r.confirmations = tx.confirmations.unwrap_or(0);
+        }
+        if fields & TX_EXPORT_FIELD_MINED_HEIGHT != 0 {
+            r.mined_height = tx.mined_height.unwrap_or(0);
+        }
+        if fields & TX_EXPORT_FIELD_FLAGS != 0 {
+            r.is_valid = tx.valid;
+            r.is_cancelled = tx.cancelled;
+        }
+        if fields & TX_EXPORT_FIELD_SOURCE_PUBLIC_KEY != 0 {
+            r.source_public_key.copy_from_slice(tx.source_public_key.as_bytes());
+        }
+        if fields & TX_EXPORT_FIELD_DESTINATION_PUBLIC_KEY != 0 {
+            r.destination_public_key
+                .copy_from_slice(tx.destination_public_key.as_bytes());
+        }
+        *record = r;
+        written += 1;
+    }
+
+    written as c_uint
+}
+
 /// -------------------------------------------------------------------------------------------- ///
 
 /// ----------------------------------- OutboundTransactions ------------------------------------ ///
@@ -1430,311 +1631,708 @@ pub unsafe extern "C" fn pending_inbound_transactions_destroy(transactions: *mut
 
 /// -------------------------------------------------------------------------------------------- ///
 
-/// ----------------------------------- CompletedTransaction ------------------------------------- ///
+/// ----------------------------------- TransactionChanges -------------------------------------- ///
 
-/// Gets the TransactionID of a TariCompletedTransaction
+/// Gets the change sequence number of the most recent change included in a TariTransactionChanges. Pass this value
+/// to `wallet_get_transaction_changes_since` to fetch the next set of changes.
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `changes` - The pointer to a TariTransactionChanges
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `c_ulonglong` - Returns the TransactionID, note that it will be zero if transaction is null
+/// `c_ulonglong` - Returns the change sequence number, note that it will be zero if changes is null
 ///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_transaction_id(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn transaction_changes_get_sequence(
+    changes: *mut TariTransactionChanges,
     error_out: *mut c_int,
 ) -> c_ulonglong {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+    if changes.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("changes".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
-    (*transaction).tx_id as c_ulonglong
+
+    (*changes).latest_sequence as c_ulonglong
 }
 
-/// Gets the destination TariPublicKey of a TariCompletedTransaction
+/// Gets the pending inbound transactions that changed, including cancelled ones, from a TariTransactionChanges
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `changes` - The pointer to a TariTransactionChanges
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `*mut TariPublicKey` - Returns the destination TariPublicKey, note that it will be
-/// ptr::null_mut() if transaction is null
+/// `*mut TariPendingInboundTransactions` - Returns a pointer to a TariPendingInboundTransactions, note that
+/// ptr::null_mut() is returned if changes is null
 ///
 /// # Safety
-/// The ```public_key_destroy``` method must be called when finished with a TariPublicKey to prevent a memory leak
+/// The ```pending_inbound_transactions_destroy``` method must be called when finished with a
+/// TariPendingInboundTransactions to prevent a memory leak
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_destination_public_key(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn transaction_changes_get_pending_inbound(
+    changes: *mut TariTransactionChanges,
     error_out: *mut c_int,
-) -> *mut TariPublicKey {
+) -> *mut TariPendingInboundTransactions {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+    if changes.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("changes".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
-    let m = (*transaction).destination_public_key.clone();
-    Box::into_raw(Box::new(m))
+
+    Box::into_raw(Box::new(TariPendingInboundTransactions((*changes).pending_inbound.clone())))
 }
 
-/// Gets the TariExcess of a TariCompletedTransaction
+/// Gets the pending outbound transactions that changed, including cancelled ones, from a TariTransactionChanges
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `changes` - The pointer to a TariTransactionChanges
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `*mut TariExcess` - Returns the transaction excess, note that it will be
-/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
-/// exactly one.
+/// `*mut TariPendingOutboundTransactions` - Returns a pointer to a TariPendingOutboundTransactions, note that
+/// ptr::null_mut() is returned if changes is null
 ///
 /// # Safety
-/// The ```excess_destroy``` method must be called when finished with a TariExcess to prevent a memory leak
+/// The ```pending_outbound_transactions_destroy``` method must be called when finished with a
+/// TariPendingOutboundTransactions to prevent a memory leak
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_excess(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn transaction_changes_get_pending_outbound(
+    changes: *mut TariTransactionChanges,
     error_out: *mut c_int,
-) -> *mut TariExcess {
+) -> *mut TariPendingOutboundTransactions {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
-
-    // check the tx is not in pending state
-    if matches!(
-        (*transaction).status,
-        TransactionStatus::Pending | TransactionStatus::Imported
-    ) {
-        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
-        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
-
-    let kernels = (*transaction).transaction.get_body().kernels();
-
-    // currently we presume that each CompletedTransaction only has 1 kernel
-    // if that changes this will need to be accounted for
-    if kernels.len() != 1 {
-        let msg = format!("Expected 1 kernel, got {}", kernels.len());
-        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
+    if changes.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("changes".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
 
-    let x = kernels[0].excess.clone();
-    Box::into_raw(Box::new(x))
+    Box::into_raw(Box::new(TariPendingOutboundTransactions((*changes).pending_outbound.clone())))
 }
 
-/// Gets the TariExcessPublicNonce of a TariCompletedTransaction
+/// Gets the completed transactions that changed, including cancelled ones, from a TariTransactionChanges. A pending
+/// transaction that has since been completed is reported here under the same TxId.
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `changes` - The pointer to a TariTransactionChanges
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `*mut TariExcessPublicNonce` - Returns the transaction excess public nonce, note that it will be
-/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
-/// exactly one.
+/// `*mut TariCompletedTransactions` - Returns a pointer to a TariCompletedTransactions, note that ptr::null_mut() is
+/// returned if changes is null
 ///
 /// # Safety
-/// The ```nonce_destroy``` method must be called when finished with a TariExcessPublicNonce to prevent a memory leak
+/// The ```completed_transactions_destroy``` method must be called when finished with a TariCompletedTransactions to
+/// prevent a memory leak
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_public_nonce(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn transaction_changes_get_completed(
+    changes: *mut TariTransactionChanges,
     error_out: *mut c_int,
-) -> *mut TariExcessPublicNonce {
+) -> *mut TariCompletedTransactions {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
-
-    // check the tx is not in pending state
-    if matches!(
-        (*transaction).status,
-        TransactionStatus::Pending | TransactionStatus::Imported
-    ) {
-        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
-        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
-
-    let kernels = (*transaction).transaction.get_body().kernels();
-
-    // currently we presume that each CompletedTransaction only has 1 kernel
-    // if that changes this will need to be accounted for
-    if kernels.len() != 1 {
-        let msg = format!("Expected 1 kernel, got {}", kernels.len());
-        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
+    if changes.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("changes".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
 
-    let r = kernels[0].excess_sig.get_public_nonce().clone();
-    Box::into_raw(Box::new(r))
+    Box::into_raw(Box::new(TariCompletedTransactions((*changes).completed.clone())))
 }
 
-/// Gets the TariExcessSignature of a TariCompletedTransaction
+/// Frees memory for a TariTransactionChanges
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
-/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
-/// as an out parameter.
+/// `changes` - The pointer to a TariTransactionChanges
 ///
 /// ## Returns
-/// `*mut TariExcessSignature` - Returns the transaction excess signature, note that it will be
-/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
-/// exactly one.
+/// `()` - Does not return a value, equivalent to void in C
 ///
 /// # Safety
-/// The ```signature_destroy``` method must be called when finished with a TariExcessSignature to prevent a memory leak
+/// None
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_signature(
-    transaction: *mut TariCompletedTransaction,
-    error_out: *mut c_int,
-) -> *mut TariExcessSignature {
-    let mut error = 0;
-    ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
-
-    // check the tx is not in pending state
-    if matches!(
-        (*transaction).status,
-        TransactionStatus::Pending | TransactionStatus::Imported
-    ) {
-        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
-        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
+pub unsafe extern "C" fn transaction_changes_destroy(changes: *mut TariTransactionChanges) {
+    if !changes.is_null() {
+        Box::from_raw(changes);
     }
+}
 
-    let kernels = (*transaction).transaction.get_body().kernels();
-
-    // currently we presume that each CompletedTransaction only has 1 kernel
-    // if that changes this will need to be accounted for
-    if kernels.len() != 1 {
-        let msg = format!("Expected 1 kernel, got {}", kernels.len());
-        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
-    }
+/// -------------------------------------------------------------------------------------------- ///
 
-    let s = kernels[0].excess_sig.get_signature().clone();
-    Box::into_raw(Box::new(s))
-}
+/// ----------------------------------- EventBatch ---------------------------------------------- ///
 
-/// Gets the source TariPublicKey of a TariCompletedTransaction
+/// Gets the number of events in a TariEventBatch
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `batch` - The pointer to a TariEventBatch
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `*mut TariPublicKey` - Returns the source TariPublicKey, note that it will be
-/// ptr::null_mut() if transaction is null
+/// `c_uint` - Returns the number of events in the batch, note that it will be zero if batch is null
 ///
 /// # Safety
-/// The ```public_key_destroy``` method must be called when finished with a TariPublicKey to prevent a memory leak
+/// None
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_source_public_key(
-    transaction: *mut TariCompletedTransaction,
-    error_out: *mut c_int,
-) -> *mut TariPublicKey {
+pub unsafe extern "C" fn event_batch_get_length(batch: *mut TariEventBatch, error_out: *mut c_int) -> c_uint {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+    let mut len = 0;
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return ptr::null_mut();
+    } else {
+        len = (*batch).0.len();
     }
-    let m = (*transaction).source_public_key.clone();
-    Box::into_raw(Box::new(m))
+
+    len as c_uint
 }
 
-/// Gets the status of a TariCompletedTransaction
+/// Gets the type of the event at the given position of a TariEventBatch, the type identifies the individual callback
+/// the event would otherwise have been delivered to
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `batch` - The pointer to a TariEventBatch
+/// `position` - The integer position of the event
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `c_int` - Returns the status which corresponds to:
-/// | Value | Interpretation |
+/// `c_int` - Returns the event type, note that it returns -1 if batch is null or position is invalid
+/// | Value | Interpretation                |
 /// |---|---|
-/// |  -1 | TxNullError         |
-/// |   0 | Completed           |
-/// |   1 | Broadcast           |
-/// |   2 | MinedUnconfirmed    |
-/// |   3 | Imported            |
-/// |   4 | Pending             |
-/// |   5 | Coinbase            |
-/// |   6 | MinedConfirmed      |
+/// |   0 | ReceivedTransaction             |
+/// |   1 | ReceivedTransactionReply        |
+/// |   2 | ReceivedFinalizedTransaction    |
+/// |   3 | TransactionBroadcast            |
+/// |   4 | TransactionMined                |
+/// |   5 | TransactionMinedUnconfirmed     |
+/// |   6 | DirectSendResult                |
+/// |   7 | StoreAndForwardSendResult       |
+/// |   8 | TransactionCancellation         |
+/// |   9 | UtxoValidationComplete          |
+/// |  10 | StxoValidationComplete          |
+/// |  11 | InvalidTxoValidationComplete    |
+/// |  12 | TransactionValidationComplete   |
+/// |  13 | SafMessagesReceived             |
+/// |  14 | TxoValidationComplete           |
 ///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_status(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn event_batch_get_event_type(
+    batch: *mut TariEventBatch,
+    position: c_uint,
     error_out: *mut c_int,
 ) -> c_int {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return -1;
     }
-    let status = (*transaction).status.clone();
-    status as c_int
+    if position as usize >= (*batch).0.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return -1;
+    }
+
+    (*batch).0[position as usize].event_type as c_int
 }
 
-/// Gets the amount of a TariCompletedTransaction
+/// Gets the TxId, or the request key for validation events, of the event at the given position of a TariEventBatch
 ///
 /// ## Arguments
-/// `transaction` - The pointer to a TariCompletedTransaction
+/// `batch` - The pointer to a TariEventBatch
+/// `position` - The integer position of the event
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `c_ulonglong` - Returns the amount, note that it will be zero if transaction is null
+/// `c_ulonglong` - Returns the TxId or request key, note that it returns 0 if batch is null or position is invalid
 ///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn completed_transaction_get_amount(
-    transaction: *mut TariCompletedTransaction,
+pub unsafe extern "C" fn event_batch_get_id(
+    batch: *mut TariEventBatch,
+    position: c_uint,
     error_out: *mut c_int,
 ) -> c_ulonglong {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
-    if transaction.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if position as usize >= (*batch).0.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    (*batch).0[position as usize].id as c_ulonglong
+}
+
+/// Gets the value of the event at the given position of a TariEventBatch. This is the number of confirmations for
+/// TransactionMinedUnconfirmed, 1 for success or 0 for failure for the send result events and the
+/// CallbackValidationResults value for the validation complete events
+///
+/// ## Arguments
+/// `batch` - The pointer to a TariEventBatch
+/// `position` - The integer position of the event
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` - Returns the value, note that it returns 0 if batch is null or position is invalid
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn event_batch_get_value(
+    batch: *mut TariEventBatch,
+    position: c_uint,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if position as usize >= (*batch).0.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    (*batch).0[position as usize].value as c_ulonglong
+}
+
+/// Gets the TariCompletedTransaction of the event at the given position of a TariEventBatch. This is available for
+/// the ReceivedTransactionReply, ReceivedFinalizedTransaction, TransactionBroadcast, TransactionMined,
+/// TransactionMinedUnconfirmed and TransactionCancellation events
+///
+/// ## Arguments
+/// `batch` - The pointer to a TariEventBatch
+/// `position` - The integer position of the event
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariCompletedTransaction` - Returns a pointer to a TariCompletedTransaction, note that ptr::null_mut() is
+/// returned if batch is null, position is invalid or the event does not carry a completed transaction
+///
+/// # Safety
+/// The ```completed_transaction_destroy``` method must be called when finished with a TariCompletedTransaction to
+/// prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn event_batch_get_completed_transaction(
+    batch: *mut TariEventBatch,
+    position: c_uint,
+    error_out: *mut c_int,
+) -> *mut TariCompletedTransaction {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    if position as usize >= (*batch).0.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    match (*batch).0[position as usize].completed_transaction {
+        Some(ref tx) => Box::into_raw(Box::new(tx.clone())),
+        None => ptr::null_mut(),
+    }
+}
+
+/// Gets the TariPendingInboundTransaction of the event at the given position of a TariEventBatch. This is only
+/// available for the ReceivedTransaction event
+///
+/// ## Arguments
+/// `batch` - The pointer to a TariEventBatch
+/// `position` - The integer position of the event
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariPendingInboundTransaction` - Returns a pointer to a TariPendingInboundTransaction, note that
+/// ptr::null_mut() is returned if batch is null, position is invalid or the event does not carry an inbound transaction
+///
+/// # Safety
+/// The ```pending_inbound_transaction_destroy``` method must be called when finished with a
+/// TariPendingInboundTransaction to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn event_batch_get_pending_inbound_transaction(
+    batch: *mut TariEventBatch,
+    position: c_uint,
+    error_out: *mut c_int,
+) -> *mut TariPendingInboundTransaction {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if batch.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("batch".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    if position as usize >= (*batch).0.len() {
+        error = LibWalletError::from(InterfaceError::PositionInvalidError).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    match (*batch).0[position as usize].inbound_transaction {
+        Some(ref tx) => Box::into_raw(Box::new(tx.clone())),
+        None => ptr::null_mut(),
+    }
+}
+
+/// Frees memory for a TariEventBatch
+///
+/// ## Arguments
+/// `batch` - The pointer to a TariEventBatch
+///
+/// ## Returns
+/// `()` - Does not return a value, equivalent to void in C
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn event_batch_destroy(batch: *mut TariEventBatch) {
+    if !batch.is_null() {
+        Box::from_raw(batch);
+    }
+}
+
+/// -------------------------------------------------------------------------------------------- ///
+
+/// ----------------------------------- CompletedTransaction ------------------------------------- ///
+
+/// Gets the TransactionID of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` - Returns the TransactionID, note that it will be zero if transaction is null
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_transaction_id(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    (*transaction).tx_id as c_ulonglong
+}
+
+/// Gets the destination TariPublicKey of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariPublicKey` - Returns the destination TariPublicKey, note that it will be
+/// ptr::null_mut() if transaction is null
+///
+/// # Safety
+/// The ```public_key_destroy``` method must be called when finished with a TariPublicKey to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_destination_public_key(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> *mut TariPublicKey {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    let m = (*transaction).destination_public_key.clone();
+    Box::into_raw(Box::new(m))
+}
+
+/// Gets the TariExcess of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariExcess` - Returns the transaction excess, note that it will be
+/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
+/// exactly one.
+///
+/// # Safety
+/// The ```excess_destroy``` method must be called when finished with a TariExcess to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_excess(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> *mut TariExcess {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    // check the tx is not in pending state
+    if matches!(
+        (*transaction).status,
+        TransactionStatus::Pending | TransactionStatus::Imported
+    ) {
+        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
+        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let kernels = (*transaction).transaction.get_body().kernels();
+
+    // currently we presume that each CompletedTransaction only has 1 kernel
+    // if that changes this will need to be accounted for
+    if kernels.len() != 1 {
+        let msg = format!("Expected 1 kernel, got {}", kernels.len());
+        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let x = kernels[0].excess.clone();
+    Box::into_raw(Box::new(x))
+}
+
+/// Gets the TariExcessPublicNonce of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariExcessPublicNonce` - Returns the transaction excess public nonce, note that it will be
+/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
+/// exactly one.
+///
+/// # Safety
+/// The ```nonce_destroy``` method must be called when finished with a TariExcessPublicNonce to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_public_nonce(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> *mut TariExcessPublicNonce {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    // check the tx is not in pending state
+    if matches!(
+        (*transaction).status,
+        TransactionStatus::Pending | TransactionStatus::Imported
+    ) {
+        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
+        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let kernels = (*transaction).transaction.get_body().kernels();
+
+    // currently we presume that each CompletedTransaction only has 1 kernel
+    // if that changes this will need to be accounted for
+    if kernels.len() != 1 {
+        let msg = format!("Expected 1 kernel, got {}", kernels.len());
+        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let r = kernels[0].excess_sig.get_public_nonce().clone();
+    Box::into_raw(Box::new(r))
+}
+
+/// Gets the TariExcessSignature of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariExcessSignature` - Returns the transaction excess signature, note that it will be
+/// ptr::null_mut() if transaction is null, if the transaction status is Pending, or if the number of kernels is not
+/// exactly one.
+///
+/// # Safety
+/// The ```signature_destroy``` method must be called when finished with a TariExcessSignature to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_signature(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> *mut TariExcessSignature {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    // check the tx is not in pending state
+    if matches!(
+        (*transaction).status,
+        TransactionStatus::Pending | TransactionStatus::Imported
+    ) {
+        let msg = format!("Incorrect transaction status: {}", (*transaction).status);
+        error = LibWalletError::from(TransactionError::StatusError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let kernels = (*transaction).transaction.get_body().kernels();
+
+    // currently we presume that each CompletedTransaction only has 1 kernel
+    // if that changes this will need to be accounted for
+    if kernels.len() != 1 {
+        let msg = format!("Expected 1 kernel, got {}", kernels.len());
+        error = LibWalletError::from(TransactionError::KernelError(msg)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let s = kernels[0].excess_sig.get_signature().clone();
+    Box::into_raw(Box::new(s))
+}
+
+/// Gets the source TariPublicKey of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariPublicKey` - Returns the source TariPublicKey, note that it will be
+/// ptr::null_mut() if transaction is null
+///
+/// # Safety
+/// The ```public_key_destroy``` method must be called when finished with a TariPublicKey to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_source_public_key(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> *mut TariPublicKey {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    let m = (*transaction).source_public_key.clone();
+    Box::into_raw(Box::new(m))
+}
+
+/// Gets the status of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_int` - Returns the status which corresponds to:
+/// | Value | Interpretation |
+/// |---|---|
+/// |  -1 | TxNullError         |
+/// |   0 | Completed           |
+/// |   1 | Broadcast           |
+/// |   2 | MinedUnconfirmed    |
+/// |   3 | Imported            |
+/// |   4 | Pending             |
+/// |   5 | Coinbase            |
+/// |   6 | MinedConfirmed      |
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_status(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> c_int {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return -1;
+    }
+    let status = (*transaction).status.clone();
+    status as c_int
+}
+
+/// Gets the amount of a TariCompletedTransaction
+///
+/// ## Arguments
+/// `transaction` - The pointer to a TariCompletedTransaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` - Returns the amount, note that it will be zero if transaction is null
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn completed_transaction_get_amount(
+    transaction: *mut TariCompletedTransaction,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if transaction.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("transaction".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
@@ -2679,6 +3277,121 @@ pub unsafe extern "C" fn comms_config_destroy(wc: *mut TariCommsConfig) {
 
 /// ---------------------------------------------------------------------------------------------- ///
 
+/// ------------------------------------- Runtime ------------------------------------------------///
+
+/// Creates a TariRuntimeConfig
+///
+/// ## Arguments
+/// `core_threads` - The number of worker threads of the multi-threaded scheduler, 0 for one per core
+/// `max_threads` - The maximum number of threads, including the worker threads, that the runtime and its blocking
+/// pool may use, 0 for the default
+/// `current_thread` - If true all tasks are run on a single scheduler thread and `core_threads` is ignored. Callbacks
+/// then run on that thread, so wallet functions must not be called from a callback of a wallet using this runtime
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariRuntimeConfig` - Returns a pointer to a TariRuntimeConfig
+///
+/// # Safety
+/// The ```runtime_config_destroy``` method must be called when finished with a TariRuntimeConfig to prevent a memory
+/// leak
+#[no_mangle]
+pub unsafe extern "C" fn runtime_config_create(
+    core_threads: c_uint,
+    max_threads: c_uint,
+    current_thread: bool,
+    error_out: *mut c_int,
+) -> *mut TariRuntimeConfig {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    let config = RuntimeConfig {
+        core_threads: if core_threads > 0 {
+            Some(core_threads as usize)
+        } else {
+            None
+        },
+        max_threads: if max_threads > 0 {
+            Some(max_threads as usize)
+        } else {
+            None
+        },
+        current_thread,
+    };
+    Box::into_raw(Box::new(config))
+}
+
+/// Frees memory for a TariRuntimeConfig
+///
+/// ## Arguments
+/// `config` - The TariRuntimeConfig pointer
+///
+/// ## Returns
+/// `()` - Does not return a value, equivalent to void in C
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn runtime_config_destroy(config: *mut TariRuntimeConfig) {
+    if !config.is_null() {
+        Box::from_raw(config);
+    }
+}
+
+/// Creates a TariRuntime that can be passed to any number of `wallet_create` calls so that the wallets share its
+/// threads instead of each wallet creating its own runtime
+///
+/// ## Arguments
+/// `config` - The TariRuntimeConfig pointer, if null the Tokio defaults are used
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariRuntime` - Returns a pointer to a TariRuntime, note that it returns ptr::null_mut() if the runtime could
+/// not be created
+///
+/// # Safety
+/// The ```runtime_destroy``` method must be called when finished with a TariRuntime to prevent a memory leak, and only
+/// after every TariWallet created with it has been destroyed
+#[no_mangle]
+pub unsafe extern "C" fn runtime_create(config: *mut TariRuntimeConfig, error_out: *mut c_int) -> *mut TariRuntime {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    let config = if config.is_null() {
+        RuntimeConfig::default()
+    } else {
+        (*config).clone()
+    };
+
+    match SharedRuntime::new(&config) {
+        Ok(runtime) => Box::into_raw(Box::new(runtime)),
+        Err(e) => {
+            error = LibWalletError::from(InterfaceError::TokioError(e.to_string())).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            ptr::null_mut()
+        },
+    }
+}
+
+/// Frees memory for a TariRuntime and stops its threads
+///
+/// ## Arguments
+/// `runtime` - The TariRuntime pointer
+///
+/// ## Returns
+/// `()` - Does not return a value, equivalent to void in C
+///
+/// # Safety
+/// Every TariWallet created with this TariRuntime must be destroyed before calling this function
+#[no_mangle]
+pub unsafe extern "C" fn runtime_destroy(runtime: *mut TariRuntime) {
+    if !runtime.is_null() {
+        Box::from_raw(runtime);
+    }
+}
+
+/// ---------------------------------------------------------------------------------------------- ///
+
 /// ------------------------------------- Wallet -------------------------------------------------///
 
 unsafe fn init_logging(log_path: *const c_char, num_rolling_log_files: c_uint, size_per_log_file_bytes: c_uint) {
@@ -2747,6 +3460,9 @@ unsafe fn init_logging(log_path: *const c_char, num_rolling_log_files: c_uint, s
 /// encrypted then the correct passphrase is required or this function will fail.
 /// `seed_words` - An optional instance of TariSeedWords, used to create a wallet for recovery purposes.
 /// If this is null, then a new master key is created for the wallet.
+/// `runtime` - An optional TariRuntime created with `runtime_create` that this wallet will share with other wallets. If
+/// this is null the wallet creates and owns its own runtime. Wallets sharing a runtime and a base node poll the chain
+/// metadata of that base node only once between them.
 /// `callback_received_transaction` - The callback function pointer matching the function signature. This will be
 /// called when an inbound transaction is received. `callback_received_transaction_reply` - The callback function
 /// pointer matching the function signature. This will be called when a reply is received for a pending outbound
@@ -2776,6 +3492,16 @@ unsafe fn init_logging(log_path: *const c_char, num_rolling_log_files: c_uint, s
 /// `callback_saf_message_received` - The callback function pointer that will be called when the Dht has determined that
 /// is has connected to enough of its neighbours to be confident that it has received any SAF messages that were waiting
 /// for it.
+/// `callback_events_batch` - An optional callback function pointer, pass null to use the individual callbacks above.
+/// If set, the individual callbacks are not called and the events are instead collected and delivered together in a
+/// TariEventBatch, with repeated events of the same type for the same TxId or request key delivered only once.
+/// `events_batch_window_ms` - How long, in milliseconds, events are collected for before a batch is delivered
+/// `events_batch_max_events` - A batch is delivered as soon as it holds this many events, 0 for no limit
+/// `callback_wallet_ready` - An optional callback function pointer. If set, this function returns as soon as the
+/// databases are open and the wallet services are started in the background, the callback is then called with 0 once
+/// the wallet has started or with the error code if it failed to start. Until then the balance, transaction and contact
+/// queries are answered from the databases and every other function waits for the startup to complete. If null, this
+/// function only returns once the wallet has started.
 /// `error_out` - Pointer to an int which will be modified
 /// to an error code should one occur, may not be null. Functions as an out parameter.
 /// ## Returns
@@ -2793,6 +3519,7 @@ pub unsafe extern "C" fn wallet_create(
     size_per_log_file_bytes: c_uint,
     passphrase: *const c_char,
     seed_words: *const TariSeedWords,
+    runtime: *mut TariRuntime,
     callback_received_transaction: unsafe extern "C" fn(*mut TariPendingInboundTransaction),
     callback_received_transaction_reply: unsafe extern "C" fn(*mut TariCompletedTransaction),
     callback_received_finalized_transaction: unsafe extern "C" fn(*mut TariCompletedTransaction),
@@ -2807,6 +3534,10 @@ pub unsafe extern "C" fn wallet_create(
     callback_invalid_txo_validation_complete: unsafe extern "C" fn(u64, u8),
     callback_transaction_validation_complete: unsafe extern "C" fn(u64, u8),
     callback_saf_messages_received: unsafe extern "C" fn(),
+    callback_events_batch: Option<unsafe extern "C" fn(*mut TariEventBatch)>,
+    events_batch_window_ms: c_ulonglong,
+    events_batch_max_events: c_uint,
+    callback_wallet_ready: Option<unsafe extern "C" fn(c_int)>,
     error_out: *mut c_int,
 ) -> *mut TariWallet {
     use tari_key_manager::mnemonic::Mnemonic;
@@ -2847,130 +3578,199 @@ pub unsafe extern "C" fn wallet_create(
         }
     };
 
-    let mut runtime = match Runtime::new() {
-        Ok(r) => r,
-        Err(e) => {
-            error = LibWalletError::from(InterfaceError::TokioError(e.to_string())).code;
-            ptr::swap(error_out, &mut error as *mut c_int);
-            return ptr::null_mut();
-        },
-    };
-    let factories = CryptoFactories::default();
-    let w;
-
+    // Running the database migrations does not depend on the runtime, so the two are set up concurrently
     let sql_database_path = (*config)
         .datastore_path
         .join((*config).peer_database_name.clone())
         .with_extension("sqlite3");
-
-    debug!(target: LOG_TARGET, "Running Wallet database migrations");
-    let (wallet_backend, transaction_backend, output_manager_backend, contacts_backend) =
-        match initialize_sqlite_database_backends(sql_database_path, passphrase_option) {
-            Ok((w, t, o, c)) => (w, t, o, c),
+    let open_databases = thread::spawn(move || {
+        debug!(target: LOG_TARGET, "Running Wallet database migrations");
+        initialize_sqlite_database_backends(sql_database_path, passphrase_option)
+    });
+
+    let (mut runtime, chain_metadata_hub) = if runtime.is_null() {
+        match Runtime::new() {
+            Ok(r) => (WalletRuntime::Owned(r), None),
             Err(e) => {
-                error = LibWalletError::from(WalletError::WalletStorageError(e)).code;
+                error = LibWalletError::from(InterfaceError::TokioError(e.to_string())).code;
                 ptr::swap(error_out, &mut error as *mut c_int);
                 return ptr::null_mut();
             },
-        };
+        }
+    } else {
+        (
+            (*runtime).wallet_runtime(),
+            Some((*runtime).chain_metadata_hub().clone()),
+        )
+    };
+    let (wallet_backend, transaction_backend, output_manager_backend, contacts_backend) = match open_databases.join() {
+        Ok(Ok((w, t, o, c))) => (w, t, o, c),
+        Ok(Err(e)) => {
+            error = LibWalletError::from(WalletError::WalletStorageError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            return ptr::null_mut();
+        },
+        Err(_) => {
+            error = LibWalletError::from(InterfaceError::TokioError(
+                "The database migrations thread panicked".to_string(),
+            ))
+            .code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            return ptr::null_mut();
+        },
+    };
     let wallet_database = WalletDatabase::new(wallet_backend);
 
     debug!(target: LOG_TARGET, "Databases Initialized");
 
-    // If the transport type is Tor then check if there is a stored TorID, if there is update the Transport Type
-    let mut comms_config = (*config).clone();
-    comms_config.transport_type = match comms_config.transport_type {
-        Tor(mut tor_config) => {
-            tor_config.identity = match runtime.block_on(wallet_database.get_tor_id()) {
-                Ok(Some(v)) => Some(Box::new(v)),
-                _ => None,
-            };
-            Tor(tor_config)
-        },
-        _ => comms_config.transport_type,
-    };
-
+    // The databases are ready so the rest of the startup, which includes bootstrapping the transport and can take a
+    // long time, runs in the background. The wallet serves balances, transactions and contacts from the databases
+    // until it has started.
     let shutdown = Shutdown::new();
-    let wallet_config = WalletConfig::new(
-        comms_config,
-        factories,
-        Some(TransactionServiceConfig {
-            direct_send_timeout: (*config).dht.discovery_request_timeout,
-            ..Default::default()
-        }),
-        None,
-        Network::Weatherwax.into(),
-        None,
-        None,
-        None,
-        None,
-    );
+    let shutdown_signal = shutdown.to_signal();
+    let comms_config = (*config).clone();
+    let direct_send_timeout = (*config).dht.discovery_request_timeout;
+    let startup_database = wallet_database.clone();
+    let startup_transaction_backend = transaction_backend.clone();
+    let startup_output_manager_backend = output_manager_backend.clone();
+    let startup_contacts_backend = contacts_backend.clone();
+    let startup = move || async move {
+        // If the transport type is Tor then check if there is a stored TorID, if there is update the Transport Type
+        let mut comms_config = comms_config;
+        comms_config.transport_type = match comms_config.transport_type {
+            Tor(mut tor_config) => {
+                tor_config.identity = match startup_database.get_tor_id().await {
+                    Ok(Some(v)) => Some(Box::new(v)),
+                    _ => None,
+                };
+                Tor(tor_config)
+            },
+            _ => comms_config.transport_type,
+        };
 
-    w = runtime.block_on(Wallet::start(
-        wallet_config,
-        wallet_database,
-        transaction_backend.clone(),
-        output_manager_backend,
-        contacts_backend,
-        shutdown.to_signal(),
-        recovery_master_key,
-    ));
+        let wallet_config = WalletConfig::new(
+            comms_config,
+            CryptoFactories::default(),
+            Some(TransactionServiceConfig {
+                direct_send_timeout,
+                ..Default::default()
+            }),
+            None,
+            Network::Weatherwax.into(),
+            Some(BaseNodeServiceConfig {
+                chain_metadata_hub,
+                ..Default::default()
+            }),
+            None,
+            None,
+            None,
+        );
 
-    match w {
-        Ok(mut w) => {
-            // lets ensure the wallet tor_id is saved, this could have been changed during wallet startup
+        let w = Wallet::start(
+            wallet_config,
+            startup_database,
+            startup_transaction_backend.clone(),
+            startup_output_manager_backend,
+            startup_contacts_backend,
+            shutdown_signal,
+            recovery_master_key,
+        )
+        .await?;
+
+        // Start the Callback Handler before the transaction protocols are restarted. The event streams are broadcast
+        // channels, so the events of resumed protocols are only delivered to subscribers that already exist.
+        let mut callback_handler = CallbackHandler::new(
+            TransactionDatabase::new(startup_transaction_backend),
+            w.transaction_service.get_event_stream_fused(),
+            w.output_manager_service.get_event_stream_fused(),
+            w.dht_service.subscribe_dht_events().fuse(),
+            w.comms.shutdown_signal(),
+            w.comms.node_identity().public_key().clone(),
+            callback_received_transaction,
+            callback_received_transaction_reply,
+            callback_received_finalized_transaction,
+            callback_transaction_broadcast,
+            callback_transaction_mined,
+            callback_transaction_mined_unconfirmed,
+            callback_direct_send_result,
+            callback_store_and_forward_send_result,
+            callback_transaction_cancellation,
+            callback_utxo_validation_complete,
+            callback_stxo_validation_complete,
+            callback_invalid_txo_validation_complete,
+            callback_transaction_validation_complete,
+            callback_saf_messages_received,
+        );
+        if let Some(callback_events_batch) = callback_events_batch {
+            callback_handler = callback_handler.with_event_batching(EventBatchConfig {
+                callback_events_batch,
+                window: Duration::from_millis(events_batch_window_ms),
+                max_events: events_batch_max_events as usize,
+            });
+        }
+        tokio::spawn(callback_handler.start());
+
+        // lets ensure the wallet tor_id is saved, this could have been changed during wallet startup. This is
+        // independent of restarting the transaction protocols so the two are done concurrently.
+        let save_tor_identity = async {
             if let Some(hs) = w.comms.hidden_service() {
-                if let Err(e) = runtime.block_on(w.db.set_tor_identity(hs.tor_identity().clone())) {
+                if let Err(e) = w.db.set_tor_identity(hs.tor_identity().clone()).await {
                     warn!(target: LOG_TARGET, "Could not save tor identity to db: {}", e);
                 }
             }
-            // Start Callback Handler
-            let callback_handler = CallbackHandler::new(
-                TransactionDatabase::new(transaction_backend),
-                w.transaction_service.get_event_stream_fused(),
-                w.output_manager_service.get_event_stream_fused(),
-                w.dht_service.subscribe_dht_events().fuse(),
-                w.comms.shutdown_signal(),
-                w.comms.node_identity().public_key().clone(),
-                callback_received_transaction,
-                callback_received_transaction_reply,
-                callback_received_finalized_transaction,
-                callback_transaction_broadcast,
-                callback_transaction_mined,
-                callback_transaction_mined_unconfirmed,
-                callback_direct_send_result,
-                callback_store_and_forward_send_result,
-                callback_transaction_cancellation,
-                callback_utxo_validation_complete,
-                callback_stxo_validation_complete,
-                callback_invalid_txo_validation_complete,
-                callback_transaction_validation_complete,
-                callback_saf_messages_received,
-            );
-
-            runtime.spawn(callback_handler.start());
-
-            if let Err(e) = runtime.block_on(w.transaction_service.restart_transaction_protocols()) {
+        };
+        let mut transaction_service = w.transaction_service.clone();
+        let restart_protocols = async {
+            if let Err(e) = transaction_service.restart_transaction_protocols().await {
                 warn!(
                     target: LOG_TARGET,
                     "Could not restart transaction negotiation protocols: {:?}", e
                 );
             }
+        };
+        futures::join!(save_tor_identity, restart_protocols);
 
-            let tari_wallet = TariWallet {
-                wallet: w,
-                runtime,
-                shutdown,
-            };
+        Ok(w)
+    };
+    let on_complete = move |code| {
+        if let Some(callback_wallet_ready) = callback_wallet_ready {
+            callback_wallet_ready(code);
+        }
+    };
 
-            Box::into_raw(Box::new(tari_wallet))
-        },
+    let startup_handle = match spawn_startup(runtime.handle().clone(), startup, on_complete) {
+        Ok(r) => r,
         Err(e) => {
-            error = LibWalletError::from(e).code;
+            error = LibWalletError::from(InterfaceError::TokioError(e.to_string())).code;
             ptr::swap(error_out, &mut error as *mut c_int);
-            ptr::null_mut()
+            return ptr::null_mut();
         },
+    };
+    let mut staged_wallet = StagedWallet::new(
+        wallet_database,
+        transaction_backend,
+        output_manager_backend,
+        contacts_backend,
+        startup_handle,
+    );
+
+    // Without a ready callback the client expects a started wallet to be returned
+    if callback_wallet_ready.is_none() {
+        if let Err(e) = runtime.block_on(staged_wallet.wait_until_started()) {
+            error = e.code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            return ptr::null_mut();
+        }
     }
+
+    let tari_wallet = TariWallet {
+        wallet: staged_wallet,
+        runtime,
+        operations: AsyncOperations::new(shutdown.to_signal()),
+        shutdown,
+    };
+
+    Box::into_raw(Box::new(tari_wallet))
 }
 
 /// Signs a message using the public key of the TariWallet
@@ -3001,6 +3801,11 @@ pub unsafe extern "C" fn wallet_sign_message(
         ptr::swap(error_out, &mut error as *mut c_int);
         return result.into_raw();
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return result.into_raw();
+    }
 
     if msg.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
@@ -3060,6 +3865,11 @@ pub unsafe extern "C" fn wallet_verify_message_signature(
         ptr::swap(error_out, &mut error as *mut c_int);
         return result;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return result;
+    }
     if public_key.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("public key".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
@@ -3142,6 +3952,11 @@ pub unsafe extern "C" fn wallet_test_generate_data(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     let datastore_path_string;
     if !datastore_path.is_null() {
         datastore_path_string = CStr::from_ptr(datastore_path).to_str().unwrap().to_owned();
@@ -3187,6 +4002,11 @@ pub unsafe extern "C" fn wallet_test_receive_transaction(wallet: *mut TariWallet
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     let handle = (*wallet).runtime.handle();
     match (*wallet)
         .runtime
@@ -3229,6 +4049,11 @@ pub unsafe extern "C" fn wallet_test_complete_sent_transaction(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     if tx.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("tx".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
@@ -3274,6 +4099,11 @@ pub unsafe extern "C" fn wallet_test_finalize_received_transaction(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     match (*wallet)
         .runtime
@@ -3315,6 +4145,11 @@ pub unsafe extern "C" fn wallet_test_broadcast_transaction(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     match (*wallet)
         .runtime
@@ -3357,6 +4192,11 @@ pub unsafe extern "C" fn wallet_test_mine_transaction(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     match (*wallet)
         .runtime
         .block_on(mine_transaction(&mut (*wallet).wallet, tx_id))
@@ -3398,6 +4238,11 @@ pub unsafe extern "C" fn wallet_add_base_node_peer(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     if public_key.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("public_key".to_string())).code;
@@ -3453,6 +4298,11 @@ pub unsafe extern "C" fn wallet_upsert_contact(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     if contact.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("contact".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
@@ -3498,6 +4348,11 @@ pub unsafe extern "C" fn wallet_remove_contact(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
     if contact.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("contact".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
@@ -3541,10 +4396,7 @@ pub unsafe extern "C" fn wallet_get_available_balance(wallet: *mut TariWallet, e
         return 0;
     }
 
-    match (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.output_manager_service.get_balance())
-    {
+    match (*wallet).runtime.block_on((*wallet).wallet.get_balance()) {
         Ok(b) => c_ulonglong::from(b.available_balance),
         Err(e) => {
             error = LibWalletError::from(WalletError::OutputManagerError(e)).code;
@@ -3580,10 +4432,7 @@ pub unsafe extern "C" fn wallet_get_pending_incoming_balance(
         return 0;
     }
 
-    match (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.output_manager_service.get_balance())
-    {
+    match (*wallet).runtime.block_on((*wallet).wallet.get_balance()) {
         Ok(b) => c_ulonglong::from(b.pending_incoming_balance),
         Err(e) => {
             error = LibWalletError::from(WalletError::OutputManagerError(e)).code;
@@ -3619,10 +4468,7 @@ pub unsafe extern "C" fn wallet_get_pending_outgoing_balance(
         return 0;
     }
 
-    match (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.output_manager_service.get_balance())
-    {
+    match (*wallet).runtime.block_on((*wallet).wallet.get_balance()) {
         Ok(b) => c_ulonglong::from(b.pending_outgoing_balance),
         Err(e) => {
             error = LibWalletError::from(WalletError::OutputManagerError(e)).code;
@@ -3632,66 +4478,369 @@ pub unsafe extern "C" fn wallet_get_pending_outgoing_balance(
     }
 }
 
-/// Sends a TariPendingOutboundTransaction
+/// Gets all the balance figures of a TariWallet in a single call
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `balance_out` - Pointer to a TariBalance which will be filled in with the balance, may not be null. Functions as
+/// an out parameter.
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `bool` - Returns true if the balance was written to `balance_out`, false otherwise
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_get_balance(
+    wallet: *mut TariWallet,
+    balance_out: *mut TariBalance,
+    error_out: *mut c_int,
+) -> bool {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
+    if balance_out.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("balance_out".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
+
+    match (*wallet).runtime.block_on((*wallet).wallet.get_balance()) {
+        Ok(b) => {
+            *balance_out = TariBalance {
+                available_balance: b.available_balance.into(),
+                time_locked_balance: b.time_locked_balance.map(u64::from).unwrap_or(0),
+                pending_incoming_balance: b.pending_incoming_balance.into(),
+                pending_outgoing_balance: b.pending_outgoing_balance.into(),
+            };
+            true
+        },
+        Err(e) => {
+            error = LibWalletError::from(WalletError::OutputManagerError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            false
+        },
+    }
+}
+
+/// Sends a TariPendingOutboundTransaction
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `dest_public_key` - The TariPublicKey pointer of the peer
+/// `amount` - The amount
+/// `fee_per_gram` - The transaction fee
+/// `message` - The pointer to a char array
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `unsigned long long` - Returns 0 if unsuccessful or the TxId of the sent transaction if successful
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_send_transaction(
+    wallet: *mut TariWallet,
+    dest_public_key: *mut TariPublicKey,
+    amount: c_ulonglong,
+    fee_per_gram: c_ulonglong,
+    message: *const c_char,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    if dest_public_key.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("dest_public_key".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let message_string = if !message.is_null() {
+        CStr::from_ptr(message).to_str().unwrap().to_owned()
+    } else {
+        error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        CString::new("").unwrap().to_str().unwrap().to_owned()
+    };
+
+    match (*wallet)
+        .runtime
+        .block_on((*wallet).wallet.transaction_service.send_transaction(
+            (*dest_public_key).clone(),
+            MicroTari::from(amount),
+            MicroTari::from(fee_per_gram),
+            message_string,
+        )) {
+        Ok(tx_id) => tx_id,
+        Err(e) => {
+            error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            0
+        },
+    }
+}
+
+/// Starts sending a TariPendingOutboundTransaction without waiting for the transaction service, see
+/// `wallet_send_transaction`. The outcome is reported to the operation completion callback or queued for
+/// `wallet_drain_operation_completions`, with the TxId of the sent transaction.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `dest_public_key` - The TariPublicKey pointer of the peer
+/// `amount` - The amount
+/// `fee_per_gram` - The transaction fee
+/// `message` - The pointer to a char array
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `unsigned long long` - Returns 0 if the send could not be started or the request id of the operation if it was
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_send_transaction_async(
+    wallet: *mut TariWallet,
+    dest_public_key: *mut TariPublicKey,
+    amount: c_ulonglong,
+    fee_per_gram: c_ulonglong,
+    message: *const c_char,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    if dest_public_key.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("dest_public_key".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let message_string = if !message.is_null() {
+        CStr::from_ptr(message).to_str().unwrap().to_owned()
+    } else {
+        error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        CString::new("").unwrap().to_str().unwrap().to_owned()
+    };
+
+    let started = (*wallet).wallet.started();
+    let dest_public_key = (*dest_public_key).clone();
+    (*wallet).operations.spawn(&(*wallet).runtime, async move {
+        let mut w = started.await?;
+        w.transaction_service
+            .send_transaction(
+                dest_public_key,
+                MicroTari::from(amount),
+                MicroTari::from(fee_per_gram),
+                message_string,
+            )
+            .await
+            .map_err(|e| LibWalletError::from(WalletError::TransactionServiceError(e)))
+    })
+}
+
+/// Sets the callback that the outcomes of the `_async` wallet operations are delivered to. The callback is called on a
+/// wallet runtime thread with the request id, the TariOperationCompletion TxId and the error code, which is 0 on
+/// success. Passing a null callback queues the outcomes for `wallet_drain_operation_completions` again.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `callback_operation_completed` - The callback function pointer, may be null
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `bool` - Returns true if the callback was set
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_set_operation_completion_callback(
+    wallet: *mut TariWallet,
+    callback_operation_completed: Option<OperationCompletionCallback>,
+    error_out: *mut c_int,
+) -> bool {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
+
+    (*wallet).operations.set_callback(callback_operation_completed);
+    true
+}
+
+/// Moves the outcomes of completed `_async` wallet operations, oldest first, into a caller supplied array. Outcomes are
+/// only queued while no operation completion callback is set.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `completions` - The pointer to the first element of an array of TariOperationCompletion
+/// `completions_len` - The number of elements in `completions`
+/// `timeout_ms` - How long to wait for an operation to complete if none are queued, 0 to return immediately
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_uint` - Returns the number of completions written to `completions`
+///
+/// # Safety
+/// `completions` must point to at least `completions_len` elements
+#[no_mangle]
+pub unsafe extern "C" fn wallet_drain_operation_completions(
+    wallet: *mut TariWallet,
+    completions: *mut TariOperationCompletion,
+    completions_len: c_uint,
+    timeout_ms: c_uint,
+    error_out: *mut c_int,
+) -> c_uint {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if completions.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("completions".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let completions = slice::from_raw_parts_mut(completions, completions_len as usize);
+    (*wallet)
+        .operations
+        .drain(completions, Duration::from_millis(u64::from(timeout_ms))) as c_uint
+}
+
+/// Sends a separate TariPendingOutboundTransaction to each of several recipients. Each recipient's transaction selects
+/// its own outputs to spend and pays its own fee, so no fee is saved over sending them one at a time. All of the
+/// transactions are prepared before any is sent, so if one cannot be prepared nothing is sent. The transactions are
+/// then negotiated with the recipients concurrently.
 ///
 /// ## Arguments
 /// `wallet` - The TariWallet pointer
-/// `dest_public_key` - The TariPublicKey pointer of the peer
-/// `amount` - The amount
+/// `dest_public_keys` - The pointer to the first element of an array of TariPublicKey pointers of the peers
+/// `amounts` - The pointer to the first element of an array of the amounts
+/// `messages` - The pointer to the first element of an array of pointers to char arrays
+/// `num_recipients` - The number of elements in each of the `dest_public_keys`, `amounts` and `messages` arrays
 /// `fee_per_gram` - The transaction fee
-/// `message` - The pointer to a char array
+/// `tx_ids_out` - The pointer to the first element of an array of `num_recipients` unsigned long longs which will be
+/// set to the TxId of each recipient's transaction. Functions as an out parameter.
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
 ///
 /// ## Returns
-/// `unsigned long long` - Returns 0 if unsuccessful or the TxId of the sent transaction if successful
+/// `bool` - Returns true if a transaction was sent to every recipient, false if none were sent
 ///
 /// # Safety
-/// None
+/// Each of the arrays must point to at least `num_recipients` elements
 #[no_mangle]
-pub unsafe extern "C" fn wallet_send_transaction(
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn wallet_send_transactions(
     wallet: *mut TariWallet,
-    dest_public_key: *mut TariPublicKey,
-    amount: c_ulonglong,
+    dest_public_keys: *const *mut TariPublicKey,
+    amounts: *const c_ulonglong,
+    messages: *const *const c_char,
+    num_recipients: c_uint,
     fee_per_gram: c_ulonglong,
-    message: *const c_char,
+    tx_ids_out: *mut c_ulonglong,
     error_out: *mut c_int,
-) -> c_ulonglong {
+) -> bool {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
     if wallet.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return 0;
+        return false;
     }
-
-    if dest_public_key.is_null() {
-        error = LibWalletError::from(InterfaceError::NullError("dest_public_key".to_string())).code;
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return 0;
+        return false;
     }
-
-    let message_string = if !message.is_null() {
-        CStr::from_ptr(message).to_str().unwrap().to_owned()
-    } else {
-        error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
+    if dest_public_keys.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("dest_public_keys".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        CString::new("").unwrap().to_str().unwrap().to_owned()
-    };
+        return false;
+    }
+    if amounts.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("amounts".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
+    if messages.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("messages".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
+    if tx_ids_out.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("tx_ids_out".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
-    match (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.transaction_service.send_transaction(
-            (*dest_public_key).clone(),
-            MicroTari::from(amount),
-            MicroTari::from(fee_per_gram),
-            message_string,
-        )) {
-        Ok(tx_id) => tx_id,
+    let dest_public_keys = slice::from_raw_parts(dest_public_keys, num_recipients as usize);
+    let amounts = slice::from_raw_parts(amounts, num_recipients as usize);
+    let messages = slice::from_raw_parts(messages, num_recipients as usize);
+    let mut recipients = Vec::with_capacity(num_recipients as usize);
+    for ((dest_public_key, amount), message) in dest_public_keys.iter().zip(amounts).zip(messages) {
+        if dest_public_key.is_null() {
+            error = LibWalletError::from(InterfaceError::NullError("dest_public_key".to_string())).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            return false;
+        }
+        let message_string = if !message.is_null() {
+            CStr::from_ptr(*message).to_str().unwrap().to_owned()
+        } else {
+            error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            CString::new("").unwrap().to_str().unwrap().to_owned()
+        };
+        recipients.push(((**dest_public_key).clone(), MicroTari::from(*amount), message_string));
+    }
+
+    match (*wallet).runtime.block_on(
+        (*wallet)
+            .wallet
+            .transaction_service
+            .send_transactions(recipients, MicroTari::from(fee_per_gram)),
+    ) {
+        Ok(tx_ids) => {
+            let tx_ids_out = slice::from_raw_parts_mut(tx_ids_out, num_recipients as usize);
+            tx_ids_out.copy_from_slice(&tx_ids);
+            true
+        },
         Err(e) => {
             error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
             ptr::swap(error_out, &mut error as *mut c_int);
-            0
+            false
         },
     }
 }
@@ -3728,6 +4877,11 @@ pub unsafe extern "C" fn wallet_get_fee_estimate(
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     match (*wallet)
         .runtime
@@ -3770,6 +4924,11 @@ pub unsafe extern "C" fn wallet_get_num_confirmations_required(
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     match (*wallet)
         .runtime
@@ -3809,6 +4968,11 @@ pub unsafe extern "C" fn wallet_set_num_confirmations_required(
         error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int)
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
 
     match (*wallet)
         .runtime
@@ -3846,9 +5010,7 @@ pub unsafe extern "C" fn wallet_get_contacts(wallet: *mut TariWallet, error_out:
         return ptr::null_mut();
     }
 
-    let retrieved_contacts = (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.contacts_service.get_contacts());
+    let retrieved_contacts = (*wallet).runtime.block_on((*wallet).wallet.get_contacts());
     match retrieved_contacts {
         Ok(mut retrieved_contacts) => {
             contacts.append(&mut retrieved_contacts);
@@ -3890,22 +5052,24 @@ pub unsafe extern "C" fn wallet_get_completed_transactions(
         return ptr::null_mut();
     }
 
+    // The frontend specification calls for completed transactions that have not yet been mined to be
+    // classified as Pending Transactions. In order to support this logic without impacting the practical
+    // definitions and storage of a MimbleWimble CompletedTransaction we will exclude CompletedTransactions with
+    // the Completed and Broadcast states from the list returned by this FFI function. The filter is applied by the
+    // database query so the excluded transactions are never loaded.
+    let query = CompletedTransactionQuery {
+        statuses: (0..32i32)
+            .filter_map(|s| TransactionStatus::try_from(s).ok())
+            .filter(|s| !matches!(s, TransactionStatus::Completed | TransactionStatus::Broadcast))
+            .collect(),
+        ..Default::default()
+    };
     let completed_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_completed_transactions());
+        .block_on((*wallet).wallet.get_completed_transactions_page(query));
     match completed_transactions {
-        Ok(completed_transactions) => {
-            // The frontend specification calls for completed transactions that have not yet been mined to be
-            // classified as Pending Transactions. In order to support this logic without impacting the practical
-            // definitions and storage of a MimbleWimble CompletedTransaction we will remove CompletedTransactions with
-            // the Completed and Broadcast states from the list returned by this FFI function
-            for tx in completed_transactions
-                .values()
-                .filter(|ct| ct.status != TransactionStatus::Completed)
-                .filter(|ct| ct.status != TransactionStatus::Broadcast)
-            {
-                completed.push(tx.clone());
-            }
+        Ok(mut completed_transactions) => {
+            completed.append(&mut completed_transactions);
             Box::into_raw(Box::new(TariCompletedTransactions(completed)))
         },
         Err(e) => {
@@ -3916,6 +5080,163 @@ pub unsafe extern "C" fn wallet_get_completed_transactions(
     }
 }
 
+/// Get a filtered page of TariCompletedTransactions from a TariWallet. The filtering, ordering and paging is performed
+/// by the wallet database so only the requested page is loaded and decrypted. Transactions are ordered newest first.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `status_mask` - A bitmask of the transaction statuses to include, where bit `n` selects the status with value `n` as
+/// returned by `completed_transaction_get_status`. A mask of 0 includes all statuses
+/// `direction` - The direction of the transactions to include: -1 for any, 0 for Inbound, 1 for Outbound and 2 for
+/// Unknown
+/// `from_timestamp` - Only include transactions with a timestamp (in seconds since the Unix epoch) at or after this
+/// value, 0 for no lower bound
+/// `to_timestamp` - Only include transactions with a timestamp (in seconds since the Unix epoch) before this value, 0
+/// for no upper bound
+/// `limit` - The maximum number of transactions to return, 0 for no limit
+/// `cursor_tx_id` - The TxId of the last transaction of the previous page, 0 to start from the newest transaction
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariCompletedTransactions` - returns the transactions, note that it returns ptr::null_mut() if
+/// wallet is null or an error is encountered
+///
+/// # Safety
+/// The ```completed_transactions_destroy``` method must be called when finished with a TariCompletedTransactions to
+/// prevent a memory leak
+#[no_mangle]
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn wallet_get_completed_transactions_page(
+    wallet: *mut TariWallet,
+    status_mask: c_uint,
+    direction: c_int,
+    from_timestamp: c_longlong,
+    to_timestamp: c_longlong,
+    limit: c_uint,
+    cursor_tx_id: c_ulonglong,
+    error_out: *mut c_int,
+) -> *mut TariCompletedTransactions {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    let statuses = (0..32i32)
+        .filter(|s| status_mask & (1 << s) != 0)
+        .filter_map(|s| TransactionStatus::try_from(s).ok())
+        .collect::<Vec<_>>();
+    let direction = if direction < 0 {
+        None
+    } else {
+        match TransactionDirection::try_from(direction) {
+            Ok(d) => Some(d),
+            Err(e) => {
+                error = LibWalletError::from(WalletError::TransactionServiceError(
+                    TransactionServiceError::TransactionStorageError(e),
+                ))
+                .code;
+                ptr::swap(error_out, &mut error as *mut c_int);
+                return ptr::null_mut();
+            },
+        }
+    };
+
+    // A timestamp of 0 is no bound. An out of range timestamp is reported as an error rather than panicking.
+    let to_datetime = |timestamp: c_longlong| {
+        if timestamp > 0 {
+            NaiveDateTime::from_timestamp_opt(timestamp, 0)
+                .map(Some)
+                .ok_or_else(|| InterfaceError::InvalidTimestamp(timestamp.to_string()))
+        } else {
+            Ok(None)
+        }
+    };
+    let (from_timestamp, to_timestamp) = match (to_datetime(from_timestamp), to_datetime(to_timestamp)) {
+        (Ok(from), Ok(to)) => (from, to),
+        (Err(e), _) | (_, Err(e)) => {
+            error = LibWalletError::from(e).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            return ptr::null_mut();
+        },
+    };
+
+    let query = CompletedTransactionQuery {
+        statuses,
+        direction,
+        from_timestamp,
+        to_timestamp,
+        cancelled: false,
+        cursor: if cursor_tx_id > 0 { Some(cursor_tx_id) } else { None },
+        limit: if limit > 0 { Some(u64::from(limit)) } else { None },
+    };
+
+    match (*wallet)
+        .runtime
+        .block_on((*wallet).wallet.get_completed_transactions_page(query))
+    {
+        Ok(completed_transactions) => Box::into_raw(Box::new(TariCompletedTransactions(completed_transactions))),
+        Err(e) => {
+            error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            ptr::null_mut()
+        },
+    }
+}
+
+/// Get the transactions that were inserted, updated or cancelled after the given change sequence number. Clients can
+/// keep a local view of the wallet's transactions up to date by applying these changes instead of re-reading all of
+/// the pending and completed transactions after every callback.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `sequence` - The change sequence number returned by `transaction_changes_get_sequence` for the previous set of
+/// changes, 0 to get all transactions
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*mut TariTransactionChanges` - returns the changes, note that it returns ptr::null_mut() if wallet is null or an
+/// error is encountered
+///
+/// # Safety
+/// The ```transaction_changes_destroy``` method must be called when finished with a TariTransactionChanges to prevent
+/// a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn wallet_get_transaction_changes_since(
+    wallet: *mut TariWallet,
+    sequence: c_ulonglong,
+    error_out: *mut c_int,
+) -> *mut TariTransactionChanges {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+
+    match (*wallet)
+        .runtime
+        .block_on((*wallet).wallet.transaction_service.get_transaction_changes_since(sequence))
+    {
+        Ok(changes) => Box::into_raw(Box::new(changes)),
+        Err(e) => {
+            error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            ptr::null_mut()
+        },
+    }
+}
+
 /// Get the TariPendingInboundTransactions from a TariWallet
 ///
 /// Currently a CompletedTransaction with the Status of Completed and Broadcast is considered Pending by the frontend
@@ -3948,7 +5269,7 @@ pub unsafe extern "C" fn wallet_get_pending_inbound_transactions(
 
     let pending_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_pending_inbound_transactions());
+        .block_on((*wallet).wallet.get_pending_inbound_transactions());
 
     match pending_transactions {
         Ok(pending_transactions) => {
@@ -3958,7 +5279,7 @@ pub unsafe extern "C" fn wallet_get_pending_inbound_transactions(
 
             if let Ok(completed_txs) = (*wallet)
                 .runtime
-                .block_on((*wallet).wallet.transaction_service.get_completed_transactions())
+                .block_on((*wallet).wallet.get_completed_transactions())
             {
                 // The frontend specification calls for completed transactions that have not yet been mined to be
                 // classified as Pending Transactions. In order to support this logic without impacting the practical
@@ -4015,7 +5336,7 @@ pub unsafe extern "C" fn wallet_get_pending_outbound_transactions(
 
     let pending_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_pending_outbound_transactions());
+        .block_on((*wallet).wallet.get_pending_outbound_transactions());
     match pending_transactions {
         Ok(pending_transactions) => {
             for tx in pending_transactions.values() {
@@ -4023,7 +5344,7 @@ pub unsafe extern "C" fn wallet_get_pending_outbound_transactions(
             }
             if let Ok(completed_txs) = (*wallet)
                 .runtime
-                .block_on((*wallet).wallet.transaction_service.get_completed_transactions())
+                .block_on((*wallet).wallet.get_completed_transactions())
             {
                 // The frontend specification calls for completed transactions that have not yet been mined to be
                 // classified as Pending Transactions. In order to support this logic without impacting the practical
@@ -4075,6 +5396,11 @@ pub unsafe extern "C" fn wallet_get_cancelled_transactions(
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
 
     let completed_transactions = match (*wallet).runtime.block_on(
         (*wallet)
@@ -4165,7 +5491,7 @@ pub unsafe extern "C" fn wallet_get_completed_transaction_by_id(
 
     let completed_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_completed_transactions());
+        .block_on((*wallet).wallet.get_completed_transactions());
 
     match completed_transactions {
         Ok(completed_transactions) => {
@@ -4218,11 +5544,11 @@ pub unsafe extern "C" fn wallet_get_pending_inbound_transaction_by_id(
 
     let pending_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_pending_inbound_transactions());
+        .block_on((*wallet).wallet.get_pending_inbound_transactions());
 
     let completed_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_completed_transactions());
+        .block_on((*wallet).wallet.get_completed_transactions());
 
     match completed_transactions {
         Ok(completed_transactions) => {
@@ -4291,11 +5617,11 @@ pub unsafe extern "C" fn wallet_get_pending_outbound_transaction_by_id(
 
     let pending_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_pending_outbound_transactions());
+        .block_on((*wallet).wallet.get_pending_outbound_transactions());
 
     let completed_transactions = (*wallet)
         .runtime
-        .block_on((*wallet).wallet.transaction_service.get_completed_transactions());
+        .block_on((*wallet).wallet.get_completed_transactions());
 
     match completed_transactions {
         Ok(completed_transactions) => {
@@ -4362,6 +5688,11 @@ pub unsafe extern "C" fn wallet_get_cancelled_transaction_by_id(
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
 
     let mut transaction = None;
 
@@ -4460,12 +5791,104 @@ pub unsafe extern "C" fn wallet_get_public_key(wallet: *mut TariWallet, error_ou
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
-    let pk = (*wallet).wallet.comms.node_identity().public_key().clone();
-    Box::into_raw(Box::new(pk))
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
+    let pk = (*wallet).wallet.comms.node_identity().public_key().clone();
+    Box::into_raw(Box::new(pk))
+}
+
+/// Import a UTXO into the wallet. This will add a spendable UTXO and create a faux completed transaction to record the
+/// event.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `amount` - The value of the UTXO in MicroTari
+/// `spending_key` - The private spending key
+/// `source_public_key` - The public key of the source of the transaction
+/// `message` - The message that the transaction will have
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` -  Returns the TransactionID of the generated transaction, note that it will be zero if transaction is
+/// null
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_import_utxo(
+    wallet: *mut TariWallet,
+    amount: c_ulonglong,
+    spending_key: *mut TariPrivateKey,
+    source_public_key: *mut TariPublicKey,
+    message: *const c_char,
+    error_out: *mut c_int,
+    /* TODO: Update this interface to add the metadata signature, script private key and script offset public keys
+     * here. */
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    if spending_key.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("spending_key".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    if source_public_key.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("source_public_key".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let message_string = if !message.is_null() {
+        CStr::from_ptr(message).to_str().unwrap().to_owned()
+    } else {
+        error = LibWalletError::from(InterfaceError::NullError("message".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        CString::new("Imported UTXO").unwrap().to_str().unwrap().to_owned()
+    };
+
+    match (*wallet).runtime.block_on((*wallet).wallet.import_utxo(
+        MicroTari::from(amount),
+        &(*spending_key).clone(),
+        TariScript::default(),
+        ExecutionStack::default(),
+        &(*source_public_key).clone(),
+        OutputFeatures::default(),
+        message_string,
+        // TODO: Add the actual metadata signature here.
+        ComSignature::default(),
+        // TODO:Add the actual script private key here.
+        &Default::default(),
+        // TODO:Add the actual script offset public keys here.
+        &Default::default(),
+    )) {
+        Ok(tx_id) => tx_id,
+        Err(e) => {
+            error = LibWalletError::from(e).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            0
+        },
+    }
 }
 
-/// Import a UTXO into the wallet. This will add a spendable UTXO and create a faux completed transaction to record the
-/// event.
+/// Starts importing a UTXO into the wallet without waiting for the wallet services, see `wallet_import_utxo`. The
+/// outcome is reported to the operation completion callback or queued for `wallet_drain_operation_completions`, with
+/// the TxId of the generated transaction.
 ///
 /// ## Arguments
 /// `wallet` - The TariWallet pointer
@@ -4477,21 +5900,18 @@ pub unsafe extern "C" fn wallet_get_public_key(wallet: *mut TariWallet, error_ou
 /// as an out parameter.
 ///
 /// ## Returns
-/// `c_ulonglong` -  Returns the TransactionID of the generated transaction, note that it will be zero if transaction is
-/// null
+/// `c_ulonglong` - Returns 0 if the import could not be started or the request id of the operation if it was
 ///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn wallet_import_utxo(
+pub unsafe extern "C" fn wallet_import_utxo_async(
     wallet: *mut TariWallet,
     amount: c_ulonglong,
     spending_key: *mut TariPrivateKey,
     source_public_key: *mut TariPublicKey,
     message: *const c_char,
     error_out: *mut c_int,
-    /* TODO: Update this interface to add the metadata signature, script private key and script offset public keys
-     * here. */
 ) -> c_ulonglong {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
@@ -4521,28 +5941,29 @@ pub unsafe extern "C" fn wallet_import_utxo(
         CString::new("Imported UTXO").unwrap().to_str().unwrap().to_owned()
     };
 
-    match (*wallet).runtime.block_on((*wallet).wallet.import_utxo(
-        MicroTari::from(amount),
-        &(*spending_key).clone(),
-        TariScript::default(),
-        ExecutionStack::default(),
-        &(*source_public_key).clone(),
-        OutputFeatures::default(),
-        message_string,
-        // TODO: Add the actual metadata signature here.
-        ComSignature::default(),
-        // TODO:Add the actual script private key here.
-        &Default::default(),
-        // TODO:Add the actual script offset public keys here.
-        &Default::default(),
-    )) {
-        Ok(tx_id) => tx_id,
-        Err(e) => {
-            error = LibWalletError::from(e).code;
-            ptr::swap(error_out, &mut error as *mut c_int);
-            0
-        },
-    }
+    let started = (*wallet).wallet.started();
+    let spending_key = (*spending_key).clone();
+    let source_public_key = (*source_public_key).clone();
+    (*wallet).operations.spawn(&(*wallet).runtime, async move {
+        let mut w = started.await?;
+        w.import_utxo(
+            MicroTari::from(amount),
+            &spending_key,
+            TariScript::default(),
+            ExecutionStack::default(),
+            &source_public_key,
+            OutputFeatures::default(),
+            message_string,
+            // TODO: Add the actual metadata signature here.
+            ComSignature::default(),
+            // TODO:Add the actual script private key here.
+            &Default::default(),
+            // TODO:Add the actual script offset public keys here.
+            &Default::default(),
+        )
+        .await
+        .map_err(LibWalletError::from)
+    })
 }
 
 /// Cancel a Pending Transaction
@@ -4571,6 +5992,11 @@ pub unsafe extern "C" fn wallet_cancel_pending_transaction(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     match (*wallet)
         .runtime
@@ -4585,6 +6011,46 @@ pub unsafe extern "C" fn wallet_cancel_pending_transaction(
     }
 }
 
+/// Starts cancelling a Pending Transaction without waiting for the transaction service, see
+/// `wallet_cancel_pending_transaction`. The outcome is reported to the operation completion callback or queued for
+/// `wallet_drain_operation_completions`, with the TxId of the cancelled transaction.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `transaction_id` - The TransactionId
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` - Returns 0 if the cancellation could not be started or the request id of the operation if it was
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_cancel_pending_transaction_async(
+    wallet: *mut TariWallet,
+    transaction_id: c_ulonglong,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let started = (*wallet).wallet.started();
+    (*wallet).operations.spawn(&(*wallet).runtime, async move {
+        let mut w = started.await?;
+        w.transaction_service
+            .cancel_transaction(transaction_id)
+            .await
+            .map(|_| transaction_id)
+            .map_err(|e| LibWalletError::from(WalletError::TransactionServiceError(e)))
+    })
+}
+
 /// This function will tell the wallet to query the set base node to confirm the status of unspent transaction outputs
 /// (UTXOs).
 ///
@@ -4608,6 +6074,11 @@ pub unsafe extern "C" fn wallet_start_utxo_validation(wallet: *mut TariWallet, e
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     if let Err(e) = (*wallet).runtime.block_on(
         (*wallet)
@@ -4658,6 +6129,11 @@ pub unsafe extern "C" fn wallet_start_stxo_validation(wallet: *mut TariWallet, e
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     if let Err(e) = (*wallet).runtime.block_on(
         (*wallet)
@@ -4710,6 +6186,11 @@ pub unsafe extern "C" fn wallet_start_invalid_txo_validation(
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     if let Err(e) = (*wallet).runtime.block_on(
         (*wallet)
@@ -4737,6 +6218,62 @@ pub unsafe extern "C" fn wallet_start_invalid_txo_validation(
     }
 }
 
+/// This function will tell the wallet to query the set base node to confirm the status of all of its transaction
+/// outputs, the unspent, spent and invalid outputs, in a single validation. The result is reported once through the
+/// UTXO validation complete callback.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` -  Returns a unique Request Key that is used to identify which callbacks refer to this specific sync
+/// request. Note the result will be 0 if there was an error
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_start_txo_validation(wallet: *mut TariWallet, error_out: *mut c_int) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    if let Err(e) = (*wallet).runtime.block_on(
+        (*wallet)
+            .wallet
+            .store_and_forward_requester
+            .request_saf_messages_from_neighbours(),
+    ) {
+        error = LibWalletError::from(e).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    match (*wallet).runtime.block_on(
+        (*wallet)
+            .wallet
+            .output_manager_service
+            .validate_txos(TxoValidationType::All, ValidationRetryStrategy::Limited(0)),
+    ) {
+        Ok(request_key) => request_key,
+        Err(e) => {
+            error = LibWalletError::from(WalletError::OutputManagerError(e)).code;
+            ptr::swap(error_out, &mut error as *mut c_int);
+            0
+        },
+    }
+}
+
 /// This function will tell the wallet to query the set base node to confirm the status of mined transactions.
 ///
 /// ## Arguments
@@ -4762,6 +6299,11 @@ pub unsafe extern "C" fn wallet_start_transaction_validation(
         ptr::swap(error_out, &mut error as *mut c_int);
         return 0;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     if let Err(e) = (*wallet).runtime.block_on(
         (*wallet)
@@ -4811,6 +6353,11 @@ pub unsafe extern "C" fn wallet_restart_transaction_broadcast(wallet: *mut TariW
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     if let Err(e) = (*wallet).runtime.block_on(
         (*wallet)
@@ -4869,6 +6416,11 @@ pub unsafe extern "C" fn wallet_coin_split(
         error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
 
     let message = if !msg.is_null() {
         CStr::from_ptr(msg).to_str().unwrap().to_owned()
@@ -4892,6 +6444,64 @@ pub unsafe extern "C" fn wallet_coin_split(
     }
 }
 
+/// Starts a coin split without waiting for the wallet services, see `wallet_coin_split`. The outcome is reported to
+/// the operation completion callback or queued for `wallet_drain_operation_completions`, with the TxId of the coin
+/// split transaction.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `amount` - The amount to split
+/// `count` - The number of times to split the amount
+/// `fee` - The transaction fee
+/// `msg` - Message for split
+/// `lock_height` - The number of bocks to lock the transaction for
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `c_ulonglong` - Returns 0 if the coin split could not be started or the request id of the operation if it was
+///
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_coin_split_async(
+    wallet: *mut TariWallet,
+    amount: c_ulonglong,
+    count: c_ulonglong,
+    fee: c_ulonglong,
+    msg: *const c_char,
+    lock_height: c_ulonglong,
+    error_out: *mut c_int,
+) -> c_ulonglong {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return 0;
+    }
+
+    let message = if !msg.is_null() {
+        CStr::from_ptr(msg).to_str().unwrap().to_owned()
+    } else {
+        "Coin Split".to_string()
+    };
+
+    let started = (*wallet).wallet.started();
+    (*wallet).operations.spawn(&(*wallet).runtime, async move {
+        let mut w = started.await?;
+        w.coin_split(
+            MicroTari(amount),
+            count as usize,
+            MicroTari(fee),
+            message,
+            Some(lock_height),
+        )
+        .await
+        .map_err(LibWalletError::from)
+    })
+}
+
 /// Gets the seed words representing the seed private key of the provided `TariWallet`.
 ///
 /// ## Arguments
@@ -4914,6 +6524,11 @@ pub unsafe extern "C" fn wallet_get_seed_words(wallet: *mut TariWallet, error_ou
         ptr::swap(error_out, &mut error as *mut c_int);
         return ptr::null_mut();
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return ptr::null_mut();
+    }
 
     match (*wallet)
         .runtime
@@ -4946,6 +6561,11 @@ pub unsafe extern "C" fn wallet_set_low_power_mode(wallet: *mut TariWallet, erro
         ptr::swap(error_out, &mut error as *mut c_int);
         return;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
 
     if let Err(e) = (*wallet)
         .runtime
@@ -4956,7 +6576,87 @@ pub unsafe extern "C" fn wallet_set_low_power_mode(wallet: *mut TariWallet, erro
     }
 }
 
-/// Set the power mode of the wallet to Normal Power mode which will then use the standard level of network traffic
+/// Set the power mode of the wallet to Normal Power mode which will then use the standard level of network traffic
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_set_normal_power_mode(wallet: *mut TariWallet, error_out: *mut c_int) {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
+
+    if let Err(e) = (*wallet)
+        .runtime
+        .block_on((*wallet).wallet.transaction_service.set_normal_power_mode())
+    {
+        error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+    }
+}
+
+/// Apply encryption to the databases used in this wallet using the provided passphrase. If the databases are already
+/// encrypted this function will fail.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `passphrase` - A string that represents the passphrase will be used to encrypt the databases for this
+/// wallet. Once encrypted the passphrase will be required to start a wallet using these databases
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+/// # Safety
+/// None
+#[no_mangle]
+pub unsafe extern "C" fn wallet_apply_encryption(
+    wallet: *mut TariWallet,
+    passphrase: *const c_char,
+    error_out: *mut c_int,
+) {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
+
+    if passphrase.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("passphrase".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
+
+    let pf = CStr::from_ptr(passphrase)
+        .to_str()
+        .expect("A non-null passphrase should be able to be converted to string")
+        .to_owned();
+
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.apply_encryption(pf)) {
+        error = LibWalletError::from(e).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+    }
+}
+
+/// Remove encryption to the databases used in this wallet. If this wallet is currently encrypted this encryption will
+/// be removed. If it is not encrypted then this function will still succeed to make the operation idempotent
 ///
 /// ## Arguments
 /// `wallet` - The TariWallet pointer
@@ -4965,7 +6665,7 @@ pub unsafe extern "C" fn wallet_set_low_power_mode(wallet: *mut TariWallet, erro
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn wallet_set_normal_power_mode(wallet: *mut TariWallet, error_out: *mut c_int) {
+pub unsafe extern "C" fn wallet_remove_encryption(wallet: *mut TariWallet, error_out: *mut c_int) {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
     if wallet.is_null() {
@@ -4973,45 +6673,63 @@ pub unsafe extern "C" fn wallet_set_normal_power_mode(wallet: *mut TariWallet, e
         ptr::swap(error_out, &mut error as *mut c_int);
         return;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return;
+    }
 
-    if let Err(e) = (*wallet)
-        .runtime
-        .block_on((*wallet).wallet.transaction_service.set_normal_power_mode())
-    {
-        error = LibWalletError::from(WalletError::TransactionServiceError(e)).code;
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.remove_encryption()) {
+        error = LibWalletError::from(e).code;
         ptr::swap(error_out, &mut error as *mut c_int);
     }
 }
 
-/// Apply encryption to the databases used in this wallet using the provided passphrase. If the databases are already
-/// encrypted this function will fail.
+/// Apply encryption to the databases used in this wallet using the provided passphrase in the background. The rows are
+/// encrypted in batches and, if the process is interrupted, the wallet has to be started with the passphrase and
+/// starting it completes the encryption.
 ///
 /// ## Arguments
 /// `wallet` - The TariWallet pointer
 /// `passphrase` - A string that represents the passphrase will be used to encrypt the databases for this
 /// wallet. Once encrypted the passphrase will be required to start a wallet using these databases
+/// `callback_progress` - The callback function pointer that will be called with the number of rows processed so far
+/// and the total number of rows after every batch
+/// `callback_completed` - The callback function pointer that will be called once with 0 when the process completed
+/// successfully or with the error code of the failure
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
+///
+/// ## Returns
+/// `bool` - Return a boolean value indicating whether the process started successfully or not
+///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn wallet_apply_encryption(
+pub unsafe extern "C" fn wallet_apply_encryption_with_progress(
     wallet: *mut TariWallet,
     passphrase: *const c_char,
+    callback_progress: unsafe extern "C" fn(c_ulonglong, c_ulonglong),
+    callback_completed: unsafe extern "C" fn(c_int),
     error_out: *mut c_int,
-) {
+) -> bool {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
     if wallet.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return;
+        return false;
+    }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
     }
 
     if passphrase.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("passphrase".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return;
+        return false;
     }
 
     let pf = CStr::from_ptr(passphrase)
@@ -5019,35 +6737,62 @@ pub unsafe extern "C" fn wallet_apply_encryption(
         .expect("A non-null passphrase should be able to be converted to string")
         .to_owned();
 
-    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.apply_encryption(pf)) {
-        error = LibWalletError::from(e).code;
-        ptr::swap(error_out, &mut error as *mut c_int);
-    }
+    let progress = EncryptionProgress::new(move |processed, total| callback_progress(processed, total));
+    let mut wallet_clone = (*wallet).wallet.clone();
+    (*wallet).runtime.spawn(async move {
+        let result = wallet_clone.apply_encryption_with_progress(pf, progress).await;
+        callback_completed(result.map_or_else(|e| LibWalletError::from(e).code, |_| 0));
+    });
+
+    true
 }
 
-/// Remove encryption to the databases used in this wallet. If this wallet is currently encrypted this encryption will
-/// be removed. If it is not encrypted then this function will still succeed to make the operation idempotent
+/// Remove encryption from the databases used in this wallet in the background. The rows are decrypted in batches and,
+/// if the process is interrupted, the wallet has to be started with the passphrase and starting it completes the
+/// removal.
 ///
 /// ## Arguments
 /// `wallet` - The TariWallet pointer
+/// `callback_progress` - The callback function pointer that will be called with the number of rows processed so far
+/// and the total number of rows after every batch
+/// `callback_completed` - The callback function pointer that will be called once with 0 when the process completed
+/// successfully or with the error code of the failure
 /// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
 /// as an out parameter.
+///
+/// ## Returns
+/// `bool` - Return a boolean value indicating whether the process started successfully or not
+///
 /// # Safety
 /// None
 #[no_mangle]
-pub unsafe extern "C" fn wallet_remove_encryption(wallet: *mut TariWallet, error_out: *mut c_int) {
+pub unsafe extern "C" fn wallet_remove_encryption_with_progress(
+    wallet: *mut TariWallet,
+    callback_progress: unsafe extern "C" fn(c_ulonglong, c_ulonglong),
+    callback_completed: unsafe extern "C" fn(c_int),
+    error_out: *mut c_int,
+) -> bool {
     let mut error = 0;
     ptr::swap(error_out, &mut error as *mut c_int);
     if wallet.is_null() {
         error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
         ptr::swap(error_out, &mut error as *mut c_int);
-        return;
+        return false;
     }
-
-    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.remove_encryption()) {
-        error = LibWalletError::from(e).code;
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
         ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
     }
+
+    let progress = EncryptionProgress::new(move |processed, total| callback_progress(processed, total));
+    let mut wallet_clone = (*wallet).wallet.clone();
+    (*wallet).runtime.spawn(async move {
+        let result = wallet_clone.remove_encryption_with_progress(progress).await;
+        callback_completed(result.map_or_else(|e| LibWalletError::from(e).code, |_| 0));
+    });
+
+    true
 }
 
 /// Set a Key Value in the Wallet storage used for Client Key Value store
@@ -5247,6 +6992,11 @@ pub unsafe extern "C" fn wallet_is_recovery_in_progress(wallet: *mut TariWallet,
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     match (*wallet).runtime.block_on((*wallet).wallet.is_recovery_in_progress()) {
         Ok(result) => result,
@@ -5295,6 +7045,11 @@ pub unsafe extern "C" fn wallet_start_recovery(
         ptr::swap(error_out, &mut error as *mut c_int);
         return false;
     }
+    if let Err(e) = (*wallet).runtime.block_on((*wallet).wallet.wait_until_started()) {
+        error = e.code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return false;
+    }
 
     let shutdown_signal = (*wallet).shutdown.to_signal();
     let peer_public_keys: Vec<TariPublicKey> = vec![(*base_node_public_key).clone()];
@@ -5474,6 +7229,35 @@ pub unsafe extern "C" fn emoji_set_destroy(emoji_set: *mut EmojiSet) {
     }
 }
 
+/// Gets the current value of the wallet metrics in the Prometheus text exposition format. The metrics include the
+/// time FFI calls spend blocked on the wallet, the depth of the callback event queue, coin selection and database query
+/// times, the UTXO scanner rate and the RPC round-trip times per base node. The metrics are shared by every wallet in
+/// the process.
+///
+/// ## Arguments
+/// `wallet` - The TariWallet pointer
+/// `error_out` - Pointer to an int which will be modified to an error code should one occur, may not be null. Functions
+/// as an out parameter.
+///
+/// ## Returns
+/// `*const c_char` - Returns the pointer to the char array, note that it will return a pointer
+/// to an empty char array if wallet is null
+///
+/// # Safety
+/// The ```string_destroy``` method must be called when finished with string coming from rust to prevent a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn wallet_get_metrics_snapshot(wallet: *mut TariWallet, error_out: *mut c_int) -> *const c_char {
+    let mut error = 0;
+    ptr::swap(error_out, &mut error as *mut c_int);
+    if wallet.is_null() {
+        error = LibWalletError::from(InterfaceError::NullError("wallet".to_string())).code;
+        ptr::swap(error_out, &mut error as *mut c_int);
+        return CString::new("").unwrap().into_raw();
+    }
+
+    CString::new(tari_metrics::global().encode_text()).unwrap().into_raw()
+}
+
 /// Frees memory for a TariWallet
 ///
 /// ## Arguments
@@ -5487,10 +7271,17 @@ pub unsafe extern "C" fn emoji_set_destroy(emoji_set: *mut EmojiSet) {
 #[no_mangle]
 pub unsafe extern "C" fn wallet_destroy(wallet: *mut TariWallet) {
     if !wallet.is_null() {
-        let mut w = Box::from_raw(wallet);
-        match w.shutdown.trigger() {
-            Err(_) => error!(target: LOG_TARGET, "No listeners for the shutdown signal!"),
-            Ok(()) => w.runtime.block_on(w.wallet.wait_until_shutdown()),
+        let TariWallet {
+            wallet,
+            mut runtime,
+            mut shutdown,
+            ..
+        } = *Box::from_raw(wallet);
+        // A wallet that is still starting completes its startup with the shutdown signal already triggered
+        if shutdown.trigger().is_err() {
+            error!(target: LOG_TARGET, "No listeners for the shutdown signal!");
+        } else if let Some(w) = runtime.block_on(wallet.into_started()) {
+            runtime.block_on(w.wait_until_shutdown());
         }
     }
 }
@@ -5914,6 +7705,30 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_runtime() {
+        unsafe {
+            let mut error = 0;
+            let error_ptr = &mut error as *mut c_int;
+            let config = runtime_config_create(2, 4, false, error_ptr);
+            assert_eq!(error, 0);
+            let runtime = runtime_create(config, error_ptr);
+            assert_eq!(error, 0);
+            assert!(!runtime.is_null());
+            runtime_destroy(runtime);
+            runtime_config_destroy(config);
+
+            let config = runtime_config_create(4, 2, false, error_ptr);
+            let runtime = runtime_create(config, error_ptr);
+            assert!(runtime.is_null());
+            assert_eq!(
+                error,
+                LibWalletError::from(InterfaceError::TokioError("".to_string())).code
+            );
+            runtime_config_destroy(config);
+        }
+    }
+
     #[test]
     fn test_keys() {
         unsafe {
@@ -6065,6 +7880,108 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_completed_transactions_export() {
+        unsafe {
+            let mut error = 0;
+            let error_ptr = &mut error as *mut c_int;
+            let source_public_key = TariPublicKey::from_secret_key(&PrivateKey::random(&mut OsRng));
+            let txs = (0..3u64)
+                .map(|i| {
+                    CompletedTransaction::new(
+                        i + 1,
+                        source_public_key.clone(),
+                        TariPublicKey::default(),
+                        MicroTari::from(1000 * (i + 1)),
+                        MicroTari::from(10),
+                        tari_core::transactions::transaction::Transaction::new(
+                            vec![],
+                            vec![],
+                            vec![],
+                            PrivateKey::default(),
+                            PrivateKey::default(),
+                        ),
+                        TransactionStatus::MinedConfirmed,
+                        format!("message {}", i),
+                        chrono::Utc::now().naive_utc(),
+                        TransactionDirection::Inbound,
+                        None,
+                    )
+                })
+                .collect::<Vec<_>>();
+            let transactions = Box::into_raw(Box::new(TariCompletedTransactions(txs)));
+
+            let mut records = vec![TariCompletedTransactionRecord::default(); 3];
+            let written = completed_transactions_export(
+                transactions,
+                0,
+                TX_EXPORT_FIELD_TX_ID | TX_EXPORT_FIELD_AMOUNT | TX_EXPORT_FIELD_SOURCE_PUBLIC_KEY,
+                records.as_mut_ptr(),
+                records.len() as c_uint,
+                ptr::null_mut(),
+                0,
+                error_ptr,
+            );
+            assert_eq!(error, 0);
+            assert_eq!(written, 3);
+            for (i, r) in records.iter().enumerate() {
+                assert_eq!(r.tx_id, i as u64 + 1);
+                assert_eq!(r.amount, 1000 * (i as u64 + 1));
+                assert_eq!(r.fee, 0);
+                assert_eq!(&r.source_public_key[..], source_public_key.as_bytes());
+            }
+
+            // An arena that can only hold the first two messages results in a partial export
+            let mut arena = vec![0u8; 20];
+            let written = completed_transactions_export(
+                transactions,
+                0,
+                TX_EXPORT_FIELD_ALL,
+                records.as_mut_ptr(),
+                records.len() as c_uint,
+                arena.as_mut_ptr() as *mut c_char,
+                arena.len() as c_uint,
+                error_ptr,
+            );
+            assert_eq!(error, 0);
+            assert_eq!(written, 2);
+            let offset = records[1].message_offset as usize;
+            let message = CStr::from_ptr(arena[offset..].as_ptr() as *const c_char);
+            assert_eq!(message.to_str().unwrap(), "message 1");
+            assert_eq!(records[1].message_length, 9);
+            assert_eq!(records[1].fee, 10);
+            assert_eq!(records[1].status, TransactionStatus::MinedConfirmed as i32);
+
+            let written = completed_transactions_export(
+                transactions,
+                2,
+                TX_EXPORT_FIELD_MESSAGE,
+                records.as_mut_ptr(),
+                records.len() as c_uint,
+                arena.as_mut_ptr() as *mut c_char,
+                arena.len() as c_uint,
+                error_ptr,
+            );
+            assert_eq!(written, 1);
+            assert_eq!(records[0].tx_id, 0);
+
+            let written = completed_transactions_export(
+                transactions,
+                4,
+                TX_EXPORT_FIELD_ALL,
+                records.as_mut_ptr(),
+                records.len() as c_uint,
+                arena.as_mut_ptr() as *mut c_char,
+                arena.len() as c_uint,
+                error_ptr,
+            );
+            assert_eq!(written, 0);
+            assert_eq!(error, LibWalletError::from(InterfaceError::PositionInvalidError).code);
+
+            completed_transactions_destroy(transactions);
+        }
+    }
+
     #[test]
     fn test_wallet_ffi() {
         unsafe {
@@ -6107,6 +8024,7 @@ mod test {
                 10000,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6121,6 +8039,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
             let secret_key_bob = private_key_generate();
@@ -6155,6 +8077,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback_bob,
                 received_tx_reply_callback_bob,
                 received_tx_finalized_callback_bob,
@@ -6169,6 +8092,10 @@ mod test {
                 invalid_txo_validation_complete_callback_bob,
                 transaction_validation_complete_callback_bob,
                 saf_messages_received_callback_bob,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -6387,8 +8314,21 @@ mod test {
                 .block_on((*alice_wallet).wallet.transaction_service.get_completed_transactions())
                 .unwrap();
 
+            let ffi_changes = wallet_get_transaction_changes_since(alice_wallet, 0, error_ptr);
+            assert_eq!(error, 0);
+            let ffi_changed_completed = transaction_changes_get_completed(ffi_changes, error_ptr);
+            assert_eq!(
+                completed_transactions_get_length(ffi_changed_completed, error_ptr) as usize,
+                completed_transactions.len()
+            );
+            let change_sequence = transaction_changes_get_sequence(ffi_changes, error_ptr);
+            completed_transactions_destroy(ffi_changed_completed);
+            transaction_changes_destroy(ffi_changes);
+            let mut num_mined = 0;
+
             for (_k, v) in completed_transactions {
                 if v.status == TransactionStatus::Completed {
+                    num_mined += 1;
                     let tx_ptr = Box::into_raw(Box::new(v.clone()));
                     wallet_test_broadcast_transaction(alice_wallet, (*tx_ptr).tx_id, error_ptr);
                     wallet_test_mine_transaction(alice_wallet, (*tx_ptr).tx_id, error_ptr);
@@ -6426,6 +8366,23 @@ mod test {
             let ffi_completed_txs = wallet_get_completed_transactions(&mut (*alice_wallet), error_ptr);
             assert_eq!(completed_transactions_get_length(ffi_completed_txs, error_ptr), 15);
 
+            // Only the transactions that were broadcast and mined above have changed since the previous sequence
+            let ffi_changes = wallet_get_transaction_changes_since(alice_wallet, change_sequence, error_ptr);
+            assert!(transaction_changes_get_sequence(ffi_changes, error_ptr) > change_sequence);
+            let ffi_changed_completed = transaction_changes_get_completed(ffi_changes, error_ptr);
+            assert_eq!(
+                completed_transactions_get_length(ffi_changed_completed, error_ptr),
+                num_mined
+            );
+            let ffi_changed_inbound = transaction_changes_get_pending_inbound(ffi_changes, error_ptr);
+            assert_eq!(
+                pending_inbound_transactions_get_length(ffi_changed_inbound, error_ptr),
+                0
+            );
+            pending_inbound_transactions_destroy(ffi_changed_inbound);
+            completed_transactions_destroy(ffi_changed_completed);
+            transaction_changes_destroy(ffi_changes);
+
             let contacts = wallet_get_contacts(alice_wallet, error_ptr);
             assert_eq!(contacts_get_length(contacts, error_ptr), 4);
 
@@ -6466,6 +8423,22 @@ mod test {
                 post_balance.available_balance
             );
 
+            let mut balance = TariBalance::default();
+            assert!(wallet_get_balance(
+                alice_wallet,
+                &mut balance as *mut TariBalance,
+                error_ptr
+            ));
+            assert_eq!(balance.available_balance, u64::from(post_balance.available_balance));
+            assert_eq!(
+                balance.pending_incoming_balance,
+                u64::from(post_balance.pending_incoming_balance)
+            );
+            assert_eq!(
+                balance.pending_outgoing_balance,
+                u64::from(post_balance.pending_outgoing_balance)
+            );
+
             let import_transaction = (*alice_wallet)
                 .runtime
                 .block_on((*alice_wallet).wallet.transaction_service.get_completed_transactions())
@@ -6679,6 +8652,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6693,6 +8667,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -6718,6 +8696,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6732,6 +8711,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -6816,6 +8799,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6830,6 +8814,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
             let generated = wallet_test_generate_data(alice_wallet, db_path_alice_str, error_ptr);
@@ -6864,6 +8852,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6878,6 +8867,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -6894,6 +8887,7 @@ mod test {
                 0,
                 wrong_passphrase_const_str,
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6908,6 +8902,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
             assert_eq!(error, 428);
@@ -6919,6 +8917,7 @@ mod test {
                 0,
                 passphrase_const_str,
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6933,6 +8932,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -6964,6 +8967,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -6978,6 +8982,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -7032,6 +9040,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -7046,6 +9055,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -7108,6 +9121,127 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_wallet_async_operations() {
+        unsafe {
+            let mut error = 0;
+            let error_ptr = &mut error as *mut c_int;
+
+            let db_name_alice = CString::new(random::string(8).as_str()).unwrap();
+            let db_name_alice_str: *const c_char = CString::into_raw(db_name_alice) as *const c_char;
+            let alice_temp_dir = tempdir().unwrap();
+            let db_path_alice = CString::new(alice_temp_dir.path().to_str().unwrap()).unwrap();
+            let db_path_alice_str: *const c_char = CString::into_raw(db_path_alice) as *const c_char;
+            let transport_type_alice = transport_memory_create();
+            let address_alice = transport_memory_get_address(transport_type_alice, error_ptr);
+            let address_alice_str = CStr::from_ptr(address_alice).to_str().unwrap().to_owned();
+            let address_alice_str: *const c_char = CString::new(address_alice_str).unwrap().into_raw() as *const c_char;
+
+            let alice_config = comms_config_create(
+                address_alice_str,
+                transport_type_alice,
+                db_name_alice_str,
+                db_path_alice_str,
+                20,
+                10800,
+                error_ptr,
+            );
+
+            let alice_wallet = wallet_create(
+                alice_config,
+                ptr::null(),
+                0,
+                0,
+                ptr::null(),
+                ptr::null(),
+                ptr::null_mut(),
+                received_tx_callback,
+                received_tx_reply_callback,
+                received_tx_finalized_callback,
+                broadcast_callback,
+                mined_callback,
+                mined_unconfirmed_callback,
+                direct_send_callback,
+                store_and_forward_send_callback,
+                tx_cancellation_callback,
+                utxo_validation_complete_callback,
+                stxo_validation_complete_callback,
+                invalid_txo_validation_complete_callback,
+                transaction_validation_complete_callback,
+                saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
+                error_ptr,
+            );
+            assert_eq!(error, 0);
+
+            let utxo_spending_key = private_key_generate();
+            let secret_key_source = private_key_generate();
+            let public_key_source = public_key_from_private_key(secret_key_source, error_ptr);
+            let utxo_message_str = CString::new("UTXO Import").unwrap();
+            let utxo_message: *const c_char = CString::into_raw(utxo_message_str) as *const c_char;
+
+            let import_request = wallet_import_utxo_async(
+                alice_wallet,
+                20000,
+                utxo_spending_key,
+                public_key_source,
+                utxo_message,
+                error_ptr,
+            );
+            assert_eq!(error, 0);
+            let cancel_request = wallet_cancel_pending_transaction_async(alice_wallet, 1234, error_ptr);
+            assert_eq!(error, 0);
+            assert_ne!(import_request, 0);
+            assert_ne!(cancel_request, 0);
+            assert_ne!(import_request, cancel_request);
+
+            let mut completions = vec![TariOperationCompletion::default(); 4];
+            let mut num_completed = 0;
+            while num_completed < 2 {
+                num_completed += wallet_drain_operation_completions(
+                    alice_wallet,
+                    completions[num_completed..].as_mut_ptr(),
+                    (completions.len() - num_completed) as c_uint,
+                    10000,
+                    error_ptr,
+                ) as usize;
+                assert_eq!(error, 0);
+            }
+            assert_eq!(num_completed, 2);
+
+            let import_completion = completions.iter().find(|c| c.request_id == import_request).unwrap();
+            assert_eq!(import_completion.error_code, 0);
+            assert!((*alice_wallet)
+                .runtime
+                .block_on(
+                    (*alice_wallet)
+                        .wallet
+                        .transaction_service
+                        .get_completed_transaction(import_completion.tx_id)
+                )
+                .is_ok());
+
+            let cancel_completion = completions.iter().find(|c| c.request_id == cancel_request).unwrap();
+            assert_eq!(cancel_completion.tx_id, 0);
+            assert_ne!(cancel_completion.error_code, 0);
+
+            string_destroy(utxo_message as *mut c_char);
+            string_destroy(db_name_alice_str as *mut c_char);
+            string_destroy(db_path_alice_str as *mut c_char);
+            string_destroy(address_alice_str as *mut c_char);
+            private_key_destroy(utxo_spending_key);
+            private_key_destroy(secret_key_source);
+            public_key_destroy(public_key_source);
+            transport_type_destroy(transport_type_alice);
+
+            comms_config_destroy(alice_config);
+            wallet_destroy(alice_wallet);
+        }
+    }
+
     #[test]
     pub fn test_seed_words() {
         unsafe {
@@ -7175,6 +9309,7 @@ mod test {
                 0,
                 ptr::null(),
                 ptr::null(),
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -7189,6 +9324,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
 
@@ -7225,6 +9364,7 @@ mod test {
                 0,
                 ptr::null(),
                 seed_words,
+                ptr::null_mut(),
                 received_tx_callback,
                 received_tx_reply_callback,
                 received_tx_finalized_callback,
@@ -7239,6 +9379,10 @@ mod test {
                 invalid_txo_validation_complete_callback,
                 transaction_validation_complete_callback,
                 saf_messages_received_callback,
+                None,
+                0,
+                0,
+                None,
                 error_ptr,
             );
             assert_eq!(error, 0);
@@ -0,0 +1,233 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! # Asynchronous wallet operations
+//! The `_async` variants of the FFI functions that wait on the wallet services (sending, coin splits, importing UTXOs
+//! and cancelling transactions) spawn the operation onto the wallet runtime and return a request id straight away. A
+//! wallet that is still starting is waited for inside the spawned operation, never on the calling thread.
+//! When an operation completes its outcome is passed to the completion callback if one is set with
+//! `wallet_set_operation_completion_callback`, otherwise it is queued until the client collects it with
+//! `wallet_drain_operation_completions`. Operations still in flight when the wallet is destroyed are dropped without
+//! reporting a completion.
+
+use crate::{error::LibWalletError, wallet_runtime::WalletRuntime};
+use futures::{
+    future::{self, Either},
+    FutureExt,
+};
+use libc::{c_int, c_ulonglong};
+use log::*;
+use std::{
+    cmp::min,
+    collections::VecDeque,
+    future::Future,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc,
+        Condvar,
+        Mutex,
+    },
+    time::Duration,
+};
+use tari_metrics::Gauge;
+use tari_shutdown::ShutdownSignal;
+use tari_wallet::output_manager_service::TxId;
+
+const LOG_TARGET: &str = "wallet_ffi::operations";
+
+lazy_static! {
+    static ref OPERATIONS_IN_FLIGHT: Arc<Gauge> = tari_metrics::global().gauge(
+        "wallet_ffi_operations_in_flight",
+        "The number of asynchronous wallet operations that have been started but not completed",
+        &[],
+    );
+}
+
+/// The outcome of an asynchronous wallet operation
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct TariOperationCompletion {
+    /// The request id returned when the operation was started
+    pub request_id: u64,
+    /// The TxId of the transaction sent, split, imported or cancelled by the operation, 0 if the operation failed
+    pub tx_id: u64,
+    /// 0 if the operation succeeded, otherwise the error code the blocking variant would have set in `error_out`
+    pub error_code: i32,
+}
+
+/// Called with the request id, TxId and error code of each completed operation
+pub type OperationCompletionCallback = unsafe extern "C" fn(c_ulonglong, c_ulonglong, c_int);
+
+#[derive(Clone)]
+pub struct AsyncOperations {
+    inner: Arc<AsyncOperationsInner>,
+}
+
+struct AsyncOperationsInner {
+    next_request_id: AtomicU64,
+    callback: Mutex<Option<OperationCompletionCallback>>,
+    completions: Mutex<VecDeque<TariOperationCompletion>>,
+    completion_added: Condvar,
+    shutdown_signal: ShutdownSignal,
+}
+
+impl AsyncOperations {
+    pub fn new(shutdown_signal: ShutdownSignal) -> Self {
+        Self {
+            inner: Arc::new(AsyncOperationsInner {
+                // Request ids start at 1 so that 0 can signal a failure to start an operation
+                next_request_id: AtomicU64::new(1),
+                callback: Mutex::new(None),
+                completions: Mutex::new(VecDeque::new()),
+                completion_added: Condvar::new(),
+                shutdown_signal,
+            }),
+        }
+    }
+
+    /// Deliver completions to `callback` instead of the completion queue, or to the queue again if `callback` is None.
+    /// Completions that are already queued stay in the queue.
+    pub fn set_callback(&self, callback: Option<OperationCompletionCallback>) {
+        *self.inner.callback.lock().unwrap() = callback;
+    }
+
+    /// Spawn an operation onto the wallet runtime and return its request id
+    pub fn spawn<F>(&self, runtime: &WalletRuntime, operation: F) -> u64
+    where F: Future<Output = Result<TxId, LibWalletError>> + Send + 'static {
+        let request_id = self.inner.next_request_id.fetch_add(1, Ordering::Relaxed);
+        let shutdown_signal = self.inner.shutdown_signal.clone();
+        let operations = self.clone();
+        OPERATIONS_IN_FLIGHT.inc();
+        runtime.spawn(async move {
+            let result = match future::select(operation.boxed(), shutdown_signal).await {
+                Either::Left((result, _)) => result,
+                Either::Right(_) => {
+                    debug!(target: LOG_TARGET, "Operation {} dropped on shutdown", request_id);
+                    OPERATIONS_IN_FLIGHT.dec();
+                    return;
+                },
+            };
+            let completion = match result {
+                Ok(tx_id) => TariOperationCompletion {
+                    request_id,
+                    tx_id,
+                    error_code: 0,
+                },
+                Err(e) => {
+                    warn!(target: LOG_TARGET, "Operation {} failed: {:?}", request_id, e);
+                    TariOperationCompletion {
+                        request_id,
+                        tx_id: 0,
+                        error_code: e.code,
+                    }
+                },
+            };
+            OPERATIONS_IN_FLIGHT.dec();
+            operations.complete(completion);
+        });
+        request_id
+    }
+
+    fn complete(&self, completion: TariOperationCompletion) {
+        let callback = *self.inner.callback.lock().unwrap();
+        match callback {
+            Some(callback) => unsafe {
+                (callback)(completion.request_id, completion.tx_id, completion.error_code);
+            },
+            None => {
+                self.inner.completions.lock().unwrap().push_back(completion);
+                self.inner.completion_added.notify_all();
+            },
+        }
+    }
+
+    /// Move up to `completions_out.len()` queued completions, oldest first, into `completions_out` and return how many
+    /// were moved. If the queue is empty this waits up to `timeout` for a completion to arrive.
+    pub fn drain(&self, completions_out: &mut [TariOperationCompletion], timeout: Duration) -> usize {
+        let mut completions = self.inner.completions.lock().unwrap();
+        if completions.is_empty() && timeout > Duration::from_millis(0) {
+            completions = self
+                .inner
+                .completion_added
+                .wait_timeout_while(completions, timeout, |completions| completions.is_empty())
+                .unwrap()
+                .0;
+        }
+        let num_drained = min(completions_out.len(), completions.len());
+        for (completion_out, completion) in completions_out.iter_mut().zip(completions.drain(..num_drained)) {
+            *completion_out = completion;
+        }
+        num_drained
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use tari_shutdown::Shutdown;
+    use tari_wallet::error::WalletError;
+    use tokio::runtime::Runtime;
+
+    #[test]
+    fn it_queues_completions_until_drained() {
+        let runtime = WalletRuntime::Owned(Runtime::new().unwrap());
+        let shutdown = Shutdown::new();
+        let operations = AsyncOperations::new(shutdown.to_signal());
+
+        let ok_request = operations.spawn(&runtime, async { Ok(123) });
+        let failed_request = operations.spawn(&runtime, async { Err(LibWalletError::from(WalletError::Shutdown)) });
+        assert_eq!(ok_request, 1);
+        assert_eq!(failed_request, 2);
+
+        let mut completions = vec![TariOperationCompletion::default(); 4];
+        let mut num_drained = 0;
+        while num_drained < 2 {
+            num_drained += operations.drain(&mut completions[num_drained..], Duration::from_secs(10));
+        }
+        completions.truncate(num_drained);
+        completions.sort_by_key(|completion| completion.request_id);
+        assert_eq!(completions[0], TariOperationCompletion {
+            request_id: ok_request,
+            tx_id: 123,
+            error_code: 0,
+        });
+        assert_eq!(completions[1], TariOperationCompletion {
+            request_id: failed_request,
+            tx_id: 0,
+            error_code: LibWalletError::from(WalletError::Shutdown).code,
+        });
+        assert_eq!(operations.drain(&mut completions, Duration::from_millis(0)), 0);
+    }
+
+    #[test]
+    fn it_drops_operations_on_shutdown() {
+        let runtime = WalletRuntime::Owned(Runtime::new().unwrap());
+        let mut shutdown = Shutdown::new();
+        let operations = AsyncOperations::new(shutdown.to_signal());
+
+        operations.spawn(&runtime, future::pending());
+        shutdown.trigger().unwrap();
+
+        let mut completions = vec![TariOperationCompletion::default(); 1];
+        assert_eq!(operations.drain(&mut completions, Duration::from_millis(100)), 0);
+    }
+}
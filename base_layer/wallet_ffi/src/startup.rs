@@ -0,0 +1,375 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! # Staged wallet startup
+//! `wallet_create` only opens the wallet databases on the calling thread. Starting the services, comms and the
+//! transport (e.g. bootstrapping Tor) runs on a background thread and the client is told through a callback when the
+//! wallet is ready. Until then balances, transactions and contacts are read straight from the databases, every other
+//! function waits for the startup to complete.
+
+use crate::error::LibWalletError;
+use futures::{channel::oneshot, executor, FutureExt};
+use log::*;
+use std::{
+    collections::HashMap,
+    future::Future,
+    io,
+    ops::{Deref, DerefMut},
+    sync::{Arc, Mutex},
+    thread,
+};
+use tari_wallet::{
+    contacts_service::{
+        error::ContactsServiceError,
+        storage::{
+            database::{Contact, ContactsDatabase},
+            sqlite_db::ContactsServiceSqliteDatabase,
+        },
+    },
+    error::WalletError,
+    output_manager_service::{
+        error::OutputManagerError,
+        service::Balance,
+        storage::{database::OutputManagerDatabase, sqlite_db::OutputManagerSqliteDatabase},
+        TxId,
+    },
+    storage::{database::WalletDatabase, sqlite_db::WalletSqliteDatabase},
+    transaction_service::{
+        error::TransactionServiceError,
+        storage::{
+            database::TransactionDatabase,
+            models::{CompletedTransaction, CompletedTransactionQuery, InboundTransaction, OutboundTransaction},
+            sqlite_db::TransactionServiceSqliteDatabase,
+        },
+    },
+    WalletSqlite,
+};
+use tokio::runtime::Handle;
+
+const LOG_TARGET: &str = "wallet_ffi::startup";
+
+pub type WalletStartupResult = Result<WalletSqlite, LibWalletError>;
+
+/// Run the startup of a wallet on its own thread within the runtime context. The result is passed to the returned
+/// handle and, if the handle is still held, `on_complete` is then called with the error code of the startup, 0 if it
+/// succeeded.
+pub fn spawn_startup<F, Fut, C>(handle: Handle, startup: F, on_complete: C) -> Result<StartupHandle, io::Error>
+where
+    F: FnOnce() -> Fut + Send + 'static,
+    Fut: Future<Output = Result<WalletSqlite, WalletError>>,
+    C: FnOnce(i32) + Send + 'static,
+{
+    let startup_handle = StartupHandle::new();
+    let thread_startup_handle = startup_handle.clone();
+    thread::Builder::new()
+        .name("wallet-ffi-startup".to_string())
+        .spawn(move || {
+            let result = handle
+                .enter(|| executor::block_on(startup()))
+                .map_err(LibWalletError::from);
+            let code = result.as_ref().err().map(|e| e.code).unwrap_or(0);
+            match &result {
+                Ok(_) => info!(target: LOG_TARGET, "Wallet started"),
+                Err(e) => error!(target: LOG_TARGET, "Wallet failed to start: {:?}", e),
+            }
+            if thread_startup_handle.complete(result) {
+                on_complete(code);
+            }
+        })?;
+    Ok(startup_handle)
+}
+
+/// The result of a wallet startup that is running or has completed. Clones refer to the same startup, so any number of
+/// waiters can wait for it without borrowing the staged wallet.
+#[derive(Clone)]
+pub struct StartupHandle {
+    state: Arc<Mutex<SharedStartupState>>,
+}
+
+enum SharedStartupState {
+    Running(Vec<oneshot::Sender<WalletStartupResult>>),
+    Completed(WalletStartupResult),
+}
+
+impl StartupHandle {
+    fn new() -> Self {
+        Self {
+            state: Arc::new(Mutex::new(SharedStartupState::Running(Vec::new()))),
+        }
+    }
+
+    fn completed(result: WalletStartupResult) -> Self {
+        Self {
+            state: Arc::new(Mutex::new(SharedStartupState::Completed(result))),
+        }
+    }
+
+    /// Store the result and pass it to every waiter. Returns false if no other clone of the handle is left, i.e. the
+    /// staged wallet was dropped while it was starting.
+    fn complete(&self, result: WalletStartupResult) -> bool {
+        let mut state = self.state.lock().unwrap();
+        if let SharedStartupState::Running(waiters) = &mut *state {
+            for waiter in waiters.drain(..) {
+                let _ = waiter.send(result.clone());
+            }
+        }
+        *state = SharedStartupState::Completed(result);
+        Arc::strong_count(&self.state) > 1
+    }
+
+    /// Returns the result if the startup has completed, without waiting for it
+    pub fn try_result(&self) -> Option<WalletStartupResult> {
+        match &*self.state.lock().unwrap() {
+            SharedStartupState::Running(_) => None,
+            SharedStartupState::Completed(result) => Some(result.clone()),
+        }
+    }
+
+    /// Wait for the startup to complete. The returned future does not borrow the handle.
+    pub fn wait(&self) -> impl Future<Output = WalletStartupResult> + Send + 'static {
+        let (sender, receiver) = oneshot::channel();
+        match &mut *self.state.lock().unwrap() {
+            SharedStartupState::Running(waiters) => waiters.push(sender),
+            SharedStartupState::Completed(result) => {
+                let _ = sender.send(result.clone());
+            },
+        }
+        receiver.map(|result| result.unwrap_or_else(|_| Err(LibWalletError::from(WalletError::Shutdown))))
+    }
+}
+
+enum StartupState {
+    Starting(StartupHandle),
+    Started(Box<WalletSqlite>),
+    Failed(LibWalletError),
+}
+
+/// A wallet that may still be starting in the background. It dereferences to the started wallet, which must only be
+/// done after `wait_until_started` has succeeded.
+pub struct StagedWallet {
+    /// The wallet key value store. It is used directly by the FFI so it is available before the services start.
+    pub db: WalletDatabase<WalletSqliteDatabase>,
+    transaction_db: TransactionDatabase<TransactionServiceSqliteDatabase>,
+    output_manager_db: OutputManagerDatabase<OutputManagerSqliteDatabase>,
+    contacts_db: ContactsDatabase<ContactsServiceSqliteDatabase>,
+    state: StartupState,
+}
+
+impl StagedWallet {
+    pub fn new(
+        db: WalletDatabase<WalletSqliteDatabase>,
+        transaction_backend: TransactionServiceSqliteDatabase,
+        output_manager_backend: OutputManagerSqliteDatabase,
+        contacts_backend: ContactsServiceSqliteDatabase,
+        startup: StartupHandle,
+    ) -> Self {
+        Self {
+            db,
+            transaction_db: TransactionDatabase::new(transaction_backend),
+            output_manager_db: OutputManagerDatabase::new(output_manager_backend),
+            contacts_db: ContactsDatabase::new(contacts_backend),
+            state: StartupState::Starting(startup),
+        }
+    }
+
+    /// Returns true if the startup has completed successfully, without waiting for it
+    pub fn is_started(&mut self) -> bool {
+        if let StartupState::Starting(startup) = &self.state {
+            match startup.try_result() {
+                Some(result) => self.complete(result),
+                None => return false,
+            }
+        }
+        matches!(self.state, StartupState::Started(_))
+    }
+
+    /// Wait for the startup to complete, returning the startup error if the wallet failed to start
+    pub async fn wait_until_started(&mut self) -> Result<(), LibWalletError> {
+        if let StartupState::Starting(startup) = &self.state {
+            let result = startup.wait().await;
+            self.complete(result);
+        }
+        match &self.state {
+            StartupState::Started(_) => Ok(()),
+            StartupState::Failed(e) => Err(e.clone()),
+            StartupState::Starting(_) => unreachable!("startup state is set once the startup completes"),
+        }
+    }
+
+    /// Returns a future that waits for the startup to complete and resolves to a handle to the started wallet. The
+    /// future does not borrow the staged wallet, so it can be spawned onto the runtime.
+    pub fn started(&self) -> impl Future<Output = WalletStartupResult> + Send + 'static {
+        match &self.state {
+            StartupState::Starting(startup) => startup.wait(),
+            StartupState::Started(wallet) => StartupHandle::completed(Ok(WalletSqlite::clone(&**wallet))).wait(),
+            StartupState::Failed(e) => StartupHandle::completed(Err(e.clone())).wait(),
+        }
+    }
+
+    /// Wait for the startup to complete and return the wallet, or None if it failed to start
+    pub async fn into_started(mut self) -> Option<WalletSqlite> {
+        let _ = self.wait_until_started().await;
+        match self.state {
+            StartupState::Started(wallet) => Some(*wallet),
+            _ => None,
+        }
+    }
+
+    pub async fn get_balance(&mut self) -> Result<Balance, OutputManagerError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.output_manager_service.get_balance().await,
+            None => {
+                let chain_tip = self
+                    .db
+                    .get_chain_metadata()
+                    .await
+                    .ok()
+                    .flatten()
+                    .map(|metadata| metadata.height_of_longest_chain());
+                Ok(self.output_manager_db.get_balance(chain_tip).await?)
+            },
+        }
+    }
+
+    pub async fn get_contacts(&mut self) -> Result<Vec<Contact>, ContactsServiceError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.contacts_service.get_contacts().await,
+            None => Ok(self.contacts_db.get_contacts().await?),
+        }
+    }
+
+    pub async fn get_completed_transactions(
+        &mut self,
+    ) -> Result<HashMap<TxId, CompletedTransaction>, TransactionServiceError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.transaction_service.get_completed_transactions().await,
+            None => Ok(self.transaction_db.get_completed_transactions().await?),
+        }
+    }
+
+    pub async fn get_completed_transactions_page(
+        &mut self,
+        query: CompletedTransactionQuery,
+    ) -> Result<Vec<CompletedTransaction>, TransactionServiceError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.transaction_service.get_completed_transactions_page(query).await,
+            None => Ok(self.transaction_db.get_completed_transactions_page(query).await?),
+        }
+    }
+
+    pub async fn get_pending_inbound_transactions(
+        &mut self,
+    ) -> Result<HashMap<TxId, InboundTransaction>, TransactionServiceError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.transaction_service.get_pending_inbound_transactions().await,
+            None => Ok(self.transaction_db.get_pending_inbound_transactions().await?),
+        }
+    }
+
+    pub async fn get_pending_outbound_transactions(
+        &mut self,
+    ) -> Result<HashMap<TxId, OutboundTransaction>, TransactionServiceError> {
+        match self.started_mut() {
+            Some(wallet) => wallet.transaction_service.get_pending_outbound_transactions().await,
+            None => Ok(self.transaction_db.get_pending_outbound_transactions().await?),
+        }
+    }
+
+    fn started_mut(&mut self) -> Option<&mut WalletSqlite> {
+        if !self.is_started() {
+            return None;
+        }
+        match &mut self.state {
+            StartupState::Started(wallet) => Some(&mut **wallet),
+            _ => None,
+        }
+    }
+
+    fn complete(&mut self, result: WalletStartupResult) {
+        self.state = match result {
+            Ok(wallet) => StartupState::Started(Box::new(wallet)),
+            Err(e) => StartupState::Failed(e),
+        };
+    }
+}
+
+impl Deref for StagedWallet {
+    type Target = WalletSqlite;
+
+    fn deref(&self) -> &Self::Target {
+        match &self.state {
+            StartupState::Started(wallet) => &**wallet,
+            _ => panic!("The wallet was used before wait_until_started succeeded"),
+        }
+    }
+}
+
+impl DerefMut for StagedWallet {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        match &mut self.state {
+            StartupState::Started(wallet) => &mut **wallet,
+            _ => panic!("The wallet was used before wait_until_started succeeded"),
+        }
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::sync::mpsc;
+    use tokio::runtime::Runtime;
+
+    #[test]
+    fn it_reports_a_failed_startup() {
+        let mut runtime = Runtime::new().unwrap();
+        let (code_tx, code_rx) = mpsc::channel();
+        let startup = spawn_startup(
+            runtime.handle().clone(),
+            || async { Err(WalletError::Shutdown) },
+            move |code| code_tx.send(code).unwrap(),
+        )
+        .unwrap();
+
+        let result = runtime.block_on(startup.wait());
+        let expected = LibWalletError::from(WalletError::Shutdown).code;
+        assert_eq!(result.unwrap_err().code, expected);
+        assert_eq!(code_rx.recv().unwrap(), expected);
+    }
+
+    #[test]
+    fn it_passes_the_result_to_every_waiter() {
+        let mut runtime = Runtime::new().unwrap();
+        let startup = StartupHandle::new();
+        let early_waiter = runtime.spawn(startup.wait());
+
+        assert!(startup.try_result().is_none());
+        let expected = LibWalletError::from(WalletError::Shutdown).code;
+        let thread_startup = startup.clone();
+        assert!(thread_startup.complete(Err(LibWalletError::from(WalletError::Shutdown))));
+
+        let result = runtime.block_on(early_waiter).unwrap();
+        assert_eq!(result.unwrap_err().code, expected);
+        let result = runtime.block_on(startup.wait());
+        assert_eq!(result.unwrap_err().code, expected);
+        assert_eq!(startup.try_result().unwrap().unwrap_err().code, expected);
+    }
+}
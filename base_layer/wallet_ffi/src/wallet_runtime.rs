@@ -0,0 +1,260 @@
+// Copyright 2021. The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! # Wallet Runtime
+//! By default every wallet created through the FFI owns a multi-threaded Tokio runtime with one worker per core. A
+//! client that hosts many wallets in one process can instead create a `SharedRuntime` from a `RuntimeConfig` and pass
+//! it to each `wallet_create` call, so that the number of threads scales with the configuration rather than with the
+//! number of wallets. Wallets sharing a runtime also share the chain metadata polling of their base node through a
+//! `ChainMetadataHub`.
+
+use futures::executor;
+use log::*;
+use std::{future::Future, io, sync::Arc, thread};
+use tari_metrics::Histogram;
+use tari_shutdown::Shutdown;
+use tari_wallet::base_node_service::chain_metadata_hub::ChainMetadataHub;
+use tokio::{
+    runtime::{Builder, Handle, Runtime},
+    task,
+    task::JoinHandle,
+};
+
+const LOG_TARGET: &str = "wallet_ffi::runtime";
+
+lazy_static! {
+    static ref BLOCK_ON_DURATION: Arc<Histogram> = tari_metrics::global().histogram(
+        "wallet_ffi_block_on_seconds",
+        "Time the calling thread of an FFI function is blocked waiting on the wallet",
+        &[],
+    );
+}
+
+/// The settings used to build a `SharedRuntime`. `None` leaves the Tokio default in place.
+#[derive(Debug, Clone, Default)]
+pub struct RuntimeConfig {
+    /// The number of worker threads of the multi-threaded scheduler
+    pub core_threads: Option<usize>,
+    /// The maximum number of threads, including the worker threads, that the runtime and its blocking pool may use
+    pub max_threads: Option<usize>,
+    /// Run all tasks on a single scheduler thread instead of the multi-threaded scheduler
+    pub current_thread: bool,
+}
+
+impl RuntimeConfig {
+    fn build(&self) -> Result<Runtime, io::Error> {
+        if let (Some(core_threads), Some(max_threads)) = (self.core_threads, self.max_threads) {
+            if max_threads < core_threads {
+                return Err(io::Error::new(
+                    io::ErrorKind::InvalidInput,
+                    "max_threads cannot be less than core_threads",
+                ));
+            }
+        }
+
+        let mut builder = Builder::new();
+        if self.current_thread {
+            builder.basic_scheduler();
+        } else {
+            builder.threaded_scheduler();
+            if let Some(core_threads) = self.core_threads {
+                builder.core_threads(core_threads);
+            }
+        }
+        if let Some(max_threads) = self.max_threads {
+            builder.max_threads(max_threads);
+        }
+        builder.enable_all().build()
+    }
+}
+
+/// A Tokio runtime that can be shared by many wallets. The runtime is driven by a dedicated thread so that the
+/// background tasks of the wallets make progress between FFI calls, which is also what allows the single threaded
+/// scheduler to be used. All wallets using the runtime must be destroyed before it is dropped.
+pub struct SharedRuntime {
+    handle: Handle,
+    current_thread: bool,
+    chain_metadata_hub: ChainMetadataHub,
+    shutdown: Shutdown,
+    thread: Option<thread::JoinHandle<()>>,
+}
+
+impl SharedRuntime {
+    pub fn new(config: &RuntimeConfig) -> Result<Self, io::Error> {
+        let mut runtime = config.build()?;
+        let handle = runtime.handle().clone();
+        let shutdown = Shutdown::new();
+        let shutdown_signal = shutdown.to_signal();
+        let thread = thread::Builder::new()
+            .name("wallet-ffi-runtime".to_string())
+            .spawn(move || {
+                let _ = runtime.block_on(shutdown_signal);
+                debug!(target: LOG_TARGET, "Shared runtime thread exiting");
+            })?;
+        info!(target: LOG_TARGET, "Shared runtime started with {:?}", config);
+
+        Ok(Self {
+            handle,
+            current_thread: config.current_thread,
+            chain_metadata_hub: ChainMetadataHub::new(),
+            shutdown,
+            thread: Some(thread),
+        })
+    }
+
+    pub fn handle(&self) -> &Handle {
+        &self.handle
+    }
+
+    /// A `WalletRuntime` for a wallet that runs on this runtime
+    pub fn wallet_runtime(&self) -> WalletRuntime {
+        WalletRuntime::Shared {
+            handle: self.handle.clone(),
+            current_thread: self.current_thread,
+        }
+    }
+
+    pub fn chain_metadata_hub(&self) -> &ChainMetadataHub {
+        &self.chain_metadata_hub
+    }
+}
+
+impl Drop for SharedRuntime {
+    fn drop(&mut self) {
+        let _ = self.shutdown.trigger();
+        if let Some(thread) = self.thread.take() {
+            if thread.join().is_err() {
+                error!(target: LOG_TARGET, "Shared runtime thread panicked");
+            }
+        }
+    }
+}
+
+/// The runtime a wallet runs on, either its own or a handle to a `SharedRuntime`
+pub enum WalletRuntime {
+    Owned(Runtime),
+    Shared { handle: Handle, current_thread: bool },
+}
+
+impl WalletRuntime {
+    /// Run a future to completion on the calling thread. On a shared runtime the future is polled on the calling thread
+    /// within the runtime context while the spawned tasks keep running on the runtime's own threads.
+    ///
+    /// A callback runs on one of the shared runtime's worker threads, so a function called from it blocks that worker.
+    /// The worker's other tasks are first handed to another thread so they are not stalled waiting on it. The single
+    /// threaded scheduler has no other thread to hand them to, which is why wallet functions must not be called from
+    /// callbacks on such a runtime.
+    ///
+    /// # Panics
+    /// When called from a task of a single threaded shared runtime, which would otherwise deadlock
+    pub fn block_on<F: Future>(&mut self, future: F) -> F::Output {
+        let _timer = BLOCK_ON_DURATION.start_timer();
+        match self {
+            WalletRuntime::Owned(runtime) => runtime.block_on(future),
+            WalletRuntime::Shared { handle, current_thread } => {
+                if Handle::try_current().is_err() {
+                    return handle.enter(|| executor::block_on(future));
+                }
+                if *current_thread {
+                    error!(
+                        target: LOG_TARGET,
+                        "A wallet function was called from a callback of a single threaded shared runtime"
+                    );
+                    panic!("Cannot block the only thread of a single threaded shared runtime");
+                }
+                task::block_in_place(|| executor::block_on(future))
+            },
+        }
+    }
+
+    pub fn spawn<F>(&self, future: F) -> JoinHandle<F::Output>
+    where
+        F: Future + Send + 'static,
+        F::Output: Send + 'static,
+    {
+        match self {
+            WalletRuntime::Owned(runtime) => runtime.spawn(future),
+            WalletRuntime::Shared { handle, .. } => handle.spawn(future),
+        }
+    }
+
+    pub fn handle(&self) -> &Handle {
+        match self {
+            WalletRuntime::Owned(runtime) => runtime.handle(),
+            WalletRuntime::Shared { handle, .. } => handle,
+        }
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use crate::wallet_runtime::{RuntimeConfig, SharedRuntime};
+    use tokio::task;
+
+    #[test]
+    fn test_shared_runtime() {
+        for current_thread in &[false, true] {
+            let shared = SharedRuntime::new(&RuntimeConfig {
+                core_threads: Some(2),
+                max_threads: Some(4),
+                current_thread: *current_thread,
+            })
+            .unwrap();
+
+            let mut runtimes = vec![shared.wallet_runtime(), shared.wallet_runtime()];
+            for (i, runtime) in runtimes.iter_mut().enumerate() {
+                let spawned = runtime.spawn(async move { i * 2 });
+                assert_eq!(runtime.block_on(spawned).unwrap(), i * 2);
+                let blocking = runtime.block_on(task::spawn_blocking(move || i + 1)).unwrap();
+                assert_eq!(blocking, i + 1);
+            }
+            drop(runtimes);
+            drop(shared);
+        }
+
+        assert!(SharedRuntime::new(&RuntimeConfig {
+            core_threads: Some(4),
+            max_threads: Some(2),
+            current_thread: false,
+        })
+        .is_err());
+    }
+
+    #[test]
+    fn it_blocks_on_a_worker_thread_of_a_shared_runtime() {
+        let shared = SharedRuntime::new(&RuntimeConfig {
+            core_threads: Some(1),
+            max_threads: Some(4),
+            current_thread: false,
+        })
+        .unwrap();
+        let mut runtime = shared.wallet_runtime();
+        let mut nested = shared.wallet_runtime();
+
+        // As a callback would, call block_on from a task on the only worker thread
+        let spawned = runtime.spawn(async move {
+            let inner = nested.spawn(async { 42 });
+            nested.block_on(inner).unwrap()
+        });
+        assert_eq!(runtime.block_on(spawned).unwrap(), 42);
+    }
+}
@@ -40,6 +40,7 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 struct ByteVector;
 
@@ -61,6 +62,61 @@ struct TariCompletedTransactions;
 
 struct TariCompletedTransaction;
 
+// Field selection flags for completed_transactions_export
+enum TariTransactionExportField {
+    TX_EXPORT_FIELD_TX_ID = 1 << 0,
+    TX_EXPORT_FIELD_AMOUNT = 1 << 1,
+    TX_EXPORT_FIELD_FEE = 1 << 2,
+    TX_EXPORT_FIELD_TIMESTAMP = 1 << 3,
+    TX_EXPORT_FIELD_STATUS = 1 << 4,
+    TX_EXPORT_FIELD_DIRECTION = 1 << 5,
+    TX_EXPORT_FIELD_CONFIRMATIONS = 1 << 6,
+    TX_EXPORT_FIELD_MINED_HEIGHT = 1 << 7,
+    TX_EXPORT_FIELD_FLAGS = 1 << 8,
+    TX_EXPORT_FIELD_SOURCE_PUBLIC_KEY = 1 << 9,
+    TX_EXPORT_FIELD_DESTINATION_PUBLIC_KEY = 1 << 10,
+    TX_EXPORT_FIELD_MESSAGE = 1 << 11,
+    TX_EXPORT_FIELD_ALL = (1 << 12) - 1
+};
+
+// A packed, fixed-width view of a TariCompletedTransaction filled in bulk by completed_transactions_export.
+// The status and direction values match completed_transaction_get_status and TransactionDirection respectively.
+// The message is stored NUL terminated in the caller supplied arena at message_offset.
+struct TariCompletedTransactionRecord {
+    uint64_t tx_id;
+    uint64_t amount;
+    uint64_t fee;
+    int64_t timestamp;
+    uint64_t confirmations;
+    uint64_t mined_height;
+    int32_t status;
+    int32_t direction;
+    uint32_t message_offset;
+    uint32_t message_length;
+    uint8_t source_public_key[32];
+    uint8_t destination_public_key[32];
+    bool is_valid;
+    bool is_cancelled;
+};
+
+// All the balance figures of a TariWallet, filled in by wallet_get_balance. The time_locked_balance is 0 if the
+// chain tip is not known.
+struct TariBalance {
+    uint64_t available_balance;
+    uint64_t time_locked_balance;
+    uint64_t pending_incoming_balance;
+    uint64_t pending_outgoing_balance;
+};
+
+// The outcome of an operation started by one of the _async wallet functions, delivered by
+// wallet_drain_operation_completions. The tx_id is 0 and error_code is the error the blocking function would have set
+// if the operation failed.
+struct TariOperationCompletion {
+    uint64_t request_id;
+    uint64_t tx_id;
+    int32_t error_code;
+};
+
 struct TariPendingOutboundTransactions;
 
 struct TariPendingOutboundTransaction;
@@ -69,6 +125,14 @@ struct TariPendingInboundTransactions;
 
 struct TariPendingInboundTransaction;
 
+struct TariTransactionChanges;
+
+struct TariEventBatch;
+
+struct TariRuntimeConfig;
+
+struct TariRuntime;
+
 struct TariTransportType;
 
 struct TariSeedWords;
@@ -296,6 +360,12 @@ struct TariCompletedTransaction *completed_transactions_get_at(struct TariComple
 // Frees memory for a TariCompletedTransactions
 void completed_transactions_destroy(struct TariCompletedTransactions *transactions);
 
+// Exports up to records_len TariCompletedTransactionRecords, starting at position start, in a single call. Only the
+// fields selected by the TariTransactionExportField bitmask are filled. Messages are written to message_arena, which may
+// be null if TX_EXPORT_FIELD_MESSAGE is not selected. Returns the number of records written, which is less than
+// records_len at the end of the collection or when the message arena is full.
+unsigned int completed_transactions_export(struct TariCompletedTransactions *transactions, unsigned int start, unsigned int fields, struct TariCompletedTransactionRecord *records, unsigned int records_len, char *message_arena, unsigned int message_arena_len, int* error_out);
+
 /// -------------------------------- OutboundTransaction ------------------------------------------------------ ///
 
 // Gets the TransactionId of a TariPendingOutboundTransaction
@@ -383,6 +453,66 @@ struct TariPendingInboundTransaction *pending_inbound_transactions_get_at(struct
 // Frees memory of a TariPendingInboundTransaction
 void pending_inbound_transactions_destroy(struct TariPendingInboundTransactions *transactions);
 
+/// -------------------------------- TransactionChanges ------------------------------------------------------- ///
+
+// Gets the change sequence number of the most recent change in a TariTransactionChanges, pass it to
+// wallet_get_transaction_changes_since to get the next set of changes
+unsigned long long transaction_changes_get_sequence(struct TariTransactionChanges *changes, int* error_out);
+
+// Gets the changed TariPendingInboundTransactions, including cancelled ones, of a TariTransactionChanges
+struct TariPendingInboundTransactions *transaction_changes_get_pending_inbound(struct TariTransactionChanges *changes, int* error_out);
+
+// Gets the changed TariPendingOutboundTransactions, including cancelled ones, of a TariTransactionChanges
+struct TariPendingOutboundTransactions *transaction_changes_get_pending_outbound(struct TariTransactionChanges *changes, int* error_out);
+
+// Gets the changed TariCompletedTransactions, including cancelled ones, of a TariTransactionChanges
+struct TariCompletedTransactions *transaction_changes_get_completed(struct TariTransactionChanges *changes, int* error_out);
+
+// Frees memory for a TariTransactionChanges
+void transaction_changes_destroy(struct TariTransactionChanges *changes);
+
+/// -------------------------------- EventBatch --------------------------------------------------------------- ///
+
+// Gets the number of events in a TariEventBatch
+unsigned int event_batch_get_length(struct TariEventBatch *batch, int* error_out);
+
+// Gets the type of the event at position, which identifies the individual callback it would otherwise be delivered to
+// | Value | Interpretation                |
+// |---|---|
+// |  -1 | Error                           |
+// |   0 | ReceivedTransaction             |
+// |   1 | ReceivedTransactionReply        |
+// |   2 | ReceivedFinalizedTransaction    |
+// |   3 | TransactionBroadcast            |
+// |   4 | TransactionMined                |
+// |   5 | TransactionMinedUnconfirmed     |
+// |   6 | DirectSendResult                |
+// |   7 | StoreAndForwardSendResult       |
+// |   8 | TransactionCancellation         |
+// |   9 | UtxoValidationComplete          |
+// |  10 | StxoValidationComplete          |
+// |  11 | InvalidTxoValidationComplete    |
+// |  12 | TransactionValidationComplete   |
+// |  13 | SafMessagesReceived             |
+// |  14 | TxoValidationComplete           |
+int event_batch_get_event_type(struct TariEventBatch *batch, unsigned int position, int* error_out);
+
+// Gets the TxId, or the request key for validation events, of the event at position
+unsigned long long event_batch_get_id(struct TariEventBatch *batch, unsigned int position, int* error_out);
+
+// Gets the value of the event at position: the confirmations for TransactionMinedUnconfirmed, 1 or 0 for the send
+// results and the CallbackValidationResults value for the validation events
+unsigned long long event_batch_get_value(struct TariEventBatch *batch, unsigned int position, int* error_out);
+
+// Gets the TariCompletedTransaction of the event at position, null if the event does not carry one
+struct TariCompletedTransaction *event_batch_get_completed_transaction(struct TariEventBatch *batch, unsigned int position, int* error_out);
+
+// Gets the TariPendingInboundTransaction of the ReceivedTransaction event at position, null if the event does not carry one
+struct TariPendingInboundTransaction *event_batch_get_pending_inbound_transaction(struct TariEventBatch *batch, unsigned int position, int* error_out);
+
+// Frees memory for a TariEventBatch
+void event_batch_destroy(struct TariEventBatch *batch);
+
 /// -------------------------------- TariCommsConfig ----------------------------------------------- ///
 // Creates a TariCommsConfig
 struct TariCommsConfig *comms_config_create(const char *public_address,
@@ -396,6 +526,21 @@ struct TariCommsConfig *comms_config_create(const char *public_address,
 // Frees memory for a TariCommsConfig
 void comms_config_destroy(struct TariCommsConfig *wc);
 
+/// -------------------------------- Runtime ----------------------------------------------- //
+
+// Creates a TariRuntimeConfig, pass 0 for core_threads or max_threads to use the default. With current_thread set,
+// callbacks run on the runtime's only thread, so wallet functions must not be called from within a callback.
+struct TariRuntimeConfig *runtime_config_create(unsigned int core_threads, unsigned int max_threads, bool current_thread, int* error_out);
+
+// Frees memory for a TariRuntimeConfig
+void runtime_config_destroy(struct TariRuntimeConfig *config);
+
+// Creates a TariRuntime that can be shared by several wallets, pass a null config to use the defaults
+struct TariRuntime *runtime_create(struct TariRuntimeConfig *config, int* error_out);
+
+// Frees memory for a TariRuntime, all wallets using it must be destroyed first
+void runtime_destroy(struct TariRuntime *runtime);
+
 /// -------------------------------- TariWallet ----------------------------------------------- //
 
 /// Creates a TariWallet
@@ -411,6 +556,11 @@ void comms_config_destroy(struct TariCommsConfig *wc);
 /// `passphrase` - An optional string that represents the passphrase used to
 /// encrypt/decrypt the databases for this wallet. If it is left Null no encryption is used. If the databases have been
 /// encrypted then the correct passphrase is required or this function will fail.
+/// `seed_words` - An optional instance of TariSeedWords, used to create a wallet for recovery purposes.
+/// If this is null, then a new master key is created for the wallet.
+/// `runtime` - An optional TariRuntime created with `runtime_create` that this wallet will share with other wallets. If
+/// this is null the wallet creates and owns its own runtime. Wallets sharing a runtime and a base node poll the chain
+/// metadata of that base node only once between them.
 /// `callback_received_transaction` - The callback function pointer matching the
 /// function signature. This will be called when an inbound transaction is received.
 /// `callback_received_transaction_reply` - The callback function pointer matching the function signature. This will be
@@ -441,6 +591,16 @@ void comms_config_destroy(struct TariCommsConfig *wc);
 /// `callback_saf_message_received` - The callback function pointer that will be called when the Dht has determined that
 /// is has connected to enough of its neighbours to be confident that it has received any SAF messages that were waiting
 /// for it.
+/// `callback_events_batch` - An optional callback function pointer, pass null to use the individual callbacks above.
+/// If set, the individual callbacks are not called and the events are instead delivered together in a TariEventBatch,
+/// with repeated events of the same type for the same TxId or request key delivered only once.
+/// `events_batch_window_ms` - How long, in milliseconds, events are collected for before a batch is delivered
+/// `events_batch_max_events` - A batch is delivered as soon as it holds this many events, 0 for no limit
+/// `callback_wallet_ready` - An optional callback function pointer. If set, this function returns as soon as the
+/// databases are open and the wallet services are started in the background, the callback is then called with 0 once
+/// the wallet has started or with the error code if it failed to start. Until then the balance, transaction and contact
+/// queries are answered from the databases and every other function waits for the startup to complete. If null, this
+/// function only returns once the wallet has started.
 /// `error_out` - Pointer to an int which will be modified
 /// to an error code should one occur, may not be null. Functions as an out parameter.
 /// ## Returns
@@ -463,6 +623,7 @@ struct TariWallet *wallet_create(struct TariWalletConfig *config,
                                     unsigned int size_per_log_file_bytes,
                                     const char *passphrase,
                                     struct TariSeedWords *seed_words,
+                                    struct TariRuntime *runtime,
                                     void (*callback_received_transaction)(struct TariPendingInboundTransaction*),
                                     void (*callback_received_transaction_reply)(struct TariCompletedTransaction*),
                                     void (*callback_received_finalized_transaction)(struct TariCompletedTransaction*),
@@ -477,6 +638,10 @@ struct TariWallet *wallet_create(struct TariWalletConfig *config,
                                     void (*callback_invalid_txo_validation_complete)(unsigned long long, unsigned char),
                                     void (*callback_transaction_validation_complete)(unsigned long long, unsigned char),
                                     void (*callback_saf_message_received)(),
+                                    void (*callback_events_batch)(struct TariEventBatch*),
+                                    unsigned long long events_batch_window_ms,
+                                    unsigned int events_batch_max_events,
+                                    void (*callback_wallet_ready)(int),
                                     int* error_out);
 
 // Signs a message
@@ -506,6 +671,9 @@ unsigned long long wallet_get_pending_incoming_balance(struct TariWallet *wallet
 // Gets the outgoing balance from a TariWallet
 unsigned long long wallet_get_pending_outgoing_balance(struct TariWallet *wallet,int* error_out);
 
+// Gets all the balance figures of a TariWallet in a single call
+bool wallet_get_balance(struct TariWallet *wallet, struct TariBalance *balance_out, int* error_out);
+
 // Get a fee estimate from a TariWallet for a given amount
 unsigned long long wallet_get_fee_estimate(struct TariWallet *wallet, unsigned long long amount, unsigned long long fee_per_gram, unsigned long long num_kernels, unsigned long long num_outputs, int* error_out);
 
@@ -519,12 +687,53 @@ void wallet_set_num_confirmations_required(struct TariWallet *wallet, unsigned l
 // Sends a TariPendingOutboundTransaction
 unsigned long long wallet_send_transaction(struct TariWallet *wallet, struct TariPublicKey *destination, unsigned long long amount, unsigned long long fee_per_gram,const char *message,int* error_out);
 
+// Sends a separate TariPendingOutboundTransaction to each of num_recipients recipients, given as arrays of destinations,
+// amounts and messages. Each transaction pays its own fee. Every transaction is prepared before any is sent and they
+// are then negotiated concurrently. The TxId of each recipient's transaction is written
+// to tx_ids_out, which must have room for num_recipients values. Returns false if no transaction was sent.
+bool wallet_send_transactions(struct TariWallet *wallet, struct TariPublicKey **destinations, const unsigned long long *amounts, const char **messages, unsigned int num_recipients, unsigned long long fee_per_gram, unsigned long long *tx_ids_out, int* error_out);
+
+// The _async functions below start an operation on the wallet runtime and return its request id straight away, or 0
+// if the operation could not be started. They do not wait for a wallet that is still starting, the operation runs once
+// the startup completes and reports the startup error if the wallet failed to start. The outcome is passed to the
+// callback set with wallet_set_operation_completion_callback or, if none is set, queued for
+// wallet_drain_operation_completions.
+
+// Starts sending a TariPendingOutboundTransaction, the completion carries the TxId of the sent transaction
+unsigned long long wallet_send_transaction_async(struct TariWallet *wallet, struct TariPublicKey *destination, unsigned long long amount, unsigned long long fee_per_gram, const char *message, int* error_out);
+
+// Starts importing a UTXO into the wallet, the completion carries the TxId of the faux completed transaction
+unsigned long long wallet_import_utxo_async(struct TariWallet *wallet, unsigned long long amount, struct TariPrivateKey *spending_key, struct TariPublicKey *source_public_key, const char *message, int* error_out);
+
+// Starts cancelling a Pending Outbound Transaction, the completion carries the TxId of the cancelled transaction
+unsigned long long wallet_cancel_pending_transaction_async(struct TariWallet *wallet, unsigned long long transaction_id, int* error_out);
+
+// Starts a coin split, the completion carries the TxId of the coin split transaction
+unsigned long long wallet_coin_split_async(struct TariWallet *wallet, unsigned long long amount, unsigned long long count, unsigned long long fee, const char* msg, unsigned long long lock_height, int* error_out);
+
+// Sets the callback the outcomes of _async operations are delivered to, with the request id, TxId and error code (0 on
+// success). The callback is called on a wallet runtime thread. A null callback queues the outcomes again.
+bool wallet_set_operation_completion_callback(struct TariWallet *wallet, void (*callback_operation_completed)(unsigned long long, unsigned long long, int), int* error_out);
+
+// Moves up to completions_len queued outcomes of _async operations, oldest first, into completions and returns how many
+// were moved. If none are queued this waits up to timeout_ms for one, 0 returns immediately.
+unsigned int wallet_drain_operation_completions(struct TariWallet *wallet, struct TariOperationCompletion *completions, unsigned int completions_len, unsigned int timeout_ms, int* error_out);
+
 // Get the TariContacts from a TariWallet
 struct TariContacts *wallet_get_contacts(struct TariWallet *wallet,int* error_out);
 
 // Get the TariCompletedTransactions from a TariWallet
 struct TariCompletedTransactions *wallet_get_completed_transactions(struct TariWallet *wallet,int* error_out);
 
+// Get a filtered page of TariCompletedTransactions from a TariWallet, ordered newest first. Bit n of status_mask selects
+// the status with value n (0 selects all), direction is -1 for any, 0 Inbound, 1 Outbound or 2 Unknown, timestamps are
+// in seconds since the Unix epoch (0 for unbounded), limit is the maximum page size (0 for unlimited) and cursor_tx_id
+// is the TxId of the last transaction of the previous page (0 to start from the newest).
+struct TariCompletedTransactions *wallet_get_completed_transactions_page(struct TariWallet *wallet, unsigned int status_mask, int direction, long long from_timestamp, long long to_timestamp, unsigned int limit, unsigned long long cursor_tx_id, int* error_out);
+
+// Get the transactions that were inserted, updated or cancelled after the given change sequence number (0 for all)
+struct TariTransactionChanges *wallet_get_transaction_changes_since(struct TariWallet *wallet, unsigned long long sequence, int* error_out);
+
 // Get the TariPendingOutboundTransactions from a TariWallet
 struct TariPendingOutboundTransactions *wallet_get_pending_outbound_transactions(struct TariWallet *wallet,int* error_out);
 
@@ -565,6 +774,10 @@ unsigned long long wallet_start_stxo_validation(struct TariWallet *wallet, int*
 // This function will tell the wallet to query the set base node to confirm the status of invalid transaction outputs.
 unsigned long long wallet_start_invalid_txo_validation(struct TariWallet *wallet, int* error_out);
 
+// This function will tell the wallet to query the set base node to confirm the status of all of its transaction
+// outputs in a single validation, the result is reported through the utxo validation complete callback
+unsigned long long wallet_start_txo_validation(struct TariWallet *wallet, int* error_out);
+
 //This function will tell the wallet to query the set base node to confirm the status of mined transactions.
 unsigned long long wallet_start_transaction_validation(struct TariWallet *wallet, int* error_out);
 
@@ -607,6 +820,18 @@ void wallet_apply_encryption(struct TariWallet *wallet, const char *passphrase,
 // be removed. If it is not encrypted then this function will still succeed to make the operation idempotent
 void wallet_remove_encryption(struct TariWallet *wallet, int* error_out);
 
+// Apply encryption to the databases used in this wallet in the background. `callback_progress` is called with the
+// number of rows processed and the total after every batch, `callback_completed` is called once with 0 on success or
+// the error code of the failure. An interrupted process is completed when the wallet is next started, which requires
+// the passphrase.
+bool wallet_apply_encryption_with_progress(struct TariWallet *wallet, const char *passphrase, void (*callback_progress)(unsigned long long, unsigned long long), void (*callback_completed)(int), int* error_out);
+
+// Remove encryption from the databases used in this wallet in the background. `callback_progress` is called with the
+// number of rows processed and the total after every batch, `callback_completed` is called once with 0 on success or
+// the error code of the failure. An interrupted process is completed when the wallet is next started, which requires
+// the passphrase. The wallet is then no longer encrypted.
+bool wallet_remove_encryption_with_progress(struct TariWallet *wallet, void (*callback_progress)(unsigned long long, unsigned long long), void (*callback_completed)(int), int* error_out);
+
 /// Set a Key Value in the Wallet storage used for Client Key Value store
 ///
 /// ## Arguments
@@ -695,6 +920,10 @@ bool wallet_is_recovery_in_progress(struct TariWallet *wallet, int* error_out);
 /// None
 bool wallet_start_recovery(struct TariWallet *wallet, struct TariPublicKey *base_node_public_key, void (*recovery_progress_callback)(unsigned long long, unsigned long long), int* error_out);
 
+// Gets the current value of the wallet metrics in the Prometheus text exposition format, the metrics are shared by
+// every wallet in the process. The string_destroy function must be called when finished with the string.
+const char *wallet_get_metrics_snapshot(struct TariWallet *wallet, int* error_out);
+
 // Frees memory for a TariWallet
 void wallet_destroy(struct TariWallet *wallet);
 
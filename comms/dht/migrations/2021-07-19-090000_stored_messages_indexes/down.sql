@@ -0,0 +1,8 @@
+DROP INDEX idx_stored_messages_destination_pubkey_type;
+DROP INDEX idx_stored_messages_destination_node_id_type;
+DROP INDEX idx_stored_messages_message_type;
+DROP INDEX idx_stored_messages_priority_stored_at;
+
+CREATE INDEX idx_stored_messages_destination_pubkey ON stored_messages (destination_pubkey);
+CREATE INDEX idx_stored_messages_destination_node_id ON stored_messages (destination_node_id);
+CREATE INDEX idx_stored_messages_priority ON stored_messages (priority);
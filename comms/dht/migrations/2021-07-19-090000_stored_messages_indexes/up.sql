@@ -0,0 +1,10 @@
+-- Indexes that cover the destination and message type filters of the retrieval queries and the priority and age
+-- ordering used to enforce the storage budget
+DROP INDEX idx_stored_messages_destination_pubkey;
+DROP INDEX idx_stored_messages_destination_node_id;
+DROP INDEX idx_stored_messages_priority;
+
+CREATE INDEX idx_stored_messages_destination_pubkey_type ON stored_messages (destination_pubkey, message_type);
+CREATE INDEX idx_stored_messages_destination_node_id_type ON stored_messages (destination_node_id, message_type);
+CREATE INDEX idx_stored_messages_message_type ON stored_messages (message_type);
+CREATE INDEX idx_stored_messages_priority_stored_at ON stored_messages (priority, stored_at);
@@ -29,6 +29,7 @@
 
 use crate::{
     broadcast_strategy::BroadcastStrategy,
+    dedup::DedupCache,
     discovery::DhtDiscoveryError,
     outbound::{DhtOutboundError, OutboundMessageRequester, SendMessageParams},
     proto::{dht::JoinMessage, envelope::DhtMessageType},
@@ -54,7 +55,6 @@ use tari_shutdown::ShutdownSignal;
 use tari_utilities::message_format::{MessageFormat, MessageFormatError};
 use thiserror::Error;
 use tokio::task;
-use ttl_cache::TtlCache;
 
 const LOG_TARGET: &str = "comms::dht::actor";
 
@@ -103,6 +103,9 @@ pub enum DhtRequest {
     /// Inserts a message signature to the msg hash cache. This operation replies with a boolean
     /// which is true if the signature already exists in the cache, otherwise false
     MsgHashCacheInsert(Vec<u8>, oneshot::Sender<bool>),
+    /// Inserts a batch of message signatures to the msg hash cache. This operation replies with a boolean for each
+    /// signature, in the same order, which is true if the signature already existed in the cache
+    MsgHashCacheInsertBatch(Vec<Vec<u8>>, oneshot::Sender<Vec<bool>>),
     /// Fetch selected peers according to the broadcast strategy
     SelectPeers(BroadcastStrategy, oneshot::Sender<Vec<NodeId>>),
     GetMetadata(DhtMetadataKey, oneshot::Sender<Result<Option<Vec<u8>>, DhtActorError>>),
@@ -115,6 +118,7 @@ impl Display for DhtRequest {
         match self {
             SendJoin => f.write_str("SendJoin"),
             MsgHashCacheInsert(_, _) => f.write_str("MsgHashCacheInsert"),
+            MsgHashCacheInsertBatch(hashes, _) => write!(f, "MsgHashCacheInsertBatch ({} hashes)", hashes.len()),
             SelectPeers(s, _) => f.write_str(&format!("SelectPeers (Strategy={})", s)),
             GetMetadata(key, _) => f.write_str(&format!("GetMetadata (key={})", key)),
             SetMetadata(key, value, _) => {
@@ -155,6 +159,17 @@ impl DhtRequester {
         reply_rx.await.map_err(|_| DhtActorError::ReplyCanceled)
     }
 
+    /// Inserts all the signatures into the msg hash cache in a single request. Returns, for each signature in order,
+    /// true if it was already in the cache.
+    pub async fn insert_message_hashes(&mut self, signatures: Vec<Vec<u8>>) -> Result<Vec<bool>, DhtActorError> {
+        let (reply_tx, reply_rx) = oneshot::channel();
+        self.sender
+            .send(DhtRequest::MsgHashCacheInsertBatch(signatures, reply_tx))
+            .await?;
+
+        reply_rx.await.map_err(|_| DhtActorError::ReplyCanceled)
+    }
+
     pub async fn get_metadata<T: MessageFormat>(&mut self, key: DhtMetadataKey) -> Result<Option<T>, DhtActorError> {
         let (reply_tx, reply_rx) = oneshot::channel();
         self.sender.send(DhtRequest::GetMetadata(key, reply_tx)).await?;
@@ -183,7 +198,7 @@ pub struct DhtActor {
     config: DhtConfig,
     shutdown_signal: Option<ShutdownSignal>,
     request_rx: Fuse<mpsc::Receiver<DhtRequest>>,
-    msg_hash_cache: TtlCache<Vec<u8>, ()>,
+    msg_hash_cache: Arc<DedupCache>,
 }
 
 impl DhtActor {
@@ -196,10 +211,11 @@ impl DhtActor {
         connectivity: ConnectivityRequester,
         outbound_requester: OutboundMessageRequester,
         request_rx: mpsc::Receiver<DhtRequest>,
+        msg_hash_cache: Arc<DedupCache>,
         shutdown_signal: ShutdownSignal,
     ) -> Self {
         Self {
-            msg_hash_cache: TtlCache::new(config.msg_hash_cache_capacity),
+            msg_hash_cache,
             config,
             database: DhtDatabase::new(conn),
             outbound_requester,
@@ -282,12 +298,13 @@ impl DhtActor {
                 Box::pin(Self::broadcast_join(node_identity, outbound_requester))
             },
             MsgHashCacheInsert(hash, reply_tx) => {
-                // No locks needed here. Downside is this isn't really async, however this should be
-                // fine as it is very quick
-                let already_exists = self
-                    .msg_hash_cache
-                    .insert(hash, (), self.config.msg_hash_cache_ttl)
-                    .is_some();
+                // The cache is shared with the inbound dedup middleware and each insert only briefly locks one shard
+                let already_exists = self.msg_hash_cache.insert(hash);
+                let result = reply_tx.send(already_exists).map_err(|_| DhtActorError::ReplyCanceled);
+                Box::pin(future::ready(result))
+            },
+            MsgHashCacheInsertBatch(hashes, reply_tx) => {
+                let already_exists = self.msg_hash_cache.insert_many(hashes);
                 let result = reply_tx.send(already_exists).map_err(|_| DhtActorError::ReplyCanceled);
                 Box::pin(future::ready(result))
             },
@@ -643,10 +660,15 @@ mod test {
         test_utils::{build_peer_manager, make_client_identity, make_node_identity},
     };
     use chrono::{DateTime, Utc};
+    use std::time::Duration;
     use tari_comms::test_utils::mocks::{create_connectivity_mock, create_peer_connection_mock_pair};
     use tari_shutdown::Shutdown;
     use tari_test_utils::random;
 
+    fn dedup_cache() -> Arc<DedupCache> {
+        Arc::new(DedupCache::new(100, Duration::from_secs(60)))
+    }
+
     async fn db_connection() -> DbConnection {
         let conn = DbConnection::connect_memory(random::string(8)).await.unwrap();
         conn.migrate().await.unwrap();
@@ -672,6 +694,7 @@ mod test {
             connectivity_manager,
             outbound_requester,
             actor_rx,
+            dedup_cache(),
             shutdown.to_signal(),
         );
 
@@ -701,6 +724,7 @@ mod test {
             connectivity_manager,
             outbound_requester,
             actor_rx,
+            dedup_cache(),
             shutdown.to_signal(),
         );
 
@@ -713,6 +737,12 @@ mod test {
         assert!(is_dup);
         let is_dup = requester.insert_message_hash(Vec::new()).await.unwrap();
         assert!(!is_dup);
+
+        let is_dup = requester
+            .insert_message_hashes(vec![vec![1u8, 2, 3], vec![4u8], vec![4u8]])
+            .await
+            .unwrap();
+        assert_eq!(is_dup, vec![true, false, true]);
     }
 
     #[tokio_macros::test_basic]
@@ -746,6 +776,7 @@ mod test {
             connectivity_manager,
             outbound_requester,
             actor_rx,
+            dedup_cache(),
             shutdown.to_signal(),
         );
 
@@ -822,6 +853,7 @@ mod test {
             connectivity_manager,
             outbound_requester,
             actor_rx,
+            dedup_cache(),
             shutdown.to_signal(),
         );
 
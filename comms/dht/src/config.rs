@@ -46,7 +46,8 @@ pub struct DhtConfig {
     /// expired or not when processing the message
     /// Default: 10800
     pub saf_msg_validity: Duration,
-    /// The maximum number of messages that can be stored using the Store-and-forward middleware.
+    /// The maximum number of messages that can be stored using the Store-and-forward middleware. The lowest priority
+    /// and then oldest messages are removed once the capacity is exceeded.
     /// Default: 100,000
     pub saf_msg_storage_capacity: usize,
     /// A request to retrieve stored messages will be ignored if the requesting node is
@@ -54,8 +55,12 @@ pub struct DhtConfig {
     /// Default 8
     pub saf_num_closest_nodes: usize,
     /// The maximum number of messages to return from a store and forward retrieval request.
-    /// Default: 100
+    /// Default: 500
     pub saf_max_returned_messages: usize,
+    /// The maximum number of messages in each response to a store and forward retrieval request, a request for more
+    /// messages is answered with several responses.
+    /// Default: 50
+    pub saf_response_page_size: usize,
     /// The time-to-live duration used for storage of low priority messages by the Store-and-forward middleware.
     /// Default: 6 hours
     pub saf_low_priority_msg_storage_ttl: Duration,
@@ -148,7 +153,8 @@ impl Default for DhtConfig {
             broadcast_factor: 8,
             outbound_buffer_size: 20,
             saf_num_closest_nodes: 10,
-            saf_max_returned_messages: 50,
+            saf_max_returned_messages: 500,
+            saf_response_page_size: 50,
             saf_msg_storage_capacity: 100_000,
             saf_low_priority_msg_storage_ttl: Duration::from_secs(6 * 60 * 60), // 6 hours
             saf_high_priority_msg_storage_ttl: Duration::from_secs(3 * 24 * 60 * 60), // 3 days
@@ -0,0 +1,206 @@
+// Copyright 2021, The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use std::{
+    collections::{hash_map::DefaultHasher, HashSet},
+    hash::{Hash, Hasher},
+    mem,
+    sync::Mutex,
+    time::{Duration, Instant},
+};
+
+/// The number of independently locked shards. Concurrent inserts only contend when their hashes fall in the same
+/// shard, so this should comfortably exceed the number of cores processing inbound messages.
+const NUM_SHARDS: usize = 32;
+
+/// # Message hash dedup cache
+///
+/// A concurrent set of recently seen message hashes, shared by the inbound dedup middleware and the DHT actor. Hashes
+/// are spread over a number of shards, each behind its own short-lived lock, so that checking a message never waits
+/// on an actor or on messages in other shards.
+///
+/// Each shard keeps two time buckets, `current` and `previous`, which are rotated every `ttl`. A hash is therefore
+/// remembered for at least `ttl` and at most twice that, unless the shard reaches its share of the capacity first, in
+/// which case it rotates early.
+pub struct DedupCache {
+    shards: Vec<Mutex<Shard>>,
+    ttl: Duration,
+    shard_capacity: usize,
+}
+
+impl DedupCache {
+    /// Create a cache that holds approximately `capacity` hashes, each for at least `ttl`.
+    pub fn new(capacity: usize, ttl: Duration) -> Self {
+        let now = Instant::now();
+        Self {
+            shards: (0..NUM_SHARDS).map(|_| Mutex::new(Shard::new(now))).collect(),
+            ttl,
+            // Two buckets per shard
+            shard_capacity: (capacity / (NUM_SHARDS * 2)).max(1),
+        }
+    }
+
+    /// Inserts the message hash into the cache, refreshing it if it is already present. Returns true if the hash was
+    /// already present i.e. the message is a duplicate.
+    pub fn insert(&self, hash: Vec<u8>) -> bool {
+        let now = Instant::now();
+        let mut shard = acquire_lock!(self.shard_for(&hash));
+        shard.expire(now, self.ttl);
+        shard.insert(hash, now, self.shard_capacity)
+    }
+
+    /// Inserts each message hash into the cache. Returns, for each hash in order, true if it was already present.
+    pub fn insert_many<I: IntoIterator<Item = Vec<u8>>>(&self, hashes: I) -> Vec<bool> {
+        hashes.into_iter().map(|hash| self.insert(hash)).collect()
+    }
+
+    /// Returns true if the message hash is present in the cache
+    pub fn contains(&self, hash: &[u8]) -> bool {
+        let mut shard = acquire_lock!(self.shard_for(hash));
+        shard.expire(Instant::now(), self.ttl);
+        shard.contains(hash)
+    }
+
+    /// Returns the number of hashes currently held in the cache. This includes hashes that have outlived the ttl but
+    /// whose bucket has not been rotated out yet.
+    pub fn len(&self) -> usize {
+        self.shards.iter().map(|shard| acquire_lock!(shard).len()).sum()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    fn shard_for(&self, hash: &[u8]) -> &Mutex<Shard> {
+        let mut hasher = DefaultHasher::new();
+        hash.hash(&mut hasher);
+        &self.shards[hasher.finish() as usize % self.shards.len()]
+    }
+}
+
+struct Shard {
+    current: HashSet<Vec<u8>>,
+    previous: HashSet<Vec<u8>>,
+    rotated_at: Instant,
+}
+
+impl Shard {
+    fn new(now: Instant) -> Self {
+        Self {
+            current: HashSet::new(),
+            previous: HashSet::new(),
+            rotated_at: now,
+        }
+    }
+
+    fn expire(&mut self, now: Instant, ttl: Duration) {
+        let elapsed = now.saturating_duration_since(self.rotated_at);
+        if elapsed >= ttl * 2 {
+            self.current.clear();
+            self.previous.clear();
+            self.rotated_at = now;
+        } else if elapsed >= ttl {
+            self.rotate(now);
+        }
+    }
+
+    fn rotate(&mut self, now: Instant) {
+        self.previous = mem::take(&mut self.current);
+        self.rotated_at = now;
+    }
+
+    fn insert(&mut self, hash: Vec<u8>, now: Instant, capacity: usize) -> bool {
+        if self.current.contains(&hash) {
+            return true;
+        }
+        let exists = self.previous.remove(&hash);
+        if self.current.len() >= capacity {
+            self.rotate(now);
+        }
+        self.current.insert(hash);
+        exists
+    }
+
+    fn contains(&self, hash: &[u8]) -> bool {
+        self.current.contains(hash) || self.previous.contains(hash)
+    }
+
+    fn len(&self) -> usize {
+        self.current.len() + self.previous.len()
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::{sync::Arc, thread};
+
+    #[test]
+    fn insert_and_contains() {
+        let cache = DedupCache::new(1000, Duration::from_secs(60));
+        assert!(cache.is_empty());
+        assert!(!cache.insert(vec![1]));
+        assert!(cache.insert(vec![1]));
+        assert!(cache.contains(&[1]));
+        assert!(!cache.contains(&[2]));
+        assert_eq!(
+            cache.insert_many(vec![vec![2], vec![1], vec![2]]),
+            vec![false, true, true]
+        );
+        assert_eq!(cache.len(), 2);
+    }
+
+    #[test]
+    fn expires_after_ttl() {
+        let cache = DedupCache::new(1000, Duration::from_millis(10));
+        assert!(!cache.insert(vec![1]));
+        thread::sleep(Duration::from_millis(25));
+        assert!(!cache.contains(&[1]));
+        assert!(!cache.insert(vec![1]));
+    }
+
+    #[test]
+    fn bounded_by_capacity() {
+        let cache = DedupCache::new(NUM_SHARDS * 2 * 10, Duration::from_secs(60));
+        for i in 0..10_000u32 {
+            cache.insert(i.to_le_bytes().to_vec());
+        }
+        assert!(cache.len() <= NUM_SHARDS * 2 * 10);
+        // The most recent hashes are always retained
+        assert!(cache.contains(&9_999u32.to_le_bytes()));
+    }
+
+    #[test]
+    fn concurrent_inserts() {
+        let cache = Arc::new(DedupCache::new(100_000, Duration::from_secs(60)));
+        let handles = (0..4)
+            .map(|_| {
+                let cache = cache.clone();
+                thread::spawn(move || (0..1000u32).filter(|i| !cache.insert(i.to_le_bytes().to_vec())).count())
+            })
+            .collect::<Vec<_>>();
+        let num_new = handles.into_iter().map(|h| h.join().unwrap()).sum::<usize>();
+        // Each hash is new to exactly one of the threads
+        assert_eq!(num_new, 1000);
+        assert_eq!(cache.len(), 1000);
+    }
+}
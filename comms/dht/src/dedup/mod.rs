@@ -20,11 +20,18 @@
 // WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-use crate::{actor::DhtRequester, inbound::DhtInboundMessage};
+mod cache;
+pub use cache::DedupCache;
+
+use crate::inbound::DhtInboundMessage;
 use digest::Digest;
-use futures::{future::BoxFuture, task::Context};
+use futures::{
+    future::{self, BoxFuture},
+    task::Context,
+    FutureExt,
+};
 use log::*;
-use std::task::Poll;
+use std::{sync::Arc, task::Poll};
 use tari_comms::{pipeline::PipelineError, types::Challenge};
 use tari_utilities::hex::Hex;
 use tower::{layer::Layer, Service, ServiceExt};
@@ -37,19 +44,20 @@ fn hash_inbound_message(message: &DhtInboundMessage) -> Vec<u8> {
 
 /// # DHT Deduplication middleware
 ///
-/// Takes in a `DhtInboundMessage` and checks the message signature cache for duplicates.
-/// If a duplicate message is detected, it is discarded.
+/// Takes in a `DhtInboundMessage` and checks the shared message hash cache for duplicates.
+/// If a duplicate message is detected, it is discarded. The check is made inline, without a round trip to the DHT
+/// actor.
 #[derive(Clone)]
 pub struct DedupMiddleware<S> {
     next_service: S,
-    dht_requester: DhtRequester,
+    dedup_cache: Arc<DedupCache>,
 }
 
 impl<S> DedupMiddleware<S> {
-    pub fn new(service: S, dht_requester: DhtRequester) -> Self {
+    pub fn new(service: S, dedup_cache: Arc<DedupCache>) -> Self {
         Self {
             next_service: service,
-            dht_requester,
+            dedup_cache,
         }
     }
 }
@@ -68,46 +76,42 @@ where
     }
 
     fn call(&mut self, message: DhtInboundMessage) -> Self::Future {
-        let next_service = self.next_service.clone();
-        let mut dht_requester = self.dht_requester.clone();
-        Box::pin(async move {
-            let hash = hash_inbound_message(&message);
+        let hash = hash_inbound_message(&message);
+        trace!(
+            target: LOG_TARGET,
+            "Inserting message hash {} for message {} (Trace: {})",
+            hash.to_hex(),
+            message.tag,
+            message.dht_header.message_tag
+        );
+        if self.dedup_cache.insert(hash) {
             trace!(
                 target: LOG_TARGET,
-                "Inserting message hash {} for message {} (Trace: {})",
-                hash.to_hex(),
+                "Received duplicate message {} from peer '{}' (Trace: {}). Message discarded.",
                 message.tag,
-                message.dht_header.message_tag
+                message.source_peer.node_id.short_str(),
+                message.dht_header.message_tag,
             );
-            if dht_requester.insert_message_hash(hash).await? {
-                trace!(
-                    target: LOG_TARGET,
-                    "Received duplicate message {} from peer '{}' (Trace: {}). Message discarded.",
-                    message.tag,
-                    message.source_peer.node_id.short_str(),
-                    message.dht_header.message_tag,
-                );
-                return Ok(());
-            }
+            return Box::pin(future::ready(Ok(())));
+        }
 
-            trace!(
-                target: LOG_TARGET,
-                "Passing message {} onto next service (Trace: {})",
-                message.tag,
-                message.dht_header.message_tag
-            );
-            next_service.oneshot(message).await
-        })
+        trace!(
+            target: LOG_TARGET,
+            "Passing message {} onto next service (Trace: {})",
+            message.tag,
+            message.dht_header.message_tag
+        );
+        self.next_service.clone().oneshot(message).boxed()
     }
 }
 
 pub struct DedupLayer {
-    dht_requester: DhtRequester,
+    dedup_cache: Arc<DedupCache>,
 }
 
 impl DedupLayer {
-    pub fn new(dht_requester: DhtRequester) -> Self {
-        Self { dht_requester }
+    pub fn new(dedup_cache: Arc<DedupCache>) -> Self {
+        Self { dedup_cache }
     }
 }
 
@@ -115,7 +119,7 @@ impl<S> Layer<S> for DedupLayer {
     type Service = DedupMiddleware<S>;
 
     fn layer(&self, service: S) -> Self::Service {
-        DedupMiddleware::new(service, self.dht_requester.clone())
+        DedupMiddleware::new(service, self.dedup_cache.clone())
     }
 }
 
@@ -124,8 +128,9 @@ mod test {
     use super::*;
     use crate::{
         envelope::DhtMessageFlags,
-        test_utils::{create_dht_actor_mock, make_dht_inbound_message, make_node_identity, service_spy},
+        test_utils::{make_dht_inbound_message, make_node_identity, service_spy},
     };
+    use std::time::Duration;
     use tari_test_utils::panic_context;
     use tokio::runtime::Runtime;
 
@@ -134,12 +139,8 @@ mod test {
         let mut rt = Runtime::new().unwrap();
         let spy = service_spy();
 
-        let (dht_requester, mock) = create_dht_actor_mock(1);
-        let mock_state = mock.get_shared_state();
-        mock_state.set_signature_cache_insert(false);
-        rt.spawn(mock.run());
-
-        let mut dedup = DedupLayer::new(dht_requester).layer(spy.to_service::<PipelineError>());
+        let dedup_cache = Arc::new(DedupCache::new(100, Duration::from_secs(60)));
+        let mut dedup = DedupLayer::new(dedup_cache.clone()).layer(spy.to_service::<PipelineError>());
 
         panic_context!(cx);
 
@@ -149,12 +150,10 @@ mod test {
 
         rt.block_on(dedup.call(msg.clone())).unwrap();
         assert_eq!(spy.call_count(), 1);
+        assert!(dedup_cache.contains(&hash_inbound_message(&msg)));
 
-        mock_state.set_signature_cache_insert(true);
         rt.block_on(dedup.call(msg)).unwrap();
         assert_eq!(spy.call_count(), 1);
-        // Drop dedup so that the DhtMock will stop running
-        drop(dedup);
     }
 
     #[test]
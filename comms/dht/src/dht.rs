@@ -24,6 +24,7 @@ use self::outbound::OutboundMessageRequester;
 use crate::{
     actor::{DhtActor, DhtRequest, DhtRequester},
     connectivity::{DhtConnectivity, MetricsCollector, MetricsCollectorHandle},
+    dedup::DedupCache,
     discovery::{DhtDiscoveryRequest, DhtDiscoveryRequester, DhtDiscoveryService},
     event::{DhtEventReceiver, DhtEventSender},
     inbound,
@@ -99,6 +100,8 @@ pub struct Dht {
     event_publisher: DhtEventSender,
     /// Used by MetricsLayer to collect metrics and to inform heuristics for peer banning
     metrics_collector: MetricsCollectorHandle,
+    /// Recently seen message hashes, shared by the DedupLayer and the DHT actor
+    dedup_cache: Arc<DedupCache>,
 }
 
 impl Dht {
@@ -117,6 +120,10 @@ impl Dht {
         let (event_publisher, _) = broadcast::channel(DHT_EVENT_BROADCAST_CHANNEL_SIZE);
 
         let metrics_collector = MetricsCollector::spawn();
+        let dedup_cache = Arc::new(DedupCache::new(
+            config.msg_hash_cache_capacity,
+            config.msg_hash_cache_ttl,
+        ));
 
         let dht = Self {
             node_identity,
@@ -130,6 +137,7 @@ impl Dht {
             connectivity,
             discovery_sender,
             event_publisher: event_publisher.clone(),
+            dedup_cache,
         };
 
         let conn = DbConnection::connect_and_migrate(dht.config.database_url.clone())
@@ -173,6 +181,7 @@ impl Dht {
             self.connectivity.clone(),
             self.outbound_requester(),
             request_receiver,
+            self.dedup_cache.clone(),
             shutdown_signal,
         )
     }
@@ -290,7 +299,7 @@ impl Dht {
         ServiceBuilder::new()
             .layer(MetricsLayer::new(self.metrics_collector.clone()))
             .layer(inbound::DeserializeLayer::new(self.peer_manager.clone()))
-            .layer(DedupLayer::new(self.dht_requester()))
+            .layer(DedupLayer::new(self.dedup_cache.clone()))
             .layer(tower_filter::FilterLayer::new(self.unsupported_saf_messages_filter()))
             .layer(MessageLoggingLayer::new(format!(
                 "Inbound [{}]",
@@ -151,7 +151,7 @@ mod storage;
 pub use storage::DbConnectionUrl;
 
 mod dedup;
-pub use dedup::DedupLayer;
+pub use dedup::{DedupCache, DedupLayer};
 
 mod logging_middleware;
 mod proto;
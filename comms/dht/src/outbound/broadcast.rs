@@ -28,7 +28,7 @@ use crate::{
     discovery::DhtDiscoveryRequester,
     envelope::{datetime_to_timestamp, DhtMessageFlags, DhtMessageHeader, NodeDestination},
     outbound::{
-        message::{DhtOutboundMessage, OutboundEncryption, SendFailure},
+        message::{DhtOutboundMessage, OutboundEncryption, SendFailure, SharedEnvelope},
         message_params::FinalSendMessageParams,
         message_send_state::MessageSendState,
         SendMessageResponse,
@@ -420,6 +420,13 @@ where S: Service<DhtOutboundMessage, Response = (), Error = PipelineError>
             self.add_to_dedup_cache(&body).await?;
         }
 
+        // The messages only differ by recipient, so the envelope is serialized once and shared between them
+        let shared_envelope = if selected_peers.len() > 1 {
+            Some(SharedEnvelope::new(MessageTag::new()))
+        } else {
+            None
+        };
+
         // Construct a DhtOutboundMessage for each recipient
         let messages = selected_peers.into_iter().map(|node_id| {
             let (reply_tx, reply_rx) = oneshot::channel();
@@ -439,6 +446,7 @@ where S: Service<DhtOutboundMessage, Response = (), Error = PipelineError>
                     origin_mac: origin_mac.clone(),
                     is_broadcast,
                     expires: expires.map(datetime_to_timestamp),
+                    shared_envelope: shared_envelope.clone(),
                 },
                 send_state,
             )
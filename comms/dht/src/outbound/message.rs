@@ -26,7 +26,11 @@ use crate::{
 };
 use bytes::Bytes;
 use futures::channel::oneshot;
-use std::{fmt, fmt::Display, sync::Arc};
+use std::{
+    fmt,
+    fmt::Display,
+    sync::{Arc, Mutex},
+};
 use tari_comms::{
     message::{MessageTag, MessagingReplyTx},
     peer_manager::NodeId,
@@ -151,6 +155,37 @@ impl fmt::Display for DhtOutboundRequest {
     }
 }
 
+/// The serialized envelope shared by every `DhtOutboundMessage` generated for a single send request. Apart from the
+/// destination peer these messages are identical, so the first message to reach the `SerializeLayer` serializes the
+/// envelope and the rest reuse the same bytes.
+#[derive(Debug, Clone)]
+pub struct SharedEnvelope {
+    tag: MessageTag,
+    encoded: Arc<Mutex<Option<Bytes>>>,
+}
+
+impl SharedEnvelope {
+    /// Create a new, not yet serialized, envelope. `tag` is used as the trace tag in the DHT header in place of the
+    /// per-peer message tags.
+    pub fn new(tag: MessageTag) -> Self {
+        Self {
+            tag,
+            encoded: Arc::new(Mutex::new(None)),
+        }
+    }
+
+    pub fn tag(&self) -> MessageTag {
+        self.tag
+    }
+
+    /// Returns the serialized envelope, calling `serialize` if it has not been serialized yet
+    pub fn get_or_serialize<F>(&self, serialize: F) -> Bytes
+    where F: FnOnce() -> Bytes {
+        let mut encoded = acquire_lock!(self.encoded);
+        encoded.get_or_insert_with(serialize).clone()
+    }
+}
+
 /// DhtOutboundMessage consists of the DHT and comms information required to
 /// send a message
 #[derive(Debug)]
@@ -167,6 +202,9 @@ pub struct DhtOutboundMessage {
     pub dht_flags: DhtMessageFlags,
     pub is_broadcast: bool,
     pub expires: Option<prost_types::Timestamp>,
+    /// Set when this message is one of many generated for a single send request, in which case the envelope is only
+    /// serialized once for all of them
+    pub shared_envelope: Option<SharedEnvelope>,
 }
 
 impl fmt::Display for DhtOutboundMessage {
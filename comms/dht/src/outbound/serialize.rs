@@ -77,6 +77,7 @@ where
             origin_mac,
             reply,
             expires,
+            shared_envelope,
             ..
         } = message;
         trace!(
@@ -85,20 +86,27 @@ where
             message.tag,
             destination_node_id.short_str()
         );
-        let dht_header = custom_header.map(DhtHeader::from).unwrap_or_else(|| DhtHeader {
-            major: DHT_MAJOR_VERSION,
-            minor: DHT_MINOR_VERSION,
-            origin_mac: origin_mac.map(|b| b.to_vec()).unwrap_or_else(Vec::new),
-            ephemeral_public_key: ephemeral_public_key.map(|e| e.to_vec()).unwrap_or_else(Vec::new),
-            message_type: dht_message_type as i32,
-            flags: dht_flags.bits(),
-            destination: Some(destination.into()),
-            message_tag: tag.as_value(),
-            expires,
-        });
-        let envelope = DhtEnvelope::new(dht_header, body);
-
-        let body = Bytes::from(envelope.to_encoded_bytes());
+        let header_tag = shared_envelope.as_ref().map(|e| e.tag()).unwrap_or(tag);
+        let serialize = move || {
+            let dht_header = custom_header.map(DhtHeader::from).unwrap_or_else(|| DhtHeader {
+                major: DHT_MAJOR_VERSION,
+                minor: DHT_MINOR_VERSION,
+                origin_mac: origin_mac.map(|b| b.to_vec()).unwrap_or_else(Vec::new),
+                ephemeral_public_key: ephemeral_public_key.map(|e| e.to_vec()).unwrap_or_else(Vec::new),
+                message_type: dht_message_type as i32,
+                flags: dht_flags.bits(),
+                destination: Some(destination.into()),
+                message_tag: header_tag.as_value(),
+                expires,
+            });
+            let envelope = DhtEnvelope::new(dht_header, body);
+            Bytes::from(envelope.to_encoded_bytes())
+        };
+
+        let body = match shared_envelope {
+            Some(shared_envelope) => shared_envelope.get_or_serialize(serialize),
+            None => serialize(),
+        };
 
         trace!(
             target: LOG_TARGET,
@@ -135,9 +143,12 @@ impl<S> Layer<S> for SerializeLayer {
 #[cfg(test)]
 mod test {
     use super::*;
-    use crate::test_utils::{assert_send_static_service, create_outbound_message, service_spy};
+    use crate::{
+        outbound::message::SharedEnvelope,
+        test_utils::{assert_send_static_service, create_outbound_message, service_spy},
+    };
     use prost::Message;
-    use tari_comms::peer_manager::NodeId;
+    use tari_comms::{message::MessageTag, peer_manager::NodeId};
 
     #[tokio_macros::test_basic]
     async fn serialize() {
@@ -155,4 +166,26 @@ mod test {
         assert_eq!(dht_envelope.body, b"A".to_vec());
         assert_eq!(msg.peer_node_id, NodeId::default());
     }
+
+    #[tokio_macros::test_basic]
+    async fn serialize_shared_envelope_once() {
+        let spy = service_spy();
+        let mut serialize = SerializeLayer.layer(spy.to_service::<PipelineError>());
+
+        let shared_envelope = SharedEnvelope::new(MessageTag::new());
+        let mut msg1 = create_outbound_message(b"A");
+        msg1.shared_envelope = Some(shared_envelope.clone());
+        let mut msg2 = create_outbound_message(b"A");
+        msg2.shared_envelope = Some(shared_envelope.clone());
+
+        serialize.ready_and().await.unwrap().call(msg1).await.unwrap();
+        serialize.ready_and().await.unwrap().call(msg2).await.unwrap();
+        let mut requests = spy.take_requests();
+        assert_eq!(requests.len(), 2);
+        // Both messages share the same serialized bytes
+        assert_eq!(requests[0].body.as_ptr(), requests[1].body.as_ptr());
+        let dht_envelope = DhtEnvelope::decode(&mut requests[0].body).unwrap();
+        assert_eq!(dht_envelope.header.unwrap().message_tag, shared_envelope.tag().as_value());
+        assert_eq!(dht_envelope.body, b"A".to_vec());
+    }
 }
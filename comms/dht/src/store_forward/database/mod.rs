@@ -73,11 +73,14 @@ impl StoreAndForwardDatabase {
             .await
     }
 
+    /// The find functions return the newest messages first. A result set larger than `limit` is paged through by
+    /// passing the id of the last message of the previous page as `before_id`.
     pub async fn find_messages_for_peer(
         &self,
         public_key: &CommsPublicKey,
         node_id: &NodeId,
         since: Option<DateTime<Utc>>,
+        before_id: Option<i32>,
         limit: i64,
     ) -> Result<Vec<StoredMessage>, StorageError> {
         let pk_hex = public_key.to_hex();
@@ -97,9 +100,12 @@ impl StoreAndForwardDatabase {
                 if let Some(since) = since {
                     query = query.filter(stored_messages::stored_at.gt(since.naive_utc()));
                 }
+                if let Some(before_id) = before_id {
+                    query = query.filter(stored_messages::id.lt(before_id));
+                }
 
                 query
-                    .order_by(stored_messages::stored_at.desc())
+                    .order_by(stored_messages::id.desc())
                     .limit(limit)
                     .get_results(conn)
                     .map_err(Into::into)
@@ -110,6 +116,7 @@ impl StoreAndForwardDatabase {
     pub async fn find_anonymous_messages(
         &self,
         since: Option<DateTime<Utc>>,
+        before_id: Option<i32>,
         limit: i64,
     ) -> Result<Vec<StoredMessage>, StorageError> {
         self.connection
@@ -125,9 +132,12 @@ impl StoreAndForwardDatabase {
                 if let Some(since) = since {
                     query = query.filter(stored_messages::stored_at.gt(since.naive_utc()));
                 }
+                if let Some(before_id) = before_id {
+                    query = query.filter(stored_messages::id.lt(before_id));
+                }
 
                 query
-                    .order_by(stored_messages::stored_at.desc())
+                    .order_by(stored_messages::id.desc())
                     .limit(limit)
                     .get_results(conn)
                     .map_err(Into::into)
@@ -138,6 +148,7 @@ impl StoreAndForwardDatabase {
     pub async fn find_join_messages(
         &self,
         since: Option<DateTime<Utc>>,
+        before_id: Option<i32>,
         limit: i64,
     ) -> Result<Vec<StoredMessage>, StorageError> {
         self.connection
@@ -150,9 +161,12 @@ impl StoreAndForwardDatabase {
                 if let Some(since) = since {
                     query = query.filter(stored_messages::stored_at.gt(since.naive_utc()));
                 }
+                if let Some(before_id) = before_id {
+                    query = query.filter(stored_messages::id.lt(before_id));
+                }
 
                 query
-                    .order_by(stored_messages::stored_at.desc())
+                    .order_by(stored_messages::id.desc())
                     .limit(limit)
                     .get_results(conn)
                     .map_err(Into::into)
@@ -165,6 +179,7 @@ impl StoreAndForwardDatabase {
         public_key: &CommsPublicKey,
         message_type: DhtMessageType,
         since: Option<DateTime<Utc>>,
+        before_id: Option<i32>,
         limit: i64,
     ) -> Result<Vec<StoredMessage>, StorageError> {
         let pk_hex = public_key.to_hex();
@@ -179,9 +194,12 @@ impl StoreAndForwardDatabase {
                 if let Some(since) = since {
                     query = query.filter(stored_messages::stored_at.gt(since.naive_utc()));
                 }
+                if let Some(before_id) = before_id {
+                    query = query.filter(stored_messages::id.lt(before_id));
+                }
 
                 query
-                    .order_by(stored_messages::stored_at.desc())
+                    .order_by(stored_messages::id.desc())
                     .limit(limit)
                     .get_results(conn)
                     .map_err(Into::into)
@@ -217,33 +235,53 @@ impl StoreAndForwardDatabase {
             .await
     }
 
-    pub(crate) async fn truncate_messages(&self, max_size: usize) -> Result<usize, StorageError> {
+    pub(crate) async fn count_messages(&self) -> Result<usize, StorageError> {
         self.connection
-            .with_connection_async(move |conn| {
-                let mut num_removed = 0;
-                let msg_count = stored_messages::table
+            .with_connection_async(|conn| {
+                let count = stored_messages::table
                     .select(dsl::count(stored_messages::id))
-                    .first::<i64>(conn)? as usize;
-                if msg_count > max_size {
-                    let remove_count = msg_count - max_size;
-                    let message_ids: Vec<i32> = stored_messages::table
-                        .select(stored_messages::id)
-                        .order_by(stored_messages::stored_at.asc())
-                        .limit(remove_count as i64)
-                        .get_results(conn)?;
-                    num_removed = diesel::delete(stored_messages::table)
-                        .filter(stored_messages::id.eq_any(message_ids))
-                        .execute(conn)?;
-                }
-                Ok(num_removed)
+                    .first::<i64>(conn)?;
+                Ok(count as usize)
             })
             .await
     }
+
+    /// Removes up to `num_messages` messages, lowest priority first and then oldest first
+    pub(crate) async fn remove_lowest_priority_messages(&self, num_messages: usize) -> Result<usize, StorageError> {
+        self.connection
+            .with_connection_async(move |conn| {
+                let message_ids: Vec<i32> = stored_messages::table
+                    .select(stored_messages::id)
+                    .order_by((
+                        stored_messages::priority.asc(),
+                        stored_messages::stored_at.asc(),
+                        stored_messages::id.asc(),
+                    ))
+                    .limit(num_messages as i64)
+                    .get_results(conn)?;
+                diesel::delete(stored_messages::table)
+                    .filter(stored_messages::id.eq_any(message_ids))
+                    .execute(conn)
+                    .map_err(Into::into)
+            })
+            .await
+    }
+
+    /// Removes the lowest priority messages until at most `max_size` messages are stored
+    #[cfg(test)]
+    pub(crate) async fn truncate_messages(&self, max_size: usize) -> Result<usize, StorageError> {
+        let msg_count = self.count_messages().await?;
+        if msg_count <= max_size {
+            return Ok(0);
+        }
+        self.remove_lowest_priority_messages(msg_count - max_size).await
+    }
 }
 
 #[cfg(test)]
 mod test {
     use super::*;
+    use crate::test_utils::make_node_identity;
     use tari_test_utils::random;
 
     #[tokio_macros::test_basic]
@@ -317,4 +355,63 @@ mod test {
         assert_eq!(messages[0].body_hash, msg3.body_hash);
         assert_eq!(messages[1].body_hash, msg4.body_hash);
     }
+
+    #[tokio_macros::test_basic]
+    async fn truncate_messages_lowest_priority_first() {
+        let conn = DbConnection::connect_memory(random::string(8)).await.unwrap();
+        conn.migrate().await.unwrap();
+        let db = StoreAndForwardDatabase::new(conn);
+        for (i, priority) in [
+            StoredMessagePriority::High,
+            StoredMessagePriority::Low,
+            StoredMessagePriority::High,
+        ]
+        .iter()
+        .enumerate()
+        {
+            let mut msg = NewStoredMessage::default();
+            msg.body_hash = i.to_string();
+            msg.priority = *priority as i32;
+            db.insert_message_if_unique(msg).await.unwrap();
+        }
+        let num_removed = db.truncate_messages(2).await.unwrap();
+        assert_eq!(num_removed, 1);
+        assert_eq!(db.count_messages().await.unwrap(), 2);
+        let messages = db.get_all_messages().await.unwrap();
+        assert_eq!(messages[0].body_hash, "0");
+        assert_eq!(messages[1].body_hash, "2");
+    }
+
+    #[tokio_macros::test_basic]
+    async fn find_messages_for_peer_in_pages() {
+        let conn = DbConnection::connect_memory(random::string(8)).await.unwrap();
+        conn.migrate().await.unwrap();
+        let db = StoreAndForwardDatabase::new(conn);
+        let node_identity = make_node_identity();
+        for i in 0..5 {
+            let mut msg = NewStoredMessage::default();
+            msg.body_hash = i.to_string();
+            msg.destination_pubkey = Some(node_identity.public_key().to_hex());
+            db.insert_message_if_unique(msg).await.unwrap();
+        }
+        let mut msg = NewStoredMessage::default();
+        msg.body_hash = "other".to_string();
+        msg.destination_pubkey = Some("other".to_string());
+        db.insert_message_if_unique(msg).await.unwrap();
+
+        let mut before_id = None;
+        let mut pages = Vec::new();
+        loop {
+            let page = db
+                .find_messages_for_peer(node_identity.public_key(), node_identity.node_id(), None, before_id, 2)
+                .await
+                .unwrap();
+            if page.is_empty() {
+                break;
+            }
+            before_id = page.last().map(|m| m.id);
+            pages.push(page.into_iter().map(|m| m.body_hash).collect::<Vec<_>>());
+        }
+        assert_eq!(pages, vec![vec!["4", "3"], vec!["2", "1"], vec!["0"]]);
+    }
 }
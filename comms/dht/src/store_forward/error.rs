@@ -25,6 +25,7 @@ use prost::DecodeError;
 use tari_comms::{message::MessageError, peer_manager::PeerManagerError};
 use tari_utilities::{byte_array::ByteArrayError, ciphers::cipher::CipherError};
 use thiserror::Error;
+use tokio::task;
 
 #[derive(Debug, Error)]
 pub enum StoreAndForwardError {
@@ -81,4 +82,6 @@ pub enum StoreAndForwardError {
     InvalidDhtMessageType,
     #[error("Failed to send request for store and forward messages: {0}")]
     RequestMessagesFailed(DhtOutboundError),
+    #[error("Stored message decryption task failed: {0}")]
+    DecryptionTaskFailed(#[from] task::JoinError),
 }
@@ -42,6 +42,7 @@ use digest::Digest;
 use futures::{channel::mpsc, future, stream, SinkExt, StreamExt};
 use log::*;
 use prost::Message;
+use rayon::prelude::*;
 use std::{convert::TryInto, sync::Arc};
 use tari_comms::{
     message::{EnvelopeBody, MessageTag},
@@ -51,6 +52,7 @@ use tari_comms::{
     utils::signature,
 };
 use tari_utilities::{convert::try_convert_all, ByteArray};
+use tokio::task;
 use tower::{Service, ServiceExt};
 
 const LOG_TARGET: &str = "comms::dht::storeforward::handler";
@@ -186,51 +188,74 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
 
         for resp_type in response_types {
             query.with_response_type(resp_type);
-            let messages = self.saf_requester.fetch_messages(query.clone()).await?;
+            // The messages are sent in pages so that the requester can start processing them while the next page is
+            // fetched. Pages go from the newest message to the oldest, so the newest are sent when more than
+            // saf_max_returned_messages are stored. Each page is removed once it has been sent, and the next page
+            // continues from the last message sent.
+            let mut num_sent = 0;
+            loop {
+                let mut messages = self.saf_requester.fetch_messages(query.clone()).await?;
+                messages.truncate(self.config.saf_max_returned_messages.saturating_sub(num_sent));
+                num_sent += messages.len();
+                let last_id = messages.last().map(|msg| msg.id);
+                let has_more = messages.len() >= self.config.saf_response_page_size &&
+                    num_sent < self.config.saf_max_returned_messages;
+
+                let message_ids = messages.iter().map(|msg| msg.id).collect::<Vec<_>>();
+                let stored_messages = StoredMessagesResponse {
+                    messages: try_convert_all(messages)?,
+                    request_id: retrieve_msgs.request_id,
+                    response_type: resp_type as i32,
+                    has_more,
+                };
 
-            let message_ids = messages.iter().map(|msg| msg.id).collect::<Vec<_>>();
-            let stored_messages = StoredMessagesResponse {
-                messages: try_convert_all(messages)?,
-                request_id: retrieve_msgs.request_id,
-                response_type: resp_type as i32,
-            };
+                debug!(
+                    target: LOG_TARGET,
+                    "Responding to received message retrieval request with {} {:?} message(s)",
+                    stored_messages.messages().len(),
+                    resp_type
+                );
+                match self
+                    .outbound_service
+                    .send_message_no_header(
+                        SendMessageParams::new()
+                            .direct_public_key(message.source_peer.public_key.clone())
+                            .with_dht_message_type(DhtMessageType::SafStoredMessages)
+                            .finish(),
+                        stored_messages,
+                    )
+                    .await?
+                    .resolve()
+                    .await
+                {
+                    Ok(_) => {
+                        debug!(
+                            target: LOG_TARGET,
+                            "Removing {} stored message(s) for peer '{}'",
+                            message_ids.len(),
+                            message.source_peer.node_id.short_str()
+                        );
+                        if !message_ids.is_empty() {
+                            self.saf_requester.remove_messages(message_ids).await?;
+                        }
+                    },
+                    Err(err) => {
+                        error!(
+                            target: LOG_TARGET,
+                            "Failed to send stored messages to peer '{}': {}",
+                            message.source_peer.node_id.short_str(),
+                            err
+                        );
+                        break;
+                    },
+                }
 
-            debug!(
-                target: LOG_TARGET,
-                "Responding to received message retrieval request with {} {:?} message(s)",
-                stored_messages.messages().len(),
-                resp_type
-            );
-            match self
-                .outbound_service
-                .send_message_no_header(
-                    SendMessageParams::new()
-                        .direct_public_key(message.source_peer.public_key.clone())
-                        .with_dht_message_type(DhtMessageType::SafStoredMessages)
-                        .finish(),
-                    stored_messages,
-                )
-                .await?
-                .resolve()
-                .await
-            {
-                Ok(_) => {
-                    debug!(
-                        target: LOG_TARGET,
-                        "Removing {} stored message(s) for peer '{}'",
-                        message_ids.len(),
-                        message.source_peer.node_id.short_str()
-                    );
-                    self.saf_requester.remove_messages(message_ids).await?;
-                },
-                Err(err) => {
-                    error!(
-                        target: LOG_TARGET,
-                        "Failed to send stored messages to peer '{}': {}",
-                        message.source_peer.node_id.short_str(),
-                        err
-                    );
-                },
+                match last_id {
+                    Some(id) if has_more => {
+                        query.before_id(id);
+                    },
+                    _ => break,
+                }
             }
         }
 
@@ -254,6 +279,7 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
             .decode_part::<StoredMessagesResponse>(0)?
             .ok_or(StoreAndForwardError::InvalidEnvelopeBody)?;
         let source_peer = Arc::new(message.source_peer);
+        let has_more = response.has_more;
 
         debug!(
             target: LOG_TARGET,
@@ -267,13 +293,9 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
             message_tag
         );
 
-        let mut results = Vec::with_capacity(response.messages.len());
-        for msg in response.messages {
-            let result = self
-                .process_incoming_stored_message(Arc::clone(&source_peer), msg)
-                .await;
-            results.push(result);
-        }
+        let results = self
+            .process_incoming_stored_messages(Arc::clone(&source_peer), response.messages)
+            .await?;
 
         let successful_msgs_iter = results
             .into_iter()
@@ -332,12 +354,14 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
             .filter(Result::is_ok)
             .map(Result::unwrap);
 
-        // Let the SAF Service know we got a SAF response.
-        let _ = self
-            .saf_response_signal_sender
-            .send(())
-            .await
-            .map_err(|e| warn!(target: LOG_TARGET, "Error sending SAF response signal; {:?}", e));
+        // Let the SAF Service know we got a SAF response, a response that is followed by more pages is not counted
+        if !has_more {
+            let _ = self
+                .saf_response_signal_sender
+                .send(())
+                .await
+                .map_err(|e| warn!(target: LOG_TARGET, "Error sending SAF response signal; {:?}", e));
+        }
 
         self.next_service
             .call_all(stream::iter(successful_msgs_iter))
@@ -353,11 +377,68 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
         Ok(())
     }
 
-    async fn process_incoming_stored_message(
+    /// Validates, deduplicates and decrypts a batch of stored messages. The message hashes of the batch are checked
+    /// against the message hash cache in a single request and the messages are decrypted in parallel.
+    async fn process_incoming_stored_messages(
         &mut self,
         source_peer: Arc<Peer>,
+        messages: Vec<ProtoStoredMessage>,
+    ) -> Result<Vec<Result<DecryptedDhtMessage, StoreAndForwardError>>, StoreAndForwardError> {
+        let mut results = Vec::with_capacity(messages.len());
+        for message in messages {
+            results.push(self.validate_incoming_stored_message(&source_peer, message).await);
+        }
+
+        // Check that the messages have not already been received
+        let msg_hashes = results
+            .iter()
+            .filter_map(|result| result.as_ref().ok())
+            .map(|(_, body)| Challenge::new().chain(body).finalize().to_vec())
+            .collect::<Vec<_>>();
+        let mut is_duplicate = self.dht_requester.insert_message_hashes(msg_hashes).await?.into_iter();
+        let results = results
+            .into_iter()
+            .map(|result| {
+                result.and_then(|msg| {
+                    if is_duplicate.next().unwrap_or(false) {
+                        Err(StoreAndForwardError::DuplicateMessage)
+                    } else {
+                        Ok(msg)
+                    }
+                })
+            })
+            .collect::<Vec<_>>();
+
+        // Attempt to decrypt the messages (if applicable), and deserialize them
+        let node_identity = Arc::clone(&self.node_identity);
+        let results = task::spawn_blocking(move || {
+            results
+                .into_par_iter()
+                .map(|result| -> Result<DecryptedDhtMessage, StoreAndForwardError> {
+                    let (dht_header, body) = result?;
+                    let (authenticated_pk, decrypted_body) =
+                        authenticate_and_decrypt_if_required(&node_identity, &dht_header, &body)?;
+                    let mut inbound_msg =
+                        DhtInboundMessage::new(MessageTag::new(), dht_header, Arc::clone(&source_peer), body);
+                    inbound_msg.is_saf_message = true;
+                    Ok(DecryptedDhtMessage::succeeded(
+                        decrypted_body,
+                        authenticated_pk,
+                        inbound_msg,
+                    ))
+                })
+                .collect()
+        })
+        .await?;
+
+        Ok(results)
+    }
+
+    async fn validate_incoming_stored_message(
+        &mut self,
+        source_peer: &Peer,
         message: ProtoStoredMessage,
-    ) -> Result<DecryptedDhtMessage, StoreAndForwardError> {
+    ) -> Result<(DhtMessageHeader, Vec<u8>), StoreAndForwardError> {
         let node_identity = &self.node_identity;
         let peer_manager = &self.peer_manager;
         let config = &self.config;
@@ -399,31 +480,8 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
 
         // Check that the destination is either undisclosed, for us or for our network region
         Self::check_destination(&config, &peer_manager, &node_identity, &dht_header).await?;
-        // Check that the message has not already been received.
-        Self::check_duplicate(&mut self.dht_requester, &message.body).await?;
-
-        // Attempt to decrypt the message (if applicable), and deserialize it
-        let (authenticated_pk, decrypted_body) =
-            Self::authenticate_and_decrypt_if_required(&node_identity, &dht_header, &message.body)?;
-
-        let mut inbound_msg =
-            DhtInboundMessage::new(MessageTag::new(), dht_header, Arc::clone(&source_peer), message.body);
-        inbound_msg.is_saf_message = true;
-
-        Ok(DecryptedDhtMessage::succeeded(
-            decrypted_body,
-            authenticated_pk,
-            inbound_msg,
-        ))
-    }
 
-    async fn check_duplicate(dht_requester: &mut DhtRequester, body: &[u8]) -> Result<(), StoreAndForwardError> {
-        let msg_hash = Challenge::new().chain(body).finalize().to_vec();
-        if dht_requester.insert_message_hash(msg_hash).await? {
-            Err(StoreAndForwardError::DuplicateMessage)
-        } else {
-            Ok(())
-        }
+        Ok((dht_header, message.body))
     }
 
     async fn check_destination(
@@ -449,60 +507,60 @@ where S: Service<DecryptedDhtMessage, Response = (), Error = PipelineError>
             Err(StoreAndForwardError::InvalidDestination)
         }
     }
+}
 
-    fn authenticate_and_decrypt_if_required(
-        node_identity: &NodeIdentity,
-        header: &DhtMessageHeader,
-        body: &[u8],
-    ) -> Result<(Option<CommsPublicKey>, EnvelopeBody), StoreAndForwardError> {
-        if header.flags.contains(DhtMessageFlags::ENCRYPTED) {
-            let ephemeral_public_key = header.ephemeral_public_key.as_ref().expect(
-                "[store and forward] DHT header is invalid after validity check because it did not contain an \
-                 ephemeral_public_key",
-            );
+fn authenticate_and_decrypt_if_required(
+    node_identity: &NodeIdentity,
+    header: &DhtMessageHeader,
+    body: &[u8],
+) -> Result<(Option<CommsPublicKey>, EnvelopeBody), StoreAndForwardError> {
+    if header.flags.contains(DhtMessageFlags::ENCRYPTED) {
+        let ephemeral_public_key = header.ephemeral_public_key.as_ref().expect(
+            "[store and forward] DHT header is invalid after validity check because it did not contain an \
+             ephemeral_public_key",
+        );
 
-            trace!(
-                target: LOG_TARGET,
-                "Attempting to decrypt origin mac ({} byte(s))",
-                header.origin_mac.len()
-            );
-            let shared_secret = crypt::generate_ecdh_secret(node_identity.secret_key(), ephemeral_public_key);
-            let decrypted = crypt::decrypt(&shared_secret, &header.origin_mac)?;
-            let authenticated_pk = Self::authenticate_message(&decrypted, body)?;
+        trace!(
+            target: LOG_TARGET,
+            "Attempting to decrypt origin mac ({} byte(s))",
+            header.origin_mac.len()
+        );
+        let shared_secret = crypt::generate_ecdh_secret(node_identity.secret_key(), ephemeral_public_key);
+        let decrypted = crypt::decrypt(&shared_secret, &header.origin_mac)?;
+        let authenticated_pk = authenticate_message(&decrypted, body)?;
 
-            trace!(
-                target: LOG_TARGET,
-                "Attempting to decrypt message body ({} byte(s))",
-                body.len()
-            );
-            let decrypted_bytes = crypt::decrypt(&shared_secret, body)?;
-            let envelope_body =
-                EnvelopeBody::decode(decrypted_bytes.as_slice()).map_err(|_| StoreAndForwardError::DecryptionFailed)?;
-            if envelope_body.is_empty() {
-                return Err(StoreAndForwardError::InvalidEnvelopeBody);
-            }
-            Ok((Some(authenticated_pk), envelope_body))
-        } else {
-            let authenticated_pk = if !header.origin_mac.is_empty() {
-                Some(Self::authenticate_message(&header.origin_mac, body)?)
-            } else {
-                None
-            };
-            let envelope_body = EnvelopeBody::decode(body).map_err(|_| StoreAndForwardError::MalformedMessage)?;
-            Ok((authenticated_pk, envelope_body))
+        trace!(
+            target: LOG_TARGET,
+            "Attempting to decrypt message body ({} byte(s))",
+            body.len()
+        );
+        let decrypted_bytes = crypt::decrypt(&shared_secret, body)?;
+        let envelope_body =
+            EnvelopeBody::decode(decrypted_bytes.as_slice()).map_err(|_| StoreAndForwardError::DecryptionFailed)?;
+        if envelope_body.is_empty() {
+            return Err(StoreAndForwardError::InvalidEnvelopeBody);
         }
+        Ok((Some(authenticated_pk), envelope_body))
+    } else {
+        let authenticated_pk = if !header.origin_mac.is_empty() {
+            Some(authenticate_message(&header.origin_mac, body)?)
+        } else {
+            None
+        };
+        let envelope_body = EnvelopeBody::decode(body).map_err(|_| StoreAndForwardError::MalformedMessage)?;
+        Ok((authenticated_pk, envelope_body))
     }
+}
 
-    fn authenticate_message(origin_mac_body: &[u8], body: &[u8]) -> Result<CommsPublicKey, StoreAndForwardError> {
-        let origin_mac = OriginMac::decode(origin_mac_body)?;
-        let public_key =
-            CommsPublicKey::from_bytes(&origin_mac.public_key).map_err(|_| StoreAndForwardError::InvalidOriginMac)?;
+fn authenticate_message(origin_mac_body: &[u8], body: &[u8]) -> Result<CommsPublicKey, StoreAndForwardError> {
+    let origin_mac = OriginMac::decode(origin_mac_body)?;
+    let public_key =
+        CommsPublicKey::from_bytes(&origin_mac.public_key).map_err(|_| StoreAndForwardError::InvalidOriginMac)?;
 
-        if signature::verify(&public_key, &origin_mac.signature, body) {
-            Ok(public_key)
-        } else {
-            Err(StoreAndForwardError::InvalidOriginMac)
-        }
+    if signature::verify(&public_key, &origin_mac.signature, body) {
+        Ok(public_key)
+    } else {
+        Err(StoreAndForwardError::InvalidOriginMac)
     }
 }
 
@@ -696,7 +754,8 @@ mod test {
             wrap_in_envelope_body!(StoredMessagesResponse {
                 messages: vec![msg1.clone(), msg2, msg_clear],
                 request_id: 123,
-                response_type: 0
+                response_type: 0,
+                has_more: false
             }),
             None,
             make_dht_inbound_message(
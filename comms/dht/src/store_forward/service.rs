@@ -63,6 +63,7 @@ pub struct FetchStoredMessageQuery {
     public_key: Box<CommsPublicKey>,
     node_id: Box<NodeId>,
     since: Option<DateTime<Utc>>,
+    before_id: Option<i32>,
     response_type: SafResponseType,
 }
 
@@ -72,6 +73,7 @@ impl FetchStoredMessageQuery {
             public_key,
             node_id,
             since: None,
+            before_id: None,
             response_type: SafResponseType::Anonymous,
         }
     }
@@ -81,6 +83,12 @@ impl FetchStoredMessageQuery {
         self
     }
 
+    /// Only fetch messages stored before the message with this id, used to fetch the next page of messages
+    pub fn before_id(&mut self, id: i32) -> &mut Self {
+        self.before_id = Some(id);
+        self
+    }
+
     pub fn with_response_type(&mut self, response_type: SafResponseType) -> &mut Self {
         self.response_type = response_type;
         self
@@ -162,6 +170,7 @@ pub struct StoreAndForwardService {
     num_online_peers: Option<usize>,
     saf_response_signal_rx: Fuse<mpsc::Receiver<()>>,
     event_publisher: DhtEventSender,
+    num_stored_messages: Option<usize>,
 }
 
 impl StoreAndForwardService {
@@ -191,6 +200,7 @@ impl StoreAndForwardService {
             num_online_peers: None,
             saf_response_signal_rx: saf_response_signal_rx.fuse(),
             event_publisher,
+            num_stored_messages: None,
         }
     }
 
@@ -273,6 +283,11 @@ impl StoreAndForwardService {
                             info!(target: LOG_TARGET, "SAF message for {} already stored", pub_key);
                         }
                         let _ = reply_tx.send(Ok(existed));
+                        if !existed {
+                            if let Err(err) = self.message_stored().await {
+                                error!(target: LOG_TARGET, "Failed to enforce storage capacity: {:?}", err);
+                            }
+                        }
                     },
                     Err(err) => {
                         error!(target: LOG_TARGET, "InsertMessage failed because '{:?}'", err);
@@ -281,7 +296,10 @@ impl StoreAndForwardService {
                 }
             },
             RemoveMessages(message_ids) => match self.database.remove_message(message_ids.clone()).await {
-                Ok(_) => trace!(target: LOG_TARGET, "Removed messages: {:?}", message_ids),
+                Ok(num_removed) => {
+                    self.num_stored_messages = self.num_stored_messages.map(|n| n.saturating_sub(num_removed));
+                    trace!(target: LOG_TARGET, "Removed messages: {:?}", message_ids)
+                },
                 Err(err) => error!(target: LOG_TARGET, "RemoveMessage failed because '{:?}'", err),
             },
             SendStoreForwardRequestToPeer(node_id) => {
@@ -418,28 +436,59 @@ impl StoreAndForwardService {
 
     async fn handle_fetch_message_query(&self, query: FetchStoredMessageQuery) -> SafResult<Vec<StoredMessage>> {
         use SafResponseType::*;
-        let limit = i64::try_from(self.config.saf_max_returned_messages)
-            .ok()
-            .or(Some(std::i64::MAX))
-            .unwrap();
+        let limit = i64::try_from(self.config.saf_response_page_size).unwrap_or(std::i64::MAX);
         let db = &self.database;
+        let (since, before_id) = (query.since, query.before_id);
         let messages = match query.response_type {
             ForMe => {
-                db.find_messages_for_peer(&query.public_key, &query.node_id, query.since, limit)
+                db.find_messages_for_peer(&query.public_key, &query.node_id, since, before_id, limit)
                     .await?
             },
-            Join => db.find_join_messages(query.since, limit).await?,
+            Join => db.find_join_messages(since, before_id, limit).await?,
             Discovery => {
-                db.find_messages_of_type_for_pubkey(&query.public_key, DhtMessageType::Discovery, query.since, limit)
-                    .await?
+                db.find_messages_of_type_for_pubkey(
+                    &query.public_key,
+                    DhtMessageType::Discovery,
+                    since,
+                    before_id,
+                    limit,
+                )
+                .await?
             },
-            Anonymous => db.find_anonymous_messages(query.since, limit).await?,
+            Anonymous => db.find_anonymous_messages(since, before_id, limit).await?,
         };
 
         Ok(messages)
     }
 
-    async fn cleanup(&self) -> SafResult<()> {
+    /// Keeps a running count of the stored messages so that the storage capacity is enforced as messages are stored
+    /// without counting the messages each time. The count is resynchronised with the database on every cleanup.
+    async fn message_stored(&mut self) -> SafResult<()> {
+        let num_stored = match self.num_stored_messages {
+            Some(n) => n + 1,
+            None => self.database.count_messages().await?,
+        };
+        self.truncate_to_capacity(num_stored).await
+    }
+
+    async fn truncate_to_capacity(&mut self, num_stored: usize) -> SafResult<()> {
+        let capacity = self.config.saf_msg_storage_capacity;
+        let mut num_removed = 0;
+        if num_stored > capacity {
+            num_removed = self
+                .database
+                .remove_lowest_priority_messages(num_stored - capacity)
+                .await?;
+            debug!(
+                target: LOG_TARGET,
+                "Storage limits exceeded, removed {} lowest priority messages", num_removed
+            );
+        }
+        self.num_stored_messages = Some(num_stored.saturating_sub(num_removed));
+        Ok(())
+    }
+
+    async fn cleanup(&mut self) -> SafResult<()> {
         let num_removed = self
             .database
             .delete_messages_with_priority_older_than(
@@ -458,18 +507,8 @@ impl StoreAndForwardService {
             .await?;
         debug!(target: LOG_TARGET, "Cleaned {} old high priority messages", num_removed);
 
-        let num_removed = self
-            .database
-            .truncate_messages(self.config.saf_msg_storage_capacity)
-            .await?;
-        if num_removed > 0 {
-            debug!(
-                target: LOG_TARGET,
-                "Storage limits exceeded, removing {} oldest messages", num_removed
-            );
-        }
-
-        Ok(())
+        let num_stored = self.database.count_messages().await?;
+        self.truncate_to_capacity(num_stored).await
     }
 
     fn publish_event(&mut self, event: DhtEvent) {
@@ -115,6 +115,10 @@ impl DhtActorMock {
                 let v = self.state.signature_cache_insert.load(Ordering::SeqCst);
                 reply_tx.send(v).unwrap();
             },
+            MsgHashCacheInsertBatch(hashes, reply_tx) => {
+                let v = self.state.signature_cache_insert.load(Ordering::SeqCst);
+                reply_tx.send(vec![v; hashes.len()]).unwrap();
+            },
             SelectPeers(_, reply_tx) => {
                 let lock = self.state.select_peers.read().unwrap();
                 reply_tx
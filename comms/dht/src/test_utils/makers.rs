@@ -192,5 +192,6 @@ pub fn create_outbound_message(body: &[u8]) -> DhtOutboundMessage {
         origin_mac: None,
         is_broadcast: false,
         expires: None,
+        shared_envelope: None,
     }
 }
@@ -213,6 +213,10 @@ impl RpcCodeGenerator {
             pub fn close(&mut self) {
                 self.inner.close();
             }
+
+            pub fn is_connected(&self) -> bool {
+                self.inner.is_connected()
+            }
         };
 
         quote! {
@@ -234,6 +238,12 @@ impl RpcCodeGenerator {
                     Self { inner }
                 }
             }
+
+            impl #dep_mod::RpcPoolClient for #client_struct {
+                fn is_connected(&self) -> bool {
+                    self.inner.is_connected()
+                }
+            }
         }
     }
 }
@@ -21,7 +21,15 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #[cfg(feature = "rpc")]
-use crate::protocol::rpc::{NamedProtocolService, RpcClient, RpcClientBuilder, RpcError, RPC_MAX_FRAME_SIZE};
+use crate::protocol::rpc::{
+    NamedProtocolService,
+    RpcClient,
+    RpcClientBuilder,
+    RpcClientPool,
+    RpcError,
+    RpcPoolClient,
+    RPC_MAX_FRAME_SIZE,
+};
 
 use super::{
     error::{ConnectionManagerError, PeerConnectionError},
@@ -219,7 +227,15 @@ impl PeerConnection {
             self.peer_node_id
         );
         let framed = self.open_framed_substream(&protocol.into(), RPC_MAX_FRAME_SIZE).await?;
-        builder.connect(framed).await
+        builder.with_peer(self.peer_node_id.clone()).connect(framed).await
+    }
+
+    /// Creates a pool of up to `pool_size` RPC sessions to the peer over this connection. Sessions are established as
+    /// they are needed or ahead of time with `RpcClientPool::warm_up`.
+    #[cfg(feature = "rpc")]
+    pub fn create_rpc_client_pool<T>(&self, pool_size: usize, builder: RpcClientBuilder<T>) -> RpcClientPool<T>
+    where T: RpcPoolClient + From<RpcClient> + NamedProtocolService + Clone {
+        RpcClientPool::new(self.clone(), pool_size, builder)
     }
 
     /// Immediately disconnects the peer connection. This can only fail if the peer connection worker
@@ -29,19 +29,24 @@ use crate::{
     peer_manager::NodeId,
     protocol::messaging::protocol::MESSAGING_PROTOCOL,
 };
-use futures::{channel::mpsc, future::Either, SinkExt, StreamExt};
+use bytes::BytesMut;
+use futures::{channel::mpsc, future::Either, AsyncWriteExt, FutureExt, SinkExt, StreamExt};
 use log::*;
 use std::{
     io,
     time::{Duration, Instant},
 };
 use tokio::stream as tokio_stream;
+use tokio_util::codec::{Encoder, LengthDelimitedCodec};
 
 const LOG_TARGET: &str = "comms::protocol::messaging::outbound";
 /// The number of times to retry sending a failed message before publishing a SendMessageFailed event.
 /// This should only need to be 1 to handle the case where the pending dial is cancelled due to to tie breaking
 /// and because the connection manager already retries dialing a number of times for each requested dial.
 const MAX_SEND_RETRIES: usize = 1;
+/// Messages that are already queued for the peer are coalesced into a single write to the substream until the write
+/// reaches this size. This matches the maximum noise frame payload.
+const MAX_COALESCED_WRITE_SIZE: usize = 64 * 1024;
 
 pub struct OutboundMessaging {
     connectivity: ConnectivityRequester,
@@ -209,9 +214,8 @@ impl OutboundMessaging {
             "Starting direct message forwarding for peer `{}`",
             self.peer_node_id.short_str()
         );
-        let substream = substream.stream;
-
-        let (sink, _) = MessagingProtocol::framed(substream).split();
+        let mut substream = substream.stream;
+        let mut codec = MessagingProtocol::codec();
 
         let Self {
             request_rx,
@@ -232,17 +236,34 @@ impl OutboundMessaging {
             },
             None => Either::Right(request_rx.map(Ok)),
         };
+        futures::pin_mut!(stream);
 
-        stream
-            .map(|msg| {
-                msg.map(|mut out_msg| {
-                    trace!(target: LOG_TARGET, "Message buffered for sending {}", out_msg);
-                    out_msg.reply_success();
-                    out_msg.body
-                })
-            })
-            .forward(sink)
-            .await?;
+        let mut write_buf = BytesMut::new();
+        while let Some(msg) = stream.next().await {
+            Self::buffer_message(&mut codec, &mut write_buf, msg?)?;
+            let mut num_coalesced = 1;
+            // Coalesce any messages that are already queued without waiting for more to arrive
+            while write_buf.len() < MAX_COALESCED_WRITE_SIZE {
+                match stream.next().now_or_never() {
+                    Some(Some(msg)) => {
+                        Self::buffer_message(&mut codec, &mut write_buf, msg?)?;
+                        num_coalesced += 1;
+                    },
+                    _ => break,
+                }
+            }
+            trace!(
+                target: LOG_TARGET,
+                "Writing {} message(s) ({} bytes) to peer `{}`",
+                num_coalesced,
+                write_buf.len(),
+                self.peer_node_id.short_str()
+            );
+            substream.write_all(&write_buf).await?;
+            substream.flush().await?;
+            write_buf.clear();
+        }
+        substream.close().await?;
 
         debug!(
             target: LOG_TARGET,
@@ -252,6 +273,17 @@ impl OutboundMessaging {
         Ok(())
     }
 
+    fn buffer_message(
+        codec: &mut LengthDelimitedCodec,
+        write_buf: &mut BytesMut,
+        mut out_msg: OutboundMessage,
+    ) -> Result<(), MessagingProtocolError> {
+        trace!(target: LOG_TARGET, "Message buffered for sending {}", out_msg);
+        out_msg.reply_success();
+        codec.encode(out_msg.body, write_buf)?;
+        Ok(())
+    }
+
     async fn fail_all_pending_messages(&mut self, reason: SendFailReason) {
         // Close the request channel so that we can read all the remaining messages and flush them
         // to a failed event
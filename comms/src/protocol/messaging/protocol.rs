@@ -193,6 +193,13 @@ impl MessagingProtocol {
         framing::canonical(socket, MAX_FRAME_LENGTH)
     }
 
+    /// The codec used to frame messages on a messaging substream
+    pub fn codec() -> LengthDelimitedCodec {
+        LengthDelimitedCodec::builder()
+            .max_frame_length(MAX_FRAME_LENGTH)
+            .new_codec()
+    }
+
     fn handle_connectivity_event(&mut self, event: &ConnectivityEvent) {
         use ConnectivityEvent::*;
         #[allow(clippy::single_match)]
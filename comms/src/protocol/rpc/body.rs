@@ -218,21 +218,46 @@ impl Buf for BodyBytes {
 
 #[derive(Debug)]
 pub struct Streaming<T> {
-    inner: mpsc::Receiver<Result<T, RpcStatus>>,
+    inner: StreamingKind<T>,
+}
+
+#[derive(Debug)]
+enum StreamingKind<T> {
+    Messages(mpsc::Receiver<Result<T, RpcStatus>>),
+    /// Messages of type T that have already been encoded, for example read as-is from storage. They are sent without
+    /// being decoded and encoded again.
+    Encoded(mpsc::Receiver<Result<Bytes, RpcStatus>>),
 }
 
 impl<T> Streaming<T> {
     pub fn new(inner: mpsc::Receiver<Result<T, RpcStatus>>) -> Self {
-        Self { inner }
+        Self {
+            inner: StreamingKind::Messages(inner),
+        }
+    }
+
+    /// Create a stream from messages that have already been encoded. Each item must be a complete encoding of a T.
+    pub fn encoded(inner: mpsc::Receiver<Result<Bytes, RpcStatus>>) -> Self {
+        Self {
+            inner: StreamingKind::Encoded(inner),
+        }
     }
 
     pub fn empty() -> Self {
         let (_, rx) = mpsc::channel(0);
-        Self { inner: rx }
+        Self::new(rx)
     }
+}
 
-    pub fn into_inner(self) -> mpsc::Receiver<Result<T, RpcStatus>> {
-        self.inner
+impl<T: prost::Message + Default + Send + 'static> Streaming<T> {
+    /// Returns the stream of messages, decoding any that were provided already encoded
+    pub fn into_inner(self) -> BoxStream<'static, Result<T, RpcStatus>> {
+        match self.inner {
+            StreamingKind::Messages(rx) => rx.boxed(),
+            StreamingKind::Encoded(rx) => rx
+                .map(|result| result.and_then(|bytes| T::decode(bytes).map_err(Into::into)))
+                .boxed(),
+        }
     }
 }
 
@@ -240,12 +265,15 @@ impl<T: prost::Message> Stream for Streaming<T> {
     type Item = Result<Bytes, RpcStatus>;
 
     fn poll_next(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Option<Self::Item>> {
-        match ready!(self.inner.poll_next_unpin(cx)) {
-            Some(result) => {
-                let result = result.map(|msg| msg.to_encoded_bytes().into());
-                Poll::Ready(Some(result))
+        match &mut self.inner {
+            StreamingKind::Messages(rx) => match ready!(rx.poll_next_unpin(cx)) {
+                Some(result) => {
+                    let result = result.map(|msg| msg.to_encoded_bytes().into());
+                    Poll::Ready(Some(result))
+                },
+                None => Poll::Ready(None),
             },
-            None => Poll::Ready(None),
+            StreamingKind::Encoded(rx) => rx.poll_next_unpin(cx),
         }
     }
 }
@@ -293,9 +321,13 @@ impl<T: prost::Message + Default + Unpin> Stream for ClientStreaming<T> {
 
 #[cfg(test)]
 mod test {
-    use crate::{message::MessageExt, protocol::rpc::body::Body, runtime};
+    use crate::{
+        message::MessageExt,
+        protocol::rpc::body::{Body, Streaming},
+        runtime,
+    };
     use bytes::Bytes;
-    use futures::{stream, StreamExt};
+    use futures::{channel::mpsc, stream, SinkExt, StreamExt};
     use prost::Message;
 
     #[runtime::test_basic]
@@ -316,4 +348,25 @@ mod test {
         assert!(body_bytes.iter().take(10).all(|b| !b.is_finished()));
         assert!(body_bytes.last().unwrap().is_finished());
     }
+
+    #[runtime::test_basic]
+    async fn encoded_streaming() {
+        let (mut tx, rx) = mpsc::channel(2);
+        tx.send(Ok(Bytes::from(123u32.to_encoded_bytes()))).await.unwrap();
+        drop(tx);
+        let mut streaming = Streaming::<u32>::encoded(rx);
+        let bytes = streaming.next().await.unwrap().unwrap();
+        assert_eq!(u32::decode(bytes).unwrap(), 123u32);
+        assert!(streaming.next().await.is_none());
+
+        let (mut tx, rx) = mpsc::channel(2);
+        tx.send(Ok(Bytes::from(456u32.to_encoded_bytes()))).await.unwrap();
+        drop(tx);
+        let messages = Streaming::<u32>::encoded(rx)
+            .into_inner()
+            .map(Result::unwrap)
+            .collect::<Vec<_>>()
+            .await;
+        assert_eq!(messages, vec![456u32]);
+    }
 }
@@ -24,6 +24,7 @@ use super::message::RpcMethod;
 use crate::{
     framing::CanonicalFraming,
     message::MessageExt,
+    peer_manager::NodeId,
     proto,
     protocol::rpc::{
         body::ClientStreaming,
@@ -32,6 +33,7 @@ use crate::{
         NamedProtocolService,
         Response,
         RpcError,
+        RpcPoolClient,
         RpcStatus,
     },
     runtime::task,
@@ -53,12 +55,15 @@ use std::{
     fmt,
     future::Future,
     marker::PhantomData,
+    sync::Arc,
     time::{Duration, Instant},
 };
+use tari_metrics::Histogram;
 use tokio::time;
 use tower::{Service, ServiceExt};
 
 const LOG_TARGET: &str = "comms::rpc::client";
+const REQUEST_TIME_METRIC: &str = "comms_rpc_client_request_seconds";
 
 #[derive(Clone)]
 pub struct RpcClient {
@@ -121,6 +126,11 @@ impl RpcClient {
         self.connector.close()
     }
 
+    /// Returns true if the RPC session is open, otherwise false
+    pub fn is_connected(&self) -> bool {
+        self.connector.is_connected()
+    }
+
     /// Return the latency of the last request
     pub fn get_last_request_latency(&mut self) -> impl Future<Output = Result<Option<Duration>, RpcError>> + '_ {
         self.connector.get_last_request_latency()
@@ -136,6 +146,12 @@ impl RpcClient {
     }
 }
 
+impl RpcPoolClient for RpcClient {
+    fn is_connected(&self) -> bool {
+        self.connector.is_connected()
+    }
+}
+
 impl fmt::Debug for RpcClient {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         write!(f, "RpcClient {{ inner: ... }}")
@@ -193,6 +209,14 @@ where TClient: From<RpcClient> + NamedProtocolService
         self
     }
 
+    /// The peer the session is with. When set, the round-trip time of requests to the peer is recorded in the
+    /// `comms_rpc_client_request_seconds` metric while a session to the peer is open.
+    /// Default: None
+    pub fn with_peer(mut self, peer: NodeId) -> Self {
+        self.config.peer = Some(peer);
+        self
+    }
+
     /// Negotiates and establishes a session to the peer's RPC service
     pub async fn connect<TSubstream>(self, framed: CanonicalFraming<TSubstream>) -> Result<TClient, RpcError>
     where TSubstream: AsyncRead + AsyncWrite + Unpin + Send + 'static {
@@ -205,6 +229,7 @@ pub struct RpcClientConfig {
     pub deadline: Option<Duration>,
     pub deadline_grace_period: Duration,
     pub handshake_timeout: Duration,
+    pub peer: Option<NodeId>,
 }
 
 impl RpcClientConfig {
@@ -225,6 +250,7 @@ impl Default for RpcClientConfig {
             deadline: Some(Duration::from_secs(30)),
             deadline_grace_period: Duration::from_secs(10),
             handshake_timeout: Duration::from_secs(30),
+            peer: None,
         }
     }
 }
@@ -239,6 +265,10 @@ impl ClientConnector {
         self.inner.close_channel();
     }
 
+    pub fn is_connected(&self) -> bool {
+        !self.inner.is_closed()
+    }
+
     pub async fn get_last_request_latency(&mut self) -> Result<Option<Duration>, RpcError> {
         let (reply, reply_rx) = oneshot::channel();
         self.inner
@@ -289,6 +319,7 @@ pub struct RpcClientWorker<TSubstream> {
     request_id: u16,
     ready_tx: Option<oneshot::Sender<Result<(), RpcError>>>,
     latency: Option<Duration>,
+    request_time: Option<Arc<Histogram>>,
 }
 
 impl<TSubstream> RpcClientWorker<TSubstream>
@@ -307,6 +338,7 @@ where TSubstream: AsyncRead + AsyncWrite + Unpin + Send
             request_id: 0,
             ready_tx: Some(ready_tx),
             latency: None,
+            request_time: None,
         }
     }
 
@@ -322,6 +354,13 @@ where TSubstream: AsyncRead + AsyncWrite + Unpin + Send
                     "RPC Session negotiation completed. Latency: {:.0?}", latency
                 );
                 self.latency = Some(latency);
+                self.request_time = self.config.peer.as_ref().map(|peer| {
+                    tari_metrics::global().histogram(
+                        REQUEST_TIME_METRIC,
+                        "Time from sending an RPC request to receiving the first response",
+                        &[("peer", &peer.to_string())],
+                    )
+                });
                 if let Some(r) = self.ready_tx.take() {
                     let _ = r.send(Ok(()));
                 }
@@ -352,6 +391,13 @@ where TSubstream: AsyncRead + AsyncWrite + Unpin + Send
         if let Err(err) = self.framed.close().await {
             debug!(target: LOG_TARGET, "IO Error when closing substream: {}", err);
         }
+        // Drop the peer's series once its last session has closed, otherwise there is a series for every peer ever
+        // connected to
+        if self.request_time.take().is_some() {
+            if let Some(peer) = self.config.peer.as_ref() {
+                tari_metrics::global().remove_if_unused(REQUEST_TIME_METRIC, &[("peer", &peer.to_string())]);
+            }
+        }
 
         debug!(target: LOG_TARGET, "RpcClientWorker terminated.");
     }
@@ -382,6 +428,7 @@ where TSubstream: AsyncRead + AsyncWrite + Unpin + Send
             response_tx.close_channel();
         }
 
+        let mut is_first_response = true;
         loop {
             // Wait until the timeout, allowing an extra grace period to account for latency
             let next_msg_fut = match self.config.timeout_with_grace_period() {
@@ -401,6 +448,12 @@ where TSubstream: AsyncRead + AsyncWrite + Unpin + Send
                         latency
                     );
                     self.latency = Some(latency);
+                    if is_first_response {
+                        if let Some(request_time) = self.request_time.as_ref() {
+                            request_time.observe(latency);
+                        }
+                        is_first_response = false;
+                    }
                     proto::rpc::RpcResponse::decode(resp)?
                 },
                 Ok(Some(Err(err))) => {
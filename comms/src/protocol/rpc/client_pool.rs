@@ -0,0 +1,337 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use crate::{
+    connection_manager::PeerConnection,
+    peer_manager::NodeId,
+    protocol::rpc::{NamedProtocolService, RpcClient, RpcClientBuilder, RpcError},
+};
+use log::*;
+use std::{
+    fmt,
+    ops::{Deref, DerefMut},
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc,
+    },
+};
+use thiserror::Error;
+use tokio::sync::Mutex;
+
+const LOG_TARGET: &str = "comms::protocol::rpc::client_pool";
+
+/// A client that can be held in an `RpcClientPool`
+pub trait RpcPoolClient {
+    /// Returns true if the RPC session is still open
+    fn is_connected(&self) -> bool;
+}
+
+/// # RPC client pool
+///
+/// Holds up to `pool_size` established RPC sessions to a single peer over a `PeerConnection`. Sessions are created
+/// lazily (or ahead of time using `warm_up`) and are shared between callers, an idle session is preferred, otherwise
+/// the least used session is leased once the pool is full. Closed sessions are dropped from the pool and replaced on
+/// the next `get` or `warm_up`. Sessions are established without holding the pool lock, so callers that can be
+/// served by an existing session do not wait for another caller's handshake.
+#[derive(Clone)]
+pub struct RpcClientPool<T> {
+    pool: Arc<Mutex<LazyPool<T>>>,
+}
+
+impl<T> RpcClientPool<T>
+where T: RpcPoolClient + From<RpcClient> + NamedProtocolService + Clone
+{
+    pub(crate) fn new(peer_connection: PeerConnection, pool_size: usize, client_config: RpcClientBuilder<T>) -> Self {
+        let pool = LazyPool::new(peer_connection, pool_size, client_config);
+        Self {
+            pool: Arc::new(Mutex::new(pool)),
+        }
+    }
+
+    /// Returns a lease on a session from the pool, establishing a new session if all sessions are in use and the pool
+    /// is not full.
+    pub async fn get(&self) -> Result<RpcClientLease<T>, RpcClientPoolError> {
+        let (slot, connector) = {
+            let mut pool = self.pool.lock().await;
+            match pool.get_least_used_or_reserve() {
+                Ok(client) => return Ok(client),
+                Err(slot) => (slot, pool.connector()),
+            }
+        };
+        let client = connector.connect().await?;
+        let mut pool = self.pool.lock().await;
+        Ok(pool.add_client(client, slot))
+    }
+
+    /// Establishes sessions until the pool holds `pool_size` open sessions. Returns the number of sessions that were
+    /// established.
+    pub async fn warm_up(&self) -> Result<usize, RpcClientPoolError> {
+        let mut num_established = 0;
+        loop {
+            let (slot, connector) = {
+                let mut pool = self.pool.lock().await;
+                match pool.reserve_if_not_full() {
+                    Some(slot) => (slot, pool.connector()),
+                    None => return Ok(num_established),
+                }
+            };
+            let client = connector.connect().await?;
+            self.pool.lock().await.add_client(client, slot);
+            num_established += 1;
+        }
+    }
+
+    /// Returns true if the underlying peer connection is still connected
+    pub async fn is_connected(&self) -> bool {
+        let pool = self.pool.lock().await;
+        pool.connection.is_connected()
+    }
+
+    pub async fn stats(&self) -> RpcClientPoolStats {
+        let mut pool = self.pool.lock().await;
+        pool.prune();
+        pool.stats()
+    }
+}
+
+struct LazyPool<T> {
+    connection: PeerConnection,
+    clients: Vec<RpcClientLease<T>>,
+    client_config: RpcClientBuilder<T>,
+    capacity: usize,
+    num_connecting: Arc<AtomicUsize>,
+    num_sessions_established: u64,
+    num_sessions_dropped: u64,
+}
+
+impl<T> LazyPool<T>
+where T: RpcPoolClient + From<RpcClient> + NamedProtocolService + Clone
+{
+    fn new(connection: PeerConnection, capacity: usize, client_config: RpcClientBuilder<T>) -> Self {
+        Self {
+            connection,
+            clients: Vec::with_capacity(capacity),
+            client_config,
+            capacity: capacity.max(1),
+            num_connecting: Arc::new(AtomicUsize::new(0)),
+            num_sessions_established: 0,
+            num_sessions_dropped: 0,
+        }
+    }
+
+    /// Returns an idle session, or reserves a slot for a new session if the pool is not full, otherwise returns the
+    /// least used session. A slot is also reserved if the pool is full of sessions that are still being established,
+    /// in which case the new session is not kept in the pool.
+    fn get_least_used_or_reserve(&mut self) -> Result<RpcClientLease<T>, ConnectSlot> {
+        self.prune();
+
+        if let Some(client) = self.clients.iter().find(|c| !c.is_leased()) {
+            return Ok(client.clone());
+        }
+
+        if let Some(slot) = self.reserve_if_not_full() {
+            return Err(slot);
+        }
+
+        match self.clients.iter().min_by_key(|c| c.lease_count()) {
+            Some(client) => Ok(client.clone()),
+            None => Err(ConnectSlot::new(self.num_connecting.clone())),
+        }
+    }
+
+    /// Reserves a slot for a new session if the open sessions and the sessions being established do not fill the pool
+    fn reserve_if_not_full(&mut self) -> Option<ConnectSlot> {
+        self.prune();
+        if self.clients.len() + self.num_connecting.load(Ordering::SeqCst) < self.capacity {
+            Some(ConnectSlot::new(self.num_connecting.clone()))
+        } else {
+            None
+        }
+    }
+
+    fn connector(&self) -> Connector<T> {
+        Connector {
+            connection: self.connection.clone(),
+            client_config: self.client_config.clone(),
+        }
+    }
+
+    /// Adds a newly established session to the pool, releasing its slot. The session is returned without being
+    /// pooled if the pool filled up in the meantime.
+    fn add_client(&mut self, client: T, slot: ConnectSlot) -> RpcClientLease<T> {
+        drop(slot);
+        self.num_sessions_established += 1;
+        let client = RpcClientLease::new(client);
+        if self.clients.len() < self.capacity {
+            self.clients.push(client.clone());
+        }
+        client
+    }
+
+    /// Drop sessions that have been closed
+    fn prune(&mut self) {
+        let num_before = self.clients.len();
+        self.clients.retain(|c| c.is_connected());
+        let num_dropped = num_before - self.clients.len();
+        if num_dropped > 0 {
+            debug!(
+                target: LOG_TARGET,
+                "Dropped {} closed RPC session(s) to peer `{}`",
+                num_dropped,
+                self.connection.peer_node_id()
+            );
+            self.num_sessions_dropped += num_dropped as u64;
+        }
+    }
+
+    fn stats(&self) -> RpcClientPoolStats {
+        RpcClientPoolStats {
+            capacity: self.capacity,
+            num_sessions: self.clients.len(),
+            num_leased: self.clients.iter().filter(|c| c.is_leased()).count(),
+            num_sessions_established: self.num_sessions_established,
+            num_sessions_dropped: self.num_sessions_dropped,
+        }
+    }
+}
+
+/// A session that is being established for a pool. The pool counts it as open until the slot is dropped.
+struct ConnectSlot {
+    num_connecting: Arc<AtomicUsize>,
+}
+
+impl ConnectSlot {
+    fn new(num_connecting: Arc<AtomicUsize>) -> Self {
+        num_connecting.fetch_add(1, Ordering::SeqCst);
+        Self { num_connecting }
+    }
+}
+
+impl Drop for ConnectSlot {
+    fn drop(&mut self) {
+        self.num_connecting.fetch_sub(1, Ordering::SeqCst);
+    }
+}
+
+/// What is needed to establish a new session for a pool once the pool lock has been released
+struct Connector<T> {
+    connection: PeerConnection,
+    client_config: RpcClientBuilder<T>,
+}
+
+impl<T> Connector<T>
+where T: From<RpcClient> + NamedProtocolService
+{
+    async fn connect(mut self) -> Result<T, RpcClientPoolError> {
+        if !self.connection.is_connected() {
+            return Err(RpcClientPoolError::PeerConnectionDropped {
+                peer: self.connection.peer_node_id().clone(),
+            });
+        }
+        let client = self.connection.connect_rpc_using_builder(self.client_config).await?;
+        Ok(client)
+    }
+}
+
+/// A session leased from an `RpcClientPool`. The session remains in the pool and may be shared with other leases.
+#[derive(Debug, Clone)]
+pub struct RpcClientLease<T> {
+    inner: T,
+    rc: Arc<()>,
+}
+
+impl<T> RpcClientLease<T> {
+    fn new(inner: T) -> Self {
+        Self {
+            inner,
+            rc: Arc::new(()),
+        }
+    }
+
+    /// The number of leases currently held on this session, not counting the pool's own reference
+    fn lease_count(&self) -> usize {
+        Arc::strong_count(&self.rc) - 1
+    }
+
+    fn is_leased(&self) -> bool {
+        self.lease_count() > 0
+    }
+}
+
+/// Wraps a client that does not belong to a pool, so that it can be used wherever a pooled session is expected
+impl<T> From<T> for RpcClientLease<T> {
+    fn from(client: T) -> Self {
+        Self::new(client)
+    }
+}
+
+impl<T> Deref for RpcClientLease<T> {
+    type Target = T;
+
+    fn deref(&self) -> &Self::Target {
+        &self.inner
+    }
+}
+
+impl<T> DerefMut for RpcClientLease<T> {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.inner
+    }
+}
+
+impl<T: RpcPoolClient> RpcPoolClient for RpcClientLease<T> {
+    fn is_connected(&self) -> bool {
+        self.inner.is_connected()
+    }
+}
+
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct RpcClientPoolStats {
+    /// The maximum number of sessions held by the pool
+    pub capacity: usize,
+    /// The number of open sessions in the pool
+    pub num_sessions: usize,
+    /// The number of open sessions that are currently leased
+    pub num_leased: usize,
+    /// The total number of sessions established by the pool
+    pub num_sessions_established: u64,
+    /// The total number of closed sessions that were dropped from the pool
+    pub num_sessions_dropped: u64,
+}
+
+impl fmt::Display for RpcClientPoolStats {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "sessions = {}/{}, leased = {}, established = {}, dropped = {}",
+            self.num_sessions, self.capacity, self.num_leased, self.num_sessions_established, self.num_sessions_dropped
+        )
+    }
+}
+
+#[derive(Debug, Error)]
+pub enum RpcClientPoolError {
+    #[error("Peer connection to peer '{peer}' dropped")]
+    PeerConnectionDropped { peer: NodeId },
+    #[error("Rpc error: {0}")]
+    RpcError(#[from] RpcError),
+}
@@ -37,6 +37,9 @@ pub use server::{mock, NamedProtocolService, RpcServer, RpcServerError, RpcServe
 mod client;
 pub use client::{RpcClient, RpcClientBuilder, RpcClientConfig};
 
+mod client_pool;
+pub use client_pool::{RpcClientLease, RpcClientPool, RpcClientPoolError, RpcClientPoolStats, RpcPoolClient};
+
 mod either;
 
 mod message;
@@ -70,6 +73,7 @@ pub mod __macro_reexports {
                 RpcClient,
                 RpcClientBuilder,
                 RpcError,
+                RpcPoolClient,
                 RpcStatus,
             },
             ProtocolId,
@@ -0,0 +1,139 @@
+//  Copyright 2021, The Tari Project
+//
+//  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+//  following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+//  disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+//  following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+//  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+//  products derived from this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+//  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+//  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use crate::{
+    protocol::rpc::{
+        test::mock::{MockRpcClient, MockRpcService},
+        RpcClientBuilder,
+        RpcClientPoolStats,
+        RpcServer,
+    },
+    runtime,
+    test_utils::node_identity::build_node_identity,
+    transports::MemoryTransport,
+    types::CommsDatabase,
+    CommsBuilder,
+    CommsNode,
+};
+use futures::future;
+use tari_shutdown::Shutdown;
+
+async fn setup(shutdown: &Shutdown) -> (CommsNode, CommsNode) {
+    let node_identity1 = build_node_identity(Default::default());
+    let rpc_service = MockRpcService::new();
+    rpc_service.shared_state().set_response_ok(());
+    let comms1 = CommsBuilder::new()
+        .with_listener_address(node_identity1.public_address())
+        .with_node_identity(node_identity1)
+        .with_shutdown_signal(shutdown.to_signal())
+        .with_peer_storage(CommsDatabase::new(), None)
+        .build()
+        .unwrap()
+        .add_rpc_server(RpcServer::new().add_service(rpc_service))
+        .spawn_with_transport(MemoryTransport)
+        .await
+        .unwrap();
+
+    let node_identity2 = build_node_identity(Default::default());
+    let comms2 = CommsBuilder::new()
+        .with_listener_address(node_identity2.public_address())
+        .with_shutdown_signal(shutdown.to_signal())
+        .with_node_identity(node_identity2)
+        .with_peer_storage(CommsDatabase::new(), None)
+        .build()
+        .unwrap();
+
+    comms2
+        .peer_manager()
+        .add_peer(comms1.node_identity().to_peer())
+        .await
+        .unwrap();
+
+    let comms2 = comms2.spawn_with_transport(MemoryTransport).await.unwrap();
+    (comms1, comms2)
+}
+
+#[runtime::test_basic]
+async fn it_warms_up_and_shares_sessions() {
+    let shutdown = Shutdown::new();
+    let (comms1, comms2) = setup(&shutdown).await;
+
+    let conn = comms2
+        .connectivity()
+        .dial_peer(comms1.node_identity().node_id().clone())
+        .await
+        .unwrap();
+
+    let pool = conn.create_rpc_client_pool::<MockRpcClient>(2, RpcClientBuilder::new());
+    assert_eq!(pool.stats().await, RpcClientPoolStats {
+        capacity: 2,
+        ..Default::default()
+    });
+
+    assert_eq!(pool.warm_up().await.unwrap(), 2);
+    // Already full
+    assert_eq!(pool.warm_up().await.unwrap(), 0);
+
+    let mut lease1 = pool.get().await.unwrap();
+    lease1.request_response::<_, ()>((), 0.into()).await.unwrap();
+    let lease2 = pool.get().await.unwrap();
+    // Both sessions are leased, so the next lease shares a session
+    let lease3 = pool.get().await.unwrap();
+
+    let stats = pool.stats().await;
+    assert_eq!(stats.num_sessions, 2);
+    assert_eq!(stats.num_leased, 2);
+    assert_eq!(stats.num_sessions_established, 2);
+    assert_eq!(stats.num_sessions_dropped, 0);
+
+    drop(lease1);
+    drop(lease2);
+    drop(lease3);
+    assert_eq!(pool.stats().await.num_leased, 0);
+    assert!(pool.is_connected().await);
+}
+
+#[runtime::test_basic]
+async fn it_establishes_concurrent_sessions_up_to_capacity() {
+    let shutdown = Shutdown::new();
+    let (comms1, comms2) = setup(&shutdown).await;
+
+    let conn = comms2
+        .connectivity()
+        .dial_peer(comms1.node_identity().node_id().clone())
+        .await
+        .unwrap();
+
+    let pool = conn.create_rpc_client_pool::<MockRpcClient>(2, RpcClientBuilder::new());
+    let leases = future::join_all((0..3).map(|_| pool.get())).await;
+    assert!(leases.iter().all(|lease| lease.is_ok()));
+
+    // The third caller could not share a session that was still being established, so it connected its own session
+    // which is not kept in the pool
+    let stats = pool.stats().await;
+    assert_eq!(stats.num_sessions, 2);
+    assert_eq!(stats.num_leased, 2);
+    assert_eq!(stats.num_sessions_established, 3);
+
+    drop(leases);
+    assert_eq!(pool.warm_up().await.unwrap(), 0);
+}
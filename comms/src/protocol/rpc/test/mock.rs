@@ -32,6 +32,7 @@ use crate::{
             Request,
             Response,
             RpcError,
+            RpcPoolClient,
             RpcStatus,
         },
         ProtocolId,
@@ -138,6 +139,7 @@ impl MockRpcServiceState {
     }
 }
 
+#[derive(Clone)]
 pub struct MockRpcClient {
     inner: RpcClient,
 }
@@ -170,6 +172,12 @@ impl From<RpcClient> for MockRpcClient {
     }
 }
 
+impl RpcPoolClient for MockRpcClient {
+    fn is_connected(&self) -> bool {
+        self.inner.is_connected()
+    }
+}
+
 pub(super) fn create_mocked_rpc_context() -> (RpcCommsBackend, ConnectivityManagerMockState) {
     let (connectivity, mock) = create_connectivity_mock();
     let mock_state = mock.get_shared_state();
@@ -0,0 +1,339 @@
+// Copyright 2021, The Tari Project
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+// following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+// disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+// products derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+use crate::metric::{Counter, Gauge, Histogram, HistogramSnapshot, DEFAULT_DURATION_BUCKETS};
+use std::{
+    collections::BTreeMap,
+    fmt::Write,
+    sync::{Arc, RwLock, RwLockReadGuard},
+};
+
+pub type Labels = Vec<(String, String)>;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum MetricKind {
+    Counter,
+    Gauge,
+    Histogram,
+}
+
+impl MetricKind {
+    fn as_str(self) -> &'static str {
+        match self {
+            MetricKind::Counter => "counter",
+            MetricKind::Gauge => "gauge",
+            MetricKind::Histogram => "histogram",
+        }
+    }
+}
+
+#[derive(Debug, Clone)]
+enum Metric {
+    Counter(Arc<Counter>),
+    Gauge(Arc<Gauge>),
+    Histogram(Arc<Histogram>),
+}
+
+impl Metric {
+    fn kind(&self) -> MetricKind {
+        match self {
+            Metric::Counter(_) => MetricKind::Counter,
+            Metric::Gauge(_) => MetricKind::Gauge,
+            Metric::Histogram(_) => MetricKind::Histogram,
+        }
+    }
+
+    /// True if the registry holds the only reference to the metric
+    fn is_unused(&self) -> bool {
+        match self {
+            Metric::Counter(c) => Arc::strong_count(c) == 1,
+            Metric::Gauge(g) => Arc::strong_count(g) == 1,
+            Metric::Histogram(h) => Arc::strong_count(h) == 1,
+        }
+    }
+
+    fn value(&self) -> MetricValue {
+        match self {
+            Metric::Counter(c) => MetricValue::Counter(c.get()),
+            Metric::Gauge(g) => MetricValue::Gauge(g.get()),
+            Metric::Histogram(h) => MetricValue::Histogram(h.snapshot()),
+        }
+    }
+}
+
+#[derive(Debug)]
+struct Family {
+    help: String,
+    kind: MetricKind,
+    series: BTreeMap<Labels, Metric>,
+}
+
+/// The value of a single metric at a point in time
+#[derive(Debug, Clone, PartialEq)]
+pub enum MetricValue {
+    Counter(u64),
+    Gauge(i64),
+    Histogram(HistogramSnapshot),
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub struct MetricSnapshot {
+    pub name: String,
+    pub help: String,
+    pub labels: Labels,
+    pub value: MetricValue,
+}
+
+/// A set of named metrics. Each metric is identified by its name and labels; asking for a metric that already exists
+/// returns the existing one, so callers are expected to look a metric up once and keep the returned `Arc` rather than
+/// looking it up on every use.
+#[derive(Debug, Default)]
+pub struct Registry {
+    families: RwLock<BTreeMap<String, Family>>,
+}
+
+impl Registry {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    pub fn counter(&self, name: &str, help: &str, labels: &[(&str, &str)]) -> Arc<Counter> {
+        match self.get_or_register(name, help, labels, || Metric::Counter(Default::default())) {
+            Some(Metric::Counter(c)) => c,
+            _ => Default::default(),
+        }
+    }
+
+    pub fn gauge(&self, name: &str, help: &str, labels: &[(&str, &str)]) -> Arc<Gauge> {
+        match self.get_or_register(name, help, labels, || Metric::Gauge(Default::default())) {
+            Some(Metric::Gauge(g)) => g,
+            _ => Default::default(),
+        }
+    }
+
+    /// A histogram of durations using the `DEFAULT_DURATION_BUCKETS`
+    pub fn histogram(&self, name: &str, help: &str, labels: &[(&str, &str)]) -> Arc<Histogram> {
+        self.histogram_with_buckets(name, help, labels, DEFAULT_DURATION_BUCKETS)
+    }
+
+    /// A histogram of durations with the given bucket upper bounds in seconds. The buckets are only used when the
+    /// histogram is first registered.
+    pub fn histogram_with_buckets(
+        &self,
+        name: &str,
+        help: &str,
+        labels: &[(&str, &str)],
+        buckets: &[f64],
+    ) -> Arc<Histogram> {
+        let create = || Metric::Histogram(Arc::new(Histogram::new(buckets)));
+        match self.get_or_register(name, help, labels, create) {
+            Some(Metric::Histogram(h)) => h,
+            _ => Arc::new(Histogram::new(buckets)),
+        }
+    }
+
+    /// Removes the metric with the given name and labels if nobody else holds a reference to it. This is used to drop
+    /// the series of a label value that has gone away (e.g. a disconnected peer) so that the number of series does
+    /// not grow without bound. Returns true if the metric was removed.
+    pub fn remove_if_unused(&self, name: &str, labels: &[(&str, &str)]) -> bool {
+        let labels = to_owned_labels(labels);
+        let mut families = self.families.write().unwrap_or_else(|e| e.into_inner());
+        let family = match families.get_mut(name) {
+            Some(family) => family,
+            None => return false,
+        };
+        if !family.series.get(&labels).map(Metric::is_unused).unwrap_or(false) {
+            return false;
+        }
+        family.series.remove(&labels);
+        if family.series.is_empty() {
+            families.remove(name);
+        }
+        true
+    }
+
+    /// Returns the current value of every registered metric, ordered by name and then by labels
+    pub fn snapshot(&self) -> Vec<MetricSnapshot> {
+        let families = acquire_read(&self.families);
+        families
+            .iter()
+            .flat_map(|(name, family)| {
+                family.series.iter().map(move |(labels, metric)| MetricSnapshot {
+                    name: name.clone(),
+                    help: family.help.clone(),
+                    labels: labels.clone(),
+                    value: metric.value(),
+                })
+            })
+            .collect()
+    }
+
+    /// Returns the current value of every registered metric in the Prometheus text exposition format
+    pub fn encode_text(&self) -> String {
+        let families = acquire_read(&self.families);
+        let mut out = String::new();
+        for (name, family) in families.iter() {
+            let _ = writeln!(out, "# HELP {} {}", name, escape_help(&family.help));
+            let _ = writeln!(out, "# TYPE {} {}", name, family.kind.as_str());
+            for (labels, metric) in &family.series {
+                let series_labels = format_labels(labels, None);
+                match metric.value() {
+                    MetricValue::Counter(v) => {
+                        let _ = writeln!(out, "{}{} {}", name, series_labels, v);
+                    },
+                    MetricValue::Gauge(v) => {
+                        let _ = writeln!(out, "{}{} {}", name, series_labels, v);
+                    },
+                    MetricValue::Histogram(h) => {
+                        for (bound, count) in &h.buckets {
+                            let le = bound.to_string();
+                            let _ = writeln!(out, "{}_bucket{} {}", name, format_labels(labels, Some(&le)), count);
+                        }
+                        let inf_labels = format_labels(labels, Some("+Inf"));
+                        let _ = writeln!(out, "{}_bucket{} {}", name, inf_labels, h.count);
+                        let _ = writeln!(out, "{}_sum{} {}", name, series_labels, h.sum.as_secs_f64());
+                        let _ = writeln!(out, "{}_count{} {}", name, series_labels, h.count);
+                    },
+                }
+            }
+        }
+        out
+    }
+
+    /// Returns `None` if a metric of a different kind is already registered under this name, in which case the
+    /// caller hands out a metric that is not registered rather than failing on the hot path.
+    fn get_or_register<F>(&self, name: &str, help: &str, labels: &[(&str, &str)], create: F) -> Option<Metric>
+    where F: FnOnce() -> Metric {
+        let labels = to_owned_labels(labels);
+        if let Some(family) = acquire_read(&self.families).get(name) {
+            if let Some(metric) = family.series.get(&labels) {
+                return Some(metric.clone());
+            }
+        }
+
+        let mut families = self.families.write().unwrap_or_else(|e| e.into_inner());
+        let metric = create();
+        let family = families.entry(name.to_string()).or_insert_with(|| Family {
+            help: help.to_string(),
+            kind: metric.kind(),
+            series: BTreeMap::new(),
+        });
+        if family.kind != metric.kind() {
+            return None;
+        }
+        Some(family.series.entry(labels).or_insert(metric).clone())
+    }
+}
+
+/// A panic while the lock is held cannot leave the families in an inconsistent state, so a poisoned lock is still used
+fn acquire_read<T>(lock: &RwLock<T>) -> RwLockReadGuard<'_, T> {
+    lock.read().unwrap_or_else(|e| e.into_inner())
+}
+
+fn to_owned_labels(labels: &[(&str, &str)]) -> Labels {
+    labels.iter().map(|(k, v)| (k.to_string(), v.to_string())).collect()
+}
+
+fn format_labels(labels: &[(String, String)], le: Option<&str>) -> String {
+    if labels.is_empty() && le.is_none() {
+        return String::new();
+    }
+    let mut pairs = labels
+        .iter()
+        .map(|(k, v)| format!("{}=\"{}\"", k, escape_label_value(v)))
+        .collect::<Vec<_>>();
+    if let Some(le) = le {
+        pairs.push(format!("le=\"{}\"", le));
+    }
+    format!("{{{}}}", pairs.join(","))
+}
+
+fn escape_label_value(value: &str) -> String {
+    value.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n")
+}
+
+fn escape_help(help: &str) -> String {
+    help.replace('\\', "\\\\").replace('\n', "\\n")
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::time::Duration;
+
+    #[test]
+    fn it_returns_the_registered_metric() {
+        let registry = Registry::new();
+        let peer_a = &[("peer", "a")];
+        registry.counter("requests_total", "Requests", peer_a).inc();
+        registry.counter("requests_total", "Requests", peer_a).inc_by(2);
+        registry.counter("requests_total", "Requests", &[("peer", "b")]).inc();
+        // A different kind under the same name is not registered
+        registry.gauge("requests_total", "Requests", &[]).set(10);
+
+        let snapshot = registry.snapshot();
+        assert_eq!(snapshot.len(), 2);
+        assert_eq!(snapshot[0].labels, vec![("peer".to_string(), "a".to_string())]);
+        assert_eq!(snapshot[0].value, MetricValue::Counter(3));
+        assert_eq!(snapshot[1].value, MetricValue::Counter(1));
+    }
+
+    #[test]
+    fn it_removes_unused_metrics() {
+        let registry = Registry::new();
+        let peer_a = &[("peer", "a")];
+        let histogram = registry.histogram("request_seconds", "Request time", peer_a);
+        registry.histogram("request_seconds", "Request time", &[("peer", "b")]);
+        assert!(!registry.remove_if_unused("request_seconds", peer_a));
+        drop(histogram);
+        assert!(registry.remove_if_unused("request_seconds", peer_a));
+        assert!(!registry.remove_if_unused("request_seconds", peer_a));
+        assert_eq!(registry.snapshot().len(), 1);
+
+        assert!(registry.remove_if_unused("request_seconds", &[("peer", "b")]));
+        assert_eq!(registry.encode_text(), "");
+    }
+
+    #[test]
+    fn it_encodes_the_text_format() {
+        let registry = Registry::new();
+        registry.gauge("queue_depth", "Queue depth", &[]).set(-2);
+        let histogram = registry.histogram_with_buckets("query_seconds", "Query time", &[("db", "a\"b")], &[0.01, 0.1]);
+        histogram.observe(Duration::from_millis(5));
+        histogram.observe(Duration::from_millis(50));
+        histogram.observe(Duration::from_secs(1));
+
+        let text = registry.encode_text();
+        let expected = "# HELP query_seconds Query time
+# TYPE query_seconds histogram
+query_seconds_bucket{db=\"a\\\"b\",le=\"0.01\"} 1
+query_seconds_bucket{db=\"a\\\"b\",le=\"0.1\"} 2
+query_seconds_bucket{db=\"a\\\"b\",le=\"+Inf\"} 3
+query_seconds_sum{db=\"a\\\"b\"} 1.055
+query_seconds_count{db=\"a\\\"b\"} 3
+# HELP queue_depth Queue depth
+# TYPE queue_depth gauge
+queue_depth -2
+";
+        assert_eq!(text, expected);
+    }
+}